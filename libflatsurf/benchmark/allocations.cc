@@ -0,0 +1,177 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "allocations.hpp"
+
+#include <flint/flint.h>
+#include <gmp.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace flatsurf::benchmark {
+
+namespace {
+
+// Whether LIBFLATSURF_BENCHMARK_ALLOCATIONS is set; decided on the first
+// allocation, i.e., before main().
+bool active() {
+  static const bool active = std::getenv("LIBFLATSURF_BENCHMARK_ALLOCATIONS") != nullptr;
+  return active;
+}
+
+std::atomic<size_t> allocations{0};
+std::atomic<size_t> bytes{0};
+
+void count(size_t size) {
+  if (active()) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+}
+
+void* allocate(size_t size) {
+  count(size);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void* allocate(size_t size, std::align_val_t alignment) {
+  count(size);
+  const auto align = static_cast<size_t>(alignment);
+  // std::aligned_alloc requires the size to be a multiple of the alignment.
+  size = (size + align - 1) / align * align;
+  if (void* ptr = std::aligned_alloc(align, size == 0 ? align : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+// The memory functions that GMP and FLINT used before we replaced them.
+void* (*gmpAllocate)(size_t);
+void* (*gmpReallocate)(void*, size_t, size_t);
+void (*gmpFree)(void*, size_t);
+
+// Replace the memory functions of GMP and FLINT with counting versions at
+// startup. Limbs that have been allocated before this runs, are released
+// through the original functions since we delegate to them.
+[[maybe_unused]] const bool interposed = []() {
+  if (!active()) return false;
+
+  mp_get_memory_functions(&gmpAllocate, &gmpReallocate, &gmpFree);
+  mp_set_memory_functions(
+      [](size_t size) {
+        count(size);
+        return gmpAllocate(size);
+      },
+      [](void* ptr, size_t old, size_t size) {
+        count(size);
+        return gmpReallocate(ptr, old, size);
+      },
+      [](void* ptr, size_t size) {
+        gmpFree(ptr, size);
+      });
+
+  __flint_set_memory_functions(
+      [](size_t size) {
+        count(size);
+        return std::malloc(size);
+      },
+      [](size_t num, size_t size) {
+        count(num * size);
+        return std::calloc(num, size);
+      },
+      [](void* ptr, size_t size) {
+        count(size);
+        return std::realloc(ptr, size);
+      },
+      [](void* ptr) {
+        std::free(ptr);
+      });
+
+  return true;
+}();
+
+}  // namespace
+
+Allocations::Allocations() :
+  start(counts()) {}
+
+bool Allocations::enabled() {
+  return active();
+}
+
+void Allocations::pause() {
+  paused = counts();
+}
+
+void Allocations::resume() {
+  const auto now = counts();
+  excluded.allocations += now.allocations - paused.allocations;
+  excluded.bytes += now.bytes - paused.bytes;
+}
+
+void Allocations::report(::benchmark::State& state) const {
+  if (!enabled()) return;
+
+  const auto now = counts();
+  state.counters["allocations"] = ::benchmark::Counter(static_cast<double>(now.allocations - start.allocations - excluded.allocations), ::benchmark::Counter::kAvgIterations);
+  state.counters["bytes"] = ::benchmark::Counter(static_cast<double>(now.bytes - start.bytes - excluded.bytes), ::benchmark::Counter::kAvgIterations);
+}
+
+Allocations::Counts Allocations::counts() {
+  return Counts{allocations.load(std::memory_order_relaxed), bytes.load(std::memory_order_relaxed)};
+}
+
+}  // namespace flatsurf::benchmark
+
+// Replacements of the global allocation functions that count all the
+// allocations performed through new.
+void* operator new(size_t size) { return flatsurf::benchmark::allocate(size); }
+void* operator new[](size_t size) { return flatsurf::benchmark::allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return flatsurf::benchmark::allocate(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return flatsurf::benchmark::allocate(size, alignment); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return flatsurf::benchmark::allocate(size);
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return flatsurf::benchmark::allocate(size);
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
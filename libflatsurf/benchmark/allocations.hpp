@@ -0,0 +1,81 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_BENCHMARK_ALLOCATIONS_HPP
+#define LIBFLATSURF_BENCHMARK_ALLOCATIONS_HPP
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+namespace flatsurf::benchmark {
+
+// Counts the memory allocations performed while a benchmark runs.
+//
+// The benchmark binary replaces the global operator new and the memory
+// functions of GMP and FLINT (which are used by e-antic and exact-real) by
+// versions that count the allocations and the bytes requested. Counting is
+// only enabled when the environment variable
+// LIBFLATSURF_BENCHMARK_ALLOCATIONS is set since it distorts the timings
+// slightly. Typical usage:
+//
+//   Allocations allocations;
+//   for (auto _ : state) {
+//     ...
+//   }
+//   allocations.report(state);
+//
+// which adds counters "allocations" and "bytes" per iteration to the output
+// of the benchmark.
+class Allocations {
+ public:
+  // Start counting from now.
+  Allocations();
+
+  // Return whether allocations are being counted.
+  static bool enabled();
+
+  // Exclude the allocations between pause() and resume() from the counts,
+  // typically used together with State::PauseTiming() and
+  // State::ResumeTiming().
+  void pause();
+  void resume();
+
+  // Add the allocations per iteration since the construction of this object
+  // to the counters of state.
+  void report(::benchmark::State& state) const;
+
+  struct Counts {
+    size_t allocations = 0;
+    size_t bytes = 0;
+  };
+
+  // Return the number of allocations performed since the start of this
+  // program (if counting is enabled.)
+  static Counts counts();
+
+ private:
+  Counts start;
+  Counts excluded;
+  Counts paused;
+};
+
+}  // namespace flatsurf::benchmark
+
+#endif
@@ -24,6 +24,7 @@
 
 #include "../flatsurf/chain.hpp"
 #include "../test/surfaces.hpp"
+#include "allocations.hpp"
 
 using benchmark::DoNotOptimize;
 using benchmark::State;
@@ -37,9 +38,11 @@ void CreateChain(State& state) {
   using R2 = Vector<T>;
   const auto L = makeL<R2>();
 
+  Allocations allocations;
   for (auto _ : state) {
     DoNotOptimize(Chain(*L));
   }
+  allocations.report(state);
 }
 BENCHMARK_TEMPLATE(CreateChain, long long);
 
@@ -49,9 +52,11 @@ void CopyConstructChain(State& state) {
   const auto L = makeL<R2>();
   const auto chain = Chain(*L);
 
+  Allocations allocations;
   for (auto _ : state) {
     DoNotOptimize(Chain(chain));
   }
+  allocations.report(state);
 }
 BENCHMARK_TEMPLATE(CopyConstructChain, long long);
 
@@ -62,9 +67,11 @@ void CopyAssignChain(State& state) {
   const auto chain = Chain(*L);
   auto target = chain;
 
+  Allocations allocations;
   for (auto _ : state) {
     target = chain;
   }
+  allocations.report(state);
 }
 BENCHMARK_TEMPLATE(CopyAssignChain, long long);
 
@@ -74,10 +81,12 @@ void MoveChain(State& state) {
   const auto L = makeL<R2>();
   auto chain = Chain(*L);
 
+  Allocations allocations;
   for (auto _ : state) {
     Chain tmp = std::move(chain);
     chain = std::move(tmp);
   }
+  allocations.report(state);
 }
 BENCHMARK_TEMPLATE(MoveChain, long long);
 
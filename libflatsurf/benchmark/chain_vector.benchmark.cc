@@ -0,0 +1,136 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+
+#include <benchmark/benchmark.h>
+
+#include <type_traits>
+#include <utility>
+
+#include <exact-real/arb.hpp>
+#include <exact-real/element.hpp>
+#include <exact-real/integer_ring.hpp>
+#include <exact-real/number_field.hpp>
+#include <exact-real/rational_field.hpp>
+
+#include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/vector.hpp"
+#include "../test/surfaces.hpp"
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+
+// These benchmarks measure the operations whose costs ChainVector weighs
+// against each other. Their output can be turned into a cost profile for the
+// host with chain_vector_cost.py.
+
+namespace flatsurf::benchmark {
+using namespace flatsurf::test;
+
+namespace {
+
+// Return two vectors of the L-shaped surface with coordinates of type T.
+template <typename T>
+auto vectors() {
+  if constexpr (std::is_same_v<T, exactreal::Arb>) {
+    const auto L = makeL<Vector<eantic::renf_elem_class>>();
+    return std::pair{static_cast<Vector<T>>(L->fromHalfEdge(HalfEdge(1))), static_cast<Vector<T>>(L->fromHalfEdge(HalfEdge(2)))};
+  } else {
+    const auto L = makeL<Vector<T>>();
+    return std::pair{L->fromHalfEdge(HalfEdge(1)), L->fromHalfEdge(HalfEdge(2))};
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void ChainVectorCostAdd(State& state) {
+  auto [v, w] = vectors<T>();
+
+  for (auto _ : state) {
+    v += w;
+    v -= w;
+  }
+
+  state.SetItemsProcessed(2 * state.iterations());
+}
+
+template <typename T>
+void ChainVectorCostCopy(State& state) {
+  const auto [v, w] = vectors<T>();
+
+  for (auto _ : state) {
+    Vector<T> copy = v;
+    DoNotOptimize(copy);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename T>
+void ChainVectorCostConvert(State& state) {
+  const auto [v, w] = vectors<T>();
+
+  for (auto _ : state) {
+    DoNotOptimize(static_cast<Vector<exactreal::Arb>>(v));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename T>
+void ChainVectorCostMove(State& state) {
+  auto [v, w] = vectors<T>();
+
+  for (auto _ : state) {
+    Vector<T> tmp = std::move(v);
+    v = std::move(tmp);
+  }
+
+  state.SetItemsProcessed(2 * state.iterations());
+}
+
+template <typename T>
+void ChainVectorCostAddmul(State& state) {
+  auto [v, w] = vectors<T>();
+  const mpz_class c = 3;
+
+  for (auto _ : state) {
+    v += c * w;
+    v -= c * w;
+  }
+
+  state.SetItemsProcessed(2 * state.iterations());
+}
+
+#define LIBFLATSURF_BENCHMARK_CHAIN_VECTOR_COST(T)  \
+  BENCHMARK_TEMPLATE(ChainVectorCostAdd, T);        \
+  BENCHMARK_TEMPLATE(ChainVectorCostCopy, T);       \
+  BENCHMARK_TEMPLATE(ChainVectorCostConvert, T);    \
+  BENCHMARK_TEMPLATE(ChainVectorCostMove, T);       \
+  BENCHMARK_TEMPLATE(ChainVectorCostAddmul, T);
+
+LIBFLATSURF_BENCHMARK_CHAIN_VECTOR_COST(long long)
+LIBFLATSURF_BENCHMARK_CHAIN_VECTOR_COST(mpz_class)
+LIBFLATSURF_BENCHMARK_CHAIN_VECTOR_COST(mpq_class)
+LIBFLATSURF_BENCHMARK_CHAIN_VECTOR_COST(eantic::renf_elem_class)
+LIBFLATSURF_BENCHMARK_CHAIN_VECTOR_COST(exactreal::Element<exactreal::IntegerRing>)
+LIBFLATSURF_BENCHMARK_CHAIN_VECTOR_COST(exactreal::Element<exactreal::RationalField>)
+LIBFLATSURF_BENCHMARK_CHAIN_VECTOR_COST(exactreal::Element<exactreal::NumberField>)
+LIBFLATSURF_BENCHMARK_CHAIN_VECTOR_COST(exactreal::Arb)
+
+}  // namespace flatsurf::benchmark
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+r"""
+Turn the output of the ChainVectorCost benchmarks into a cost profile that
+ChainVector uses to decide when to recompute vectors from scratch.
+
+Run this as
+
+    ./benchmark --benchmark_filter=ChainVectorCost --benchmark_format=json | ./chain_vector_cost.py > chain_vector.costs
+
+and point the environment variable LIBFLATSURF_CHAIN_VECTOR_COSTS to the
+resulting file.
+"""
+#*********************************************************************
+#  This file is part of flatsurf.
+#
+#        Copyright (C) 2020 Julian Rüth
+#
+#  Flatsurf is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  Flatsurf is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+#*********************************************************************
+
+import json
+import re
+import sys
+
+OPERATIONS = ["add", "copy", "convert", "move", "addmul"]
+
+
+def main():
+    report = json.load(sys.stdin)
+
+    # The time per operation for each coordinate type.
+    costs = {}
+    for benchmark in report["benchmarks"]:
+        match = re.fullmatch(r"ChainVectorCost(Add|Copy|Convert|Move|Addmul)<(.*)>", benchmark["name"])
+        if not match:
+            continue
+        operation, coordinate = match.group(1).lower(), match.group(2).replace(" ", "")
+        costs.setdefault(coordinate, {})[operation] = 1 / benchmark["items_per_second"]
+
+    # All costs are relative to the addition of two Vector<long long>.
+    unit = costs["longlong"]["add"]
+
+    print("# name add copy convert move addmul")
+    for coordinate, cost in sorted(costs.items()):
+        if all(operation in cost for operation in OPERATIONS):
+            print(coordinate, *("%.3g" % (cost[operation] / unit) for operation in OPERATIONS))
+
+
+if __name__ == "__main__":
+    main()
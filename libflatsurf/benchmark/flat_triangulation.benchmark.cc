@@ -20,7 +20,13 @@
 
 #include <benchmark/benchmark.h>
 
+#include <random>
+#include <type_traits>
+
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flat_triangulation_combinatorial.hpp"
 #include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/isomorphism.hpp"
 #include "../flatsurf/vertical.hpp"
 #include "../test/surfaces.hpp"
 
@@ -49,4 +55,123 @@ BENCHMARK_TEMPLATE(FlatTriangulationFlip, Vector<mpq_class>);
 BENCHMARK_TEMPLATE(FlatTriangulationFlip, Vector<eantic::renf_elem_class>);
 BENCHMARK_TEMPLATE(FlatTriangulationFlip, Vector<exactreal::Element<exactreal::IntegerRing>>);
 
+// Benchmark how long it takes to Delaunay triangulate a surface of larger
+// genus that has been distorted by a random shear.
+template <typename Surface>
+void FlatTriangulationDelaunay(State& state, Surface makeSurface) {
+  const auto surface = makeSurface();
+
+  using T = typename std::decay_t<decltype(*surface)>::Coordinate;
+
+  std::mt19937 rand(1337);
+  std::uniform_int_distribution<int> shear(-32, 32);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    const int k = shear(rand);
+    auto sheared = FlatTriangulation<T>(static_cast<const FlatTriangulationCombinatorics<FlatTriangulation<T>>&>(*surface).clone(), [&](HalfEdge e) {
+      const auto v = surface->fromHalfEdge(e);
+      return Vector<T>(v.x() + k * v.y(), v.y());
+    });
+    state.ResumeTiming();
+
+    sheared.delaunay();
+  }
+}
+BENCHMARK_CAPTURE(FlatTriangulationDelaunay, make1234, [] { return make1234<Vector<eantic::renf_elem_class>>(); });
+BENCHMARK_CAPTURE(FlatTriangulationDelaunay, make235, [] { return make235<Vector<eantic::renf_elem_class>>(); });
+
+// Benchmark how long it takes to Delaunay triangulate a random square-tiled
+// surface made of "range" squares that has been distorted by a random
+// element of SL(2, Z).
+template <typename R2>
+void FlatTriangulationDelaunaySquareTiled(State& state) {
+  const auto surface = makeRandomlySheared(*makeRandomSquareTiled<R2>(static_cast<int>(state.range(0))));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto sheared = surface->clone();
+    state.ResumeTiming();
+
+    sheared.delaunay();
+  }
+
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK_TEMPLATE(FlatTriangulationDelaunaySquareTiled, Vector<long long>)->Range(1, 256)->Complexity();
+BENCHMARK_TEMPLATE(FlatTriangulationDelaunaySquareTiled, Vector<mpq_class>)->Range(1, 256)->Complexity();
+
+// Benchmark the same as FlatTriangulationDelaunaySquareTiled on 4096
+// squares but flipping in parallel rounds with "range" threads.
+template <typename R2>
+void FlatTriangulationDelaunaySquareTiledParallel(State& state) {
+  const auto surface = makeRandomlySheared(*makeRandomSquareTiled<R2>(4096));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto sheared = surface->clone();
+    state.ResumeTiming();
+
+    sheared.delaunay(static_cast<unsigned int>(state.range(0)));
+  }
+}
+BENCHMARK_TEMPLATE(FlatTriangulationDelaunaySquareTiledParallel, Vector<long long>)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(FlatTriangulationDelaunaySquareTiledParallel, Vector<mpq_class>)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+// Benchmark how long it takes to determine the automorphisms of a random
+// square-tiled surface made of "range" squares.
+template <typename R2>
+void FlatTriangulationIsomorphismSquareTiled(State& state) {
+  const auto surface = makeRandomSquareTiled<R2>(static_cast<int>(state.range(0)));
+
+  for (auto _ : state) {
+    DoNotOptimize(surface->isomorphism(*surface, ISOMORPHISM::FACES));
+  }
+
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK_TEMPLATE(FlatTriangulationIsomorphismSquareTiled, Vector<long long>)->Range(1, 256)->Complexity();
+
+// Benchmark how long it takes to Delaunay triangulate a surface whose
+// triangulation has been scrambled by random flips.
+template <typename Surface>
+void FlatTriangulationDelaunayFlipped(State& state, Surface makeSurface) {
+  const auto surface = makeSurface();
+  const auto flipped = makeRandomlyFlipped(*surface, static_cast<int>(4 * surface->size()));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto scrambled = flipped->clone();
+    state.ResumeTiming();
+
+    scrambled.delaunay();
+  }
+}
+BENCHMARK_CAPTURE(FlatTriangulationDelaunayFlipped, makeOctagon, [] { return makeOctagon<Vector<eantic::renf_elem_class>>(); });
+BENCHMARK_CAPTURE(FlatTriangulationDelaunayFlipped, makeHeptagonL, [] { return makeHeptagonL<Vector<eantic::renf_elem_class>>(); });
+BENCHMARK_CAPTURE(FlatTriangulationDelaunayFlipped, makeRandomSquareTiled/256, [] { return makeRandomSquareTiled<Vector<long long>>(256); });
+
+// Benchmark how long it takes to find an isomorphism between a surface and a
+// random relabeling of it. For ISOMORPHISM::DELAUNAY_CELLS, the surface is
+// Delaunay triangulated first.
+template <typename Surface>
+void FlatTriangulationIsomorphismRelabeled(State& state, Surface makeSurface, ISOMORPHISM kind) {
+  const auto surface = makeSurface();
+  if (kind == ISOMORPHISM::DELAUNAY_CELLS)
+    surface->delaunay();
+  const auto relabeled = makeRandomlyRelabeled(*surface);
+
+  for (auto _ : state) {
+    DoNotOptimize(surface->isomorphism(*relabeled, kind));
+  }
+}
+BENCHMARK_CAPTURE(FlatTriangulationIsomorphismRelabeled, makeOctagon/FACES, [] { return makeOctagon<Vector<eantic::renf_elem_class>>(); }, ISOMORPHISM::FACES);
+BENCHMARK_CAPTURE(FlatTriangulationIsomorphismRelabeled, makeOctagon/DELAUNAY_CELLS, [] { return makeOctagon<Vector<eantic::renf_elem_class>>(); }, ISOMORPHISM::DELAUNAY_CELLS);
+BENCHMARK_CAPTURE(FlatTriangulationIsomorphismRelabeled, makeHeptagonL/FACES, [] { return makeHeptagonL<Vector<eantic::renf_elem_class>>(); }, ISOMORPHISM::FACES);
+BENCHMARK_CAPTURE(FlatTriangulationIsomorphismRelabeled, makeHeptagonL/DELAUNAY_CELLS, [] { return makeHeptagonL<Vector<eantic::renf_elem_class>>(); }, ISOMORPHISM::DELAUNAY_CELLS);
+BENCHMARK_CAPTURE(FlatTriangulationIsomorphismRelabeled, make1234/FACES, [] { return make1234<Vector<eantic::renf_elem_class>>(); }, ISOMORPHISM::FACES);
+BENCHMARK_CAPTURE(FlatTriangulationIsomorphismRelabeled, make1234/DELAUNAY_CELLS, [] { return make1234<Vector<eantic::renf_elem_class>>(); }, ISOMORPHISM::DELAUNAY_CELLS);
+BENCHMARK_CAPTURE(FlatTriangulationIsomorphismRelabeled, makeRandomSquareTiled/256/FACES, [] { return makeRandomSquareTiled<Vector<long long>>(256); }, ISOMORPHISM::FACES);
+BENCHMARK_CAPTURE(FlatTriangulationIsomorphismRelabeled, makeRandomSquareTiled/256/DELAUNAY_CELLS, [] { return makeRandomSquareTiled<Vector<long long>>(256); }, ISOMORPHISM::DELAUNAY_CELLS);
+
 }  // namespace flatsurf::benchmark
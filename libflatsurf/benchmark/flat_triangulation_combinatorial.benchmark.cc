@@ -20,6 +20,8 @@
 
 #include <benchmark/benchmark.h>
 
+#include <random>
+
 #include "../flatsurf/half_edge.hpp"
 #include "../test/surfaces.hpp"
 
@@ -43,4 +45,16 @@ void FlatTriangulationCombinatorialFlip(State& state) {
 }
 BENCHMARK(FlatTriangulationCombinatorialFlip);
 
+void FlatTriangulationCombinatorialFlipRandom(State& state) {
+  auto surface = makeGenusCombinatorial(static_cast<int>(state.range(0)));
+
+  const auto& halfEdges = surface->halfEdges();
+  std::mt19937 random(1337);
+
+  for (auto _ : state) {
+    surface->flip(halfEdges[random() % halfEdges.size()]);
+  }
+}
+BENCHMARK(FlatTriangulationCombinatorialFlipRandom)->Arg(20)->Iterations(1000000);
+
 }  // namespace flatsurf::benchmark
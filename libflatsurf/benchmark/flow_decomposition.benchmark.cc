@@ -0,0 +1,195 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <e-antic/renfxx.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "../flatsurf/bound.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flow_decomposition.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connections.hpp"
+#include "../flatsurf/saddle_connections_by_length.hpp"
+#include "../flatsurf/saddle_connections_by_length_iterator.hpp"
+#include "../flatsurf/vector.hpp"
+#include "../test/surfaces.hpp"
+#include "allocations.hpp"
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+
+namespace flatsurf::benchmark {
+using namespace flatsurf::test;
+
+using T = eantic::renf_elem_class;
+using R2 = Vector<T>;
+using Surface = FlatTriangulation<T>;
+
+// The maximum number of steps of Zorich induction per component. Without
+// this limit, the decomposition would not terminate in minimal directions.
+constexpr int limit = 1024;
+
+// Directions on these Veech surfaces in which they decompose into
+// cylinders.
+std::vector<R2> cylinderDirections(const Surface&) {
+  return {R2(1, 0), R2(0, 1)};
+}
+
+// Directions with irrational slope on a square-tiled surface; the flow is
+// minimal in these directions.
+std::vector<R2> minimalDirections(const Surface&) {
+  return {R2(1, N->gen()), R2(N->gen(), 3)};
+}
+
+// The directions of some saddle connections on the surface. While these are
+// always the same, they are spread over the first saddle connections
+// ordered by length which are otherwise not special.
+std::vector<R2> saddleConnectionDirections(const Surface& surface) {
+  std::vector<R2> directions;
+  size_t i = 0;
+  for (const auto& connection : surface.connections().byLength()) {
+    if (i++ % 7)
+      continue;
+    directions.push_back(connection.vector());
+    if (directions.size() == 8)
+      break;
+  }
+  return directions;
+}
+
+using Surfaces = std::function<std::shared_ptr<Surface>()>;
+using Directions = std::function<std::vector<R2>(const Surface&)>;
+
+// Benchmark how long it takes to create the initial decomposition into
+// components, i.e., to construct the contour decomposition and the interval
+// exchange transformations of its components.
+void FlowDecompositionConstruction(State& state, Surfaces makeSurface, Directions makeDirections) {
+  const auto surface = makeSurface();
+  const auto directions = makeDirections(*surface);
+
+  Allocations allocations;
+  for (auto _ : state) {
+    for (const auto& direction : directions)
+      DoNotOptimize(FlowDecomposition<Surface>(surface->clone(), direction));
+  }
+  allocations.report(state);
+}
+
+// Benchmark how long it takes to decompose a surface completely (up to the
+// limit) once the initial decomposition has been constructed.
+void FlowDecompositionDecompose(State& state, Surfaces makeSurface, Directions makeDirections) {
+  const auto surface = makeSurface();
+  const auto directions = makeDirections(*surface);
+
+  Allocations allocations;
+  for (auto _ : state) {
+    state.PauseTiming();
+    allocations.pause();
+    std::vector<FlowDecomposition<Surface>> decompositions;
+    for (const auto& direction : directions)
+      decompositions.emplace_back(surface->clone(), direction);
+    allocations.resume();
+    state.ResumeTiming();
+
+    for (auto& decomposition : decompositions)
+      DoNotOptimize(decomposition.decompose(FlowDecomposition<Surface>::defaultTarget, limit));
+  }
+  allocations.report(state);
+}
+
+// Benchmark how long it takes to decide whether a decomposed surface is
+// parabolic, i.e., to compare the moduli of its cylinders.
+void FlowDecompositionParabolic(State& state, Surfaces makeSurface, Directions makeDirections) {
+  const auto surface = makeSurface();
+
+  std::vector<FlowDecomposition<Surface>> decompositions;
+  for (const auto& direction : makeDirections(*surface)) {
+    decompositions.emplace_back(surface->clone(), direction);
+    decompositions.back().decompose(FlowDecomposition<Surface>::defaultTarget, limit);
+  }
+
+  for (auto _ : state) {
+    for (const auto& decomposition : decompositions)
+      DoNotOptimize(decomposition.parabolic());
+  }
+}
+
+BENCHMARK_CAPTURE(FlowDecompositionConstruction, makeMcMullenL3125/cylinderDirections, [] { return makeMcMullenL3125<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionConstruction, makeMcMullenL3125/minimalDirections, [] { return makeMcMullenL3125<R2>(); }, minimalDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionConstruction, makeMcMullenL3125/saddleConnectionDirections, [] { return makeMcMullenL3125<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionConstruction, makeCathedralVeech/cylinderDirections, [] { return makeCathedralVeech<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionConstruction, makeCathedralVeech/saddleConnectionDirections, [] { return makeCathedralVeech<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionConstruction, makeOctagon/cylinderDirections, [] { return makeOctagon<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionConstruction, makeOctagon/saddleConnectionDirections, [] { return makeOctagon<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionConstruction, makeHeptagonL/cylinderDirections, [] { return makeHeptagonL<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionConstruction, makeHeptagonL/saddleConnectionDirections, [] { return makeHeptagonL<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionConstruction, makeMcMullenGenus2/cylinderDirections, [] { return makeMcMullenGenus2<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionConstruction, makeMcMullenGenus2/saddleConnectionDirections, [] { return makeMcMullenGenus2<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(FlowDecompositionDecompose, makeMcMullenL3125/cylinderDirections, [] { return makeMcMullenL3125<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionDecompose, makeMcMullenL3125/minimalDirections, [] { return makeMcMullenL3125<R2>(); }, minimalDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionDecompose, makeMcMullenL3125/saddleConnectionDirections, [] { return makeMcMullenL3125<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionDecompose, makeCathedralVeech/cylinderDirections, [] { return makeCathedralVeech<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionDecompose, makeCathedralVeech/saddleConnectionDirections, [] { return makeCathedralVeech<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionDecompose, makeOctagon/cylinderDirections, [] { return makeOctagon<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionDecompose, makeOctagon/saddleConnectionDirections, [] { return makeOctagon<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionDecompose, makeHeptagonL/cylinderDirections, [] { return makeHeptagonL<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionDecompose, makeHeptagonL/saddleConnectionDirections, [] { return makeHeptagonL<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionDecompose, makeMcMullenGenus2/cylinderDirections, [] { return makeMcMullenGenus2<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionDecompose, makeMcMullenGenus2/saddleConnectionDirections, [] { return makeMcMullenGenus2<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(FlowDecompositionParabolic, makeMcMullenL3125/cylinderDirections, [] { return makeMcMullenL3125<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionParabolic, makeMcMullenL3125/minimalDirections, [] { return makeMcMullenL3125<R2>(); }, minimalDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionParabolic, makeMcMullenL3125/saddleConnectionDirections, [] { return makeMcMullenL3125<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionParabolic, makeCathedralVeech/cylinderDirections, [] { return makeCathedralVeech<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionParabolic, makeCathedralVeech/saddleConnectionDirections, [] { return makeCathedralVeech<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionParabolic, makeOctagon/cylinderDirections, [] { return makeOctagon<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionParabolic, makeOctagon/saddleConnectionDirections, [] { return makeOctagon<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionParabolic, makeHeptagonL/cylinderDirections, [] { return makeHeptagonL<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionParabolic, makeHeptagonL/saddleConnectionDirections, [] { return makeHeptagonL<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionParabolic, makeMcMullenGenus2/cylinderDirections, [] { return makeMcMullenGenus2<R2>(); }, cylinderDirections)->Unit(::benchmark::kMillisecond);
+BENCHMARK_CAPTURE(FlowDecompositionParabolic, makeMcMullenGenus2/saddleConnectionDirections, [] { return makeMcMullenGenus2<R2>(); }, saddleConnectionDirections)->Unit(::benchmark::kMillisecond);
+
+// Benchmark how long it takes to decompose random square-tiled surfaces made
+// of "range" squares in a direction of irrational slope.
+void FlowDecompositionDecomposeSquareTiled(State& state) {
+  const auto surface = makeRandomSquareTiled<R2>(static_cast<int>(state.range(0)));
+
+  Allocations allocations;
+  for (auto _ : state) {
+    state.PauseTiming();
+    allocations.pause();
+    auto decomposition = FlowDecomposition<Surface>(surface->clone(), R2(1, N->gen()));
+    allocations.resume();
+    state.ResumeTiming();
+
+    DoNotOptimize(decomposition.decompose(FlowDecomposition<Surface>::defaultTarget, limit));
+  }
+  allocations.report(state);
+
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(FlowDecompositionDecomposeSquareTiled)->Range(1, 64)->Unit(::benchmark::kMillisecond)->Complexity();
+
+}  // namespace flatsurf::benchmark
@@ -20,7 +20,10 @@
 
 #include <benchmark/benchmark.h>
 
+#include <exact-real/element.hpp>
 #include <exact-real/integer_ring.hpp>
+#include <exact-real/module.hpp>
+#include <exact-real/real_number.hpp>
 
 #include "../flatsurf/bound.hpp"
 #include "../flatsurf/deformation.hpp"
@@ -31,8 +34,10 @@
 #include "../flatsurf/saddle_connections_by_length.hpp"
 #include "../flatsurf/saddle_connections_by_length_iterator.hpp"
 #include "../flatsurf/saddle_connections_iterator.hpp"
+#include "../flatsurf/saddle_connections_sample.hpp"
 #include "../flatsurf/vector.hpp"
 #include "../test/surfaces.hpp"
+#include "allocations.hpp"
 
 using benchmark::DoNotOptimize;
 using benchmark::State;
@@ -48,28 +53,118 @@ void SaddleConnectionsSquare(State& state) {
   const auto square = makeSquare<R2>();
   const auto bound = Bound(state.range(0), 0);
 
+  Allocations allocations;
   for (auto _ : state) {
     const auto connections = SaddleConnections<FlatTriangulation<typename R2::Coordinate>>(*square).bound(bound);
     DoNotOptimize(std::distance(begin(connections), end(connections)));
   }
+  allocations.report(state);
 }
 BENCHMARK_TEMPLATE(SaddleConnectionsSquare, Vector<long long>)->Range(1, 64);
 BENCHMARK_TEMPLATE(SaddleConnectionsSquare, Vector<mpq_class>)->Range(1, 64);
 BENCHMARK_TEMPLATE(SaddleConnectionsSquare, Vector<eantic::renf_elem_class>)->Range(1, 64);
 BENCHMARK_TEMPLATE(SaddleConnectionsSquare, Vector<exactreal::Element<exactreal::IntegerRing>>)->Range(1, 64);
 
+// Benchmark the same as SaddleConnectionsSquare on a square whose
+// coordinates come from different exact-real modules. The surface promotes
+// them to a common module, so this should be as fast as the enumeration on
+// the square with integer coordinates in a single module.
+void SaddleConnectionsSquareModules(State& state) {
+  using exactreal::IntegerRing;
+  using exactreal::Module;
+  using exactreal::RealNumber;
+  using T = exactreal::Element<IntegerRing>;
+
+  const auto rational = Module<IntegerRing>::make({RealNumber::rational(1)});
+  const auto irrational = Module<IntegerRing>::make({RealNumber::rational(1), RealNumber::random()});
+  const T one = rational->gen(0);
+  const T other = irrational->gen(0);
+
+  const auto square = FlatTriangulation<T>(std::move(*makeSquareCombinatorial()), std::vector{Vector<T>(one, 0 * other), Vector<T>(0 * one, other), Vector<T>(one, other)});
+  const auto bound = Bound(state.range(0), 0);
+
+  Allocations allocations;
+  for (auto _ : state) {
+    const auto connections = SaddleConnections<FlatTriangulation<T>>(square).bound(bound);
+    DoNotOptimize(std::distance(begin(connections), end(connections)));
+  }
+  allocations.report(state);
+}
+BENCHMARK(SaddleConnectionsSquareModules)->Range(1, 64);
+
+// Benchmark the same as SaddleConnectionsSquare but with the frame-based
+// search of forEach() on a single thread.
+template <typename R2>
+void SaddleConnectionsForEachSquare(State& state) {
+  const auto square = makeSquare<R2>();
+  const auto bound = Bound(state.range(0), 0);
+
+  Allocations allocations;
+  for (auto _ : state) {
+    const auto connections = SaddleConnections<FlatTriangulation<typename R2::Coordinate>>(*square).bound(bound);
+    size_t count = 0;
+    connections.forEach([&](const auto&) { count++; }, 1);
+    DoNotOptimize(count);
+  }
+  allocations.report(state);
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsForEachSquare, Vector<long long>)->Range(1, 64);
+BENCHMARK_TEMPLATE(SaddleConnectionsForEachSquare, Vector<mpq_class>)->Range(1, 64);
+BENCHMARK_TEMPLATE(SaddleConnectionsForEachSquare, Vector<eantic::renf_elem_class>)->Range(1, 64);
+BENCHMARK_TEMPLATE(SaddleConnectionsForEachSquare, Vector<exactreal::Element<exactreal::IntegerRing>>)->Range(1, 64);
+
+// Benchmark how long it takes to count all saddle connections up to length
+// "bound" in a torus without creating the actual SaddleConnection objects.
+template <typename R2>
+void SaddleConnectionsCountSquare(State& state) {
+  const auto square = makeSquare<R2>();
+  const auto bound = Bound(state.range(0), 0);
+
+  Allocations allocations;
+  for (auto _ : state) {
+    const auto connections = SaddleConnections<FlatTriangulation<typename R2::Coordinate>>(*square).bound(bound);
+    DoNotOptimize(connections.count());
+  }
+  allocations.report(state);
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsCountSquare, Vector<long long>)->Range(1, 64);
+BENCHMARK_TEMPLATE(SaddleConnectionsCountSquare, Vector<mpq_class>)->Range(1, 64);
+BENCHMARK_TEMPLATE(SaddleConnectionsCountSquare, Vector<eantic::renf_elem_class>)->Range(1, 64);
+BENCHMARK_TEMPLATE(SaddleConnectionsCountSquare, Vector<exactreal::Element<exactreal::IntegerRing>>)->Range(1, 64);
+
+// Benchmark how long it takes to count the saddle connections of length at
+// most 8 on random square-tiled surfaces made of "range" squares.
+template <typename R2>
+void SaddleConnectionsCountSquareTiled(State& state) {
+  const auto surface = makeRandomSquareTiled<R2>(static_cast<int>(state.range(0)));
+  const auto bound = Bound(8, 0);
+
+  Allocations allocations;
+  for (auto _ : state) {
+    const auto connections = SaddleConnections<FlatTriangulation<typename R2::Coordinate>>(*surface).bound(bound);
+    DoNotOptimize(connections.count());
+  }
+  allocations.report(state);
+
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsCountSquareTiled, Vector<long long>)->Range(1, 256)->Complexity();
+BENCHMARK_TEMPLATE(SaddleConnectionsCountSquareTiled, Vector<eantic::renf_elem_class>)->Range(1, 256)->Complexity();
+
 // Benchmark how long it takes to enumaret all saddle connections up to length "bound" in the L surface.
 template <typename R2>
 void SaddleConnectionsL(State& state) {
   const auto L = makeL<R2>();
   const auto bound = Bound(state.range(0), 0);
 
+  Allocations allocations;
   for (auto _ : state) {
     auto connections = SaddleConnections<FlatTriangulation<typename R2::Coordinate>>(*L).bound(bound);
     DoNotOptimize(std::distance(begin(connections), end(connections)));
   }
+  allocations.report(state);
 }
-BENCHMARK_TEMPLATE(SaddleConnectionsL, Vector<long long>)->Range(1, 64);
+BENCHMARK_TEMPLATE(SaddleConnectionsL, Vector<long long>)->Range(1, 1024);
 BENCHMARK_TEMPLATE(SaddleConnectionsL, Vector<mpq_class>)->Range(1, 64);
 BENCHMARK_TEMPLATE(SaddleConnectionsL, Vector<eantic::renf_elem_class>)->Range(1, 64);
 BENCHMARK_TEMPLATE(SaddleConnectionsL, Vector<exactreal::Element<exactreal::IntegerRing>>)->Range(1, 64);
@@ -86,6 +181,7 @@ void SaddleConnectionsByLength(State& state) {
       static_cast<const FlatTriangulationCombinatorial&>(*surface).clone(),
       [&](const HalfEdge he) { return surface->fromHalfEdge(he) / static_cast<int>(scale); });
 
+  Allocations allocations;
   for (auto _ : state) {
     const auto connections = SaddleConnections<FlatTriangulation<typename R2::Coordinate>>(scaled).byLength();
     auto it = begin(connections);
@@ -93,10 +189,35 @@ void SaddleConnectionsByLength(State& state) {
     for (int i = 0; i < scale; i++)
       DoNotOptimize(++it);
   }
+  allocations.report(state);
 }
 BENCHMARK_TEMPLATE(SaddleConnectionsByLength, Vector<eantic::renf_elem_class>)->Arg(1)->Arg(64);
 BENCHMARK_TEMPLATE(SaddleConnectionsByLength, Vector<exactreal::Element<exactreal::NumberField>>)->Arg(1)->Arg(64);
 
+// Benchmark the same as SaddleConnectionsByLength but with a best-first
+// search.
+template <typename R2>
+void SaddleConnectionsBestFirst(State& state) {
+  auto surface = make1234<R2>();
+  const auto scale = state.range(0);
+
+  const auto scaled = FlatTriangulation<typename R2::Coordinate>(
+      static_cast<const FlatTriangulationCombinatorial&>(*surface).clone(),
+      [&](const HalfEdge he) { return surface->fromHalfEdge(he) / static_cast<int>(scale); });
+
+  Allocations allocations;
+  for (auto _ : state) {
+    int reported = 0;
+    SaddleConnections<FlatTriangulation<typename R2::Coordinate>>(scaled).forEachByLength([&](const auto& connection) {
+      DoNotOptimize(connection);
+      return ++reported < scale;
+    });
+  }
+  allocations.report(state);
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsBestFirst, Vector<eantic::renf_elem_class>)->Arg(1)->Arg(64);
+BENCHMARK_TEMPLATE(SaddleConnectionsBestFirst, Vector<exactreal::Element<exactreal::NumberField>>)->Arg(1)->Arg(64);
+
 // Benchmark how long it takes to get a single random saddle connection in the
 // torus that longer that "bound". (This is crucial in sage-flatsurf in the
 // later process when trying to compute orbit closures.)
@@ -107,15 +228,35 @@ void SaddleConnectionsSampleSquare(State& state) {
 
   const auto connections = SaddleConnections<FlatTriangulation<typename R2::Coordinate>>(*square).lowerBound(bound);
 
+  Allocations allocations;
   for (auto _ : state) {
     DoNotOptimize(*begin(connections));
   }
+  allocations.report(state);
 }
 BENCHMARK_TEMPLATE(SaddleConnectionsSampleSquare, Vector<long long>)->Arg(256)->Arg(65536);
 BENCHMARK_TEMPLATE(SaddleConnectionsSampleSquare, Vector<mpq_class>)->Arg(256)->Arg(65536);
 BENCHMARK_TEMPLATE(SaddleConnectionsSampleSquare, Vector<eantic::renf_elem_class>)->Arg(256)->Arg(65536);
 BENCHMARK_TEMPLATE(SaddleConnectionsSampleSquare, Vector<exactreal::Element<exactreal::IntegerRing>>)->Arg(256)->Arg(65536);
 
+// Benchmark how long it takes to get 1024 random saddle connections in the
+// torus that are longer than "bound" with all available threads.
+template <typename R2>
+void SaddleConnectionsSampleParallelSquare(State& state) {
+  const auto square = makeSquare<R2>();
+  const auto bound = Bound(state.range(0), 0);
+
+  const auto connections = SaddleConnections<FlatTriangulation<typename R2::Coordinate>>(*square).sample().lowerBound(bound);
+
+  Allocations allocations;
+  for (auto _ : state) {
+    connections.forEach(1024, [](const auto& connection) { DoNotOptimize(connection); });
+  }
+  allocations.report(state);
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsSampleParallelSquare, Vector<long long>)->Arg(256)->Arg(65536);
+BENCHMARK_TEMPLATE(SaddleConnectionsSampleParallelSquare, Vector<eantic::renf_elem_class>)->Arg(256)->Arg(65536);
+
 // Benchmark how long it takes to enumerate all saddle connections up to length
 // "bound" in an L with an added slit.
 template <typename R2>
@@ -128,10 +269,12 @@ void SaddleConnectionsLWithSlit(State& state) {
 
   const auto LWithSlit = L->insertAt(e, vector).surface().slit(e).surface();
 
+  Allocations allocations;
   for (auto _ : state) {
     auto connections = SaddleConnections<FlatTriangulation<typename R2::Coordinate>>(LWithSlit).bound(bound).source(Vertex::source(e, LWithSlit));
     DoNotOptimize(std::distance(begin(connections), end(connections)));
   }
+  allocations.report(state);
 }
 BENCHMARK_TEMPLATE(SaddleConnectionsLWithSlit, Vector<mpq_class>)->Range(1, 64);
 BENCHMARK_TEMPLATE(SaddleConnectionsLWithSlit, Vector<eantic::renf_elem_class>)->Range(1, 64);
@@ -0,0 +1,160 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#include <benchmark/benchmark.h>
+
+#include <e-antic/renfxx.h>
+
+#include <atomic>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "../flatsurf/bound.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flow_decomposition.hpp"
+#include "../flatsurf/flow_decompositions.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connections.hpp"
+#include "../flatsurf/saddle_connections_by_length.hpp"
+#include "../flatsurf/saddle_connections_by_length_iterator.hpp"
+#include "../flatsurf/saddle_connections_sample.hpp"
+#include "../flatsurf/vector.hpp"
+#include "../test/surfaces.hpp"
+#include "scaling.hpp"
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+
+// Benchmarks of the parallel engines of the library on large synthetic
+// surfaces with 1, 2, 4, …, 64 threads. Besides the wall time of each run,
+// these report the speedup and the efficiency compared to the run with a
+// single thread so that changes to state that is shared between the threads
+// do not silently degrade the scalability.
+
+namespace flatsurf::benchmark {
+using namespace flatsurf::test;
+
+namespace {
+
+using T = eantic::renf_elem_class;
+using R2 = Vector<T>;
+using Surface = FlatTriangulation<T>;
+
+// The maximum number of steps of Zorich induction per component.
+constexpr int limit = 1024;
+
+// Return the directions of the first count saddle connections of surface
+// ordered by length.
+std::vector<R2> directions(const Surface& surface, size_t count) {
+  std::vector<R2> directions;
+  for (const auto& connection : surface.connections().byLength()) {
+    directions.push_back(connection.vector());
+    if (directions.size() == count)
+      break;
+  }
+  return directions;
+}
+
+}  // namespace
+
+// Benchmark how long it takes to enumerate the saddle connections of length
+// at most 16 on a random square-tiled surface made of "range(1)" squares with
+// "range(0)" threads.
+template <typename R>
+void SaddleConnectionsForEachScaling(State& state) {
+  const auto surface = makeRandomSquareTiled<R>(static_cast<int>(state.range(1)));
+  const auto connections = SaddleConnections<FlatTriangulation<typename R::Coordinate>>(*surface).bound(Bound(16, 0));
+
+  Scaling scaling(state, std::string("SaddleConnectionsForEachScaling/") + typeid(R).name() + "/" + std::to_string(state.range(1)));
+  for (auto _ : state) {
+    std::atomic<size_t> count = 0;
+    scaling.start();
+    connections.forEach([&](const auto&) { count++; }, scaling.threads());
+    scaling.stop();
+    DoNotOptimize(count.load());
+  }
+  scaling.report(state);
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsForEachScaling, Vector<long long>)->Apply([](::benchmark::internal::Benchmark* benchmark) { threadRange(benchmark, {64}); })->Unit(::benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(SaddleConnectionsForEachScaling, Vector<eantic::renf_elem_class>)->Apply([](::benchmark::internal::Benchmark* benchmark) { threadRange(benchmark, {64}); })->Unit(::benchmark::kMillisecond);
+
+// Benchmark how long it takes to sample 4096 saddle connections of length at
+// least 256 on a random square-tiled surface made of "range(1)" squares with
+// "range(0)" threads.
+template <typename R>
+void SaddleConnectionsSampleScaling(State& state) {
+  const auto surface = makeRandomSquareTiled<R>(static_cast<int>(state.range(1)));
+  const auto connections = SaddleConnections<FlatTriangulation<typename R::Coordinate>>(*surface).sample().lowerBound(Bound(256, 0));
+
+  Scaling scaling(state, std::string("SaddleConnectionsSampleScaling/") + typeid(R).name() + "/" + std::to_string(state.range(1)));
+  for (auto _ : state) {
+    scaling.start();
+    connections.forEach(
+        4096, [](const auto& connection) { DoNotOptimize(connection); }, scaling.threads(), 1337);
+    scaling.stop();
+  }
+  scaling.report(state);
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsSampleScaling, Vector<long long>)->Apply([](::benchmark::internal::Benchmark* benchmark) { threadRange(benchmark, {64}); })->Unit(::benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(SaddleConnectionsSampleScaling, Vector<eantic::renf_elem_class>)->Apply([](::benchmark::internal::Benchmark* benchmark) { threadRange(benchmark, {64}); })->Unit(::benchmark::kMillisecond);
+
+// Benchmark how long it takes to decompose a random square-tiled surface made
+// of "range(1)" squares in a direction of irrational slope, distributing its
+// components over "range(0)" threads.
+void FlowDecompositionDecomposeScaling(State& state) {
+  const auto surface = makeRandomSquareTiled<R2>(static_cast<int>(state.range(1)));
+
+  Scaling scaling(state, "FlowDecompositionDecomposeScaling/" + std::to_string(state.range(1)));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto decomposition = FlowDecomposition<Surface>(surface->clone(), R2(1, N->gen()));
+    state.ResumeTiming();
+
+    scaling.start();
+    DoNotOptimize(decomposition.decompose(FlowDecomposition<Surface>::defaultTarget, limit, scaling.threads()));
+    scaling.stop();
+  }
+  scaling.report(state);
+}
+BENCHMARK(FlowDecompositionDecomposeScaling)->Apply([](::benchmark::internal::Benchmark* benchmark) { threadRange(benchmark, {64}); })->Unit(::benchmark::kMillisecond);
+
+// Benchmark how long it takes to decompose a random square-tiled surface made
+// of "range(1)" squares in the directions of its first 64 saddle
+// connections, distributing the directions over "range(0)" threads.
+void FlowDecompositionsScaling(State& state) {
+  const auto surface = makeRandomSquareTiled<R2>(static_cast<int>(state.range(1)));
+  const auto decompositions = FlowDecompositions<Surface>(*surface, directions(*surface, 64));
+
+  Scaling scaling(state, "FlowDecompositionsScaling/" + std::to_string(state.range(1)));
+  for (auto _ : state) {
+    scaling.start();
+    decompositions.forEach([](auto&& decomposition, bool) {
+      DoNotOptimize(decomposition);
+      return true;
+    },
+        FlowDecomposition<Surface>::defaultTarget, limit, scaling.threads());
+    scaling.stop();
+  }
+  scaling.report(state);
+}
+BENCHMARK(FlowDecompositionsScaling)->Apply([](::benchmark::internal::Benchmark* benchmark) { threadRange(benchmark, {16}); })->Unit(::benchmark::kMillisecond);
+
+}  // namespace flatsurf::benchmark
@@ -0,0 +1,93 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#include "scaling.hpp"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace flatsurf::benchmark {
+
+namespace {
+
+// The wall time per iteration of the single-threaded run of each scaling
+// benchmark, keyed by the key given to Scaling.
+std::map<std::string, double>& baselines() {
+  static std::map<std::string, double> baselines;
+  return baselines;
+}
+
+std::mutex baselinesMutex;
+
+}  // namespace
+
+Scaling::Scaling(const ::benchmark::State& state, std::string key) :
+  key(std::move(key)),
+  threadCount(static_cast<unsigned int>(state.range(0))) {}
+
+unsigned int Scaling::threads() const {
+  return threadCount;
+}
+
+void Scaling::start() {
+  started = std::chrono::steady_clock::now();
+}
+
+void Scaling::stop() {
+  seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+  iterations++;
+}
+
+void Scaling::report(::benchmark::State& state) const {
+  state.counters["threads"] = threadCount;
+
+  if (iterations == 0)
+    return;
+
+  const double perIteration = seconds / static_cast<double>(iterations);
+
+  std::lock_guard lock(baselinesMutex);
+  if (threadCount == 1)
+    baselines()[key] = perIteration;
+
+  const auto baseline = baselines().find(key);
+  if (baseline == baselines().end())
+    return;
+
+  const double speedup = baseline->second / perIteration;
+  state.counters["speedup"] = speedup;
+  state.counters["efficiency"] = speedup / threadCount;
+}
+
+void threadRange(::benchmark::internal::Benchmark* benchmark, std::vector<int64_t> args, int max) {
+  args.insert(args.begin(), 0);
+  for (int threads = 1;; threads *= 2) {
+    args.front() = std::min(threads, max);
+    benchmark->Args(args);
+    if (threads >= max)
+      break;
+  }
+  benchmark->UseRealTime();
+}
+
+}  // namespace flatsurf::benchmark
@@ -0,0 +1,79 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#ifndef LIBFLATSURF_BENCHMARK_SCALING_HPP
+#define LIBFLATSURF_BENCHMARK_SCALING_HPP
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace flatsurf::benchmark {
+
+// Reports how well a parallel operation scales with the number of threads.
+//
+// A scaling benchmark is registered with the number of threads as its first
+// argument, see threadRange(), and times the wall time of each iteration.
+// The timings of the run with a single thread are remembered under the given
+// key (which should identify the benchmark and its other arguments) so that
+// the runs with more threads (which Google Benchmark runs later) can report
+// counters "speedup" and "efficiency", i.e., the speedup divided by the
+// number of threads. Typical usage:
+//
+//   Scaling scaling(state, "SaddleConnections/" + std::to_string(state.range(1)));
+//   for (auto _ : state) {
+//     scaling.start();
+//     ... (scaling.threads()) ...
+//     scaling.stop();
+//   }
+//   scaling.report(state);
+class Scaling {
+ public:
+  Scaling(const ::benchmark::State& state, std::string key);
+
+  // The number of threads this run should use, i.e., the first argument of
+  // the benchmark.
+  unsigned int threads() const;
+
+  // Time the section of an iteration between start() and stop().
+  void start();
+  void stop();
+
+  // Add the counters "threads", "speedup", and "efficiency" to state.
+  void report(::benchmark::State& state) const;
+
+ private:
+  std::string key;
+  unsigned int threadCount;
+  std::chrono::steady_clock::time_point started;
+  double seconds = 0;
+  size_t iterations = 0;
+};
+
+// Register the number of threads 1, 2, 4, …, max (and max itself) as the
+// first argument of benchmark, followed by the given other arguments.
+void threadRange(::benchmark::internal::Benchmark* benchmark, std::vector<int64_t> args, int max = 64);
+
+}  // namespace flatsurf::benchmark
+
+#endif
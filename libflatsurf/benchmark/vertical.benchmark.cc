@@ -0,0 +1,146 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <e-antic/renfxx.h>
+
+#include "../flatsurf/ccw.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/vector.hpp"
+#include "../flatsurf/vertical.hpp"
+#include "../test/generators/real_generator.hpp"
+#include "../test/surfaces.hpp"
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+
+namespace flatsurf::benchmark {
+using namespace flatsurf::test;
+
+// Return a surface with coordinates of type T that is small enough so that
+// the benchmarks measure the predicates and not the iteration over its half
+// edges.
+template <typename T>
+auto makeVerticalSurface() {
+  if constexpr (hasNumberFieldElements<T>) {
+    return make1221<Vector<T>>();
+  } else {
+    return makeL<Vector<T>>();
+  }
+}
+
+// Run `predicate` for all half edges of a surface in a generic direction. If
+// `warm`, the Vertical is created once, so its caches are populated after the
+// first iteration. Otherwise, a new Vertical with empty caches is created in
+// each iteration. (Verticals in the same direction share their caches while
+// they are alive, so the previous one must be gone for the caches to be
+// cold.)
+template <typename T, bool warm, typename Predicate>
+void benchmarkVertical(State& state, Predicate&& predicate) {
+  const auto surface = makeVerticalSurface<T>();
+  const auto direction = Vector<T>(13, 37);
+
+  const auto run = [&](const auto& vertical) {
+    for (const auto he : surface->halfEdges())
+      DoNotOptimize(predicate(vertical, he));
+  };
+
+  if constexpr (warm) {
+    const auto vertical = Vertical(*surface, direction);
+    for (auto _ : state)
+      run(vertical);
+  } else {
+    for (auto _ : state)
+      run(Vertical(*surface, direction));
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * surface->halfEdges().size()));
+}
+
+template <typename T, bool warm>
+void VerticalClassifyFace(State& state) {
+  benchmarkVertical<T, warm>(state, [](const auto& vertical, HalfEdge he) { return vertical.classifyFace(he); });
+}
+
+template <typename T, bool warm>
+void VerticalLarge(State& state) {
+  benchmarkVertical<T, warm>(state, [](const auto& vertical, HalfEdge he) { return vertical.large(he); });
+}
+
+template <typename T, bool warm>
+void VerticalProject(State& state) {
+  benchmarkVertical<T, warm>(state, [](const auto& vertical, HalfEdge he) { return vertical.project(he); });
+}
+
+template <typename T, bool warm>
+void VerticalProjectPerpendicular(State& state) {
+  benchmarkVertical<T, warm>(state, [](const auto& vertical, HalfEdge he) { return vertical.projectPerpendicular(he); });
+}
+
+template <typename T, bool warm>
+void VerticalCCW(State& state) {
+  benchmarkVertical<T, warm>(state, [](const auto& vertical, HalfEdge he) { return vertical.ccw(he); });
+}
+
+// Benchmark how long it takes to create a Vertical, i.e., to set up its
+// (empty) caches.
+template <typename T>
+void VerticalCreate(State& state) {
+  const auto surface = makeVerticalSurface<T>();
+  const auto direction = Vector<T>(13, 37);
+
+  for (auto _ : state)
+    DoNotOptimize(Vertical(*surface, direction));
+}
+
+// Register a benchmark with cold and warm caches for all the coordinate types
+// in LIBFLATSURF_REAL_TYPES.
+#define LIBFLATSURF_BENCHMARK_VERTICAL(name)                                           \
+  BENCHMARK_TEMPLATE(name, long long, false);                                          \
+  BENCHMARK_TEMPLATE(name, long long, true);                                           \
+  BENCHMARK_TEMPLATE(name, mpz_class, false);                                          \
+  BENCHMARK_TEMPLATE(name, mpz_class, true);                                           \
+  BENCHMARK_TEMPLATE(name, mpq_class, false);                                          \
+  BENCHMARK_TEMPLATE(name, mpq_class, true);                                           \
+  BENCHMARK_TEMPLATE(name, eantic::renf_elem_class, false);                            \
+  BENCHMARK_TEMPLATE(name, eantic::renf_elem_class, true);                             \
+  BENCHMARK_TEMPLATE(name, exactreal::Element<exactreal::IntegerRing>, false);         \
+  BENCHMARK_TEMPLATE(name, exactreal::Element<exactreal::IntegerRing>, true);          \
+  BENCHMARK_TEMPLATE(name, exactreal::Element<exactreal::RationalField>, false);       \
+  BENCHMARK_TEMPLATE(name, exactreal::Element<exactreal::RationalField>, true);        \
+  BENCHMARK_TEMPLATE(name, exactreal::Element<exactreal::NumberField>, false);         \
+  BENCHMARK_TEMPLATE(name, exactreal::Element<exactreal::NumberField>, true)
+
+LIBFLATSURF_BENCHMARK_VERTICAL(VerticalClassifyFace);
+LIBFLATSURF_BENCHMARK_VERTICAL(VerticalLarge);
+LIBFLATSURF_BENCHMARK_VERTICAL(VerticalProject);
+LIBFLATSURF_BENCHMARK_VERTICAL(VerticalProjectPerpendicular);
+LIBFLATSURF_BENCHMARK_VERTICAL(VerticalCCW);
+
+BENCHMARK_TEMPLATE(VerticalCreate, long long);
+BENCHMARK_TEMPLATE(VerticalCreate, mpz_class);
+BENCHMARK_TEMPLATE(VerticalCreate, mpq_class);
+BENCHMARK_TEMPLATE(VerticalCreate, eantic::renf_elem_class);
+BENCHMARK_TEMPLATE(VerticalCreate, exactreal::Element<exactreal::IntegerRing>);
+BENCHMARK_TEMPLATE(VerticalCreate, exactreal::Element<exactreal::RationalField>);
+BENCHMARK_TEMPLATE(VerticalCreate, exactreal::Element<exactreal::NumberField>);
+
+}  // namespace flatsurf::benchmark
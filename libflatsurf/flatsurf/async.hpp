@@ -0,0 +1,112 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_ASYNC_HPP
+#define LIBFLATSURF_ASYNC_HPP
+
+#include <functional>
+#include <future>
+#include <iosfwd>
+#include <optional>
+#include <vector>
+
+#include "copyable.hpp"
+#include "decomposition_budget.hpp"
+#include "deformation.hpp"
+#include "flow_decomposition.hpp"
+#include "isomorphism.hpp"
+#include "saddle_connection.hpp"
+#include "saddle_connections.hpp"
+
+namespace flatsurf {
+
+// Runs the expensive operations on a surface without blocking the calling
+// thread. Each operation returns a future immediately and runs on the
+// executor this was created with.
+// The operations can be cancelled cooperatively with the budget they are
+// started with, see DecompositionBudget::cancel(). The budget is checked in
+// the inner loops of the operation, so a cancelled operation completes
+// shortly after. Its result is then the partial result of the operation,
+// e.g., a partially decomposed flow decomposition that can be resumed later.
+template <typename Surface>
+class Async {
+  static_assert(std::is_same_v<Surface, std::decay_t<Surface>>, "type must not have modifiers such as const");
+
+  using T = typename Surface::Coordinate;
+
+ public:
+  // Runs a task on some thread. The executor must eventually invoke each
+  // task it is given exactly once.
+  using Executor = std::function<void(std::function<void()>)>;
+
+  // Create a facade for the operations on surface. If no executor is given,
+  // each operation runs on a thread of its own (as with std::async.) Note
+  // that then destroying the future of an operation waits for it to
+  // complete; cancel its budget to not wait for long.
+  // The surface must not be modified while operations are running.
+  explicit Async(const Surface &, Executor executor = {});
+
+  // Return the flow decomposition of the surface in the direction vertical,
+  // decomposed as with FlowDecomposition::decompose().
+  std::future<FlowDecomposition<Surface>> flowDecomposition(
+      const Vector<T> &vertical,
+      std::function<bool(const FlowComponent<Surface> &)> target = FlowDecomposition<Surface>::defaultTarget,
+      const DecompositionBudget &budget = DecompositionBudget()) const;
+
+  // Return a Delaunay triangulation of a copy of the surface, see
+  // FlatTriangulation::delaunay(). If the budget runs out, the copy might
+  // not be Delaunay triangulated yet; calling delaunay() on it completes the
+  // triangulation.
+  std::future<Surface> delaunay(const DecompositionBudget &budget = DecompositionBudget()) const;
+
+  // Return an isomorphism from the surface to other as with
+  // FlatTriangulation::isomorphism(). If the budget runs out, no further
+  // isomorphisms are considered, so the result might be missing.
+  std::future<std::optional<Deformation<Surface>>> isomorphism(
+      const Surface &other,
+      ISOMORPHISM kind,
+      std::function<bool(const T &, const T &, const T &, const T &)> = [](const T &a, const T &b, const T &c, const T &d) { return a == 1 && b == 0 && c == 0 && d == 1; },
+      std::function<bool(HalfEdge, HalfEdge)> = [](HalfEdge, HalfEdge) { return true; },
+      const DecompositionBudget &budget = DecompositionBudget(),
+      unsigned int threads = 1) const;
+
+  // Return the saddle connections produced by connections, which must be
+  // saddle connections on the surface, in the order they are produced. If
+  // the budget runs out, only the connections produced until then are
+  // returned. Typically, connections is bounded, e.g., with
+  // SaddleConnections::bound().
+  std::future<std::vector<SaddleConnection<Surface>>> connections(const SaddleConnections<Surface> &connections, const DecompositionBudget &budget = DecompositionBudget()) const;
+
+  const Surface &surface() const;
+
+  template <typename S>
+  friend std::ostream &operator<<(std::ostream &, const Async<S> &);
+
+ private:
+  Copyable<Async> self;
+
+  friend ImplementationOf<Async>;
+};
+
+template <typename Surface, typename... Args>
+Async(const Surface &, Args &&...) -> Async<Surface>;
+
+}  // namespace flatsurf
+
+#endif
@@ -24,6 +24,7 @@
 
 #include <boost/operators.hpp>
 #include <iosfwd>
+#include <optional>
 
 #include "forward.hpp"
 
@@ -46,6 +47,10 @@ class Bound : boost::totally_ordered<Bound>, boost::multipliable<Bound, mpz_clas
 
   const mpz_class& squared() const;
 
+  // Return the squared length if it fits into a long long so that
+  // comparisons can be done without going through GMP.
+  std::optional<long long> machineSquared() const;
+
   bool operator==(const Bound&) const;
   bool operator<(const Bound&) const;
 
@@ -60,8 +65,14 @@ class Bound : boost::totally_ordered<Bound>, boost::multipliable<Bound, mpz_clas
   friend std::ostream& operator<<(std::ostream&, const Bound&);
 
  private:
+  // Update small after square changed.
+  void normalize();
+
   mpz_class square;
 
+  // The value of square if it fits into a long long, -1 otherwise.
+  long long small;
+
   friend cereal::access;
 
   template <typename Archive>
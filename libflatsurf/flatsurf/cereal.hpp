@@ -25,24 +25,35 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <boost/logic/tribool.hpp>
 #include <cereal/types/memory.hpp>
 #include <cereal/types/unordered_map.hpp>
 #include <cereal/types/utility.hpp>
 #include <cereal/types/vector.hpp>
+#include <cstdint>
 #include <exact-real/cereal.hpp>
+#include <optional>
+#include <stdexcept>
+#include <variant>
 
 #include "bound.hpp"
 #include "chain.hpp"
 #include "edge.hpp"
 #include "flat_triangulation.hpp"
 #include "flat_triangulation_combinatorial.hpp"
+#include "flow_decomposition_summary.hpp"
 #include "forward.hpp"
 #include "half_edge.hpp"
 #include "half_edge_set.hpp"
 #include "half_edge_set_iterator.hpp"
 #include "permutation.hpp"
 #include "saddle_connection.hpp"
+#include "saddle_connection_records.hpp"
 #include "saddle_connections.hpp"
+#include "saddle_connections_buckets.hpp"
+#include "saddle_connections_iterator_checkpoint.hpp"
+#include "saddle_connections_work_unit.hpp"
+#include "tracing.hpp"
 #include "vector.hpp"
 #include "vertex.hpp"
 
@@ -52,8 +63,8 @@ namespace {
 
 // Defines serialization for a type T without polluting the global namespace,
 // i.e., other libraries might still decide to serialize this type differently.
-// This is used for types such as mpz_class which do not provide an official
-// serialization with cereal.
+// This is used for types such as mpz_class or boost::logic::tribool which do
+// not provide an official serialization with cereal.
 template <typename T>
 struct ReplacementSerialization {
   static auto serializable(const T& value) {
@@ -61,6 +72,8 @@ struct ReplacementSerialization {
       return value.get_str();
     } else if constexpr (std::is_same_v<T, mpq_class>) {
       return value.get_str();
+    } else if constexpr (std::is_same_v<T, boost::logic::tribool>) {
+      return value ? 1 : !value ? 0 : -1;
     } else {
       return value;
     }
@@ -72,6 +85,8 @@ struct ReplacementSerialization {
       return mpz_class(value);
     } else if constexpr (std::is_same_v<T, mpq_class>) {
       return mpq_class(value);
+    } else if constexpr (std::is_same_v<T, boost::logic::tribool>) {
+      return value == -1 ? boost::logic::tribool(boost::logic::indeterminate) : boost::logic::tribool(value == 1);
     } else {
       return value;
     }
@@ -79,15 +94,80 @@ struct ReplacementSerialization {
 
   template <typename Archive>
   static void save(Archive& archive, const std::string key, const T& value) {
+    if constexpr (binary<Archive>) {
+      if constexpr (std::is_same_v<T, mpz_class>) {
+        saveLimbs(archive, value);
+        return;
+      } else if constexpr (std::is_same_v<T, mpq_class>) {
+        saveLimbs(archive, value.get_num());
+        saveLimbs(archive, value.get_den());
+        return;
+      }
+    }
     archive(cereal::make_nvp(key, serializable(value)));
   }
 
   template <typename Archive>
   static void load(Archive& archive, const std::string key, T& value) {
+    if constexpr (binary<Archive>) {
+      if constexpr (std::is_same_v<T, mpz_class>) {
+        loadLimbs(archive, value);
+        return;
+      } else if constexpr (std::is_same_v<T, mpq_class>) {
+        loadLimbs(archive, value.get_num());
+        loadLimbs(archive, value.get_den());
+        return;
+      }
+    }
     decltype(serializable(std::declval<T>())) s;
     archive(cereal::make_nvp(key, s));
     value = deserializable(s);
   }
+
+ private:
+  // Whether values are written to this archive without a round trip through
+  // decimal strings.
+  template <typename Archive>
+  static constexpr bool binary = !cereal::traits::is_text_archive<Archive>::value;
+
+  // Write an integer as its sign followed by the 64-bit words of its
+  // absolute value, least significant word first.
+  template <typename Archive>
+  static void saveLimbs(Archive& archive, const mpz_class& value) {
+    std::vector<std::uint64_t> words((mpz_sizeinbase(value.get_mpz_t(), 2) + 63) / 64);
+    size_t count = 0;
+    mpz_export(words.data(), &count, -1, sizeof(std::uint64_t), 0, 0, value.get_mpz_t());
+    words.resize(count);
+    archive(static_cast<std::int8_t>(sgn(value)), words);
+  }
+
+  // Read an integer that has been written with saveLimbs().
+  template <typename Archive>
+  static void loadLimbs(Archive& archive, mpz_class& value) {
+    std::int8_t sign;
+    std::vector<std::uint64_t> words;
+    archive(sign, words);
+    mpz_import(value.get_mpz_t(), words.size(), -1, sizeof(std::uint64_t), 0, 0, words.data());
+    if (sign < 0)
+      value = -value;
+  }
+};
+
+// A value that is serialized with its ReplacementSerialization, e.g., to
+// serialize containers of such values.
+template <typename T>
+struct Replaced {
+  T value;
+
+  template <typename Archive>
+  void save(Archive& archive) const {
+    ReplacementSerialization<T>::save(archive, "value", value);
+  }
+
+  template <typename Archive>
+  void load(Archive& archive) {
+    ReplacementSerialization<T>::load(archive, "value", value);
+  }
 };
 
 }  // namespace
@@ -126,6 +206,7 @@ void Bound::save(Archive& archive) const {
 template <typename Archive>
 void Bound::load(Archive& archive) {
   ReplacementSerialization<mpz_class>::load(archive, "square", square);
+  normalize();
 }
 
 // Serialize a permutation to an archive.
@@ -160,6 +241,196 @@ void Vector<T>::load(Archive& archive) {
   *this = Vector<T>(x, y);
 }
 
+// Serialize a saddle connection on the perimeter of a summarized component.
+template <typename Surface>
+template <typename Archive>
+void FlowDecompositionSummary<Surface>::Connection::save(Archive& archive) const {
+  archive(cereal::make_nvp("source", source));
+  archive(cereal::make_nvp("target", target));
+  archive(cereal::make_nvp("vector", vector));
+  archive(cereal::make_nvp("vertical", vertical));
+}
+
+// Deserialize a saddle connection on the perimeter of a summarized component.
+template <typename Surface>
+template <typename Archive>
+void FlowDecompositionSummary<Surface>::Connection::load(Archive& archive) {
+  archive(cereal::make_nvp("source", source));
+  archive(cereal::make_nvp("target", target));
+  archive(cereal::make_nvp("vector", vector));
+  archive(cereal::make_nvp("vertical", vertical));
+}
+
+// Serialize a summarized flow component.
+template <typename Surface>
+template <typename Archive>
+void FlowDecompositionSummary<Surface>::Component::save(Archive& archive) const {
+  ReplacementSerialization<boost::logic::tribool>::save(archive, "cylinder", cylinder);
+  ReplacementSerialization<boost::logic::tribool>::save(archive, "withoutPeriodicTrajectory", withoutPeriodicTrajectory);
+  ReplacementSerialization<boost::logic::tribool>::save(archive, "keane", keane);
+  ReplacementSerialization<T>::save(archive, "area", area);
+  ReplacementSerialization<T>::save(archive, "width", width);
+  // Cylinders are the only components with a circumference.
+  archive(cereal::make_nvp("circumferenceHolonomy", circumferenceHolonomy ? std::vector<Vector<T>>{*circumferenceHolonomy} : std::vector<Vector<T>>{}));
+  archive(cereal::make_nvp("perimeter", perimeter));
+}
+
+// Deserialize a summarized flow component.
+template <typename Surface>
+template <typename Archive>
+void FlowDecompositionSummary<Surface>::Component::load(Archive& archive) {
+  ReplacementSerialization<boost::logic::tribool>::load(archive, "cylinder", cylinder);
+  ReplacementSerialization<boost::logic::tribool>::load(archive, "withoutPeriodicTrajectory", withoutPeriodicTrajectory);
+  ReplacementSerialization<boost::logic::tribool>::load(archive, "keane", keane);
+  ReplacementSerialization<T>::load(archive, "area", area);
+  ReplacementSerialization<T>::load(archive, "width", width);
+  std::vector<Vector<T>> circumference;
+  archive(cereal::make_nvp("circumferenceHolonomy", circumference));
+  circumferenceHolonomy = circumference.empty() ? std::nullopt : std::optional<Vector<T>>(circumference[0]);
+  archive(cereal::make_nvp("perimeter", perimeter));
+}
+
+// Serialize the summary of a flow decomposition.
+template <typename Surface>
+template <typename Archive>
+void FlowDecompositionSummary<Surface>::save(Archive& archive) const {
+  archive(cereal::make_nvp("vertical", vertical));
+  archive(cereal::make_nvp("components", components));
+}
+
+// Deserialize the summary of a flow decomposition.
+template <typename Surface>
+template <typename Archive>
+void FlowDecompositionSummary<Surface>::load(Archive& archive) {
+  archive(cereal::make_nvp("vertical", vertical));
+  archive(cereal::make_nvp("components", components));
+}
+
+// Serialize the position of a saddle connections iterator.
+template <typename Surface>
+template <typename Archive>
+void SaddleConnectionsIteratorCheckpoint<Surface>::save(Archive& archive) const {
+  archive(cereal::make_nvp("sector", sector));
+
+  const bool searching = static_cast<bool>(nextEdgeEnd);
+  archive(cereal::make_nvp("searching", searching));
+  if (!searching)
+    return;
+
+  const auto& surface = nextEdgeEnd->surface();
+  archive(cereal::make_nvp("surface", surface));
+  archive(cereal::make_nvp("nextEdge", nextEdge));
+  archive(cereal::make_nvp("nextEdgeEnd", *nextEdgeEnd));
+  archive(cereal::make_nvp("state", state));
+
+  // All chains live on the same surface, so we do not write them as
+  // individual chains but only their nonzero coefficients.
+  std::vector<unsigned char> chain;
+  std::vector<Vector<T>> vectors;
+  std::vector<std::vector<std::pair<Edge, Replaced<mpz_class>>>> chains;
+  for (const auto& boundary : boundaries) {
+    chain.push_back(std::holds_alternative<Chain<Surface>>(boundary));
+    if (chain.back()) {
+      chains.emplace_back();
+      for (auto edge : surface.edges())
+        if (std::get<Chain<Surface>>(boundary)[edge] != 0)
+          chains.back().emplace_back(edge, Replaced<mpz_class>{std::get<Chain<Surface>>(boundary)[edge]});
+    } else {
+      vectors.push_back(std::get<Vector<T>>(boundary));
+    }
+  }
+  archive(cereal::make_nvp("chain", chain));
+  archive(cereal::make_nvp("vectors", vectors));
+  archive(cereal::make_nvp("chains", chains));
+}
+
+// Deserialize the position of a saddle connections iterator.
+template <typename Surface>
+template <typename Archive>
+void SaddleConnectionsIteratorCheckpoint<Surface>::load(Archive& archive) {
+  archive(cereal::make_nvp("sector", sector));
+
+  boundaries.clear();
+  nextEdgeEnd = std::nullopt;
+  state.clear();
+
+  bool searching;
+  archive(cereal::make_nvp("searching", searching));
+  if (!searching)
+    return;
+
+  Surface surface;
+  archive(cereal::make_nvp("surface", surface));
+  archive(cereal::make_nvp("nextEdge", nextEdge));
+  nextEdgeEnd = Chain<Surface>(surface);
+  archive(cereal::make_nvp("nextEdgeEnd", *nextEdgeEnd));
+  archive(cereal::make_nvp("state", state));
+
+  std::vector<unsigned char> chain;
+  std::vector<Vector<T>> vectors;
+  std::vector<std::vector<std::pair<Edge, Replaced<mpz_class>>>> chains;
+  archive(cereal::make_nvp("chain", chain));
+  archive(cereal::make_nvp("vectors", vectors));
+  archive(cereal::make_nvp("chains", chains));
+
+  auto nextVector = begin(vectors);
+  auto coefficients = begin(chains);
+  for (const auto isChain : chain) {
+    if (isChain) {
+      if (coefficients == end(chains))
+        throw std::invalid_argument("checkpoint is missing chains");
+      std::vector<mpz_class> dense(surface.size());
+      for (auto& [edge, coefficient] : *coefficients++)
+        dense[edge.index()] = std::move(coefficient.value);
+      boundaries.push_back(Chain<Surface>(surface, dense));
+    } else {
+      if (nextVector == end(vectors))
+        throw std::invalid_argument("checkpoint is missing vectors");
+      boundaries.push_back(*nextVector++);
+    }
+  }
+}
+
+// Serialize a sector of a work unit of a saddle connection search.
+template <typename Surface>
+template <typename Archive>
+void SaddleConnectionsWorkUnit<Surface>::Sector::save(Archive& archive) const {
+  archive(cereal::make_nvp("source", source));
+  archive(cereal::make_nvp("rays", rays ? std::vector<Vector<T>>{rays->first, rays->second} : std::vector<Vector<T>>{}));
+}
+
+// Deserialize a sector of a work unit of a saddle connection search.
+template <typename Surface>
+template <typename Archive>
+void SaddleConnectionsWorkUnit<Surface>::Sector::load(Archive& archive) {
+  archive(cereal::make_nvp("source", source));
+  std::vector<Vector<T>> rays;
+  archive(cereal::make_nvp("rays", rays));
+  if (rays.size() != 0 && rays.size() != 2)
+    throw std::invalid_argument("sector must be enclosed by two rays");
+  this->rays = rays.empty() ? std::nullopt : std::optional{std::pair{rays[0], rays[1]}};
+}
+
+// Serialize a work unit of a saddle connection search.
+template <typename Surface>
+template <typename Archive>
+void SaddleConnectionsWorkUnit<Surface>::save(Archive& archive) const {
+  archive(cereal::make_nvp("sectors", sectors));
+  archive(cereal::make_nvp("bound", bound ? std::vector<Bound>{*bound} : std::vector<Bound>{}));
+  archive(cereal::make_nvp("lowerBound", lowerBound));
+}
+
+// Deserialize a work unit of a saddle connection search.
+template <typename Surface>
+template <typename Archive>
+void SaddleConnectionsWorkUnit<Surface>::load(Archive& archive) {
+  archive(cereal::make_nvp("sectors", sectors));
+  std::vector<Bound> bound;
+  archive(cereal::make_nvp("bound", bound));
+  this->bound = bound.empty() ? std::nullopt : std::optional{bound[0]};
+  archive(cereal::make_nvp("lowerBound", lowerBound));
+}
+
 // Helper class for flatsurf types that inherit from Serializable and can be serialized with cereal.
 // Any class marked as Serializable must provide a specialization of a Serialization here.
 template <typename T>
@@ -214,6 +485,10 @@ struct Serialization<ManagedMovable<T>> {
 // ImplementationOf<> of the different surface types. If you have trouble with
 // this, it might help to make sure that non-combinatorial instances are
 // serialized and deserialized first.
+// In binary archives, only the vertex permutation is written, as the lengths
+// of its cycles and the ids of their half edges, all as varints; the faces
+// are derived from it when loading. This is much more compact than the
+// explicit pairs of the vertex and face permutation in text archives.
 template <>
 struct Serialization<FlatTriangulationCombinatorial> {
   template <typename Archive>
@@ -223,6 +498,12 @@ struct Serialization<FlatTriangulationCombinatorial> {
       for (auto& e : self.halfEdges()) {
         vertices.push_back(std::pair(e, self.nextAtVertex(e)));
       }
+
+      if constexpr (binary<Archive>) {
+        archive(cereal::make_nvp("vertices", encode(Permutation<HalfEdge>(vertices))));
+        return;
+      }
+
       archive(cereal::make_nvp("vertices", Permutation<HalfEdge>(vertices)));
 
       std::vector<std::pair<HalfEdge, HalfEdge>> faces;
@@ -236,35 +517,154 @@ struct Serialization<FlatTriangulationCombinatorial> {
   template <typename Archive>
   void load(Archive& archive_, FlatTriangulationCombinatorial& self_) {
     Serialization<ManagedMovable<FlatTriangulationCombinatorial>>::load<Archive>(archive_, self_, [](Archive& archive, FlatTriangulationCombinatorial& self) {
+      if constexpr (binary<Archive>) {
+        std::vector<std::uint8_t> bytes;
+        archive(cereal::make_nvp("vertices", bytes));
+        self = FlatTriangulationCombinatorial(decode(bytes));
+        return;
+      }
+
       Permutation<HalfEdge> vertices;
       archive(cereal::make_nvp("vertices", vertices));
       self = FlatTriangulationCombinatorial(vertices);
     });
   }
+
+ private:
+  template <typename Archive>
+  static constexpr bool binary = !cereal::traits::is_text_archive<Archive>::value;
+
+  static void put(std::vector<std::uint8_t>& bytes, std::uint32_t value) {
+    while (value >= 0x80) {
+      bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    bytes.push_back(static_cast<std::uint8_t>(value));
+  }
+
+  static std::uint32_t get(const std::vector<std::uint8_t>& bytes, size_t& position) {
+    std::uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      if (position == bytes.size())
+        throw cereal::Exception("vertex permutation ended unexpectedly");
+      const auto byte = bytes[position++];
+      value |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return value;
+    }
+    throw cereal::Exception("malformed vertex permutation");
+  }
+
+  // Write the cycles of a vertex permutation as varints. Half edge ids are
+  // zigzag encoded so that small negative ids also take a single byte.
+  static std::vector<std::uint8_t> encode(const Permutation<HalfEdge>& vertices) {
+    std::vector<HalfEdge> elements;
+    std::vector<size_t> offsets;
+    vertices.cycles(elements, offsets);
+
+    std::vector<std::uint8_t> bytes;
+    bytes.reserve(elements.size() + offsets.size());
+    for (size_t i = 0; i + 1 < offsets.size(); i++) {
+      put(bytes, static_cast<std::uint32_t>(offsets[i + 1] - offsets[i]));
+      for (size_t j = offsets[i]; j < offsets[i + 1]; j++) {
+        const auto id = static_cast<std::uint32_t>(elements[j].id());
+        put(bytes, (id << 1) ^ static_cast<std::uint32_t>(elements[j].id() >> 31));
+      }
+    }
+    return bytes;
+  }
+
+  static Permutation<HalfEdge> decode(const std::vector<std::uint8_t>& bytes) {
+    std::vector<HalfEdge> elements;
+    std::vector<size_t> offsets{0};
+
+    size_t position = 0;
+    while (position < bytes.size()) {
+      const auto length = get(bytes, position);
+      for (std::uint32_t j = 0; j < length; j++) {
+        const auto zigzag = get(bytes, position);
+        elements.push_back(HalfEdge(static_cast<int>(zigzag >> 1) ^ -static_cast<int>(zigzag & 1)));
+      }
+      offsets.push_back(elements.size());
+    }
+
+    return Permutation<HalfEdge>(elements, offsets);
+  }
 };
 
 // Serialization and deserialization for FlatTriangulation.
+// A surface is typically shared by many chains and saddle connections, so it
+// is only written once per archive; further copies of the same surface are
+// written as a reference to this first copy.
 template <typename T>
 struct Serialization<FlatTriangulation<T>> {
   template <typename Archive>
   void save(Archive& archive, const FlatTriangulation<T>& self) {
-    archive(cereal::make_nvp("combinatorial", static_cast<const FlatTriangulationCombinatorial&>(self)));
+    // This header is compiled by the caller so the scope cannot depend on
+    // --enable-tracing; it is cheap when tracing is disabled.
+    Tracing::Scope trace("FlatTriangulation::save");
+
+    uint32_t id = archive.registerSharedPointer(key(self));
+    archive(cereal::make_nvp("shared", id));
 
-    std::unordered_map<HalfEdge, Vector<T>> vectors;
-    for (auto& edge : self.halfEdges())
-      vectors[edge] = self.fromHalfEdge(edge);
+    if (id & static_cast<unsigned int>(cereal::detail::msb_32bit)) {
+      archive(cereal::make_nvp("combinatorial", static_cast<const FlatTriangulationCombinatorial&>(self)));
+
+      // The vectors of the positive half edges indexed by the index of their edge.
+      std::vector<Vector<T>> vectors(self.edges().size());
+      for (auto& edge : self.edges())
+        vectors[edge.index()] = self.fromHalfEdge(edge.positive());
 
-    archive(cereal::make_nvp("vectors", vectors));
+      archive(cereal::make_nvp("vectors", vectors));
+    }
   }
 
   template <typename Archive>
   void load(Archive& archive, FlatTriangulation<T>& self) {
-    FlatTriangulationCombinatorial combinatorial;
-    archive(cereal::make_nvp("combinatorial", combinatorial));
-    std::unordered_map<HalfEdge, Vector<T>> map;
-    archive(cereal::make_nvp("vectors", map));
+    Tracing::Scope trace("FlatTriangulation::load");
 
-    self = FlatTriangulation<T>(std::move(std::move(combinatorial)), [&](HalfEdge e) { return map.at(e); });
+    uint32_t id;
+    archive(cereal::make_nvp("shared", id));
+
+    if (id & static_cast<unsigned int>(cereal::detail::msb_32bit)) {
+      FlatTriangulationCombinatorial combinatorial;
+      archive(cereal::make_nvp("combinatorial", combinatorial));
+      std::vector<Vector<T>> vectors;
+      archive(cereal::make_nvp("vectors", vectors));
+
+      self = FlatTriangulation<T>(std::move(combinatorial), [&](HalfEdge e) {
+        const auto& vector = vectors.at(Edge(e).index());
+        return e == Edge(e).positive() ? vector : -vector;
+      });
+      archive.registerSharedPointer(id, self.self.state);
+    } else {
+      self.self.state = std::static_pointer_cast<ImplementationOf<FlatTriangulation<T>>>(archive.getSharedPointer(id));
+    }
+  }
+
+  // Record surface in archive as if it had been written to (or read from)
+  // the archive already, so that any occurrence of surface in the archive is
+  // written as a reference to it. This must happen before anything else is
+  // written to (or read from) the archive. This is used to write many
+  // objects on the same surface without writing the surface each time, see
+  // pickle.hpp.
+  template <typename Archive>
+  static void assume(Archive& archive, const FlatTriangulation<T>& surface) {
+    if constexpr (Archive::is_saving::value) {
+      archive.registerSharedPointer(key(surface));
+    } else {
+      // The first shared pointer in an archive gets the id 1.
+      archive.registerSharedPointer(1, surface.self.state);
+    }
+  }
+
+  // Return the key that identifies this surface in the archive. We cannot
+  // use the address of its implementation directly since that is also the
+  // key of its combinatorial structure, see
+  // Serialization<FlatTriangulationCombinatorial>. Any other address inside
+  // the implementation identifies the surface equally well.
+  static const void* key(const FlatTriangulation<T>& self) {
+    return static_cast<const char*>(static_cast<const void*>(self.self.state.get())) + 1;
   }
 };
 
@@ -275,9 +675,11 @@ struct Serialization<Chain<Surface>> {
   void save(Archive& archive, const Chain<Surface>& self) {
     archive(cereal::make_nvp("surface", self.surface()));
 
-    std::vector<std::string> coefficients;
+    // Chains are typically sparse, so we only write the nonzero coefficients.
+    std::vector<std::pair<Edge, Replaced<mpz_class>>> coefficients;
     for (auto edge : self.surface().edges())
-      coefficients.push_back(fmt::format("{}", self[edge]));
+      if (self[edge] != 0)
+        coefficients.emplace_back(edge, Replaced<mpz_class>{self[edge]});
     archive(cereal::make_nvp("coefficients", coefficients));
   }
 
@@ -285,12 +687,13 @@ struct Serialization<Chain<Surface>> {
   void load(Archive& archive, Chain<Surface>& self) {
     Surface surface;
     archive(cereal::make_nvp("surface", surface));
-    std::vector<std::string> coefficients;
+    std::vector<std::pair<Edge, Replaced<mpz_class>>> coefficients;
     archive(cereal::make_nvp("coefficients", coefficients));
 
-    self = Chain(surface);
-    for (size_t i = 0; i < coefficients.size(); i++)
-      self += ((Chain<Surface>(surface) += surface.edges()[i].positive()) *= mpz_class(coefficients[i]));
+    std::vector<mpz_class> dense(surface.size());
+    for (auto& [edge, coefficient] : coefficients)
+      dense[edge.index()] = std::move(coefficient.value);
+    self = Chain<Surface>(surface, dense);
   }
 };
 
@@ -315,11 +718,108 @@ struct Serialization<SaddleConnection<Surface>> {
     archive(cereal::make_nvp("target", target));
     Chain<Surface> chain(surface);
     archive(cereal::make_nvp("chain", chain));
+    // The crossings are only written for the benefit of other consumers of
+    // the archive. We must read them anyway since binary archives cannot
+    // skip an entry.
+    std::vector<HalfEdge> crossings;
+    archive(cereal::make_nvp("crossings", crossings));
 
     self = SaddleConnection<Surface>(surface, source, target, chain);
   }
 };
 
+// Serialization and deserialization for saddle connections sorted into
+// buckets by their length. The connections of all the buckets are written
+// as a few flat arrays of integers, namely their source and target half
+// edges, and the number, edges, and coefficients of the nonzero terms of
+// their chains. Binary archives write these without any overhead for the
+// individual connections.
+template <typename Surface>
+struct Serialization<SaddleConnectionsBuckets<Surface>> {
+  using Term = typename SaddleConnectionRecords<Surface>::Term;
+
+  template <typename Archive>
+  void save(Archive& archive, const SaddleConnectionsBuckets<Surface>& self) {
+    archive(cereal::make_nvp("surface", self.surface()));
+    archive(cereal::make_nvp("bounds", self.bounds()));
+
+    std::vector<std::uint64_t> sizes;
+    std::vector<std::int32_t> sources, targets;
+    std::vector<std::uint32_t> terms;
+    std::vector<std::uint64_t> edges;
+    std::vector<std::int64_t> coefficients;
+
+    for (size_t bucket = 0; bucket < self.bounds().size(); bucket++) {
+      const auto& records = self[bucket];
+      sizes.push_back(records.size());
+      for (const auto& record : records.records()) {
+        sources.push_back(record.source);
+        targets.push_back(record.target);
+        terms.push_back(static_cast<std::uint32_t>(record.end - record.begin));
+        for (size_t t = record.begin; t != record.end; t++) {
+          edges.push_back(records.terms()[t].edge);
+          coefficients.push_back(records.terms()[t].coefficient);
+        }
+      }
+    }
+
+    archive(cereal::make_nvp("sizes", sizes));
+    archive(cereal::make_nvp("sources", sources));
+    archive(cereal::make_nvp("targets", targets));
+    archive(cereal::make_nvp("terms", terms));
+    archive(cereal::make_nvp("edges", edges));
+    archive(cereal::make_nvp("coefficients", coefficients));
+  }
+
+  template <typename Archive>
+  void load(Archive& archive, SaddleConnectionsBuckets<Surface>& self) {
+    Surface surface;
+    archive(cereal::make_nvp("surface", surface));
+    std::vector<Bound> bounds;
+    archive(cereal::make_nvp("bounds", bounds));
+
+    std::vector<std::uint64_t> sizes;
+    std::vector<std::int32_t> sources, targets;
+    std::vector<std::uint32_t> terms;
+    std::vector<std::uint64_t> edges;
+    std::vector<std::int64_t> coefficients;
+
+    archive(cereal::make_nvp("sizes", sizes));
+    archive(cereal::make_nvp("sources", sources));
+    archive(cereal::make_nvp("targets", targets));
+    archive(cereal::make_nvp("terms", terms));
+    archive(cereal::make_nvp("edges", edges));
+    archive(cereal::make_nvp("coefficients", coefficients));
+
+    size_t total = 0;
+    for (const auto size : sizes)
+      total += size;
+    if (sources.size() != total || targets.size() != total || terms.size() != total)
+      throw std::invalid_argument("each saddle connection must have a source, a target, and a chain");
+
+    size_t nonzero = 0;
+    for (const auto count : terms)
+      nonzero += count;
+    if (edges.size() != nonzero || coefficients.size() != nonzero)
+      throw std::invalid_argument("each term of a chain must have an edge and a coefficient");
+
+    std::vector<SaddleConnectionRecords<Surface>> buckets;
+    std::vector<Term> chain;
+    size_t connection = 0, term = 0;
+    for (const auto size : sizes) {
+      buckets.emplace_back(surface);
+      for (size_t i = 0; i < size; i++, connection++) {
+        chain.clear();
+        for (size_t j = 0; j < terms[connection]; j++, term++)
+          chain.push_back(Term{static_cast<size_t>(edges[term]), coefficients[term]});
+        buckets.back().push_back(sources[connection], targets[connection], chain.data(), chain.data() + chain.size());
+      }
+    }
+
+    self = SaddleConnectionsBuckets<Surface>(std::move(buckets), std::move(bounds));
+  }
+};
+
 // Serialization and deserialization for a Vertex.
 template <>
 struct Serialization<Vertex> {
@@ -23,8 +23,11 @@
 #include <gmpxx.h>
 
 #include <boost/operators.hpp>
+#include <cstdint>
 #include <exact-real/arb.hpp>
 #include <iosfwd>
+#include <optional>
+#include <vector>
 
 #include "chain_iterator.hpp"
 #include "copyable.hpp"
@@ -33,6 +36,7 @@
 namespace flatsurf {
 
 // A chain on a flat triangulation, i.e., a formal sum of edges.
+// The const methods of a chain can be called from several threads at once.
 template <typename Surface>
 class Chain : public Serializable<Chain<Surface>>,
               boost::equality_comparable<Chain<Surface>>,
@@ -47,6 +51,17 @@ class Chain : public Serializable<Chain<Surface>>,
  public:
   explicit Chain(const Surface&);
   Chain(const Surface&, HalfEdge);
+  // Create the chain with the given coefficients, one for each edge of
+  // surface ordered by the index of the edges, as written by
+  // SaddleConnectionsIterator::fill().
+  Chain(const Surface&, const std::vector<mpz_class>& coefficients);
+  Chain(const Chain&);
+  Chain(Chain&&);
+
+  // Assign rhs to this chain. Unlike copying the chain, this reuses the
+  // memory of this chain if possible.
+  Chain<Surface>& operator=(const Chain&);
+  Chain<Surface>& operator=(Chain&&);
 
   operator const Vector<T> &() const;
   operator const Vector<exactreal::Arb> &() const;
@@ -63,6 +78,11 @@ class Chain : public Serializable<Chain<Surface>>,
   const mpz_class& operator[](const Edge&) const;
   mpz_class operator[](const HalfEdge&) const;
 
+  // Return the coefficient of this edge if it fits into a 64-bit integer.
+  // This is much cheaper than operator[] since the coefficients of typical
+  // chains are small and never need to be turned into GMP integers here.
+  std::optional<int64_t> coefficient(const Edge&) const;
+
   using iterator = ChainIterator<Surface>;
 
   // Return an iterator over the summands of this chain, i.e., the pairs of
@@ -72,8 +92,8 @@ class Chain : public Serializable<Chain<Surface>>,
 
   bool operator==(const Chain& rhs) const;
 
-  bool operator>(const Bound) const;
-  bool operator<(const Bound) const;
+  bool operator>(const Bound&) const;
+  bool operator<(const Bound&) const;
 
   Chain<Surface> operator-() const;
 
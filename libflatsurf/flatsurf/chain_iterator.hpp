@@ -24,6 +24,8 @@
 
 #include <boost/iterator/iterator_categories.hpp>
 #include <boost/iterator/iterator_facade.hpp>
+#include <cstdint>
+#include <optional>
 
 #include "copyable.hpp"
 
@@ -43,6 +45,10 @@ class ChainIterator : public boost::iterator_facade<ChainIterator<Surface>, cons
   const value_type& dereference() const;
   bool equal(const ChainIterator& other) const;
 
+  // Return the coefficient of the current edge if it fits into a 64-bit
+  // integer, see Chain::coefficient().
+  std::optional<int64_t> coefficient() const;
+
   template <typename S>
   friend std::ostream& operator<<(std::ostream&, const ChainIterator<S>&);
 
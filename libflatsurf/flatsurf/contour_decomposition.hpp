@@ -37,9 +37,20 @@ class ContourDecomposition {
 
   using T = typename Surface::Coordinate;
 
+  template <typename... Args>
+  ContourDecomposition(PrivateConstructor, Args &&...args);
+
  public:
   ContourDecomposition(Surface, const Vector<T> &vertical);
 
+  // Return the decomposition of the same surface with respect to another
+  // vertical direction.
+  // The uncollapsed surface is shared with this decomposition and not
+  // copied. If vertical is a positive multiple of the current vertical
+  // direction, the returned decomposition shares all of its data with this
+  // decomposition.
+  ContourDecomposition rotate(const Vector<T> &vertical) const;
+
   std::vector<ContourComponent<Surface>> components() const;
 
   // Return the underlying Collapsed Flat Triangulation where all edges have
@@ -20,7 +20,13 @@
 #ifndef LIBFLATSURF_CPPYY_HPP
 #define LIBFLATSURF_CPPYY_HPP
 
+#include <e-antic/renfxx.h>
+#include <gmpxx.h>
+
+#include <complex>
 #include <iosfwd>
+#include <stdexcept>
+#include <vector>
 
 #include "flatsurf.hpp"
 
@@ -32,6 +38,107 @@ FlatTriangulation<T> makeFlatTriangulation(const std::vector<std::vector<int>> &
   return FlatTriangulation<T>(FlatTriangulationCombinatorial(vertices), vectors);
 }
 
+// Create a FlatTriangulation from flat buffers, see the corresponding
+// constructors of FlatTriangulationCombinatorial and FlatTriangulation.
+template <typename T>
+FlatTriangulation<T> makeFlatTriangulation(const std::vector<int> &vertices, const std::vector<size_t> &offsets, const std::vector<Vector<T>> &vectors) {
+  return FlatTriangulation<T>(FlatTriangulationCombinatorial(vertices, offsets, {}), vectors);
+}
+
+template <typename T>
+FlatTriangulation<T> makeFlatTriangulation(const std::vector<int> &vertices, const std::vector<size_t> &offsets, const std::vector<T> &x, const std::vector<T> &y) {
+  return FlatTriangulation<T>(FlatTriangulationCombinatorial(vertices, offsets, {}), x, y);
+}
+
+// Create a FlatTriangulation from contiguous buffers such as numpy arrays or
+// Python arrays that cppyy hands to us as pointers without copying them
+// element by element. The half edges around the i-th vertex are
+// vertices[offsets[i]], …, vertices[offsets[i + 1] - 1], i.e., offsets has
+// cycles + 1 entries. The vector of the i-th edge is (xy[2*i], xy[2*i + 1]).
+template <typename T>
+FlatTriangulation<T> makeFlatTriangulationFromBuffers(const int *vertices, const long long *offsets, size_t cycles, const long long *xy, size_t edges) {
+  std::vector<T> x, y;
+  x.reserve(edges);
+  y.reserve(edges);
+  for (size_t i = 0; i < edges; i++) {
+    x.emplace_back(xy[2 * i]);
+    y.emplace_back(xy[2 * i + 1]);
+  }
+
+  return FlatTriangulation<T>(FlatTriangulationCombinatorial(std::vector<int>(vertices, vertices + offsets[cycles]), std::vector<size_t>(offsets, offsets + cycles + 1), {}), x, y);
+}
+
+// Create a FlatTriangulation with coordinates in the number field K from
+// contiguous buffers as above. The j-th coefficient (in the power basis) of
+// the k-th coordinate, where coordinates are ordered x, y for each edge, is
+// numerators[k*degree + j] / denominators[k].
+template <typename Field>
+FlatTriangulation<eantic::renf_elem_class> makeFlatTriangulationFromBuffers(const Field &K, const int *vertices, const long long *offsets, size_t cycles, const long long *numerators, const long long *denominators, size_t degree, size_t edges) {
+  const auto coordinate = [&](size_t k) {
+    std::vector<mpq_class> coefficients;
+    coefficients.reserve(degree);
+    for (size_t j = 0; j < degree; j++)
+      coefficients.emplace_back(mpz_class(static_cast<long>(numerators[k * degree + j])), mpz_class(static_cast<long>(denominators[k])));
+    for (auto &coefficient : coefficients)
+      coefficient.canonicalize();
+    return eantic::renf_elem_class(K, coefficients);
+  };
+
+  std::vector<eantic::renf_elem_class> x, y;
+  x.reserve(edges);
+  y.reserve(edges);
+  for (size_t i = 0; i < edges; i++) {
+    x.push_back(coordinate(2 * i));
+    y.push_back(coordinate(2 * i + 1));
+  }
+
+  return FlatTriangulation<eantic::renf_elem_class>(FlatTriangulationCombinatorial(std::vector<int>(vertices, vertices + offsets[cycles]), std::vector<size_t>(offsets, offsets + cycles + 1), {}), x, y);
+}
+
+// Elementwise operations on arrays of vectors so that Python does not need to
+// dispatch each operation on each vector through cppyy, see
+// pyflatsurf.export.VectorArray.
+template <typename T>
+std::vector<Vector<T>> addVectors(const std::vector<Vector<T>> &lhs, const std::vector<Vector<T>> &rhs, int sign = 1) {
+  if (lhs.size() != rhs.size())
+    throw std::invalid_argument("arrays of vectors must have the same length");
+
+  std::vector<Vector<T>> sum;
+  sum.reserve(lhs.size());
+  for (size_t i = 0; i < lhs.size(); i++)
+    sum.push_back(sign < 0 ? lhs[i] - rhs[i] : lhs[i] + rhs[i]);
+  return sum;
+}
+
+template <typename T>
+std::vector<Vector<T>> scaleVectors(const std::vector<Vector<T>> &vectors, const mpz_class &scalar) {
+  std::vector<Vector<T>> scaled;
+  scaled.reserve(vectors.size());
+  for (const auto &v : vectors) {
+    scaled.push_back(v);
+    scaled.back() *= scalar;
+  }
+  return scaled;
+}
+
+// Write the orientation of each vector relative to direction, i.e., the
+// value of Vector::ccw() as an int, to ccw[i].
+template <typename T>
+void ccwVectors(const std::vector<Vector<T>> &vectors, const Vector<T> &direction, int *ccw) {
+  for (size_t i = 0; i < vectors.size(); i++)
+    ccw[i] = static_cast<int>(vectors[i].ccw(direction));
+}
+
+// Write double approximations of the i-th vector to (xy[2*i], xy[2*i + 1]).
+template <typename T>
+void approximateVectors(const std::vector<Vector<T>> &vectors, double *xy) {
+  for (size_t i = 0; i < vectors.size(); i++) {
+    const auto approximation = static_cast<std::complex<double>>(vectors[i]);
+    xy[2 * i] = approximation.real();
+    xy[2 * i + 1] = approximation.imag();
+  }
+}
+
 // cppyy sometimes has trouble with rvalues, let's help it to create a FlowDecomposition
 // See https://bitbucket.org/wlav/cppyy/issues/275/result-of-cppyygblstdmove-is-not-an-rvalue.
 template <typename T>
@@ -49,8 +156,8 @@ auto makeOddHalfEdgeMap(const FlatTriangulationCombinatorial &surface, const std
 
 // Work around https://bitbucket.org/wlav/cppyy/issues/273/segfault-in-cpycppyy-anonymous-namespace
 template <typename T>
-bool decomposeFlowDecomposition(FlowDecomposition<T> &decomposition, int limit = -1) {
-  return decomposition.decompose(FlowDecomposition<T>::defaultTarget, limit);
+bool decomposeFlowDecomposition(FlowDecomposition<T> &decomposition, int limit = -1, unsigned int threads = 1) {
+  return decomposition.decompose(FlowDecomposition<T>::defaultTarget, limit, threads);
 }
 
 template <typename T>
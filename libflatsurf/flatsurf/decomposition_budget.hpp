@@ -0,0 +1,109 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_DECOMPOSITION_BUDGET_HPP
+#define LIBFLATSURF_DECOMPOSITION_BUDGET_HPP
+
+#include <chrono>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+
+#include "forward.hpp"
+
+namespace flatsurf {
+
+// A budget for the decomposition of Flow Components, see
+// FlowComponent::decompose(). A budget is exhausted once a number of
+// decomposition steps has been performed, a timeout has passed, or it has
+// been cancelled (possibly from another thread.) Copies of a budget share
+// their consumption so the same budget can be handed to several
+// decompositions. A decomposition that ran out of budget can be resumed
+// later by decomposing it again with a fresh budget.
+class DecompositionBudget {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Statistics about a single decomposition step, see trace().
+  struct Step {
+    // The number of steps of the Rauzy-Zorich induction performed.
+    size_t inductions;
+    // Whether a vertical saddle connection was found.
+    bool connection;
+    // Whether the component split into two components.
+    bool split;
+    // Whether the step stopped since it exceeded limit().
+    bool limitReached;
+    // The time spent in the induction of this decomposition step.
+    Clock::duration total;
+    // The part of total spent comparing and subtracting the exact lengths
+    // of the interval exchange transformation; the remainder is spent in
+    // intervalxt itself.
+    Clock::duration lengths;
+  };
+
+  // Create a budget that allows for the given number of decomposition steps
+  // (or an unlimited number if not set) and runs out after timeout from now
+  // (or never if not set.) Each decomposition step is limited to limit steps
+  // of the underlying Rauzy induction (or unlimited if negative) as with the
+  // limit parameter of FlowComponent::decompose().
+  explicit DecompositionBudget(std::optional<size_t> steps = std::nullopt, std::optional<Clock::duration> timeout = std::nullopt, int limit = -1);
+
+  // Return the number of decomposition steps this budget allows for, if
+  // limited.
+  std::optional<size_t> steps() const;
+
+  // Return the number of decomposition steps that have been performed with
+  // this budget.
+  size_t consumed() const;
+
+  // Return the time that has passed since this budget was created.
+  Clock::duration elapsed() const;
+
+  // Return the number of steps of the Rauzy induction each decomposition step
+  // is limited to (or -1 if unlimited.)
+  int limit() const;
+
+  // Make this budget (and all its copies) exhausted.
+  void cancel() const;
+
+  bool cancelled() const;
+
+  // Report each decomposition step performed with this budget (or any of
+  // its copies) to callback. When decomposing in parallel, callback is
+  // invoked from several threads concurrently. Note that collecting these
+  // statistics slows down the decomposition slightly.
+  void trace(std::function<void(const Step&)> callback) const;
+
+  // Return whether no further decomposition steps should be started with
+  // this budget.
+  bool exhausted() const;
+
+  friend std::ostream& operator<<(std::ostream&, const DecompositionBudget&);
+
+ private:
+  std::shared_ptr<ImplementationOf<DecompositionBudget>> self;
+
+  friend ImplementationOf<DecompositionBudget>;
+};
+
+}  // namespace flatsurf
+
+#endif
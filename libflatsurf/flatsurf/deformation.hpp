@@ -45,6 +45,14 @@ class Deformation {
   // Return the result of the deformation.
   const Surface& surface() const;
 
+  // Return the composition of this deformation with rhs, i.e., the
+  // deformation that maps half edges first with rhs and then with this
+  // deformation, where this deformation deformed the result of rhs.
+  // Both deformations are consumed by this. Their surfaces are not copied;
+  // the result of the composition is the result of this deformation and
+  // the intermediate result of rhs is released.
+  Deformation operator*(Deformation&& rhs) &&;
+
   template <typename S>
   friend std::ostream& operator<<(std::ostream&, const Deformation<S>&);
 
@@ -29,12 +29,13 @@
 #include "vector_base.hpp"
 
 namespace flatsurf::detail {
-// An exact vector in ℝ².
+// A vector in ℝ² with exact coordinates (or floating point coordinates
+// whose predicates are decided up to a small error, see Vector<double>.)
 template <typename Vector, typename T>
 class VectorExact : public VectorBase<Vector>,
                     private boost::less_than_comparable<Vector, Bound>,
                     private boost::equality_comparable<Vector>,
-                    private std::conditional_t<std::is_same_v<T, mpz_class>, boost::empty_init_t, boost::multipliable<Vector, T>> {
+                    private std::conditional_t<std::is_same_v<T, mpz_class> || std::is_floating_point_v<T>, boost::empty_init_t, boost::multipliable<Vector, T>> {
  public:
   using Coordinate = T;
 
@@ -45,8 +46,8 @@ class VectorExact : public VectorBase<Vector>,
   // Return the scalar product with the argument
   T operator*(const Vector &) const;
 
-  bool operator>(const Bound) const;
-  bool operator<(const Bound) const;
+  bool operator>(const Bound&) const;
+  bool operator<(const Bound&) const;
   bool operator==(const Vector &) const;
   explicit operator bool() const;
 
@@ -34,10 +34,10 @@ class VectorWithError : public VectorBase<Vector> {
   std::optional<ORIENTATION> orientation(const Vector &) const;
   std::optional<bool> insideCircumcircle(std::initializer_list<Vector>) const;
 
-  std::optional<bool> operator>(const Bound) const;
-  std::optional<bool> operator>=(const Bound) const;
-  std::optional<bool> operator<(const Bound) const;
-  std::optional<bool> operator<=(const Bound) const;
+  std::optional<bool> operator>(const Bound&) const;
+  std::optional<bool> operator>=(const Bound&) const;
+  std::optional<bool> operator<(const Bound&) const;
+  std::optional<bool> operator<=(const Bound&) const;
   // Return true if both vectors are the same exact vector, false if the
   // respective balls do not overlap.
   std::optional<bool> operator==(const Vector &) const;
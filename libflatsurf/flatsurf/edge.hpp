@@ -30,20 +30,22 @@ namespace flatsurf {
 // An unoriented edge of a Flat Triangulation.
 class Edge : boost::equality_comparable<Edge> {
  public:
-  Edge() noexcept;
+  constexpr Edge() noexcept :
+    id(HalfEdge()) {}
   Edge(int);
-  Edge(HalfEdge);
+  constexpr Edge(HalfEdge e) noexcept :
+    id(e.index() % 2 ? -e : e) {}
 
-  static Edge fromIndex(size_t);
+  static constexpr Edge fromIndex(size_t index) noexcept { return Edge(HalfEdge::fromIndex(2 * index)); }
 
-  HalfEdge positive() const;
-  HalfEdge negative() const;
+  constexpr HalfEdge positive() const noexcept { return id; }
+  constexpr HalfEdge negative() const noexcept { return -id; }
 
   // Return a zero-based index that can be used to index into arrays with
   // edges from the same triangulation.
-  size_t index() const;
+  constexpr size_t index() const noexcept { return id.index() / 2; }
 
-  bool operator==(const Edge &) const;
+  constexpr bool operator==(const Edge &rhs) const noexcept { return id == rhs.id; }
 
   friend std::ostream &operator<<(std::ostream &, const Edge &);
 
@@ -62,9 +64,15 @@ class Edge : boost::equality_comparable<Edge> {
 namespace std {
 template <>
 struct hash<flatsurf::Edge> {
-  size_t operator()(const flatsurf::Edge &) const;
+  size_t operator()(const flatsurf::Edge &e) const noexcept { return e.positive().index(); }
 };
 
 }  // namespace std
 
+namespace flatsurf {
+
+constexpr Edge HalfEdge::edge() const noexcept { return Edge(*this); }
+
+}  // namespace flatsurf
+
 #endif
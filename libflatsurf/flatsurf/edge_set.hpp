@@ -30,7 +30,10 @@
 namespace flatsurf {
 
 // A subset of the set of edges of a Triangulation.
-class EdgeSet : boost::equality_comparable<EdgeSet> {
+class EdgeSet : boost::equality_comparable<EdgeSet>,
+                boost::orable<EdgeSet>,
+                boost::andable<EdgeSet>,
+                boost::subtractable<EdgeSet> {
   template <typename... Args>
   EdgeSet(PrivateConstructor, Args&&...);
 
@@ -54,6 +57,12 @@ class EdgeSet : boost::equality_comparable<EdgeSet> {
 
   bool disjoint(const EdgeSet&) const;
 
+  // Replace this set with its union, intersection, or difference with
+  // another set.
+  EdgeSet& operator|=(const EdgeSet&);
+  EdgeSet& operator&=(const EdgeSet&);
+  EdgeSet& operator-=(const EdgeSet&);
+
   friend std::ostream& operator<<(std::ostream&, const EdgeSet&);
 
  private:
@@ -0,0 +1,77 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_EXACT_FALLBACKS_HPP
+#define LIBFLATSURF_EXACT_FALLBACKS_HPP
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "forward.hpp"
+
+namespace flatsurf {
+
+// Library-wide statistics about the predicates that are first evaluated on
+// ball approximations and fall back to exact arithmetic when these balls
+// cannot decide them, e.g., Vector::ccw() over a number field.
+// Collecting these statistics is disabled by default. It is enabled with
+// enable() or by setting the environment variable
+// LIBFLATSURF_EXACT_FALLBACKS, in which case the statistics are also
+// printed to standard error when the program exits.
+// The counters are kept per thread and aggregated when queried.
+class ExactFallbacks {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // The statistics of a single predicate.
+  struct Site {
+    // The name of the predicate, e.g., "Vector::ccw".
+    std::string name;
+    // The number of times the approximation decided the predicate.
+    size_t decided;
+    // The number of times the predicate had to be decided exactly.
+    size_t undecided;
+    // The total time spent in the exact fallback.
+    Clock::duration exact;
+
+    friend std::ostream& operator<<(std::ostream&, const Site&);
+  };
+
+  // Start (or stop) collecting statistics.
+  static void enable(bool enabled = true);
+
+  static bool enabled();
+
+  // Return the statistics of all the predicates that have been evaluated
+  // since statistics were enabled (or last reset), aggregated over all
+  // threads.
+  static std::vector<Site> sites();
+
+  // Reset all counters to zero.
+  static void reset();
+
+  // Print the statistics of all predicates, one per line.
+  static void dump(std::ostream&);
+};
+
+}  // namespace flatsurf
+
+#endif
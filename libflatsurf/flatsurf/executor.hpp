@@ -0,0 +1,87 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_EXECUTOR_HPP
+#define LIBFLATSURF_EXECUTOR_HPP
+
+#include <functional>
+#include <iosfwd>
+#include <memory>
+
+#include "forward.hpp"
+
+namespace flatsurf {
+
+// Runs the tasks of the parallel operations of libflatsurf, e.g., of
+// SaddleConnections::forEach(), FlowDecomposition::decompose(), or
+// FlatTriangulation::isomorphism().
+// When such an operation runs with several threads, the calling thread
+// works on the operation itself and asks the global() executor to run
+// further workers. By default, each such worker runs on a fresh thread. An
+// application that already maintains a pool of threads, e.g., a TBB arena,
+// a pool of std::threads, or an executor in Python, should install an
+// executor that hands the workers to that pool. Then the operations of
+// libflatsurf do not oversubscribe the machine.
+// A worker that has not started when the calling thread has completed the
+// operation is skipped. So an executor may run workers late or on a single
+// thread without risking a deadlock.
+// Copies of an executor share their state.
+class Executor {
+ public:
+  using Task = std::function<void()>;
+
+  // Create an executor that runs each task on a new thread. It reports one
+  // task per core as its concurrency().
+  Executor();
+
+  // Create an executor that hands each task to submit. It must eventually
+  // run each task exactly once; it may run tasks concurrently on any
+  // thread. The concurrency is the number of tasks that are worth running
+  // at once, typically the number of threads of the pool.
+  Executor(std::function<void(Task)> submit, unsigned int concurrency);
+
+  // Return an executor that does not run any tasks. Parallel operations
+  // then run completely on the calling thread.
+  static Executor serial();
+
+  // Return the executor that the parallel operations of libflatsurf use.
+  static Executor global();
+
+  // Replace the executor that the parallel operations of libflatsurf use.
+  // Operations that are running already keep using the previous executor.
+  static void global(Executor);
+
+  // Return the number of tasks that are worth running at once. Parallel
+  // operations that are invoked with zero threads use this many threads.
+  unsigned int concurrency() const;
+
+  // Run task at some point, possibly on another thread.
+  void submit(Task task) const;
+
+  friend std::ostream &operator<<(std::ostream &, const Executor &);
+
+ private:
+  std::shared_ptr<ImplementationOf<Executor>> self;
+
+  friend ImplementationOf<Executor>;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -26,6 +26,7 @@
 #include <exact-real/forward.hpp>
 #include <functional>
 #include <iosfwd>
+#include <utility>
 #include <vector>
 
 #include "flat_triangulation_combinatorial.hpp"
@@ -37,6 +38,9 @@ namespace flatsurf {
 
 // A triangulated translation surface. For most purposes this is the central
 // object of the flatsurf library.
+// The const methods of a triangulation can be called from several threads at
+// once, so a single surface can be shared by a pool of threads; only
+// modifications of the surface, such as flips, need exclusive access.
 template <class T>
 class FlatTriangulation : public FlatTriangulationCombinatorics<FlatTriangulation<T>>,
                           Serializable<FlatTriangulation<T>>,
@@ -48,6 +52,9 @@ class FlatTriangulation : public FlatTriangulationCombinatorics<FlatTriangulatio
 
   FlatTriangulation() noexcept;
   FlatTriangulation(FlatTriangulationCombinatorial &&, const std::vector<Vector<T>> &vectors);
+  FlatTriangulation(FlatTriangulationCombinatorial &&, std::vector<Vector<T>> &&vectors);
+  // Create a triangulation whose edge with index i has the vector (x[i], y[i]).
+  FlatTriangulation(FlatTriangulationCombinatorial &&, const std::vector<T> &x, const std::vector<T> &y);
   FlatTriangulation(FlatTriangulationCombinatorial &&, const std::function<Vector<T>(HalfEdge)> &vectors);
 
   // Create an independent clone of this triangulation that is built from the
@@ -58,7 +65,12 @@ class FlatTriangulation : public FlatTriangulationCombinatorics<FlatTriangulatio
 
   // Flip edges in this triangulation so that it satisfies the usual
   // l²-Delaunay condition, see delaunay(Edge).
-  void delaunay();
+  // With several threads (or Executor::concurrency() many if zero), the
+  // flips are performed in rounds. Each round evaluates the Delaunay
+  // condition of the edges in parallel and then flips a set of non-Delaunay
+  // edges whose quadrilaterals do not overlap. This pays off for large
+  // surfaces that are far from Delaunay, e.g., after a strong shear.
+  void delaunay(unsigned int threads = 1);
 
   // Return whether this edge satisfies the usual l²-Delaunay condition, i.e.,
   // when embedding just the faces attached to this edge in R², whether the
@@ -72,10 +84,41 @@ class FlatTriangulation : public FlatTriangulationCombinatorics<FlatTriangulatio
   // next to e, the necessary edge flips are performed to accomodate it.
   Deformation<FlatTriangulation<T>> insertAt(HalfEdge &e, const Vector<T> &v) const;
 
+  // Create an independent clone of this triangulation with an added vertex
+  // for each pair (e, v), at v from e's source in the sector next to e.
+  // The vertices are inserted one after the other into a single working
+  // copy of this triangulation, i.e., a vector v must not cross any of the
+  // vertices inserted before it. The half edges are updated such that each
+  // v is in the closed sector next to its half edge in the resulting
+  // triangulation.
+  Deformation<FlatTriangulation<T>> insertAt(std::vector<std::pair<HalfEdge, Vector<T>>> &points) const;
+
   // Create an independent clone of this triangulation with all vectors scaled
   // by c.
   FlatTriangulation<T> scale(const mpz_class &c) const;
 
+  // Create a triangulation with the same combinatorics whose vectors are
+  // the double approximations of the vectors of this triangulation.
+  // Predicates on such a surface are only decided up to a relative error, so
+  // results computed on it, e.g., its saddle connections, are heuristic.
+  // They can be certified by lifting them back to this surface, see
+  // SaddleConnection::lift().
+  FlatTriangulation<double> approximate() const;
+
+  // Scale all vectors of this triangulation by c in place.
+  // Note that structures which depend on the vectors of this surface, such
+  // as an existing Vertical, are not updated by this.
+  FlatTriangulation<T> &operator*=(const mpz_class &c);
+
+  // Replace each vector (x, y) of this triangulation with (a·x + b·y, c·x +
+  // d·y) in place and then flip edges to restore the Delaunay condition, see
+  // delaunay(). The matrix must have positive determinant.
+  // Unlike with other deformations, the approximations of the vectors are
+  // transformed instead of being recomputed, and an existing Vertical in
+  // direction v on this surface becomes the Vertical in the direction of
+  // the image of v.
+  FlatTriangulation<T> &apply(const T &a, const T &b, const T &c, const T &d);
+
   // Create an independent clone of this triangulation with an edded boundary
   // at the half edge e by removing the identification of the two corresponding
   // half edges there.
@@ -88,20 +131,53 @@ class FlatTriangulation : public FlatTriangulationCombinatorics<FlatTriangulatio
   // v(h) associated to a half edge replaced by v(h) + shift[h].
   Deformation<FlatTriangulation<T>> operator+(const OddHalfEdgeMap<Vector<T>> &shift) const;
 
+  // Replace the vector v(h) associated to a half edge with v(h) + shift[h] in
+  // place. Edges are flipped along the way as in operator+; these flips are
+  // reported to the Tracked structures attached to this surface. Shifts that
+  // collapse half edges are not supported in place.
+  // Note that structures which depend on the vectors of this surface, such
+  // as an existing Vertical, are not updated by this.
+  FlatTriangulation<T> &operator+=(const OddHalfEdgeMap<Vector<T>> &shift);
+
   // Return a simplified flat triangulation with marked points, i.e., verticas
   // with a total angle of 2π, eliminated.
   Deformation<FlatTriangulation<T>> eliminateMarkedPoints() const;
 
+  // Return a copy of this triangulation whose half edges are renumbered in
+  // the order in which a breadth-first search through the faces meets them.
+  // On large surfaces, neighboring triangles then have similar indices, so
+  // the data that searches such as SaddleConnections and the components of a
+  // Vertical read when walking across the surface is close in memory.
+  Deformation<FlatTriangulation<T>> reorder() const;
+
   // Return an isomorphism from this surface to the given surface, i.e., a
   // bijection on some (depending on the selected "kind") of the half edges
   // transforming them subject to the same linear transformation (note that
   // that transformation might have negative determinant, i.e., the order of
   // half edges in a face might change under this map.)
+  // If threads is not 1, the possible images of a half edge are checked in
+  // parallel with that many threads (or one per core if threads is 0.) Then
+  // the filters must be safe to call concurrently and if there are several
+  // isomorphisms, any of them might be returned.
   std::optional<Deformation<FlatTriangulation<T>>> isomorphism(
       const FlatTriangulation &,
       ISOMORPHISM kind,
       std::function<bool(const T &, const T &, const T &, const T &)> = [](const T &a, const T &b, const T &c, const T &d) { return a == 1 && b == 0 && c == 0 && d == 1; },
-      std::function<bool(HalfEdge, HalfEdge)> = [](HalfEdge, HalfEdge) { return true; }) const;
+      std::function<bool(HalfEdge, HalfEdge)> = [](HalfEdge, HalfEdge) { return true; },
+      unsigned int threads = 1) const;
+
+  // Return all the isomorphisms from this surface to itself whose matrix is
+  // accepted by the filter, including the identity. By default, these are
+  // the translation automorphisms, i.e., the deck transformations.
+  std::vector<Deformation<FlatTriangulation<T>>> automorphisms(
+      ISOMORPHISM kind,
+      std::function<bool(const T &, const T &, const T &, const T &)> = [](const T &a, const T &b, const T &c, const T &d) { return a == 1 && b == 0 && c == 0 && d == 1; }) const;
+
+  // Return a hash of this surface that is invariant under isomorphism(), i.e.,
+  // surfaces that are isomorphic for the given kind have the same hash for
+  // any choice of filter. This can be used to bucket large collections of
+  // surfaces before calling isomorphism() within each bucket.
+  size_t canonicalHash(ISOMORPHISM kind) const;
 
   Vector<T> shortest() const;
 
@@ -114,9 +190,15 @@ class FlatTriangulation : public FlatTriangulationCombinatorics<FlatTriangulatio
   // Return twice the area of this triangulation.
   T area() const;
 
+  // Return an approximation of twice the area of this triangulation.
+  exactreal::Arb areaApproximate() const;
+
   // Return the total angle at this vertex as a multiple of 2π.
   int angle(const Vertex &) const;
 
+  // Return the number of half edges starting at this vertex.
+  size_t degree(const Vertex &) const;
+
   // Return whether the vector is in the sector counterclockwise next to the
   // half edge (including the half edge but not including the following half
   // edge.)
@@ -135,8 +217,13 @@ class FlatTriangulation : public FlatTriangulationCombinatorics<FlatTriangulatio
  private:
   using FlatTriangulationCombinatorics<FlatTriangulation<T>>::self;
 
+  // Create a triangulation from data that has been derived from a valid
+  // surface, see ImplementationOf<FlatTriangulation>::make().
+  FlatTriangulation(ProtectedConstructor, FlatTriangulationCombinatorial &&, const std::function<Vector<T>(HalfEdge)> &vectors);
+
   friend ImplementationOf<FlatTriangulation<T>>;
   friend ImplementationOf<ManagedMovable<FlatTriangulation<T>>>;
+  friend Serialization<FlatTriangulation<T>>;
 };
 
 template <typename Vector>
@@ -68,7 +68,9 @@ class FlatTriangulationCollapsed : public FlatTriangulationCombinatorics<FlatTri
   bool inSector(HalfEdge, const Vector<T> &) const;
 
   // Return the saddle connections to go from this half edge's source to its negative's target.
-  Path<FlatTriangulation<T>> cross(HalfEdge) const;
+  // The returned reference is only valid until this triangulation is
+  // flipped or collapsed next.
+  const Path<FlatTriangulation<T>> &cross(HalfEdge) const;
 
   // Return the collapsed saddle connections to turn from one half edge clockwise to the other.
   Path<FlatTriangulation<T>> turn(HalfEdge, HalfEdge) const;
@@ -41,6 +41,10 @@ class FlatTriangulationCombinatorial : public FlatTriangulationCombinatorics<Fla
   FlatTriangulationCombinatorial() noexcept;
   FlatTriangulationCombinatorial(const std::vector<std::vector<int>> &vertices, const std::vector<int> &boundaries = std::vector<int>());
   FlatTriangulationCombinatorial(const Permutation<HalfEdge> &vertices);
+  // Create the triangulation whose vertex permutation is given in a single
+  // flat buffer, i.e., the half edges around the i-th vertex are
+  // vertices[offsets[i]], …, vertices[offsets[i + 1] - 1].
+  FlatTriangulationCombinatorial(const std::vector<int> &vertices, const std::vector<size_t> &offsets, const std::vector<int> &boundaries);
   FlatTriangulationCombinatorial(const std::vector<std::tuple<HalfEdge, HalfEdge, HalfEdge>> &faces);
 
   friend ImplementationOf<FlatTriangulationCombinatorial>;
@@ -25,6 +25,7 @@
 // cppyy.hpp for the Python interface and cereal.hpp for
 // serialization with cereal.)
 
+#include "async.hpp"
 #include "bound.hpp"
 #include "ccw.hpp"
 #include "chain.hpp"
@@ -33,12 +34,15 @@
 #include "contour_connection.hpp"
 #include "contour_decomposition.hpp"
 #include "copyable.hpp"
+#include "decomposition_budget.hpp"
 #include "decomposition_step.hpp"
 #include "deformation.hpp"
 #include "edge.hpp"
 #include "edge_map.hpp"
 #include "edge_set.hpp"
 #include "edge_set_iterator.hpp"
+#include "exact_fallbacks.hpp"
+#include "executor.hpp"
 #include "flat_triangulation.hpp"
 #include "flat_triangulation_collapsed.hpp"
 #include "flat_triangulation_combinatorial.hpp"
@@ -46,15 +50,21 @@
 #include "flow_component.hpp"
 #include "flow_connection.hpp"
 #include "flow_decomposition.hpp"
+#include "flow_decomposition_summary.hpp"
+#include "flow_decompositions.hpp"
 #include "flow_triangulation.hpp"
 #include "fmt.hpp"
 #include "forward.hpp"
+#include "geodesic_flow.hpp"
 #include "half_edge.hpp"
 #include "half_edge_map.hpp"
 #include "half_edge_set.hpp"
 #include "half_edge_set_iterator.hpp"
+#include "inline_copyable.hpp"
 #include "interval_exchange_transformation.hpp"
 #include "isomorphism.hpp"
+#include "isomorphism_classes.hpp"
+#include "latency.hpp"
 #include "local.hpp"
 #include "managed_movable.hpp"
 #include "movable.hpp"
@@ -64,15 +74,23 @@
 #include "path_iterator.hpp"
 #include "permutation.hpp"
 #include "saddle_connection.hpp"
+#include "saddle_connection_records.hpp"
 #include "saddle_connections.hpp"
+#include "saddle_connections_buckets.hpp"
 #include "saddle_connections_by_length.hpp"
 #include "saddle_connections_by_length_iterator.hpp"
+#include "saddle_connections_index.hpp"
 #include "saddle_connections_iterator.hpp"
+#include "saddle_connections_iterator_checkpoint.hpp"
+#include "saddle_connections_work_unit.hpp"
 #include "saddle_connections_sample.hpp"
 #include "saddle_connections_sample_iterator.hpp"
+#include "saddle_connections_statistics.hpp"
 #include "serializable.hpp"
+#include "tracing.hpp"
 #include "tracked.hpp"
 #include "vector.hpp"
+#include "veech_group.hpp"
 #include "vertex.hpp"
 #include "vertical.hpp"
 
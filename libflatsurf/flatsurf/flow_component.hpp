@@ -24,6 +24,7 @@
 #include <boost/operators.hpp>
 #include <functional>
 #include <list>
+#include <optional>
 
 #include "copyable.hpp"
 
@@ -46,6 +47,16 @@ class FlowComponent : boost::equality_comparable<FlowComponent<Surface>> {
   // We should be using a FlowPath instead, see https://github.com/flatsurf/flatsurf/issues/146.
   using Perimeter = std::list<FlowConnection<Surface>>;
 
+  // Metrics of a component which are computed in a single walk around its
+  // perimeter and cached until the component changes in a decomposition.
+  struct Summary {
+    boost::logic::tribool cylinder;
+    T area;
+    T width;
+    // The holonomy of the circumference if this is a cylinder.
+    std::optional<Vector<T>> circumferenceHolonomy;
+  };
+
   boost::logic::tribool cylinder() const;
   boost::logic::tribool withoutPeriodicTrajectory() const;
   boost::logic::tribool keane() const;
@@ -64,6 +75,12 @@ class FlowComponent : boost::equality_comparable<FlowComponent<Surface>> {
       },
       int limit = -1);
 
+  // Return whether all resulting components satisfy target. Returns false
+  // when a decomposition step exceeds the limit of the budget or when the
+  // budget is exhausted, see DecompositionBudget. Such a decomposition can
+  // be resumed by calling decompose() again.
+  bool decompose(std::function<bool(const FlowComponent&)> target, const DecompositionBudget& budget);
+
   // A walk around this component in counter clockwise order along saddle connections.
   Perimeter perimeter() const;
 
@@ -73,6 +90,10 @@ class FlowComponent : boost::equality_comparable<FlowComponent<Surface>> {
 
   T width() const;
 
+  // Return the area, width, and (for cylinders) the circumference of this
+  // component without walking its perimeter again if nothing changed.
+  const Summary& summary() const;
+
   T area() const;
 
   // Return the holonomy of the circumference of this cylinder, i.e., the
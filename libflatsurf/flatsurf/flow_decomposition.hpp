@@ -50,7 +50,37 @@ class FlowDecomposition {
 
   // Return whether all resulting components satisfy target, i.e., target could
   // be established for all components without exceeding the limit.
-  bool decompose(std::function<bool(const FlowComponent<Surface>&)> target = defaultTarget, int limit = -1);
+  // If threads is not 1, the components are decomposed in parallel with that
+  // many threads (or one per core if threads is 0.) Then target must be
+  // thread-safe and all components are decomposed even if target cannot be
+  // established for some of them. The components that split off a component
+  // are decomposed by the same thread since they share the state of their
+  // interval exchange transformation.
+  // If the Latency::global() has a budget, the decomposition stops once it
+  // has passed, as with the overload below.
+  bool decompose(std::function<bool(const FlowComponent<Surface>&)> target = defaultTarget, int limit = -1, unsigned int threads = 1);
+
+  // Return whether all resulting components satisfy target as above but
+  // stop once the budget is exhausted, see FlowComponent::decompose().
+  // Calling this again continues the decomposition where it stopped. Note
+  // that the state of such a partial decomposition cannot be serialized
+  // since it lives mostly in intervalxt; only its summary() can.
+  bool decompose(std::function<bool(const FlowComponent<Surface>&)> target, const DecompositionBudget& budget, unsigned int threads = 1);
+
+  // Decompose the components until predicate is decided, i.e., until it
+  // does not return indeterminate anymore, and return its final value.
+  // The components are decomposed one step at a time in turns so that, e.g.,
+  // decomposeUntil([](const auto& d) { return d.completelyPeriodic(); })
+  // stops as soon as some component turns out not to be a cylinder. A
+  // component is not considered anymore once a single one of its steps
+  // exceeds the limit; the predicate is then returned as is when no
+  // component can be decomposed further or the budget of the
+  // Latency::global() has passed.
+  boost::logic::tribool decomposeUntil(std::function<boost::logic::tribool(const FlowDecomposition&)> predicate, int limit = -1);
+
+  // Decompose the components until predicate is decided as above but stop
+  // once the budget is exhausted. Then the predicate is returned as is.
+  boost::logic::tribool decomposeUntil(std::function<boost::logic::tribool(const FlowDecomposition&)> predicate, const DecompositionBudget& budget);
 
   std::vector<FlowComponent<Surface>> components() const;
 
@@ -60,7 +90,10 @@ class FlowDecomposition {
   Vector<T> vertical() const;
 
   // Return a triangulation of surface consistent with the decomposition into flow components.
-  FlatTriangulation<T> triangulation() const;
+  // If threads is not 1, the components are triangulated in parallel with
+  // that many threads (or one per core if threads is 0.) This must not be
+  // called while the components are being decomposed.
+  FlatTriangulation<T> triangulation(unsigned int threads = 1) const;
 
   // Return the half edge in triangulation() corresponding to this flow connection.
   HalfEdge halfEdge(const FlowConnection<Surface>&) const;
@@ -74,6 +107,20 @@ class FlowDecomposition {
   //   unknown: otherwise
   boost::logic::tribool parabolic() const;
 
+  // Return a compact snapshot of the current state of this decomposition
+  // which remains valid once this decomposition has been destroyed.
+  FlowDecompositionSummary<Surface> summary() const;
+
+  // Release the memory that is only needed to decompose the components
+  // further, namely the cached lengths of the interval exchange
+  // transformations whose components have all been decomposed (see
+  // defaultTarget), and the cached embedding of triangulation(). The
+  // perimeters and types of the components remain available and the
+  // decomposition can still be continued; the dropped data is then
+  // recomputed. This must not be called while the components are being
+  // decomposed.
+  void compact();
+
   template <typename S>
   friend std::ostream& operator<<(std::ostream&, const FlowDecomposition<S>&);
 
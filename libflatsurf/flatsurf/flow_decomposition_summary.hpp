@@ -0,0 +1,87 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_FLOW_DECOMPOSITION_SUMMARY_HPP
+#define LIBFLATSURF_FLOW_DECOMPOSITION_SUMMARY_HPP
+
+#include <boost/logic/tribool.hpp>
+#include <optional>
+#include <vector>
+
+#include "forward.hpp"
+#include "half_edge.hpp"
+#include "vector.hpp"
+
+namespace flatsurf {
+
+// A compact and immutable snapshot of a Flow Decomposition, see
+// FlowDecomposition::summary(). Unlike the decomposition itself, a summary
+// does not keep the surface, the collapsed triangulations, or the interval
+// exchange transformations alive, so it is suitable to extract the result of
+// many decompositions and export them in bulk, e.g., with cereal.
+template <typename Surface>
+struct FlowDecompositionSummary {
+  using T = typename Surface::Coordinate;
+
+  // A saddle connection on the perimeter of a component.
+  struct Connection {
+    // The half edges of the original surface from which this saddle
+    // connection leaves and at which it arrives, see SaddleConnection.
+    HalfEdge source;
+    HalfEdge target;
+    Vector<T> vector;
+    // Whether this connection is parallel to the vertical direction.
+    bool vertical;
+
+    template <typename Archive>
+    void save(Archive&) const;
+    template <typename Archive>
+    void load(Archive&);
+  };
+
+  // The metrics of a single Flow Component.
+  struct Component {
+    boost::logic::tribool cylinder;
+    boost::logic::tribool withoutPeriodicTrajectory;
+    boost::logic::tribool keane;
+    T area;
+    T width;
+    // The holonomy of the circumference if this is a cylinder.
+    std::optional<Vector<T>> circumferenceHolonomy;
+    // A walk around this component in counter clockwise order.
+    std::vector<Connection> perimeter;
+
+    template <typename Archive>
+    void save(Archive&) const;
+    template <typename Archive>
+    void load(Archive&);
+  };
+
+  Vector<T> vertical;
+  std::vector<Component> components;
+
+  template <typename Archive>
+  void save(Archive&) const;
+  template <typename Archive>
+  void load(Archive&);
+};
+
+}  // namespace flatsurf
+
+#endif
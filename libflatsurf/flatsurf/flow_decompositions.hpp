@@ -0,0 +1,121 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_FLOW_DECOMPOSITIONS_HPP
+#define LIBFLATSURF_FLOW_DECOMPOSITIONS_HPP
+
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <vector>
+
+#include "decomposition_budget.hpp"
+#include "flow_decomposition.hpp"
+#include "flow_decomposition_summary.hpp"
+#include "movable.hpp"
+#include "saddle_connections_by_length.hpp"
+
+namespace flatsurf {
+
+// Flow Decompositions of a single surface in many directions, typically the
+// directions of its saddle connections as in a survey of its periodic
+// directions.
+template <typename Surface>
+class FlowDecompositions {
+  static_assert(std::is_same_v<Surface, std::decay_t<Surface>>, "type must not have modifiers such as const");
+
+  using T = typename Surface::Coordinate;
+
+ public:
+  FlowDecompositions(const Surface&, std::vector<Vector<T>> directions);
+
+  // Create the flow decomposition in each of the directions, decompose it
+  // with target and limit as in FlowDecomposition::decompose(), and report it
+  // to callback together with the value returned by decompose().
+  // The directions are distributed over the given number of threads (or one
+  // per core if threads is 0.) Decompositions are reported as soon as they
+  // are available, i.e., not necessarily in the order of the directions. The
+  // callback is never invoked concurrently but target must be thread-safe.
+  // Once callback returns false, no further directions are decomposed.
+  void forEach(const std::function<bool(FlowDecomposition<Surface>&&, bool)>& callback, std::function<bool(const FlowComponent<Surface>&)> target = FlowDecomposition<Surface>::defaultTarget, int limit = -1, unsigned int threads = 0) const;
+
+  // Decompose in each of the directions as in forEach() but report only the
+  // summary of each decomposition to callback together with the direction
+  // and the value returned by decompose().
+  // Directions which are positive multiples of each other, e.g., because
+  // they were obtained from different saddle connections, are decomposed
+  // only once and the summary of the first such direction is reported for
+  // all of them. Note that such a summary then refers to that first
+  // direction, i.e., its vertical and the widths of its components are not
+  // rescaled.
+  void forEachSummary(const std::function<bool(const Vector<T>&, const FlowDecompositionSummary<Surface>&, bool)>& callback, std::function<bool(const FlowComponent<Surface>&)> target = FlowDecomposition<Surface>::defaultTarget, int limit = -1, unsigned int threads = 0) const;
+
+  // Decompose in the directions of connections as forEachSummary() does but
+  // while these directions are being enumerated. The connections are
+  // enumerated by the calling thread; each direction that is not a positive
+  // multiple of an earlier direction is queued and decomposed by one of the
+  // given number of threads (or Executor::concurrency() many if zero.) At
+  // most capacity directions are queued (or four per thread if zero); while
+  // the queue is full, the calling thread decomposes the next direction
+  // itself instead of enumerating further. So enumeration and decomposition
+  // overlap but the enumeration never runs far ahead of the decompositions.
+  // Summaries are reported as soon as they are available. The callback is
+  // never invoked concurrently but target must be thread-safe. Once callback
+  // returns false, e.g., after it has seen a certain number of completely
+  // periodic directions, the enumeration stops and no further directions are
+  // decomposed. Otherwise, this only returns once connections are
+  // exhausted, so typically connections should be bounded.
+  static void survey(const SaddleConnectionsByLength<Surface>& connections, const std::function<bool(const Vector<T>&, const FlowDecompositionSummary<Surface>&, bool)>& callback, std::function<bool(const FlowComponent<Surface>&)> target = FlowDecomposition<Surface>::defaultTarget, int limit = -1, unsigned int threads = 0, size_t capacity = 0);
+
+  // Search for cylinders in the directions of connections, e.g., to find
+  // directions for an orbit closure computation. The directions are
+  // enumerated and distributed over threads as in survey(). In each
+  // direction, the components are decomposed one step at a time in turns
+  // until a cylinder has been found or all components are decided, see
+  // FlowDecomposition::decomposeUntil(). The number of cylinders found and
+  // whether there is a cylinder in that direction (indeterminate if this
+  // could not be decided) are reported to callback.
+  // Each direction may perform the given number of decomposition steps (or
+  // an unlimited number if not set), each limited to budget.limit() steps
+  // of the Rauzy induction. Once budget is exhausted, e.g., because it has
+  // been cancelled or has timed out, the decompositions stop and the
+  // remaining directions are reported as undecided. Once callback returns
+  // false, the enumeration stops and no further directions are decomposed.
+  static void cylinders(const SaddleConnectionsByLength<Surface>& connections, const std::function<bool(const Vector<T>&, size_t, boost::logic::tribool)>& callback, std::optional<size_t> steps = std::nullopt, const DecompositionBudget& budget = DecompositionBudget(), unsigned int threads = 0, size_t capacity = 0);
+
+  // Return the surface which is decomposed.
+  const Surface& surface() const;
+
+  const std::vector<Vector<T>>& directions() const;
+
+  template <typename S>
+  friend std::ostream& operator<<(std::ostream&, const FlowDecompositions<S>&);
+
+ private:
+  Movable<FlowDecompositions> self;
+
+  friend ImplementationOf<FlowDecompositions>;
+};
+
+template <typename Surface, typename... Args>
+FlowDecompositions(const Surface&, Args&&... args) -> FlowDecompositions<Surface>;
+
+}  // namespace flatsurf
+
+#endif
@@ -31,6 +31,9 @@
 
 namespace flatsurf {
 
+template <typename Surface>
+class Async;
+
 class Bound;
 
 enum class CCW;
@@ -47,6 +50,8 @@ class ContourConnection;
 template <typename Surface>
 class ContourDecomposition;
 
+class DecompositionBudget;
+
 template <typename Surface>
 class DecompositionStep;
 
@@ -64,6 +69,10 @@ class EdgeSet;
 
 class EdgeSetIterator;
 
+class ExactFallbacks;
+
+class Executor;
+
 template <typename T>
 class FlatTriangulation;
 
@@ -84,9 +93,18 @@ class FlowConnection;
 template <typename Surface>
 class FlowDecomposition;
 
+template <typename Surface>
+class FlowDecompositions;
+
+template <typename Surface>
+struct FlowDecompositionSummary;
+
 template <typename Surface>
 class FlowTriangulation;
 
+template <typename Surface>
+class GeodesicFlow;
+
 class HalfEdge;
 
 template <typename T>
@@ -104,6 +122,11 @@ class IntervalExchangeTransformation;
 
 enum class ISOMORPHISM;
 
+template <typename Surface>
+class IsomorphismClasses;
+
+class Latency;
+
 template <typename T>
 class ManagedMovable;
 
@@ -131,33 +154,55 @@ struct ProtectedConstructor {};
 template <typename Surface>
 class SaddleConnection;
 
+template <typename Surface>
+class SaddleConnectionRecords;
+
 template <typename Surface>
 class SaddleConnections;
 
+template <typename Surface>
+class SaddleConnectionsBuckets;
+
 template <typename Surface>
 class SaddleConnectionsByLength;
 
 template <typename Surface>
 class SaddleConnectionsByLengthIterator;
 
+template <typename Surface>
+class SaddleConnectionsIndex;
+
 template <typename Surface>
 class SaddleConnectionsIterator;
 
+template <typename Surface>
+struct SaddleConnectionsIteratorCheckpoint;
+
 template <typename Surface>
 class SaddleConnectionsSample;
 
 template <typename Surface>
 class SaddleConnectionsSampleIterator;
 
+struct SaddleConnectionsStatistics;
+
+template <typename Surface>
+struct SaddleConnectionsWorkUnit;
+
 template <typename T>
 class Serializable;
 
 template <typename T>
 struct Serialization;
 
+class Tracing;
+
 template <typename T>
 class Vector;
 
+template <typename Surface>
+class VeechGroup;
+
 class Vertex;
 
 template <typename Surface>
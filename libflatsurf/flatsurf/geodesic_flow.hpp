@@ -0,0 +1,75 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_GEODESIC_FLOW_HPP
+#define LIBFLATSURF_GEODESIC_FLOW_HPP
+
+#include <iosfwd>
+
+#include "movable.hpp"
+
+namespace flatsurf {
+
+// The Teichmüller geodesic flow, i.e., the action of diag(e^t, e^-t), on a
+// surface whose triangulation is kept Delaunay along the flow.
+// Along the flow, the Delaunay condition of each edge changes at most once,
+// at a time that can be computed exactly. The flow keeps these times in a
+// queue and flips each edge just when it stops being Delaunay. So, the cost
+// of a long trajectory is essentially given by the number of flips and not
+// by the number of steps it is split into.
+template <typename Surface>
+class GeodesicFlow {
+  static_assert(std::is_same_v<Surface, std::decay_t<Surface>>, "type must not have modifiers such as const");
+
+  using T = typename Surface::Coordinate;
+
+ public:
+  // Start the flow at a clone of surface that is made Delaunay first.
+  explicit GeodesicFlow(const Surface&);
+
+  // Replace each vector (x, y) of the surface with (a·x, d·y), where a and d
+  // must be positive, and flip the edges that stop being Delaunay on the way.
+  // For a = e^t and d = e^-t this is the geodesic flow for time t. Since the
+  // Delaunay condition does not depend on the scaling of the surface, any
+  // a/d = e^2t (which can typically be chosen in the coordinate ring) gives
+  // the same triangulation up to scaling.
+  // Returns the number of flips that were performed.
+  size_t step(const T& a, const T& d);
+
+  // Return the surface at the current time of the flow.
+  // The flow only applies the accumulated matrix to the vectors of the
+  // surface when they are requested here, so this is linear in the size of
+  // the surface.
+  const Surface& surface() const;
+
+  template <typename S>
+  friend std::ostream& operator<<(std::ostream&, const GeodesicFlow<S>&);
+
+ private:
+  Movable<GeodesicFlow> self;
+
+  friend ImplementationOf<GeodesicFlow>;
+};
+
+template <typename Surface>
+GeodesicFlow(const Surface&) -> GeodesicFlow<Surface>;
+
+}  // namespace flatsurf
+
+#endif
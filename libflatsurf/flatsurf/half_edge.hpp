@@ -29,28 +29,36 @@
 namespace flatsurf {
 
 // A (combinatorial) half edge of a triangulation.
+// The trivial operations are defined inline (here and in edge.hpp) so that
+// the hot loops of the library can inline them without link time
+// optimization.
 class HalfEdge : boost::equality_comparable<HalfEdge> {
-  HalfEdge(PrivateConstructor, size_t idx);
+  constexpr HalfEdge(PrivateConstructor, size_t idx) noexcept :
+    idx(idx) {}
 
  public:
-  HalfEdge() noexcept;
+  constexpr HalfEdge() noexcept :
+    HalfEdge(PrivateConstructor{}, static_cast<size_t>(-1)) {}
   HalfEdge(int id);
-  HalfEdge(const HalfEdge &edge) = default;
+  constexpr HalfEdge(const HalfEdge &edge) noexcept = default;
 
-  static HalfEdge fromIndex(size_t index);
+  static constexpr HalfEdge fromIndex(size_t index) noexcept { return HalfEdge(PrivateConstructor{}, index); }
 
-  HalfEdge operator-() const;
+  constexpr HalfEdge operator-() const noexcept { return fromIndex(idx ^ static_cast<size_t>(1)); }
 
-  HalfEdge &operator=(const HalfEdge &other) noexcept;
+  constexpr HalfEdge &operator=(const HalfEdge &other) noexcept = default;
 
-  bool operator==(const HalfEdge &other) const;
+  constexpr bool operator==(const HalfEdge &other) const noexcept { return idx == other.idx; }
 
-  Edge edge() const;
+  constexpr Edge edge() const noexcept;
 
   // Return a zero based index for this half edge that can be used to index into an array.
-  size_t index() const;
+  // Note that this must not be called on a default constructed half edge.
+  constexpr size_t index() const noexcept { return idx; }
 
-  int id() const;
+  // Return the non-zero id of this half edge; positive half edges have
+  // positive ids and the negative of a half edge has the negative id.
+  constexpr int id() const noexcept { return (idx % 2 ? -1 : 1) * static_cast<int>(idx / 2 + 1); }
 
   friend std::ostream &operator<<(std::ostream &, const HalfEdge &);
 
@@ -69,8 +77,11 @@ class HalfEdge : boost::equality_comparable<HalfEdge> {
 namespace std {
 template <>
 struct hash<flatsurf::HalfEdge> {
-  size_t operator()(const flatsurf::HalfEdge &) const;
+  size_t operator()(const flatsurf::HalfEdge &e) const noexcept { return e.index(); }
 };
 }  // namespace std
 
+// HalfEdge::edge() is defined in edge.hpp.
+#include "edge.hpp"
+
 #endif
@@ -29,7 +29,10 @@
 namespace flatsurf {
 
 // A subset of the set of half edges of a triangulation.
-class HalfEdgeSet : boost::equality_comparable<HalfEdgeSet> {
+class HalfEdgeSet : boost::equality_comparable<HalfEdgeSet>,
+                    boost::orable<HalfEdgeSet>,
+                    boost::andable<HalfEdgeSet>,
+                    boost::subtractable<HalfEdgeSet> {
  public:
   HalfEdgeSet() noexcept;
   HalfEdgeSet(const std::vector<HalfEdge>&);
@@ -50,6 +53,12 @@ class HalfEdgeSet : boost::equality_comparable<HalfEdgeSet> {
 
   bool disjoint(const HalfEdgeSet&) const;
 
+  // Replace this set with its union, intersection, or difference with
+  // another set.
+  HalfEdgeSet& operator|=(const HalfEdgeSet&);
+  HalfEdgeSet& operator&=(const HalfEdgeSet&);
+  HalfEdgeSet& operator-=(const HalfEdgeSet&);
+
   friend std::ostream& operator<<(std::ostream&, const HalfEdgeSet&);
 
  private:
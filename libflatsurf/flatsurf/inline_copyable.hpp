@@ -0,0 +1,110 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019-2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_INLINE_COPYABLE_HPP
+#define LIBFLATSURF_INLINE_COPYABLE_HPP
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "forward.hpp"
+
+namespace flatsurf {
+
+// A pimpl for types that are copyable and moveable like Copyable<T>.
+// However, the implementation is not allocated on the heap but stored in a
+// buffer of Size bytes inside of this object. This is useful for small
+// types such as Vector<long long> that are created and destroyed a lot.
+// As with Copyable<T>, the implementation only needs to be a complete type
+// where the pimpl is created with make(); copying and destroying go through
+// a table of operations that is captured at that point.
+template <typename T, size_t Size>
+class InlineCopyable {
+  using Implementation = ImplementationOf<T>;
+
+  struct Operations {
+    void (*copy)(void* target, const void* source);
+    void (*move)(void* target, void* source);
+    void (*copyAssign)(void* target, const void* source);
+    void (*moveAssign)(void* target, void* source);
+    void (*destroy)(void* target);
+  };
+
+ public:
+  // Create the implementation in place from args.
+  template <typename... Args>
+  static InlineCopyable make(Args&&... args) {
+    static_assert(sizeof(Implementation) <= Size, "implementation does not fit into the inline storage");
+    static_assert(alignof(Implementation) <= alignof(std::max_align_t), "implementation has unsupported alignment");
+
+    static constexpr Operations operations{
+        [](void* target, const void* source) { new (target) Implementation(*static_cast<const Implementation*>(source)); },
+        [](void* target, void* source) { new (target) Implementation(std::move(*static_cast<Implementation*>(source))); },
+        [](void* target, const void* source) { *static_cast<Implementation*>(target) = *static_cast<const Implementation*>(source); },
+        [](void* target, void* source) { *static_cast<Implementation*>(target) = std::move(*static_cast<Implementation*>(source)); },
+        [](void* target) { static_cast<Implementation*>(target)->~Implementation(); },
+    };
+
+    return InlineCopyable(&operations, std::forward<Args>(args)...);
+  }
+
+  InlineCopyable(const InlineCopyable& rhs) :
+    operations(rhs.operations) {
+    operations->copy(&storage, &rhs.storage);
+  }
+
+  InlineCopyable(InlineCopyable&& rhs) noexcept :
+    operations(rhs.operations) {
+    operations->move(&storage, &rhs.storage);
+  }
+
+  ~InlineCopyable() { operations->destroy(&storage); }
+
+  InlineCopyable& operator=(const InlineCopyable& rhs) {
+    if (this != &rhs)
+      operations->copyAssign(&storage, &rhs.storage);
+    return *this;
+  }
+
+  InlineCopyable& operator=(InlineCopyable&& rhs) noexcept {
+    if (this != &rhs)
+      operations->moveAssign(&storage, &rhs.storage);
+    return *this;
+  }
+
+  const Implementation* operator->() const { return std::launder(reinterpret_cast<const Implementation*>(&storage)); }
+  Implementation* operator->() { return std::launder(reinterpret_cast<Implementation*>(&storage)); }
+  const Implementation& operator*() const { return *operator->(); }
+  Implementation& operator*() { return *operator->(); }
+
+ private:
+  template <typename... Args>
+  explicit InlineCopyable(const Operations* operations, Args&&... args) :
+    operations(operations) {
+    new (&storage) Implementation(std::forward<Args>(args)...);
+  }
+
+  const Operations* operations;
+  alignas(std::max_align_t) unsigned char storage[Size];
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,88 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_ISOMORPHISM_CLASSES_HPP
+#define LIBFLATSURF_ISOMORPHISM_CLASSES_HPP
+
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+#include "isomorphism.hpp"
+#include "movable.hpp"
+
+namespace flatsurf {
+
+// Partitions collections of surfaces into classes of surfaces that are
+// isomorphic in the sense of FlatTriangulation::isomorphism().
+// The surfaces are first sorted into buckets by invariants that are cheap to
+// compute. Only surfaces in the same bucket are then compared with
+// isomorphism().
+template <typename Surface>
+class IsomorphismClasses {
+  static_assert(std::is_same_v<Surface, std::decay_t<Surface>>, "type must not have modifiers such as const");
+
+  using T = typename Surface::Coordinate;
+
+ public:
+  // The kind of matrices that the filter of isomorphism() accepts. This
+  // determines which invariants can be used to bucket the surfaces.
+  enum class MATRICES {
+    // Arbitrary matrices. Only combinatorial invariants are used, i.e., the
+    // total angles at the vertices and canonicalHash().
+    GENERIC,
+    // Matrices with determinant ±1, e.g., SL(2, ℤ). Additionally, surfaces
+    // are bucketed by their area.
+    AREA_PRESERVING,
+    // Orthogonal matrices, e.g., translations. Additionally, surfaces are
+    // bucketed by the lengths of the edges of their faces (or Delaunay
+    // cells.)
+    ISOMETRIES,
+  };
+
+  // Create classes of surfaces that are isomorphic for the given kind and
+  // filter, see FlatTriangulation::isomorphism(). The filter must only
+  // accept matrices of the given kind and these must form a group.
+  // If threads is not 1, surfaces are bucketed and compared in parallel with
+  // that many threads (or one per core if threads is 0.) Then the filter must
+  // be safe to call concurrently.
+  IsomorphismClasses(
+      ISOMORPHISM kind,
+      MATRICES matrices = MATRICES::ISOMETRIES,
+      std::function<bool(const T &, const T &, const T &, const T &)> = [](const T &a, const T &b, const T &c, const T &d) { return a == 1 && b == 0 && c == 0 && d == 1; },
+      unsigned int threads = 1);
+
+  // Return the partition of surfaces into isomorphism classes. Each class is
+  // given by the indices of its surfaces in increasing order and the classes
+  // are sorted by their first index.
+  // If kind is DELAUNAY_CELLS, the surfaces must be Delaunay triangulated.
+  std::vector<std::vector<size_t>> operator()(const std::vector<Surface> &surfaces) const;
+
+  template <typename S>
+  friend std::ostream &operator<<(std::ostream &, const IsomorphismClasses<S> &);
+
+ private:
+  Movable<IsomorphismClasses> self;
+
+  friend ImplementationOf<IsomorphismClasses>;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,99 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_LATENCY_HPP
+#define LIBFLATSURF_LATENCY_HPP
+
+#include <chrono>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+
+#include "forward.hpp"
+
+namespace flatsurf {
+
+// Configures how long the potentially expensive operations of libflatsurf
+// may block their caller, e.g., when the library is driven from an
+// interactive session.
+// By default, operations run to completion. With a budget, operations that
+// can stop early and be resumed, such as FlowDecomposition::decompose() and
+// FlowDecomposition::decomposeUntil() when called without an explicit
+// DecompositionBudget, stop once the budget has passed. The components they
+// have not decomposed yet then report indeterminate, e.g., for
+// FlowComponent::cylinder(), and calling them again continues the
+// decomposition. Operations that produce their results incrementally, such
+// as the iteration of SaddleConnectionsByLength, report their progress to
+// the progress callback so that a frontend can render partial results.
+// Copies of a latency share their state.
+class Latency {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // The progress of an operation, see report().
+  struct Progress {
+    // The name of the operation, e.g., "FlowDecomposition::decompose".
+    const char* operation;
+    // The number of units of work, e.g., decomposition steps or saddle
+    // connections, that the operation has completed so far.
+    size_t completed;
+  };
+
+  // Create a latency without a budget that does not report progress, i.e.,
+  // operations run to completion.
+  Latency();
+
+  // Create a latency that lets each operation run for at most budget (or
+  // until completion if not set) and reports progress to the given
+  // callback. The callback may be invoked from several threads
+  // concurrently.
+  explicit Latency(std::optional<Clock::duration> budget, std::function<void(const Progress&)> progress = {});
+
+  // Return the latency that the operations of libflatsurf honor.
+  static Latency global();
+
+  // Replace the latency that the operations of libflatsurf honor.
+  // Operations that are running already keep using the previous latency.
+  static void global(Latency);
+
+  // Return the time each operation may run for, if limited.
+  std::optional<Clock::duration> budget() const;
+
+  // Return a budget for a decomposition that starts now, with each
+  // decomposition step limited to limit steps of the Rauzy induction (or
+  // unlimited if negative.) The budget runs out after budget() and reports
+  // each decomposition step as progress.
+  DecompositionBudget decomposition(int limit = -1) const;
+
+  // Report to the progress callback that operation has completed that many
+  // units of work.
+  void report(const char* operation, size_t completed) const;
+
+  friend std::ostream& operator<<(std::ostream&, const Latency&);
+
+ private:
+  std::shared_ptr<ImplementationOf<Latency>> self;
+
+  friend ImplementationOf<Latency>;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -40,6 +40,19 @@ class OddHalfEdgeMap {
   OddHalfEdgeMap(const FlatTriangulationCombinatorial& surface, std::function<T(HalfEdge)> values) :
     values(surface, values) {}
 
+  // Create the map from the values of the positive half edges, i.e.,
+  // positive[i] is the value of the positive half edge of the edge with
+  // index i.
+  OddHalfEdgeMap(const FlatTriangulationCombinatorial& surface, std::vector<T>&& positive) :
+    values(surface) {
+    assert(positive.size() == surface.size() && "there must be exactly one value for each edge");
+    for (size_t i = 0; i < positive.size(); i++) {
+      const HalfEdge he = Edge::fromIndex(i).positive();
+      values[-he] = -positive[i];
+      values[he] = std::move(positive[i]);
+    }
+  }
+
   const T& get(HalfEdge he) const {
     return values[he];
   }
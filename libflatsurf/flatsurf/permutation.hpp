@@ -41,6 +41,10 @@ class Permutation : boost::equality_comparable<Permutation<T>>, boost::multiplia
  public:
   Permutation() noexcept;
   explicit Permutation(const std::vector<std::vector<T>> &cycles);
+  // Create the permutation whose cycles are given in a single flat buffer,
+  // i.e., the i-th cycle consists of the entries of elements from offsets[i]
+  // to offsets[i + 1], see cycles(elements, offsets).
+  Permutation(const std::vector<T> &elements, const std::vector<size_t> &offsets);
   explicit Permutation(const std::vector<std::pair<T, T>> &permutation);
   explicit Permutation(const std::unordered_map<T, T> &permutation);
   static Permutation<T> random(const std::vector<T> &domain);
@@ -61,8 +65,16 @@ class Permutation : boost::equality_comparable<Permutation<T>>, boost::multiplia
   size_t size() const;
   const std::vector<T> &domain() const;
   std::vector<std::vector<T>> cycles() const;
+  // Write the cycles of this permutation into a single flat buffer, i.e.,
+  // the i-th cycle consists of the entries of elements from offsets[i] to
+  // offsets[i + 1]. Any previous content of elements and offsets is
+  // discarded.
+  void cycles(std::vector<T> &elements, std::vector<size_t> &offsets) const;
   // Return the cycle containing this T.
   std::vector<T> cycle(const T &) const;
+  // Remove these entries from the domain of this permutation. The entries
+  // must form cycles of their own and have the largest indices in the
+  // domain.
   void drop(const std::vector<T> &);
 
   bool trivial() const;
@@ -0,0 +1,108 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#ifndef LIBFLATSURF_PICKLE_HPP
+#define LIBFLATSURF_PICKLE_HPP
+
+#include <cereal/archives/binary.hpp>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "cereal.hpp"
+
+// Helpers for pyflatsurf to pickle objects with compact binary cereal
+// archives. Objects that live on a surface, such as saddle connections, can
+// be written without their surface so that the surface only needs to be
+// pickled once for many such objects.
+namespace flatsurf::pickle {
+
+// Return value written to a binary cereal archive.
+template <typename T>
+std::vector<unsigned char> save(const T& value) {
+  std::ostringstream stream;
+  {
+    cereal::BinaryOutputArchive archive(stream);
+    archive(value);
+  }
+  const auto bytes = stream.str();
+  return std::vector<unsigned char>(bytes.begin(), bytes.end());
+}
+
+// Return value, which lives on surface, written to a binary cereal archive
+// that does not contain surface. It can only be restored with load() and
+// the same surface (or an equal surface.)
+template <typename T, typename Surface>
+std::vector<unsigned char> save(const T& value, const Surface& surface) {
+  std::ostringstream stream;
+  {
+    cereal::BinaryOutputArchive archive(stream);
+    Serialization<Surface>::assume(archive, surface);
+    archive(value);
+  }
+  const auto bytes = stream.str();
+  return std::vector<unsigned char>(bytes.begin(), bytes.end());
+}
+
+// Return the object written by save() to the size bytes at data.
+template <typename T>
+T load(const char* data, size_t size) {
+  std::istringstream stream(std::string(data, size));
+  cereal::BinaryInputArchive archive(stream);
+  T value;
+  archive(value);
+  return value;
+}
+
+// Return the object on surface written by save() to the size bytes at data.
+template <typename T, typename Surface>
+T load(const char* data, size_t size, const Surface& surface) {
+  std::istringstream stream(std::string(data, size));
+  cereal::BinaryInputArchive archive(stream);
+  Serialization<Surface>::assume(archive, surface);
+
+  // Loading replaces an existing object so we need to create one first.
+  T value = [&]() {
+    if constexpr (std::is_default_constructible_v<T>)
+      return T();
+    else if constexpr (std::is_constructible_v<T, const Surface&>)
+      return T(surface);
+    else if constexpr (std::is_constructible_v<T, const Surface&, HalfEdge>)
+      return T(surface, HalfEdge(1));
+    else
+      return T(surface, surface.fromHalfEdge(HalfEdge(1)));
+  }();
+  archive(value);
+  return value;
+}
+
+// Return an integer that identifies surface as long as it exists, i.e., two
+// surfaces have the same identity iff any change to one also changes the
+// other.
+template <typename Surface>
+std::uintptr_t identity(const Surface& surface) {
+  return reinterpret_cast<std::uintptr_t>(Serialization<Surface>::key(surface));
+}
+
+}  // namespace flatsurf::pickle
+
+#endif
@@ -60,6 +60,12 @@ class SaddleConnection : public Serializable<SaddleConnection<Surface>>,
   // counterclockwise from target (but not necessarily in the sector next to
   // source.)
   static SaddleConnection<Surface> counterclockwise(const Surface &, HalfEdge source, HalfEdge target, const Chain<Surface> &);
+  // Return the saddle connection on surface that a saddle connection on its
+  // double approximation, see FlatTriangulation::approximate(), describes,
+  // i.e., the saddle connection from the same source to the same target
+  // crossing the same edges; or nothing if there is no such saddle
+  // connection because the approximation misjudged some predicate.
+  static std::optional<SaddleConnection<Surface>> lift(const Surface &, const SaddleConnection<FlatTriangulation<double>> &);
 
   const Vector<T> &vector() const;
   const Chain<Surface> &chain() const;
@@ -77,16 +83,20 @@ class SaddleConnection : public Serializable<SaddleConnection<Surface>>,
 
   const Surface &surface() const;
 
+  // Return the half edges that this saddle connection crosses in order.
   std::vector<HalfEdge> crossings() const;
 
-  std::optional<int> angle(const SaddleConnection<Surface> &) const;
+  // Return the angle from this saddle connection to other, turning
+  // counterclockwise around their common source vertex, as a multiple of
+  // 2π rounded down; or nothing if they do not start at the same vertex.
+  std::optional<int> angle(const SaddleConnection<Surface> &other) const;
 
   SaddleConnection<Surface> operator-() const;
 
   bool operator==(const SaddleConnection<Surface> &) const;
 
-  bool operator>(const Bound) const;
-  bool operator<(const Bound) const;
+  bool operator>(const Bound&) const;
+  bool operator<(const Bound&) const;
 
   template <typename S>
   friend std::ostream &operator<<(std::ostream &, const SaddleConnection<S> &);
@@ -0,0 +1,141 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTION_RECORDS_HPP
+#define LIBFLATSURF_SADDLE_CONNECTION_RECORDS_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include "copyable.hpp"
+#include "half_edge.hpp"
+
+namespace flatsurf {
+
+// A compact store of saddle connections on a fixed surface.
+// Each saddle connection is stored as a Record, a trivially copyable struct
+// that refers to the nonzero coefficients of its chain in a flat array of
+// Terms which is shared by all the records. The surface is held once by the
+// store and not by each connection. This needs much less memory than
+// storing the SaddleConnection objects themselves when working with millions
+// of saddle connections.
+template <typename Surface>
+class SaddleConnectionRecords {
+  static_assert(std::is_same_v<Surface, std::decay_t<Surface>>, "type must not have modifiers such as const");
+
+ public:
+  // A nonzero summand of the chain of a saddle connection.
+  struct Term {
+    // The index of the edge.
+    size_t edge;
+    int64_t coefficient;
+  };
+
+  struct Record {
+    // The ids of the source and target half edges of the saddle connection.
+    int source;
+    int target;
+    // The range of the terms of the chain of the saddle connection in
+    // terms().
+    size_t begin;
+    size_t end;
+  };
+
+  explicit SaddleConnectionRecords(const Surface &);
+
+  // Append a saddle connection on the surface of this store.
+  // Throws an std::invalid_argument if the coefficients of its chain do not
+  // fit into 64 bits.
+  const Record &push_back(const SaddleConnection<Surface> &);
+
+  // Append a saddle connection on the surface of this store given by its
+  // source, target, and chain, see the SaddleConnection constructor.
+  const Record &push_back(HalfEdge source, HalfEdge target, const Chain<Surface> &);
+
+  // Append a saddle connection on the surface of this store given by the
+  // ids of its source and target half edges and the nonzero terms of its
+  // chain in [begin, end), e.g., to restore records that have been written
+  // out with records() and terms().
+  const Record &push_back(int source, int target, const Term *begin, const Term *end);
+
+  // Return the saddle connection stored at the given position.
+  SaddleConnection<Surface> operator[](size_t) const;
+
+  // Return the saddle connection described by a record of this store.
+  SaddleConnection<Surface> operator[](const Record &) const;
+
+  size_t size() const;
+
+  bool empty() const;
+
+  void clear();
+
+  const std::vector<Record> &records() const;
+
+  const std::vector<Term> &terms() const;
+
+  // Write the connections of this store column by column into buffers with
+  // size() entries each, e.g., the data of numpy arrays: the ids of their
+  // source and target half edges, floating point approximations of the
+  // coordinates of their vectors, and of their squared lengths. Any of the
+  // buffers can be nullptr in which case that column is not written.
+  // Note that the approximations are computed in plain double precision
+  // without any guarantee on the error.
+  void columns(int *sources, int *targets, double *x, double *y, double *squared) const;
+
+  // Write the exact chains of the connections of this store in compressed
+  // sparse row format into buffers: offsets must have size() + 1 entries,
+  // edges and coefficients must have terms().size() entries. The nonzero
+  // coefficients of the chain of the i-th connection are then at the
+  // positions offsets[i], …, offsets[i + 1] - 1.
+  void chains(size_t *offsets, size_t *edges, int64_t *coefficients) const;
+
+  // Write the half edges crossed by the connections of this store, see
+  // SaddleConnection::crossings(), one connection after the other into
+  // crossings, and replace offsets with size() + 1 entries such that the
+  // crossings of the i-th connection are at the positions offsets[i], …,
+  // offsets[i + 1] - 1. Each connection only costs the number of half edges
+  // it crosses.
+  void crossings(std::vector<size_t> &offsets, std::vector<HalfEdge> &crossings) const;
+
+  // Write angle(from, connection), see SaddleConnection::angle(), for each
+  // connection of this store into angles which must have size() entries;
+  // -1 for connections that do not start at the vertex of from. The sectors
+  // at that vertex are only walked once, so each connection only costs a
+  // constant number of orientation tests.
+  void angles(const SaddleConnection<Surface> &from, int *angles) const;
+
+  const Surface &surface() const;
+
+  template <typename S>
+  friend std::ostream &operator<<(std::ostream &, const SaddleConnectionRecords<S> &);
+
+ private:
+  Copyable<SaddleConnectionRecords> self;
+
+  friend ImplementationOf<SaddleConnectionRecords>;
+};
+
+template <typename Surface>
+SaddleConnectionRecords(const Surface &) -> SaddleConnectionRecords<Surface>;
+
+}  // namespace flatsurf
+
+#endif
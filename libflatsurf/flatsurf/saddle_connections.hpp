@@ -20,6 +20,11 @@
 #ifndef LIBFLATSURF_SADDLE_CONNECTIONS_HPP
 #define LIBFLATSURF_SADDLE_CONNECTIONS_HPP
 
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
 #include "copyable.hpp"
 #include "half_edge.hpp"
 #include "vertex.hpp"
@@ -66,6 +71,15 @@ class SaddleConnections {
   // sectorBegin (inclusive) and sectorEnd (exclusive.)
   SaddleConnections<Surface> sector(const Vector<T> &sectorBegin, const Vector<T> &sectorEnd) const;
 
+  // Return only the saddle connections starting at the source vertex of
+  // connection whose direction is within epsilon of connection, i.e., which
+  // lie in the sector between connection - epsilon·v (inclusive) and
+  // connection + epsilon·v (exclusive) where v is the vector perpendicular
+  // to connection. Only the sectors at that vertex that are in the same
+  // sheet as connection are searched so, unlike sector(), this does not
+  // consider sectors at all the vertices of the surface.
+  SaddleConnections<Surface> near(const SaddleConnection<Surface> &connection, const T &epsilon) const;
+
   // Return only the saddle connections starting at source.
   SaddleConnections<Surface> source(const Vertex &source) const;
 
@@ -90,6 +104,112 @@ class SaddleConnections {
   // End position of the iterator through the saddle connections.
   iterator end() const;
 
+  // Return an iterator that continues the iteration at the position recorded
+  // in checkpoint, see SaddleConnectionsIterator::checkpoint(). The
+  // checkpoint must have been created by an iterator of saddle connections on
+  // the same surface with the same bounds and sectors.
+  iterator resume(const SaddleConnectionsIteratorCheckpoint<Surface> &checkpoint) const;
+
+  // Return these saddle connections split into at most the given number of
+  // work units that can be searched independently, e.g., in different
+  // processes. The units require roughly the same amount of work and are
+  // in the order of iteration; each saddle connection is in exactly one of
+  // them. Note that the symmetries of symmetric() are not exploited here.
+  std::vector<SaddleConnectionsWorkUnit<Surface>> split(size_t units) const;
+
+  // Return the saddle connections of the work unit, which must have been
+  // created with split() on the same surface (or a copy of it.) The bounds
+  // of the work unit replace the bounds of these connections.
+  SaddleConnections<Surface> unit(const SaddleConnectionsWorkUnit<Surface> &unit) const;
+
+  // Return the number of saddle connections. This performs the same search
+  // as iterating over these connections but never creates any actual
+  // SaddleConnection. To count connections by their source, combine this with
+  // source() or sector(). The result is remembered, so counting the same
+  // connections again is free (unless statistics are being collected.)
+  size_t count() const;
+
+  // Call callback for each saddle connection. The search is distributed
+  // over the given number of threads (or as many threads as there are cores
+  // if zero.) The callback is invoked concurrently from these threads and the
+  // connections are not reported in any particular order.
+  void forEach(const std::function<void(const SaddleConnection<Surface> &)> &callback, unsigned int threads = 0) const;
+
+  // Call callback for each saddle connection in the same order as iterating
+  // with begin() and end(), i.e., counterclockwise around each vertex. The
+  // sectors are searched by the given number of threads (or as many threads
+  // as there are cores if zero) into buffers which are reported in order
+  // from the calling thread. Only a bounded number of buffers is searched
+  // ahead of the one currently being reported.
+  void forEachByAngle(const std::function<void(const SaddleConnection<Surface> &)> &callback, unsigned int threads = 0) const;
+
+  // Return the distinct directions of these saddle connections in
+  // counterclockwise order, starting with the direction of the positive x
+  // axis (inclusive.) Each direction is given by the vector of the shortest
+  // saddle connection in that direction together with the number of saddle
+  // connections in that direction. The search is distributed over the given
+  // number of threads as in forEach().
+  std::vector<std::pair<Vector<T>, size_t>> directions(unsigned int threads = 0) const;
+
+  // Return these saddle connections sorted into buckets by their length,
+  // see SaddleConnectionsBuckets. Only the connections of length at most the
+  // last of the bounds are searched. The search is distributed over the
+  // given number of threads as in forEach().
+  SaddleConnectionsBuckets<Surface> buckets(std::vector<Bound> bounds, unsigned int threads = 0) const;
+
+  // Call callback for each saddle connection in order of increasing length
+  // until it returns false. Unlike byLength(), which searches rings of
+  // growing radius, this performs a best-first search, i.e., the first
+  // connections are reported as soon as nothing shorter can exist, and the
+  // memory used grows with the frontier of the search only.
+  void forEachByLength(const std::function<bool(const SaddleConnection<Surface> &)> &callback) const;
+
+  // Return a copy of these saddle connections whose count(), forEach(), and
+  // forEachByLength() are served from a cache that is attached to the
+  // surface if a bound() has been set. The cache holds all the saddle
+  // connections up to the largest bound requested so far through cached()
+  // saddle connections on this surface, so repeated searches with the same
+  // or smaller bounds, in fewer sectors, or with a lowerBound() do not search
+  // the surface again. Any change to the surface, e.g., a flip, empties the
+  // cache. Note that iteration with begin() and end() always searches the
+  // surface.
+  SaddleConnections<Surface> cached() const;
+
+  // Return a copy of these saddle connections whose count() and forEach()
+  // exploit the rotational and translational symmetries of the surface.
+  // The orientation preserving isometric automorphisms of the surface are
+  // computed once here with FlatTriangulation::automorphisms(). The
+  // searches then only visit one sector out of each orbit under these
+  // automorphisms and report the images of the connections found there.
+  // When the sectors are not invariant under the automorphisms, e.g.,
+  // because they have been restricted with sector(), the searches fall back
+  // to searching all the sectors.
+  SaddleConnections<Surface> symmetric() const;
+
+  // Return a copy of these saddle connections whose forEach() distributes
+  // the given number of copies of the surface among its threads (or lets
+  // all threads read the surface itself if zero.) Each copy is created by
+  // the first thread that searches on it, so on machines with several
+  // memory nodes, its memory is typically local to that thread. The
+  // connections found on a copy are translated back to the surface, which
+  // takes time linear in the number of edges for each connection, so this
+  // only pays off for searches that read the surface a lot from many
+  // threads.
+  SaddleConnections<Surface> replicated(unsigned int replicas) const;
+
+  // Return a copy of these saddle connections that records statistics about
+  // the searches performed by its iterators, by count(), and by byLength().
+  // The statistics are shared with all the objects derived from the copy,
+  // e.g., with bound(). Collecting statistics slows down the search
+  // slightly, so it is disabled by default.
+  SaddleConnections<Surface> collectStatistics() const;
+
+  // Return the statistics collected so far if collectStatistics() has been
+  // enabled. An iterator contributes its statistics once it has been
+  // destroyed. Note that forEach() and forEachByLength() do not report any
+  // statistics.
+  std::optional<SaddleConnectionsStatistics> statistics() const;
+
   template <typename S>
   friend std::ostream &operator<<(std::ostream &, const SaddleConnections<S> &);
 
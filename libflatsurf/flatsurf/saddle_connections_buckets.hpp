@@ -0,0 +1,114 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_BUCKETS_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_BUCKETS_HPP
+
+#include <iosfwd>
+#include <vector>
+
+#include "bound.hpp"
+#include "copyable.hpp"
+#include "saddle_connection_records.hpp"
+#include "serializable.hpp"
+
+namespace flatsurf {
+
+// The saddle connections on a fixed surface sorted into buckets by their
+// length.
+// The buckets are given by increasing bounds b₀ < b₁ < … < bₙ. The i-th
+// bucket holds the connections whose length is in (bᵢ₋₁, bᵢ], the first
+// bucket the connections of length at most b₀. The connections of each
+// bucket are stored compactly in SaddleConnectionRecords and the number of
+// connections up to each bound is kept, so counting N(R), the number of
+// saddle connections of length at most R, for many R, e.g., to observe the
+// quadratic growth of N(R), does not need to look at the connections
+// themselves. The buckets are typically populated directly by a search with
+// SaddleConnections::buckets().
+template <typename Surface>
+class SaddleConnectionsBuckets : Serializable<SaddleConnectionsBuckets<Surface>> {
+  static_assert(std::is_same_v<Surface, std::decay_t<Surface>>, "type must not have modifiers such as const");
+
+ public:
+  // Create empty buckets for the given bounds.
+  // Throws a std::invalid_argument if there are no bounds or if they are not
+  // strictly increasing.
+  SaddleConnectionsBuckets(const Surface &, std::vector<Bound> bounds);
+
+  // Create buckets for the given bounds that hold the given saddle
+  // connections, e.g., when restoring buckets that have been serialized. The
+  // connections of each bucket are not checked against the bounds.
+  // Throws a std::invalid_argument if there are no bounds, if they are not
+  // strictly increasing, or if there is not one store of connections for
+  // each bound.
+  SaddleConnectionsBuckets(std::vector<SaddleConnectionRecords<Surface>> buckets, std::vector<Bound> bounds);
+
+  // Add a saddle connection to its bucket. Returns whether the connection
+  // has been added, i.e., whether it is not longer than the last bound.
+  // Throws an std::invalid_argument if the coefficients of its chain do not
+  // fit into 64 bits, see SaddleConnectionRecords::push_back().
+  bool push_back(const SaddleConnection<Surface> &);
+
+  // Return the index of the bucket that a saddle connection belongs to, or
+  // the number of buckets if it is longer than the last bound. This
+  // performs a binary search in the bounds.
+  size_t bucket(const SaddleConnection<Surface> &) const;
+
+  // Return the bounds of the buckets.
+  const std::vector<Bound> &bounds() const;
+
+  // Return the saddle connections in the i-th bucket.
+  const SaddleConnectionRecords<Surface> &operator[](size_t) const;
+
+  // Return the number of saddle connections of length at most bound.
+  // If bound is one of the bounds(), or beyond the last one, this is a
+  // binary search in the bounds. Otherwise, the connections of the bucket
+  // that bound falls into are compared to it.
+  size_t count(Bound bound) const;
+
+  // Return the number of saddle connections whose length is in (lower,
+  // upper], see count(Bound).
+  size_t count(Bound lower, Bound upper) const;
+
+  // Return the saddle connections whose length is in (lower, upper] ordered
+  // by their bucket. Only the buckets that overlap this range are visited.
+  std::vector<SaddleConnection<Surface>> range(Bound lower, Bound upper) const;
+
+  // Return the total number of saddle connections in all buckets.
+  size_t size() const;
+
+  bool empty() const;
+
+  const Surface &surface() const;
+
+  template <typename S>
+  friend std::ostream &operator<<(std::ostream &, const SaddleConnectionsBuckets<S> &);
+
+ private:
+  Copyable<SaddleConnectionsBuckets> self;
+
+  friend ImplementationOf<SaddleConnectionsBuckets>;
+};
+
+template <typename Surface>
+SaddleConnectionsBuckets(const Surface &, std::vector<Bound>) -> SaddleConnectionsBuckets<Surface>;
+
+}  // namespace flatsurf
+
+#endif
@@ -21,6 +21,7 @@
 #define LIBFLATSURF_SADDLE_CONNECTIONS_BY_LENGTH_ITERATOR_HPP
 
 #include <boost/iterator/iterator_facade.hpp>
+#include <vector>
 
 #include "copyable.hpp"
 
@@ -42,6 +43,10 @@ class SaddleConnectionsByLengthIterator : public boost::iterator_facade<SaddleCo
   bool equal(const SaddleConnectionsByLengthIterator &other) const;
   const SaddleConnection<Surface> &dereference() const;
 
+  // Return the next (at most) n saddle connections and advance the iterator
+  // past them, see SaddleConnectionsIterator::batch().
+  std::vector<SaddleConnection<Surface>> batch(size_t n);
+
   template <typename S>
   friend std::ostream &operator<<(std::ostream &, const SaddleConnectionsByLengthIterator<S> &);
 
@@ -0,0 +1,88 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_INDEX_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_INDEX_HPP
+
+#include <iosfwd>
+#include <vector>
+
+#include "bound.hpp"
+#include "copyable.hpp"
+
+namespace flatsurf {
+
+// An index of the saddle connections on a fixed surface up to a fixed
+// radius, sorted by angle in each sector at the vertices of the surface.
+// Once built, repeated queries for the saddle connections in narrow sectors,
+// e.g., around many directions on the same surface, are answered by binary
+// search in the sorted sectors instead of a search on the surface. Queries
+// with a bound that exceeds the radius of the index fall back to such a
+// search.
+template <typename Surface>
+class SaddleConnectionsIndex {
+  static_assert(std::is_same_v<Surface, std::decay_t<Surface>>, "type must not have modifiers such as const");
+
+  using T = typename Surface::Coordinate;
+
+ public:
+  // Index the saddle connections of length at most radius on the surface.
+  // Throws a std::logic_error if the surface has boundary.
+  SaddleConnectionsIndex(const Surface &, Bound radius);
+
+  // Return the saddle connections whose direction lies in the sector between
+  // sectorBegin (inclusive) and sectorEnd (exclusive) and whose length is at
+  // most the radius of this index, as in SaddleConnections::sector().
+  std::vector<SaddleConnection<Surface>> sector(const Vector<T> &sectorBegin, const Vector<T> &sectorEnd) const;
+
+  // Return the saddle connections whose direction lies in the sector between
+  // sectorBegin (inclusive) and sectorEnd (exclusive) and whose length is at
+  // most bound. If bound exceeds the radius of this index, this searches the
+  // surface for the saddle connections in that sector.
+  std::vector<SaddleConnection<Surface>> sector(const Vector<T> &sectorBegin, const Vector<T> &sectorEnd, Bound bound) const;
+
+  // Return the indexed saddle connections in the sector between sectorBegin
+  // (inclusive) and the following half edge (exclusive) in counter-clockwise
+  // order, sorted by angle.
+  const std::vector<SaddleConnection<Surface>> &sector(HalfEdge sectorBegin) const;
+
+  // Return the radius up to which saddle connections are indexed.
+  Bound radius() const;
+
+  // Return the number of indexed saddle connections.
+  size_t size() const;
+
+  const Surface &surface() const;
+
+  template <typename S>
+  friend std::ostream &operator<<(std::ostream &, const SaddleConnectionsIndex<S> &);
+
+ private:
+  Copyable<SaddleConnectionsIndex> self;
+
+  friend ImplementationOf<SaddleConnectionsIndex>;
+};
+
+template <typename Surface>
+SaddleConnectionsIndex(const Surface &, Bound) -> SaddleConnectionsIndex<Surface>;
+
+}  // namespace flatsurf
+
+#endif
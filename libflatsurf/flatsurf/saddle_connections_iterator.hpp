@@ -20,14 +20,19 @@
 #ifndef LIBFLATSURF_SADDLE_CONNECTIONS_ITERATOR_HPP
 #define LIBFLATSURF_SADDLE_CONNECTIONS_ITERATOR_HPP
 
+#include <gmpxx.h>
+
 #include <boost/iterator/iterator_facade.hpp>
 #include <optional>
+#include <vector>
 
 #include "copyable.hpp"
 
 namespace flatsurf {
 
 // Iterates over the saddle connections on a triangulation translation surface.
+// An iterator must not be shared between threads. However, the saddle
+// connections it produces can be used from several threads at once.
 template <typename Surface>
 class SaddleConnectionsIterator : public boost::iterator_facade<SaddleConnectionsIterator<Surface>, const SaddleConnection<Surface>, boost::forward_traversal_tag> {
   static_assert(std::is_same_v<Surface, std::decay_t<Surface>>, "type must not have modifiers such as const");
@@ -50,6 +55,32 @@ class SaddleConnectionsIterator : public boost::iterator_facade<SaddleConnection
 
   void skipSector(CCW sector);
 
+  // Write the next (at most) n saddle connections in a compact format and
+  // advance the iterator past them. Returns the number of connections that
+  // have been written. For each connection its source and target are
+  // appended to halfEdges and the coefficients of its chain are appended to
+  // coefficients (one for each edge of the surface, ordered by the index of
+  // the edges.) This is much faster than iterating when crossing a language
+  // boundary, e.g., from Python.
+  size_t fill(std::vector<HalfEdge> &halfEdges, std::vector<mpz_class> &coefficients, size_t n);
+
+  // Append the next (at most) n saddle connections to records and advance the
+  // iterator past them. Returns the number of connections that have been
+  // written.
+  size_t fill(SaddleConnectionRecords<Surface> &records, size_t n);
+
+  // Return the next (at most) n saddle connections and advance the iterator
+  // past them. Returns fewer connections only when the iterator reached the
+  // end. This is much faster than iterating when crossing a language
+  // boundary, e.g., from Python, since the connections can be consumed
+  // without comparing to an end iterator after each step.
+  std::vector<SaddleConnection<Surface>> batch(size_t n);
+
+  // Return the exact position of this iterator. The iteration can later be
+  // continued from there with SaddleConnections::resume(), possibly after
+  // the checkpoint has been serialized and deserialized with cereal.
+  SaddleConnectionsIteratorCheckpoint<Surface> checkpoint() const;
+
   template <typename S>
   friend std::ostream &operator<<(std::ostream &, const SaddleConnectionsIterator<S> &);
 
@@ -0,0 +1,68 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_ITERATOR_CHECKPOINT_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_ITERATOR_CHECKPOINT_HPP
+
+#include <optional>
+#include <variant>
+#include <vector>
+
+#include "chain.hpp"
+#include "forward.hpp"
+#include "half_edge.hpp"
+#include "vector.hpp"
+
+namespace flatsurf {
+
+// The exact position of a SaddleConnectionsIterator, see
+// SaddleConnectionsIterator::checkpoint(). The search can be continued from
+// such a checkpoint with SaddleConnections::resume() on the same surface with
+// the same bounds and sectors. Checkpoints can be serialized with cereal, so
+// a long enumeration of saddle connections can be split across processes.
+template <typename Surface>
+struct SaddleConnectionsIteratorCheckpoint {
+  using T = typename Surface::Coordinate;
+
+  // The index of the sector that is being searched. This is the number of
+  // sectors if the iterator is at its end.
+  size_t sector = 0;
+
+  // The two rays enclosing the part of the sector that is being searched,
+  // followed by the rays that have been set aside during the recursive
+  // descent of the search, innermost last.
+  std::vector<std::variant<Chain<Surface>, Vector<T>>> boundaries;
+
+  // The half edge that the search is about to cross and the vector to its
+  // target. Not set if the iterator is at its end.
+  HalfEdge nextEdge;
+  std::optional<Chain<Surface>> nextEdgeEnd;
+
+  // The call stack of the search in an encoding internal to the iterator.
+  std::vector<unsigned char> state;
+
+  template <typename Archive>
+  void save(Archive&) const;
+  template <typename Archive>
+  void load(Archive&);
+};
+
+}  // namespace flatsurf
+
+#endif
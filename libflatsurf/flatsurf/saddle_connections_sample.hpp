@@ -20,6 +20,9 @@
 #ifndef LIBFLATSURF_SADDLE_CONNECTIONS_SAMPLE_HPP
 #define LIBFLATSURF_SADDLE_CONNECTIONS_SAMPLE_HPP
 
+#include <functional>
+#include <optional>
+
 #include "copyable.hpp"
 #include "half_edge.hpp"
 #include "vertex.hpp"
@@ -73,6 +76,36 @@ class SaddleConnectionsSample {
   // Return only the saddle connections starting at source.
   SaddleConnectionsSample source(const Vertex &source) const;
 
+  // Return the configured seed of the random number generator, if any.
+  std::optional<unsigned int> seed() const;
+
+  // Return the same sample but with its iterators seeded with seed so that
+  // the sequence of connections is reproducible.
+  SaddleConnectionsSample seed(unsigned int seed) const;
+
+  // Return the number of saddle connections that the iterators remember to
+  // not report the same connection twice, or nothing if they remember all of
+  // them (the default.)
+  std::optional<size_t> deduplication() const;
+
+  // Return the same sample but with iterators that only remember the last
+  // capacity connections they reported so that their memory does not grow
+  // unboundedly. A capacity of zero disables deduplication altogether.
+  SaddleConnectionsSample deduplication(std::optional<size_t> capacity) const;
+
+  // Return whether the iterators sample by following straight lines, see
+  // trajectories(bool).
+  bool trajectories() const;
+
+  // Return the same sample but with iterators that draw each connection by
+  // picking a random sector and a direction in it uniformly at random and
+  // then following the straight line in that direction through the
+  // triangles until it passes a saddle connection that exceeds the lower
+  // bound and has not been reported before. Each sample costs time linear
+  // in the number of triangles crossed, whereas the default strategy
+  // restarts a search in a random sector for every sample.
+  SaddleConnectionsSample trajectories(bool enable) const;
+
   // Return the saddle connections ordered by increasing angle.
   SaddleConnections<Surface> byAngle() const;
 
@@ -89,6 +122,17 @@ class SaddleConnectionsSample {
   // End position of the iterator through the saddle connections.
   iterator end() const;
 
+  // Call callback for count distinct randomly sampled saddle connections.
+  // The sampling is distributed over the given number of threads (or as many
+  // threads as there are cores if zero.) Each thread draws from its own
+  // random stream; the streams are derived from seed (or the configured
+  // seed() or a random seed if not set.) Since the threads race to report
+  // their connections, the connections reported are not reproducible with
+  // more than one thread. Unless deduplication() is bounded, no connection is
+  // reported twice; otherwise, each thread only remembers its own recent
+  // connections. The callback is invoked concurrently from these threads.
+  void forEach(size_t count, const std::function<void(const SaddleConnection<Surface> &)> &callback, unsigned int threads = 0, std::optional<unsigned int> seed = std::nullopt) const;
+
   template <typename S>
   friend std::ostream &operator<<(std::ostream &, const SaddleConnectionsSample<S> &);
 
@@ -0,0 +1,63 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_STATISTICS_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_STATISTICS_HPP
+
+#include <cstddef>
+#include <iosfwd>
+
+#include "forward.hpp"
+
+namespace flatsurf {
+
+// Counters describing the work performed by the searches for saddle
+// connections, see SaddleConnections::collectStatistics().
+struct SaddleConnectionsStatistics {
+  // The number of times the search crossed a half edge into another
+  // triangle.
+  size_t trianglesCrossed = 0;
+  // The number of vertices that were classified with respect to the search
+  // sector.
+  size_t classifications = 0;
+  // The number of orientation predicates that were decided by a floating
+  // point approximation and the number that required exact arithmetic.
+  size_t approximatePredicates = 0;
+  size_t exactPredicates = 0;
+  // The number of pending moves through the triangulation that were
+  // combined with another move without touching the exact vector of the
+  // search, and the number of moves that had to be applied to it one by one.
+  size_t combinedMoves = 0;
+  size_t appliedMoves = 0;
+  // The maximum depth of the recursive descent of the search.
+  size_t maximumDepth = 0;
+  // The number of times that an exact chain was copied, e.g., to shrink the
+  // search sector or to report a saddle connection.
+  size_t chainCopies = 0;
+
+  // Accumulate the counters of another search into these; the depths are
+  // combined by taking their maximum.
+  SaddleConnectionsStatistics& operator+=(const SaddleConnectionsStatistics&);
+
+  friend std::ostream& operator<<(std::ostream&, const SaddleConnectionsStatistics&);
+};
+
+}  // namespace flatsurf
+
+#endif
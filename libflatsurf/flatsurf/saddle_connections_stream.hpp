@@ -0,0 +1,178 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_STREAM_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_STREAM_HPP
+
+#include <cereal/archives/binary.hpp>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "cereal.hpp"
+#include "chain.hpp"
+#include "edge.hpp"
+#include "half_edge.hpp"
+#include "saddle_connection.hpp"
+
+namespace flatsurf {
+
+// Writes saddle connections of a single surface to a stream as they are
+// produced, e.g., while iterating over SaddleConnections, so that they never
+// need to be held in memory all at once. The surface is written once at the
+// beginning of the stream; each saddle connection is then recorded by its
+// source, its target, and the nonzero coefficients of its chain. Records are
+// written in chunks of a fixed number of saddle connections.
+// Like cereal.hpp, this header requires cereal to be installed.
+template <typename Surface>
+class SaddleConnectionsWriter {
+ public:
+  // Create a writer for the saddle connections of surface, which must
+  // outlive this writer.
+  SaddleConnectionsWriter(std::ostream& os, const Surface& surface, size_t chunk = 1024) :
+    os(os),
+    surface(surface),
+    chunk(chunk == 0 ? 1 : chunk) {
+    cereal::BinaryOutputArchive archive(os);
+    archive(surface);
+  }
+
+  // Record a saddle connection which must be a saddle connection on the
+  // surface of this writer.
+  void push(const SaddleConnection<Surface>& connection) {
+    const Chain<Surface>& chain = connection;
+
+    std::vector<std::pair<Edge, Replaced<mpz_class>>> coefficients;
+    for (auto edge : surface.edges())
+      if (chain[edge] != 0)
+        coefficients.emplace_back(edge, Replaced<mpz_class>{chain[edge]});
+
+    cereal::BinaryOutputArchive archive(pending);
+    archive(connection.source(), connection.target(), coefficients);
+
+    if (++count == chunk)
+      flush();
+  }
+
+  // Record all the saddle connections of connections, e.g., of a
+  // SaddleConnections range.
+  template <typename Connections>
+  void write(const Connections& connections) {
+    for (const auto& connection : connections)
+      push(connection);
+  }
+
+  // Write the pending records to the stream.
+  void flush() {
+    if (count == 0)
+      return;
+
+    const auto records = pending.str();
+    writeHeader(count);
+    os.write(records.data(), static_cast<std::streamsize>(records.size()));
+    os.flush();
+
+    pending.str("");
+    count = 0;
+  }
+
+  // Write the pending records and mark the end of the stream. No further
+  // saddle connections can be recorded.
+  void finish() {
+    flush();
+    writeHeader(0);
+    os.flush();
+  }
+
+ private:
+  void writeHeader(std::uint64_t records) {
+    os.write(reinterpret_cast<const char*>(&records), sizeof(records));
+  }
+
+  std::ostream& os;
+  const Surface& surface;
+  const size_t chunk;
+
+  std::stringstream pending;
+  size_t count = 0;
+};
+
+// Reads the saddle connections written by a SaddleConnectionsWriter one by
+// one.
+template <typename Surface>
+class SaddleConnectionsReader {
+ public:
+  explicit SaddleConnectionsReader(std::istream& is) :
+    is(is) {
+    cereal::BinaryInputArchive archive(is);
+    archive(surface_);
+  }
+
+  // Return the surface on which the saddle connections live.
+  const Surface& surface() const { return surface_; }
+
+  // Return the next saddle connection or nothing if all saddle connections
+  // have been read.
+  std::optional<SaddleConnection<Surface>> next() {
+    if (remaining == 0) {
+      if (finished)
+        return std::nullopt;
+
+      is.read(reinterpret_cast<char*>(&remaining), sizeof(remaining));
+      if (!is)
+        throw std::runtime_error("saddle connection stream ended unexpectedly");
+
+      if (remaining == 0) {
+        finished = true;
+        return std::nullopt;
+      }
+    }
+
+    remaining--;
+
+    HalfEdge source, target;
+    std::vector<std::pair<Edge, Replaced<mpz_class>>> coefficients;
+    cereal::BinaryInputArchive archive(is);
+    archive(source, target, coefficients);
+
+    std::vector<mpz_class> dense(surface_.size());
+    for (auto& [edge, coefficient] : coefficients)
+      dense[edge.index()] = std::move(coefficient.value);
+    Chain<Surface> chain(surface_, dense);
+
+    return SaddleConnection<Surface>(surface_, source, target, std::move(chain));
+  }
+
+ private:
+  std::istream& is;
+  Surface surface_;
+
+  // The number of records left in the current chunk.
+  std::uint64_t remaining = 0;
+  bool finished = false;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,78 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_WORK_UNIT_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_WORK_UNIT_HPP
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "bound.hpp"
+#include "forward.hpp"
+#include "half_edge.hpp"
+#include "vector.hpp"
+
+namespace flatsurf {
+
+// A part of a search for saddle connections that can be performed on its
+// own, see SaddleConnections::split(). The saddle connections of a work unit
+// are obtained with SaddleConnections::unit() on the same surface. Work
+// units can be serialized with cereal, so a single search can be spread
+// across processes, e.g., over the nodes of a cluster.
+template <typename Surface>
+struct SaddleConnectionsWorkUnit {
+  using T = typename Surface::Coordinate;
+
+  // A sector at the source of a half edge which is searched for saddle
+  // connections.
+  struct Sector {
+    // The half edge that starts the sector, i.e., the sector lies between
+    // source (inclusive) and the following half edge counterclockwise
+    // (exclusive.)
+    HalfEdge source;
+
+    // The rays enclosing the part of the sector that is searched (the first
+    // inclusive, the second exclusive) or nothing if the whole sector is
+    // searched.
+    std::optional<std::pair<Vector<T>, Vector<T>>> rays;
+
+    template <typename Archive>
+    void save(Archive&) const;
+    template <typename Archive>
+    void load(Archive&);
+  };
+
+  // The sectors searched in the order in which iteration visits them.
+  std::vector<Sector> sectors;
+
+  // Only saddle connections of length at most bound (if set) and longer
+  // than lowerBound are reported.
+  std::optional<Bound> bound;
+  Bound lowerBound;
+
+  template <typename Archive>
+  void save(Archive&) const;
+  template <typename Archive>
+  void load(Archive&);
+};
+
+}  // namespace flatsurf
+
+#endif
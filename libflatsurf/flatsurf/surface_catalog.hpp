@@ -0,0 +1,212 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SURFACE_CATALOG_HPP
+#define LIBFLATSURF_SURFACE_CATALOG_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cereal/archives/binary.hpp>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cereal.hpp"
+#include "executor.hpp"
+#include "flat_triangulation.hpp"
+
+namespace flatsurf {
+
+// Writes a catalog of many surfaces to a stream which can then be read with
+// SurfaceCatalog. Each surface is stored as a separate binary cereal archive;
+// an index of their offsets follows after the last surface.
+// Like cereal.hpp, this header requires cereal to be installed.
+template <typename T>
+class SurfaceCatalogWriter {
+ public:
+  explicit SurfaceCatalogWriter(std::ostream& os) :
+    os(os),
+    start(os.tellp()) {}
+
+  // Append surface to the catalog.
+  void push(const FlatTriangulation<T>& surface) {
+    if (finished)
+      throw std::logic_error("cannot add surfaces to a catalog that has been finished");
+
+    offsets.push_back(static_cast<std::uint64_t>(os.tellp() - start));
+
+    cereal::BinaryOutputArchive archive(os);
+    archive(surface);
+  }
+
+  // Write the index of the catalog. No further surfaces can be added.
+  void finish() {
+    if (finished)
+      return;
+    finished = true;
+
+    const auto index = static_cast<std::uint64_t>(os.tellp() - start);
+    for (const auto offset : offsets)
+      write(offset);
+    write(offsets.size());
+    write(index);
+  }
+
+ private:
+  void write(std::uint64_t value) {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  std::ostream& os;
+  const std::ostream::pos_type start;
+  std::vector<std::uint64_t> offsets;
+  bool finished = false;
+};
+
+// A read-only catalog of surfaces written by SurfaceCatalogWriter.
+// Opening a catalog only reads its size; a surface is only read from the
+// underlying stream when it is requested, so it is cheap to work with a
+// small subset of a large catalog.
+template <typename T>
+class SurfaceCatalog {
+ public:
+  // Open the catalog stored in the file at path.
+  explicit SurfaceCatalog(const std::string& path) :
+    SurfaceCatalog(std::make_shared<std::ifstream>(path, std::ios::binary)) {}
+
+  // Open the catalog stored in stream which must start at the beginning of
+  // the catalog.
+  explicit SurfaceCatalog(std::shared_ptr<std::istream> stream) :
+    stream(std::move(stream)),
+    start(this->stream->tellg()) {
+    if (!*this->stream)
+      throw std::invalid_argument("cannot read surface catalog from this stream");
+
+    this->stream->seekg(-2 * static_cast<std::streamoff>(sizeof(std::uint64_t)), std::ios::end);
+    count = read();
+    index = read();
+
+    if (!*this->stream)
+      throw std::invalid_argument("stream does not contain a surface catalog");
+  }
+
+  // Return the number of surfaces in this catalog.
+  size_t size() const { return count; }
+
+  // Return the i-th surface in this catalog.
+  FlatTriangulation<T> operator[](size_t i) const {
+    if (i >= count)
+      throw std::out_of_range("no such surface in this catalog");
+
+    return decode(entry(i));
+  }
+
+  // Return all the surfaces in this catalog. The entries are read from the
+  // underlying stream one after the other but decoded in parallel with the
+  // given number of threads (or Executor::concurrency() many if zero.)
+  std::vector<FlatTriangulation<T>> surfaces(unsigned int threads = 0) const {
+    std::vector<FlatTriangulation<T>> surfaces(count);
+
+    if (threads == 0)
+      threads = Executor::global().concurrency();
+    threads = static_cast<unsigned int>(std::min<std::uint64_t>(threads, std::max<std::uint64_t>(count, 1)));
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+
+    const auto work = [&]() {
+      try {
+        for (size_t i = next++; i < count && !failed; i = next++)
+          surfaces[i] = decode(entry(i));
+      } catch (...) {
+        if (!failed.exchange(true))
+          error = std::current_exception();
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int worker = 1; worker < threads; worker++)
+      workers.emplace_back(work);
+    work();
+    for (auto& worker : workers)
+      worker.join();
+
+    if (error)
+      std::rethrow_exception(error);
+
+    return surfaces;
+  }
+
+ private:
+  // Return the bytes of the binary archive of the i-th surface.
+  std::string entry(size_t i) const {
+    std::lock_guard<std::mutex> guard(lock);
+
+    stream->seekg(start + static_cast<std::streamoff>(index + i * sizeof(std::uint64_t)));
+    const auto offset = read();
+    // The index of the catalog follows right after the last surface.
+    const auto next = i + 1 == count ? index : read();
+
+    std::string bytes(next - offset, '\0');
+    stream->seekg(start + static_cast<std::streamoff>(offset));
+    stream->read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!*stream)
+      throw std::runtime_error("surface catalog ended unexpectedly");
+
+    return bytes;
+  }
+
+  static FlatTriangulation<T> decode(const std::string& bytes) {
+    std::istringstream is(bytes);
+
+    FlatTriangulation<T> surface;
+    cereal::BinaryInputArchive archive(is);
+    archive(surface);
+    return surface;
+  }
+
+  std::uint64_t read() const {
+    std::uint64_t value = 0;
+    stream->read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+  }
+
+  const std::shared_ptr<std::istream> stream;
+  const std::istream::pos_type start;
+  std::uint64_t count;
+  std::uint64_t index;
+
+  // Serializes the access to stream; the surfaces themselves are decoded
+  // outside of this lock.
+  mutable std::mutex lock;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,74 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_TRACING_HPP
+#define LIBFLATSURF_TRACING_HPP
+
+#include <chrono>
+#include <iosfwd>
+#include <optional>
+
+#include "forward.hpp"
+
+namespace flatsurf {
+
+// Records how long the major operations of the library take, e.g.,
+// FlatTriangulation::delaunay() or FlowDecomposition::decompose(), so that a
+// slow computation can be attributed to a phase of the library.
+// The library only contains these scopes when it has been configured with
+// --enable-tracing; otherwise they are compiled out entirely. Even then,
+// recording is disabled by default. It is enabled with enable() or by
+// setting the environment variable LIBFLATSURF_TRACE to a path, in which
+// case the trace is written to that path when the program exits.
+// The trace is written in the Chrome Trace Event format which can be
+// inspected with chrome://tracing or https://ui.perfetto.dev.
+class Tracing {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Records the time between its construction and its destruction as an
+  // event called `name` (if tracing is enabled at construction.)
+  // The name must outlive the trace; it is typically a string literal.
+  class Scope {
+   public:
+    explicit Scope(const char* name) noexcept;
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope();
+
+   private:
+    const char* name;
+    std::optional<Clock::time_point> start;
+  };
+
+  // Start (or stop) recording events.
+  static void enable(bool enabled = true);
+
+  static bool enabled();
+
+  // Drop all the events recorded so far.
+  static void reset();
+
+  // Write all the events recorded so far as a Chrome trace.
+  static void write(std::ostream&);
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -20,14 +20,61 @@
 #define LIBFLATSURF_VECTOR_HPP
 
 #include <exact-real/forward.hpp>
+#include <type_traits>
 
 #include "copyable.hpp"
 #include "detail/vector_exact.hpp"
 #include "detail/vector_with_error.hpp"
+#include "inline_copyable.hpp"
 
 namespace flatsurf {
 
+namespace detail {
+
+// The storage of the coordinates of a Vector<T>. Vectors with coordinates
+// of bounded size are stored inline so that arithmetic and the predicates
+// on vectors do not need to allocate on the heap. Other vectors use a pimpl
+// on the heap.
+template <typename T>
+struct VectorStorage {
+  using type = Copyable<Vector<T>>;
+};
+
+template <>
+struct VectorStorage<long long> {
+  using type = InlineCopyable<Vector<long long>, 2 * sizeof(long long)>;
+};
+
+template <>
+struct VectorStorage<mpz_class> {
+  using type = InlineCopyable<Vector<mpz_class>, 2 * sizeof(mpz_class)>;
+};
+
+template <>
+struct VectorStorage<mpq_class> {
+  using type = InlineCopyable<Vector<mpq_class>, 2 * sizeof(mpq_class)>;
+};
+
+template <>
+struct VectorStorage<double> {
+  using type = InlineCopyable<Vector<double>, 2 * sizeof(double)>;
+};
+
+// An arb_t consists of six words.
+template <>
+struct VectorStorage<exactreal::Arb> {
+  using type = InlineCopyable<Vector<exactreal::Arb>, 2 * 6 * sizeof(void*)>;
+};
+
+}  // namespace detail
+
 // A vector in ℝ² whose coordinates are of type T.
+// For floating point coordinates, i.e., T = double, the predicates such as
+// ccw() and orientation() and comparisons with a Bound are only decided up
+// to a small relative error, e.g., vectors that are almost parallel are
+// considered to be collinear. Everything built on top of such vectors is
+// therefore heuristic. Note that equality of such vectors is still the
+// exact equality of their coordinates.
 template <typename T>
 class Vector : public std::conditional_t<std::is_same_v<T, exactreal::Arb>, detail::VectorWithError<Vector<T>>, detail::VectorExact<Vector<T>, T>> {
  public:
@@ -59,7 +106,7 @@ class Vector : public std::conditional_t<std::is_same_v<T, exactreal::Arb>, deta
   template <typename Archive>
   void load(Archive& archive);
 
-  Copyable<Vector<T>> self;
+  typename detail::VectorStorage<T>::type self;
   friend ImplementationOf<Vector<T>>;
 };
 }  // namespace flatsurf
@@ -0,0 +1,93 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_VEECH_GROUP_HPP
+#define LIBFLATSURF_VEECH_GROUP_HPP
+
+#include <iosfwd>
+#include <utility>
+#include <vector>
+
+#include "bound.hpp"
+#include "movable.hpp"
+#include "vector.hpp"
+
+namespace flatsurf {
+
+// A search for elements of the Veech group of a translation surface, i.e.,
+// of the derivatives of its affine automorphisms.
+// An element g is determined by the images g·u and g·v of two non-parallel
+// holonomy vectors u and v of saddle connections, see reference(). Since
+// these images are again holonomy vectors of saddle connections, the
+// elements can be found among the pairs of such vectors of bounded length.
+template <typename Surface>
+class VeechGroup {
+  static_assert(std::is_same_v<Surface, std::decay_t<Surface>>, "type must not have modifiers such as const");
+
+  using T = typename Surface::Coordinate;
+
+ public:
+  // The matrix (a, b; c, d) / denominator. The entries have a common
+  // denominator so that elements can be represented when the coordinates
+  // do not form a field.
+  struct Element {
+    T a, b, c, d;
+    T denominator;
+  };
+
+  // Throws an exception if the surface does not have two non-parallel saddle
+  // connections.
+  explicit VeechGroup(const Surface&);
+
+  // Return the non-parallel holonomy vectors u and v that determine the
+  // elements, namely the shortest vector of a saddle connection and the
+  // shortest vector of a saddle connection not parallel to it.
+  std::pair<Vector<T>, Vector<T>> reference() const;
+
+  // Return the elements g of the Veech group such that g·u and g·v have
+  // length at most bound, where u and v are the reference() vectors. The
+  // elements are sorted by the order in which the saddle connections
+  // producing g·u and g·v are found.
+  // Each pair of holonomy vectors defines a candidate matrix. Candidates
+  // whose determinant is not 1, or whose trace is certainly not the trace
+  // of an element of finite order although the candidate is elliptic, are
+  // rejected with ball arithmetic before the exact determinant is checked.
+  // The remaining candidates are applied to the surface and verified by
+  // searching for a translation isomorphism with the given number of
+  // threads (or Executor::concurrency() many if zero.)
+  std::vector<Element> elements(Bound bound, unsigned int threads = 0) const;
+
+  // Return the Delaunay triangulated surface which the elements act on.
+  const Surface& surface() const;
+
+  template <typename S>
+  friend std::ostream& operator<<(std::ostream&, const VeechGroup<S>&);
+
+ private:
+  Movable<VeechGroup> self;
+
+  friend ImplementationOf<VeechGroup>;
+};
+
+template <typename Surface>
+VeechGroup(const Surface&) -> VeechGroup<Surface>;
+
+}  // namespace flatsurf
+
+#endif
@@ -21,17 +21,23 @@
 #define LIBFLATSURF_VERTICAL_HPP
 
 #include <boost/operators.hpp>
+#include <cstdint>
+#include <exact-real/forward.hpp>
 #include <iosfwd>
 #include <type_traits>
 #include <unordered_set>
 #include <vector>
 
 #include "copyable.hpp"
+#include "half_edge_map.hpp"
 #include "serializable.hpp"
 
 namespace flatsurf {
 
 // A vertical direction on a translation surface.
+// The const methods of a vertical can be called from several threads at once.
+// Note that verticals on the same surface in the same direction share their
+// caches.
 template <typename Surface>
 class Vertical : Serializable<Vertical<Surface>>,
                  boost::equality_comparable<Vertical<Surface>> {
@@ -56,6 +62,12 @@ class Vertical : Serializable<Vertical<Surface>>,
   // both of its adjacent triangles.
   bool large(HalfEdge) const;
 
+  // Determine what is needed to answer classifyFace() and large() for all
+  // faces and edges in one pass over the surface. Afterwards, these queries
+  // are answered from caches. Flips only invalidate the entries of the faces
+  // they touch, so calling this again only recomputes these.
+  void classifyAll() const;
+
   // Return the defining vector of this vertical direction.
   const Vector<T> &vertical() const;
 
@@ -93,9 +105,36 @@ class Vertical : Serializable<Vertical<Surface>>,
   // orthogonal to the defining vector.
   T projectPerpendicular(const Vector<T> &) const;
 
+  // Return a ball enclosing project() of this half edge. The ball is
+  // computed from the approximations of the surface so this does not need
+  // any exact arithmetic.
+  exactreal::Arb projectApproximate(HalfEdge) const;
+
+  // Return a ball enclosing projectPerpendicular() of this half edge. The
+  // ball is computed from the approximations of the surface so this does not
+  // need any exact arithmetic.
+  exactreal::Arb projectPerpendicularApproximate(HalfEdge) const;
+
+  // Return -1, 0, or 1 if project() of the first half edge is smaller than,
+  // equal to, or larger than project() of the second half edge.
+  // For coordinates whose exact arithmetic is expensive, this is decided on
+  // projectApproximate() and the exact projections are only computed when
+  // the balls overlap.
+  int compareProjections(HalfEdge, HalfEdge) const;
+
+  // Return -1, 0, or 1 if projectPerpendicular() of the first half edge is
+  // smaller than, equal to, or larger than projectPerpendicular() of the
+  // second half edge, see compareProjections().
+  int compareProjectionsPerpendicular(HalfEdge, HalfEdge) const;
+
   const Surface &surface() const;
 
-  std::vector<std::unordered_set<HalfEdge>> components() const;
+  std::vector<HalfEdgeSet> components() const;
+
+  // Return for each half edge the index of its component in components().
+  // This is much cheaper than components() when only membership in a
+  // component needs to be tested.
+  HalfEdgeMap<uint32_t> componentLabels() const;
 
   bool operator==(const Vertical &) const;
 
@@ -19,15 +19,31 @@
 
 #include "impl/approximation.hpp"
 
+#include <exact-real/element.hpp>
 #include <exact-real/integer_ring.hpp>
+#include <exact-real/module.hpp>
 #include <exact-real/number_field.hpp>
 #include <exact-real/rational_field.hpp>
+#include <exact-real/real_number.hpp>
+#include <unordered_map>
 
 #include "util/assert.ipp"
 #include "util/false.ipp"
 
 namespace flatsurf {
 
+namespace {
+
+template <typename T>
+struct CoefficientRing {};
+
+template <typename Ring>
+struct CoefficientRing<exactreal::Element<Ring>> {
+  using ElementClass = typename Ring::ElementClass;
+};
+
+}  // namespace
+
 template <typename T>
 exactreal::Arb Approximation<T>::arb(const T& x, slong prec) {
   exactreal::Arb ret;
@@ -38,6 +54,9 @@ exactreal::Arb Approximation<T>::arb(const T& x, slong prec) {
   } else if constexpr (std::is_same_v<T, long long>) {
     (void)(prec);
     ret = exactreal::Arb(x);
+  } else if constexpr (std::is_same_v<T, double>) {
+    (void)(prec);
+    arb_set_d(ret.arb_t(), x);
   } else if constexpr (std::is_same_v<T, mpq_class>) {
     ret = exactreal::Arb(x, prec);
   } else if constexpr (std::is_same_v<T, eantic::renf_elem_class>) {
@@ -57,9 +76,54 @@ exactreal::Arb Approximation<T>::arb(const T& x, slong prec) {
   return ret;
 }
 
+template <typename T>
+std::vector<exactreal::Arb> Approximation<T>::arb(const std::vector<const T*>& values, slong prec) {
+  std::vector<exactreal::Arb> ret;
+  ret.reserve(values.size());
+
+  if constexpr (std::is_same_v<T, exactreal::Element<exactreal::IntegerRing>> || std::is_same_v<T, exactreal::Element<exactreal::RationalField>> || std::is_same_v<T, exactreal::Element<exactreal::NumberField>>) {
+    using C = typename CoefficientRing<T>::ElementClass;
+
+    // The approximations of the generators of the modules that we have
+    // encountered so far.
+    std::unordered_map<const void*, std::vector<exactreal::Arb>> generators;
+
+    for (const T* value : values) {
+      const auto module = value->module();
+
+      auto approximations = generators.find(module.get());
+      if (approximations == generators.end()) {
+        std::vector<exactreal::Arb> basis;
+        for (const auto& gen : module->basis())
+          basis.push_back(gen->arb(prec));
+        approximations = generators.emplace(module.get(), std::move(basis)).first;
+      }
+
+      const std::vector<C> coefficients = value->coefficients();
+      ASSERT(coefficients.size() == approximations->second.size(), "element must have a coefficient for each generator of its module");
+
+      exactreal::Arb approximation;
+      for (size_t i = 0; i < coefficients.size(); i++) {
+        if (coefficients[i] == 0)
+          continue;
+        const auto coefficient = Approximation<C>::arb(coefficients[i], prec);
+        arb_addmul(approximation.arb_t(), coefficient.arb_t(), approximations->second[i].arb_t(), prec);
+      }
+
+      ASSERT(arb_is_finite(approximation.arb_t()), "Approximation of a finite number cannot be non-finite.");
+      ret.emplace_back(std::move(approximation));
+    }
+  } else {
+    for (const T* value : values)
+      ret.emplace_back(arb(*value, prec));
+  }
+
+  return ret;
+}
+
 }  // namespace flatsurf
 
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), Approximation, LIBFLATSURF_REAL_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), Approximation, LIBFLATSURF_GEOMETRY_TYPES)
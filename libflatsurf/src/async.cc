@@ -0,0 +1,116 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/async.hpp"
+
+#include <memory>
+#include <ostream>
+
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flow_decomposition.hpp"
+#include "../flatsurf/saddle_connections_iterator.hpp"
+#include "../flatsurf/vector.hpp"
+#include "impl/async.impl.hpp"
+#include "impl/flat_triangulation.impl.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+Async<Surface>::Async(const Surface& surface, Executor executor) :
+  self(spimpl::make_impl<ImplementationOf<Async>>(surface, std::move(executor))) {}
+
+template <typename Surface>
+std::future<FlowDecomposition<Surface>> Async<Surface>::flowDecomposition(const Vector<T>& vertical, std::function<bool(const FlowComponent<Surface>&)> target, const DecompositionBudget& budget) const {
+  return self->template run<FlowDecomposition<Surface>>([surface = self->surface, vertical, target = std::move(target), budget]() {
+    FlowDecomposition<Surface> decomposition(surface->clone(), vertical);
+    decomposition.decompose(target, budget);
+    return decomposition;
+  });
+}
+
+template <typename Surface>
+std::future<Surface> Async<Surface>::delaunay(const DecompositionBudget& budget) const {
+  return self->template run<Surface>([surface = self->surface, budget]() {
+    auto delaunay = surface->clone();
+    ImplementationOf<Surface>::delaunay(delaunay, [&]() { return budget.exhausted(); });
+    return delaunay;
+  });
+}
+
+template <typename Surface>
+std::future<std::optional<Deformation<Surface>>> Async<Surface>::isomorphism(const Surface& other, ISOMORPHISM kind, std::function<bool(const T&, const T&, const T&, const T&)> filterMatrix, std::function<bool(HalfEdge, HalfEdge)> filterHalfEdgeMap, const DecompositionBudget& budget, unsigned int threads) const {
+  return self->template run<std::optional<Deformation<Surface>>>([surface = self->surface, other = ReadOnly<Surface>(other), kind, filterMatrix = std::move(filterMatrix), filterHalfEdgeMap = std::move(filterHalfEdgeMap), budget, threads]() {
+    // Every candidate isomorphism is checked against the matrix filter, so
+    // rejecting all candidates there once the budget runs out makes the
+    // search complete quickly.
+    const auto filter = [&](const T& a, const T& b, const T& c, const T& d) {
+      return !budget.exhausted() && filterMatrix(a, b, c, d);
+    };
+    return surface->isomorphism(other, kind, filter, filterHalfEdgeMap, threads);
+  });
+}
+
+template <typename Surface>
+std::future<std::vector<SaddleConnection<Surface>>> Async<Surface>::connections(const SaddleConnections<Surface>& connections, const DecompositionBudget& budget) const {
+  return self->template run<std::vector<SaddleConnection<Surface>>>([connections, budget]() {
+    std::vector<SaddleConnection<Surface>> found;
+    for (const auto& connection : connections) {
+      if (budget.exhausted())
+        break;
+      found.push_back(connection);
+    }
+    return found;
+  });
+}
+
+template <typename Surface>
+const Surface& Async<Surface>::surface() const {
+  return self->surface;
+}
+
+template <typename Surface>
+ImplementationOf<Async<Surface>>::ImplementationOf(const Surface& surface, Executor executor) :
+  surface(surface),
+  executor(std::move(executor)) {}
+
+template <typename Surface>
+template <typename R>
+std::future<R> ImplementationOf<Async<Surface>>::run(std::function<R()> task) const {
+  if (!executor)
+    return std::async(std::launch::async, std::move(task));
+
+  // The executor takes a std::function which must be copyable, so the
+  // packaged task is shared between the copies.
+  auto packaged = std::make_shared<std::packaged_task<R()>>(std::move(task));
+  auto future = packaged->get_future();
+  executor([packaged]() { (*packaged)(); });
+  return future;
+}
+
+template <typename Surface>
+std::ostream& operator<<(std::ostream& os, const Async<Surface>& self) {
+  return os << "Async(" << self.surface() << ")";
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Async, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
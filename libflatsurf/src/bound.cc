@@ -19,6 +19,7 @@
 
 #include "../flatsurf/bound.hpp"
 
+#include <cmath>
 #include <gmpxxll/mpz_class.hpp>
 #include <ostream>
 
@@ -27,35 +28,55 @@
 namespace flatsurf {
 
 Bound::Bound() noexcept :
-  square() {}
+  square(),
+  small(0) {}
 
 Bound::Bound(int x) :
   Bound(mpz_class(x)) {}
 
 Bound::Bound(const mpz_class& x) :
-  square(x * x) {}
+  square(x * x) {
+  normalize();
+}
 
 Bound::Bound(const mpz_class& x, const mpz_class& y) :
-  square(x * x + y * y) {}
+  square(x * x + y * y) {
+  normalize();
+}
 
 const mpz_class& Bound::squared() const {
   return square;
 }
 
+std::optional<long long> Bound::machineSquared() const {
+  if (small < 0)
+    return std::nullopt;
+  return small;
+}
+
+void Bound::normalize() {
+  small = mpz_fits_slong_p(square.get_mpz_t()) ? mpz_get_si(square.get_mpz_t()) : -1;
+}
+
 Bound::operator bool() const {
   return static_cast<bool>(square);
 }
 
 bool Bound::operator==(const Bound& rhs) const {
+  if (small >= 0 && rhs.small >= 0)
+    return small == rhs.small;
   return square == rhs.square;
 }
 
 bool Bound::operator<(const Bound& rhs) const {
+  if (small >= 0 && rhs.small >= 0)
+    return small < rhs.small;
   return square < rhs.square;
 }
 
 Bound& Bound::operator*=(const mpz_class& c) {
   square *= (c * c);
+  normalize();
   return *this;
 }
 
@@ -69,8 +90,11 @@ Bound Bound::lower(const Vector<T>& v) {
     ret.square = square.get_num() / square.get_den();
   else if constexpr (std::is_same_v<T, mpz_class>)
     ret.square = square;
+  else if constexpr (std::is_floating_point_v<T>)
+    ret.square = mpz_class(std::floor(square));
   else
     ret.square = square.floor();
+  ret.normalize();
   return ret;
 }
 
@@ -86,8 +110,11 @@ Bound Bound::upper(const Vector<T>& v) {
       ret.square++;
   } else if constexpr (std::is_same_v<T, mpz_class>)
     ret.square = square;
+  else if constexpr (std::is_floating_point_v<T>)
+    ret.square = mpz_class(std::ceil(square));
   else
     ret.square = square.ceil();
+  ret.normalize();
   return ret;
 }
 
@@ -105,4 +132,4 @@ std::ostream& operator<<(std::ostream& os, const Bound& self) {
   template Bound Bound::upper<T>(const Vector<T>&); \
   }
 
-LIBFLATSURF_INSTANTIATE_MANY((LIBFLATSURF_INSTANTIATE_BOUND), LIBFLATSURF_REAL_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY((LIBFLATSURF_INSTANTIATE_BOUND), LIBFLATSURF_GEOMETRY_TYPES)
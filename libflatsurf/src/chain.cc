@@ -26,16 +26,72 @@
 #include <gmp.h>
 #include <gmpxx.h>
 
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include <gmpxxll/mpz_class.hpp>
+
 #include "../flatsurf/bound.hpp"
+#include "../flatsurf/exact_fallbacks.hpp"
 #include "../flatsurf/fmt.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
 #include "impl/chain.impl.hpp"
 #include "impl/chain_iterator.impl.hpp"
+#include "impl/exact_fallbacks.impl.hpp"
+#include "impl/flat_triangulation.impl.hpp"
 #include "util/assert.ipp"
-#include "util/hash.ipp"
 
 namespace flatsurf {
 
+namespace {
+
+// The Mersenne prime 2^61 - 1 modulo which we compute the fingerprints of
+// chains.
+constexpr uint64_t FINGERPRINT_PRIME = (uint64_t{1} << 61) - 1;
+
+uint64_t fingerprintReduce(unsigned __int128 x) {
+  uint64_t r = static_cast<uint64_t>(x & FINGERPRINT_PRIME) + static_cast<uint64_t>(x >> 61);
+  r = (r & FINGERPRINT_PRIME) + (r >> 61);
+  return r >= FINGERPRINT_PRIME ? r - FINGERPRINT_PRIME : r;
+}
+
+uint64_t fingerprintAdd(uint64_t x, uint64_t y) {
+  const uint64_t sum = x + y;
+  return sum >= FINGERPRINT_PRIME ? sum - FINGERPRINT_PRIME : sum;
+}
+
+uint64_t fingerprintSub(uint64_t x, uint64_t y) {
+  return x >= y ? x - y : x + FINGERPRINT_PRIME - y;
+}
+
+uint64_t fingerprintMul(uint64_t x, uint64_t y) {
+  return fingerprintReduce(static_cast<unsigned __int128>(x) * y);
+}
+
+uint64_t fingerprintResidue(slong c) {
+  // Negate in unsigned arithmetic so that this cannot overflow.
+  const uint64_t magnitude = c < 0 ? uint64_t{0} - static_cast<uint64_t>(c) : static_cast<uint64_t>(c);
+  const uint64_t residue = magnitude % FINGERPRINT_PRIME;
+  return c < 0 ? fingerprintSub(0, residue) : residue;
+}
+
+uint64_t fingerprintResidue(const mpz_class& c) {
+  if (c.fits_slong_p())
+    return fingerprintResidue(static_cast<slong>(c.get_si()));
+  return mpz_fdiv_ui(c.get_mpz_t(), FINGERPRINT_PRIME);
+}
+
+// Return the pseudo-random weight r_e of the edge with this index (with the
+// finalizer of splitmix64.)
+uint64_t fingerprintWeight(size_t edge) {
+  uint64_t z = static_cast<uint64_t>(edge) + 0x9e3779b97f4a7c15ull;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return (z ^ (z >> 31)) % FINGERPRINT_PRIME;
+}
+
+}  // namespace
+
 template <typename Surface>
 Chain<Surface>::Chain(const Surface& surface) :
   self(spimpl::make_impl<ImplementationOf<Chain>>(surface)) {
@@ -46,6 +102,36 @@ Chain<Surface>::Chain(const Surface& surface, HalfEdge e) :
   self(spimpl::make_impl<ImplementationOf<Chain>>(surface, e)) {
 }
 
+template <typename Surface>
+Chain<Surface>::Chain(const Surface& surface, const std::vector<mpz_class>& coefficients) :
+  self(spimpl::make_impl<ImplementationOf<Chain>>(surface, coefficients)) {
+}
+
+template <typename Surface>
+Chain<Surface>::Chain(const Chain&) = default;
+
+template <typename Surface>
+Chain<Surface>::Chain(Chain&&) = default;
+
+template <typename Surface>
+Chain<Surface>& Chain<Surface>::operator=(const Chain& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  // Copying the pimpl would allocate a fresh array of coefficients. Since
+  // these assignments happen a lot, e.g., in the search for saddle
+  // connections, we recycle our existing coefficients instead.
+  if (self.get() != nullptr && rhs.self.get() != nullptr && self->surface.same(rhs.self->surface))
+    self->assign(*rhs.self);
+  else
+    self = rhs.self;
+
+  return *this;
+}
+
+template <typename Surface>
+Chain<Surface>& Chain<Surface>::operator=(Chain&&) = default;
+
 template <typename Surface>
 const mpz_class& Chain<Surface>::operator[](const Edge& edge) const {
   auto ret = (*self)[edge.index()];
@@ -53,6 +139,11 @@ const mpz_class& Chain<Surface>::operator[](const Edge& edge) const {
   return ret ? **ret : zero;
 }
 
+template <typename Surface>
+std::optional<int64_t> Chain<Surface>::coefficient(const Edge& edge) const {
+  return self->coefficient(edge.index());
+}
+
 template <typename Surface>
 mpz_class Chain<Surface>::operator[](const HalfEdge& halfEdge) const {
   Edge edge(halfEdge);
@@ -72,23 +163,51 @@ Chain<Surface>::operator const Vector<exactreal::Arb> &() const {
 
 template <typename Surface>
 Chain<Surface>::operator bool() const {
-  return not _fmpz_vec_is_zero(self->coefficients, self->surface->size());
+  return not self->zero();
 }
 
 template <typename Surface>
-bool Chain<Surface>::operator<(const Bound rhs) const {
-  const auto approx = static_cast<const Vector<exactreal::Arb>&>(*this) < rhs;
-  if (approx)
+bool Chain<Surface>::operator<(const Bound& rhs) const {
+  if constexpr (std::is_same_v<T, long long> || std::is_same_v<T, mpz_class> || std::is_same_v<T, mpq_class> || std::is_same_v<T, double>) {
+    // Vector decides this on machine integers (or floating point numbers)
+    // for small bounds which is cheaper than going through Arb first.
+    return static_cast<const Vector<T>&>(*this) < rhs;
+  }
+
+  if (!rhs) return false;
+  static const size_t site = ImplementationOf<ExactFallbacks>::site("Chain::operator<(Bound)");
+
+  const auto approx = self->approximateVector.squaredLength() < rhs.squared();
+  ImplementationOf<Surface>::precision(*self->surface).record(static_cast<bool>(approx));
+  if (approx) {
+    ImplementationOf<ExactFallbacks>::decided(site);
     return *approx;
-  return static_cast<const Vector<T>&>(*this) < rhs;
+  }
+
+  const ImplementationOf<ExactFallbacks>::Fallback fallback(site);
+  return self->vector.squaredLength() < ::gmpxxll::mpz_class(rhs.squared());
 }
 
 template <typename Surface>
-bool Chain<Surface>::operator>(const Bound rhs) const {
-  const auto approx = static_cast<const Vector<exactreal::Arb>&>(*this) > rhs;
-  if (approx)
+bool Chain<Surface>::operator>(const Bound& rhs) const {
+  if constexpr (std::is_same_v<T, long long> || std::is_same_v<T, mpz_class> || std::is_same_v<T, mpq_class> || std::is_same_v<T, double>) {
+    // Vector decides this on machine integers (or floating point numbers)
+    // for small bounds which is cheaper than going through Arb first.
+    return static_cast<const Vector<T>&>(*this) > rhs;
+  }
+
+  if (!rhs) return static_cast<bool>(static_cast<const Vector<T>&>(*this));
+  static const size_t site = ImplementationOf<ExactFallbacks>::site("Chain::operator>(Bound)");
+
+  const auto approx = self->approximateVector.squaredLength() > rhs.squared();
+  ImplementationOf<Surface>::precision(*self->surface).record(static_cast<bool>(approx));
+  if (approx) {
+    ImplementationOf<ExactFallbacks>::decided(site);
     return *approx;
-  return static_cast<const Vector<T>&>(*this) > rhs;
+  }
+
+  const ImplementationOf<ExactFallbacks>::Fallback fallback(site);
+  return self->vector.squaredLength() > ::gmpxxll::mpz_class(rhs.squared());
 }
 
 template <typename Surface>
@@ -101,7 +220,7 @@ Chain<Surface> Chain<Surface>::operator-() const {
 template <typename Surface>
 Chain<Surface>& Chain<Surface>::operator+=(HalfEdge halfEdge) {
   Edge edge(halfEdge);
-  fmpz_add_si(self->coefficients + edge.index(), self->coefficients + edge.index(), halfEdge == edge.positive() ? 1 : -1);
+  self->add(edge.index(), halfEdge == edge.positive() ? 1 : -1);
 
   self->vector += halfEdge;
   self->approximateVector += halfEdge;
@@ -116,7 +235,7 @@ Chain<Surface>& Chain<Surface>::operator-=(HalfEdge halfEdge) {
 
 template <typename Surface>
 Chain<Surface>& Chain<Surface>::operator+=(const Chain& rhs) {
-  _fmpz_vec_add(self->coefficients, self->coefficients, rhs.self->coefficients, surface().size());
+  self->add(*rhs.self, 1);
 
   self->vector += rhs.self->vector;
   self->approximateVector += rhs.self->approximateVector;
@@ -126,7 +245,7 @@ Chain<Surface>& Chain<Surface>::operator+=(const Chain& rhs) {
 
 template <typename Surface>
 Chain<Surface>& Chain<Surface>::operator-=(const Chain& rhs) {
-  _fmpz_vec_sub(self->coefficients, self->coefficients, rhs.self->coefficients, surface().size());
+  self->add(*rhs.self, -1);
 
   self->vector -= rhs.self->vector;
   self->approximateVector -= rhs.self->approximateVector;
@@ -136,7 +255,7 @@ Chain<Surface>& Chain<Surface>::operator-=(const Chain& rhs) {
 
 template <typename Surface>
 Chain<Surface>& Chain<Surface>::operator+=(Chain&& rhs) {
-  _fmpz_vec_add(self->coefficients, self->coefficients, rhs.self->coefficients, surface().size());
+  self->add(*rhs.self, 1);
 
   self->vector += std::move(rhs.self->vector);
   self->approximateVector += std::move(rhs.self->approximateVector);
@@ -146,7 +265,7 @@ Chain<Surface>& Chain<Surface>::operator+=(Chain&& rhs) {
 
 template <typename Surface>
 Chain<Surface>& Chain<Surface>::operator-=(Chain&& rhs) {
-  _fmpz_vec_sub(self->coefficients, self->coefficients, rhs.self->coefficients, surface().size());
+  self->add(*rhs.self, -1);
 
   self->vector -= std::move(rhs.self->vector);
   self->approximateVector -= std::move(rhs.self->approximateVector);
@@ -156,6 +275,9 @@ Chain<Surface>& Chain<Surface>::operator-=(Chain&& rhs) {
 
 template <typename Surface>
 bool Chain<Surface>::operator==(const Chain& rhs) const {
+  // Equal chains have equal fingerprints.
+  if (self->fingerprint != rhs.self->fingerprint)
+    return false;
   if (surface() != rhs.surface())
     return false;
   // We cannot use _fmpz_vec_equal since our coefficients are not normalized,
@@ -167,10 +289,11 @@ bool Chain<Surface>::operator==(const Chain& rhs) const {
 
 template <typename Surface>
 Chain<Surface>& Chain<Surface>::operator*=(const mpz_class& c) {
-  fmpz_t cc;
-  fmpz_init_set_readonly(cc, c.get_mpz_t());
-  _fmpz_vec_scalar_mul_fmpz(self->coefficients, self->coefficients, surface().size(), cc);
-  fmpz_clear_readonly(cc);
+  self->mul(c);
+
+  self->vector.reset();
+  self->approximateVector.reset();
+
   return *this;
 }
 
@@ -197,37 +320,109 @@ std::ostream& operator<<(std::ostream& os, const Chain<Surface>& chain) {
 template <typename Surface>
 ImplementationOf<Chain<Surface>>::ImplementationOf(const Surface& surface) :
   surface(surface),
-  coefficients(_fmpz_vec_init(surface.size())),
   vector(this),
-  approximateVector(this) {
+  // We track the approximate vector from the start since in a lazy
+  // ChainVector, see chain_vector.cc, it is the only vector that is kept
+  // up-to-date.
+  approximateVector(this, Vector<exactreal::Arb>()) {
 }
 
 template <typename Surface>
 ImplementationOf<Chain<Surface>>::ImplementationOf(const Surface& surface, HalfEdge halfEdge) :
   surface(surface),
-  coefficients(_fmpz_vec_init(surface.size())),
   vector(this, this->surface->fromHalfEdge(halfEdge)),
   approximateVector(this, this->surface->fromHalfEdgeApproximate(halfEdge)) {
   Edge edge(halfEdge);
-  fmpz_add_si(coefficients + edge.index(), coefficients + edge.index(), halfEdge == edge.positive() ? 1 : -1);
+  add(edge.index(), halfEdge == edge.positive() ? 1 : -1);
+}
+
+template <typename Surface>
+ImplementationOf<Chain<Surface>>::ImplementationOf(const Surface& surface, const std::vector<mpz_class>& values) :
+  ImplementationOf(surface) {
+  CHECK_ARGUMENT(values.size() == surface.size(), "there must be exactly one coefficient for each edge of the surface");
+
+  // We write the coefficients directly instead of adding up the edges one by
+  // one which would need a temporary chain for each edge.
+  for (size_t i = 0; i < values.size(); i++) {
+    const auto& c = values[i];
+    if (c == 0)
+      continue;
+
+    fingerprint = fingerprintAdd(fingerprint, fingerprintMul(fingerprintResidue(c), fingerprintWeight(i)));
+
+    if (!dense() && terms < SPARSE && c.fits_slong_p() && c.get_si() >= COEFF_MIN && c.get_si() <= COEFF_MAX) {
+      // The indexes are increasing, so the terms remain sorted.
+      sparse[terms++] = Term{i, c.get_si()};
+      continue;
+    }
+
+    densify();
+    fmpz_set_mpz(coefficients + i, c.get_mpz_t());
+  }
+
+  // The vectors are computed once from the coefficients when needed.
+  approximateVector.reset();
 }
 
 template <typename Surface>
 ImplementationOf<Chain<Surface>>::ImplementationOf(const ImplementationOf& rhs) :
   surface(rhs.surface),
-  coefficients(_fmpz_vec_init(surface->size())),
+  sparse(rhs.sparse),
+  terms(rhs.terms),
+  coefficients(rhs.dense() ? ImplementationOf<Surface>::coefficients(*surface).allocate(surface->size()) : nullptr),
+  fingerprint(rhs.fingerprint),
   vector(this, rhs.vector),
   approximateVector(this, rhs.approximateVector) {
-  _fmpz_vec_set(coefficients, rhs.coefficients, surface->size());
+  if (rhs.dense()) {
+    std::lock_guard<std::recursive_mutex> guard(rhs.lock);
+    _fmpz_vec_set(coefficients, rhs.coefficients, surface->size());
+  }
+}
+
+template <typename Surface>
+void ImplementationOf<Chain<Surface>>::assign(const ImplementationOf& rhs) {
+  assert(surface.same(rhs.surface) && "can only assign chains on the same surface");
+
+  if (rhs.dense()) {
+    if (!dense())
+      coefficients = ImplementationOf<Surface>::coefficients(*surface).allocate(surface->size());
+    std::lock_guard<std::recursive_mutex> guard(rhs.lock);
+    _fmpz_vec_set(coefficients, rhs.coefficients, surface->size());
+  } else {
+    if (dense()) {
+      ImplementationOf<Surface>::coefficients(*surface).release(coefficients, surface->size());
+      coefficients = nullptr;
+    }
+    sparse = rhs.sparse;
+    terms = rhs.terms;
+  }
+  fingerprint = rhs.fingerprint;
+  vector.assign(rhs.vector);
+  approximateVector.assign(rhs.approximateVector);
 }
 
 template <typename Surface>
 ImplementationOf<Chain<Surface>>::~ImplementationOf() {
-  _fmpz_vec_clear(coefficients, surface->size());
+  if (dense())
+    ImplementationOf<Surface>::coefficients(*surface).release(coefficients, surface->size());
 }
 
 template <typename Surface>
 std::optional<const mpz_class*> ImplementationOf<Chain<Surface>>::operator[](const size_t index) const {
+  std::lock_guard<std::recursive_mutex> guard(lock);
+
+  if (!dense()) {
+    const auto term = std::lower_bound(sparse.begin(), sparse.begin() + terms, index, [](const Term& term, size_t edge) { return term.edge < edge; });
+    if (term == sparse.begin() + terms || term->edge != index) return std::nullopt;
+
+    // We only write the promoted value if it changed, so that other threads
+    // can keep reading a value we handed out earlier.
+    mpz_class& value = promoted[term - sparse.begin()];
+    if (value != term->coefficient)
+      mpz_set_si(value.get_mpz_t(), term->coefficient);
+    return &value;
+  }
+
   if (fmpz_is_zero(&coefficients[index])) return std::nullopt;
 
   __mpz_struct* promoted = _fmpz_promote_val(&coefficients[index]);
@@ -237,24 +432,193 @@ std::optional<const mpz_class*> ImplementationOf<Chain<Surface>>::operator[](con
   return reinterpret_cast<const mpz_class*>(promoted);
 }
 
+template <typename Surface>
+std::optional<int64_t> ImplementationOf<Chain<Surface>>::coefficient(const size_t index) const {
+  if (!dense()) {
+    const auto term = std::lower_bound(sparse.begin(), sparse.begin() + terms, index, [](const Term& term, size_t edge) { return term.edge < edge; });
+    if (term == sparse.begin() + terms || term->edge != index) return 0;
+    return term->coefficient;
+  }
+
+  // operator[] might be promoting this coefficient concurrently.
+  std::lock_guard<std::recursive_mutex> guard(lock);
+
+  const fmpz coefficient = coefficients[index];
+  if (!COEFF_IS_MPZ(coefficient))
+    return coefficient;
+
+  const mpz_ptr value = COEFF_TO_PTR(coefficient);
+  if (!mpz_fits_slong_p(value))
+    return std::nullopt;
+  return mpz_get_si(value);
+}
+
 template <typename Surface>
 size_t ImplementationOf<Chain<Surface>>::hash(const Chain<Surface>& self) {
-  const auto hash_fmpz = [](fmpz_t x) -> size_t {
-    if (fmpz_fits_si(x)) {
-      return fmpz_get_si(x);
-    } else {
-      __mpz_struct* y = _fmpz_promote_val(x);
-      const size_t lowest_limb = mpz_get_ui(y);
-      _fmpz_demote_val(x);
-      return lowest_limb;
+  // The fingerprint only depends on the coefficients, so sparse and dense
+  // chains hash the same.
+  return static_cast<size_t>(self.self->fingerprint);
+}
+
+template <typename Surface>
+void ImplementationOf<Chain<Surface>>::own(Chain<Surface>& chain, const ReadOnly<Surface>& surface) {
+  if (chain.self->surface.borrowed()) {
+    assert(chain.self->surface.same(surface) && "chain must be defined on this surface");
+    chain.self->surface = surface;
+  }
+}
+
+template <typename Surface>
+bool ImplementationOf<Chain<Surface>>::shorter(const Chain<Surface>& lhs, const Chain<Surface>& rhs) {
+  static const size_t site = ImplementationOf<ExactFallbacks>::site("Chain::shorter");
+
+  const auto approx = lhs.self->approximateVector.squaredLength() < rhs.self->approximateVector.squaredLength();
+  ImplementationOf<Surface>::precision(*lhs.self->surface).record(static_cast<bool>(approx));
+  if (approx) {
+    ImplementationOf<ExactFallbacks>::decided(site);
+    return *approx;
+  }
+
+  const ImplementationOf<ExactFallbacks>::Fallback fallback(site);
+  return lhs.self->vector.squaredLength() < rhs.self->vector.squaredLength();
+}
+
+template <typename Surface>
+size_t ImplementationOf<Chain<Surface>>::next(int pos) const {
+  const size_t size = surface->size();
+
+  if (dense()) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    do {
+      pos++;
+    } while (pos < size && fmpz_is_zero(&coefficients[pos]));
+    return pos;
+  }
+
+  const auto term = std::upper_bound(sparse.begin(), sparse.begin() + terms, pos, [](int edge, const Term& term) { return edge < static_cast<int>(term.edge); });
+  return term == sparse.begin() + terms ? size : term->edge;
+}
+
+template <typename Surface>
+void ImplementationOf<Chain<Surface>>::add(const size_t index, const slong c) {
+  ASSERT(c >= COEFF_MIN && c <= COEFF_MAX, "coefficient must be small");
+
+  if (c == 0)
+    return;
+
+  fingerprint = fingerprintAdd(fingerprint, fingerprintMul(fingerprintResidue(c), fingerprintWeight(index)));
+
+  if (!dense()) {
+    const auto end = sparse.begin() + terms;
+    const auto term = std::lower_bound(sparse.begin(), end, index, [](const Term& term, size_t edge) { return term.edge < edge; });
+
+    if (term != end && term->edge == index) {
+      // Since both summands are small, this cannot overflow.
+      const slong sum = term->coefficient + c;
+      if (sum == 0) {
+        std::move(term + 1, end, term);
+        terms--;
+        return;
+      }
+      if (sum >= COEFF_MIN && sum <= COEFF_MAX) {
+        term->coefficient = sum;
+        return;
+      }
+    } else if (terms < SPARSE) {
+      std::move_backward(term, end, end + 1);
+      *term = Term{index, c};
+      terms++;
+      return;
     }
-  };
 
-  size_t ret = hash_fmpz(&self.self->coefficients[0]);
-  for (size_t i = 1; i < self.surface().size(); i++)
-    ret = hash_combine(ret, hash_fmpz(&self.self->coefficients[i]));
+    densify();
+  }
+
+  // Most dense coefficients are small, so we add them without calling into
+  // FLINT; since both summands are small, this cannot overflow.
+  fmpz& coefficient = coefficients[index];
+  if (!COEFF_IS_MPZ(coefficient)) {
+    const slong sum = coefficient + c;
+    if (sum >= COEFF_MIN && sum <= COEFF_MAX) {
+      coefficient = sum;
+      return;
+    }
+  }
 
-  return ret;
+  fmpz_add_si(&coefficient, &coefficient, c);
+}
+
+template <typename Surface>
+void ImplementationOf<Chain<Surface>>::add(const ImplementationOf& rhs, int sgn) {
+  if (rhs.dense()) {
+    fingerprint = sgn > 0 ? fingerprintAdd(fingerprint, rhs.fingerprint) : fingerprintSub(fingerprint, rhs.fingerprint);
+    densify();
+    std::lock_guard<std::recursive_mutex> guard(rhs.lock);
+    if (sgn > 0)
+      _fmpz_vec_add(coefficients, coefficients, rhs.coefficients, surface->size());
+    else
+      _fmpz_vec_sub(coefficients, coefficients, rhs.coefficients, surface->size());
+    return;
+  }
+
+  // We copy the terms of rhs since rhs might be this chain itself.
+  const auto summands = rhs.sparse;
+  const size_t count = rhs.terms;
+  for (size_t i = 0; i < count; i++)
+    add(summands[i].edge, sgn > 0 ? summands[i].coefficient : -summands[i].coefficient);
+}
+
+template <typename Surface>
+void ImplementationOf<Chain<Surface>>::mul(const mpz_class& c) {
+  fingerprint = fingerprintMul(fingerprint, fingerprintResidue(c));
+
+  if (!dense()) {
+    if (c == 0) {
+      terms = 0;
+      return;
+    }
+
+    if (c.fits_slong_p()) {
+      const slong cc = c.get_si();
+      auto product = sparse;
+      bool small = true;
+      for (size_t i = 0; i < terms && small; i++)
+        small = !__builtin_mul_overflow(sparse[i].coefficient, cc, &product[i].coefficient) && product[i].coefficient >= COEFF_MIN && product[i].coefficient <= COEFF_MAX;
+
+      if (small) {
+        sparse = product;
+        return;
+      }
+    }
+
+    densify();
+  }
+
+  fmpz_t cc;
+  fmpz_init_set_readonly(cc, c.get_mpz_t());
+  _fmpz_vec_scalar_mul_fmpz(coefficients, coefficients, surface->size(), cc);
+  fmpz_clear_readonly(cc);
+}
+
+template <typename Surface>
+bool ImplementationOf<Chain<Surface>>::zero() const {
+  // Sparse coefficients are never zero.
+  if (!dense())
+    return terms == 0;
+
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  return _fmpz_vec_is_zero(coefficients, surface->size());
+}
+
+template <typename Surface>
+void ImplementationOf<Chain<Surface>>::densify() {
+  if (dense())
+    return;
+
+  coefficients = ImplementationOf<Surface>::coefficients(*surface).allocate(surface->size());
+  for (size_t i = 0; i < terms; i++)
+    fmpz_set_si(coefficients + sparse[i].edge, sparse[i].coefficient);
+  terms = 0;
 }
 
 template <typename Surface>
@@ -283,4 +647,4 @@ size_t hash<Chain<Surface>>::operator()(const Chain<Surface>& self) const {
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), Chain, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), Chain, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -32,7 +32,8 @@ namespace flatsurf {
 template <typename Surface>
 void ChainIterator<Surface>::increment() {
   const size_t pos = self->current.first.index();
-  _fmpz_demote_val(&self->parent->self->coefficients[pos]);
+  if (self->parent->self->dense())
+    _fmpz_demote_val(&self->parent->self->coefficients[pos]);
   self->current = ImplementationOf<ChainIterator>::make(self->parent, ImplementationOf<ChainIterator>::findNext(self->parent, static_cast<int>(pos)));
 }
 
@@ -42,6 +43,12 @@ const typename ChainIterator<Surface>::value_type& ChainIterator<Surface>::deref
   return self->current;
 }
 
+template <typename Surface>
+std::optional<int64_t> ChainIterator<Surface>::coefficient() const {
+  ASSERT(self->current.second != nullptr, "Cannot dereference iterator that is already at the end of Chain.");
+  return self->parent->self->coefficient(self->current.first.index());
+}
+
 template <typename Surface>
 bool ChainIterator<Surface>::equal(const ChainIterator& rhs) const {
   return self->parent == rhs.self->parent && self->current.first == rhs.self->current.first;
@@ -75,13 +82,7 @@ ChainIterator<Surface> ImplementationOf<ChainIterator<Surface>>::end(const Chain
 
 template <typename Surface>
 size_t ImplementationOf<ChainIterator<Surface>>::findNext(const Chain<Surface>* parent, int pos) {
-  const size_t size = parent->surface().size();
-
-  do {
-    pos++;
-  } while (pos < size && fmpz_is_zero(&parent->self->coefficients[pos]));
-
-  return pos;
+  return parent->self->next(pos);
 }
 
 template <typename Surface>
@@ -98,4 +99,4 @@ std::pair<Edge, const mpz_class*> ImplementationOf<ChainIterator<Surface>>::make
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), ChainIterator, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), ChainIterator, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -19,68 +19,183 @@
 
 #include "impl/chain_vector.hpp"
 
+#include <e-antic/renfxx.h>
+
+#include <cstdlib>
+#include <exact-real/arb.hpp>
+#include <exact-real/element.hpp>
+#include <exact-real/integer_ring.hpp>
+#include <exact-real/number_field.hpp>
+#include <exact-real/rational_field.hpp>
+#include <fstream>
+#include <mutex>
 #include <optional>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <variant>
 
+#include "impl/approximation.hpp"
 #include "impl/chain.impl.hpp"
+#include "impl/flat_triangulation.impl.hpp"
 #include "util/assert.ipp"
+#include "util/false.ipp"
 
 namespace flatsurf {
 
 namespace {
 
-// These are just rough estimates. If Chain shows up a lot in the profiler, we
-// might want to benchmark these to get better values here. (Or rather
-// autotune them.)
+// Return an approximation of vector to the current working precision of
+// the approximations on surface, see PrecisionPolicy.
+template <typename Surface>
+Vector<exactreal::Arb> approximate(const Surface& surface, const Vector<typename Surface::Coordinate>& vector) {
+  using Coordinate = typename Surface::Coordinate;
+  const slong prec = ImplementationOf<Surface>::precision(surface).precision();
+  return Vector<exactreal::Arb>(Approximation<Coordinate>::arb(vector.x(), prec), Approximation<Coordinate>::arb(vector.y(), prec));
+}
+
+// The relative cost of the operations on a Vector<T> that ChainVector can
+// choose from.
+struct Costs {
+  double add;
+  double copy;
+  double convert;
+  double move;
+  double addmul;
+  // Whether the exact vector should not be tracked at all but only be
+  // recomputed from the coefficients of the chain when it is needed, i.e.,
+  // when the approximate vector cannot decide a predicate. For coordinates
+  // with very expensive arithmetic, this turns most exact additions in the
+  // search for saddle connections into nothing.
+  bool lazy;
+};
+
+// Return the name of T as it appears in a cost profile, i.e., the C++ type
+// name without spaces.
+template <typename T>
+const char* profileName() {
+  if constexpr (std::is_same_v<T, long long>)
+    return "longlong";
+  else if constexpr (std::is_same_v<T, double>)
+    return "double";
+  else if constexpr (std::is_same_v<T, mpz_class>)
+    return "mpz_class";
+  else if constexpr (std::is_same_v<T, mpq_class>)
+    return "mpq_class";
+  else if constexpr (std::is_same_v<T, eantic::renf_elem_class>)
+    return "eantic::renf_elem_class";
+  else if constexpr (std::is_same_v<T, exactreal::Element<exactreal::IntegerRing>>)
+    return "exactreal::Element<exactreal::IntegerRing>";
+  else if constexpr (std::is_same_v<T, exactreal::Element<exactreal::RationalField>>)
+    return "exactreal::Element<exactreal::RationalField>";
+  else if constexpr (std::is_same_v<T, exactreal::Element<exactreal::NumberField>>)
+    return "exactreal::Element<exactreal::NumberField>";
+  else if constexpr (std::is_same_v<T, exactreal::Arb>)
+    return "exactreal::Arb";
+  else
+    static_assert(false_type_v<T>, "no profile name for this coordinate type");
+}
+
+// Return the costs for the type called name from the profile that the
+// environment variable LIBFLATSURF_CHAIN_VECTOR_COSTS points to (if any.)
+// Each line of the profile is of the form
+//   name add copy convert move addmul [lazy]
+// where the costs are relative to a Vector<long long> addition and lazy is 0
+// or 1, see Costs::lazy. Such a
+// profile can be created with the ChainVectorCost benchmarks and
+// benchmark/chain_vector_cost.py.
+std::optional<Costs> loadProfile(const std::string& name, bool defaultLazy) {
+  const char* path = std::getenv("LIBFLATSURF_CHAIN_VECTOR_COSTS");
+  if (path == nullptr)
+    return std::nullopt;
+
+  std::ifstream profile(path);
+  CHECK_ARGUMENT(profile, "cannot read cost profile " << path);
+
+  std::string line;
+  while (std::getline(profile, line)) {
+    std::istringstream words(line);
+    std::string type;
+    if (!(words >> type) || type[0] == '#' || type != name)
+      continue;
+
+    Costs costs;
+    CHECK_ARGUMENT(words >> costs.add >> costs.copy >> costs.convert >> costs.move >> costs.addmul, "malformed line in cost profile " << path << ": " << line);
+    if (!(words >> costs.lazy))
+      costs.lazy = defaultLazy;
+    return costs;
+  }
+
+  return std::nullopt;
+}
+
+// The default costs are just rough estimates. If Chain shows up a lot in the
+// profiler, run the ChainVectorCost benchmarks to measure them on the actual
+// host instead; see loadProfile().
 template <typename T>
 struct Cost {
   // The cost of a Vector<T> addition.
-  static constexpr double add() {
-    if (std::is_same_v<T, long long>)
-      return 1;
-    else if (std::is_same_v<T, exactreal::Arb>)
-      return 2;
-    else
-      return 16;
-  }
+  static double add() { return costs().add; }
 
   // The cost of a Vector<T> copy.
-  static constexpr double copy() {
-    if (std::is_same_v<T, long long>) {
-      return 1;
-    } else if (std::is_same_v<T, mpz_class> || std::is_same_v<T, exactreal::Arb>) {
-      return 2;
-    } else if (std::is_same_v<T, mpq_class> || std::is_same_v<T, eantic::renf_elem_class>) {
-      return 4;
-    } else {
-      return 8;
-    }
-  }
+  static double copy() { return costs().copy; }
 
   // The cost of converting a Vector<T> to a Vector<Arb>.
-  static constexpr double convert() {
-    if (std::is_same_v<T, exactreal::Arb> || std::is_same_v<T, long long>) {
-      return 1;
-    } else if (std::is_same_v<T, mpz_class>) {
-      return 2;
-    } else {
-      return 16;
-    }
-  }
+  static double convert() { return costs().convert; }
 
   // The cost of a Vector<T> move.
-  static constexpr double move() {
-    return 1;
-  }
+  static double move() { return costs().move; }
 
   // The cost of a c * Vector<T> addition.
-  static constexpr double addmul() {
-    return 2 * add();
-  }
+  static double addmul() { return costs().addmul; }
+
+  // Whether to only recompute the exact vector when needed, see Costs::lazy.
+  static bool lazy() { return !std::is_same_v<T, exactreal::Arb> && costs().lazy; }
 
   // The cost of recomputing a vector from the mpz coefficients from scratch.
-  static constexpr double recompute(size_t edges) {
+  static double recompute(size_t edges) {
     return static_cast<double>(edges) * addmul();
   }
+
+ private:
+  static const Costs& costs() {
+    static const Costs costs = loadProfile(profileName<T>(), defaults().lazy).value_or(defaults());
+    return costs;
+  }
+
+  static constexpr Costs defaults() {
+    Costs costs{};
+
+    if (std::is_same_v<T, long long> || std::is_same_v<T, double>)
+      costs.add = 1;
+    else if (std::is_same_v<T, exactreal::Arb>)
+      costs.add = 2;
+    else
+      costs.add = 16;
+
+    if (std::is_same_v<T, long long> || std::is_same_v<T, double>)
+      costs.copy = 1;
+    else if (std::is_same_v<T, mpz_class> || std::is_same_v<T, exactreal::Arb>)
+      costs.copy = 2;
+    else if (std::is_same_v<T, mpq_class> || std::is_same_v<T, eantic::renf_elem_class>)
+      costs.copy = 4;
+    else
+      costs.copy = 8;
+
+    if (std::is_same_v<T, exactreal::Arb> || std::is_same_v<T, long long> || std::is_same_v<T, double>)
+      costs.convert = 1;
+    else if (std::is_same_v<T, mpz_class>)
+      costs.convert = 2;
+    else
+      costs.convert = 16;
+
+    costs.move = 1;
+    costs.addmul = 2 * costs.add;
+
+    costs.lazy = std::is_same_v<T, exactreal::Element<exactreal::IntegerRing>> || std::is_same_v<T, exactreal::Element<exactreal::RationalField>> || std::is_same_v<T, exactreal::Element<exactreal::NumberField>>;
+
+    return costs;
+  }
 };
 
 }  // namespace
@@ -94,47 +209,75 @@ template <typename Surface, typename T>
 ChainVector<Surface, T>::ChainVector(const ImplementationOf<Chain<Surface>>* chain, Vector<T> value) :
   chain(*chain),
   value(std::move(value)) {
+  settle();
 }
 
 template <typename Surface, typename T>
 ChainVector<Surface, T>::ChainVector(const ImplementationOf<Chain<Surface>>* chain, const ChainVector& value) :
-  ChainVector(chain, static_cast<const Vector<T>&>(value)) {}
+  chain(*chain) {
+  assign(value);
+}
+
+template <typename Surface, typename T>
+void ChainVector<Surface, T>::assign(const ChainVector& rhs) {
+  std::lock_guard<std::recursive_mutex> guard(rhs.chain.lock);
+
+  if (rhs.value) {
+    *this = static_cast<const Vector<T>&>(rhs);
+    lengthSquared = rhs.lengthSquared;
+    lengthSettled.store(lengthSquared.has_value(), std::memory_order_release);
+  } else {
+    // We do not force rhs to compute its value since it might never be
+    // needed.
+    reset();
+  }
+}
 
 template <typename Surface, typename T>
 ChainVector<Surface, T>& ChainVector<Surface, T>::operator=(const Vector<T>& value) noexcept {
   this->value = value;
+  lengthSquared = std::nullopt;
+  lengthSettled.store(false, std::memory_order_release);
   pendingMoves.clear();
   pendingMovesCost = 0;
+  settle();
   return *this;
 }
 
 template <typename Surface, typename T>
 ChainVector<Surface, T>& ChainVector<Surface, T>::operator=(Vector<T>&& value) noexcept {
   this->value = std::move(value);
+  lengthSquared = std::nullopt;
+  lengthSettled.store(false, std::memory_order_release);
   pendingMoves.clear();
   pendingMovesCost = 0;
+  settle();
   return *this;
 }
 
 template <typename Surface, typename T>
 ChainVector<Surface, T>& ChainVector<Surface, T>::operator+=(HalfEdge halfEdge) {
-  (void)halfEdge;
+  lengthSquared = std::nullopt;
+  lengthSettled.store(false, std::memory_order_release);
+  if (Cost<T>::lazy()) {
+    reset();
+    return *this;
+  }
   if (value) {
-    const double storeAsPendingCost = pendingMovesCost + Cost<T>::copy() + Cost<T>::add();
+    // The half edge is only resolved to its vector when the value is
+    // computed, so recording it does not copy a vector.
+    const double storeAsPendingCost = pendingMovesCost + Cost<T>::add();
     if (storeAsPendingCost > recomputeCost()) {
       value = std::nullopt;
       pendingMovesCost = 0;
       pendingMoves.clear();
     } else {
-      if constexpr (std::is_same_v<T, exactreal::Arb>) {
-        pendingMoves.emplace_back(MOVE::ADD, chain.surface->fromHalfEdgeApproximate(halfEdge));
-      } else {
-        pendingMoves.emplace_back(MOVE::ADD, chain.surface->fromHalfEdge(halfEdge));
-      }
+      pendingMoves.push_back({MOVE::ADD, halfEdge});
       pendingMovesCost += Cost<T>::add();
     }
   }
 
+  settle();
   return *this;
 }
 
@@ -166,6 +309,15 @@ ChainVector<Surface, T>& ChainVector<Surface, T>::operator-=(ChainVector<Surface
 template <typename Surface, typename T>
 template <typename V>
 ChainVector<Surface, T>& ChainVector<Surface, T>::record(MOVE move, V&& rhs) {
+  lengthSquared = std::nullopt;
+  lengthSettled.store(false, std::memory_order_release);
+  if (Cost<T>::lazy()) {
+    reset();
+    return *this;
+  }
+  // Other threads might be computing the vector of rhs concurrently.
+  std::lock_guard<std::recursive_mutex> guard(rhs.chain.lock);
+
   if (value) {
     if (rhs.value) {
       // Both operands have a valid Vector<T>. We now have to decide whether
@@ -183,9 +335,9 @@ ChainVector<Surface, T>& ChainVector<Surface, T>::record(MOVE move, V&& rhs) {
           (void)static_cast<const Vector<T>&>(rhs);
 
           if constexpr (std::is_rvalue_reference_v<V>) {
-            pendingMoves.emplace_back(move, std::move(*rhs.value));
+            pendingMoves.push_back({move, std::move(*rhs.value)});
           } else {
-            pendingMoves.emplace_back(move, *rhs.value);
+            pendingMoves.push_back({move, *rhs.value});
           }
           pendingMovesCost += Cost<T>::add();
         }
@@ -197,6 +349,7 @@ ChainVector<Surface, T>& ChainVector<Surface, T>::record(MOVE move, V&& rhs) {
     }
   }
 
+  settle();
   return *this;
 }
 
@@ -210,14 +363,20 @@ double ChainVector<Surface, T>::recomputeCost() {
 
 template <typename Surface, typename T>
 ChainVector<Surface, T>::operator const Vector<T> &() const {
+  if (settled.load(std::memory_order_acquire))
+    return *value;
+
+  std::lock_guard<std::recursive_mutex> guard(chain.lock);
+
   if (value) {
-    for (const auto& [move, v] : pendingMoves) {
+    for (auto& [move, summand] : pendingMoves) {
+      const Vector<T>& v = std::holds_alternative<HalfEdge>(summand) ? resolve(std::get<HalfEdge>(summand)) : std::get<Vector<T>>(summand);
       switch (move) {
         case MOVE::ADD:
-          *value += std::move(v);
+          *value += v;
           break;
         case MOVE::SUB:
-          *value -= std::move(v);
+          *value -= v;
           break;
         default:
           throw std::logic_error("unsupported MOVE type");
@@ -234,27 +393,74 @@ ChainVector<Surface, T>::operator const Vector<T> &() const {
     if constexpr (std::is_same_v<T, exactreal::Arb>) {
       const Vector<Coordinate>& exact = static_cast<const Vector<Coordinate>&>(chain);
       if (!value)
-        value.emplace(exact);
+        value.emplace(approximate(*chain.surface, exact));
     } else {
       static_assert(std::is_same_v<T, Coordinate>);
 
       Vector<T> exact;
 
-      for (const Edge edge : chain.surface->edges()) {
-        const auto coefficient = chain[edge.index()];
-        if (coefficient)
-          exact += **coefficient * static_cast<const Vector<T>&>(chain.surface->fromHalfEdge(edge.positive()));
+      const int size = static_cast<int>(chain.surface->size());
+      for (int index = static_cast<int>(chain.next(-1)); index < size; index = static_cast<int>(chain.next(index))) {
+        const auto coefficient = chain[index];
+        ASSERT(coefficient, "next() must only report edges with non-zero coefficients");
+        exact += **coefficient * static_cast<const Vector<T>&>(chain.surface->fromHalfEdge(Edge::fromIndex(index).positive()));
       }
 
       value.emplace(std::move(exact));
 
-      chain.approximateVector = static_cast<Vector<exactreal::Arb>>(*value);
+      // Other threads might be reading the approximate vector if it is
+      // settled already; it then approximates this vector already anyway.
+      if (!chain.approximateVector.settled.load(std::memory_order_acquire))
+        chain.approximateVector = approximate(*chain.surface, *value);
     }
   }
 
+  settle();
   return *value;
 }
 
+template <typename Surface, typename T>
+const Vector<T>& ChainVector<Surface, T>::resolve(HalfEdge halfEdge) const {
+  if constexpr (std::is_same_v<T, exactreal::Arb>)
+    return chain.surface->fromHalfEdgeApproximate(halfEdge);
+  else
+    return chain.surface->fromHalfEdge(halfEdge);
+}
+
+template <typename Surface, typename T>
+const T& ChainVector<Surface, T>::squaredLength() const {
+  if (lengthSettled.load(std::memory_order_acquire))
+    return *lengthSquared;
+
+  std::lock_guard<std::recursive_mutex> guard(chain.lock);
+
+  if (!lengthSquared) {
+    const Vector<T>& vector = *this;
+    if constexpr (std::is_same_v<T, exactreal::Arb>)
+      lengthSquared = exactreal::Arb((vector.x() * vector.x() + vector.y() * vector.y())(ImplementationOf<Surface>::precision(*chain.surface).precision()));
+    else
+      lengthSquared = T(vector.x() * vector.x() + vector.y() * vector.y());
+  }
+
+  lengthSettled.store(true, std::memory_order_release);
+  return *lengthSquared;
+}
+
+template <typename Surface, typename T>
+void ChainVector<Surface, T>::reset() const {
+  value = std::nullopt;
+  lengthSquared = std::nullopt;
+  pendingMoves.clear();
+  pendingMovesCost = 0;
+  settled.store(false, std::memory_order_release);
+  lengthSettled.store(false, std::memory_order_release);
+}
+
+template <typename Surface, typename T>
+void ChainVector<Surface, T>::settle() const {
+  settled.store(value && pendingMoves.empty(), std::memory_order_release);
+}
+
 template <typename Surface, typename T>
 std::ostream& operator<<(std::ostream& os, const ChainVector<Surface, T>& self) {
   return os << static_cast<const Vector<T>&>(self);
@@ -270,4 +476,4 @@ std::ostream& operator<<(std::ostream& os, const ChainVector<Surface, T>& self)
   LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION((ChainVector<SURFACE, typename SURFACE::Coordinate>)) \
   LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION((ChainVector<SURFACE, exactreal::Arb>))
 
-LIBFLATSURF_INSTANTIATE_MANY((LIBFLATSURF_INSTANTIATE_THIS), LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY((LIBFLATSURF_INSTANTIATE_THIS), LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
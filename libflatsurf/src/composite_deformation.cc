@@ -0,0 +1,54 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "impl/composite_deformation.hpp"
+
+#include "../flatsurf/half_edge.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+CompositeDeformation<Surface>::CompositeDeformation(Implementation&& lhs, Implementation&& rhs) :
+  ImplementationOf<Deformation<Surface>>(std::move(lhs->surface)),
+  lhs(std::move(lhs)),
+  rhs(std::move(rhs)) {
+  // Release the intermediate surface. (Unless something else holds on to
+  // it.)
+  Surface intermediate = std::move(this->rhs->surface);
+}
+
+template <typename Surface>
+std::optional<HalfEdge> CompositeDeformation<Surface>::operator()(HalfEdge he) const {
+  const auto image = (*rhs)(he);
+  if (!image || *image == HalfEdge())
+    return image;
+  return (*lhs)(*image);
+}
+
+template <typename Surface>
+Deformation<Surface> CompositeDeformation<Surface>::make(Implementation&& lhs, Implementation&& rhs) {
+  return ImplementationOf<Deformation<Surface>>::make(Implementation(new CompositeDeformation<Surface>(std::move(lhs), std::move(rhs)), spimpl::details::default_delete<ImplementationOf<Deformation<Surface>>>));
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), CompositeDeformation, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -22,11 +22,11 @@
 #include <fmt/format.h>
 
 #include <ostream>
-#include <unordered_set>
 
 #include "../flatsurf/ccw.hpp"
 #include "../flatsurf/fmt.hpp"
 #include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/half_edge_set_iterator.hpp"
 #include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/vertical.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
@@ -37,11 +37,11 @@
 namespace flatsurf {
 
 template <typename Surface>
-ContourComponentState<Surface>::ContourComponentState(const ContourDecompositionState<Surface>& state, const std::unordered_set<HalfEdge>& halfEdges) :
+ContourComponentState<Surface>::ContourComponentState(const ContourDecompositionState<Surface>& state, const HalfEdgeSet& halfEdges) :
   halfEdges(halfEdges),
   large([&]() {
     auto vertical = state.surface.vertical();
-    HalfEdge large = *std::find_if(begin(halfEdges), end(halfEdges), [&](HalfEdge e) {
+    HalfEdge large = *std::find_if(halfEdges.begin(), halfEdges.end(), [&](HalfEdge e) {
       return vertical.large(e);
     });
 
@@ -20,11 +20,13 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <memory>
 #include <ostream>
 #include <vector>
 
 #include "../flatsurf/ccw.hpp"
 #include "../flatsurf/contour_component.hpp"
+#include "../flatsurf/flat_triangulation_collapsed.hpp"
 #include "../flatsurf/fmt.hpp"
 #include "../flatsurf/half_edge.hpp"
 #include "../flatsurf/orientation.hpp"
@@ -45,7 +47,7 @@ using std::vector;
 template <typename Surface>
 ContourDecomposition<Surface>::ContourDecomposition(Surface surface, const Vector<T>& vertical) :
   self(spimpl::make_unique_impl<ImplementationOf<ContourDecomposition>>(std::move(surface), vertical)) {
-  ASSERTIONS([&]() {
+  VALIDATE([&]() {
     ImplementationOf<ContourDecomposition>::check(components() | rx::transform([&](const auto& component) { return component.perimeter(); }) | rx::to_vector(), Vertical(self->state->surface.uncollapsed(), vertical));
   });
 }
@@ -63,10 +65,26 @@ const FlatTriangulationCollapsed<typename Surface::Coordinate>& ContourDecomposi
   return self->state->surface;
 }
 
+template <typename Surface>
+ContourDecomposition<Surface> ContourDecomposition<Surface>::rotate(const Vector<T>& vertical) const {
+  const auto current = self->state->surface.vertical().vertical();
+
+  // The collapsed surface and its components only depend on the direction
+  // of the vertical.
+  if (current.ccw(vertical) == CCW::COLLINEAR && current.orientation(vertical) == ORIENTATION::SAME)
+    return ContourDecomposition(PrivateConstructor{}, self->state);
+
+  return ContourDecomposition(PrivateConstructor{}, std::make_shared<ContourDecompositionState<Surface>>(ContourDecompositionState<Surface>::collapse(self->state->surface.uncollapsed(), vertical)));
+}
+
 template <typename Surface>
 ImplementationOf<ContourDecomposition<Surface>>::ImplementationOf(Surface surface, const Vector<T>& vertical) :
   state(new DecompositionState(std::move(surface), vertical)) {}
 
+template <typename Surface>
+ImplementationOf<ContourDecomposition<Surface>>::ImplementationOf(std::shared_ptr<DecompositionState> state) :
+  state(std::move(state)) {}
+
 template <typename Surface>
 void ImplementationOf<ContourDecomposition<Surface>>::check(const std::vector<Path<FlatTriangulation<T>>>& decomposition, const Vertical<FlatTriangulation<T>>& vertical) {
   const auto& surface = vertical.surface();
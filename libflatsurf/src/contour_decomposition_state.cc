@@ -19,6 +19,7 @@
 
 #include "impl/contour_decomposition_state.hpp"
 
+#include <deque>
 #include <ostream>
 
 #include "../flatsurf/half_edge.hpp"
@@ -31,18 +32,21 @@ namespace flatsurf {
 
 template <typename Surface>
 ContourDecompositionState<Surface>::ContourDecompositionState(Surface surface, const Vector<T>& vert) :
-  surface([&]() {
+  ContourDecompositionState([&]() {
     if constexpr (std::is_same_v<Surface, FlatTriangulationCollapsed<T>>) {
       CHECK_ARGUMENT(surface->vertical().vertical() == vert, "can only decompose with respect to the existing vertical " << surface->vertical().vertical() << " of this surface");
       return surface;
     } else {
-      auto collapsed = FlatTriangulationCollapsed<T>(surface, vert);
-      IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>::makeUniqueLargeEdges(collapsed, vert);
-      return collapsed;
+      return collapse(surface, vert);
     }
-  }()),
+  }()) {
+}
+
+template <typename Surface>
+ContourDecompositionState<Surface>::ContourDecompositionState(FlatTriangulationCollapsed<T>&& surface) :
+  surface(std::move(surface)),
   components([&]() {
-    std::list<ComponentState> components;
+    std::deque<ComponentState> components;
     for (auto& component : this->surface.vertical().components()) {
       components.push_back(ComponentState(*this, component));
     }
@@ -50,6 +54,13 @@ ContourDecompositionState<Surface>::ContourDecompositionState(Surface surface, c
   }()) {
 }
 
+template <typename Surface>
+FlatTriangulationCollapsed<typename Surface::Coordinate> ContourDecompositionState<Surface>::collapse(const FlatTriangulation<T>& surface, const Vector<T>& vertical) {
+  auto collapsed = FlatTriangulationCollapsed<T>(surface, vertical);
+  IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>::makeUniqueLargeEdges(collapsed, vertical);
+  return collapsed;
+}
+
 template <typename Surface>
 ContourComponent<Surface> ContourDecompositionState<Surface>::make(ComponentState* component) {
   return ImplementationOf<ContourComponent<Surface>>::make(this->shared_from_this(), component);
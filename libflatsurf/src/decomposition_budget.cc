@@ -0,0 +1,116 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/decomposition_budget.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+#include "impl/decomposition_budget.impl.hpp"
+
+namespace flatsurf {
+
+DecompositionBudget::DecompositionBudget(std::optional<size_t> steps, std::optional<Clock::duration> timeout, int limit) :
+  self(std::make_shared<ImplementationOf<DecompositionBudget>>(steps, timeout, limit, 1024)) {}
+
+std::optional<size_t> DecompositionBudget::steps() const {
+  return self->steps;
+}
+
+size_t DecompositionBudget::consumed() const {
+  return self->consumed;
+}
+
+DecompositionBudget::Clock::duration DecompositionBudget::elapsed() const {
+  return Clock::now() - self->start;
+}
+
+int DecompositionBudget::limit() const {
+  return self->limit;
+}
+
+void DecompositionBudget::cancel() const {
+  self->cancelled = true;
+}
+
+bool DecompositionBudget::cancelled() const {
+  return self->cancelled;
+}
+
+void DecompositionBudget::trace(std::function<void(const Step&)> callback) const {
+  self->tracer = std::move(callback);
+}
+
+bool DecompositionBudget::exhausted() const {
+  if (self->cancelled)
+    return true;
+  if (self->steps && self->consumed >= *self->steps)
+    return true;
+  if (self->deadline && Clock::now() >= *self->deadline)
+    return true;
+  return false;
+}
+
+ImplementationOf<DecompositionBudget>::ImplementationOf(std::optional<size_t> steps, std::optional<Clock::duration> timeout, int limit, int interval) :
+  steps(steps),
+  start(Clock::now()),
+  deadline(timeout ? std::optional{start + *timeout} : std::nullopt),
+  limit(limit < 0 ? -1 : limit),
+  interval(interval) {}
+
+DecompositionBudget ImplementationOf<DecompositionBudget>::make(int limit) {
+  DecompositionBudget budget;
+  budget.self = std::make_shared<ImplementationOf>(std::nullopt, std::nullopt, limit, -1);
+  return budget;
+}
+
+int ImplementationOf<DecompositionBudget>::chunk(const DecompositionBudget& budget, int remaining) {
+  const int interval = budget.self->interval;
+  if (interval == -1)
+    return remaining;
+  if (remaining == -1)
+    return interval;
+  return std::min(remaining, interval);
+}
+
+void ImplementationOf<DecompositionBudget>::consume(const DecompositionBudget& budget) {
+  budget.self->consumed++;
+}
+
+bool ImplementationOf<DecompositionBudget>::tracing(const DecompositionBudget& budget) {
+  return static_cast<bool>(budget.self->tracer);
+}
+
+void ImplementationOf<DecompositionBudget>::trace(const DecompositionBudget& budget, const DecompositionBudget::Step& step) {
+  budget.self->tracer(step);
+}
+
+std::ostream& operator<<(std::ostream& os, const DecompositionBudget& self) {
+  os << "DecompositionBudget(" << self.consumed();
+  if (self.steps())
+    os << "/" << *self.steps();
+  os << " steps";
+  if (self.limit() != -1)
+    os << " of at most " << self.limit() << " induction steps";
+  if (self.cancelled())
+    os << ", cancelled";
+  return os << ")";
+}
+
+}  // namespace flatsurf
@@ -18,6 +18,7 @@
  *********************************************************************/
 
 #include "../flatsurf/half_edge.hpp"
+#include "impl/composite_deformation.hpp"
 #include "impl/deformation.impl.hpp"
 
 namespace flatsurf {
@@ -41,6 +42,11 @@ std::optional<HalfEdge> Deformation<Surface>::operator()(HalfEdge he) const {
   return (*self)(he);
 }
 
+template <typename Surface>
+Deformation<Surface> Deformation<Surface>::operator*(Deformation&& rhs) && {
+  return CompositeDeformation<Surface>::make(std::move(self), std::move(rhs.self));
+}
+
 template <typename Surface>
 ImplementationOf<Deformation<Surface>>::ImplementationOf(Surface&& surface) :
   surface(std::move(surface)) {}
@@ -75,4 +81,4 @@ std::ostream& operator<<(std::ostream& os, const ImplementationOf<Deformation<Su
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Deformation, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Deformation, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -0,0 +1,139 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "impl/double_approximation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <exact-real/arb.hpp>
+#include <limits>
+#include <ostream>
+
+#include "../flatsurf/vector.hpp"
+
+namespace flatsurf {
+
+namespace {
+
+// The unit roundoff of IEEE doubles with rounding to nearest.
+constexpr double EPS = std::numeric_limits<double>::epsilon() / 2;
+
+// Inflates an error bound that has been computed with a handful of roundings
+// to nearest so that it is again an upper bound for the actual error.
+constexpr double SAFETY = 1 + 8 * EPS;
+
+// Return a double close to the midpoint of x and store an upper bound for the
+// distance of this double to any point in x in error.
+double approximate(const exactreal::Arb& x, double& error) {
+  const double mid = arf_get_d(arb_midref(x.arb_t()), ARF_RND_NEAR);
+  const double rad = mag_get_d(arb_radref(x.arb_t()));
+
+  // If the midpoint is not representable as a double, we set the error to
+  // infinity so that no predicate ever relies on this approximation.
+  if (!std::isfinite(mid) || !std::isfinite(rad))
+    error = std::numeric_limits<double>::infinity();
+  else
+    error = std::max(error, (rad + EPS * std::abs(mid)) * SAFETY);
+
+  return mid;
+}
+
+}  // namespace
+
+DoubleApproximation::DoubleApproximation() noexcept :
+  x(0),
+  y(0),
+  error(0) {}
+
+DoubleApproximation::DoubleApproximation(const Vector<exactreal::Arb>& vector) :
+  error(0) {
+  x = approximate(vector.x(), error);
+  y = approximate(vector.y(), error);
+}
+
+std::optional<CCW> DoubleApproximation::ccw(const DoubleApproximation& rhs) const {
+  const double a = x * rhs.y;
+  const double b = rhs.x * y;
+  const double det = a - b;
+
+  // The error coming from the uncertainty of the coordinates.
+  const double propagated = (std::abs(x) + std::abs(rhs.y) + std::abs(rhs.x) + std::abs(y)) * std::max(error, rhs.error) + 2 * error * rhs.error;
+  // The error coming from the roundings in the computation of det.
+  const double rounding = 3 * EPS * (std::abs(a) + std::abs(b));
+
+  const double bound = (propagated + rounding) * SAFETY;
+
+  if (det > bound)
+    return CCW::COUNTERCLOCKWISE;
+  if (det < -bound)
+    return CCW::CLOCKWISE;
+  return std::nullopt;
+}
+
+double DoubleApproximation::upperLength() const {
+  return std::hypot(std::abs(x) + error, std::abs(y) + error) * SAFETY;
+}
+
+double DoubleApproximation::lowerLength() const {
+  return lowerDistance(*this, *this);
+}
+
+double DoubleApproximation::lowerDistance(const DoubleApproximation& start, const DoubleApproximation& end) {
+  const double dx = end.x - start.x;
+  const double dy = end.y - start.y;
+  const double norm = dx * dx + dy * dy;
+
+  // The parameter of the point on the segment that is closest to the origin.
+  double t = norm > 0 ? -(start.x * dx + start.y * dy) / norm : 0;
+  t = std::min(1., std::max(0., t));
+
+  const double distance = std::hypot(start.x + t * dx, start.y + t * dy);
+
+  // Moving the endpoints by their error moves the segment by at most √2
+  // times that error. The roundings above (including the ones in t which
+  // might make us miss the actual closest point) are bounded relative to the
+  // size of the coordinates.
+  const double magnitude = std::abs(start.x) + std::abs(start.y) + std::abs(end.x) + std::abs(end.y);
+  const double bound = (1.5 * std::max(start.error, end.error) + 16 * EPS * magnitude) * SAFETY;
+
+  if (!std::isfinite(distance) || !std::isfinite(bound))
+    return 0;
+
+  return std::max(0., distance - bound);
+}
+
+DoubleApproximation& DoubleApproximation::operator+=(const DoubleApproximation& rhs) {
+  x += rhs.x;
+  y += rhs.y;
+  error = (error + rhs.error + EPS * std::max(std::abs(x), std::abs(y))) * SAFETY;
+  return *this;
+}
+
+DoubleApproximation& DoubleApproximation::operator-=(const DoubleApproximation& rhs) {
+  x -= rhs.x;
+  y -= rhs.y;
+  error = (error + rhs.error + EPS * std::max(std::abs(x), std::abs(y))) * SAFETY;
+  return *this;
+}
+
+std::ostream& operator<<(std::ostream& os, const DoubleApproximation& self) {
+  return os << "(" << self.x << " ± " << self.error << ", " << self.y << " ± " << self.error << ")";
+}
+
+}  // namespace flatsurf
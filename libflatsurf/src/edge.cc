@@ -22,42 +22,14 @@
 #include <ostream>
 
 #include "../flatsurf/half_edge.hpp"
-#include "util/assert.ipp"
 
 namespace flatsurf {
 
-Edge::Edge() noexcept :
-  id(HalfEdge()) {}
-
 Edge::Edge(int id) :
   Edge(HalfEdge(id)) {}
 
-Edge::Edge(HalfEdge e) :
-  id(e.index() < (-e).index() ? e : -e) {}
-
-Edge Edge::fromIndex(size_t index) {
-  return Edge(HalfEdge(static_cast<int>(index) + 1));
-}
-
-HalfEdge Edge::positive() const { return id; }
-
-HalfEdge Edge::negative() const { return -id; }
-
-size_t Edge::index() const {
-  ASSERT(id.index() % 2 == 0, "Edge should have been automatically set to its positive HalfEdge representative");
-  return id.index() / 2;
-}
-
-bool Edge::operator==(const Edge& rhs) const {
-  return id == rhs.id;
-}
-
 std::ostream& operator<<(std::ostream& os, const Edge& e) {
   return os << e.id;
 }
 
 }  // namespace flatsurf
-
-size_t std::hash<flatsurf::Edge>::operator()(const flatsurf::Edge& e) const {
-  return std::hash<flatsurf::HalfEdge>()(e.positive());
-}
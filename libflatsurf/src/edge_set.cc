@@ -58,6 +58,21 @@ bool EdgeSet::disjoint(const EdgeSet& rhs) const {
   return self->disjoint(*rhs.self);
 }
 
+EdgeSet& EdgeSet::operator|=(const EdgeSet& rhs) {
+  *self |= *rhs.self;
+  return *this;
+}
+
+EdgeSet& EdgeSet::operator&=(const EdgeSet& rhs) {
+  *self &= *rhs.self;
+  return *this;
+}
+
+EdgeSet& EdgeSet::operator-=(const EdgeSet& rhs) {
+  *self -= *rhs.self;
+  return *this;
+}
+
 bool EdgeSet::empty() const {
   return self->empty();
 }
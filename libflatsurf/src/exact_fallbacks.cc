@@ -0,0 +1,203 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/exact_fallbacks.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "impl/exact_fallbacks.impl.hpp"
+#include "util/assert.ipp"
+
+namespace flatsurf {
+
+namespace {
+
+using Clock = ExactFallbacks::Clock;
+
+// The counters of a single predicate in a single thread. Only the owning
+// thread writes to them but any thread might read them when aggregating.
+struct Counter {
+  std::atomic<size_t> decided = 0;
+  std::atomic<size_t> undecided = 0;
+  std::atomic<Clock::rep> exact = 0;
+
+  void clear() {
+    decided.store(0, std::memory_order_relaxed);
+    undecided.store(0, std::memory_order_relaxed);
+    exact.store(0, std::memory_order_relaxed);
+  }
+};
+
+using Counters = std::array<Counter, ImplementationOf<ExactFallbacks>::MAX_SITES>;
+
+// The totals of a single predicate.
+struct Total {
+  size_t decided = 0;
+  size_t undecided = 0;
+  Clock::rep exact = 0;
+
+  Total& operator+=(const Counter& counter) {
+    decided += counter.decided.load(std::memory_order_relaxed);
+    undecided += counter.undecided.load(std::memory_order_relaxed);
+    exact += counter.exact.load(std::memory_order_relaxed);
+    return *this;
+  }
+};
+
+struct Registry {
+  std::mutex mutex;
+  // The names of the registered predicates, indexed by their key.
+  std::vector<std::string> names;
+  // The counters of the currently running threads.
+  std::vector<const Counters*> threads;
+  // The counters of the threads that have already terminated.
+  std::array<Total, ImplementationOf<ExactFallbacks>::MAX_SITES> retired;
+};
+
+// The registry is never destroyed since threads might still report to it
+// while static objects are being destroyed at exit.
+Registry& globalRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+// The counters of the current thread which are handed to the registry when
+// the thread terminates.
+struct Local {
+  Local() {
+    auto& registry = globalRegistry();
+    std::lock_guard lock(registry.mutex);
+    registry.threads.push_back(&counters);
+  }
+
+  ~Local() {
+    auto& registry = globalRegistry();
+    std::lock_guard lock(registry.mutex);
+    for (size_t site = 0; site < counters.size(); site++)
+      registry.retired[site] += counters[site];
+    registry.threads.erase(std::find(begin(registry.threads), end(registry.threads), &counters));
+  }
+
+  Counters counters;
+};
+
+Local& local() {
+  thread_local Local local;
+  return local;
+}
+
+// Enable the statistics when requested through the environment and print
+// them when the program exits.
+[[maybe_unused]] const bool fromEnvironment = [] {
+  if (std::getenv("LIBFLATSURF_EXACT_FALLBACKS") == nullptr)
+    return false;
+  ExactFallbacks::enable();
+  std::atexit([] { ExactFallbacks::dump(std::cerr); });
+  return true;
+}();
+
+}  // namespace
+
+std::atomic<bool> ImplementationOf<ExactFallbacks>::active = false;
+
+void ExactFallbacks::enable(bool enabled) {
+  ImplementationOf<ExactFallbacks>::active = enabled;
+}
+
+bool ExactFallbacks::enabled() {
+  return ImplementationOf<ExactFallbacks>::enabled();
+}
+
+std::vector<ExactFallbacks::Site> ExactFallbacks::sites() {
+  auto& registry = globalRegistry();
+  std::lock_guard lock(registry.mutex);
+
+  std::vector<Site> sites;
+  for (size_t site = 0; site < registry.names.size(); site++) {
+    Total total = registry.retired[site];
+    for (const auto* counters : registry.threads)
+      total += (*counters)[site];
+    sites.push_back(Site{registry.names[site], total.decided, total.undecided, Clock::duration(total.exact)});
+  }
+  return sites;
+}
+
+void ExactFallbacks::reset() {
+  auto& registry = globalRegistry();
+  std::lock_guard lock(registry.mutex);
+
+  registry.retired = {};
+  for (const auto* counters : registry.threads)
+    for (auto& counter : const_cast<Counters&>(*counters))
+      counter.clear();
+}
+
+void ExactFallbacks::dump(std::ostream& os) {
+  auto sites = ExactFallbacks::sites();
+
+  // Report the predicates that cost the most first.
+  std::sort(begin(sites), end(sites), [](const auto& lhs, const auto& rhs) { return lhs.exact > rhs.exact; });
+
+  for (const auto& site : sites)
+    os << site << std::endl;
+}
+
+size_t ImplementationOf<ExactFallbacks>::site(const char* name) {
+  auto& registry = globalRegistry();
+  std::lock_guard lock(registry.mutex);
+
+  const auto existing = std::find(begin(registry.names), end(registry.names), name);
+  if (existing != end(registry.names))
+    return static_cast<size_t>(existing - begin(registry.names));
+
+  ASSERT(registry.names.size() < MAX_SITES, "too many predicates registered with ExactFallbacks");
+  registry.names.push_back(name);
+  return registry.names.size() - 1;
+}
+
+void ImplementationOf<ExactFallbacks>::record(size_t site, std::optional<Clock::duration> exact) {
+  auto& counter = local().counters[site];
+
+  // Only this thread writes to its counters, so there is no need for an
+  // atomic increment.
+  if (exact) {
+    counter.undecided.store(counter.undecided.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    counter.exact.store(counter.exact.load(std::memory_order_relaxed) + exact->count(), std::memory_order_relaxed);
+  } else {
+    counter.decided.store(counter.decided.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+}
+
+std::ostream& operator<<(std::ostream& os, const ExactFallbacks::Site& self) {
+  const size_t total = self.decided + self.undecided;
+  const double undecided = total ? 100. * static_cast<double>(self.undecided) / static_cast<double>(total) : 0.;
+  const double exact = std::chrono::duration<double, std::milli>(self.exact).count();
+  return os << fmt::format("{}: {} evaluations, {} undecided ({:.2f}%), {:.3f}ms in exact fallback", self.name, total, self.undecided, undecided, exact);
+}
+
+}  // namespace flatsurf
@@ -0,0 +1,86 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/executor.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+#include "impl/executor.impl.hpp"
+#include "util/assert.ipp"
+
+namespace flatsurf {
+
+namespace {
+
+// Guards the executor returned by Executor::global().
+std::mutex globalLock;
+
+Executor& globalExecutor() {
+  static Executor executor;
+  return executor;
+}
+
+}  // namespace
+
+Executor::Executor() :
+  Executor([](Task task) { std::thread(std::move(task)).detach(); }, std::max(1u, std::thread::hardware_concurrency())) {}
+
+Executor::Executor(std::function<void(Task)> submit, unsigned int concurrency) :
+  self(std::make_shared<ImplementationOf<Executor>>(std::move(submit), concurrency)) {
+  CHECK_ARGUMENT(self->submit || concurrency == 1, "an executor that cannot run tasks must have concurrency 1");
+  CHECK_ARGUMENT(concurrency >= 1, "concurrency must be positive");
+}
+
+Executor Executor::serial() {
+  return Executor({}, 1);
+}
+
+Executor Executor::global() {
+  std::lock_guard<std::mutex> guard(globalLock);
+  return globalExecutor();
+}
+
+void Executor::global(Executor executor) {
+  std::lock_guard<std::mutex> guard(globalLock);
+  globalExecutor() = std::move(executor);
+}
+
+unsigned int Executor::concurrency() const {
+  return self->concurrency;
+}
+
+void Executor::submit(Task task) const {
+  if (self->submit)
+    self->submit(std::move(task));
+}
+
+ImplementationOf<Executor>::ImplementationOf(std::function<void(Executor::Task)> submit, unsigned int concurrency) :
+  submit(std::move(submit)),
+  concurrency(concurrency) {}
+
+std::ostream& operator<<(std::ostream& os, const Executor& self) {
+  if (!self.self->submit)
+    return os << "Executor(serial)";
+  return os << "Executor(" << self.concurrency() << " threads)";
+}
+
+}  // namespace flatsurf
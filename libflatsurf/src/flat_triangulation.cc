@@ -19,17 +19,31 @@
 
 #include "../flatsurf/flat_triangulation.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <boost/type_traits/is_detected.hpp>
+#include <cmath>
+#include <complex>
+#include <deque>
 #include <exact-real/arb.hpp>
+#include <exact-real/element.hpp>
 #include <exact-real/integer_ring.hpp>
+#include <exact-real/module.hpp>
 #include <exact-real/number_field.hpp>
 #include <exact-real/rational_field.hpp>
 #include <exact-real/yap/arb.hpp>
 #include <functional>
 #include <iosfwd>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <ostream>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "../flatsurf/bound.hpp"
@@ -38,256 +52,418 @@
 #include "../flatsurf/delaunay.hpp"
 #include "../flatsurf/edge.hpp"
 #include "../flatsurf/edge_set.hpp"
+#include "../flatsurf/executor.hpp"
 #include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/half_edge_map.hpp"
 #include "../flatsurf/half_edge_set.hpp"
+#include "../flatsurf/half_edge_set_iterator.hpp"
 #include "../flatsurf/isomorphism.hpp"
 #include "../flatsurf/odd_half_edge_map.hpp"
 #include "../flatsurf/orientation.hpp"
+#include "../flatsurf/permutation.hpp"
 #include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/saddle_connections.hpp"
 #include "../flatsurf/vector.hpp"
+#include "../flatsurf/vertex.hpp"
 #include "../flatsurf/vertical.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
 #include "impl/approximation.hpp"
 #include "impl/deformation.impl.hpp"
 #include "impl/flat_triangulation.impl.hpp"
 #include "impl/flat_triangulation_combinatorial.impl.hpp"
+#include "impl/floating_point.hpp"
 #include "impl/quadratic_polynomial.hpp"
+#include "impl/saddle_connections_cache.hpp"
+#include "impl/tracked.impl.hpp"
 #include "impl/transformation_deformation.hpp"
+#include "impl/vertex.impl.hpp"
+#include "impl/vertical.impl.hpp"
 #include "util/assert.ipp"
+#include "util/hash.ipp"
+#include "util/scratch.ipp"
+#include "util/trace.ipp"
+#include "util/work_stealing.ipp"
 
 namespace flatsurf {
 
 using std::begin;
 using std::end;
 
+namespace {
+
+// Promote the coordinates of vectors to a common module if T is an
+// exact-real element. Arithmetic of elements of the same module only
+// combines their coefficients; elements of different modules have to be
+// promoted to the module spanned by both in every operation. Since the
+// vectors of chains, saddle connections, and decompositions are sums of the
+// vectors of the surface, they then all live in that same module.
+template <typename Surface, typename T>
+void unifyModules(const Surface &surface, OddHalfEdgeMap<Vector<T>> &vectors) {
+  if constexpr (std::is_same_v<T, exactreal::Element<exactreal::IntegerRing>> || std::is_same_v<T, exactreal::Element<exactreal::RationalField>> || std::is_same_v<T, exactreal::Element<exactreal::NumberField>>) {
+    using Module = std::decay_t<decltype(*std::declval<const T &>().module())>;
+
+    std::shared_ptr<const Module> module;
+    const auto extend = [&](const T &coordinate) {
+      if (!module)
+        module = coordinate.module();
+      else if (coordinate.module() != module)
+        module = Module::span(module, coordinate.module());
+    };
+
+    for (const auto edge : surface.edges()) {
+      const auto &vector = vectors.get(edge.positive());
+      extend(vector.x());
+      extend(vector.y());
+    }
+
+    for (const auto edge : surface.edges()) {
+      const auto &vector = vectors.get(edge.positive());
+
+      T x = vector.x();
+      T y = vector.y();
+      if (x.module() == module && y.module() == module)
+        continue;
+
+      x.promote(module);
+      y.promote(module);
+      vectors.set(edge.positive(), Vector<T>(std::move(x), std::move(y)));
+    }
+  }
+}
+
+}  // namespace
+
 template <typename T>
 Deformation<FlatTriangulation<T>> FlatTriangulation<T>::operator+(const OddHalfEdgeMap<Vector<T>> &shift) const {
+  // We perform all the flips that are necessary along the way on a single
+  // copy of this surface.
+  auto surface = clone();
+  Tracked<OddHalfEdgeMap<Vector<T>>> remaining(surface, OddHalfEdgeMap<Vector<T>>(surface, [&](const HalfEdge he) { return shift.get(he); }), ImplementationOf<FlatTriangulation>::updateAfterFlip);
+
   // Half edges that collapse at the end of the shift.
   EdgeSet collapsing;
 
-  // Records that the half edge e needs to be flipped at a time t in (0, 1]
-  // that is given by a solution to det(t) = a*t^2 + b*t + c = 0.
-  struct Flip {
-    HalfEdge flip;
-    QuadraticPolynomial<T> det;
+  ImplementationOf<FlatTriangulation>::shift(surface, remaining, collapsing);
+
+  // Now we perform the remaining shifts of half edges on a copy of the
+  // surface's vector structure and collapse on the combinatorial structure.
+  auto combinatorial = static_cast<const FlatTriangulationCombinatorial &>(surface).clone();
+  Tracked<OddHalfEdgeMap<Vector<T>>> vectors(combinatorial, OddHalfEdgeMap<Vector<T>>(combinatorial, [&](const HalfEdge he) { return surface.fromHalfEdge(he) + remaining->get(he); }),
+      Tracked<OddHalfEdgeMap<Vector<T>>>::defaultFlip,
+      [](OddHalfEdgeMap<Vector<T>> &vectors, const FlatTriangulationCombinatorial &, Edge e) {
+        ASSERT(!vectors.get(e.positive()), "can only collapse half edges that have become trivial");
+      });
+  Tracked<EdgeSet> collapsing_(combinatorial, collapsing,
+      Tracked<EdgeSet>::defaultFlip,
+      [](EdgeSet &self, const FlatTriangulationCombinatorial &, Edge e) {
+        ASSERT(self.contains(e), "can only collapse edges that have been found to collapse at t=1");
+      });
+
+  while (!collapsing_->empty())
+    combinatorial.collapse(begin(static_cast<const EdgeSet &>(collapsing_))->positive());
+
+  return ImplementationOf<Deformation<FlatTriangulation>>::make(ImplementationOf<FlatTriangulation>::make(
+      std::move(combinatorial),
+      [&](const HalfEdge he) { return vectors->get(he); }));
+}
+
+template <typename T>
+FlatTriangulation<T> &FlatTriangulation<T>::operator+=(const OddHalfEdgeMap<Vector<T>> &shift) {
+  // The part of the shift that has not been applied yet. It follows the
+  // flips that we perform on this surface along the way.
+  Tracked<OddHalfEdgeMap<Vector<T>>> remaining(*this, shift, ImplementationOf<FlatTriangulation>::updateAfterFlip);
+
+  EdgeSet collapsing;
+
+  ImplementationOf<FlatTriangulation>::shift(*this, remaining, collapsing);
+
+  if (!collapsing.empty())
+    throw std::logic_error("not implemented: cannot collapse half edges in an in-place shift, use operator+ instead");
+
+  self->deform([&](const HalfEdge he) { return fromHalfEdge(he) + remaining->get(he); });
+  return *this;
+}
+
+template <typename T>
+FlatTriangulation<T> &FlatTriangulation<T>::operator*=(const mpz_class &scalar) {
+  self->deform([&](const HalfEdge e) { return scalar * fromHalfEdge(e); });
+  return *this;
+}
+
+template <typename T>
+FlatTriangulation<T> &FlatTriangulation<T>::apply(const T &a, const T &b, const T &c, const T &d) {
+  CHECK_ARGUMENT(a * d - b * c > 0, "matrix must have positive determinant");
+
+  self->transform(a, b, c, d);
+
+  // Lawson's algorithm only flips the edges that are not Delaunay anymore
+  // and their neighbours. For matrices close to the identity, these are
+  // typically few.
+  delaunay();
+
+  return *this;
+}
+
+template <typename T>
+Deformation<FlatTriangulation<T>> FlatTriangulation<T>::reorder() const {
+  // The new label of each half edge. The half edge through which an edge is
+  // met first becomes its positive half edge.
+  HalfEdgeMap<HalfEdge> relabeling(*this);
+  int edges = 0;
+
+  HalfEdgeSet visited;
+  std::deque<HalfEdge> faces;
+
+  const auto visit = [&](HalfEdge face) {
+    visited.insert(face);
+    visited.insert(this->nextInFace(face));
+    visited.insert(this->previousInFace(face));
+  };
+
+  const auto label = [&](HalfEdge he) {
+    if (relabeling[he] != HalfEdge())
+      return;
+    edges++;
+    relabeling[he] = HalfEdge(edges);
+    relabeling[-he] = HalfEdge(-edges);
   };
 
-  std::optional<Flip> flip;
+  for (const auto start : this->halfEdges()) {
+    if (visited.contains(start) || this->boundary(start))
+      continue;
 
-  for (auto vertex : this->vertices()) {
-    const auto outgoing = this->atVertex(vertex);
+    faces.push_back(start);
+    visit(start);
 
-    // The x, y coordinates of the half edge he
-    const auto x = [&](const HalfEdge he) { return fromHalfEdge(he).x(); };
-    const auto y = [&](const HalfEdge he) { return fromHalfEdge(he).y(); };
-    // The x, y shifts of the half edge he at time t = 1
-    const auto u = [&](const HalfEdge he) { return shift.get(he).x(); };
-    const auto v = [&](const HalfEdge he) { return shift.get(he).y(); };
+    while (!faces.empty()) {
+      const HalfEdge face = faces.front();
+      faces.pop_front();
 
-    // One reason why the area of a triangle is zero for a time t in [0, 1] is
-    // that two singularities were shifted into each other. We can make sense
-    // of this when it happens at time t=1 by collapsing triangles.
-    for (size_t i = 0; i < outgoing.size(); i++) {
-      const auto he = outgoing.at(i);
+      for (const auto he : {face, this->nextInFace(face), this->previousInFace(face)}) {
+        label(he);
 
-      if (fromHalfEdge(he).ccw(shift.get(he)) == CCW::COLLINEAR) {
-        switch (fromHalfEdge(he).orientation(fromHalfEdge(he) + shift.get(he))) {
-          case ORIENTATION::SAME:
-            // The critical time t is not in [0, 1]
-            break;
-          case ORIENTATION::OPPOSITE:
-            throw std::invalid_argument("shift must not collapse half edges for a time t in (0, 1)");
-          case ORIENTATION::ORTHOGONAL:
-            collapsing.insert(he);
-        }
+        const HalfEdge neighbor = -he;
+        if (visited.contains(neighbor) || this->boundary(neighbor))
+          continue;
+
+        faces.push_back(neighbor);
+        visit(neighbor);
       }
     }
+  }
 
-    // The more common reason why the area of a triangle is zero is that a
-    // singularity is shifted onto the interior of an edge. When this happens
-    // we can flip that edge just before to make sure that our triangulation
-    // remains valid at all times.
-    for (size_t i = 0; i < outgoing.size(); i++) {
-      const auto he = outgoing.at(i);
-      const auto he_ = outgoing.at((i + 1) % outgoing.size());
-
-      // The determinant of the vectors spanned by the edges he and he_ at time
-      // t is given by a*t^2 - b*t + c.
-      const auto det = QuadraticPolynomial<T>(
-          u(he) * v(he_) - u(he_) * v(he),
-          u(he) * y(he_) - u(he_) * y(he) + x(he) * v(he_) - x(he_) * v(he),
-          x(he) * y(he_) - x(he_) * y(he));
-
-      ASSERT(det(T()) > 0, "Original surface " << *this << " already had a triangle with non-positive area before applying any shift to it.");
-
-      // If the determinant has a zero for any t in [0, 1], the area of a
-      // triangle vanishes or becomes negative.
-      // We handle the easiest case first: the area remains positive for all
-      // times t in [0, 1].
-      if (det.positive())
-        continue;
+  ASSERT(edges == static_cast<int>(this->size()), "breadth-first search did not reach all edges of the surface");
 
-      // We can now assume that the determinant is zero for some t in (0, 1].
-      // We need to flip a half edge of this triangle if it has a vertex on its
-      // interior at that critical time t.
+  HalfEdgeMap<HalfEdge> preimage(*this);
+  for (const auto he : this->halfEdges())
+    preimage[relabeling[he]] = he;
 
-      // But first we exclude the case that
-      // the vertex ends up on the boundary of the half edge, i.e., a half edge
-      // collapses.
-      if (collapsing.contains(he) || collapsing.contains(he_))
-        continue;
+  std::vector<std::pair<HalfEdge, HalfEdge>> vertices;
+  std::vector<HalfEdge> boundaries;
+  for (const auto he : this->halfEdges()) {
+    vertices.emplace_back(relabeling[he], relabeling[this->nextAtVertex(he)]);
+    if (this->boundary(he))
+      boundaries.push_back(relabeling[he]);
+  }
 
-      // Determine whether our vertex moves onto the half edge opposite to it,
-      // i.e., the one following he in this triangle.
-      const auto vertex_hits_interior = [&]() {
-        for (long prec = exactreal::ARB_PRECISION_FAST;; prec *= 2) {
-          const auto t = det.root(prec);
-          const auto arb = Approximation<T>::arb;
-          ASSERT(t, "determinant " << det << " must have a root in [0, 1]");
-          const auto et = Vector<exactreal::Arb>(
-              (arb(fromHalfEdge(he).x(), prec) + *t * arb(shift.get(he).x(), prec))(prec),
-              (arb(fromHalfEdge(he).y(), prec) + *t * arb(shift.get(he).y(), prec))(prec));
-          const auto e_t = Vector<exactreal::Arb>(
-              (arb(fromHalfEdge(he_).x(), prec) + *t * arb(shift.get(he_).x(), prec))(prec),
-              (arb(fromHalfEdge(he_).y(), prec) + *t * arb(shift.get(he_).y(), prec))(prec));
-
-          const auto orientation = et.orientation(e_t);
-
-          if (orientation) {
-            switch (*orientation) {
-              case ORIENTATION::ORTHOGONAL:
-                UNREACHABLE("vectors cannot be orthogonal when their determinant is vanishing");
-              case ORIENTATION::SAME:
-                // The half edges he and he_ meet but the vertex at their source
-                // does not end up on the interior of the half edge opposite to
-                // it. We can ignore this case as another vertex will take care
-                // of this vanishing triangle.
-                return false;
-              case ORIENTATION::OPPOSITE:
-                // The two edges attached to this vertex point in opposite
-                // directions at time t so this vertex ends up on the interior
-                // of the opposite edge.
-                return true;
-            }
-          }
-        }
-      };
+  auto reordered = ImplementationOf<FlatTriangulation>::make(
+      ImplementationOf<FlatTriangulationCombinatorial>::make(Permutation<HalfEdge>(vertices), boundaries),
+      [&](const HalfEdge he) { return fromHalfEdge(preimage[he]); });
+
+  return TransformationDeformation<FlatTriangulation>::make(std::move(reordered), std::move(relabeling));
+}
 
-      if (!vertex_hits_interior())
-        // The half edge following e does not need to be flipped.
+template <typename T>
+Deformation<FlatTriangulation<T>> FlatTriangulation<T>::eliminateMarkedPoints() const {
+  auto simplified = clone();
+
+  while (true) {
+    // We move a batch of marked points at once, each onto one of its
+    // neighbours along their shortest connecting half edge. To keep the
+    // deformation well-defined, no two of these marked points are adjacent,
+    // none of them moves onto another point that moves, and no two of them
+    // move onto the same point.
+    std::unordered_map<Vertex, HalfEdge> collapse;
+    std::unordered_set<Vertex> targets;
+    std::unordered_set<Vertex> blocked;
+
+    for (const auto &vertex : simplified.vertices()) {
+      if (simplified.angle(vertex) != 1 || blocked.find(vertex) != blocked.end() || targets.find(vertex) != targets.end())
         continue;
 
-      const Flip proposed{this->nextInFace(he), det};
+      std::optional<HalfEdge> shortest;
+      for (const auto &outgoing : simplified.atVertex(vertex)) {
+        const auto neighbour = Vertex::target(outgoing, simplified);
+        if (neighbour == vertex || collapse.find(neighbour) != collapse.end() || targets.find(neighbour) != targets.end())
+          continue;
+        if (shortest && (simplified.fromHalfEdge(*shortest) * simplified.fromHalfEdge(*shortest)) < simplified.fromHalfEdge(outgoing) * simplified.fromHalfEdge(outgoing))
+          continue;
+        shortest = outgoing;
+      }
+
+      if (!shortest)
+        continue;
 
-      // Record that a half edge needs to be flipped at time t. We'll later
-      // actually flip the one that needs to be flipped first and recurse.
-      if (!flip || proposed.det < flip->det)
-        flip = proposed;
+      collapse[vertex] = *shortest;
+      targets.insert(Vertex::target(*shortest, simplified));
+      for (const auto &outgoing : simplified.atVertex(vertex))
+        blocked.insert(Vertex::target(outgoing, simplified));
     }
-  }
 
-  if (flip) {
-    // We want to flip the half edge that we found needs to be flipped first.
-    // However, just flipping that edge right now might lead to infinite loops
-    // where the same edges get flipped again and again without making any
-    // progress. So instead we get a bit closer to the critical time and
-    // perform the flip just then.
-    // Note that this also solves the problem that the flip might not actually
-    // be possibly as it might lead to a non-convex triangulation since
-    // eventually, when we are close enough to the critical time, the flip will
-    // be valid.
-    // Note that this leads to quite some coefficient blow-up along the way;
-    // every flip introduces a factor of two in the denominators. These
-    // coefficients go away in the final surface. It would likely be more
-    // efficient not to move before the flip if this still makes the critical
-    // time t increase.
-    const auto t = *flip->det.root(exactreal::ARB_PRECISION_FAST);
+    if (collapse.empty())
+      return ImplementationOf<Deformation<FlatTriangulation>>::make(std::move(simplified));
 
-    for (auto s = mpq_class(1, 2);; s /= 2) {
-      const auto lt = exactreal::Arb(s, exactreal::ARB_PRECISION_FAST) < t;
-      if (lt && *lt) {
-        const OddHalfEdgeMap<Vector<T>> partial(*this, [&](const HalfEdge he) { return shift.get(he) / s.get_den(); });
-        auto closer = (*this + partial).surface();
+    const size_t vertices = simplified.vertices().size();
 
-        const Tracked<OddHalfEdgeMap<Vector<T>>> remaining(closer, OddHalfEdgeMap<Vector<T>>(closer, [&](const HalfEdge he) { return shift.get(he) - partial.get(he); }), ImplementationOf<FlatTriangulation>::updateAfterFlip);
+    simplified = (simplified + OddHalfEdgeMap<Vector<T>>(simplified, [&](const HalfEdge he) {
+      Vector<T> shift;
 
-        if (convex(flip->flip, true))
-          closer.flip(flip->flip);
+      const auto source = collapse.find(Vertex::source(he, simplified));
+      if (source != collapse.end())
+        shift -= simplified.fromHalfEdge(source->second);
 
-        return closer + remaining;
-      }
-    }
-  } else {
-    // Now we perform shifts of half edges on a copy of the surface's vector
-    // structure and collapse on the combinatorial structure.
-    auto combinatorial = static_cast<const FlatTriangulationCombinatorial &>(*this).clone();
-    Tracked<OddHalfEdgeMap<Vector<T>>> vectors(combinatorial, OddHalfEdgeMap<Vector<T>>(combinatorial, [&](const HalfEdge he) { return fromHalfEdge(he) + shift.get(he); }),
-        Tracked<OddHalfEdgeMap<Vector<T>>>::defaultFlip,
-        [](OddHalfEdgeMap<Vector<T>> &vectors, const FlatTriangulationCombinatorial &, Edge e) {
-          ASSERT(!vectors.get(e.positive()), "can only collapse half edges that have become trivial");
-        });
-    Tracked<EdgeSet> collapsing_(combinatorial, collapsing,
-        Tracked<EdgeSet>::defaultFlip,
-        [](EdgeSet &self, const FlatTriangulationCombinatorial &, Edge e) {
-          ASSERT(self.contains(e), "can only collapse edges that have been found to collapse at t=1");
-        });
+      const auto target = collapse.find(Vertex::target(he, simplified));
+      if (target != collapse.end())
+        shift += simplified.fromHalfEdge(target->second);
 
-    while (!collapsing_->empty())
-      combinatorial.collapse(begin(static_cast<const EdgeSet &>(collapsing_))->positive());
+      return shift;
+    })).surface();
 
-    return ImplementationOf<Deformation<FlatTriangulation>>::make(FlatTriangulation<T>(
-        std::move(combinatorial),
-        [&](const HalfEdge he) { return vectors->get(he); }));
+    ASSERT(simplified.vertices().size() == vertices - collapse.size(), "the numbers of vertices is reduced by the number of collapsed marked points but " << *this << " was simplified to " << simplified);
   }
 }
 
 template <typename T>
-Deformation<FlatTriangulation<T>> FlatTriangulation<T>::eliminateMarkedPoints() const {
-  std::optional<HalfEdge> collapse;
+size_t FlatTriangulation<T>::canonicalHash(ISOMORPHISM kind) const {
+  if (this->hasBoundary())
+    throw std::logic_error("not implemented: canonicalHash() not implemented for surfaces with boundary");
+
+  if (kind == ISOMORPHISM::DELAUNAY_CELLS)
+    ASSERT(this->edges() | rx::all_of([&](const auto e) { return this->delaunay(e) != DELAUNAY::NON_DELAUNAY; }), "surface not Delaunay triangulated");
+
+  const size_t size = this->halfEdges().size();
+
+  std::vector<bool> ignore(size);
+  if (kind == ISOMORPHISM::DELAUNAY_CELLS)
+    for (const auto he : this->halfEdges())
+      ignore[he.index()] = this->delaunay(he.edge()) == DELAUNAY::AMBIGUOUS;
+
+  // The half edge following e in the cell to its left (or to its right if
+  // sgn is -1, i.e., when walking the surface with reversed orientation.)
+  const auto nextInCell = [&](HalfEdge e, int sgn) {
+    e = -e;
+    do {
+      e = sgn == 1 ? this->previousAtVertex(e) : this->nextAtVertex(e);
+    } while (ignore[e.index()]);
+    return e;
+  };
+
+  const auto cellDegree = [&](const HalfEdge e, int sgn) {
+    size_t degree = 0;
+    HalfEdge current = e;
+    do {
+      current = nextInCell(current, sgn);
+      degree++;
+    } while (current != e);
+    return degree;
+  };
 
+  // The total angle and the number of cell boundaries at the source of each
+  // half edge.
+  std::vector<std::pair<int, size_t>> vertexInvariant(size);
   for (const auto &vertex : this->vertices()) {
-    if (angle(vertex) == 1) {
-      for (const auto &outgoing : this->atVertex(vertex)) {
-        const auto neighbour = Vertex::target(outgoing, *this);
-        if (neighbour != vertex) {
-          if (collapse && (fromHalfEdge(*collapse) * fromHalfEdge(*collapse)) < fromHalfEdge(outgoing) * fromHalfEdge(outgoing))
-            continue;
-          collapse = outgoing;
-        }
-      }
-    }
+    const auto atVertex = this->atVertex(vertex);
+    const auto invariant = std::pair{this->angle(vertex), static_cast<size_t>(std::count_if(begin(atVertex), end(atVertex), [&](const HalfEdge he) { return !ignore[he.index()]; }))};
+    for (const auto he : atVertex)
+      vertexInvariant[he.index()] = invariant;
+  }
+
+  // We label the half edges in the order in which a breadth-first search
+  // starting from a half edge encounters them and encode the surface in
+  // terms of these labels. The smallest such encoding is an invariant of the
+  // surface. To keep this fast, we only start from the half edges (with an
+  // orientation) whose local invariants are the rarest on this surface.
+  using Invariant = std::tuple<int, size_t, size_t, size_t>;
+
+  std::map<Invariant, std::vector<std::pair<HalfEdge, int>>> starts;
+  for (const auto he : this->halfEdges()) {
+    if (ignore[he.index()]) continue;
+    for (int sgn : {1, -1})
+      starts[Invariant{vertexInvariant[he.index()].first, vertexInvariant[he.index()].second, cellDegree(he, sgn), cellDegree(-he, sgn)}].push_back({he, sgn});
   }
 
-  if (!collapse)
-    return Deformation(clone());
+  ASSERT(starts.size(), "cannot hash surface without Delaunay cells");
+
+  const auto &candidates = std::min_element(begin(starts), end(starts), [](const auto &lhs, const auto &rhs) { return lhs.second.size() < rhs.second.size(); })->second;
 
-  const auto marked = Vertex::source(*collapse, *this);
+  const auto encode = [&](const HalfEdge start, int sgn) {
+    std::vector<size_t> encoding;
+    std::vector<size_t> label(size, size);
+    std::vector<HalfEdge> order{start};
+    label[start.index()] = 0;
+
+    for (size_t i = 0; i < order.size(); i++) {
+      const HalfEdge he = order[i];
+      for (const HalfEdge neighbor : {-he, nextInCell(he, sgn)}) {
+        if (label[neighbor.index()] == size) {
+          label[neighbor.index()] = order.size();
+          order.push_back(neighbor);
+        }
+        encoding.push_back(label[neighbor.index()]);
+      }
+      encoding.push_back(static_cast<size_t>(vertexInvariant[he.index()].first));
+    }
 
-  auto simplified = (*this + OddHalfEdgeMap<Vector<T>>(*this, [&](const HalfEdge he) {
-    if (Vertex::source(he, *this) == marked && Vertex::target(he, *this) == marked)
-      return Vector<T>();
-    if (Vertex::source(he, *this) == marked)
-      return -fromHalfEdge(*collapse);
-    if (Vertex::target(he, *this) == marked)
-      return fromHalfEdge(*collapse);
+    return encoding;
+  };
 
-    return Vector<T>();
-  })).surface();
+  std::vector<size_t> canonical;
+  for (const auto &[start, sgn] : candidates) {
+    auto encoding = encode(start, sgn);
+    if (canonical.empty() || encoding < canonical)
+      canonical = std::move(encoding);
+  }
 
-  ASSERT(simplified.vertices().size() < this->vertices().size(), "the numbers of vertices is reduced in each step but " << *this << " was simplified to " << simplified);
-  return ImplementationOf<Deformation<FlatTriangulation>>::make(simplified.eliminateMarkedPoints().surface());
+  size_t hash = canonical.size();
+  for (const auto label : canonical)
+    hash = hash_combine(hash, label);
+  return hash;
 }
 
 template <typename T>
 Vector<T> FlatTriangulation<T>::shortest() const {
-  const auto edges = this->edges();
-  Edge shortest = *std::min_element(begin(edges), end(edges), [&](const auto &a, const auto &b) {
-    const Vector x = fromHalfEdge(a.positive());
-    const Vector y = fromHalfEdge(b.positive());
-    return x * x < y * y;
-  });
-  return fromHalfEdge(shortest.positive());
+  std::lock_guard<std::mutex> guard(self->shortestEdgeLock);
+
+  HalfEdge &cached = *self->shortestEdge;
+
+  if (cached == HalfEdge()) {
+    if constexpr (std::is_same_v<T, long long>) {
+      // Stream through the coordinates of the positive half edges, i.e., the
+      // even indexes, instead of resolving every half edge on its own.
+      const auto &columns = ImplementationOf<FlatTriangulation<T>>::coordinates(*this);
+
+      size_t shortest = 0;
+      long long length = columns.x[0] * columns.x[0] + columns.y[0] * columns.y[0];
+      for (size_t i = 2; i < columns.size(); i += 2) {
+        const long long l = columns.x[i] * columns.x[i] + columns.y[i] * columns.y[i];
+        if (l < length) {
+          shortest = i;
+          length = l;
+        }
+      }
+      cached = HalfEdge::fromIndex(shortest);
+    } else {
+      const auto edges = this->edges();
+      Edge shortest = *std::min_element(begin(edges), end(edges), [&](const auto &a, const auto &b) {
+        const Vector x = fromHalfEdge(a.positive());
+        const Vector y = fromHalfEdge(b.positive());
+        return x * x < y * y;
+      });
+      cached = shortest.positive();
+    }
+  }
+
+  return fromHalfEdge(cached);
 }
 
 template <typename T>
@@ -317,7 +493,7 @@ const Vector<T> &FlatTriangulation<T>::fromHalfEdge(const HalfEdge e) const {
 
 template <typename T>
 const flatsurf::Vector<exactreal::Arb> &FlatTriangulation<T>::fromHalfEdgeApproximate(HalfEdge e) const {
-  return self->approximations->get(e);
+  return self->approximation(e);
 }
 
 template <typename T>
@@ -326,30 +502,51 @@ FlatTriangulation<T>::FlatTriangulation() noexcept :
 
 template <typename T>
 FlatTriangulation<T>::FlatTriangulation(FlatTriangulationCombinatorial &&combinatorial, const std::vector<Vector<T>> &vectors) :
-  FlatTriangulation(std::move(combinatorial), [&](const HalfEdge he) {
-    Edge e = he;
-    if (he == e.positive())
-      return vectors.at(e.index());
-    else
-      return -vectors.at(e.index());
-  }) {
-  CHECK_ARGUMENT(vectors.size() == this->edges().size(), "there must be exactly one vector for each edge");
+  FlatTriangulation(std::move(combinatorial), std::vector<Vector<T>>(vectors)) {}
+
+template <typename T>
+FlatTriangulation<T>::FlatTriangulation(FlatTriangulationCombinatorial &&combinatorial, std::vector<Vector<T>> &&vectors) :
+  FlatTriangulationCombinatorics<FlatTriangulation>(ProtectedConstructor{}, [&]() {
+    CHECK_ARGUMENT(vectors.size() == combinatorial.size(), "there must be exactly one vector for each edge");
+    return std::make_shared<ImplementationOf<FlatTriangulation<T>>>(std::move(combinatorial), std::move(vectors));
+  }()) {
+  LIBFLATSURF_TRACE("FlatTriangulation::FlatTriangulation");
+  VALIDATE_INPUT([&]() { self->check(); });
 }
 
+template <typename T>
+FlatTriangulation<T>::FlatTriangulation(FlatTriangulationCombinatorial &&combinatorial, const std::vector<T> &x, const std::vector<T> &y) :
+  FlatTriangulation(std::move(combinatorial), [&]() {
+    CHECK_ARGUMENT(x.size() == y.size(), "there must be exactly as many x as y coordinates");
+    std::vector<Vector<T>> vectors;
+    vectors.reserve(x.size());
+    for (size_t i = 0; i < x.size(); i++)
+      vectors.emplace_back(x[i], y[i]);
+    return vectors;
+  }()) {}
+
 template <typename T>
 FlatTriangulation<T>::FlatTriangulation(FlatTriangulationCombinatorial &&combinatorial, const std::function<Vector<T>(HalfEdge)> &vectors) :
   FlatTriangulationCombinatorics<FlatTriangulation>(ProtectedConstructor{}, std::make_shared<ImplementationOf<FlatTriangulation<T>>>(std::move(combinatorial), vectors)) {
-  self->check();
+  LIBFLATSURF_TRACE("FlatTriangulation::FlatTriangulation");
+  VALIDATE_INPUT([&]() { self->check(); });
+}
+
+template <typename T>
+FlatTriangulation<T>::FlatTriangulation(ProtectedConstructor, FlatTriangulationCombinatorial &&combinatorial, const std::function<Vector<T>(HalfEdge)> &vectors) :
+  FlatTriangulationCombinatorics<FlatTriangulation>(ProtectedConstructor{}, std::make_shared<ImplementationOf<FlatTriangulation<T>>>(std::move(combinatorial), vectors)) {
+  LIBFLATSURF_TRACE("FlatTriangulation::FlatTriangulation");
+  VALIDATE([&]() { self->check(); });
 }
 
 template <typename T>
 FlatTriangulation<T> FlatTriangulation<T>::clone() const {
-  return FlatTriangulation(static_cast<const FlatTriangulationCombinatorial &>(*this).clone(), [&](HalfEdge e) { return fromHalfEdge(e); });
+  return ImplementationOf<FlatTriangulation>::make(static_cast<const FlatTriangulationCombinatorial &>(*this).clone(), [&](HalfEdge e) { return fromHalfEdge(e); });
 }
 
 template <typename T>
 Deformation<FlatTriangulation<T>> FlatTriangulation<T>::slit(HalfEdge slit) const {
-  return ImplementationOf<Deformation<FlatTriangulation>>::make(FlatTriangulation(
+  return ImplementationOf<Deformation<FlatTriangulation>>::make(ImplementationOf<FlatTriangulation>::make(
       static_cast<const FlatTriangulationCombinatorial &>(*this).slit(slit),
       [&](HalfEdge e) {
         HalfEdge newEdge = HalfEdge(static_cast<int>(this->halfEdges().size()) / 2 + 1);
@@ -365,131 +562,54 @@ Deformation<FlatTriangulation<T>> FlatTriangulation<T>::insertAt(HalfEdge &nextT
 
   FlatTriangulation<T> surface = clone();
 
-  auto check_orientation = [&](const Vector<T> &saddle_connection) {
-    auto orient = (saddle_connection - slit).orientation(slit);
-    CHECK_ARGUMENT(orient != ORIENTATION::OPPOSITE, "cannot insert half edge that crosses over an existing vertex");
-    if (orient == ORIENTATION::ORTHOGONAL) {
-      // It is a bit unclear what to do if the new edge should end at a
-      // vertex, in particular if it is collinear with an existing half
-      // edge (after fliping.)
-      throw std::logic_error("insertion of half edges that end at an existing vertex not implemented yet");
-    }
-  };
-
-  // Search for half edges that slit would be crossing and flip them.
-  // We should replace all this with a simple call to operator+, see #183.
-  [&]() {
-    while (true) {
-      if (surface.fromHalfEdge(nextTo).ccw(slit) == CCW::COLLINEAR) {
-        check_orientation(surface.fromHalfEdge(nextTo));
-        // Slot is on an existing HalfEdge but does not cross a vertex.
-        return;
-      }
-      assert(surface.fromHalfEdge(nextTo).ccw(slit) == CCW::COUNTERCLOCKWISE);
-
-      // The half edge that slit is potentially crossing
-      const HalfEdge crossing = surface.nextInFace(nextTo);
-      // The base point of crossing half edge
-      const Vector<T> base = surface.fromHalfEdge(nextTo);
-
-      // Check whether slit is actually crossing crossing. It would be enough
-      // to check whether this is != CLOCKWISE. However, we do not allow slit
-      // to end on an edge other than nextTo. So we perform one additional
-      // flip in that case so slit is actually inside of a face.
-      if (surface.fromHalfEdge(crossing).ccw(slit - base) == CCW::COUNTERCLOCKWISE)
-        return;
-
-      std::function<void(HalfEdge)> flip = [&](HalfEdge e) {
-        assert(e != nextTo && e != -nextTo && e != surface.nextAtVertex(nextTo) && e != -surface.nextAtVertex(nextTo));
-
-        auto canFlip = [&](HalfEdge g) {
-          return e != nextTo && e != -nextTo && e != surface.nextAtVertex(nextTo) && e != -surface.nextAtVertex(nextTo) &&
-                 surface.fromHalfEdge(surface.previousAtVertex(g)).ccw(surface.fromHalfEdge(surface.nextAtVertex(g))) == CCW::COUNTERCLOCKWISE && surface.fromHalfEdge(surface.previousAtVertex(-g)).ccw(surface.fromHalfEdge(surface.nextAtVertex(-g))) == CCW::COUNTERCLOCKWISE;
-        };
-
-        while (!canFlip(e)) {
-          // f is blocked by a forward triangle on top of it so we flip its top edge.
-          if (slit.ccw(surface.fromHalfEdge(surface.previousAtVertex(e))) != CCW::COUNTERCLOCKWISE) {
-            flip(-surface.nextAtVertex(-e));
-            continue;
-          } else {
-            assert(slit.ccw(surface.fromHalfEdge(surface.nextAtVertex(-e))) != CCW::CLOCKWISE);
-            flip(surface.previousAtVertex(e));
-            continue;
-          }
-        }
-
-        surface.flip(e);
-      };
-
-      // slit crosses crossing, so flip it and replace nextTo if slit is then not next to nextTo anymore.
-      flip(crossing);
-      assert(surface.fromHalfEdge(nextTo).ccw(slit) == CCW::COUNTERCLOCKWISE);
-      while (surface.fromHalfEdge(surface.nextAtVertex(nextTo)).ccw(slit) != CCW::CLOCKWISE)
-        nextTo = surface.nextAtVertex(nextTo);
-    }
-  }();
-
-  auto symmetric = [](HalfEdge x, HalfEdge e, const Vector<T> &v) {
-    assert(x == e || x == -e);
-    return x == e ? v : -v;
-  };
-
-  if (surface.fromHalfEdge(nextTo).ccw(slit) != CCW::COLLINEAR) {
-    // After the flips we did, v is now completely inside a face.
-    assert(surface.fromHalfEdge(nextTo).ccw(slit) == CCW::COUNTERCLOCKWISE);
-
-    auto combinatorial = static_cast<FlatTriangulationCombinatorial &>(surface).insertAt(nextTo);
+  std::vector<HalfEdge> tracked;
+  return ImplementationOf<Deformation<FlatTriangulation>>::make(ImplementationOf<FlatTriangulation>::insertAt(surface, nextTo, slit, tracked));
+}
 
-    return ImplementationOf<Deformation<FlatTriangulation>>::make(FlatTriangulation(combinatorial.clone(), [&](const HalfEdge e) {
-      HalfEdge a = -combinatorial.nextAtVertex(nextTo);
-      HalfEdge b = combinatorial.nextAtVertex(a);
-      HalfEdge c = combinatorial.nextAtVertex(b);
+template <typename T>
+Deformation<FlatTriangulation<T>> FlatTriangulation<T>::insertAt(std::vector<std::pair<HalfEdge, Vector<T>>> &points) const {
+  for (const auto &[nextTo, slit] : points)
+    CHECK_ARGUMENT(inSector(nextTo, slit), "vector must be contained in the sector next to the half edge");
+
+  // All points are inserted into the same working copy. Flips and
+  // insertions move the half edges around, so we track the half edges of all
+  // the other points along the way and restore them to the sectors
+  // containing their vectors afterwards.
+  FlatTriangulation<T> surface = clone();
 
-      if (Edge(e) == a) return symmetric(e, a, -slit);
-      if (Edge(e) == b) return symmetric(e, b, surface.fromHalfEdge(nextTo) - slit);
-      if (Edge(e) == c) return symmetric(e, c, surface.fromHalfEdge(surface.nextAtVertex(nextTo)) - slit);
-      return surface.fromHalfEdge(e);
-    }));
-  } else {
-    // After the flips we did, v is collinear with the half edge e (but shorter.)
+  std::vector<HalfEdge> tracked;
+  for (const auto &point : points)
+    tracked.push_back(point.first);
 
-    // Insert our half edge ee next to e
-    auto combinatorial = static_cast<FlatTriangulationCombinatorial &>(surface).insertAt(nextTo);
-    auto nextAtSlot = combinatorial.nextAtVertex(nextTo);
-    // After a flip of slit the original slit can be recovered as nextAtSlot + eee.
-    combinatorial.flip(nextTo);
-    auto eee = combinatorial.nextAtVertex(combinatorial.nextAtVertex(-nextAtSlot));
+  for (size_t i = 0; i < points.size(); i++) {
+    const Vector<T> &slit = points[i].second;
 
-    // The combinatorics are correct now, but we still have to patch up the
-    // vectors, namely the four half edges meeting at the new vertex all need
-    // updating.
-    auto ret = FlatTriangulation(combinatorial.clone(), [&](const HalfEdge e) {
-      if (Edge(e) == nextAtSlot) return symmetric(e, nextAtSlot, slit);
-      if (Edge(e) == eee) return symmetric(e, eee, surface.fromHalfEdge(nextTo) - slit);
-      if (Edge(e) == combinatorial.nextAtVertex(-nextAtSlot)) return symmetric(e, combinatorial.nextAtVertex(-nextAtSlot), surface.fromHalfEdge(surface.previousAtVertex(nextTo)) - slit);
-      if (Edge(e) == combinatorial.nextAtVertex(eee)) return symmetric(e, combinatorial.nextAtVertex(eee), surface.fromHalfEdge(surface.nextAtVertex(nextTo)) - slit);
-      return surface.fromHalfEdge(e);
-    });
+    // The sector next to the half edge has been split by the points
+    // inserted so far. Since it spans an angle less than π, turning
+    // counterclockwise until the next half edge is clockwise of slit finds
+    // the sector that contains slit.
+    HalfEdge nextTo = tracked[i];
+    while (surface.fromHalfEdge(surface.nextAtVertex(nextTo)).ccw(slit) != CCW::CLOCKWISE)
+      nextTo = surface.nextAtVertex(nextTo);
 
-    nextTo = combinatorial.previousAtVertex(nextAtSlot);
+    surface = ImplementationOf<FlatTriangulation>::insertAt(surface, nextTo, slit, tracked);
+    tracked[i] = nextTo;
+  }
 
-    return ImplementationOf<Deformation<FlatTriangulation>>::make(std::move(ret));
+  for (size_t i = 0; i < points.size(); i++) {
+    while (surface.fromHalfEdge(surface.nextAtVertex(tracked[i])).ccw(points[i].second) == CCW::COUNTERCLOCKWISE)
+      tracked[i] = surface.nextAtVertex(tracked[i]);
+    points[i].first = tracked[i];
   }
+
+  return ImplementationOf<Deformation<FlatTriangulation>>::make(std::move(surface));
 }
 
 template <typename T>
-void FlatTriangulation<T>::delaunay() {
-  bool isDelaunay;
-  do {
-    isDelaunay = true;
-    for (auto edge : this->edges()) {
-      if (delaunay(edge) == DELAUNAY::NON_DELAUNAY) {
-        isDelaunay = false;
-        this->flip(edge.positive());
-      }
-    }
-  } while (!isDelaunay);
+void FlatTriangulation<T>::delaunay(unsigned int threads) {
+  LIBFLATSURF_TRACE("FlatTriangulation::delaunay");
+
+  ImplementationOf<FlatTriangulation>::delaunay(*this, []() { return false; }, threads);
 }
 
 template <typename T>
@@ -498,15 +618,64 @@ auto delaunay(const FlatTriangulation<T> &surface, const HalfEdge edge) {
 
 template <typename T>
 DELAUNAY FlatTriangulation<T>::delaunay(const Edge edge) const {
-  // We could eventually use Vector::insideCircumcircle() so vectors can
-  // provide optimized implementations of this. However, at the moment, it
-  // does not seem worth it.
-
   // We use the condition described in Wikipedia (whether a certain
   // determinant is positive.) Using the notation there, the face attached to
   // this half edge is the triangle (a, b, c), and the face attached to the
   // reversed half edge is (a, c, d). We use a coordinate system where
   // d=(0,0).
+  if constexpr (std::is_same_v<T, double>) {
+    // The determinant cannot be computed exactly, so we consider the edge
+    // ambiguous when the determinant is small relative to the size of the
+    // terms in its expansion.
+    const auto ca = this->fromHalfEdge(edge.positive());
+    const auto cb = this->fromHalfEdge(this->nextAtVertex(edge.positive()));
+    const auto dc = this->fromHalfEdge(-this->nextInFace(edge.negative()));
+
+    const auto a = dc + ca;
+    const auto b = dc + cb;
+    const auto &c = dc;
+
+    const double la = a * a, lb = b * b, lc = c * c;
+    const double del = a.x() * (b.y() * lc - lb * c.y()) - b.x() * (a.y() * lc - c.y() * la) + c.x() * (a.y() * lb - b.y() * la);
+
+    const double scale = std::sqrt(la * lb * lc) * std::max({la, lb, lc});
+    if (std::abs(del) <= FLOAT_EPSILON * scale)
+      return DELAUNAY::AMBIGUOUS;
+    return del < 0 ? DELAUNAY::DELAUNAY : DELAUNAY::NON_DELAUNAY;
+  } else if constexpr (!std::is_same_v<T, long long>) {
+    // The exact determinant needs lots of expensive multiplications. Usually,
+    // its sign can already be decided with the Arb approximations of the
+    // vectors that we keep track of anyway.
+    using exactreal::Arb;
+
+    const slong prec = self->policy.precision();
+
+    const auto &ca = fromHalfEdgeApproximate(edge.positive());
+    const auto &cb = fromHalfEdgeApproximate(this->nextAtVertex(edge.positive()));
+    const auto &dc = fromHalfEdgeApproximate(-this->nextInFace(edge.negative()));
+
+    const auto a = dc + ca;
+    const auto b = dc + cb;
+    const auto &c = dc;
+
+    const Arb ax = a.x(), ay = a.y(), bx = b.x(), by = b.y(), cx = c.x(), cy = c.y();
+    const Arb la = (ax * ax + ay * ay)(prec);
+    const Arb lb = (bx * bx + by * by)(prec);
+    const Arb lc = (cx * cx + cy * cy)(prec);
+
+    const Arb del = (ax * (by * lc - lb * cy) - bx * (ay * lc - cy * la) + cx * (ay * lb - by * la))(prec);
+
+    const auto negative = del < 0;
+    const auto positive = del > 0;
+    self->policy.record((negative && *negative) || (positive && *positive));
+    if (negative && *negative)
+      return DELAUNAY::DELAUNAY;
+    if (positive && *positive)
+      return DELAUNAY::NON_DELAUNAY;
+
+    // The determinant is (close to) zero, so we need to decide exactly.
+  }
+
   const auto ca = this->fromHalfEdge(edge.positive());
   const auto cb = this->fromHalfEdge(this->nextAtVertex(edge.positive()));
   const auto dc = this->fromHalfEdge(-this->nextInFace(edge.negative()));
@@ -515,11 +684,43 @@ DELAUNAY FlatTriangulation<T>::delaunay(const Edge edge) const {
   const auto b = dc + cb;
   const auto c = dc;
 
-  const auto det = [](const auto &x00, const auto &x01, const auto &x02, const auto &x10, const auto &x11, const auto &x12, const auto &x20, const auto &x21, const auto &x22) -> T {
-    return x00 * (x11 * x22 - x12 * x21) - x10 * (x01 * x22 - x21 * x02) + x20 * (x01 * x12 - x11 * x02);
+  // We expand the determinant in registers of this thread that are reused
+  // across calls so that we do not allocate a temporary for every product.
+  Scratch<T, 6> scratch;
+  T &la = scratch[0], &lb = scratch[1], &lc = scratch[2], &del = scratch[3], &minor = scratch[4], &product = scratch[5];
+
+  const auto squaredLength = [&](T &length, const Vector<T> &v) {
+    length = v.x();
+    length *= v.x();
+    product = v.y();
+    product *= v.y();
+    length += product;
   };
 
-  const auto del = det(a.x(), a.y(), a.x() * a.x() + a.y() * a.y(), b.x(), b.y(), b.x() * b.x() + b.y() * b.y(), c.x(), c.y(), c.x() * c.x() + c.y() * c.y());
+  // Set minor to p*q - r*s.
+  const auto setMinor = [&](const T &p, const T &q, const T &r, const T &s) {
+    minor = p;
+    minor *= q;
+    product = r;
+    product *= s;
+    minor -= product;
+  };
+
+  squaredLength(la, a);
+  squaredLength(lb, b);
+  squaredLength(lc, c);
+
+  setMinor(b.y(), lc, lb, c.y());
+  del = minor;
+  del *= a.x();
+
+  setMinor(a.y(), lc, c.y(), la);
+  minor *= b.x();
+  del -= minor;
+
+  setMinor(a.y(), lb, b.y(), la);
+  minor *= c.x();
+  del += minor;
 
   if (del < 0)
     return DELAUNAY::DELAUNAY;
@@ -531,7 +732,36 @@ DELAUNAY FlatTriangulation<T>::delaunay(const Edge edge) const {
 
 template <typename T>
 T FlatTriangulation<T>::area() const {
-  T area = T();
+  std::lock_guard<std::mutex> guard(self->areaLock);
+
+  if (!self->area) {
+    T area = T();
+    for (auto e : this->halfEdges()) {
+      if (this->boundary(e)) continue;
+
+      // Do not count every triangle three times.
+      if (e.index() > this->nextInFace(e).index()) continue;
+      if (e.index() > this->previousInFace(e).index()) continue;
+
+      area += Vector<T>::area({fromHalfEdge(e), fromHalfEdge(this->nextInFace(e)), fromHalfEdge(this->nextInFace(this->nextInFace(e)))});
+    }
+    self->area = std::move(area);
+  }
+
+  return *self->area;
+}
+
+template <typename T>
+exactreal::Arb FlatTriangulation<T>::areaApproximate() const {
+  const slong prec = exactreal::ARB_PRECISION_FAST;
+
+  {
+    std::lock_guard<std::mutex> guard(self->areaLock);
+    if (self->area)
+      return Approximation<T>::arb(*self->area, prec);
+  }
+
+  exactreal::Arb area;
   for (auto e : this->halfEdges()) {
     if (this->boundary(e)) continue;
 
@@ -539,18 +769,31 @@ T FlatTriangulation<T>::area() const {
     if (e.index() > this->nextInFace(e).index()) continue;
     if (e.index() > this->previousInFace(e).index()) continue;
 
-    area += Vector<T>::area({fromHalfEdge(e), fromHalfEdge(this->nextInFace(e)), fromHalfEdge(this->nextInFace(this->nextInFace(e)))});
+    // Twice the area of a triangle is the cross product of two of its sides.
+    const auto &a = fromHalfEdgeApproximate(e);
+    const auto &b = fromHalfEdgeApproximate(this->nextInFace(e));
+    area = (area + a.x() * b.y() - a.y() * b.x())(prec);
   }
   return area;
 }
 
 template <typename T>
 FlatTriangulation<T> FlatTriangulation<T>::scale(const mpz_class &scalar) const {
-  return FlatTriangulation(static_cast<const FlatTriangulationCombinatorial &>(*this).clone(), [&](HalfEdge e) {
+  return ImplementationOf<FlatTriangulation>::make(static_cast<const FlatTriangulationCombinatorial &>(*this).clone(), [&](HalfEdge e) {
     return scalar * fromHalfEdge(e);
   });
 }
 
+#ifndef LIBFLATSURF_WITHOUT_DOUBLE
+template <typename T>
+FlatTriangulation<double> FlatTriangulation<T>::approximate() const {
+  return FlatTriangulation<double>(static_cast<const FlatTriangulationCombinatorial &>(*this).clone(), [&](HalfEdge e) {
+    const auto v = static_cast<std::complex<double>>(fromHalfEdge(e));
+    return Vector<double>(v.real(), v.imag());
+  });
+}
+#endif
+
 template <typename T>
 bool FlatTriangulation<T>::convex(HalfEdge e, bool strict) const {
   if (strict)
@@ -592,29 +835,23 @@ bool FlatTriangulation<T>::operator==(const FlatTriangulation<T> &rhs) const {
 
 template <typename T>
 int FlatTriangulation<T>::angle(const Vertex &vertex) const {
-  int angle = 0;
-
-  const HalfEdge first = *begin(this->atVertex(vertex));
-  HalfEdge current = first;
-  do {
-    const HalfEdge next = this->nextAtVertex(current);
-
-    if (fromHalfEdge(current).x() >= 0 && fromHalfEdge(next).x() < 0)
-      angle++;
-
-    current = next;
-  } while (current != first);
-
-  ASSERT(angle >= 1, "Total angle at vertex cannot be less than 2π");
+  const auto &invariants = ImplementationOf<FlatTriangulation>::invariants(*this);
+  return invariants.angles[ImplementationOf<FlatTriangulationCombinatorial>::vertex(*this, *begin(ImplementationOf<Vertex>::outgoing(vertex)))];
+}
 
-  return angle;
+template <typename T>
+size_t FlatTriangulation<T>::degree(const Vertex &vertex) const {
+  const auto &invariants = ImplementationOf<FlatTriangulation>::invariants(*this);
+  return invariants.degrees[ImplementationOf<FlatTriangulationCombinatorial>::vertex(*this, *begin(ImplementationOf<Vertex>::outgoing(vertex)))];
 }
 
 template <typename T>
 using truediv_t = decltype(std::declval<T &>() /= std::declval<const T &>());
 
 template <typename T>
-std::optional<Deformation<FlatTriangulation<T>>> FlatTriangulation<T>::isomorphism(const FlatTriangulation<T> &other, ISOMORPHISM kind, std::function<bool(const T &, const T &, const T &, const T &)> filterMatrix, std::function<bool(HalfEdge, HalfEdge)> filterHalfEdgeMap) const {
+std::optional<Deformation<FlatTriangulation<T>>> FlatTriangulation<T>::isomorphism(const FlatTriangulation<T> &other, ISOMORPHISM kind, std::function<bool(const T &, const T &, const T &, const T &)> filterMatrix, std::function<bool(HalfEdge, HalfEdge)> filterHalfEdgeMap, unsigned int threads) const {
+  LIBFLATSURF_TRACE("FlatTriangulation::isomorphism");
+
   if (this->hasBoundary() != other.hasBoundary())
     return std::nullopt;
 
@@ -624,12 +861,25 @@ std::optional<Deformation<FlatTriangulation<T>>> FlatTriangulation<T>::isomorphi
   if (this->hasBoundary())
     throw std::logic_error("not implemented: isomorphism() not implemented for surfaces with boundary");
 
-  const auto ignore = [&](HalfEdge he) {
-    return kind == ISOMORPHISM::FACES ? false : this->delaunay(he.edge()) == DELAUNAY::AMBIGUOUS;
-  };
-  const auto ignoreImage = [&](HalfEdge he) {
-    return kind == ISOMORPHISM::FACES ? false : this->delaunay(he.edge()) == DELAUNAY::AMBIGUOUS;
+  if (threads == 0)
+    threads = Executor::global().concurrency();
+
+  // Deciding whether an edge is Delaunay updates the approximation policy
+  // of the surface, so we decide this upfront for all edges since the
+  // candidates below might be checked in parallel.
+  const auto ambiguous = [&](const FlatTriangulation<T> &surface) {
+    EdgeSet ambiguous;
+    if (kind != ISOMORPHISM::FACES)
+      for (const auto edge : surface.edges())
+        if (surface.delaunay(edge) == DELAUNAY::AMBIGUOUS)
+          ambiguous.insert(edge);
+    return ambiguous;
   };
+  const EdgeSet ignored = ambiguous(*this);
+  const EdgeSet ignoredImage = ambiguous(other);
+
+  const auto ignore = [&](HalfEdge he) { return ignored.contains(he.edge()); };
+  const auto ignoreImage = [&](HalfEdge he) { return ignoredImage.contains(he.edge()); };
 
   if (kind == ISOMORPHISM::DELAUNAY_CELLS) {
     ASSERT(this->edges() | rx::all_of([&](const auto e) { return this->delaunay(e) != DELAUNAY::NON_DELAUNAY; }), "source surface not Delaunay triangulated");
@@ -647,133 +897,325 @@ std::optional<Deformation<FlatTriangulation<T>>> FlatTriangulation<T>::isomorphi
     throw std::logic_error("cannot detect isomorphism in surface without Delaunay cells");
   }();
 
-  for (auto image : other.halfEdges()) {
-    if (ignoreImage(image))
-      continue;
+  // Before we solve for a matrix, we rule out most images with some cheap
+  // invariants that any isomorphism must preserve: the total angle at the
+  // source vertex, the number of cell boundaries at that vertex, and the
+  // number of edges of the cells on either side of the half edge. (Note that
+  // we cannot use lengths here since the matrix is arbitrary.)
+  const auto vertexInvariant = [](const FlatTriangulation<T> &surface, const auto &skip, const Vertex &vertex) {
+    size_t degree = 0;
+    for (const auto he : surface.atVertex(vertex))
+      if (!skip(he))
+        degree++;
+    return std::pair{surface.angle(vertex), degree};
+  };
 
-    for (int sgn : {1, -1}) {
-      const auto nextInCell = [&](auto e) {
-        e = -e;
+  // Return the number of edges of the cell to the left of e.
+  const auto cellDegree = [](const FlatTriangulation<T> &surface, const auto &skip, const HalfEdge e) {
+    size_t degree = 0;
+    HalfEdge current = e;
+    do {
+      current = -current;
+      do {
+        current = surface.previousAtVertex(current);
+      } while (skip(current));
+      degree++;
+    } while (current != e);
+    return degree;
+  };
+
+  const auto preimageVertex = vertexInvariant(*this, ignore, Vertex::source(preimage, *this));
+  const auto preimageCells = std::pair{cellDegree(*this, ignore, preimage), cellDegree(*this, ignore, -preimage)};
+
+  std::unordered_map<Vertex, std::pair<int, size_t>> imageVertices;
+  for (const auto &vertex : other.vertices())
+    imageVertices[vertex] = vertexInvariant(other, ignoreImage, vertex);
+
+  // Return whether the matrix that sends preimage to image and the next half
+  // edge in its cell to the next half edge in the image cell could also send
+  // the other half edges of the cells on either side of preimage to the
+  // corresponding half edges around image. To avoid divisions, we only
+  // determine the matrix (na nb nc nd) / n up to its denominator n.
+  const auto approximateCandidate = [&](const HalfEdge image, const auto &nextInCell, const auto &nextInImageCell) {
+    using exactreal::Arb;
+
+    const slong prec = exactreal::ARB_PRECISION_FAST;
+
+    const auto certainlyNonZero = [](const Arb &x) {
+      const auto negative = x < 0;
+      const auto positive = x > 0;
+      return (negative && *negative) || (positive && *positive);
+    };
+
+    const auto &v = this->fromHalfEdgeApproximate(preimage);
+    const auto &w = this->fromHalfEdgeApproximate(nextInCell(preimage));
+    const auto &v_ = other.fromHalfEdgeApproximate(image);
+    const auto &w_ = other.fromHalfEdgeApproximate(nextInImageCell(image));
+
+    const Arb n = (v.x() * w.y() - v.y() * w.x())(prec);
+    const Arb na = (v_.x() * w.y() - v.y() * w_.x())(prec);
+    const Arb nb = (v.x() * w_.x() - v_.x() * w.x())(prec);
+    const Arb nc = (v_.y() * w.y() - v.y() * w_.y())(prec);
+    const Arb nd = (v.x() * w_.y() - v_.y() * w.x())(prec);
+
+    for (const auto &[from, to] : {std::pair{nextInCell(nextInCell(preimage)), nextInImageCell(nextInImageCell(image))}, std::pair{nextInCell(-preimage), nextInImageCell(-image)}}) {
+      const auto &u = this->fromHalfEdgeApproximate(from);
+      const auto &u_ = other.fromHalfEdgeApproximate(to);
+
+      if (certainlyNonZero((na * u.x() + nb * u.y() - n * u_.x())(prec)))
+        return false;
+      if (certainlyNonZero((nc * u.x() + nd * u.y() - n * u_.y())(prec)))
+        return false;
+    }
+
+    return true;
+  };
+
+  // Return the isomorphism of half edges that sends preimage to image (with
+  // a matrix whose determinant has sign sgn) if there is such an isomorphism.
+  const auto candidate = [&](const HalfEdge image, const int sgn) -> std::optional<HalfEdgeMap<HalfEdge>> {
+    // The entries of the candidate matrices live in registers of this thread
+    // that are reused for every candidate image.
+    Scratch<T, 6> scratch;
+    T &denominator = scratch[0], &a = scratch[1], &b = scratch[2], &c = scratch[3], &d = scratch[4], &product = scratch[5];
+
+    // Set minor to p*q - r*s.
+    const auto setMinor = [&](T &minor, const T &p, const T &q, const T &r, const T &s) {
+      minor = p;
+      minor *= q;
+      product = r;
+      product *= s;
+      minor -= product;
+    };
+
+    const auto nextInCell = [&](auto e) {
+      e = -e;
+      do {
+        e = this->previousAtVertex(e);
+      } while (ignore(e));
+      return e;
+    };
+
+    const auto nextInImageCell = [&](auto e) {
+      e = -e;
+      if (sgn == 1) {
         do {
-          e = this->previousAtVertex(e);
-        } while (ignore(e));
-        return e;
-      };
-
-      const auto nextInImageCell = [&](auto e) {
-        e = -e;
-        if (sgn == 1) {
-          do {
-            e = other.previousAtVertex(e);
-          } while (ignoreImage(e));
-        } else {
-          do {
-            e = other.nextAtVertex(e);
-          } while (ignoreImage(e));
-        }
-        return e;
-      };
-
-      auto v = this->fromHalfEdge(preimage);
-      auto w = this->fromHalfEdge(nextInCell(preimage));
-      auto v_ = other.fromHalfEdge(image);
-      auto w_ = other.fromHalfEdge(nextInImageCell(image));
-
-      // To determine the matrix 2×2 matrix (a b c d) that sends v to v_ and w to w_ note that:
-      // ┌ v.x v.y   0   0 ┐ ┌ a ┐   ┌ v_.x ┐
-      // | w.x w.y   0   0 | | b |   | w_.x |
-      // |   0   0 v.x v.y | | c | = | v_.y |
-      // └   0   0 w.x w.y ┘ └ d ┘   └ w_.y ┘
-      // Hence, we can determine (a b) and (c d) by solving a 2×2 system for each.
-      const T denominator = v.x() * w.y() - v.y() * w.x();
-      T a = v_.x() * w.y() - v.y() * w_.x();
-      T b = v.x() * w_.x() - v_.x() * w.x();
-      T c = v_.y() * w.y() - v.y() * w_.y();
-      T d = v.x() * w_.y() - v_.y() * w.x();
-
-      if constexpr (boost::is_detected_v<truediv_t, T>) {
-        a /= denominator;
-        b /= denominator;
-        c /= denominator;
-        d /= denominator;
+          e = other.previousAtVertex(e);
+        } while (ignoreImage(e));
       } else {
-        auto maybe = a.truediv(denominator);
-        if (!maybe) continue;
-        a = *maybe;
+        do {
+          e = other.nextAtVertex(e);
+        } while (ignoreImage(e));
+      }
+      return e;
+    };
+
+    if constexpr (!std::is_same_v<T, long long>) {
+      // Most candidates fail. Before doing any exact arithmetic, we rule
+      // them out with the Arb approximations of the vectors that we keep
+      // track of anyway: the candidate matrix must send the half edges that
+      // the search below checks first to their images.
+      if (!approximateCandidate(image, nextInCell, nextInImageCell))
+        return std::nullopt;
+    }
 
-        maybe = b.truediv(denominator);
-        if (!maybe) continue;
-        b = *maybe;
+    auto v = this->fromHalfEdge(preimage);
+    auto w = this->fromHalfEdge(nextInCell(preimage));
+    auto v_ = other.fromHalfEdge(image);
+    auto w_ = other.fromHalfEdge(nextInImageCell(image));
+
+    // To determine the matrix 2×2 matrix (a b c d) that sends v to v_ and w to w_ note that:
+    // ┌ v.x v.y   0   0 ┐ ┌ a ┐   ┌ v_.x ┐
+    // | w.x w.y   0   0 | | b |   | w_.x |
+    // |   0   0 v.x v.y | | c | = | v_.y |
+    // └   0   0 w.x w.y ┘ └ d ┘   └ w_.y ┘
+    // Hence, we can determine (a b) and (c d) by solving a 2×2 system for each.
+    setMinor(denominator, v.x(), w.y(), v.y(), w.x());
+    setMinor(a, v_.x(), w.y(), v.y(), w_.x());
+    setMinor(b, v.x(), w_.x(), v_.x(), w.x());
+    setMinor(c, v_.y(), w.y(), v.y(), w_.y());
+    setMinor(d, v.x(), w_.y(), v_.y(), w.x());
+
+    if constexpr (boost::is_detected_v<truediv_t, T>) {
+      a /= denominator;
+      b /= denominator;
+      c /= denominator;
+      d /= denominator;
+    } else {
+      auto maybe = a.truediv(denominator);
+      if (!maybe) return std::nullopt;
+      a = *maybe;
+
+      maybe = b.truediv(denominator);
+      if (!maybe) return std::nullopt;
+      b = *maybe;
+
+      maybe = c.truediv(denominator);
+      if (!maybe) return std::nullopt;
+      c = *maybe;
+
+      maybe = d.truediv(denominator);
+      if (!maybe) return std::nullopt;
+      d = *maybe;
+    }
 
-        maybe = c.truediv(denominator);
-        if (!maybe) continue;
-        c = *maybe;
+    if (!filterMatrix(a, b, c, d))
+      return std::nullopt;
 
-        maybe = d.truediv(denominator);
-        if (!maybe) continue;
-        d = *maybe;
-      }
+    // The isomorphism of half edges can now be determined by starting with
+    // the half edges of this face/cell and depth-first searching through all
+    // the adjacent faces/cells until we find a contradiction.
+    auto isomorphism = HalfEdgeMap<HalfEdge>(*this);
 
-      if (!filterMatrix(a, b, c, d))
-        continue;
+    const std::function<bool(HalfEdge, HalfEdge)> match = [&](const HalfEdge from, const HalfEdge to) {
+      if (!filterHalfEdgeMap(from, to))
+        return false;
 
-      // The isomorphism of half edges can now be determined by starting with
-      // the half edges of this face/cell and depth-first searching through all
-      // the adjacent faces/cells until we find a contradiction.
-      auto isomorphism = HalfEdgeMap<HalfEdge>(*this);
+      if (isomorphism[from] != HalfEdge())
+        return isomorphism[from] == to;
 
-      const std::function<bool(HalfEdge, HalfEdge)> match = [&](const HalfEdge from, const HalfEdge to) {
-        if (!filterHalfEdgeMap(from, to))
-          return false;
+      isomorphism[from] = to;
 
-        if (isomorphism[from] != HalfEdge())
-          return isomorphism[from] == to;
+      if (this->fromHalfEdge(from).x() * a + this->fromHalfEdge(from).y() * b != other.fromHalfEdge(to).x())
+        return false;
 
-        isomorphism[from] = to;
+      if (this->fromHalfEdge(from).x() * c + this->fromHalfEdge(from).y() * d != other.fromHalfEdge(to).y())
+        return false;
 
-        if (this->fromHalfEdge(from).x() * a + this->fromHalfEdge(from).y() * b != other.fromHalfEdge(to).x())
-          return false;
+      // We found that this half edge is mapped in a consistent way. Now
+      // check its negative.
+      if (!match(-from, -to))
+        return false;
 
-        if (this->fromHalfEdge(from).x() * c + this->fromHalfEdge(from).y() * d != other.fromHalfEdge(to).y())
-          return false;
+      // And check that every other edge in its face/cell maps consistently
+      if (!match(nextInCell(from), nextInImageCell(to)))
+        return false;
 
-        // We found that this half edge is mapped in a consistent way. Now
-        // check its negative.
-        if (!match(-from, -to))
-          return false;
+      return true;
+    };
 
-        // And check that every other edge in its face/cell maps consistently
-        if (!match(nextInCell(from), nextInImageCell(to)))
-          return false;
+    if (match(preimage, image))
+      return isomorphism;
 
-        return true;
-      };
+    return std::nullopt;
+  };
 
-      if (match(preimage, image))
-        return TransformationDeformation<FlatTriangulation>::make(other.clone(), std::move(isomorphism));
-    }
+  // The images that are compatible with the cheap invariants above.
+  std::vector<std::pair<HalfEdge, int>> candidates;
+  for (auto image : other.halfEdges()) {
+    if (ignoreImage(image))
+      continue;
+
+    if (imageVertices.at(Vertex::source(image, other)) != preimageVertex)
+      continue;
+
+    const auto imageCells = std::pair{cellDegree(other, ignoreImage, image), cellDegree(other, ignoreImage, -image)};
+
+    // A transformation with negative determinant swaps the cells on the
+    // left and right of the half edge.
+    if (imageCells == preimageCells)
+      candidates.push_back({image, 1});
+    if (imageCells == std::pair{preimageCells.second, preimageCells.first})
+      candidates.push_back({image, -1});
   }
 
-  return std::nullopt;
-}
+  std::optional<HalfEdgeMap<HalfEdge>> isomorphism;
 
-template <typename T>
-ImplementationOf<FlatTriangulation<T>>::ImplementationOf(FlatTriangulationCombinatorial &&combinatorial, const std::function<Vector<T>(HalfEdge)> &vectors) :
-  ImplementationOf<FlatTriangulationCombinatorial>(
-      ImplementationOf<FlatTriangulationCombinatorial>::self(combinatorial)->vertices,
-      combinatorial.halfEdges() | rx::filter([&](HalfEdge he) { return combinatorial.boundary(he); }) | rx::to_vector()),
-  vectors([&]() {
-    // We keep track of the vectors attached to the half edges in a Tracked<>
-    // object. To construct such an object, we need the surface it is tracking.
-    // However, that surface is the surface we are in the process of building.
-    // In particular it is not referenced by shared pointer yet. Therefore, we
-    // now build a combinatorial triangulation from the data we are building
-    // and wrap it in a shared pointer that does *not* free its memory when it
-    // goes out of scope.
+  if (threads == 1 || candidates.size() < 2) {
+    for (const auto &[image, sgn] : candidates)
+      if ((isomorphism = candidate(image, sgn)))
+        break;
+  } else {
+    // The candidates are independent, so we check them in parallel and
+    // skip all remaining candidates once one of them succeeded.
+    std::mutex lock;
+    std::atomic<bool> found = false;
+
+    WorkStealing<std::pair<HalfEdge, int>> pool(std::min<size_t>(threads, candidates.size()));
+    for (size_t i = 0; i < candidates.size(); i++)
+      pool.push(i, candidates[i]);
+
+    pool.run([&](size_t, const std::pair<HalfEdge, int> &task) {
+      if (found)
+        return;
+
+      auto map = candidate(task.first, task.second);
+      if (!map)
+        return;
+
+      std::lock_guard<std::mutex> guard(lock);
+      if (!found) {
+        isomorphism = std::move(map);
+        found = true;
+      }
+    });
+  }
+
+  if (isomorphism)
+    return TransformationDeformation<FlatTriangulation>::make(other.clone(), std::move(*isomorphism));
+
+  return std::nullopt;
+}
+
+template <typename T>
+std::vector<Deformation<FlatTriangulation<T>>> FlatTriangulation<T>::automorphisms(ISOMORPHISM kind, std::function<bool(const T &, const T &, const T &, const T &)> filterMatrix) const {
+  LIBFLATSURF_TRACE("FlatTriangulation::automorphisms");
+
+  std::vector<Deformation<FlatTriangulation<T>>> automorphisms;
+
+  // An automorphism is determined by the image of the first half edge that
+  // isomorphism() tries to map and by the sign of the determinant of its
+  // matrix. So we force isomorphism() to consider each of these choices in
+  // turn.
+  const HalfEdge preimage = [&]() {
+    for (HalfEdge he : this->halfEdges())
+      if (kind == ISOMORPHISM::FACES || this->delaunay(he.edge()) != DELAUNAY::AMBIGUOUS)
+        return he;
+    throw std::logic_error("cannot detect isomorphism in surface without Delaunay cells");
+  }();
+
+  for (const auto image : this->halfEdges()) {
+    for (int sgn : {1, -1}) {
+      auto automorphism = isomorphism(
+          *this, kind, [&](const T &a, const T &b, const T &c, const T &d) {
+            if (sgn == 1 ? a * d - b * c < 0 : a * d - b * c > 0)
+              return false;
+            return filterMatrix(a, b, c, d);
+          },
+          [&](HalfEdge from, HalfEdge to) { return from != preimage || to == image; });
+
+      if (automorphism)
+        automorphisms.push_back(std::move(*automorphism));
+    }
+  }
+
+  return automorphisms;
+}
+
+template <typename T>
+ImplementationOf<FlatTriangulation<T>>::ImplementationOf(FlatTriangulationCombinatorial &&combinatorial, const std::function<Vector<T>(HalfEdge)> &vectors) :
+  ImplementationOf(std::move(combinatorial), OddHalfEdgeMap<Vector<T>>(combinatorial, vectors)) {}
+
+template <typename T>
+ImplementationOf<FlatTriangulation<T>>::ImplementationOf(FlatTriangulationCombinatorial &&combinatorial, std::vector<Vector<T>> &&vectors) :
+  ImplementationOf(std::move(combinatorial), OddHalfEdgeMap<Vector<T>>(combinatorial, std::move(vectors))) {}
+
+template <typename T>
+ImplementationOf<FlatTriangulation<T>>::ImplementationOf(FlatTriangulationCombinatorial &&combinatorial, OddHalfEdgeMap<Vector<T>> &&vectors) :
+  ImplementationOf<FlatTriangulationCombinatorial>(ImplementationOf<FlatTriangulationCombinatorial>::self(combinatorial)->structure),
+  vectors([&]() {
+    // We keep track of the vectors attached to the half edges in a Tracked<>
+    // object. To construct such an object, we need the surface it is tracking.
+    // However, that surface is the surface we are in the process of building.
+    // In particular it is not referenced by shared pointer yet. Therefore, we
+    // now build a combinatorial triangulation from the data we are building
+    // and wrap it in a shared pointer that does *not* free its memory when it
+    // goes out of scope.
     auto self = from_this(std::shared_ptr<ImplementationOf>(this, [](auto *) {}));
+    unifyModules(self, vectors);
     auto ret = Tracked<OddHalfEdgeMap<Vector<T>>>(
         self,
-        OddHalfEdgeMap<Vector<T>>(self, vectors),
+        std::move(vectors),
         ImplementationOf::updateAfterFlip);
     // The shared pointer we used to build the Tracked is not going to remain
     // valid so we assert that noone else is holding on to it because it won't
@@ -782,28 +1224,347 @@ ImplementationOf<FlatTriangulation<T>>::ImplementationOf(FlatTriangulationCombin
     return ret;
   }()),
   approximations([&]() {
-    // We keep track of the vectors attached to the half edges in a Tracked<>
-    // object. To construct such an object, we need the surface it is tracking.
-    // However, that surface is the surface we are in the process of building.
-    // In particular it is not referenced by shared pointer yet. Therefore, we
-    // now build a combinatorial triangulation from the data we are building
-    // and wrap it in a shared pointer that does *not* free its memory when it
-    // goes out of scope.
+    // See the comments in the construction of vectors above. The
+    // approximations are only computed when they are first needed, see
+    // approximation().
     auto self = from_this(std::shared_ptr<ImplementationOf>(this, [](auto *) {}));
-    auto ret = Tracked<OddHalfEdgeMap<Vector<exactreal::Arb>>>(
+    auto ret = Tracked<OddHalfEdgeMap<std::optional<Vector<exactreal::Arb>>>>(
         self,
-        OddHalfEdgeMap<Vector<exactreal::Arb>>(
-            self,
-            [&](const HalfEdge e) {
-              return static_cast<flatsurf::Vector<exactreal::Arb>>(this->vectors->get(e));
-            }),
-        ImplementationOf::updateApproximationAfterFlip);
-    // The shared pointer we used to build the Tracked is not going to remain
-    // valid so we assert that noone else is holding on to it because it won't
-    // work for other use cases than Tracked<>.
+        OddHalfEdgeMap<std::optional<Vector<exactreal::Arb>>>(self),
+        [](auto &cache, const auto &, HalfEdge flip) { cache.set(flip, std::nullopt); });
     ASSERT(self.self.state.use_count() == 1, "Something is holding to an short lived shared pointer to a surface. This shared pointer is not actually valid and should not be used outside of Tracked<>.");
     return ret;
-  }()) {}
+  }()),
+  preciseApproximations([&]() {
+    // See the comments in the construction of vectors above.
+    auto self = from_this(std::shared_ptr<ImplementationOf>(this, [](auto *) {}));
+    auto ret = Tracked<OddHalfEdgeMap<std::optional<Vector<exactreal::Arb>>>>(
+        self,
+        OddHalfEdgeMap<std::optional<Vector<exactreal::Arb>>>(self),
+        [](auto &cache, const auto &, HalfEdge flip) { cache.set(flip, std::nullopt); });
+    ImplementationOf<Tracked<OddHalfEdgeMap<std::optional<Vector<exactreal::Arb>>>>>::defer(ret);
+    ASSERT(self.self.state.use_count() == 1, "Something is holding to an short lived shared pointer to a surface. This shared pointer is not actually valid and should not be used outside of Tracked<>.");
+    return ret;
+  }()),
+  preciseApproximationsPrecision([&]() {
+    // See the comments in the construction of vectors above.
+    auto self = from_this(std::shared_ptr<ImplementationOf>(this, [](auto *) {}));
+    auto ret = Tracked<EdgeMap<std::optional<long long>>>(
+        self,
+        EdgeMap<std::optional<long long>>(self),
+        [](auto &cache, const auto &, HalfEdge flip) { cache[flip] = std::nullopt; });
+    ImplementationOf<Tracked<EdgeMap<std::optional<long long>>>>::defer(ret);
+    ASSERT(self.self.state.use_count() == 1, "Something is holding to an short lived shared pointer to a surface. This shared pointer is not actually valid and should not be used outside of Tracked<>.");
+    return ret;
+  }()),
+  shortestEdge([&]() {
+    // See the comments in the construction of vectors above. Flips are
+    // handled in flip() where the new vectors are known. Any other change
+    // to the affected edges forgets the shortest edge.
+    auto self = from_this(std::shared_ptr<ImplementationOf>(this, [](auto *) {}));
+    auto ret = Tracked<HalfEdge>(
+        self,
+        HalfEdge(),
+        [](HalfEdge &, const auto &, HalfEdge) {},
+        [](HalfEdge &shortest, const auto &, Edge collapse) {
+          if (shortest != HalfEdge() && Edge(shortest) == collapse)
+            shortest = HalfEdge();
+        },
+        [](HalfEdge &shortest, const auto &, HalfEdge, HalfEdge) { shortest = HalfEdge(); },
+        [](HalfEdge &shortest, const auto &, const std::vector<Edge> &) { shortest = HalfEdge(); });
+    ASSERT(self.self.state.use_count() == 1, "Something is holding to an short lived shared pointer to a surface. This shared pointer is not actually valid and should not be used outside of Tracked<>.");
+    return ret;
+  }()),
+  vertexInvariants([&]() {
+    // See the comments in the construction of vectors above. A flip does
+    // not change any angles. It adds a half edge to the vertices of the new
+    // diagonal and removes one from the vertices of the old diagonal.
+    auto self = from_this(std::shared_ptr<ImplementationOf>(this, [](auto *) {}));
+    auto ret = Tracked<VertexInvariants>(
+        self,
+        VertexInvariants(),
+        [](VertexInvariants &invariants, const auto &surface, HalfEdge flip) {
+          if (!invariants.computed)
+            return;
+          using Combinatorial = ImplementationOf<FlatTriangulationCombinatorial>;
+          invariants.degrees[Combinatorial::vertex(surface, flip)]++;
+          invariants.degrees[Combinatorial::vertex(surface, -flip)]++;
+          invariants.degrees[Combinatorial::vertex(surface, surface.previousInFace(flip))]--;
+          invariants.degrees[Combinatorial::vertex(surface, surface.previousInFace(-flip))]--;
+        },
+        [](VertexInvariants &invariants, const auto &, Edge) { invariants.clear(); },
+        // Swapping half edges does not change the vertices.
+        [](VertexInvariants &, const auto &, HalfEdge, HalfEdge) {},
+        [](VertexInvariants &invariants, const auto &, const std::vector<Edge> &) { invariants.clear(); });
+    ASSERT(self.self.state.use_count() == 1, "Something is holding to an short lived shared pointer to a surface. This shared pointer is not actually valid and should not be used outside of Tracked<>.");
+    return ret;
+  }()) {
+  if constexpr (std::is_same_v<T, long long>) {
+    columns.resize(this->structure->halfEdges.size());
+    for (const HalfEdge he : this->structure->halfEdges)
+      columns.set(he.index(), this->vectors->get(he));
+  }
+}
+
+template <typename T>
+Vector<exactreal::Arb> ImplementationOf<FlatTriangulation<T>>::approximation(HalfEdge he, slong prec) const {
+  if (prec <= exactreal::ARB_PRECISION_FAST)
+    return approximation(he);
+
+  std::lock_guard<std::mutex> guard(preciseApproximationsLock);
+
+  const auto &precision = (*preciseApproximationsPrecision)[he];
+  if (precision && *precision >= prec)
+    return *preciseApproximations->get(he);
+
+  const auto &vector = vectors->get(he);
+  preciseApproximations->set(he, Vector<exactreal::Arb>(Approximation<T>::arb(vector.x(), prec), Approximation<T>::arb(vector.y(), prec)));
+  (*preciseApproximationsPrecision)[he] = prec;
+
+  return *preciseApproximations->get(he);
+}
+
+template <typename T>
+const VertexInvariants &ImplementationOf<FlatTriangulation<T>>::invariants(const FlatTriangulation<T> &surface) {
+  std::lock_guard<std::mutex> guard(self(surface)->vertexInvariantsLock);
+
+  VertexInvariants &invariants = *self(surface)->vertexInvariants;
+  if (invariants.computed)
+    return invariants;
+
+  // Whether each half edge points into the closed right half plane. The
+  // Arb approximations usually decide this so only few exact coordinates
+  // need to be inspected.
+  std::vector<bool> right(surface.halfEdges().size());
+  for (const auto he : surface.halfEdges()) {
+    if constexpr (!std::is_same_v<T, long long>) {
+      const auto &x = surface.fromHalfEdgeApproximate(he).x();
+      const auto positive = x > 0;
+      const auto negative = x < 0;
+      if ((positive && *positive) || (negative && *negative)) {
+        right[he.index()] = *positive;
+        continue;
+      }
+    }
+    right[he.index()] = surface.fromHalfEdge(he).x() >= 0;
+  }
+
+  const auto &vertices = surface.vertices();
+  invariants.angles.assign(vertices.size(), 0);
+  invariants.degrees.assign(vertices.size(), 0);
+
+  for (const auto &vertex : vertices) {
+    const auto atVertex = surface.atVertex(vertex);
+    const size_t position = ImplementationOf<FlatTriangulationCombinatorial>::vertex(surface, atVertex[0]);
+
+    // Count how often we turn from the right to the left half plane when
+    // walking around the vertex.
+    int angle = 0;
+    for (size_t i = 0; i < atVertex.size(); i++)
+      if (right[atVertex[i].index()] && !right[atVertex[(i + 1) % atVertex.size()].index()])
+        angle++;
+
+    ASSERT(angle >= 1, "Total angle at vertex cannot be less than 2π");
+
+    invariants.angles[position] = angle;
+    invariants.degrees[position] = atVertex.size();
+  }
+
+  invariants.computed = true;
+  return invariants;
+}
+
+template <typename T>
+FmpzPool &ImplementationOf<FlatTriangulation<T>>::coefficients(const FlatTriangulation<T> &surface) {
+  return self(surface)->pool;
+}
+
+template <typename T>
+void ImplementationOf<FlatTriangulation<T>>::transform(FlatTriangulation<T> &surface, const T &a, const T &b, const T &c, const T &d) {
+  self(surface)->transform(a, b, c, d);
+}
+
+template <typename T>
+bool ImplementationOf<FlatTriangulation<T>>::delaunay(FlatTriangulation<T> &surface, const std::function<bool()> &stop, unsigned int threads) {
+  if (threads == 0)
+    threads = Executor::global().concurrency();
+
+  if (threads > 1)
+    return delaunayInRounds(surface, stop, threads);
+
+  // We run Lawson's flip algorithm: whenever an edge is not Delaunay, we flip
+  // it. Such a flip can only change the Delaunay condition for the four edges
+  // of the quadrilateral that contains the flipped edge, so only these need to
+  // be checked again.
+  std::vector<Edge> pending(surface.edges().rbegin(), surface.edges().rend());
+  std::vector<bool> queued(surface.size(), true);
+
+  // Caches that only need to forget about flipped edges are cleared once
+  // when this pass is complete; approximations are only recomputed for the
+  // edges whose Delaunay condition is checked.
+  const FlipBatch batch(*self(surface));
+
+  while (pending.size()) {
+    if (stop())
+      return false;
+
+    const Edge edge = pending.back();
+    pending.pop_back();
+    queued[edge.index()] = false;
+
+    if (surface.delaunay(edge) != DELAUNAY::NON_DELAUNAY)
+      continue;
+
+    const HalfEdge flip = edge.positive();
+    surface.flip(flip);
+
+    for (const HalfEdge side : {surface.nextInFace(flip), surface.previousInFace(flip), surface.nextInFace(-flip), surface.previousInFace(-flip)}) {
+      if (queued[side.edge().index()]) continue;
+      queued[side.edge().index()] = true;
+      pending.push_back(side.edge());
+    }
+  }
+
+  return true;
+}
+
+template <typename T>
+bool ImplementationOf<FlatTriangulation<T>>::delaunayInRounds(FlatTriangulation<T> &surface, const std::function<bool()> &stop, unsigned int threads) {
+  // The number of in-circle tests that form a single task.
+  constexpr size_t CHUNK = 256;
+
+  std::vector<Edge> pending(surface.edges().begin(), surface.edges().end());
+  std::vector<bool> queued(surface.size(), true);
+
+  // The half edges of the faces of the quadrilaterals that are flipped in
+  // the current round.
+  std::vector<bool> claimed(2 * surface.size());
+
+  const FlipBatch batch(*self(surface));
+
+  while (pending.size()) {
+    if (stop())
+      return false;
+
+    // The in-circle tests run concurrently, so they must not compute the
+    // approximations of the edges flipped in the previous round lazily.
+    self(surface)->refreshApproximations();
+
+    std::vector<char> nonDelaunay(pending.size());
+
+    const size_t chunks = (pending.size() + CHUNK - 1) / CHUNK;
+    WorkStealing<size_t> pool(std::min<size_t>(threads, chunks));
+    for (size_t chunk = 0; chunk < chunks; chunk++)
+      pool.push(chunk % pool.workers(), chunk);
+
+    pool.run([&](size_t, size_t chunk) {
+      for (size_t i = chunk * CHUNK; i < std::min(pending.size(), (chunk + 1) * CHUNK); i++)
+        nonDelaunay[i] = surface.delaunay(pending[i]) == DELAUNAY::NON_DELAUNAY;
+    });
+
+    // Pick the edges to flip. An edge is skipped when one of its faces is
+    // already claimed by another flip of this round; it is checked again in
+    // the next round.
+    std::vector<Edge> deferred;
+    std::vector<HalfEdge> flips;
+    for (size_t i = 0; i < pending.size(); i++) {
+      const Edge edge = pending[i];
+      queued[edge.index()] = false;
+
+      if (!nonDelaunay[i])
+        continue;
+
+      const HalfEdge flip = edge.positive();
+      if (claimed[flip.index()] || claimed[(-flip).index()]) {
+        deferred.push_back(edge);
+        continue;
+      }
+
+      for (const HalfEdge side : {flip, -flip})
+        for (const HalfEdge he : {side, surface.nextInFace(side), surface.previousInFace(side)})
+          claimed[he.index()] = true;
+
+      flips.push_back(flip);
+    }
+
+    for (const HalfEdge flip : flips)
+      for (const HalfEdge side : {flip, -flip})
+        for (const HalfEdge he : {side, surface.nextInFace(side), surface.previousInFace(side)})
+          claimed[he.index()] = false;
+
+    pending.clear();
+
+    for (const Edge edge : deferred) {
+      queued[edge.index()] = true;
+      pending.push_back(edge);
+    }
+
+    for (const HalfEdge flip : flips) {
+      surface.flip(flip);
+
+      for (const HalfEdge side : {surface.nextInFace(flip), surface.previousInFace(flip), surface.nextInFace(-flip), surface.previousInFace(-flip)}) {
+        if (queued[side.edge().index()]) continue;
+        queued[side.edge().index()] = true;
+        pending.push_back(side.edge());
+      }
+    }
+  }
+
+  return true;
+}
+
+template <typename T>
+PrecisionPolicy &ImplementationOf<FlatTriangulation<T>>::precision(const FlatTriangulation<T> &surface) {
+  return self(surface)->policy;
+}
+
+template <typename T>
+const VectorColumns<long long> &ImplementationOf<FlatTriangulation<T>>::coordinates(const FlatTriangulation<T> &surface) {
+  return self(surface)->columns;
+}
+
+template <typename T>
+void ImplementationOf<FlatTriangulation<T>>::connections(const FlatTriangulation<T> &surface, const std::function<void(SaddleConnectionsCache<FlatTriangulation<T>> &)> &f) {
+  auto &impl = *self(surface);
+
+  std::lock_guard<std::mutex> guard(impl.connectionsCacheLock);
+
+  if (!impl.connectionsCache) {
+    using Cache = SaddleConnectionsCache<FlatTriangulation<T>>;
+    impl.connectionsCache = std::make_shared<Tracked<Cache>>(surface, Cache{}, Cache::clearAfterFlip, Cache::clearBeforeCollapse, Cache::clearBeforeSwap, Cache::clearBeforeErase);
+  }
+
+  f(**impl.connectionsCache);
+}
+
+template <typename T>
+std::shared_ptr<ImplementationOf<Vertical<FlatTriangulation<T>>>> ImplementationOf<FlatTriangulation<T>>::vertical(const FlatTriangulation<T> &surface, const Vector<T> &vertical, const std::function<std::shared_ptr<ImplementationOf<Vertical<FlatTriangulation<T>>>>()> &make) {
+  auto &impl = *self(surface);
+
+  std::lock_guard<std::mutex> guard(impl.verticalsLock);
+
+  auto &shared = impl.verticals[vertical];
+  if (auto existing = shared.lock())
+    return existing;
+
+  auto created = make();
+  shared = created;
+
+  // Forget about the verticals that are not alive anymore.
+  for (auto it = begin(impl.verticals); it != end(impl.verticals);) {
+    if (it->second.expired())
+      it = impl.verticals.erase(it);
+    else
+      it++;
+  }
+
+  return created;
+}
+
+template <typename T>
+FlatTriangulation<T> ImplementationOf<FlatTriangulation<T>>::make(FlatTriangulationCombinatorial &&combinatorial, const std::function<Vector<T>(HalfEdge)> &vectors) {
+  return FlatTriangulation<T>(ProtectedConstructor{}, std::move(combinatorial), vectors);
+}
 
 template <typename T>
 void ImplementationOf<FlatTriangulation<T>>::updateAfterFlip(OddHalfEdgeMap<Vector<T>> &vectors, const FlatTriangulationCombinatorial &parent, HalfEdge flip) {
@@ -811,9 +1572,616 @@ void ImplementationOf<FlatTriangulation<T>>::updateAfterFlip(OddHalfEdgeMap<Vect
 }
 
 template <typename T>
-void ImplementationOf<FlatTriangulation<T>>::updateApproximationAfterFlip(OddHalfEdgeMap<flatsurf::Vector<exactreal::Arb>> &vectors, const FlatTriangulationCombinatorial &combinatorial, HalfEdge flip) {
-  const auto &surface = reinterpret_cast<const FlatTriangulation<T> &>(combinatorial);
-  vectors.set(flip, static_cast<flatsurf::Vector<exactreal::Arb>>(surface.fromHalfEdge(-surface.nextInFace(flip)) + surface.fromHalfEdge(-surface.previousInFace(flip))));
+void ImplementationOf<FlatTriangulation<T>>::shift(FlatTriangulation<T> &surface, Tracked<OddHalfEdgeMap<Vector<T>>> &remaining, EdgeSet &collapsing) {
+  auto schedule = std::make_unique<FlipSchedule>(surface, *remaining);
+
+  while (true) {
+    const auto flip = schedule->next();
+
+    if (!flip) {
+      collapsing = schedule->collapsing();
+      return;
+    }
+
+    // We want to flip the half edge that we found needs to be flipped first.
+    // However, just flipping that edge right now might lead to infinite loops
+    // where the same edges get flipped again and again without making any
+    // progress. So instead we get a bit closer to the critical time and
+    // perform the flip just then.
+    // Note that this also solves the problem that the flip might not actually
+    // be possibly as it might lead to a non-convex triangulation since
+    // eventually, when we are close enough to the critical time, the flip will
+    // be valid.
+    // Note that this leads to quite some coefficient blow-up along the way;
+    // every flip introduces a factor of two in the denominators. These
+    // coefficients go away in the final surface. It would likely be more
+    // efficient not to move before the flip if this still makes the critical
+    // time t increase.
+    const auto t = *flip->det.root(exactreal::ARB_PRECISION_FAST);
+
+    for (auto s = mpq_class(1, 2);; s /= 2) {
+      const auto lt = exactreal::Arb(s, exactreal::ARB_PRECISION_FAST) < t;
+      if (lt && *lt) {
+        const OddHalfEdgeMap<Vector<T>> partial(surface, [&](const HalfEdge he) { return remaining->get(he) / s.get_den(); });
+
+        // With integer coordinates, the division above might not be exact.
+        const bool exact = surface.edges() | rx::all_of([&](const Edge e) { return partial.get(e.positive()) * s.get_den() == remaining->get(e.positive()); });
+
+        for (const Edge e : surface.edges())
+          remaining->set(e.positive(), remaining->get(e.positive()) - partial.get(e.positive()));
+
+        if (exact) {
+          // Since we stop before the first critical time, no triangle
+          // degenerates on the way. Also, the events in the schedule stay
+          // in the same order, so there is nothing to update.
+          self(surface)->deform([&](const HalfEdge he) { return surface.fromHalfEdge(he) + partial.get(he); });
+        } else {
+          // Otherwise, partial is not a multiple of the shift, so we have to
+          // treat it as a shift of its own and start over afterwards.
+          surface += partial;
+          schedule = std::make_unique<FlipSchedule>(surface, *remaining);
+        }
+
+        if (surface.convex(flip->flip, true))
+          schedule->flip(surface, flip->flip);
+
+        break;
+      }
+    }
+  }
+}
+
+template <typename T>
+ImplementationOf<FlatTriangulation<T>>::FlipSchedule::FlipSchedule(const FlatTriangulation<T> &surface, const OddHalfEdgeMap<Vector<T>> &shift) :
+  surface(surface),
+  shift(shift),
+  events(Earlier{this}),
+  scheduled(surface.halfEdges().size()) {
+  for (const auto he : surface.halfEdges())
+    schedule(he);
+}
+
+template <typename T>
+std::optional<typename ImplementationOf<FlatTriangulation<T>>::Flip> ImplementationOf<FlatTriangulation<T>>::FlipSchedule::next() const {
+  if (events.empty())
+    return std::nullopt;
+
+  const HalfEdge corner = *begin(events);
+  return Flip{surface.nextInFace(corner), det(corner)};
+}
+
+template <typename T>
+void ImplementationOf<FlatTriangulation<T>>::FlipSchedule::flip(FlatTriangulation<T> &surface, HalfEdge e) {
+  ASSERT(&surface == &this->surface, "can only flip half edges of the surface this schedule was created for");
+
+  // Only the corners that contain e or -e before or after the flip change,
+  // i.e., the corners formed by the half edges of the faces next to e.
+  const auto corners = [&]() {
+    const HalfEdge a = surface.nextInFace(e);
+    const HalfEdge c = surface.nextInFace(-e);
+    return std::array<HalfEdge, 6>{e, a, surface.nextInFace(a), -e, c, surface.nextInFace(c)};
+  };
+
+  for (const auto corner : corners())
+    unschedule(corner);
+
+  surface.flip(e);
+
+  for (const auto corner : corners())
+    schedule(corner);
+}
+
+template <typename T>
+EdgeSet ImplementationOf<FlatTriangulation<T>>::FlipSchedule::collapsing() const {
+  EdgeSet collapsing;
+  for (const auto he : surface.halfEdges())
+    if (collapses(he))
+      collapsing.insert(he);
+  return collapsing;
+}
+
+template <typename T>
+QuadraticPolynomial<T> ImplementationOf<FlatTriangulation<T>>::FlipSchedule::det(HalfEdge he) const {
+  const HalfEdge he_ = surface.nextAtVertex(he);
+
+  // The x, y coordinates of the half edge he
+  const auto x = [&](const HalfEdge he) { return surface.fromHalfEdge(he).x(); };
+  const auto y = [&](const HalfEdge he) { return surface.fromHalfEdge(he).y(); };
+  // The x, y shifts of the half edge he at time t = 1
+  const auto u = [&](const HalfEdge he) { return shift.get(he).x(); };
+  const auto v = [&](const HalfEdge he) { return shift.get(he).y(); };
+
+  // The determinant of the vectors spanned by the edges he and he_ at time
+  // t is given by a*t^2 - b*t + c.
+  return QuadraticPolynomial<T>(
+      u(he) * v(he_) - u(he_) * v(he),
+      u(he) * y(he_) - u(he_) * y(he) + x(he) * v(he_) - x(he_) * v(he),
+      x(he) * y(he_) - x(he_) * y(he));
+}
+
+template <typename T>
+bool ImplementationOf<FlatTriangulation<T>>::FlipSchedule::collapses(HalfEdge he) const {
+  // One reason why the area of a triangle is zero for a time t in [0, 1] is
+  // that two singularities were shifted into each other. We can make sense
+  // of this when it happens at time t=1 by collapsing triangles.
+  if (surface.fromHalfEdge(he).ccw(shift.get(he)) != CCW::COLLINEAR)
+    return false;
+
+  switch (surface.fromHalfEdge(he).orientation(surface.fromHalfEdge(he) + shift.get(he))) {
+    case ORIENTATION::SAME:
+      // The critical time t is not in [0, 1]
+      return false;
+    case ORIENTATION::OPPOSITE:
+      throw std::invalid_argument("shift must not collapse half edges for a time t in (0, 1)");
+    case ORIENTATION::ORTHOGONAL:
+      return true;
+  }
+
+  UNREACHABLE("unknown orientation");
+}
+
+template <typename T>
+void ImplementationOf<FlatTriangulation<T>>::FlipSchedule::schedule(HalfEdge he) {
+  unschedule(he);
+
+  const HalfEdge he_ = surface.nextAtVertex(he);
+
+  // The more common reason why the area of a triangle is zero is that a
+  // singularity is shifted onto the interior of an edge. When this happens
+  // we can flip that edge just before to make sure that our triangulation
+  // remains valid at all times.
+  const auto det = this->det(he);
+
+  ASSERT(det(T()) > 0, "Original surface " << surface << " already had a triangle with non-positive area before applying any shift to it.");
+
+  // If the determinant has a zero for any t in [0, 1], the area of a
+  // triangle vanishes or becomes negative.
+  // We handle the easiest case first: the area remains positive for all
+  // times t in [0, 1].
+  if (det.positive())
+    return;
+
+  // We can now assume that the determinant is zero for some t in (0, 1].
+  // We need to flip a half edge of this triangle if it has a vertex on its
+  // interior at that critical time t.
+
+  // But first we exclude the case that
+  // the vertex ends up on the boundary of the half edge, i.e., a half edge
+  // collapses.
+  if (collapses(he) || collapses(he_))
+    return;
+
+  // Determine whether our vertex moves onto the half edge opposite to it,
+  // i.e., the one following he in this triangle.
+  const auto vertex_hits_interior = [&]() {
+    for (long prec = exactreal::ARB_PRECISION_FAST;; prec *= 2) {
+      const auto t = det.root(prec);
+      const auto arb = Approximation<T>::arb;
+      ASSERT(t, "determinant " << det << " must have a root in [0, 1]");
+      const auto e = self(surface)->approximation(he, prec);
+      const auto e_ = self(surface)->approximation(he_, prec);
+      const auto et = Vector<exactreal::Arb>(
+          (e.x() + *t * arb(shift.get(he).x(), prec))(prec),
+          (e.y() + *t * arb(shift.get(he).y(), prec))(prec));
+      const auto e_t = Vector<exactreal::Arb>(
+          (e_.x() + *t * arb(shift.get(he_).x(), prec))(prec),
+          (e_.y() + *t * arb(shift.get(he_).y(), prec))(prec));
+
+      const auto orientation = et.orientation(e_t);
+
+      if (orientation) {
+        switch (*orientation) {
+          case ORIENTATION::ORTHOGONAL:
+            UNREACHABLE("vectors cannot be orthogonal when their determinant is vanishing");
+          case ORIENTATION::SAME:
+            // The half edges he and he_ meet but the vertex at their source
+            // does not end up on the interior of the half edge opposite to
+            // it. We can ignore this case as another vertex will take care
+            // of this vanishing triangle.
+            return false;
+          case ORIENTATION::OPPOSITE:
+            // The two edges attached to this vertex point in opposite
+            // directions at time t so this vertex ends up on the interior
+            // of the opposite edge.
+            return true;
+        }
+      }
+    }
+  };
+
+  if (!vertex_hits_interior())
+    // The half edge following e does not need to be flipped.
+    return;
+
+  // Record that the half edge following he needs to be flipped at time t.
+  scheduled[he.index()] = events.insert(he);
+}
+
+template <typename T>
+void ImplementationOf<FlatTriangulation<T>>::FlipSchedule::unschedule(HalfEdge he) {
+  auto &position = scheduled[he.index()];
+  if (position) {
+    events.erase(*position);
+    position.reset();
+  }
+}
+
+template <typename T>
+bool ImplementationOf<FlatTriangulation<T>>::FlipSchedule::Earlier::operator()(HalfEdge lhs, HalfEdge rhs) const {
+  return schedule->det(lhs) < schedule->det(rhs);
+}
+
+template <typename T>
+FlatTriangulation<T> ImplementationOf<FlatTriangulation<T>>::insertAt(FlatTriangulation<T> &surface, HalfEdge &nextTo, const Vector<T> &slit, std::vector<HalfEdge> &tracked) {
+  auto check_orientation = [&](const Vector<T> &saddle_connection) {
+    auto orient = (saddle_connection - slit).orientation(slit);
+    CHECK_ARGUMENT(orient != ORIENTATION::OPPOSITE, "cannot insert half edge that crosses over an existing vertex");
+    if (orient == ORIENTATION::ORTHOGONAL) {
+      // It is a bit unclear what to do if the new edge should end at a
+      // vertex, in particular if it is collinear with an existing half
+      // edge (after fliping.)
+      throw std::logic_error("insertion of half edges that end at an existing vertex not implemented yet");
+    }
+  };
+
+  // Search for half edges that slit would be crossing and flip them.
+  // We should replace all this with a simple call to operator+, see #183.
+  {
+    // When a tracked half edge is flipped, it leaves its vertex. We replace
+    // it with the half edge preceding it at that vertex, i.e., the sector
+    // next to the replacement is the union of the sectors before and after
+    // the flipped half edge.
+    std::vector<Tracked<HalfEdge>> tracking;
+    for (const auto he : tracked)
+      tracking.emplace_back(surface, he, [](HalfEdge &self, const FlatTriangulationCombinatorial &parent, HalfEdge flip) {
+        if (Edge(self) == Edge(flip))
+          self = parent.previousInFace(self);
+      });
+
+    [&]() {
+      const typename ImplementationOf<FlatTriangulation<T>>::FlipBatch batch(*surface.self);
+
+      while (true) {
+        if (surface.fromHalfEdge(nextTo).ccw(slit) == CCW::COLLINEAR) {
+          check_orientation(surface.fromHalfEdge(nextTo));
+          // Slot is on an existing HalfEdge but does not cross a vertex.
+          return;
+        }
+        assert(surface.fromHalfEdge(nextTo).ccw(slit) == CCW::COUNTERCLOCKWISE);
+
+        // The half edge that slit is potentially crossing
+        const HalfEdge crossing = surface.nextInFace(nextTo);
+        // The base point of crossing half edge
+        const Vector<T> base = surface.fromHalfEdge(nextTo);
+
+        // Check whether slit is actually crossing crossing. It would be enough
+        // to check whether this is != CLOCKWISE. However, we do not allow slit
+        // to end on an edge other than nextTo. So we perform one additional
+        // flip in that case so slit is actually inside of a face.
+        if (surface.fromHalfEdge(crossing).ccw(slit - base) == CCW::COUNTERCLOCKWISE)
+          return;
+
+        std::function<void(HalfEdge)> flip = [&](HalfEdge e) {
+          assert(e != nextTo && e != -nextTo && e != surface.nextAtVertex(nextTo) && e != -surface.nextAtVertex(nextTo));
+
+          auto canFlip = [&](HalfEdge g) {
+            return e != nextTo && e != -nextTo && e != surface.nextAtVertex(nextTo) && e != -surface.nextAtVertex(nextTo) &&
+                   surface.fromHalfEdge(surface.previousAtVertex(g)).ccw(surface.fromHalfEdge(surface.nextAtVertex(g))) == CCW::COUNTERCLOCKWISE && surface.fromHalfEdge(surface.previousAtVertex(-g)).ccw(surface.fromHalfEdge(surface.nextAtVertex(-g))) == CCW::COUNTERCLOCKWISE;
+          };
+
+          while (!canFlip(e)) {
+            // f is blocked by a forward triangle on top of it so we flip its top edge.
+            if (slit.ccw(surface.fromHalfEdge(surface.previousAtVertex(e))) != CCW::COUNTERCLOCKWISE) {
+              flip(-surface.nextAtVertex(-e));
+              continue;
+            } else {
+              assert(slit.ccw(surface.fromHalfEdge(surface.nextAtVertex(-e))) != CCW::CLOCKWISE);
+              flip(surface.previousAtVertex(e));
+              continue;
+            }
+          }
+
+          surface.flip(e);
+        };
+
+        // slit crosses crossing, so flip it and replace nextTo if slit is then not next to nextTo anymore.
+        flip(crossing);
+        assert(surface.fromHalfEdge(nextTo).ccw(slit) == CCW::COUNTERCLOCKWISE);
+        while (surface.fromHalfEdge(surface.nextAtVertex(nextTo)).ccw(slit) != CCW::CLOCKWISE)
+          nextTo = surface.nextAtVertex(nextTo);
+      }
+    }();
+
+    for (size_t i = 0; i < tracked.size(); i++)
+      tracked[i] = *tracking[i];
+  }
+
+  auto symmetric = [](HalfEdge x, HalfEdge e, const Vector<T> &v) {
+    assert(x == e || x == -e);
+    return x == e ? v : -v;
+  };
+
+  if (surface.fromHalfEdge(nextTo).ccw(slit) != CCW::COLLINEAR) {
+    // After the flips we did, v is now completely inside a face.
+    assert(surface.fromHalfEdge(nextTo).ccw(slit) == CCW::COUNTERCLOCKWISE);
+
+    auto combinatorial = static_cast<FlatTriangulationCombinatorial &>(surface).insertAt(nextTo);
+
+    return ImplementationOf<FlatTriangulation<T>>::make(combinatorial.clone(), [&](const HalfEdge e) {
+      HalfEdge a = -combinatorial.nextAtVertex(nextTo);
+      HalfEdge b = combinatorial.nextAtVertex(a);
+      HalfEdge c = combinatorial.nextAtVertex(b);
+
+      if (Edge(e) == a) return symmetric(e, a, -slit);
+      if (Edge(e) == b) return symmetric(e, b, surface.fromHalfEdge(nextTo) - slit);
+      if (Edge(e) == c) return symmetric(e, c, surface.fromHalfEdge(surface.nextAtVertex(nextTo)) - slit);
+      return surface.fromHalfEdge(e);
+    });
+  } else {
+    // After the flips we did, v is collinear with the half edge e (but shorter.)
+
+    // Insert our half edge ee next to e
+    auto combinatorial = static_cast<FlatTriangulationCombinatorial &>(surface).insertAt(nextTo);
+    auto nextAtSlot = combinatorial.nextAtVertex(nextTo);
+    // After a flip of slit the original slit can be recovered as nextAtSlot + eee.
+    combinatorial.flip(nextTo);
+    for (auto &he : tracked)
+      if (Edge(he) == Edge(nextTo))
+        he = combinatorial.previousInFace(he);
+    auto eee = combinatorial.nextAtVertex(combinatorial.nextAtVertex(-nextAtSlot));
+
+    // The combinatorics are correct now, but we still have to patch up the
+    // vectors, namely the four half edges meeting at the new vertex all need
+    // updating.
+    auto ret = ImplementationOf<FlatTriangulation<T>>::make(combinatorial.clone(), [&](const HalfEdge e) {
+      if (Edge(e) == nextAtSlot) return symmetric(e, nextAtSlot, slit);
+      if (Edge(e) == eee) return symmetric(e, eee, surface.fromHalfEdge(nextTo) - slit);
+      if (Edge(e) == combinatorial.nextAtVertex(-nextAtSlot)) return symmetric(e, combinatorial.nextAtVertex(-nextAtSlot), surface.fromHalfEdge(surface.previousAtVertex(nextTo)) - slit);
+      if (Edge(e) == combinatorial.nextAtVertex(eee)) return symmetric(e, combinatorial.nextAtVertex(eee), surface.fromHalfEdge(surface.nextAtVertex(nextTo)) - slit);
+      return surface.fromHalfEdge(e);
+    });
+
+    nextTo = combinatorial.previousAtVertex(nextAtSlot);
+
+    return ret;
+  }
+}
+
+template <typename T>
+void ImplementationOf<FlatTriangulation<T>>::deform(const std::function<Vector<T>(HalfEdge)> &vector) {
+  for (const Edge e : this->structure->edges)
+    vectors->set(e.positive(), vector(e.positive()));
+
+  // The approximations are recomputed when they are needed again, see
+  // approximation().
+  {
+    std::lock_guard<std::mutex> guard(approximationsLock);
+    for (const Edge e : this->structure->edges)
+      approximations->set(e.positive(), std::nullopt);
+    approximated = false;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(preciseApproximationsLock);
+    for (const Edge e : this->structure->edges) {
+      preciseApproximations->set(e.positive(), std::nullopt);
+      (*preciseApproximationsPrecision)[e] = std::nullopt;
+    }
+  }
+
+  if constexpr (std::is_same_v<T, long long>) {
+    for (const HalfEdge he : this->structure->halfEdges)
+      columns.set(he.index(), vectors->get(he));
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(shortestEdgeLock);
+    *shortestEdge = HalfEdge();
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(areaLock);
+    area = std::nullopt;
+  }
+
+  {
+    // Existing verticals are not updated, but new verticals should not pick
+    // up their outdated caches.
+    std::lock_guard<std::mutex> guard(verticalsLock);
+    verticals.clear();
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(connectionsCacheLock);
+    if (connectionsCache)
+      (*connectionsCache)->clear();
+  }
+
+  VALIDATE([&]() { check(); });
+}
+
+template <typename T>
+void ImplementationOf<FlatTriangulation<T>>::transform(const T &a, const T &b, const T &c, const T &d) {
+  const auto image = [&](const Vector<T> &v) {
+    return Vector<T>(T(a * v.x() + b * v.y()), T(c * v.x() + d * v.y()));
+  };
+
+  for (const Edge e : this->structure->edges)
+    vectors->set(e.positive(), image(vectors->get(e.positive())));
+
+  // Transforming the approximations is much cheaper than approximating the
+  // new coordinates, in particular for coordinates in exact-real modules.
+  // The resulting balls are slightly wider but still enclose the exact
+  // coordinates.
+  std::map<slong, std::array<exactreal::Arb, 4>> matrices;
+  const auto approximateImage = [&](const Vector<exactreal::Arb> &v, slong prec) {
+    auto matrix = matrices.find(prec);
+    if (matrix == end(matrices))
+      matrix = matrices.emplace(prec, std::array<exactreal::Arb, 4>{Approximation<T>::arb(a, prec), Approximation<T>::arb(b, prec), Approximation<T>::arb(c, prec), Approximation<T>::arb(d, prec)}).first;
+    const auto &[a_, b_, c_, d_] = matrix->second;
+    return Vector<exactreal::Arb>((a_ * v.x() + b_ * v.y())(prec), (c_ * v.x() + d_ * v.y())(prec));
+  };
+
+  {
+    std::lock_guard<std::mutex> guard(approximationsLock);
+    for (const Edge e : this->structure->edges) {
+      const auto &approximation = approximations->get(e.positive());
+      if (approximation)
+        approximations->set(e.positive(), approximateImage(*approximation, approximationsPrecision));
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(preciseApproximationsLock);
+    for (const Edge e : this->structure->edges) {
+      const auto &precision = (*preciseApproximationsPrecision)[e];
+      if (precision)
+        preciseApproximations->set(e.positive(), approximateImage(*preciseApproximations->get(e.positive()), *precision));
+    }
+  }
+
+  if constexpr (std::is_same_v<T, long long>) {
+    for (const HalfEdge he : this->structure->halfEdges)
+      columns.set(he.index(), vectors->get(he));
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(shortestEdgeLock);
+    *shortestEdge = HalfEdge();
+  }
+
+  {
+    // Areas are scaled by the determinant.
+    std::lock_guard<std::mutex> guard(areaLock);
+    if (area)
+      *area *= a * d - b * c;
+  }
+
+  {
+    // A Vertical in direction v becomes the Vertical in direction of the
+    // image of v. Since the determinant is positive, the ccw() of all half
+    // edges with respect to the vertical does not change. Also the
+    // perpendicular projections are just scaled by the determinant. (So the
+    // relative lengths of edges, i.e., their largeness, are not affected
+    // either.) The remaining caches are recomputed when needed.
+    const T det = a * d - b * c;
+
+    std::lock_guard<std::mutex> guard(verticalsLock);
+
+    std::unordered_map<Vector<T>, std::weak_ptr<ImplementationOf<Vertical<FlatTriangulation<T>>>>> images;
+    for (const auto &[direction, shared] : verticals) {
+      const auto vertical = shared.lock();
+      if (!vertical)
+        continue;
+
+      vertical->vertical = image(vertical->vertical);
+      vertical->horizontal = -vertical->vertical.perpendicular();
+      vertical->verticalApproximation = static_cast<Vector<exactreal::Arb>>(vertical->vertical);
+      vertical->horizontalApproximation = static_cast<Vector<exactreal::Arb>>(vertical->horizontal);
+
+      vertical->parallelProjectionCache->clear();
+      vertical->orientationCache->clear();
+      vertical->batched = false;
+
+      if (det != 1) {
+        auto &projections = *vertical->perpendicularProjectionCache;
+        for (const Edge e : this->structure->edges)
+          if (projections.contains(e.positive()))
+            projections.set(e.positive(), projections.get(e.positive()) * det);
+      }
+
+      images[vertical->vertical] = vertical;
+    }
+
+    verticals = std::move(images);
+  }
+
+  {
+    // Saddle connections are cached by length which is not preserved by the
+    // transformation.
+    std::lock_guard<std::mutex> guard(connectionsCacheLock);
+    if (connectionsCache)
+      (*connectionsCache)->clear();
+  }
+
+  VALIDATE([&]() { check(); });
+}
+
+template <typename T>
+void ImplementationOf<FlatTriangulation<T>>::approximate() const {
+  // We approximate all the coordinates at once so that coordinates in
+  // exact-real modules can share the approximations of the generators.
+  std::vector<T> coordinates;
+  for (const Edge e : this->structure->edges) {
+    coordinates.push_back(vectors->get(e.positive()).x());
+    coordinates.push_back(vectors->get(e.positive()).y());
+  }
+  std::vector<const T *> values;
+  for (const auto &coordinate : coordinates)
+    values.push_back(&coordinate);
+  approximationsPrecision = policy.precision();
+  auto balls = Approximation<T>::arb(values, approximationsPrecision);
+
+  for (size_t i = 0; i < this->structure->edges.size(); i++)
+    approximations->set(this->structure->edges[i].positive(), flatsurf::Vector<exactreal::Arb>(std::move(balls[2 * i]), std::move(balls[2 * i + 1])));
+}
+
+template <typename T>
+const Vector<exactreal::Arb> &ImplementationOf<FlatTriangulation<T>>::approximation(HalfEdge he) const {
+  if (!approximated.load(std::memory_order_acquire)) {
+    // The surface might be shared between threads, so we make sure that the
+    // approximations are only computed once.
+    std::lock_guard<std::mutex> guard(approximationsLock);
+    if (!approximated.load(std::memory_order_relaxed)) {
+      approximate();
+      approximated.store(true, std::memory_order_release);
+    }
+  }
+
+  const auto &cached = approximations->get(he);
+  if (cached)
+    return *cached;
+
+  ASSERT(flipBatches, "approximations can only be missing while a FlipBatch is open");
+
+  // Both coordinates typically live in the same module so we approximate
+  // them together.
+  const T x = vectors->get(he).x(), y = vectors->get(he).y();
+  auto coordinates = Approximation<T>::arb({&x, &y}, approximationsPrecision);
+  approximations->set(he, flatsurf::Vector<exactreal::Arb>(std::move(coordinates[0]), std::move(coordinates[1])));
+  return *approximations->get(he);
+}
+
+template <typename T>
+void ImplementationOf<FlatTriangulation<T>>::refreshApproximations() const {
+  // Approximate each half edge that is still missing its approximation
+  // once; edges that have been flipped repeatedly appear several times in
+  // staleApproximations.
+  for (const HalfEdge he : staleApproximations)
+    approximation(he);
+  staleApproximations.clear();
+}
+
+template <typename T>
+ImplementationOf<FlatTriangulation<T>>::FlipBatch::FlipBatch(const ImplementationOf &surface) :
+  surface(surface),
+  transaction(surface) {
+  if (surface.flipBatches == 0 && surface.approximated && surface.policy.precision() != surface.approximationsPrecision) {
+    // The surface is about to change anyway, so this is a good time to
+    // switch the approximations to a new working precision.
+    std::lock_guard<std::mutex> guard(surface.approximationsLock);
+    surface.approximate();
+  }
+
+  surface.flipBatches++;
+}
+
+template <typename T>
+ImplementationOf<FlatTriangulation<T>>::FlipBatch::~FlipBatch() {
+  if (surface.flipBatches == 1)
+    surface.refreshApproximations();
+
+  surface.flipBatches--;
 }
 
 template <typename T>
@@ -824,7 +2192,43 @@ void ImplementationOf<FlatTriangulation<T>>::flip(HalfEdge e) {
 
   ImplementationOf<FlatTriangulationCombinatorial>::flip(e);
 
-  check();
+  // The flip invalidated the approximation of e. Inside a FlipBatch, it is
+  // only recomputed when needed. If no approximations have been computed
+  // yet, there is nothing to maintain.
+  if (approximated) {
+    if (flipBatches)
+      staleApproximations.push_back(e);
+    else
+      approximation(e);
+  }
+
+  if constexpr (std::is_same_v<T, long long>) {
+    columns.set(e.index(), vectors->get(e));
+    columns.set((-e).index(), vectors->get(-e));
+  }
+
+  // Only the flipped edge changed its length, so the shortest edge can be
+  // updated with a single comparison unless the flipped edge was the
+  // shortest one. Ties are broken by the index of the edge, just like the
+  // scan in shortest() does.
+  {
+    std::lock_guard<std::mutex> guard(shortestEdgeLock);
+    HalfEdge &shortest = *shortestEdge;
+    if (shortest != HalfEdge()) {
+      if (Edge(shortest) == Edge(e)) {
+        shortest = HalfEdge();
+      } else {
+        const auto &flipped = vectors->get(Edge(e).positive());
+        const auto &current = vectors->get(shortest);
+        const auto flippedLength = flipped * flipped;
+        const auto currentLength = current * current;
+        if (flippedLength < currentLength || (flippedLength == currentLength && Edge(e).index() < Edge(shortest).index()))
+          shortest = Edge(e).positive();
+      }
+    }
+  }
+
+  VALIDATE([&]() { check(); });
 }
 
 template <typename T>
@@ -840,7 +2244,18 @@ void ImplementationOf<FlatTriangulation<T>>::check() {
     zero += self.fromHalfEdge(edge);
     edge = self.nextInFace(edge);
     zero += self.fromHalfEdge(edge);
-    CHECK_ARGUMENT(!zero, "face at " << edge << " is not closed in " << self);
+    if constexpr (std::is_same_v<T, double>) {
+      // Floating point coordinates do not close up exactly after rounding,
+      // so we only require the face to close up to the size of its edges.
+      double size = 0;
+      for (int i = 0; i < 3; i++) {
+        edge = self.nextInFace(edge);
+        size = std::max({size, std::abs(self.fromHalfEdge(edge).x()), std::abs(self.fromHalfEdge(edge).y())});
+      }
+      CHECK_ARGUMENT(std::abs(zero.x()) <= FLOAT_EPSILON * size && std::abs(zero.y()) <= FLOAT_EPSILON * size, "face at " << edge << " is not closed in " << self);
+    } else {
+      CHECK_ARGUMENT(!zero, "face at " << edge << " is not closed in " << self);
+    }
   }
   // check that faces are oriented correctly
   for (auto edge : self.halfEdges()) {
@@ -862,4 +2277,4 @@ std::ostream &operator<<(std::ostream &os, const FlatTriangulation<T> &self) {
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), FlatTriangulation, LIBFLATSURF_REAL_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), FlatTriangulation, LIBFLATSURF_GEOMETRY_TYPES)
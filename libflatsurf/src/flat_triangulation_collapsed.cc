@@ -56,7 +56,6 @@
 #include "impl/flat_triangulation_combinatorial.impl.hpp"
 #include "impl/saddle_connection.impl.hpp"
 #include "util/assert.ipp"
-#include "util/union_find.ipp"
 
 namespace flatsurf {
 
@@ -72,7 +71,7 @@ FlatTriangulationCollapsed<T>::FlatTriangulationCollapsed(const FlatTriangulatio
   FlatTriangulationCombinatorics<FlatTriangulationCollapsed>(ProtectedConstructor{}, std::make_shared<ImplementationOf<FlatTriangulationCollapsed>>(surface, vertical)) {
   while ([&]() {
     for (auto e : this->halfEdges()) {
-      if (this->vertical().ccw(e) == CCW::COLLINEAR) {
+      if (self->ccw(e) == CCW::COLLINEAR) {
         self->collapse(e);
         return true;
       }
@@ -110,24 +109,23 @@ const SaddleConnection<FlatTriangulation<T>>& FlatTriangulationCollapsed<T>::fro
 }
 
 template <typename T>
-Path<FlatTriangulation<T>> FlatTriangulationCollapsed<T>::cross(HalfEdge e) const {
-  const auto connections = self->collapsedHalfEdges->operator[](e).connections;
-  return connections | rx::to_vector();
+const Path<FlatTriangulation<T>>& FlatTriangulationCollapsed<T>::cross(HalfEdge e) const {
+  return self->collapsedHalfEdges->operator[](e).connections;
 }
 
 template <typename T>
 Path<FlatTriangulation<T>> FlatTriangulationCollapsed<T>::turn(HalfEdge from, HalfEdge to) const {
-  std::vector<SaddleConnection> connections;
+  Path<FlatTriangulation<T>> connections;
 
   CHECK_ARGUMENT(Vertex::source(from, *this) == Vertex::source(to, *this), "can only turn between half edges starting at the same vertex but " << from << " and " << to << " do not start at the same vertex");
 
   while (from != to) {
-    for (auto connection : cross(from))
+    for (const auto& connection : cross(from))
       connections.push_back(connection);
     from = this->previousAtVertex(from);
   }
 
-  ASSERT(std::unordered_set<SaddleConnection>(begin(connections), end(connections)).size() == connections.size(), "collapsed connections cannot appear twice when turning around a vertex");
+  ASSERT(connections.simple(), "collapsed connections cannot appear twice when turning around a vertex");
 
   return connections;
 }
@@ -145,7 +143,7 @@ bool FlatTriangulationCollapsed<T>::operator==(const FlatTriangulationCollapsed<
 template <typename T>
 ImplementationOf<FlatTriangulationCollapsed<T>>::ImplementationOf(const FlatTriangulation<T>& surface, const Vector<T>& vertical) :
   ImplementationOf<FlatTriangulationCombinatorial>(
-      ImplementationOf<FlatTriangulationCombinatorial>::self(static_cast<const FlatTriangulationCombinatorial&>(surface))->vertices,
+      ImplementationOf<FlatTriangulationCombinatorial>::self(static_cast<const FlatTriangulationCombinatorial&>(surface))->structure->vertices,
       surface.halfEdges() | rx::filter([&](HalfEdge he) { return surface.boundary(he); }) | rx::to_vector()),
   original(surface),
   vertical(vertical),
@@ -193,6 +191,11 @@ ImplementationOf<FlatTriangulationCollapsed<T>>::ImplementationOf(const FlatTria
     return ret;
   }()) {}
 
+template <typename T>
+CCW ImplementationOf<FlatTriangulationCollapsed<T>>::ccw(HalfEdge e) const {
+  return vertical.ccw(static_cast<const Vector<T>&>(vectors->operator[](e)));
+}
+
 template <typename T>
 T ImplementationOf<FlatTriangulationCollapsed<T>>::area() {
   auto self = from_this();
@@ -285,9 +288,9 @@ void ImplementationOf<FlatTriangulationCollapsed<T>>::updateBeforeCollapse(HalfE
 
   HalfEdge collapse = collapse_.positive();
 
-  ASSERT(surface.vertical().ccw(collapse) == CCW::COLLINEAR, "cannot collapse non-vertical edge " << collapse);
+  ASSERT(surface.self->vertical.ccw(static_cast<const Vector<T>&>(vectors[collapse])) == CCW::COLLINEAR, "cannot collapse non-vertical edge " << collapse);
 
-  if (surface.vertical().orientation(collapse) == ORIENTATION::OPPOSITE)
+  if (surface.self->vertical.orientation(static_cast<const Vector<T>&>(vectors[collapse])) == ORIENTATION::OPPOSITE)
     collapse = -collapse;
 
   auto& collapsedHalfEdges = surface.self->collapsedHalfEdges;
@@ -409,12 +412,12 @@ void ImplementationOf<FlatTriangulationCollapsed<T>>::flip(HalfEdge e) {
   CHECK_ARGUMENT(self.vertical().large(e), "in a CollapsedSurface, only large edges can be flipped");
   CHECK_ARGUMENT(self.nextInFace(self.nextInFace(self.nextInFace(e))) == e && self.nextInFace(self.nextInFace(self.nextInFace(-e))) == -e, "in a CollapsedSurface, only edges that are not in a collapsed face can be fliped");
 
-  if (self.vertical().ccw(e) == CCW::COUNTERCLOCKWISE)
+  if (ccw(e) == CCW::COUNTERCLOCKWISE)
     e = -e;
 
   ImplementationOf<FlatTriangulationCombinatorial>::flip(e);
 
-  ASSERT(area() == self.area(), "Area inconsistent after flip of edge. Area is " << area() << " but should still be " << self.area());
+  VALIDATE([&]() { CHECK(area() == self.area(), "Area inconsistent after flip of edge. Area is " << area() << " but should still be " << self.area()); });
   ASSERT(faceClosed(e), "Face attached to " << e << " not closed after flip in " << self);
   ASSERTIONS(([&]() {
     static thread_local AssertConnection<T> assertion;
@@ -422,7 +425,7 @@ void ImplementationOf<FlatTriangulationCollapsed<T>>::flip(HalfEdge e) {
     ASSERT(assertion(self.fromHalfEdge(e)), "Edges of Triangulation inconsistent after flip. The half edge " << e << " in the collapsed surface " << self << " claims to correspond to the " << self.fromHalfEdge(e) << ", however, there is no such saddle connection in the original surface " << original << ".");
   }));
 
-  ASSERTIONS(([&]() {
+  VALIDATE(([&]() {
     std::unordered_map<Vertex, int> vertices;
     for (auto& vertex : original->vertices())
       vertices[vertex] = 0;
@@ -436,12 +439,12 @@ void ImplementationOf<FlatTriangulationCollapsed<T>>::flip(HalfEdge e) {
     }
 
     for (auto& count : vertices) {
-      ASSERT(count.second != 0, "Vertex " << count.first << " disappeared from surface after flip; the vertex was still there in the original surface " << original << " but is gone in the collapsed surface " << self);
-      ASSERT(count.second >= 2, "Vertex " << count.first << " almost disappeared from surface after flip; the vertex was still there in the original surface " << original << " but it has only one outgoing edge in the collapsed surface " << self);
+      CHECK(count.second != 0, "Vertex " << count.first << " disappeared from surface after flip; the vertex was still there in the original surface " << original << " but is gone in the collapsed surface " << self);
+      CHECK(count.second >= 2, "Vertex " << count.first << " almost disappeared from surface after flip; the vertex was still there in the original surface " << original << " but it has only one outgoing edge in the collapsed surface " << self);
     }
   }));
 
-  if (self.vertical().ccw(e) == CCW::COLLINEAR) {
+  if (ccw(e) == CCW::COLLINEAR) {
     collapse(e);
   }
 }
@@ -452,8 +455,10 @@ std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCollapsed<T>>::c
 
   auto ret = ImplementationOf<FlatTriangulationCombinatorial>::collapse(e);
 
-  ASSERT(area() == self.area(), "Area inconsistent after collapse of edge. Area is " << area() << " but should still be " << self.area());
-  ASSERT(self.halfEdges() | rx::all_of([&](const auto e) { return faceClosed(e); }), "Some faces are not closed after collapse of edge in " << self);
+  VALIDATE([&]() {
+    CHECK(area() == self.area(), "Area inconsistent after collapse of edge. Area is " << area() << " but should still be " << self.area());
+    CHECK(self.halfEdges() | rx::all_of([&](const auto e) { return faceClosed(e); }), "Some faces are not closed after collapse of edge in " << self);
+  });
   ASSERTIONS(([&]() {
     static thread_local AssertConnection<T> assertion;
 
@@ -463,7 +468,7 @@ std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCollapsed<T>>::c
     }
   }));
 
-  ASSERTIONS(([&]() {
+  VALIDATE(([&]() {
     std::unordered_map<Vertex, int> vertices;
     for (auto& vertex : original->vertices())
       vertices[vertex] = 0;
@@ -477,8 +482,8 @@ std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCollapsed<T>>::c
     }
 
     for (auto& count : vertices) {
-      ASSERT(count.second != 0, "Vertex " << count.first << " disappeared from surface after collapse; the vertex was still there in the original surface " << original << " but is gone in the collapsed surface " << self);
-      ASSERT(count.second >= 2, "Vertex " << count.first << " almost disappeared from surface after collapse; the vertex was still there in the original surface " << original << " but it has only one outgoing edge in the collapsed surface " << self);
+      CHECK(count.second != 0, "Vertex " << count.first << " disappeared from surface after collapse; the vertex was still there in the original surface " << original << " but is gone in the collapsed surface " << self);
+      CHECK(count.second >= 2, "Vertex " << count.first << " almost disappeared from surface after collapse; the vertex was still there in the original surface " << original << " but it has only one outgoing edge in the collapsed surface " << self);
     }
   }));
 
@@ -21,6 +21,9 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <array>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -48,6 +51,15 @@ FlatTriangulationCombinatorial::FlatTriangulationCombinatorial(const std::vector
       CHECK_ARGUMENT(std::find(begin(boundaries), end(boundaries), *it) == end(boundaries) || it == cycle.rbegin(), "Boundary edges must be at the end of a vertex permutation");
 }
 
+FlatTriangulationCombinatorial::FlatTriangulationCombinatorial(const std::vector<int>& vertices, const std::vector<size_t>& offsets, const std::vector<int>& boundaries) :
+  FlatTriangulationCombinatorial(PrivateConstructor{}, Permutation<HalfEdge>(std::vector<HalfEdge>(begin(vertices), end(vertices)), offsets), std::vector<HalfEdge>(begin(boundaries), end(boundaries))) {
+  auto sorted = boundaries;
+  std::sort(begin(sorted), end(sorted));
+  for (size_t i = 0; i + 1 < offsets.size(); i++)
+    for (size_t j = offsets[i]; j + 1 < offsets[i + 1]; j++)
+      CHECK_ARGUMENT(!std::binary_search(begin(sorted), end(sorted), vertices[j]), "Boundary edges must be at the end of a vertex permutation");
+}
+
 FlatTriangulationCombinatorial::FlatTriangulationCombinatorial(const Permutation<HalfEdge>& vertices) :
   FlatTriangulationCombinatorial(PrivateConstructor{}, vertices, std::vector<HalfEdge>{}) {}
 
@@ -95,14 +107,15 @@ FlatTriangulationCombinatorial::FlatTriangulationCombinatorial(const std::vector
   }()) {
   ASSERT(
       faces | rx::all_of([&](const auto face) {
-        return self->faces(std::get<0>(face)) == std::get<1>(face) && self->faces(std::get<1>(face)) == std::get<2>(face) && self->faces(std::get<2>(face)) == std::get<0>(face);
+        return self->structure->faces(std::get<0>(face)) == std::get<1>(face) && self->structure->faces(std::get<1>(face)) == std::get<2>(face) && self->structure->faces(std::get<2>(face)) == std::get<0>(face);
       }),
-      "triangulation changed faces, expected " << fmt::format("({})", fmt::join(faces | rx::transform([](const auto face) { return fmt::format("({}, {}, {})", std::get<0>(face), std::get<1>(face), std::get<2>(face)); }) | rx::to_vector(), ", ")) << " but got " << self->faces);
+      "triangulation changed faces, expected " << fmt::format("({})", fmt::join(faces | rx::transform([](const auto face) { return fmt::format("({}, {}, {})", std::get<0>(face), std::get<1>(face), std::get<2>(face)); }) | rx::to_vector(), ", ")) << " but got " << self->structure->faces);
 }
 
 ImplementationOf<FlatTriangulationCombinatorial>::ImplementationOf(const Permutation<HalfEdge>& vertices, const std::vector<HalfEdge>& boundaries) :
-  vertices(vertices),
-  faces(
+  structure(std::make_shared<Structure>(Structure{
+      {},
+      vertices,
       // In the triangulation, the order in which half edges are attached to a
       // vertex defines the faces, so we reconstruct the faces here.
       vertices.domain() | rx::transform([&](const HalfEdge& e) {
@@ -112,109 +125,227 @@ ImplementationOf<FlatTriangulationCombinatorial>::ImplementationOf(const Permuta
                    // which only contains that half edge.
                    : std::pair<HalfEdge, HalfEdge>(e, e);
       }) |
-      rx::to_vector()),
-  vertexes() {
+          rx::to_vector(),
+      {},
+      {},
+      {}})) {
   CHECK_ARGUMENT(vertices.size() % 2 == 0, "half edges must come in pairs");
 
   resetVertexes();
+  resetAdjacency();
   resetEdges();
 
   // check that faces are triangles
-  for (auto edge : faces.domain()) {
-    if (faces(edge) != edge) {
-      CHECK_ARGUMENT(faces(faces(faces(edge))) == edge, "not fully triangulated");
+  for (auto edge : structure->faces.domain()) {
+    if (structure->faces(edge) != edge) {
+      CHECK_ARGUMENT(structure->faces(structure->faces(structure->faces(edge))) == edge, "not fully triangulated");
     } else {
       ASSERT_ARGUMENT(std::find(begin(boundaries), end(boundaries), edge) != end(boundaries), "faces must not be trivial");
     }
   }
 
-  check();
+  VALIDATE_INPUT([&]() { check(); });
+}
+
+ImplementationOf<FlatTriangulationCombinatorial>::ImplementationOf(std::shared_ptr<Structure> structure) :
+  structure(std::move(structure)) {}
+
+void ImplementationOf<FlatTriangulationCombinatorial>::unshare() {
+  if (structure.use_count() != 1)
+    structure = std::make_shared<Structure>(*structure);
+}
+
+size_t ImplementationOf<FlatTriangulationCombinatorial>::vertex(const FlatTriangulationCombinatorial& surface, HalfEdge he) {
+  return self(surface)->structure->adjacency[he.index()].vertex;
+}
+
+void ImplementationOf<FlatTriangulationCombinatorial>::attach(Observer* observer) const {
+  std::lock_guard<std::mutex> guard(observersLock);
+
+  ASSERT(observer->previous == nullptr && observer->next == nullptr && observers != observer, "observer is already attached");
+
+  observer->next = observers;
+  if (observers != nullptr)
+    observers->previous = observer;
+  observers = observer;
+}
+
+void ImplementationOf<FlatTriangulationCombinatorial>::detach(Observer* observer) const {
+  std::lock_guard<std::mutex> guard(observersLock);
+
+  if (observer->previous != nullptr)
+    observer->previous->next = observer->next;
+  else if (observers == observer)
+    observers = observer->next;
+  else
+    return;
+
+  if (observer->next != nullptr)
+    observer->next->previous = observer->previous;
+
+  observer->previous = nullptr;
+  observer->next = nullptr;
+}
+
+void ImplementationOf<FlatTriangulationCombinatorial>::flushFlips() const {
+  if (deferredFlips.empty())
+    return;
+
+  // Report each edge only once, no matter how often it has been flipped.
+  std::vector<HalfEdge> flips;
+  std::vector<bool> flipped(structure->edges.size());
+  for (const auto flip : deferredFlips) {
+    if (flipped[flip.edge().index()])
+      continue;
+    flipped[flip.edge().index()] = true;
+    flips.push_back(flip);
+  }
+  deferredFlips.clear();
+
+  notify([&](Observer& observer) {
+    if (observer.deferrable())
+      observer.afterFlips(flips);
+  });
 }
 
-sigslot::connection ImplementationOf<FlatTriangulationCombinatorial>::connect(const ImplementationOf* surface, std::function<void(Message)> handler) {
-  return surface->change.connect(handler);
+ImplementationOf<FlatTriangulationCombinatorial>::FlipTransaction::FlipTransaction(const ImplementationOf& surface) :
+  surface(surface) {
+  surface.flipTransactions++;
+}
+
+ImplementationOf<FlatTriangulationCombinatorial>::FlipTransaction::~FlipTransaction() {
+  if (--surface.flipTransactions == 0)
+    surface.flushFlips();
 }
 
 void ImplementationOf<FlatTriangulationCombinatorial>::check() const {
-  assert(faces.domain().size() == vertices.domain().size() && "faces and vertices must have the same half edges as domain");
-  assert([&]() {
-    for (auto edge : faces.domain()) {
-      if (faces(edge) == edge)
+  CHECK(structure->faces.domain().size() == structure->vertices.domain().size(), "faces and vertices must have the same half edges as domain");
+  const bool consistent = [&]() {
+    for (auto edge : structure->faces.domain()) {
+      if (structure->faces(edge) == edge)
         // nothing to check for boundaries yet
         continue;
-      if (faces(faces(edge)) == edge)
+      if (structure->faces(structure->faces(edge)) == edge)
         // nothing to check for collapsed faces yet
         continue;
-      if (-faces.preimage(edge) == edge)
+      if (-structure->faces.preimage(edge) == edge)
         // surface is only connected in a point here, the faces do not encode
         // enough information to reconstruct vertices.
         continue;
-      if (-faces.preimage(vertices(edge)) == vertices(edge))
+      if (-structure->faces.preimage(structure->vertices(edge)) == structure->vertices(edge))
         // surface is only connected in a point here, the faces do not encode
         // enough information to reconstruct vertices.
         continue;
-      if (vertices(edge) != -faces.preimage(edge))
+      if (structure->vertices(edge) != -structure->faces.preimage(edge))
         return false;
     }
     return true;
-  }() && "vertices must be consistent with faces");
+  }();
+  CHECK(consistent, "vertices must be consistent with faces");
 }
 
 void ImplementationOf<FlatTriangulationCombinatorial>::resetVertexes() {
-  this->vertexes.clear();
-  for (const auto& cycle : vertices.cycles())
-    vertexes.push_back(::flatsurf::ImplementationOf<Vertex>::make(cycle));
+  structure->vertexes.clear();
+  structure->adjacency.resize(structure->vertices.size());
+
+  std::vector<HalfEdge> cycles;
+  std::vector<size_t> offsets;
+  structure->vertices.cycles(cycles, offsets);
+
+  structure->vertexes.reserve(offsets.size() - 1);
+  for (size_t i = 0; i + 1 < offsets.size(); i++) {
+    const auto first = begin(cycles) + offsets[i];
+    const auto last = begin(cycles) + offsets[i + 1];
+    for (auto he = first; he != last; he++)
+      structure->adjacency[he->index()].vertex = static_cast<uint32_t>(structure->vertexes.size());
+    structure->vertexes.push_back(::flatsurf::ImplementationOf<Vertex>::make(std::vector<HalfEdge>(first, last)));
+  }
+}
+
+void ImplementationOf<FlatTriangulationCombinatorial>::resetAdjacency() {
+  structure->adjacency.resize(structure->vertices.size());
+  for (const auto& he : structure->vertices.domain())
+    updateAdjacency(he);
+}
+
+void ImplementationOf<FlatTriangulationCombinatorial>::updateAdjacency(HalfEdge he) {
+  auto& record = structure->adjacency[he.index()];
+  record.nextInFace = static_cast<uint32_t>(structure->faces(he).index());
+  record.nextAtVertex = static_cast<uint32_t>(structure->vertices(he).index());
+  record.previousAtVertex = static_cast<uint32_t>(structure->vertices.preimage(he).index());
 }
 
 void ImplementationOf<FlatTriangulationCombinatorial>::resetVertices() {
-  std::vector<std::pair<HalfEdge, HalfEdge>> vertices;
-  for (auto e : faces.domain()) {
-    if (faces(e) == e)
+  std::vector<std::pair<HalfEdge, HalfEdge>> permutation;
+  for (auto e : structure->faces.domain()) {
+    if (structure->faces(e) == e)
       throw std::logic_error("not implemented: resetVertices() with boundaries");
-    if (faces(e) == -e && faces(faces(e)) == e) {
-      vertices.push_back({e, e});
+    if (structure->faces(e) == -e && structure->faces(structure->faces(e)) == e) {
+      permutation.push_back({e, e});
     } else {
-      vertices.push_back({e, -faces.preimage(e)});
+      permutation.push_back({e, -structure->faces.preimage(e)});
     }
   }
-  this->vertices = Permutation<HalfEdge>(vertices);
+  structure->vertices = Permutation<HalfEdge>(permutation);
 }
 
 void ImplementationOf<FlatTriangulationCombinatorial>::resetEdges() {
-  std::unordered_set<Edge> edges;
-  for (const auto& e : faces.domain())
-    edges.insert(e);
-  this->edges = std::vector<Edge>(begin(edges), end(edges));
+  std::unordered_set<Edge> unique;
+  for (const auto& e : structure->faces.domain())
+    unique.insert(e);
+  structure->edges = std::vector<Edge>(begin(unique), end(unique));
   // This can probably go away, see https://github.com/flatsurf/flatsurf/issues/147
-  std::sort(begin(this->edges), end(this->edges), [&](const auto& lhs, const auto& rhs) { return lhs.index() < rhs.index(); });
+  std::sort(begin(structure->edges), end(structure->edges), [&](const auto& lhs, const auto& rhs) { return lhs.index() < rhs.index(); });
 
-  halfEdges = vertices.domain();
+  structure->halfEdges = structure->vertices.domain();
   // This can probably go away, see https://github.com/flatsurf/flatsurf/issues/147
-  std::sort(begin(halfEdges), end(halfEdges), [&](const auto& lhs, const auto& rhs) { return lhs.index() < rhs.index(); });
+  std::sort(begin(structure->halfEdges), end(structure->halfEdges), [&](const auto& lhs, const auto& rhs) { return lhs.index() < rhs.index(); });
 }
 
 void ImplementationOf<FlatTriangulationCombinatorial>::swap(HalfEdge a, HalfEdge b) {
   if (a == b) return;
 
-  change(ImplementationOf::MessageBeforeSwap{a, b});
+  unshare();
+
+  flushFlips();
+  notify([&](Observer& observer) { observer.beforeSwap(a, b); });
 
-  vertices *= {a, b};
-  std::vector{a, b} *= vertices;
+  structure->vertices *= {a, b};
+  std::vector{a, b} *= structure->vertices;
 
   if (a != -b) {
-    vertices *= {-a, -b};
-    std::vector{-a, -b} *= vertices;
+    structure->vertices *= {-a, -b};
+    std::vector{-a, -b} *= structure->vertices;
   }
 
-  faces *= {a, b};
-  std::vector{a, b} *= faces;
+  structure->faces *= {a, b};
+  std::vector{a, b} *= structure->faces;
 
   if (a != -b) {
-    faces *= {-a, -b};
-    std::vector{-a, -b} *= faces;
+    structure->faces *= {-a, -b};
+    std::vector{-a, -b} *= structure->faces;
   }
 
-  resetVertexes();
+  // Only the records of the swapped half edges and of the half edges next
+  // to them mention a or b.
+  for (const HalfEdge he : {a, -a, b, -b})
+    for (const HalfEdge neighbour : {he, structure->faces(he), structure->faces.preimage(he), structure->vertices(he), structure->vertices.preimage(he)})
+      updateAdjacency(neighbour);
+
+  // Exchange the labels in the vertices that contain them.
+  const auto relabel = [&](HalfEdge x, HalfEdge y) {
+    const uint32_t vx = structure->adjacency[x.index()].vertex;
+    const uint32_t vy = structure->adjacency[y.index()].vertex;
+    if (vx == vy) return;
+
+    ImplementationOf<Vertex>::afterSwap(structure->vertexes[vx], x, y);
+    ImplementationOf<Vertex>::afterSwap(structure->vertexes[vy], x, y);
+    std::swap(structure->adjacency[x.index()].vertex, structure->adjacency[y.index()].vertex);
+  };
+
+  relabel(a, b);
+  if (a != -b)
+    relabel(-a, -b);
 }
 
 void ImplementationOf<FlatTriangulationCombinatorial>::flip(HalfEdge e) {
@@ -222,6 +353,8 @@ void ImplementationOf<FlatTriangulationCombinatorial>::flip(HalfEdge e) {
 
   ASSERT_ARGUMENT(!self.boundary(e) && !self.boundary(-e), "cannot flip a boundary edge");
 
+  unshare();
+
   // Let (e a b) and (-e c d) be the faces containing e and -e before the flip.
   const HalfEdge a = self.nextInFace(e);
   const HalfEdge b = self.nextInFace(a);
@@ -234,21 +367,44 @@ void ImplementationOf<FlatTriangulationCombinatorial>::flip(HalfEdge e) {
   // multiply vertices with (b a -e)
   // (... d -c ...)(... c e -b ...) -> (... d e -c ...)(... c -b ...) so we
   // multiply vertices with (d c e)
-  vertices *= cycle{b, a, -e};
-  vertices *= cycle{d, c, e};
+  structure->vertices *= cycle{b, a, -e};
+  structure->vertices *= cycle{d, c, e};
 
   // flip e in "faces"
   // (a b e)(c d -e) -> (a -e d)(c e b), i.e., multiply with (a d e)(c b -e)
-  faces *= cycle{a, d, e};
-  faces *= cycle{c, b, -e};
+  structure->faces *= cycle{a, d, e};
+  structure->faces *= cycle{c, b, -e};
 
-  for (auto& vertex : vertexes)
-    ImplementationOf<Vertex>::afterFlip(vertex, self, e);
+  // The cycles above only change the neighbours of these half edges.
+  for (const HalfEdge he : {a, b, c, d, e})
+    for (const HalfEdge side : {he, -he})
+      updateAdjacency(side);
 
-  // notify attached structures about this flip
-  change(ImplementationOf<FlatTriangulationCombinatorial>::MessageAfterFlip{e});
+  // Only the vertices that contain the neighbours of e and -e change, namely
+  // p and q are followed by -e and e in the updated vertices.
+  {
+    const HalfEdge p = self.previousAtVertex(-e);
+    const HalfEdge q = self.previousAtVertex(e);
+
+    std::array<uint32_t, 4> affected{structure->adjacency[p.index()].vertex, structure->adjacency[(-p).index()].vertex, structure->adjacency[q.index()].vertex, structure->adjacency[(-q).index()].vertex};
+    std::sort(begin(affected), end(affected));
+    for (auto vertex = begin(affected); vertex != std::unique(begin(affected), end(affected)); vertex++)
+      ImplementationOf<Vertex>::afterFlip(structure->vertexes[*vertex], self, e);
 
-  check();
+    structure->adjacency[e.index()].vertex = structure->adjacency[q.index()].vertex;
+    structure->adjacency[(-e).index()].vertex = structure->adjacency[p.index()].vertex;
+  }
+
+  // notify attached structures about this flip; deferrable ones only learn
+  // about it when the current FlipTransaction ends.
+  if (flipTransactions)
+    deferredFlips.push_back(e);
+  notify([&](Observer& observer) {
+    if (!flipTransactions || !observer.deferrable())
+      observer.afterFlip(e);
+  });
+
+  VALIDATE([&]() { check(); });
 }
 
 std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCombinatorial>::collapse(HalfEdge collapse) {
@@ -260,8 +416,11 @@ std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCombinatorial>::
   if (self.nextInFace(self.nextInFace(self.nextInFace(collapse))) != collapse || self.nextInFace(self.nextInFace(self.nextInFace(-collapse))) != -collapse)
     throw std::logic_error("not implemented: cannot collapse collapsed edge yet");
 
+  unshare();
+
   // notify attached structures about this collapse
-  change(ImplementationOf<FlatTriangulationCombinatorial>::MessageBeforeCollapse{collapse});
+  flushFlips();
+  notify([&](Observer& observer) { observer.beforeCollapse(collapse); });
 
   // In principle, we will drop three pairs of half edges, namely e,
   // previousAtVertex(-e), nextAtVertex(-e).
@@ -321,7 +480,14 @@ std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCombinatorial>::
     dropHalfEdges.insert(d.negative());
   }
 
-  change(ImplementationOf<FlatTriangulationCombinatorial>::MessageBeforeErase{dropEdges | rx::to_vector()});
+  notify([&, erase = dropEdges | rx::to_vector()](Observer& observer) { observer.beforeErase(erase); });
+
+  // Only the vertices of the two faces that collapse are affected.
+  std::vector<size_t> affected;
+  for (const HalfEdge he : {collapse, self.nextInFace(collapse), self.previousInFace(collapse), -collapse, self.nextInFace(-collapse), self.previousInFace(-collapse)})
+    affected.push_back(structure->adjacency[he.index()].vertex);
+  std::sort(begin(affected), end(affected));
+  affected.erase(std::unique(begin(affected), end(affected)), end(affected));
 
   // Consider the faces (collapse, x, -a) and (-collapse, c, -y).
   const HalfEdge a = -self.previousInFace(collapse);
@@ -329,44 +495,85 @@ std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCombinatorial>::
 
   // Remove any mention of these edges from `faces`:
   // Consider again the faces (collapse, x, -a) and (-collapse, c, -y).
+  // Note that adjacency is not updated until the end of the collapse, so we
+  // query the permutation directly here.
   // To collapse these faces, -a needs to take the place of -x …
   {
-    const HalfEdge _a = self.previousInFace(collapse);
+    const HalfEdge _a = structure->faces.preimage(collapse);
     assert(_a == -a && "permutations not consistent in face to collapse");
-    const HalfEdge _x = -self.nextInFace(collapse);
-    const HalfEdge p_x = self.previousInFace(_x);
-    const HalfEdge x = self.nextInFace(collapse);
-    faces *= {_a, _x};
-    faces *= {p_x, x};
-    faces *= {self.previousInFace(collapse), collapse};
+    const HalfEdge _x = -structure->faces(collapse);
+    const HalfEdge p_x = structure->faces.preimage(_x);
+    const HalfEdge x = structure->faces(collapse);
+    structure->faces *= {_a, _x};
+    structure->faces *= {p_x, x};
+    structure->faces *= {structure->faces.preimage(collapse), collapse};
   }
   // … and c needs to take the place of y.
   {
     // Note that this might not be the original c anymore.
-    const HalfEdge cc = self.nextInFace(-collapse);
-    const HalfEdge y = -self.previousInFace(-collapse);
-    const HalfEdge py = self.previousInFace(y);
+    const HalfEdge cc = structure->faces(-collapse);
+    const HalfEdge y = -structure->faces.preimage(-collapse);
+    const HalfEdge py = structure->faces.preimage(y);
     const HalfEdge _e = -collapse;
-    faces *= {cc, y};
-    faces *= {py, _e};
-    faces *= {self.previousInFace(-collapse), -collapse};
+    structure->faces *= {cc, y};
+    structure->faces *= {py, _e};
+    structure->faces *= {structure->faces.preimage(-collapse), -collapse};
   }
 
-  faces.drop(dropHalfEdges | rx::to_vector());
+  structure->faces.drop(dropHalfEdges | rx::to_vector());
 
   // Calculate vertex permutation from half edges, note that this might
   // separate vertices when a connection from a vertex to itself has been
   // collapsed.
   resetVertices();
 
-  // The vertices at the end of e need to merge (or separate.) We could do this
-  // more efficiently, but it's probably not worth it.
-  resetVertexes();
+  // The vertices at the end of e need to merge (or separate.) We replace the
+  // affected vertices with the cycles of their surviving half edges.
+  {
+    std::vector<HalfEdge> survivors;
+    for (const size_t vertex : affected)
+      for (const HalfEdge he : ImplementationOf<Vertex>::outgoing(structure->vertexes[vertex]))
+        if (dropHalfEdges.find(he) == end(dropHalfEdges))
+          survivors.push_back(he);
+
+    // Remove the affected vertices by moving the last vertices into their place.
+    for (auto vertex = rbegin(affected); vertex != rend(affected); vertex++) {
+      if (*vertex != structure->vertexes.size() - 1) {
+        structure->vertexes[*vertex] = std::move(structure->vertexes.back());
+        for (const HalfEdge he : ImplementationOf<Vertex>::outgoing(structure->vertexes[*vertex]))
+          structure->adjacency[he.index()].vertex = static_cast<uint32_t>(*vertex);
+      }
+      structure->vertexes.pop_back();
+    }
 
-  // This could also be done more efficiently.
-  resetEdges();
+    structure->adjacency.resize(structure->vertices.size());
+
+    const uint32_t unassigned = static_cast<uint32_t>(-1);
+    for (const HalfEdge he : survivors)
+      structure->adjacency[he.index()].vertex = unassigned;
 
-  check();
+    for (const HalfEdge he : survivors) {
+      if (structure->adjacency[he.index()].vertex != unassigned)
+        continue;
+
+      const auto cycle = structure->vertices.cycle(he);
+      for (const HalfEdge member : cycle)
+        structure->adjacency[member.index()].vertex = static_cast<uint32_t>(structure->vertexes.size());
+      structure->vertexes.push_back(::flatsurf::ImplementationOf<Vertex>::make(cycle));
+    }
+
+    ASSERT(structure->vertexes.size() == structure->vertices.cycles().size(), "vertices inconsistent after collapse");
+  }
+
+  resetAdjacency();
+
+  // The dropped edges have maximal indices, so they are at the end of the
+  // sorted edges and half edges.
+  structure->edges.resize(structure->edges.size() - dropEdges.size());
+  structure->halfEdges.resize(structure->halfEdges.size() - dropHalfEdges.size());
+  ASSERT(structure->halfEdges.size() == structure->vertices.size(), "edges inconsistent after collapse");
+
+  VALIDATE([&]() { check(); });
 
   if (dropEdges.find(a) != end(dropEdges)) {
     assert(dropEdges.find(c) == end(dropEdges) && "an entire horizontal part of the surface has been dropped out of existence");
@@ -380,7 +587,11 @@ std::pair<HalfEdge, HalfEdge> ImplementationOf<FlatTriangulationCombinatorial>::
 }
 
 ImplementationOf<FlatTriangulationCombinatorial>::~ImplementationOf() {
-  change(MessageAfterMove{nullptr});
+  while (observers != nullptr) {
+    Observer* observer = observers;
+    detach(observer);
+    observer->beforeDestruction();
+  }
 }
 
 std::ostream& operator<<(std::ostream& os, const FlatTriangulationCombinatorial& self) {
@@ -38,6 +38,7 @@
 #include "impl/flat_triangulation_combinatorial.impl.hpp"
 #include "impl/vertex.impl.hpp"
 #include "util/assert.ipp"
+#include "util/union_find.ipp"
 
 namespace flatsurf {
 
@@ -47,52 +48,52 @@ using std::end;
 template <typename Surface>
 HalfEdge FlatTriangulationCombinatorics<Surface>::nextInFace(const HalfEdge e) const {
   ASSERT_ARGUMENT(!boundary(e), "boundary half edge has no successor since it is not on any face");
-  return self->faces(e);
+  return HalfEdge::fromIndex(self->structure->adjacency[e.index()].nextInFace);
 }
 
 template <typename Surface>
 HalfEdge FlatTriangulationCombinatorics<Surface>::previousInFace(const HalfEdge e) const {
   ASSERT_ARGUMENT(!boundary(e), "boundary half edge has no predecessor since it is not on any face");
-  return self->faces.preimage(e);
+  return self->structure->faces.preimage(e);
 }
 
 template <typename Surface>
 bool FlatTriangulationCombinatorics<Surface>::boundary(const HalfEdge e) const {
-  return self->faces(e) == e;
+  return self->structure->adjacency[e.index()].nextInFace == e.index();
 }
 
 template <typename Surface>
 HalfEdge FlatTriangulationCombinatorics<Surface>::nextAtVertex(const HalfEdge e) const {
   ASSERT_ARGUMENT(!boundary(e), "boundary half edge has no successor at vertex");
-  return self->vertices(e);
+  return HalfEdge::fromIndex(self->structure->adjacency[e.index()].nextAtVertex);
 }
 
 template <typename Surface>
 HalfEdge FlatTriangulationCombinatorics<Surface>::previousAtVertex(const HalfEdge e) const {
   ASSERT_ARGUMENT(!boundary(-e), "complement of boundary half edge has no predecessor at vertex");
-  return self->vertices.preimage(e);
+  return HalfEdge::fromIndex(self->structure->adjacency[e.index()].previousAtVertex);
 }
 
 template <typename Surface>
 const std::vector<HalfEdge>& FlatTriangulationCombinatorics<Surface>::halfEdges() const {
-  return self->halfEdges;
+  return self->structure->halfEdges;
 }
 
 template <typename Surface>
 const std::vector<Vertex>& FlatTriangulationCombinatorics<Surface>::vertices() const {
-  return self->vertexes;
+  return self->structure->vertexes;
 }
 
 template <typename Surface>
 const std::vector<Edge>& FlatTriangulationCombinatorics<Surface>::edges() const {
-  return self->edges;
+  return self->structure->edges;
 }
 
 template <typename Surface>
 FlatTriangulationCombinatorial FlatTriangulationCombinatorics<Surface>::clone() const {
-  return ImplementationOf<FlatTriangulationCombinatorial>::make(
-      self->vertices,
-      self->faces.domain() | rx::filter([&](auto& edge) { return this->boundary(edge); }) | rx::to_vector());
+  // The clone shares the combinatorial structure with this surface until
+  // one of them is modified.
+  return ImplementationOf<FlatTriangulationCombinatorial>::make(self->structure);
 }
 
 template <typename Surface>
@@ -100,12 +101,12 @@ FlatTriangulationCombinatorial FlatTriangulationCombinatorics<Surface>::insertAt
   CHECK_ARGUMENT(!boundary(e), "cannot insert vertex beyond boundary");
 
   // Insert three new half edges a, b, c which go around the new vertex such that -a is next to e.
-  const int nextEdge = static_cast<int>(self->vertices.size() / 2) + 1;
+  const int nextEdge = static_cast<int>(self->structure->vertices.size() / 2) + 1;
   HalfEdge a = HalfEdge(nextEdge);
   HalfEdge b = HalfEdge(nextEdge + 1);
   HalfEdge c = HalfEdge(nextEdge + 2);
 
-  auto cycles = self->vertices.cycles();
+  auto cycles = self->structure->vertices.cycles();
   for (auto& cycle : cycles) {
     for (size_t i = 0; i < cycle.size(); i++) {
       if (cycle[i] == e) {
@@ -124,17 +125,45 @@ FlatTriangulationCombinatorial FlatTriangulationCombinatorics<Surface>::insertAt
 
   return ImplementationOf<FlatTriangulationCombinatorial>::make(
       Permutation<HalfEdge>(cycles),
-      self->faces.domain() | rx::filter([&](auto& edge) { return this->boundary(edge); }) | rx::to_vector());
+      self->structure->faces.domain() | rx::filter([&](auto& edge) { return this->boundary(edge); }) | rx::to_vector());
 }
 
 template <typename Surface>
 std::vector<std::tuple<HalfEdge, HalfEdge, HalfEdge>> FlatTriangulationCombinatorics<Surface>::faces() const {
-  return self->faces.cycles() | rx::filter([](const auto& face) {
+  std::vector<HalfEdge> cycles;
+  std::vector<size_t> offsets;
+  self->structure->faces.cycles(cycles, offsets);
+
+  std::vector<std::tuple<HalfEdge, HalfEdge, HalfEdge>> faces;
+  faces.reserve(cycles.size() / 3);
+  for (size_t i = 0; i + 1 < offsets.size(); i++) {
     // Boundary half edges have trivial faces.
-    return face.size() == 3;
-  }) | rx::transform([](const auto& face) {
-    return std::tuple{face[0], face[1], face[2]};
-  }) | rx::to_vector();
+    if (offsets[i + 1] - offsets[i] != 3)
+      continue;
+    faces.emplace_back(cycles[offsets[i]], cycles[offsets[i] + 1], cycles[offsets[i] + 2]);
+  }
+  return faces;
+}
+
+template <typename Surface>
+std::vector<std::vector<HalfEdge>> FlatTriangulationCombinatorics<Surface>::components() const {
+  UnionFind components(halfEdges().size());
+  for (const auto he : halfEdges()) {
+    components.join(he.index(), (-he).index());
+    components.join(he.index(), nextInFace(he).index());
+  }
+
+  std::vector<std::vector<HalfEdge>> sets;
+  std::vector<size_t> position(components.size(), components.size());
+  for (const auto he : halfEdges()) {
+    const size_t root = components.find(he.index());
+    if (position[root] == components.size()) {
+      position[root] = sets.size();
+      sets.emplace_back();
+    }
+    sets[position[root]].push_back(he);
+  }
+  return sets;
 }
 
 template <typename Surface>
@@ -162,7 +191,7 @@ FlatTriangulationCombinatorial FlatTriangulationCombinatorics<Surface>::slit(Hal
   for (HalfEdge current = nextAtVertex(e); current != e; current = nextAtVertex(current)) {
     if (boundary(current)) {
       vertices[current] = ee;
-      vertices[e] = self->vertices(current);
+      vertices[e] = self->structure->vertices(current);
       break;
     }
   }
@@ -170,7 +199,7 @@ FlatTriangulationCombinatorial FlatTriangulationCombinatorics<Surface>::slit(Hal
   for (HalfEdge current = nextAtVertex(-e); current != -e; current = nextAtVertex(current)) {
     if (boundary(current)) {
       vertices[current] = -e;
-      vertices[-ee] = self->vertices(current);
+      vertices[-ee] = self->structure->vertices(current);
       break;
     }
   }
@@ -184,7 +213,7 @@ FlatTriangulationCombinatorial FlatTriangulationCombinatorics<Surface>::slit(Hal
 
 template <typename Surface>
 std::vector<HalfEdge> FlatTriangulationCombinatorics<Surface>::atVertex(const Vertex& v) const {
-  return self->vertices.cycle(*begin(ImplementationOf<Vertex>::outgoing(v)));
+  return self->structure->vertices.cycle(*begin(ImplementationOf<Vertex>::outgoing(v)));
 }
 
 template <typename Surface>
@@ -194,7 +223,7 @@ bool FlatTriangulationCombinatorics<Surface>::hasBoundary() const {
 
 template <typename Surface>
 size_t FlatTriangulationCombinatorics<Surface>::size() const {
-  return self->edges.size();
+  return self->structure->edges.size();
 }
 
 template <typename Surface>
@@ -210,7 +239,8 @@ std::pair<HalfEdge, HalfEdge> FlatTriangulationCombinatorics<Surface>::collapse(
 template <typename Surface>
 bool FlatTriangulationCombinatorics<Surface>::operator==(const FlatTriangulationCombinatorial& rhs) const {
   if (self.state == ImplementationOf<FlatTriangulationCombinatorial>::self(rhs).state) return true;
-  return this->self->vertices == ImplementationOf<FlatTriangulationCombinatorial>::self(rhs)->vertices;
+  const auto& other = ImplementationOf<FlatTriangulationCombinatorial>::self(rhs)->structure;
+  return this->self->structure == other || this->self->structure->vertices == other->vertices;
 }
 
 template <typename Surface>
@@ -236,7 +266,7 @@ FlatTriangulationCombinatorics<Surface>::operator FlatTriangulationCombinatorial
 template <typename Surface>
 std::ostream& operator<<(std::ostream& os, const FlatTriangulationCombinatorics<Surface>& self) {
   return os << "FlatTriangulationCombinatorial(vertices = "
-            << self.self->vertices << ", faces = " << self.self->faces << ")";
+            << self.self->structure->vertices << ", faces = " << self.self->structure->faces << ")";
 }
 }  // namespace flatsurf
 
@@ -245,4 +275,4 @@ std::ostream& operator<<(std::ostream& os, const FlatTriangulationCombinatorics<
 #include "impl/flat_triangulation_collapsed.impl.hpp"
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION), FlatTriangulationCombinatorics, LIBFLATSURF_FLAT_TRIANGULATION_TYPES(FlatTriangulationCombinatorial) LIBFLATSURF_FLAT_TRIANGULATION_COLLAPSED_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION), FlatTriangulationCombinatorics, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES(FlatTriangulationCombinatorial) LIBFLATSURF_FLAT_TRIANGULATION_COLLAPSED_TYPES)
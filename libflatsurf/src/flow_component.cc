@@ -27,10 +27,12 @@
 #include <intervalxt/fmt.hpp>
 #include <intervalxt/label.hpp>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <unordered_set>
 
 #include "../flatsurf/ccw.hpp"
+#include "../flatsurf/decomposition_budget.hpp"
 #include "../flatsurf/fmt.hpp"
 #include "../flatsurf/orientation.hpp"
 #include "../flatsurf/vertical.hpp"
@@ -38,10 +40,13 @@
 #include "impl/collapsed_half_edge.hpp"
 #include "impl/contour_component.impl.hpp"
 #include "impl/contour_decomposition_state.hpp"
+#include "impl/decomposition_budget.impl.hpp"
 #include "impl/flat_triangulation_collapsed.impl.hpp"
 #include "impl/flow_component.impl.hpp"
 #include "impl/flow_connection.impl.hpp"
+#include "impl/flow_decomposition_state.hpp"
 #include "impl/flow_triangulation.impl.hpp"
+#include "impl/interval_exchange_transformation.impl.hpp"
 #include "impl/saddle_connection.impl.hpp"
 #include "util/assert.ipp"
 
@@ -52,16 +57,77 @@ using std::string;
 
 template <typename Surface>
 bool FlowComponent<Surface>::decompose(std::function<bool(const FlowComponent<Surface>&)> target, int limit) {
+  return decompose(target, ImplementationOf<DecompositionBudget>::make(limit));
+}
+
+template <typename Surface>
+bool FlowComponent<Surface>::decompose(std::function<bool(const FlowComponent<Surface>&)> target, const DecompositionBudget& budget) {
   const auto check = [&]() {
+    // The components of other threads might be in an intermediate state.
+    if (self->state->parallel)
+      return;
+
     auto paths = self->state->components | rx::transform([&](const auto& component) { return Path(ImplementationOf<FlowComponent<Surface>>::make(self->state, &const_cast<FlowComponentState<Surface>&>(component)).perimeter() | rx::transform([](const auto& connection) { return connection.saddleConnection(); }) | rx::to_vector()); }) | rx::to_vector();
     ImplementationOf<ContourDecomposition<Surface>>::check(paths, vertical());
   };
 
+  {
+    std::lock_guard<std::mutex> guard(self->state->lock);
+    // The perimeters of the components are going to change.
+    self->state->embedding.reset();
+  }
+
   while (!target(*this)) {
-    auto step = self->component->dynamicalComponent.decompositionStep(limit);
+    if (budget.exhausted()) {
+      VALIDATE(check);
+      return false;
+    }
+
+    // Collect the statistics for DecompositionBudget::trace().
+    const bool tracing = ImplementationOf<DecompositionBudget>::tracing(budget);
+    auto& lengths = *ImplementationOf<IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>>::self(*self->component->iet).lengths;
+    DecompositionBudget::Clock::time_point start;
+    if (tracing) {
+      lengths.tracing = true;
+      lengths.inductions = 0;
+      lengths.elapsed = {};
+      start = DecompositionBudget::Clock::now();
+    }
+
+    auto step = [&]() {
+      // Perform the decomposition step in chunks so that we can check the
+      // budget in between.
+      int remaining = budget.limit();
+      while (true) {
+        const int chunk = ImplementationOf<DecompositionBudget>::chunk(budget, remaining);
+        auto step = self->component->dynamicalComponent.decompositionStep(chunk);
+        if (step.result != intervalxt::DecompositionStep::Result::LIMIT_REACHED || chunk == remaining)
+          return step;
+        if (remaining != -1)
+          remaining -= chunk;
+        if (budget.exhausted())
+          return step;
+      }
+    }();
+
+    ImplementationOf<DecompositionBudget>::consume(budget);
+
+    if (tracing) {
+      lengths.tracing = false;
+      ImplementationOf<DecompositionBudget>::trace(budget, DecompositionBudget::Step{
+          lengths.inductions,
+          static_cast<bool>(step.connection),
+          static_cast<bool>(step.additionalComponent),
+          step.result == intervalxt::DecompositionStep::Result::LIMIT_REACHED,
+          DecompositionBudget::Clock::now() - start,
+          lengths.elapsed});
+    }
+
+    // The perimeter of this component might have changed.
+    self->component->summary.reset();
 
     if (step.result == intervalxt::DecompositionStep::Result::LIMIT_REACHED) {
-      ASSERTIONS(check);
+      VALIDATE(check);
       return false;
     }
 
@@ -233,24 +299,30 @@ bool FlowComponent<Surface>::decompose(std::function<bool(const FlowComponent<Su
 
       ASSERT(clockwiseFrom.vector().ccw(connection) == CCW::CLOCKWISE || (clockwiseFrom.vector().ccw(connection) == CCW::COLLINEAR && clockwiseFrom.vector().orientation(connection) == ORIENTATION::OPPOSITE), "Detected SaddleConnection must be reachable clockwise from the existing contour but " << connection << " is not clockwise from " << clockwiseFrom);
 
+      std::lock_guard<std::mutex> guard(self->state->lock);
       self->state->detectedConnections.emplace(*step.connection, connection);
       self->state->detectedConnections.emplace(-*step.connection, -connection);
     }
 
     if (step.additionalComponent) {
-      self->state->components.push_back({
-          self->component->contourComponent,
-          self->component->iet,
-          *step.additionalComponent,
-      });
+      FlowComponentState<Surface>* additionalComponentState;
+      {
+        std::lock_guard<std::mutex> guard(self->state->lock);
+        self->state->components.push_back({
+            self->component->contourComponent,
+            self->component->iet,
+            *step.additionalComponent,
+        });
+        additionalComponentState = &self->state->components.back();
+      }
 
-      auto additionalComponent = ImplementationOf<FlowComponent>::make(self->state, &*self->state->components.rbegin());
+      auto additionalComponent = ImplementationOf<FlowComponent>::make(self->state, additionalComponentState);
 
-      return decompose(target, limit) && additionalComponent.decompose(target, limit);
+      return decompose(target, budget) && additionalComponent.decompose(target, budget);
     }
   }
 
-  ASSERTIONS(check);
+  VALIDATE(check);
 
   return true;
 }
@@ -272,36 +344,61 @@ Vertical<Surface> FlowComponent<Surface>::vertical() const {
 
 template <typename Surface>
 typename Surface::Coordinate FlowComponent<Surface>::area() const {
-  return Vector<T>::area(perimeter() | rx::transform([&](const auto& connection) { return static_cast<const Vector<T>&>(connection.saddleConnection()); }) | rx::to_vector());
+  return summary().area;
 }
 
 template <typename Surface>
 typename Surface::Coordinate FlowComponent<Surface>::width() const {
-  T sum = T();
-  auto vertical = this->vertical();
-  for (const auto& c : perimeter()) {
-    auto width = vertical.projectPerpendicular(c.saddleConnection());
-    if (width > 0)
-      sum += width;
-  }
-  return sum;
+  return summary().width;
 }
 
 template <typename Surface>
 Vector<typename Surface::Coordinate> FlowComponent<Surface>::circumferenceHolonomy() const {
-  if (not this->cylinder())
+  const auto& summary = this->summary();
+  if (!summary.circumferenceHolonomy)
     throw std::logic_error("circumferenceHolonomy can only be called on cylinders");
-  Vector<T> h = Vector<T>();
-  bool basis = false;
-  for (const auto& c : perimeter()) {
-    if (!c.vertical()) {
-      if (basis) break;
-      basis = true;
-    } else {
-      h += c.saddleConnection().vector();
+  return *summary.circumferenceHolonomy;
+}
+
+template <typename Surface>
+const typename FlowComponent<Surface>::Summary& FlowComponent<Surface>::summary() const {
+  auto& summary = self->component->summary;
+
+  if (!summary) {
+    const auto perimeter = this->perimeter();
+    const auto vertical = this->vertical();
+
+    const auto vectors = perimeter | rx::transform([&](const auto& connection) { return static_cast<const Vector<T>&>(connection.saddleConnection()); }) | rx::to_vector();
+
+    T width = T();
+    for (const auto& vector : vectors) {
+      auto projection = vertical.projectPerpendicular(vector);
+      if (projection > 0)
+        width += projection;
     }
+
+    const boost::logic::tribool cylinder = this->cylinder();
+
+    std::optional<Vector<T>> circumferenceHolonomy;
+    if (cylinder) {
+      circumferenceHolonomy = Vector<T>();
+      bool basis = false;
+      auto vector = begin(vectors);
+      for (const auto& c : perimeter) {
+        if (!c.vertical()) {
+          if (basis) break;
+          basis = true;
+        } else {
+          *circumferenceHolonomy += *vector;
+        }
+        ++vector;
+      }
+    }
+
+    summary = Summary{cylinder, Vector<T>::area(vectors), std::move(width), std::move(circumferenceHolonomy)};
   }
-  return h;
+
+  return *summary;
 }
 
 template <typename Surface>
@@ -20,6 +20,7 @@
 #include "../flatsurf/flow_connection.hpp"
 
 #include <intervalxt/label.hpp>
+#include <mutex>
 #include <ostream>
 
 #include "../flatsurf/ccw.hpp"
@@ -140,13 +141,17 @@ ImplementationOf<FlowConnection<Surface>>::ImplementationOf(std::shared_ptr<Flow
 
 template <typename Surface>
 FlowConnection<Surface> ImplementationOf<FlowConnection<Surface>>::make(std::shared_ptr<FlowDecompositionState<Surface>> state, const FlowComponent<Surface>& component, const intervalxt::Connection& connection) {
-  ASSERT(state->injectedConnections.find(connection) != end(state->injectedConnections) || state->detectedConnections.find(connection) != end(state->detectedConnections), "Connection " << connection << " not known to " << *state);
-
   const Kind kind = connection.parallel() ? Kind::PARALLEL : Kind::ANTIPARALLEL;
 
-  FlowConnection<Surface> ret = (state->injectedConnections.find(connection) != state->injectedConnections.end())
-                                    ? FlowConnection<Surface>(PrivateConstructor{}, state, component, state->injectedConnections.at(connection), kind)
-                                    : FlowConnection<Surface>(PrivateConstructor{}, state, component, state->detectedConnections.at(connection), kind);
+  FlowConnection<Surface> ret = [&]() {
+    std::lock_guard<std::mutex> guard(state->lock);
+    auto saddleConnection = state->injectedConnections.find(connection);
+    if (saddleConnection == end(state->injectedConnections)) {
+      saddleConnection = state->detectedConnections.find(connection);
+      ASSERT(saddleConnection != end(state->detectedConnections), "Connection " << connection << " not known to " << *state);
+    }
+    return FlowConnection<Surface>(PrivateConstructor{}, state, component, saddleConnection->second, kind);
+  }();
 
   ASSERT(ret.vertical(), "FlowConnection created from vertical Connection must be vertical but " << ret << " created from " << connection << " is not.");
   ASSERT(connection.parallel() == ret.parallel(), "FlowConnection must have same parallelity as Connection but " << ret << " and " << connection << " do not coincide");
@@ -34,7 +34,11 @@
 #include <intervalxt/sample/mpq_coefficients.hpp>
 #include <intervalxt/sample/mpz_coefficients.hpp>
 #include <intervalxt/sample/renf_elem_coefficients.hpp>
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <numeric>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <unordered_map>
@@ -42,23 +46,33 @@
 
 #include "../flatsurf/contour_component.hpp"
 #include "../flatsurf/contour_decomposition.hpp"
+#include "../flatsurf/decomposition_budget.hpp"
+#include "../flatsurf/executor.hpp"
 #include "../flatsurf/flat_triangulation.hpp"
 #include "../flatsurf/flat_triangulation_collapsed.hpp"
 #include "../flatsurf/flow_connection.hpp"
+#include "../flatsurf/flow_decomposition_summary.hpp"
 #include "../flatsurf/flow_triangulation.hpp"
 #include "../flatsurf/half_edge.hpp"
 #include "../flatsurf/half_edge_map.hpp"
+#include "../flatsurf/latency.hpp"
 #include "../flatsurf/path.hpp"
+#include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/vector.hpp"
 #include "../flatsurf/vertical.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
 #include "impl/contour_decomposition.impl.hpp"
+#include "impl/decomposition_budget.impl.hpp"
+#include "impl/enclosure.hpp"
+#include "impl/flat_triangulation.impl.hpp"
 #include "impl/flow_component.impl.hpp"
 #include "impl/flow_component_state.hpp"
 #include "impl/flow_decomposition.impl.hpp"
 #include "impl/flow_decomposition_state.hpp"
 #include "impl/interval_exchange_transformation.impl.hpp"
 #include "util/assert.ipp"
+#include "util/trace.ipp"
+#include "util/work_stealing.ipp"
 
 using std::ostream;
 
@@ -68,8 +82,11 @@ namespace flatsurf {
 
 template <typename Surface>
 FlowDecomposition<Surface>::FlowDecomposition(Surface&& surface, const Vector<T>& vertical) :
-  self(spimpl::make_unique_impl<ImplementationOf<FlowDecomposition>>(std::move(surface), vertical)) {
-  ASSERTIONS(([&]() {
+  self([&]() {
+    LIBFLATSURF_TRACE("FlowDecomposition::FlowDecomposition");
+    return spimpl::make_unique_impl<ImplementationOf<FlowDecomposition>>(std::move(surface), vertical);
+  }()) {
+  VALIDATE(([&]() {
     auto paths = components() | rx::transform([](const auto& component) { return Path(component.perimeter() | rx::transform([](const auto& connection) { return connection.saddleConnection(); }) | rx::to_vector()); }) | rx::to_vector();
     ImplementationOf<ContourDecomposition<Surface>>::check(paths, Vertical(this->surface(), vertical));
   }));
@@ -81,13 +98,110 @@ const Surface& FlowDecomposition<Surface>::surface() const {
 }
 
 template <typename Surface>
-bool FlowDecomposition<Surface>::decompose(std::function<bool(const FlowComponent<Surface>&)> target, int limit) {
-  bool targetReached = true;
-  for (auto& component : components())
-    targetReached = targetReached && component.decompose(target, limit);
+Vector<typename Surface::Coordinate> FlowDecomposition<Surface>::vertical() const {
+  return self->state->contourDecomposition.collapsed().vertical().vertical();
+}
+
+template <typename Surface>
+bool FlowDecomposition<Surface>::decompose(std::function<bool(const FlowComponent<Surface>&)> target, int limit, unsigned int threads) {
+  return decompose(target, Latency::global().decomposition(limit), threads);
+}
+
+template <typename Surface>
+bool FlowDecomposition<Surface>::decompose(std::function<bool(const FlowComponent<Surface>&)> target, const DecompositionBudget& budget, unsigned int threads) {
+  LIBFLATSURF_TRACE("FlowDecomposition::decompose");
+
+  if (threads == 0)
+    threads = Executor::global().concurrency();
+
+  auto components = this->components();
+
+  if (threads == 1 || components.size() < 2) {
+    bool targetReached = true;
+    for (auto& component : components)
+      targetReached = targetReached && component.decompose(target, budget);
+    return targetReached;
+  }
+
+  // All components query the same Vertical on the surface, see
+  // ImplementationOf<FlatTriangulation>::vertical(). We populate its caches
+  // now so that the threads only read from them.
+  const auto vertical = Vertical<Surface>(surface(), this->vertical());
+  vertical.classifyAll();
+  for (const auto he : surface().halfEdges()) {
+    vertical.orientation(he);
+    vertical.project(he);
+    vertical.projectPerpendicular(he);
+  }
+
+  // Each of the initial components comes from its own contour component and
+  // has its own interval exchange transformation, so they can be decomposed
+  // independently.
+  WorkStealing<FlowComponent<Surface>> pool(std::min<size_t>(threads, components.size()));
+  for (size_t i = 0; i < components.size(); i++)
+    pool.push(i, std::move(components[i]));
+
+  std::atomic<bool> targetReached = true;
+
+  self->state->parallel = true;
+  try {
+    pool.run([&](size_t, FlowComponent<Surface>&& component) {
+      if (!component.decompose(target, budget))
+        targetReached = false;
+    });
+  } catch (...) {
+    self->state->parallel = false;
+    throw;
+  }
+  self->state->parallel = false;
+
   return targetReached;
 }
 
+template <typename Surface>
+boost::logic::tribool FlowDecomposition<Surface>::decomposeUntil(std::function<boost::logic::tribool(const FlowDecomposition&)> predicate, int limit) {
+  return decomposeUntil(std::move(predicate), Latency::global().decomposition(limit));
+}
+
+template <typename Surface>
+boost::logic::tribool FlowDecomposition<Surface>::decomposeUntil(std::function<boost::logic::tribool(const FlowDecomposition&)> predicate, const DecompositionBudget& budget) {
+  // Whether the component at this position of components() has exceeded the
+  // limit. Components that split off are appended to components() so the
+  // positions of existing components do not change.
+  std::vector<bool> exhausted;
+
+  while (true) {
+    const boost::logic::tribool decided = predicate(*this);
+    if (!boost::logic::indeterminate(decided))
+      return decided;
+
+    auto components = this->components();
+    exhausted.resize(components.size(), false);
+
+    bool progress = false;
+    for (size_t i = 0; i < components.size(); i++) {
+      if (exhausted[i] || defaultTarget(components[i]))
+        continue;
+
+      // Perform a single decomposition step: the target is only checked
+      // again after that step. (Components split off by that step see a
+      // copy of this target that is already satisfied.)
+      const bool stepped = components[i].decompose([steps = 0](const FlowComponent<Surface>&) mutable { return steps++ > 0; }, budget);
+
+      if (budget.exhausted())
+        return predicate(*this);
+
+      if (!stepped)
+        exhausted[i] = true;
+
+      progress = true;
+    }
+
+    if (!progress)
+      return decided;
+  }
+}
+
 template <typename Surface>
 std::vector<FlowComponent<Surface>> FlowDecomposition<Surface>::components() const {
   std::vector<FlowComponent<Surface>> components;
@@ -98,21 +212,106 @@ std::vector<FlowComponent<Surface>> FlowDecomposition<Surface>::components() con
 }
 
 template <typename Surface>
-FlatTriangulation<typename Surface::Coordinate> FlowDecomposition<Surface>::triangulation() const {
-  std::unordered_map<HalfEdge, Vector<T>> vectors;
-  const auto triangulations = components() | rx::transform([](const auto& component) { return component.triangulation(); }) | rx::to_vector();
-  const auto faces = triangulations | rx::transform([&](const auto& triangulation) {
-    const auto embedding = triangulation.embedding();
-    for (auto localHalfEdge : triangulation.triangulation().halfEdges())
-      vectors[embedding[localHalfEdge]] = triangulation.triangulation().fromHalfEdge(localHalfEdge);
-    return triangulation.triangulation().faces() | rx::transform([&](const auto& face) {
-      return std::tuple{embedding[std::get<0>(face)], embedding[std::get<1>(face)], embedding[std::get<2>(face)]};
-    }) | rx::to_vector();
-  }) | rx::to_vector() |
-                     rx::flatten<1>() | rx::to_vector();
+void FlowDecomposition<Surface>::compact() {
+  auto& state = *self->state;
+
+  // Several components might share the lengths of the same interval exchange
+  // transformation. These lengths are only needed by the components that
+  // can be decomposed further.
+  std::unordered_map<const IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>*, bool> finished;
+  for (auto& component : state.components) {
+    const auto entry = finished.try_emplace(component.iet.get(), true).first;
+    entry->second = entry->second && defaultTarget(ImplementationOf<FlowComponent<Surface>>::make(self->state, &component));
+  }
+
+  for (const auto& [iet, done] : finished)
+    if (done)
+      ImplementationOf<IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>>::self(*iet).lengths->compact();
+
+  state.embedding.reset();
+  state.injectedConnections.rehash(0);
+  state.detectedConnections.rehash(0);
+}
+
+template <typename Surface>
+FlowDecompositionSummary<Surface> FlowDecomposition<Surface>::summary() const {
+  using Summary = FlowDecompositionSummary<Surface>;
+
+  Summary summary{vertical(), {}};
+
+  for (const auto& component : components()) {
+    const auto& metrics = component.summary();
+
+    typename Summary::Component snapshot{
+        metrics.cylinder,
+        component.withoutPeriodicTrajectory(),
+        component.keane(),
+        metrics.area,
+        metrics.width,
+        metrics.circumferenceHolonomy,
+        {}};
+
+    for (const auto& connection : component.perimeter()) {
+      const auto saddleConnection = connection.saddleConnection();
+      snapshot.perimeter.push_back({saddleConnection.source(), saddleConnection.target(), saddleConnection.vector(), connection.vertical()});
+    }
+
+    summary.components.emplace_back(std::move(snapshot));
+  }
+
+  return summary;
+}
+
+template <typename Surface>
+FlatTriangulation<typename Surface::Coordinate> FlowDecomposition<Surface>::triangulation(unsigned int threads) const {
+  if (threads == 0)
+    threads = Executor::global().concurrency();
+
+  const auto components = this->components();
+
+  // The embedding is computed lazily and shared by all components, so we
+  // compute it before triangulating the components in parallel.
+  ImplementationOf<FlowDecomposition>::embedding(*self->state);
 
-  return FlatTriangulation<T>(FlatTriangulationCombinatorial(faces), [&](const HalfEdge he) {
-    return vectors.at(he);
+  std::vector<std::optional<FlowTriangulation<Surface>>> triangulations(components.size());
+  if (threads == 1 || components.size() < 2) {
+    for (size_t i = 0; i < components.size(); i++)
+      triangulations[i] = components[i].triangulation();
+  } else {
+    WorkStealing<size_t> pool(std::min<size_t>(threads, components.size()));
+    for (size_t i = 0; i < components.size(); i++)
+      pool.push(i, i);
+    pool.run([&](size_t, size_t i) { triangulations[i] = components[i].triangulation(); });
+  }
+
+  // Every half edge of the glued triangulation shows up in exactly one of
+  // the faces of the components, so we can allocate everything upfront.
+  size_t faceCount = 0;
+  for (const auto& triangulation : triangulations)
+    faceCount += triangulation->triangulation().faces().size();
+
+  std::vector<std::tuple<HalfEdge, HalfEdge, HalfEdge>> faces;
+  faces.reserve(faceCount);
+  std::vector<std::optional<Vector<T>>> vectors(3 * faceCount);
+
+  for (const auto& triangulation : triangulations) {
+    const auto& local = triangulation->triangulation();
+    const auto embedding = triangulation->embedding();
+    for (auto localHalfEdge : local.halfEdges()) {
+      // Boundary half edges are not embedded anywhere.
+      if (local.boundary(localHalfEdge))
+        continue;
+      const HalfEdge he = embedding[localHalfEdge];
+      ASSERT(he.index() < vectors.size(), "half edge " << he << " is not in the range of half edges of the glued triangulation");
+      vectors[he.index()] = local.fromHalfEdge(localHalfEdge);
+    }
+    for (const auto& face : local.faces())
+      faces.emplace_back(embedding[std::get<0>(face)], embedding[std::get<1>(face)], embedding[std::get<2>(face)]);
+  }
+
+  return ImplementationOf<FlatTriangulation<T>>::make(FlatTriangulationCombinatorial(faces), [&](const HalfEdge he) {
+    ASSERT(he.index() < vectors.size() && vectors[he.index()], "half edge " << he << " not in any of the component triangulations");
+    return *vectors[he.index()];
   });
 }
 
@@ -128,29 +327,53 @@ boost::logic::tribool FlowDecomposition<Surface>::hasCylinder() const {
 
 template <typename Surface>
 boost::logic::tribool FlowDecomposition<Surface>::completelyPeriodic() const {
+  boost::logic::tribool state = true;
   for (auto& component : components()) {
-    boost::logic::tribool state = component.cylinder();
-    if (state != true) return state;
+    state = state && component.cylinder();
+    if (!state) return false;
   }
-  return true;
+  return state;
 }
 
 template <typename Surface>
 boost::logic::tribool FlowDecomposition<Surface>::parabolic() const {
-  T a0(0), hnorm20(0);
+  const auto components = this->components();
+
+  // A single component that is not a cylinder decides the question without
+  // computing any moduli.
   boost::logic::tribool ans = true;
-  for (auto& component : components()) {
+  for (const auto& component : components) {
     boost::logic::tribool state = component.cylinder();
     if (state == false) return false;
     ans = ans && state;
-    Vector<T> h = component.circumferenceHolonomy();
+  }
+
+  // Rational moduli are always commensurable.
+  if constexpr (std::is_same_v<T, long long> || std::is_same_v<T, mpz_class> || std::is_same_v<T, mpq_class>)
+    return ans;
+
+  T a0(0), hnorm20(0);
+  for (const auto& component : components) {
+    // Only cylinders have a modulus. Since a single pair of incommensurable
+    // moduli decides the question, we keep going with the other components.
+    if (boost::logic::indeterminate(component.cylinder())) continue;
+    const auto& summary = component.summary();
+    const Vector<T>& h = *summary.circumferenceHolonomy;
     T hnorm2 = h.x() * h.x() + h.y() * h.y();
-    T a = component.area();
+    const T& a = summary.area;
     if (hnorm20 == 0) {
       hnorm20 = hnorm2;
       a0 = a;
     } else {
-      auto [u, v] = intervalxt::sample::Coefficients<>()(static_cast<T>(a0 * hnorm2), static_cast<T>(a * hnorm20));
+      const auto lhs = Enclosure<T>(a0 * hnorm2);
+      const auto rhs = Enclosure<T>(a * hnorm20);
+
+      // Equal moduli, as is typical for the cylinders of Veech surfaces, are
+      // trivially commensurable. The balls settle most other cases before
+      // we need to compare exactly.
+      if (lhs.cmp(rhs) == 0) continue;
+
+      auto [u, v] = intervalxt::sample::Coefficients<>()(static_cast<const T&>(lhs), static_cast<const T&>(rhs));
       size_t i0 = 0;
       while (i0 < u.size() && u[i0] == 0 && v[i0] == 0)
         i0++;
@@ -174,35 +397,56 @@ ImplementationOf<FlowDecomposition<Surface>>::ImplementationOf(std::shared_ptr<F
 
 template <typename Surface>
 Edge ImplementationOf<FlowDecomposition<Surface>>::firstInnerEdge(const FlowComponent<Surface>& component) {
-  size_t perimeterHalfEdges = 0;
-  for (const auto& other : component.decomposition().components())
-    perimeterHalfEdges += other.perimeter().size();
-  ASSERT(perimeterHalfEdges % 2 == 0, "edges on the perimeter must come in pairs");
-
-  size_t innerHalfEdges = 0;
-  for (const auto& other : component.decomposition().components()) {
-    if (other == component) break;
-    ASSERT(other.perimeter().size() >= 4, "component has no area");
-    innerHalfEdges += 2 * (other.perimeter().size() - 3);
-  }
-
-  return Edge(static_cast<int>((perimeterHalfEdges + innerHalfEdges) / 2 + 1));
+  const auto& impl = ImplementationOf<FlowComponent<Surface>>::self(component);
+  return embedding(*impl.state).firstInnerEdges.at(impl.component);
 }
 
 template <typename Surface>
 HalfEdge ImplementationOf<FlowDecomposition<Surface>>::halfEdge(const FlowConnection<Surface>& connection) {
-  std::unordered_map<FlowConnection<Surface>, HalfEdge> toHalfEdge;
-  for (const auto component : connection.component().decomposition().components()) {
-    for (const auto other : component.perimeter()) {
-      if (toHalfEdge.find(other) == toHalfEdge.end()) {
-        toHalfEdge[other] = HalfEdge(static_cast<int>(toHalfEdge.size() / 2 + 1));
-        toHalfEdge[-other] = -toHalfEdge.at(other);
+  const auto& halfEdges = embedding(*ImplementationOf<FlowComponent<Surface>>::self(connection.component()).state).halfEdges;
+  const auto it = halfEdges.find(connection);
+  if (it == halfEdges.end())
+    UNREACHABLE("connection does not show up in this decomposition");
+  return it->second;
+}
+
+template <typename Surface>
+const typename FlowDecompositionState<Surface>::Embedding& ImplementationOf<FlowDecomposition<Surface>>::embedding(FlowDecompositionState<Surface>& state) {
+  if (!state.embedding) {
+    typename FlowDecompositionState<Surface>::Embedding embedding;
+
+    // The connections on the perimeters are numbered first in order of
+    // appearance; the inner edges of the components follow.
+    std::vector<size_t> perimeters;
+    for (auto& component : state.components) {
+      const auto perimeter = ImplementationOf<FlowComponent<Surface>>::make(state.shared_from_this(), &component).perimeter();
+      perimeters.push_back(perimeter.size());
+      for (const auto& connection : perimeter) {
+        if (embedding.halfEdges.find(connection) == embedding.halfEdges.end()) {
+          const auto halfEdge = HalfEdge(static_cast<int>(embedding.halfEdges.size() / 2 + 1));
+          embedding.halfEdges[connection] = halfEdge;
+          embedding.halfEdges[-connection] = -halfEdge;
+        }
+      }
+    }
+
+    const size_t perimeterHalfEdges = std::accumulate(begin(perimeters), end(perimeters), size_t{});
+    ASSERT(perimeterHalfEdges % 2 == 0, "edges on the perimeter must come in pairs");
+
+    size_t innerHalfEdges = 0;
+    size_t i = 0;
+    for (auto& component : state.components) {
+      embedding.firstInnerEdges[&component] = Edge(static_cast<int>((perimeterHalfEdges + innerHalfEdges) / 2 + 1));
+      if (++i < perimeters.size()) {
+        ASSERT(perimeters[i - 1] >= 4, "component has no area");
+        innerHalfEdges += 2 * (perimeters[i - 1] - 3);
       }
-      if (other == connection || other == -connection)
-        return toHalfEdge.at(connection);
     }
+
+    state.embedding = std::move(embedding);
   }
-  UNREACHABLE("connection does not show up in this decomposition");
+
+  return *state.embedding;
 }
 
 template <typename Surface>
@@ -0,0 +1,379 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/flow_decompositions.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <set>
+
+#include "../flatsurf/decomposition_budget.hpp"
+#include "../flatsurf/executor.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/flow_component.hpp"
+#include "../flatsurf/flow_decomposition_summary.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connections_by_length.hpp"
+#include "../flatsurf/saddle_connections_by_length_iterator.hpp"
+#include "../flatsurf/vector.hpp"
+#include "impl/flow_decompositions.impl.hpp"
+#include "util/work_stealing.ipp"
+
+namespace flatsurf {
+
+namespace {
+
+// Orders vectors by their direction, i.e., two vectors are equivalent in
+// this order iff they are positive multiples of each other.
+template <typename T>
+struct CompareDirection {
+  bool operator()(const Vector<T>& lhs, const Vector<T>& rhs) const {
+    const bool lhsUpper = lhs.y() > 0 || (!lhs.y() && lhs.x() > 0);
+    const bool rhsUpper = rhs.y() > 0 || (!rhs.y() && rhs.x() > 0);
+    if (lhsUpper != rhsUpper)
+      return lhsUpper;
+    return typename Vector<T>::CompareSlope()(lhs, rhs);
+  }
+};
+
+// Enumerate the directions of connections on the calling thread and run
+// work on each direction that is not a positive multiple of an earlier one,
+// see FlowDecompositions::survey(). The results of work are handed to report
+// which is never invoked concurrently; once report returns false, no further
+// directions are enumerated or worked on.
+template <typename Surface, typename Work, typename Report>
+void pipeline(const SaddleConnectionsByLength<Surface>& connections, const Work& work, const Report& report, unsigned int threads, size_t capacity) {
+  using T = typename Surface::Coordinate;
+
+  if (threads == 0)
+    threads = Executor::global().concurrency();
+  if (capacity == 0)
+    capacity = 4 * static_cast<size_t>(threads);
+
+  // The directions waiting to be decomposed, shared between the calling
+  // thread which enumerates them and the workers which decompose them.
+  std::mutex lock;
+  std::condition_variable changed;
+  std::deque<Vector<T>> queue;
+  // Set once all connections have been enumerated.
+  bool exhausted = false;
+  // Set once report asked us to stop or work failed.
+  std::atomic<bool> cancelled{false};
+  std::exception_ptr error;
+
+  // Serializes the invocations of report.
+  std::mutex reporting;
+
+  const auto cancel = [&](std::exception_ptr failure) {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      if (failure && !error)
+        error = failure;
+      cancelled = true;
+    }
+    changed.notify_all();
+  };
+
+  const auto decompose = [&](const Vector<T>& direction) {
+    try {
+      const auto result = work(direction);
+
+      std::lock_guard<std::mutex> guard(reporting);
+      if (cancelled)
+        return;
+      if (!report(direction, result))
+        cancel(nullptr);
+    } catch (...) {
+      cancel(std::current_exception());
+    }
+  };
+
+  // Decompose queued directions until the enumeration is done and the queue
+  // has been drained.
+  const auto work = [&]() {
+    while (true) {
+      Vector<T> direction;
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [&]() { return cancelled || exhausted || !queue.empty(); });
+        if (cancelled || queue.empty())
+          return;
+        direction = std::move(queue.front());
+        queue.pop_front();
+      }
+      changed.notify_all();
+      decompose(direction);
+    }
+  };
+
+  // The workers are run by the executor. As in WorkStealing, workers that
+  // start only after the calling thread is done, do nothing.
+  struct Workers {
+    std::mutex lock;
+    std::condition_variable stopped;
+    size_t running = 0;
+    bool closed = false;
+  };
+  const auto workers = std::make_shared<Workers>();
+
+  const auto executor = Executor::global();
+  for (unsigned int worker = 1; worker < threads; worker++)
+    executor.submit([workers, &work]() {
+      {
+        std::lock_guard<std::mutex> guard(workers->lock);
+        if (workers->closed)
+          return;
+        workers->running++;
+      }
+      work();
+      {
+        std::lock_guard<std::mutex> guard(workers->lock);
+        workers->running--;
+      }
+      workers->stopped.notify_all();
+    });
+
+  try {
+    std::set<Vector<T>, CompareDirection<T>> seen;
+    for (const auto& connection : connections) {
+      if (cancelled)
+        break;
+
+      const auto& direction = connection.vector();
+      if (!seen.insert(direction).second)
+        continue;
+
+      std::optional<Vector<T>> next;
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        queue.push_back(direction);
+        if (queue.size() > capacity) {
+          // Instead of waiting for the workers to catch up, we help them.
+          next = std::move(queue.front());
+          queue.pop_front();
+        }
+      }
+      changed.notify_all();
+
+      if (next)
+        decompose(*next);
+    }
+  } catch (...) {
+    cancel(std::current_exception());
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    exhausted = true;
+  }
+  changed.notify_all();
+
+  // The calling thread drains the queue together with the workers.
+  work();
+
+  {
+    std::unique_lock<std::mutex> guard(workers->lock);
+    workers->closed = true;
+    workers->stopped.wait(guard, [&]() { return workers->running == 0; });
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+}  // namespace
+
+template <typename Surface>
+FlowDecompositions<Surface>::FlowDecompositions(const Surface& surface, std::vector<Vector<T>> directions) :
+  self(spimpl::make_unique_impl<ImplementationOf<FlowDecompositions>>(surface, std::move(directions))) {}
+
+template <typename Surface>
+void FlowDecompositions<Surface>::forEach(const std::function<bool(FlowDecomposition<Surface>&&, bool)>& callback, std::function<bool(const FlowComponent<Surface>&)> target, int limit, unsigned int threads) const {
+  if (self->directions.empty())
+    return;
+
+  if (threads == 0)
+    threads = Executor::global().concurrency();
+
+  // Set once callback asked us to stop.
+  std::atomic<bool> cancelled{false};
+
+  // Serializes the invocations of callback.
+  std::mutex lock;
+
+  // Each task is the index of a direction.
+  WorkStealing<size_t> pool(std::min<size_t>(threads, self->directions.size()));
+  for (size_t i = 0; i < self->directions.size(); i++)
+    pool.push(i, i);
+
+  pool.run([&](size_t, size_t direction) {
+    if (cancelled)
+      return;
+
+    // Each decomposition consumes its surface, so it works on its own clone
+    // of the shared surface.
+    auto decomposition = FlowDecomposition<Surface>(self->surface.clone(), self->directions[direction]);
+    const bool decomposed = decomposition.decompose(target, limit);
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (cancelled)
+      return;
+    if (!callback(std::move(decomposition), decomposed))
+      cancelled = true;
+  });
+}
+
+template <typename Surface>
+void FlowDecompositions<Surface>::forEachSummary(const std::function<bool(const Vector<T>&, const FlowDecompositionSummary<Surface>&, bool)>& callback, std::function<bool(const FlowComponent<Surface>&)> target, int limit, unsigned int threads) const {
+  if (self->directions.empty())
+    return;
+
+  if (threads == 0)
+    threads = Executor::global().concurrency();
+
+  // The indices of the directions grouped by their direction. Only the first
+  // direction of each group is actually decomposed.
+  std::vector<std::vector<size_t>> groups;
+  {
+    std::map<Vector<T>, size_t, CompareDirection<T>> representatives;
+    for (size_t i = 0; i < self->directions.size(); i++) {
+      const auto [group, inserted] = representatives.try_emplace(self->directions[i], groups.size());
+      if (inserted)
+        groups.emplace_back();
+      groups[group->second].push_back(i);
+    }
+  }
+
+  std::atomic<bool> cancelled{false};
+
+  std::mutex lock;
+
+  // Each task is the index of a group of directions.
+  WorkStealing<size_t> pool(std::min<size_t>(threads, groups.size()));
+  for (size_t i = 0; i < groups.size(); i++)
+    pool.push(i, i);
+
+  pool.run([&](size_t, size_t group) {
+    if (cancelled)
+      return;
+
+    auto decomposition = FlowDecomposition<Surface>(self->surface.clone(), self->directions[groups[group][0]]);
+    const bool decomposed = decomposition.decompose(target, limit);
+    const auto summary = decomposition.summary();
+
+    std::lock_guard<std::mutex> guard(lock);
+    for (const size_t direction : groups[group]) {
+      if (cancelled)
+        return;
+      if (!callback(self->directions[direction], summary, decomposed))
+        cancelled = true;
+    }
+  });
+}
+
+template <typename Surface>
+void FlowDecompositions<Surface>::survey(const SaddleConnectionsByLength<Surface>& connections, const std::function<bool(const Vector<T>&, const FlowDecompositionSummary<Surface>&, bool)>& callback, std::function<bool(const FlowComponent<Surface>&)> target, int limit, unsigned int threads, size_t capacity) {
+  const Surface& surface = connections.surface();
+
+  pipeline(
+      connections,
+      [&](const Vector<T>& direction) {
+        auto decomposition = FlowDecomposition<Surface>(surface.clone(), direction);
+        const bool decomposed = decomposition.decompose(target, limit);
+        return std::pair{decomposition.summary(), decomposed};
+      },
+      [&](const Vector<T>& direction, const auto& result) {
+        return callback(direction, result.first, result.second);
+      },
+      threads,
+      capacity);
+}
+
+template <typename Surface>
+void FlowDecompositions<Surface>::cylinders(const SaddleConnectionsByLength<Surface>& connections, const std::function<bool(const Vector<T>&, size_t, boost::logic::tribool)>& callback, std::optional<size_t> steps, const DecompositionBudget& budget, unsigned int threads, size_t capacity) {
+  const Surface& surface = connections.surface();
+
+  pipeline(
+      connections,
+      [&](const Vector<T>& direction) {
+        if (budget.exhausted())
+          return std::pair<size_t, boost::logic::tribool>{0, boost::logic::indeterminate};
+
+        // Each direction gets a fresh budget of steps; the overall budget
+        // is only consulted in between the steps of the decomposition.
+        const DecompositionBudget local(steps, std::nullopt, budget.limit());
+
+        auto decomposition = FlowDecomposition<Surface>(surface.clone(), direction);
+        decomposition.decomposeUntil([&](const FlowDecomposition<Surface>& decomposition) -> boost::logic::tribool {
+          const auto hasCylinder = decomposition.hasCylinder();
+          // Stop once the overall budget runs out. The status reported is
+          // then still undecided.
+          if (boost::logic::indeterminate(hasCylinder) && budget.exhausted())
+            return false;
+          return hasCylinder;
+        }, local);
+
+        size_t cylinders = 0;
+        for (const auto& component : decomposition.components())
+          if (component.cylinder())
+            cylinders++;
+
+        return std::pair<size_t, boost::logic::tribool>{cylinders, decomposition.hasCylinder()};
+      },
+      [&](const Vector<T>& direction, const auto& result) {
+        return callback(direction, result.first, result.second);
+      },
+      threads,
+      capacity);
+}
+
+template <typename Surface>
+const Surface& FlowDecompositions<Surface>::surface() const {
+  return self->surface;
+}
+
+template <typename Surface>
+const std::vector<Vector<typename Surface::Coordinate>>& FlowDecompositions<Surface>::directions() const {
+  return self->directions;
+}
+
+template <typename Surface>
+ImplementationOf<FlowDecompositions<Surface>>::ImplementationOf(const Surface& surface, std::vector<Vector<T>>&& directions) :
+  surface(surface.clone()),
+  directions(std::move(directions)) {}
+
+template <typename Surface>
+std::ostream& operator<<(std::ostream& os, const FlowDecompositions<Surface>& self) {
+  return os << "FlowDecompositions of " << self.surface() << " in " << self.directions().size() << " directions";
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), FlowDecompositions, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
@@ -33,6 +33,7 @@
 #include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/vertical.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
+#include "impl/flat_triangulation.impl.hpp"
 #include "impl/flow_decomposition.impl.hpp"
 #include "impl/flow_triangulation.impl.hpp"
 #include "util/assert.ipp"
@@ -236,7 +237,7 @@ ImplementationOf<FlowTriangulation<Surface>>::ImplementationOf(const FlowCompone
     }
   }
 
-  triangulation = FlatTriangulation<T>(FlatTriangulationCombinatorial(faces), [&](const HalfEdge he) {
+  triangulation = ImplementationOf<FlatTriangulation<T>>::make(FlatTriangulationCombinatorial(faces), [&](const HalfEdge he) {
     return vectors[he];
   });
 
@@ -0,0 +1,209 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/geodesic_flow.hpp"
+
+#include <ostream>
+
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/vector.hpp"
+#include "impl/flat_triangulation.impl.hpp"
+#include "impl/geodesic_flow.impl.hpp"
+#include "util/assert.ipp"
+
+namespace flatsurf {
+
+template <typename Surface>
+GeodesicFlow<Surface>::GeodesicFlow(const Surface& surface) :
+  self(spimpl::make_unique_impl<ImplementationOf<GeodesicFlow>>(surface)) {}
+
+template <typename Surface>
+size_t GeodesicFlow<Surface>::step(const T& a, const T& d) {
+  CHECK_ARGUMENT(a > 0 && d > 0, "diagonal entries must be positive");
+
+  size_t flips = 0;
+
+  const int direction = a > d ? 1 : a < d ? -1 : 0;
+
+  if (direction) {
+    if (direction != self->direction)
+      self->reschedule(direction);
+
+    // The surface at the end of this step is the image of self->surface
+    // under diag(√(p/q), 1) up to scaling.
+    const T x = self->a * a;
+    const T y = self->d * d;
+    const T p = x * x;
+    const T q = y * y;
+
+    // Flip the edges that stop being Delaunay before the end of this step
+    // in the order in which this happens.
+    while (!self->events.empty()) {
+      const Edge next = *self->events.begin();
+      const auto& [A, B] = self->coefficients[next.index()];
+      if (A * p + B * q <= 0)
+        break;
+
+      self->flip(next.positive());
+      flips++;
+    }
+  }
+
+  self->a *= a;
+  self->d *= d;
+
+  return flips;
+}
+
+template <typename Surface>
+const Surface& GeodesicFlow<Surface>::surface() const {
+  self->materialize();
+  return self->surface;
+}
+
+template <typename Surface>
+ImplementationOf<GeodesicFlow<Surface>>::ImplementationOf(const Surface& surface) :
+  surface(surface.clone()),
+  a(1),
+  d(1),
+  events(Earlier{this}) {
+  this->surface.delaunay();
+}
+
+template <typename Surface>
+std::pair<typename Surface::Coordinate, typename Surface::Coordinate> ImplementationOf<GeodesicFlow<Surface>>::incircle(Edge edge) const {
+  // We use the same coordinates as FlatTriangulation::delaunay(Edge), i.e.,
+  // the quadrilateral (a, b, c, d) with d = (0, 0). Replacing (x, y) with
+  // (√r·x, y) turns the squared lengths x² + y² in the determinant into
+  // r·x² + y², so the determinant is √r·(A·r + B).
+  const auto ca = surface.fromHalfEdge(edge.positive());
+  const auto cb = surface.fromHalfEdge(surface.nextAtVertex(edge.positive()));
+  const auto dc = surface.fromHalfEdge(-surface.nextInFace(edge.negative()));
+
+  const Vector<T> a = dc + ca;
+  const Vector<T> b = dc + cb;
+  const Vector<T>& c = dc;
+
+  const auto det = [&](const T& la, const T& lb, const T& lc) -> T {
+    return a.x() * (b.y() * lc - lb * c.y()) - b.x() * (a.y() * lc - c.y() * la) + c.x() * (a.y() * lb - b.y() * la);
+  };
+
+  return {
+      det(a.x() * a.x(), b.x() * b.x(), c.x() * c.x()),
+      det(a.y() * a.y(), b.y() * b.y(), c.y() * c.y())};
+}
+
+template <typename Surface>
+void ImplementationOf<GeodesicFlow<Surface>>::materialize() const {
+  if (a == T(1) && d == T(1))
+    return;
+
+  ImplementationOf<Surface>::transform(surface, a, T(), T(), d);
+
+  // The in-circle polynomials of the transformed surface are obtained by
+  // substituting r·a²/d² for r. Since this scales all the times by the same
+  // factor, the order of the queue is not affected.
+  const T aa = a * a;
+  const T dd = d * d;
+  for (auto& [A, B] : coefficients) {
+    A *= aa;
+    B *= dd;
+  }
+
+  a = T(1);
+  d = T(1);
+}
+
+template <typename Surface>
+void ImplementationOf<GeodesicFlow<Surface>>::reschedule(int direction) {
+  this->direction = direction;
+
+  events.clear();
+  scheduled.assign(surface.size(), std::nullopt);
+  coefficients.assign(surface.size(), {T(), T()});
+
+  for (const auto edge : surface.edges())
+    schedule(edge);
+}
+
+template <typename Surface>
+void ImplementationOf<GeodesicFlow<Surface>>::flip(HalfEdge e) {
+  // The flip only changes the quadrilateral around e, so only the Delaunay
+  // condition of its edges can change.
+  const Edge quadrilateral[] = {e, surface.nextInFace(e), surface.previousInFace(e), surface.nextInFace(-e), surface.previousInFace(-e)};
+
+  for (const auto edge : quadrilateral)
+    unschedule(edge);
+
+  // A quadrilateral is convex in the surface at the current time iff it is
+  // convex in the surface at the start of the flow, so we can flip there.
+  surface.flip(e);
+
+  for (const auto edge : quadrilateral)
+    schedule(edge);
+}
+
+template <typename Surface>
+void ImplementationOf<GeodesicFlow<Surface>>::schedule(Edge edge) {
+  if (surface.boundary(edge.positive()) || surface.boundary(edge.negative()))
+    return;
+
+  coefficients[edge.index()] = incircle(edge);
+
+  // The edge stops being Delaunay at r = -B/A if the in-circle determinant
+  // grows in the direction of the flow.
+  const T& A = coefficients[edge.index()].first;
+  if (direction > 0 ? A > 0 : A < 0)
+    scheduled[edge.index()] = events.insert(edge);
+}
+
+template <typename Surface>
+void ImplementationOf<GeodesicFlow<Surface>>::unschedule(Edge edge) {
+  if (scheduled[edge.index()]) {
+    events.erase(*scheduled[edge.index()]);
+    scheduled[edge.index()] = std::nullopt;
+  }
+}
+
+template <typename Surface>
+bool ImplementationOf<GeodesicFlow<Surface>>::Earlier::operator()(Edge lhs, Edge rhs) const {
+  // Compare the times -B/A of the edges. The signs of the A agree, so we can
+  // compare without dividing.
+  const auto& [la, lb] = flow->coefficients[lhs.index()];
+  const auto& [ra, rb] = flow->coefficients[rhs.index()];
+
+  const T l = la * rb;
+  const T r = ra * lb;
+
+  return flow->direction > 0 ? l < r : l > r;
+}
+
+template <typename Surface>
+std::ostream& operator<<(std::ostream& os, const GeodesicFlow<Surface>& self) {
+  return os << "Geodesic flow on " << self.surface();
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), GeodesicFlow, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
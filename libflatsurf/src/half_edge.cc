@@ -29,54 +29,11 @@ using std::ostream;
 
 namespace flatsurf {
 
-HalfEdge::HalfEdge(PrivateConstructor, size_t idx) :
-  idx(idx) {
-}
-
 HalfEdge::HalfEdge(const int id) :
   HalfEdge(PrivateConstructor{}, id > 0 ? (2 * (id - 1)) : (-2 * id - 1)) {
   ASSERT_ARGUMENT(id != 0, "id must be non-zero");
 }
 
-HalfEdge HalfEdge::fromIndex(const size_t index) {
-  return HalfEdge(PrivateConstructor{}, index);
-}
-
-HalfEdge::HalfEdge() noexcept :
-  HalfEdge(PrivateConstructor{}, static_cast<size_t>(-1)) {}
-
-int HalfEdge::id() const {
-  ASSERT(idx != static_cast<size_t>(-1), "id must be non-zero");
-  return (idx % 2 ? -1 : 1) * static_cast<int>(idx / 2 + 1);
-}
-
-HalfEdge HalfEdge::operator-() const {
-  return HalfEdge::fromIndex(idx ^ static_cast<size_t>(1));
-}
-
-HalfEdge &HalfEdge::operator=(const HalfEdge &rhs) noexcept {
-  idx = rhs.idx;
-  ASSERT(idx != static_cast<size_t>(-1), "id must be non-zero");
-  return *this;
-}
-
-bool HalfEdge::operator==(const HalfEdge &rhs) const {
-  return idx == rhs.idx;
-}
-
-size_t HalfEdge::index() const {
-  ASSERT(idx != static_cast<size_t>(-1), "id must be non-zero");
-  return idx;
-}
-
-Edge HalfEdge::edge() const {
-  return Edge(*this);
-}
-
 ostream &operator<<(ostream &os, const HalfEdge &self) { return os << self.id(); }
 
 }  // namespace flatsurf
-
-size_t std::hash<flatsurf::HalfEdge>::operator()(const flatsurf::HalfEdge &e) const {
-  return static_cast<size_t>(e.index());
-}
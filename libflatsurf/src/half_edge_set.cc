@@ -56,6 +56,21 @@ bool HalfEdgeSet::disjoint(const HalfEdgeSet& rhs) const {
   return self->disjoint(*rhs.self);
 }
 
+HalfEdgeSet& HalfEdgeSet::operator|=(const HalfEdgeSet& rhs) {
+  *self |= *rhs.self;
+  return *this;
+}
+
+HalfEdgeSet& HalfEdgeSet::operator&=(const HalfEdgeSet& rhs) {
+  *self &= *rhs.self;
+  return *this;
+}
+
+HalfEdgeSet& HalfEdgeSet::operator-=(const HalfEdgeSet& rhs) {
+  *self -= *rhs.self;
+  return *this;
+}
+
 bool HalfEdgeSet::empty() const {
   return self->empty();
 }
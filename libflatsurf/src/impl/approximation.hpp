@@ -21,6 +21,7 @@
 #define LIBFLATSURF_IMPL_APPROXIMATION_HPP
 
 #include <exact-real/arb.hpp>
+#include <vector>
 
 namespace flatsurf {
 
@@ -30,6 +31,12 @@ class Approximation final {
   Approximation() = delete;
 
   static exactreal::Arb arb(const T& value, slong prec = exactreal::ARB_PRECISION_FAST);
+
+  // Return the approximations of all the values. For elements of exact-real
+  // modules, the generators of each module are only approximated once and
+  // each value is then approximated as a linear combination of these
+  // generators.
+  static std::vector<exactreal::Arb> arb(const std::vector<const T*>& values, slong prec = exactreal::ARB_PRECISION_FAST);
 };
 
 }  // namespace flatsurf
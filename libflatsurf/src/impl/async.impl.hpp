@@ -0,0 +1,48 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_ASYNC_IMPL_HPP
+#define LIBFLATSURF_ASYNC_IMPL_HPP
+
+#include <functional>
+#include <future>
+
+#include "../../flatsurf/async.hpp"
+#include "read_only.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+class ImplementationOf<Async<Surface>> {
+  using Executor = typename Async<Surface>::Executor;
+
+ public:
+  ImplementationOf(const Surface&, Executor);
+
+  // Run task on the executor and return a future for its result.
+  template <typename R>
+  std::future<R> run(std::function<R()> task) const;
+
+  ReadOnly<Surface> surface;
+  Executor executor;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -20,10 +20,15 @@
 #ifndef LIBFLATSURF_CHAIN_IMPL_HPP
 #define LIBFLATSURF_CHAIN_IMPL_HPP
 
+#include <flint/fmpz.h>
 #include <gmpxx.h>
 
+#include <array>
+#include <cstdint>
 #include <exact-real/arb.hpp>
+#include <mutex>
 #include <optional>
+#include <vector>
 
 #include "../../flatsurf/chain.hpp"
 #include "../../flatsurf/edge_map.hpp"
@@ -43,25 +48,99 @@ class ImplementationOf<Chain<Surface>> {
   ImplementationOf(ImplementationOf&&);
   ImplementationOf(const Surface&);
   ImplementationOf(const Surface&, HalfEdge);
+  ImplementationOf(const Surface&, const std::vector<mpz_class>&);
 
   ~ImplementationOf();
 
   ImplementationOf& operator=(const ImplementationOf&) = delete;
   ImplementationOf& operator=(ImplementationOf&&) = delete;
 
+  // Make this a copy of rhs without allocating new memory for the
+  // coefficients; rhs must be a chain on the same surface.
+  void assign(const ImplementationOf&);
+
   operator const Vector<T> &() const;
   operator const Vector<exactreal::Arb> &() const;
 
   static size_t hash(const Chain<Surface>&);
 
+  // Make chain hold on to surface if it currently only borrows its surface,
+  // see ReadOnly::borrow(); chain must be a chain on that surface.
+  static void own(Chain<Surface>& chain, const ReadOnly<Surface>& surface);
+
+  // Return whether the vector of lhs is shorter than the vector of rhs. This
+  // uses the squared lengths cached in the ChainVectors.
+  static bool shorter(const Chain<Surface>& lhs, const Chain<Surface>& rhs);
+
   std::optional<const mpz_class*> operator[](size_t) const;
 
+  // Return the coefficient of the edge with this index if it fits into a
+  // 64-bit integer. Unlike operator[] this never creates a GMP integer.
+  std::optional<int64_t> coefficient(size_t) const;
+
+  // Return the index of the first edge after pos with a non-zero
+  // coefficient. Return the number of edges if there is no such edge.
+  size_t next(int pos) const;
+
+  // Add c times the edge with this index, where c must fit into a small
+  // fmpz, i.e., |c| <= COEFF_MAX.
+  void add(size_t index, slong c);
+
+  // Add (or subtract if sgn is negative) the coefficients of rhs.
+  void add(const ImplementationOf& rhs, int sgn);
+
+  // Multiply all coefficients with c.
+  void mul(const mpz_class& c);
+
+  // Return whether all coefficients are zero.
+  bool zero() const;
+
+  // Return whether the coefficients are stored in the dense array
+  // `coefficients` (rather than in `sparse`.)
+  bool dense() const { return coefficients != nullptr; }
+
   ReadOnly<Surface> surface;
 
-  fmpz* coefficients;
+  // Most chains only involve a few edges. As long as that is the case, we
+  // store their non-zero coefficients in `sparse`, sorted by edge index. Once
+  // there are too many of them or one does not fit into a small fmpz, we
+  // switch to a dense array of coefficients for all the edges.
+  struct Term {
+    size_t edge;
+    slong coefficient;
+  };
+
+  static constexpr size_t SPARSE = 8;
+
+  std::array<Term, SPARSE> sparse;
+  size_t terms = 0;
+
+  // The coefficients in `sparse` as GMP integers so that operator[] can hand
+  // out pointers to them.
+  mutable std::array<mpz_class, SPARSE> promoted;
+
+  // The dense coefficients or nullptr if the coefficients are sparse.
+  fmpz* coefficients = nullptr;
+
+  // The fingerprint Σ c_e·r_e mod p of the coefficients c_e for fixed
+  // pseudo-random weights r_e, see chain.cc. It is updated whenever the
+  // coefficients change so that hashing takes constant time and different
+  // chains can usually be told apart without comparing their coefficients.
+  uint64_t fingerprint = 0;
+
+  // Guards the state that const methods change lazily, i.e., the vectors
+  // below, `promoted`, and the dense coefficients that operator[] promotes
+  // to GMP integers. This makes the const methods safe to call from several
+  // threads at once. The lock is recursive since computing one vector can
+  // require the other and the coefficients.
+  mutable std::recursive_mutex lock;
 
   mutable ChainVector<Surface, T> vector;
   mutable ChainVector<Surface, exactreal::Arb> approximateVector;
+
+ private:
+  // Switch to the dense representation of the coefficients.
+  void densify();
 };
 
 }  // namespace flatsurf
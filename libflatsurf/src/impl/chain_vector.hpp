@@ -20,10 +20,13 @@
 #ifndef LIBFLATSURF_CHAIN_VECTOR_IMPL_HPP
 #define LIBFLATSURF_CHAIN_VECTOR_IMPL_HPP
 
-#include <deque>
+#include <atomic>
+#include <boost/container/small_vector.hpp>
 #include <optional>
+#include <variant>
 
 #include "../../flatsurf/chain.hpp"
+#include "../../flatsurf/half_edge.hpp"
 
 namespace flatsurf {
 
@@ -31,6 +34,8 @@ namespace flatsurf {
 // that make up the chain; however, there are some optimizations to make this
 // more efficient than just always keeping an updated vector around in the
 // chain.
+// The const methods are safe to call from several threads at once; they
+// only take the lock of the chain when the vector needs to be computed.
 template <typename Surface, typename T>
 class ChainVector {
  public:
@@ -43,6 +48,16 @@ class ChainVector {
 
   operator const Vector<T> &() const;
 
+  // Return x² + y² of this vector. The result is cached until the vector
+  // changes. (For Arb, this is only computed to the working precision of
+  // the surface, see PrecisionPolicy.)
+  const T& squaredLength() const;
+
+  // Make this a copy of rhs without forcing rhs to compute its value.
+  void assign(const ChainVector&);
+
+  // Forget the vector, e.g., because the coefficients of the chain changed
+  // in a way that cannot be tracked.
   void reset() const;
 
   ChainVector& operator+=(const ChainVector<Surface, T>&);
@@ -68,13 +83,40 @@ class ChainVector {
 
   mutable std::optional<Vector<T>> value = std::nullopt;
 
+  // A cache of squaredLength(); it is invalidated whenever value changes.
+  mutable std::optional<T> lengthSquared = std::nullopt;
+
   enum class MOVE {
     ADD,
     SUB
   };
 
+  // A summand that has not been added to value yet. Half edges are only
+  // resolved to their vectors through the (immutable) surface of the chain
+  // when value is computed.
+  struct PendingMove {
+    MOVE move;
+    std::variant<HalfEdge, Vector<T>> summand;
+  };
+
   mutable double pendingMovesCost = 0;
-  mutable std::deque<std::pair<MOVE, Vector<T>>> pendingMoves = {};
+
+  // The pending moves, stored inline since recomputeCost() keeps the
+  // number of moves small, so that a chain does not allocate for them.
+  mutable boost::container::small_vector<PendingMove, 4> pendingMoves = {};
+
+  // Whether value is present and there are no pendingMoves, i.e., whether
+  // value can be returned without taking the lock of the chain.
+  mutable std::atomic<bool> settled = false;
+
+  // Whether lengthSquared is present.
+  mutable std::atomic<bool> lengthSettled = false;
+
+  // Update `settled` after value or pendingMoves changed.
+  void settle() const;
+
+  // Return the vector of halfEdge on the surface of the chain.
+  const Vector<T>& resolve(HalfEdge) const;
 
   template <typename S, typename TT>
   friend class ChainVector;
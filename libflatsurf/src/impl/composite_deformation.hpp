@@ -0,0 +1,47 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_COMPOSITE_DEFORMATION_IMPL_HPP
+#define LIBFLATSURF_COMPOSITE_DEFORMATION_IMPL_HPP
+
+#include "./deformation.impl.hpp"
+
+namespace flatsurf {
+
+// The composition of two deformations, i.e., first rhs and then lhs.
+template <typename Surface>
+class CompositeDeformation : ImplementationOf<Deformation<Surface>> {
+  using Implementation = spimpl::unique_impl_ptr<ImplementationOf<Deformation<Surface>>>;
+
+ public:
+  CompositeDeformation(Implementation&& lhs, Implementation&& rhs);
+
+  static Deformation<Surface> make(Implementation&& lhs, Implementation&& rhs);
+
+  std::optional<HalfEdge> operator()(HalfEdge) const override;
+
+  // The deformations that are composed. Their surfaces have been released
+  // since only their mappings of half edges are needed.
+  Implementation lhs;
+  Implementation rhs;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -21,9 +21,9 @@
 #define LIBFLATSURF_CONTOUR_COMPONENT_IMPL_COMPONENT_STATE_HPP
 
 #include <list>
-#include <unordered_set>
 
 #include "../../flatsurf/half_edge.hpp"
+#include "../../flatsurf/half_edge_set.hpp"
 #include "forward.hpp"
 
 namespace flatsurf {
@@ -32,9 +32,9 @@ class ContourComponentState {
   using T = typename Surface::Coordinate;
 
  public:
-  ContourComponentState(const ContourDecompositionState<Surface>&, const std::unordered_set<HalfEdge>&);
+  ContourComponentState(const ContourDecompositionState<Surface>&, const HalfEdgeSet&);
 
-  std::unordered_set<HalfEdge> halfEdges;
+  HalfEdgeSet halfEdges;
 
   HalfEdge large;
   // The edges on the top of this component, from right to left, oriented from right to left.
@@ -35,6 +35,7 @@ class ImplementationOf<ContourDecomposition<Surface>> {
 
  public:
   ImplementationOf(Surface, const Vector<T>&);
+  ImplementationOf(std::shared_ptr<DecompositionState>);
 
   // Verify that the lists of saddle connectionss in decomposition describe a
   // valid decomposition of the surface they are defined on.
@@ -42,6 +43,12 @@ class ImplementationOf<ContourDecomposition<Surface>> {
 
   std::shared_ptr<DecompositionState> state;
 };
+
+template <typename Surface>
+template <typename... Args>
+ContourDecomposition<Surface>::ContourDecomposition(PrivateConstructor, Args&&... args) :
+  self(spimpl::make_unique_impl<ImplementationOf<ContourDecomposition>>(std::forward<Args>(args)...)) {}
+
 }  // namespace flatsurf
 
 #endif
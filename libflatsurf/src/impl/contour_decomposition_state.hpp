@@ -20,8 +20,8 @@
 #ifndef LIBFLATSURF_CONTOUR_DECOMPOSITION_STATE_HPP
 #define LIBFLATSURF_CONTOUR_DECOMPOSITION_STATE_HPP
 
+#include <deque>
 #include <iosfwd>
-#include <list>
 
 #include "../../flatsurf/contour_component.hpp"
 #include "contour_component_state.hpp"
@@ -36,10 +36,21 @@ class ContourDecompositionState : public std::enable_shared_from_this<ContourDec
  public:
   ContourDecompositionState(Surface surface, const Vector<T>& vert);
 
+  // Create the decomposition of a surface that has already been collapsed
+  // and whose large edges have been made unique, see collapse().
+  explicit ContourDecompositionState(FlatTriangulationCollapsed<T>&& surface);
+
+  // Return the surface collapsed with respect to vertical and flipped such
+  // that each component has a unique large edge.
+  static FlatTriangulationCollapsed<T> collapse(const FlatTriangulation<T>& surface, const Vector<T>& vertical);
+
   ContourComponent<Surface> make(ComponentState* component);
 
   FlatTriangulationCollapsed<T> surface;
-  std::list<ComponentState> components;
+  // The components are never removed, so pointers to them remain valid. A
+  // deque keeps them in a few contiguous blocks instead of allocating each
+  // of them separately.
+  std::deque<ComponentState> components;
 
   template <typename S>
   friend std::ostream& operator<<(std::ostream&, const ContourDecompositionState<S>&);
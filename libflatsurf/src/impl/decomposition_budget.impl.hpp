@@ -0,0 +1,78 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_DECOMPOSITION_BUDGET_IMPL_HPP
+#define LIBFLATSURF_DECOMPOSITION_BUDGET_IMPL_HPP
+
+#include <atomic>
+#include <functional>
+#include <optional>
+
+#include "../../flatsurf/decomposition_budget.hpp"
+
+namespace flatsurf {
+
+template <>
+class ImplementationOf<DecompositionBudget> {
+  using Clock = DecompositionBudget::Clock;
+
+ public:
+  ImplementationOf(std::optional<size_t> steps, std::optional<Clock::duration> timeout, int limit, int interval);
+
+  // Return a budget that only limits each decomposition step to limit steps
+  // of the Rauzy induction. Such a budget is never checked during a
+  // decomposition step, i.e., decomposing with it is exactly the same as
+  // decomposing with the plain limit.
+  static DecompositionBudget make(int limit);
+
+  // Return the limit to pass to the next call into intervalxt's
+  // decompositionStep() when remaining steps of the induction are left for
+  // the current decomposition step (or -1 if unlimited.)
+  static int chunk(const DecompositionBudget&, int remaining);
+
+  // Record that a decomposition step has been performed.
+  static void consume(const DecompositionBudget&);
+
+  // Return whether the decomposition steps of this budget are traced, see
+  // DecompositionBudget::trace().
+  static bool tracing(const DecompositionBudget&);
+
+  // Report a decomposition step to the callback of DecompositionBudget::trace().
+  static void trace(const DecompositionBudget&, const DecompositionBudget::Step&);
+
+  const std::optional<size_t> steps;
+  const Clock::time_point start;
+  const std::optional<Clock::time_point> deadline;
+  const int limit;
+
+  // The number of induction steps after which the budget is checked again
+  // during a single decomposition step, or -1 to never interrupt a
+  // decomposition step. Since intervalxt resumes the induction where it
+  // stopped, interrupting a decomposition step does not change its outcome.
+  const int interval;
+
+  std::atomic<size_t> consumed = 0;
+  std::atomic<bool> cancelled = false;
+
+  std::function<void(const DecompositionBudget::Step&)> tracer;
+};
+
+}  // namespace flatsurf
+
+#endif
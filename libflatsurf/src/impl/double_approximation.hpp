@@ -0,0 +1,71 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_DOUBLE_APPROXIMATION_HPP
+#define LIBFLATSURF_DOUBLE_APPROXIMATION_HPP
+
+#include <exact-real/forward.hpp>
+#include <iosfwd>
+#include <optional>
+
+#include "../../flatsurf/ccw.hpp"
+
+namespace flatsurf {
+
+// An approximation of a vector in ℝ² by double precision floating point
+// numbers together with a certified bound on the absolute error of each
+// coordinate.
+// This serves as a static filter in the style of Shewchuk in hot predicates:
+// only when the floating point computation is inconclusive, we fall back to
+// Arb and then to exact arithmetic.
+class DoubleApproximation {
+ public:
+  // The zero vector (without any error.)
+  DoubleApproximation() noexcept;
+
+  explicit DoubleApproximation(const Vector<exactreal::Arb>&);
+
+  // Return the orientation of this vector and rhs if it can be decided with
+  // the precision of this approximation; never returns COLLINEAR.
+  std::optional<CCW> ccw(const DoubleApproximation& rhs) const;
+
+  // Return an upper bound for the length of this vector.
+  double upperLength() const;
+
+  // Return a lower bound for the length of this vector.
+  double lowerLength() const;
+
+  // Return a lower bound for the distance of the origin to the segment from
+  // start to end.
+  static double lowerDistance(const DoubleApproximation& start, const DoubleApproximation& end);
+
+  DoubleApproximation& operator+=(const DoubleApproximation&);
+  DoubleApproximation& operator-=(const DoubleApproximation&);
+
+  friend std::ostream& operator<<(std::ostream&, const DoubleApproximation&);
+
+ private:
+  double x, y;
+  // An upper bound for the absolute error in x and y.
+  double error;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,170 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_EDGE_CACHE_HPP
+#define LIBFLATSURF_EDGE_CACHE_HPP
+
+#include <boost/dynamic_bitset.hpp>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../flatsurf/edge.hpp"
+#include "../../flatsurf/flat_triangulation_combinatorial.hpp"
+#include "../../flatsurf/half_edge.hpp"
+#include "../util/assert.ipp"
+
+namespace flatsurf {
+
+// A cache of a T for some of the edges of a triangulation.
+// This serves the same purpose as an EdgeMap<std::optional<T>> but keeps
+// track of the valid entries in a bitset next to the values. So checking
+// whether an entry is present only tests a single bit and all the entries
+// can be invalidated at once by clearing the bitset.
+template <typename T>
+class EdgeCache {
+ public:
+  // For a cache of bools, entries are stored in a std::vector<bool> which
+  // cannot hand out references.
+  using const_reference = typename std::vector<T>::const_reference;
+
+  explicit EdgeCache(const FlatTriangulationCombinatorial& surface) :
+    valid(surface.size()),
+    values(surface.size()) {}
+
+  bool contains(Edge e) const { return valid.test(e.index()); }
+
+  // Return the cached value for e, which must be present.
+  const_reference get(Edge e) const {
+    ASSERT(contains(e), "no value cached for " << e);
+    return values[e.index()];
+  }
+
+  void set(Edge e, T value) {
+    values[e.index()] = std::move(value);
+    valid.set(e.index());
+  }
+
+  void erase(Edge e) { valid.reset(e.index()); }
+
+  // Invalidate all entries.
+  void clear() { valid.reset(); }
+
+  void swap(Edge a, Edge b) {
+    if (a == b) return;
+    T value = std::move(values[a.index()]);
+    values[a.index()] = std::move(values[b.index()]);
+    values[b.index()] = std::move(value);
+    const bool contained = valid[a.index()];
+    valid[a.index()] = valid[b.index()];
+    valid[b.index()] = contained;
+  }
+
+  // Forget about the edge with maximal index.
+  void pop() {
+    values.pop_back();
+    valid.pop_back();
+  }
+
+  size_t size() const { return values.size(); }
+
+  friend std::ostream& operator<<(std::ostream& os, const EdgeCache& self) {
+    bool first = true;
+    os << "{";
+    for (size_t i = 0; i < self.values.size(); i++) {
+      if (!self.valid.test(i))
+        continue;
+      if (!first) os << ", ";
+      os << Edge::fromIndex(i) << ": " << self.values[i];
+      first = false;
+    }
+    return os << "}";
+  }
+
+ private:
+  boost::dynamic_bitset<> valid;
+  std::vector<T> values;
+};
+
+// A cache of a T for some of the half edges of a triangulation such that if
+// e maps to x, then -e maps to -x, i.e., the cached counterpart of an
+// OddHalfEdgeMap<std::optional<T>>.
+template <typename T>
+class OddHalfEdgeCache {
+ public:
+  explicit OddHalfEdgeCache(const FlatTriangulationCombinatorial& surface) :
+    values(surface) {}
+
+  bool contains(HalfEdge he) const { return values.contains(he); }
+
+  // Return the cached value for he, which must be present.
+  T get(HalfEdge he) const {
+    if (he == Edge(he).positive())
+      return values.get(he);
+    else
+      return -values.get(he);
+  }
+
+  void set(HalfEdge he, const T& value) {
+    if (he == Edge(he).positive())
+      values.set(he, value);
+    else
+      values.set(he, -value);
+  }
+
+  void erase(HalfEdge he) { values.erase(he); }
+
+  // Invalidate all entries.
+  void clear() { values.clear(); }
+
+  void swap(HalfEdge a, HalfEdge b) {
+    if (a == b) return;
+    if (a == -b) {
+      if (contains(a))
+        set(a, get(b));
+    } else if (contains(a) && contains(b)) {
+      const T tmp = get(a);
+      set(a, get(b));
+      set(b, tmp);
+    } else if (contains(a)) {
+      set(b, get(a));
+      erase(a);
+    } else if (contains(b)) {
+      set(a, get(b));
+      erase(b);
+    }
+  }
+
+  void pop() { values.pop(); }
+
+  // Return the number of half edges in the domain of this cache.
+  size_t size() const { return 2 * values.size(); }
+
+  friend std::ostream& operator<<(std::ostream& os, const OddHalfEdgeCache& self) {
+    return os << self.values;
+  }
+
+ private:
+  EdgeCache<T> values;
+};
+
+}  // namespace flatsurf
+
+#endif
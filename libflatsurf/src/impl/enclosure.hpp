@@ -0,0 +1,135 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_IMPL_ENCLOSURE_HPP
+#define LIBFLATSURF_IMPL_ENCLOSURE_HPP
+
+#include <e-antic/renfxx.h>
+
+#include <exact-real/arb.hpp>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+
+#include "approximation.hpp"
+
+namespace flatsurf {
+
+// An exact value together with a lazily computed ball enclosing it.
+// For coordinates whose exact comparisons are expensive, i.e., elements of
+// number fields, signs and comparisons are decided on the balls whenever
+// these are conclusive and we only fall back to exact arithmetic otherwise.
+template <typename T>
+class Enclosure {
+ public:
+  // Whether comparisons of T profit from checking the enclosing balls first.
+  static constexpr bool filtered = std::is_same_v<T, eantic::renf_elem_class>;
+
+  Enclosure() :
+    Enclosure(T()) {}
+
+  explicit Enclosure(T value) :
+    exact(std::move(value)) {}
+
+  operator const T&() const { return exact; }
+
+  Enclosure operator-() const {
+    Enclosure negative(-exact);
+    if (approximation) {
+      negative.approximation = exactreal::Arb();
+      arb_neg(negative.approximation->arb_t(), approximation->arb_t());
+    }
+    return negative;
+  }
+
+  // Add rhs to this value. The ball is updated with ball arithmetic so the
+  // exact sum does not need to be approximated again.
+  Enclosure& operator+=(const Enclosure& rhs) {
+    if constexpr (filtered) {
+      exactreal::Arb ball;
+      arb_add(ball.arb_t(), arb().arb_t(), rhs.arb().arb_t(), exactreal::ARB_PRECISION_FAST);
+      approximation = std::move(ball);
+    } else {
+      approximation.reset();
+    }
+    exact += rhs.exact;
+    return *this;
+  }
+
+  Enclosure& operator-=(const Enclosure& rhs) {
+    if constexpr (filtered) {
+      exactreal::Arb ball;
+      arb_sub(ball.arb_t(), arb().arb_t(), rhs.arb().arb_t(), exactreal::ARB_PRECISION_FAST);
+      approximation = std::move(ball);
+    } else {
+      approximation.reset();
+    }
+    exact -= rhs.exact;
+    return *this;
+  }
+
+  // Return the absolute value.
+  Enclosure abs() const {
+    return sgn() < 0 ? -*this : *this;
+  }
+
+  // Return the sign of the value, i.e., -1, 0, or 1.
+  int sgn() const {
+    if constexpr (filtered) {
+      const auto& ball = arb();
+      if (arb_is_positive(ball.arb_t()))
+        return 1;
+      if (arb_is_negative(ball.arb_t()))
+        return -1;
+    }
+    return exact > 0 ? 1 : (exact < 0 ? -1 : 0);
+  }
+
+  // Return -1, 0, or 1 if this value is smaller, equal, or larger than rhs.
+  int cmp(const Enclosure& rhs) const {
+    if constexpr (filtered) {
+      exactreal::Arb difference;
+      arb_sub(difference.arb_t(), arb().arb_t(), rhs.arb().arb_t(), exactreal::ARB_PRECISION_FAST);
+      if (arb_is_positive(difference.arb_t()))
+        return 1;
+      if (arb_is_negative(difference.arb_t()))
+        return -1;
+    }
+    return exact < rhs.exact ? -1 : (exact > rhs.exact ? 1 : 0);
+  }
+
+  // Return a ball enclosing the value.
+  const exactreal::Arb& arb() const {
+    if (!approximation)
+      approximation = Approximation<T>::arb(exact);
+    return *approximation;
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const Enclosure& self) {
+    return os << self.exact;
+  }
+
+ private:
+  T exact;
+  mutable std::optional<exactreal::Arb> approximation;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,92 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_EXACT_FALLBACKS_IMPL_HPP
+#define LIBFLATSURF_EXACT_FALLBACKS_IMPL_HPP
+
+#include <atomic>
+#include <optional>
+
+#include "../../flatsurf/exact_fallbacks.hpp"
+
+namespace flatsurf {
+
+// The counters behind ExactFallbacks. A predicate that first tries an
+// approximation registers itself once with site() and then reports each
+// evaluation, e.g.:
+//
+//   static const size_t site = ImplementationOf<ExactFallbacks>::site("Vector::ccw");
+//   if (approximate) {
+//     ImplementationOf<ExactFallbacks>::decided(site);
+//     return *approximate;
+//   }
+//   const ImplementationOf<ExactFallbacks>::Fallback fallback(site);
+//   return exact();
+template <>
+class ImplementationOf<ExactFallbacks> {
+  using Clock = ExactFallbacks::Clock;
+
+ public:
+  // The maximum number of distinct predicates that can be registered.
+  static constexpr size_t MAX_SITES = 64;
+
+  // Return the key of the predicate called name, registering it if
+  // necessary.
+  static size_t site(const char* name);
+
+  static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+  // Record that the approximation decided the predicate at site.
+  static void decided(size_t site) {
+    if (enabled())
+      record(site, std::nullopt);
+  }
+
+  // Records an exact fallback of the predicate at site and the time it took
+  // until this object goes out of scope.
+  class Fallback {
+   public:
+    explicit Fallback(size_t site) :
+      site(site),
+      start(enabled() ? std::optional(Clock::now()) : std::nullopt) {}
+
+    Fallback(const Fallback&) = delete;
+    Fallback& operator=(const Fallback&) = delete;
+
+    ~Fallback() {
+      if (start)
+        record(site, Clock::now() - *start);
+    }
+
+   private:
+    size_t site;
+    std::optional<Clock::time_point> start;
+  };
+
+  static std::atomic<bool> active;
+
+ private:
+  // Count an evaluation at site in the counters of this thread; a duration
+  // indicates an exact fallback that took that much time.
+  static void record(size_t site, std::optional<Clock::duration> exact);
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,43 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_EXECUTOR_IMPL_HPP
+#define LIBFLATSURF_EXECUTOR_IMPL_HPP
+
+#include <functional>
+
+#include "../../flatsurf/executor.hpp"
+
+namespace flatsurf {
+
+template <>
+class ImplementationOf<Executor> {
+ public:
+  ImplementationOf(std::function<void(Executor::Task)> submit, unsigned int concurrency);
+
+  // Hands a task to the threads of this executor or drops it if this is
+  // the serial executor.
+  const std::function<void(Executor::Task)> submit;
+
+  const unsigned int concurrency;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -20,36 +20,279 @@
 #ifndef LIBFLATSURF_FLAT_TRIANGULATION_IMPL_HPP
 #define LIBFLATSURF_FLAT_TRIANGULATION_IMPL_HPP
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "../../flatsurf/flat_triangulation.hpp"
+#include "../../flatsurf/edge_map.hpp"
+#include "../../flatsurf/edge_set.hpp"
+#include "../../flatsurf/half_edge.hpp"
 #include "../../flatsurf/half_edge_map.hpp"
 #include "../../flatsurf/tracked.hpp"
 #include "../../flatsurf/vector.hpp"
+#include "../util/fmpz_pool.ipp"
 #include "flat_triangulation_combinatorial.impl.hpp"
+#include "precision_policy.hpp"
+#include "quadratic_polynomial.hpp"
+#include "vector_batch.hpp"
+#include "vertex_invariants.hpp"
 
 namespace flatsurf {
 
 template <typename T>
-class ImplementationOf<FlatTriangulation<T>> : protected ImplementationOf<ManagedMovable<FlatTriangulation<T>>>,
-                                               public ImplementationOf<FlatTriangulationCombinatorial> {
+class ImplementationOf<FlatTriangulation<T>> final : protected ImplementationOf<ManagedMovable<FlatTriangulation<T>>>,
+                                                     public ImplementationOf<FlatTriangulationCombinatorial> {
  public:
   ImplementationOf(FlatTriangulationCombinatorial&&, const std::function<Vector<T>(HalfEdge)>&);
+  // Create a surface with the vectors of the positive half edges, indexed by
+  // the index of their edge.
+  ImplementationOf(FlatTriangulationCombinatorial&&, std::vector<Vector<T>>&&);
+
+  // Create a surface from data that the library derived from a valid surface
+  // itself. Unlike the public constructors, this does not validate the
+  // surface unless LIBFLATSURF_VALIDATION asks for it, see util/assert.ipp.
+  static FlatTriangulation<T> make(FlatTriangulationCombinatorial&&, const std::function<Vector<T>(HalfEdge)>&);
 
   static void updateAfterFlip(OddHalfEdgeMap<Vector<T>>&, const FlatTriangulationCombinatorial&, HalfEdge);
-  static void updateApproximationAfterFlip(OddHalfEdgeMap<Vector<exactreal::Arb>>&, const FlatTriangulationCombinatorial&, HalfEdge);
+
+  // Records that the half edge flip needs to be flipped at a time t in (0, 1]
+  // that is given by a solution to det(t) = a*t^2 + b*t + c = 0.
+  struct Flip {
+    HalfEdge flip;
+    QuadraticPolynomial<T> det;
+  };
+
+  // The half edges that need to be flipped when shifting the vectors of a
+  // surface continuously by a shift, see operator+. This is a kinetic event
+  // queue: it keeps the corners (he, nextAtVertex(he)) whose vertex hits the
+  // interior of the opposite half edge during the shift, ordered by the time
+  // when this happens.
+  // The fate of a corner only depends on the vectors and the shifts of its
+  // two half edges, so it only needs to be recomputed when one of these is
+  // flipped. Moving the surface part of the way along the shift maps the
+  // times [s, 1] monotonically to [0, 1] and therefore does not change the
+  // order of the queue.
+  class FlipSchedule {
+   public:
+    // Create the queue of the flips needed when shifting surface by shift.
+    // Note that both are kept as references and the queue must be informed
+    // through flip() whenever an edge is flipped.
+    FlipSchedule(const FlatTriangulation<T>& surface, const OddHalfEdgeMap<Vector<T>>& shift);
+    FlipSchedule(const FlipSchedule&) = delete;
+    FlipSchedule& operator=(const FlipSchedule&) = delete;
+
+    // Return the half edge that needs to be flipped first, if any.
+    std::optional<Flip> next() const;
+
+    // Flip the half edge e of surface and update the corners of the two
+    // faces next to it.
+    void flip(FlatTriangulation<T>& surface, HalfEdge e);
+
+    // Return the edges that shrink to zero at the end of the shift.
+    EdgeSet collapsing() const;
+
+   private:
+    // Return the determinant of the vectors of the half edges forming the
+    // corner at time t in [0, 1] as a polynomial in t.
+    QuadraticPolynomial<T> det(HalfEdge corner) const;
+
+    // Return whether the half edge shrinks to zero at the end of the shift.
+    bool collapses(HalfEdge) const;
+
+    // Recompute the fate of this corner and add it to the queue if its
+    // vertex is going to hit the interior of the opposite half edge.
+    void schedule(HalfEdge corner);
+
+    // Remove this corner from the queue.
+    void unschedule(HalfEdge corner);
+
+    struct Earlier {
+      bool operator()(HalfEdge, HalfEdge) const;
+      const FlipSchedule* schedule;
+    };
+
+    const FlatTriangulation<T>& surface;
+    const OddHalfEdgeMap<Vector<T>>& shift;
+    std::multiset<HalfEdge, Earlier> events;
+    // The position of each corner in events indexed by HalfEdge::index().
+    std::vector<std::optional<typename std::multiset<HalfEdge, Earlier>::iterator>> scheduled;
+  };
+
+  // Shift the vectors of surface continuously by remaining and flip edges
+  // along the way so that the triangulation stays valid, see operator+.
+  // Stops after the last flip, i.e., surface still needs to be shifted by
+  // what is then left in remaining. The edges that collapse at the end of
+  // that shift are returned in collapsing.
+  static void shift(FlatTriangulation<T>& surface, Tracked<OddHalfEdgeMap<Vector<T>>>& remaining, EdgeSet& collapsing);
+
+  // Flip the working copy surface so that slit, which starts in the sector
+  // next to nextTo, does not cross any edges and return the surface with a
+  // vertex inserted at the end of slit, see FlatTriangulation::insertAt().
+  // The half edges in tracked are updated so that they stay at their
+  // vertex and each remains clockwise of the same directions at that vertex,
+  // i.e., a vector in the sector next to such a half edge is in the sector
+  // next to the updated half edge or in one of the sectors that follow.
+  static FlatTriangulation<T> insertAt(FlatTriangulation<T>& surface, HalfEdge& nextTo, const Vector<T>& slit, std::vector<HalfEdge>& tracked);
+
+  // Replace the vector attached to each half edge with vector(half edge)
+  // and update all the caches derived from the vectors.
+  void deform(const std::function<Vector<T>(HalfEdge)>& vector);
+
+  // Replace the vector attached to each half edge with its image under the
+  // matrix (a b; c d) of positive determinant and transform the caches
+  // derived from the vectors accordingly.
+  void transform(const T& a, const T& b, const T& c, const T& d);
+
+  // Apply the matrix (a b; c d) to the vectors of surface as above without
+  // restoring the Delaunay condition, see GeodesicFlow.
+  static void transform(FlatTriangulation<T>& surface, const T& a, const T& b, const T& c, const T& d);
+
+  // Flip edges of surface until it is Delaunay triangulated as with
+  // FlatTriangulation::delaunay() but give up once stop() returns true.
+  // Return whether the surface is Delaunay triangulated. Another call to
+  // this function resumes an abandoned triangulation.
+  // With more than one thread, the flips are performed in rounds, see
+  // delaunayInRounds().
+  static bool delaunay(FlatTriangulation<T>& surface, const std::function<bool()>& stop, unsigned int threads = 1);
+
+  // Flip edges of surface as in delaunay() in rounds: the in-circle tests of
+  // all edges that might not be Delaunay are evaluated with that many
+  // threads, then a maximal set of non-Delaunay edges whose quadrilaterals
+  // do not share a face is flipped. Such flips do not affect each other's
+  // in-circle tests.
+  static bool delaunayInRounds(FlatTriangulation<T>& surface, const std::function<bool()>& stop, unsigned int threads);
 
   void check();
 
   static T area(const Vector<T>& a, const Vector<T>& b, const Vector<T>& c);
 
+  // Return an approximation of the vector attached to this half edge with
+  // at least prec bits of precision. Approximations beyond
+  // ARB_PRECISION_FAST are cached so that callers which successively
+  // increase the precision do not redo the work at lower precisions.
+  Vector<exactreal::Arb> approximation(HalfEdge, slong prec) const;
+
+  // Return the approximation of the vector attached to this half edge that
+  // is kept in approximations. Computes all the approximations on first use
+  // and recomputes the approximation if it has been invalidated by a flip in
+  // the current FlipBatch.
+  const Vector<exactreal::Arb>& approximation(HalfEdge) const;
+
+  // Fill approximations for all the half edges to the current working
+  // precision of policy.
+  void approximate() const;
+
+  // Recompute the approximations of the half edges that have been flipped
+  // in the current FlipBatch, so that approximation() does not need to
+  // update any caches, e.g., when it is called from several threads.
+  void refreshApproximations() const;
+
+  // Delays updating the approximations of flipped half edges until they are
+  // needed or the outermost batch ends, so that an edge that is flipped
+  // several times in a batch is only approximated once. Also opens a
+  // FlipTransaction so deferrable observers are only notified at the end.
+  class FlipBatch {
+   public:
+    explicit FlipBatch(const ImplementationOf&);
+    FlipBatch(const FlipBatch&) = delete;
+    FlipBatch& operator=(const FlipBatch&) = delete;
+    ~FlipBatch();
+
+   private:
+    const ImplementationOf& surface;
+    const ImplementationOf<FlatTriangulationCombinatorial>::FlipTransaction transaction;
+  };
+
   void flip(HalfEdge) override;
 
-  const Tracked<OddHalfEdgeMap<Vector<T>>> vectors;
-  // A cache of approximations for improved performance
-  const Tracked<OddHalfEdgeMap<Vector<exactreal::Arb>>> approximations;
+  // Return the pool of coefficient arrays shared by the chains on surface.
+  static FmpzPool& coefficients(const FlatTriangulation<T>& surface);
+
+  // Return the policy that picks the working precision of the
+  // approximations on surface, see PrecisionPolicy.
+  static PrecisionPolicy& precision(const FlatTriangulation<T>& surface);
+
+  // Return the total angles and degrees of the vertices of surface. They
+  // are computed on first use and then kept up to date across flips.
+  static const VertexInvariants& invariants(const FlatTriangulation<T>& surface);
+
+  // Return the coordinates of the vectors of surface as columns indexed by
+  // HalfEdge::index(). Only available for machine integer coordinates, for
+  // other coordinates, the columns are empty.
+  static const VectorColumns<long long>& coordinates(const FlatTriangulation<T>& surface);
+
+  // Return the implementation of the Vertical in direction vertical on
+  // surface that is shared by all the Vertical objects for this direction
+  // which are alive. If there is none, a new one is created with make().
+  static std::shared_ptr<ImplementationOf<Vertical<FlatTriangulation<T>>>> vertical(const FlatTriangulation<T>& surface, const Vector<T>& vertical, const std::function<std::shared_ptr<ImplementationOf<Vertical<FlatTriangulation<T>>>>()>& make);
+
+  // Call f with the cache of the saddle connections on surface while
+  // holding a lock on it, see SaddleConnections::cached(). The cache is
+  // created on first use.
+  static void connections(const FlatTriangulation<T>& surface, const std::function<void(SaddleConnectionsCache<FlatTriangulation<T>>&)>& f);
+
+  Tracked<OddHalfEdgeMap<Vector<T>>> vectors;
+  // A cache of approximations for improved performance. It is only filled
+  // on first use; entries are then only missing while a FlipBatch is open,
+  // see approximation().
+  mutable Tracked<OddHalfEdgeMap<std::optional<Vector<exactreal::Arb>>>> approximations;
+  // Whether approximations has been filled. Until then, flips do not
+  // recompute any approximations.
+  mutable std::atomic<bool> approximated{false};
+  mutable std::mutex approximationsLock;
+  // The working precision of the approximations and the precision they
+  // have actually been computed to. When the policy changes its mind, the
+  // approximations are recomputed when the next FlipBatch opens.
+  mutable PrecisionPolicy policy;
+  mutable slong approximationsPrecision = exactreal::ARB_PRECISION_FAST;
+  // A cache of the most precise approximations computed by approximation()
+  // and the precision they have been computed to.
+  mutable Tracked<OddHalfEdgeMap<std::optional<Vector<exactreal::Arb>>>> preciseApproximations;
+  mutable Tracked<EdgeMap<std::optional<long long>>> preciseApproximationsPrecision;
+  // Since the surface might be shared between threads, e.g., in a parallel
+  // search for saddle connections, this lock guards the above caches.
+  mutable std::mutex preciseApproximationsLock;
+  // The positive half edge of the shortest edge (the one of smallest index
+  // among the shortest ones) or HalfEdge() if it needs to be recomputed, see
+  // FlatTriangulation::shortest().
+  mutable Tracked<HalfEdge> shortestEdge;
+  mutable std::mutex shortestEdgeLock;
+  // Twice the area of this surface if it has been computed already. Flips
+  // do not change the area so this is only reset when the vectors change.
+  mutable std::optional<T> area;
+  mutable std::mutex areaLock;
+  // The total angles and degrees of the vertices, see invariants().
+  mutable Tracked<VertexInvariants> vertexInvariants;
+  mutable std::mutex vertexInvariantsLock;
+  // The dense coefficient arrays of the chains on this surface, see Chain.
+  mutable FmpzPool pool;
+  // A copy of the vectors as a structure of arrays so that bulk passes over
+  // all the half edges stream through memory. Only kept for machine
+  // integers where such loops can be vectorized.
+  VectorColumns<long long> columns;
+  // The number of currently open FlipBatch scopes and the half edges whose
+  // approximations have been invalidated in them.
+  mutable size_t flipBatches = 0;
+  mutable std::vector<HalfEdge> staleApproximations;
+  // The implementations of the Vertical directions on this surface, keyed
+  // by their defining vector, so that their caches are only built once per
+  // direction, see vertical().
+  mutable std::unordered_map<Vector<T>, std::weak_ptr<ImplementationOf<Vertical<FlatTriangulation<T>>>>> verticals;
+  mutable std::mutex verticalsLock;
+  // The saddle connections up to some radius if requested through
+  // SaddleConnections::cached(), see connections().
+  mutable std::shared_ptr<Tracked<SaddleConnectionsCache<FlatTriangulation<T>>>> connectionsCache;
+  mutable std::mutex connectionsCacheLock;
 
  protected:
+  ImplementationOf(FlatTriangulationCombinatorial&&, OddHalfEdgeMap<Vector<T>>&&);
+
   using ImplementationOf<ManagedMovable<FlatTriangulation<T>>>::from_this;
   using ImplementationOf<ManagedMovable<FlatTriangulation<T>>>::self;
 
@@ -40,8 +40,8 @@ template <typename T>
 class CollapsedHalfEdge;
 
 template <typename T>
-class ImplementationOf<FlatTriangulationCollapsed<T>> : protected ImplementationOf<ManagedMovable<FlatTriangulationCollapsed<T>>>,
-                                                        public ImplementationOf<FlatTriangulationCombinatorial> {
+class ImplementationOf<FlatTriangulationCollapsed<T>> final : protected ImplementationOf<ManagedMovable<FlatTriangulationCollapsed<T>>>,
+                                                              public ImplementationOf<FlatTriangulationCombinatorial> {
   using SaddleConnection = flatsurf::SaddleConnection<FlatTriangulation<T>>;
   using CollapsedHalfEdge = flatsurf::CollapsedHalfEdge<T>;
 
@@ -66,6 +66,12 @@ class ImplementationOf<FlatTriangulationCollapsed<T>> : protected Implementation
   // cross to the other face.
   Tracked<HalfEdgeMap<SaddleConnection>> vectors;
 
+  // Return whether the vector of this half edge is clockwise,
+  // counterclockwise, or collinear to the vertical. Unlike FlatTriangulationCollapsed::vertical(), this does
+  // not create a Vertical with caches for all half edges, which would be
+  // wasteful while the triangulation is changing in collapse() and flip().
+  CCW ccw(HalfEdge) const;
+
   // Explicitly compute the area of this triangulation.
   T area();
 
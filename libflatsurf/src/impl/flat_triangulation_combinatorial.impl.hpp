@@ -20,16 +20,16 @@
 #ifndef LIBFLATSURF_FLAT_TRIANGULATION_COMBINATORIAL_IMPL_HPP
 #define LIBFLATSURF_FLAT_TRIANGULATION_COMBINATORIAL_IMPL_HPP
 
+#include <cstdint>
 #include <functional>
 #include <memory>
-#include <variant>
+#include <mutex>
 #include <vector>
 
 #include "../../flatsurf/edge.hpp"
 #include "../../flatsurf/flat_triangulation_combinatorial.hpp"
 #include "../../flatsurf/half_edge.hpp"
 #include "../../flatsurf/permutation.hpp"
-#include "../external/sigslot/include/sigslot/signal.hpp"
 #include "flat_triangulation_combinatorics.impl.hpp"
 #include "forward.hpp"
 #include "managed_movable.impl.hpp"
@@ -42,28 +42,81 @@ class ImplementationOf<FlatTriangulationCombinatorial> : protected Implementatio
  public:
   ImplementationOf(const Permutation<HalfEdge>&, const std::vector<HalfEdge>& boundaries);
 
+  struct Structure;
+
+  // Create a surface that shares its combinatorial structure with another
+  // surface until one of them is modified.
+  explicit ImplementationOf(std::shared_ptr<Structure>);
+
   // Destruct this surface and notify all the Tracked<> instances of the destruction.
   virtual ~ImplementationOf();
 
-  struct MessageAfterFlip {
-    HalfEdge e;
-  };
-  struct MessageBeforeCollapse {
-    Edge e;
-  };
-  struct MessageBeforeSwap {
-    HalfEdge a, b;
+  // An object that reacts to changes of this surface, such as a Tracked<T>.
+  // The observers of a surface form an intrusive doubly linked list, so
+  // attaching and detaching does not allocate and each notification is a
+  // single virtual call. Observers must not detach other observers while
+  // they are being notified.
+  class Observer {
+   public:
+    virtual ~Observer() = default;
+
+    // Invoked after the half edge has been flipped.
+    virtual void afterFlip(HalfEdge) = 0;
+    // Invoked once when the outermost FlipTransaction ends with the flipped
+    // edges, each edge reported once. Only invoked for deferrable() observers.
+    virtual void afterFlips(const std::vector<HalfEdge>&) = 0;
+    virtual void beforeCollapse(Edge) = 0;
+    virtual void beforeSwap(HalfEdge, HalfEdge) = 0;
+    virtual void beforeErase(const std::vector<Edge>&) = 0;
+    // Invoked when the surface is destructed. The observer has already been
+    // detached at this point.
+    virtual void beforeDestruction() = 0;
+
+    // Whether this observer only needs to learn about flips at the end of
+    // a FlipTransaction. This is the case if its reaction to a flip only
+    // depends on the flipped edge, e.g., because it just invalidates a
+    // cached value for that edge.
+    virtual bool deferrable() const = 0;
+
+   private:
+    Observer* previous = nullptr;
+    Observer* next = nullptr;
+
+    friend ImplementationOf<FlatTriangulationCombinatorial>;
   };
-  struct MessageBeforeErase {
-    std::vector<Edge> erase;
-  };
-  struct MessageAfterMove {
-    ImplementationOf<FlatTriangulationCombinatorial>* target;
+
+  // Start notifying observer about changes of this surface.
+  void attach(Observer*) const;
+  // Stop notifying observer about changes; does nothing if it is not attached.
+  void detach(Observer*) const;
+
+  // Delays notifying deferrable observers about flips until the outermost
+  // transaction on this surface ends. Other observers are still notified
+  // immediately.
+  class FlipTransaction {
+   public:
+    explicit FlipTransaction(const ImplementationOf&);
+    FlipTransaction(const FlipTransaction&) = delete;
+    FlipTransaction& operator=(const FlipTransaction&) = delete;
+    ~FlipTransaction();
+
+   private:
+    const ImplementationOf& surface;
   };
 
-  using Message = std::variant<MessageAfterFlip, MessageBeforeCollapse, MessageBeforeSwap, MessageBeforeErase, MessageAfterMove>;
+  // Make sure that the structure of this surface is not shared with other
+  // surfaces so that it can be modified.
+  void unshare();
+
+  // Return the position in vertices() of the vertex at which this half edge
+  // starts. Positions do not change when the surface is flipped.
+  static size_t vertex(const FlatTriangulationCombinatorial&, HalfEdge);
 
   void resetVertexes();
+  // Recompute the neighbours in adjacency from vertices and faces.
+  void resetAdjacency();
+  // Recompute the neighbours of this half edge in adjacency.
+  void updateAdjacency(HalfEdge);
   void resetVertices();
   void resetEdges();
 
@@ -72,19 +125,69 @@ class ImplementationOf<FlatTriangulationCombinatorial> : protected Implementatio
   // Sanity check this triangulation
   void check() const;
 
+  // Notify the deferrable observers about the flips that happened in the current FlipTransaction.
+  void flushFlips() const;
+
+  // Invoke notify on each attached observer.
+  template <typename Notify>
+  void notify(Notify&& notify) const {
+    for (Observer* observer = observers; observer != nullptr;) {
+      Observer* next = observer->next;
+      notify(*observer);
+      observer = next;
+    }
+  }
+
   virtual void flip(HalfEdge);
   virtual std::pair<HalfEdge, HalfEdge> collapse(HalfEdge);
 
-  // Connect to change event.
-  static sigslot::connection connect(const ImplementationOf<FlatTriangulationCombinatorial>*, std::function<void(Message)>);
 
-  std::vector<Edge> edges;
-  Permutation<HalfEdge> vertices;
-  Permutation<HalfEdge> faces;
-  std::vector<Vertex> vertexes;
-  std::vector<HalfEdge> halfEdges;
+  // The neighbours of a half edge packed into a single record, so that
+  // traversals of the surface only touch one cache line per step instead of
+  // the four arrays that make up vertices and faces.
+  struct Adjacency {
+    uint32_t nextInFace;
+    uint32_t nextAtVertex;
+    uint32_t previousAtVertex;
+    // The position in vertexes of the vertex at which this half edge starts.
+    // This lets flip(), swap(), and collapse() only update the vertices that
+    // are actually affected.
+    uint32_t vertex;
+  };
+  static_assert(sizeof(Adjacency) == 16, "adjacency records should be packed");
+
+  // The combinatorial data of a surface. Clones of a surface, e.g., the
+  // surfaces produced by scaling, share this data until they are modified.
+  struct Structure {
+    std::vector<Edge> edges;
+    Permutation<HalfEdge> vertices;
+    Permutation<HalfEdge> faces;
+    std::vector<Vertex> vertexes;
+    std::vector<HalfEdge> halfEdges;
+
+    // The adjacency of each half edge, indexed by HalfEdge::index(). This is
+    // kept in sync with vertices, faces, and vertexes, except for the inside
+    // of collapse().
+    std::vector<Adjacency> adjacency;
+  };
+
+  // The combinatorial data of this surface, possibly shared with other
+  // surfaces. Call unshare() before modifying it.
+  std::shared_ptr<Structure> structure;
+
+  // The first observer attached to this surface.
+  mutable Observer* observers = nullptr;
+
+  // Guards attaching and detaching observers, which happens when caches such
+  // as the ones of a Vertical are created on a shared surface from several
+  // threads.
+  mutable std::mutex observersLock;
+
+  // The number of FlipTransactions that are currently open.
+  mutable size_t flipTransactions = 0;
 
-  mutable sigslot::signal_st<Message> change;
+  // The edges flipped during the current FlipTransaction, see flushFlips().
+  mutable std::vector<HalfEdge> deferredFlips;
 
  protected:
   template <typename... Args>
@@ -0,0 +1,49 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_IMPL_FLOATING_POINT_HPP
+#define LIBFLATSURF_IMPL_FLOATING_POINT_HPP
+
+#include <algorithm>
+#include <cmath>
+
+namespace flatsurf {
+
+// Floating point coordinates cannot decide predicates exactly, so we decide
+// them up to this relative error: quantities that agree up to this error
+// are considered equal, e.g., vectors that are almost parallel are
+// considered collinear. Results on such vectors are only heuristic.
+constexpr double FLOAT_EPSILON = 1e-9;
+
+// Return the error up to which products of coordinates of vectors of these
+// sizes are considered equal, see FLOAT_EPSILON.
+inline double floatTolerance(double x, double y, double x_, double y_) {
+  return FLOAT_EPSILON * std::max(std::abs(x), std::abs(y)) * std::max(std::abs(x_), std::abs(y_));
+}
+
+// Return the sign of lhs - rhs up to the relative error FLOAT_EPSILON.
+inline int floatCompare(double lhs, double rhs) {
+  if (std::abs(lhs - rhs) <= FLOAT_EPSILON * std::max(std::abs(lhs), std::abs(rhs)))
+    return 0;
+  return lhs < rhs ? -1 : 1;
+}
+
+}  // namespace flatsurf
+
+#endif
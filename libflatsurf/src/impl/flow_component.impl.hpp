@@ -37,6 +37,8 @@ class ImplementationOf<FlowComponent<Surface>> {
 
   static FlowComponent<Surface> make(std::shared_ptr<FlowDecompositionState<Surface>>, FlowComponentState<Surface>*);
 
+  static const ImplementationOf& self(const FlowComponent<Surface>& component) { return *component.self; }
+
   std::string id() const;
 
   std::shared_ptr<FlowDecompositionState<Surface>> state;
@@ -20,13 +20,17 @@
 #ifndef LIBFLATSURF_FLOW_COMPONENT_STATE_HPP
 #define LIBFLATSURF_FLOW_COMPONENT_STATE_HPP
 
+#include <boost/logic/tribool.hpp>
 #include <intervalxt/component.hpp>
 #include <iosfwd>
 #include <list>
 #include <memory>
+#include <optional>
 
 #include "../../flatsurf/contour_component.hpp"
+#include "../../flatsurf/flow_component.hpp"
 #include "../../flatsurf/interval_exchange_transformation.hpp"
+#include "../../flatsurf/vector.hpp"
 
 namespace flatsurf {
 template <typename Surface>
@@ -40,6 +44,10 @@ class FlowComponentState {
   std::shared_ptr<const IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>> iet;
   intervalxt::Component dynamicalComponent;
 
+  // The metrics of this component as returned by FlowComponent::summary().
+  // Dropped whenever this component changes in a decomposition step.
+  mutable std::optional<typename FlowComponent<Surface>::Summary> summary;
+
   template <typename S>
   friend std::ostream& operator<<(std::ostream&, const FlowComponentState<S>&);
 };
@@ -37,6 +37,10 @@ class ImplementationOf<FlowDecomposition<Surface>> {
   static Edge firstInnerEdge(const FlowComponent<Surface>&);
   static HalfEdge halfEdge(const FlowConnection<Surface>&);
 
+  // Return the embedding of the components of this state, computing it if
+  // it is not cached yet.
+  static const typename FlowDecompositionState<Surface>::Embedding& embedding(FlowDecompositionState<Surface>&);
+
   std::shared_ptr<FlowDecompositionState<Surface>> state;
 };
 
@@ -21,15 +21,27 @@
 #define LIBFLATSURF_FLOW_DECOMPOSITION_STATE_HPP
 
 #include <intervalxt/connection.hpp>
+#include <deque>
 #include <iosfwd>
-#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 
 #include "../../flatsurf/contour_decomposition.hpp"
+#include "../../flatsurf/edge.hpp"
+#include "../../flatsurf/flow_connection.hpp"
+#include "../../flatsurf/half_edge.hpp"
 #include "../../flatsurf/saddle_connection.hpp"
 #include "../../flatsurf/vector.hpp"
 #include "flow_component_state.hpp"
 
 namespace flatsurf {
+// The state shared by a FlowDecomposition and its components.
+// This state cannot be serialized (yet) since intervalxt provides no means
+// to serialize its interval exchange transformations and their dynamical
+// components. Once it does, a checkpoint would consist of the contour
+// decomposition, the Lengths of each component, and the injected and
+// detected connections keyed by their intervalxt counterparts.
 template <typename Surface>
 class FlowDecompositionState : public std::enable_shared_from_this<FlowDecompositionState<Surface>> {
   using T = typename Surface::Coordinate;
@@ -41,10 +53,33 @@ class FlowDecompositionState : public std::enable_shared_from_this<FlowDecomposi
 
   ContourDecomposition<Surface> contourDecomposition;
 
-  std::list<FlowComponentState<Surface>> components;
+  // Components are only ever added when a component splits, so pointers to
+  // them remain valid, see ContourDecompositionState::components.
+  std::deque<FlowComponentState<Surface>> components;
   std::unordered_map<::intervalxt::Connection, SaddleConnection<FlatTriangulation<T>>> injectedConnections;
   std::unordered_map<::intervalxt::Connection, SaddleConnection<FlatTriangulation<T>>> detectedConnections;
 
+  // How the triangulations of the components embed into the triangulation
+  // of the entire decomposition, see FlowDecomposition::triangulation().
+  struct Embedding {
+    // The half edges that the connections on the perimeters map to.
+    std::unordered_map<FlowConnection<Surface>, HalfEdge> halfEdges;
+    // The edge that the first inner edge of each component maps to.
+    std::unordered_map<const FlowComponentState<Surface>*, Edge> firstInnerEdges;
+  };
+
+  // The embedding of the current components; computed lazily and reset
+  // whenever a component is decomposed further.
+  std::optional<Embedding> embedding;
+
+  // Protects components, detectedConnections, and embedding while the
+  // components are decomposed in parallel, see FlowDecomposition::decompose().
+  std::mutex lock;
+
+  // Whether components are currently being decomposed in parallel, i.e.,
+  // whether other threads might be modifying the components.
+  bool parallel = false;
+
   template <typename S>
   friend std::ostream& operator<<(std::ostream&, const FlowDecompositionState<S>&);
 };
@@ -0,0 +1,44 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_FLOW_DECOMPOSITIONS_IMPL_HPP
+#define LIBFLATSURF_FLOW_DECOMPOSITIONS_IMPL_HPP
+
+#include <vector>
+
+#include "../../flatsurf/flow_decompositions.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+class ImplementationOf<FlowDecompositions<Surface>> {
+  using T = typename Surface::Coordinate;
+
+ public:
+  ImplementationOf(const Surface& surface, std::vector<Vector<T>>&& directions);
+
+  // The surface from which the surface of each flow decomposition is cloned.
+  Surface surface;
+
+  std::vector<Vector<T>> directions;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -39,6 +39,9 @@ class IndexedSetIterator;
 template <typename T>
 class ReadOnly;
 
+template <typename Surface>
+class SaddleConnectionsCache;
+
 template <typename T>
 class WeakReadOnly;
 
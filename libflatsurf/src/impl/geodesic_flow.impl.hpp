@@ -0,0 +1,90 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_GEODESIC_FLOW_IMPL_HPP
+#define LIBFLATSURF_GEODESIC_FLOW_IMPL_HPP
+
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "../../flatsurf/edge.hpp"
+#include "../../flatsurf/geodesic_flow.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+class ImplementationOf<GeodesicFlow<Surface>> {
+  using T = typename Surface::Coordinate;
+
+ public:
+  explicit ImplementationOf(const Surface&);
+
+  // Return the linear polynomial A·r + B whose sign is the sign of the
+  // in-circle determinant of edge, see FlatTriangulation::delaunay(Edge),
+  // once each vector (x, y) of surface has been replaced with (√r·x, y)
+  // (up to a positive factor.) So the edge is Delaunay for all r up to or
+  // from -B/A, depending on the sign of A.
+  std::pair<T, T> incircle(Edge) const;
+
+  // Apply the accumulated matrix diag(a, d) to the vectors of surface.
+  void materialize() const;
+
+  // Rebuild the queue of events for a flow that stretches horizontally if
+  // direction is positive and vertically if direction is negative.
+  void reschedule(int direction);
+
+  // Flip the half edge e of surface and update the events of the edges of
+  // the quadrilateral around it.
+  void flip(HalfEdge e);
+
+  // Recompute when this edge stops being Delaunay and add it to the queue
+  // if this happens along the flow.
+  void schedule(Edge);
+
+  // Remove this edge from the queue.
+  void unschedule(Edge);
+
+  struct Earlier {
+    bool operator()(Edge, Edge) const;
+    const ImplementationOf* flow;
+  };
+
+  // The surface at the start of the flow; the surface at the current time
+  // is the image of this surface under diag(a, d).
+  mutable Surface surface;
+  mutable T a, d;
+
+  // Whether the events in the queue are for stretching horizontally (+1) or
+  // vertically (-1) or whether the queue has not been built yet (0).
+  int direction = 0;
+
+  // The in-circle polynomials of the edges indexed by Edge::index().
+  mutable std::vector<std::pair<T, T>> coefficients;
+
+  // The edges that stop being Delaunay along the flow ordered by the time
+  // when this happens, and the position of each edge in this queue.
+  std::multiset<Edge, Earlier> events;
+  std::vector<std::optional<typename std::multiset<Edge, Earlier>::iterator>> scheduled;
+};
+
+}  // namespace flatsurf
+
+#endif
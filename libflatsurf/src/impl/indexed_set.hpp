@@ -41,6 +41,11 @@ class IndexedSet {
   bool operator==(const IndexedSet&) const;
 
   bool disjoint(const IndexedSet&) const;
+
+  // Word-parallel union, intersection, and difference with another set.
+  IndexedSet& operator|=(const IndexedSet&);
+  IndexedSet& operator&=(const IndexedSet&);
+  IndexedSet& operator-=(const IndexedSet&);
   bool empty() const;
 
   size_t size() const;
@@ -22,9 +22,11 @@
 
 #include <intervalxt/interval_exchange_transformation.hpp>
 #include <map>
+#include <utility>
 #include <vector>
 
 #include "../../flatsurf/interval_exchange_transformation.hpp"
+#include "../../flatsurf/vertical.hpp"
 #include "flat_triangulation.impl.hpp"
 #include "flat_triangulation_collapsed.impl.hpp"
 #include "lengths.hpp"
@@ -49,8 +51,16 @@ class ImplementationOf<IntervalExchangeTransformation<Surface>> {
   // unique large edge by performing necessary flips. Return the half edges
   // contained in that component. (a component here contains all half edges
   // that can be reached by crossing faces or crossing over non-vertical
-  // half edges.)
-  static std::unordered_set<HalfEdge> makeUniqueLargeEdge(Surface&, const Vector<T>& vertical, HalfEdge& source);
+  // half edges.) The vertical must be a vertical on this surface.
+  static HalfEdgeSet makeUniqueLargeEdge(Surface&, const Vertical<Surface>& vertical, HalfEdge& source);
+
+  // Return the top and the bottom contour of the component of the large half
+  // edge `large`, i.e., the half edges that the interval exchange
+  // transformation built from `large` is made of. The bottom contour is
+  // walked with `negated` which must be the negative of `vertical`.
+  static std::pair<std::vector<HalfEdge>, std::vector<HalfEdge>> contours(const Vertical<Surface>& vertical, const Vertical<Surface>& negated, HalfEdge large);
+
+  static const ImplementationOf& self(const IntervalExchangeTransformation<Surface>&);
 
   ReadOnly<Surface> surface;
   intervalxt::IntervalExchangeTransformation iet;
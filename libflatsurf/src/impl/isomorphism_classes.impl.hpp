@@ -0,0 +1,56 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_ISOMORPHISM_CLASSES_IMPL_HPP
+#define LIBFLATSURF_ISOMORPHISM_CLASSES_IMPL_HPP
+
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "../../flatsurf/isomorphism_classes.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+class ImplementationOf<IsomorphismClasses<Surface>> {
+  using T = typename Surface::Coordinate;
+  using MATRICES = typename IsomorphismClasses<Surface>::MATRICES;
+
+ public:
+  ImplementationOf(ISOMORPHISM, MATRICES, std::function<bool(const T &, const T &, const T &, const T &)>, unsigned int threads);
+
+  // The invariants of a surface by which surfaces are bucketed: the
+  // canonical hash, the sorted total angles at the vertices, the area (if
+  // preserved by the matrices) and the sorted squared lengths of the edges
+  // that isomorphism() considers (if preserved by the matrices.)
+  using Invariant = std::tuple<size_t, std::vector<int>, std::optional<T>, std::vector<T>>;
+
+  Invariant invariant(const Surface &) const;
+
+  ISOMORPHISM kind;
+  MATRICES matrices;
+  std::function<bool(const T &, const T &, const T &, const T &)> filter;
+  unsigned int threads;
+};
+
+}  // namespace flatsurf
+
+#endif
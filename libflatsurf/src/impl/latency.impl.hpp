@@ -0,0 +1,44 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_LATENCY_IMPL_HPP
+#define LIBFLATSURF_LATENCY_IMPL_HPP
+
+#include <functional>
+#include <optional>
+
+#include "../../flatsurf/latency.hpp"
+
+namespace flatsurf {
+
+template <>
+class ImplementationOf<Latency> {
+ public:
+  ImplementationOf(std::optional<Latency::Clock::duration> budget, std::function<void(const Latency::Progress&)> progress);
+
+  const std::optional<Latency::Clock::duration> budget;
+
+  // Receives the progress of operations or is empty if progress is not
+  // reported.
+  const std::function<void(const Latency::Progress&)> progress;
+};
+
+}  // namespace flatsurf
+
+#endif
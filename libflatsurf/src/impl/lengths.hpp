@@ -27,11 +27,14 @@
 #include <intervalxt/lengths.hpp>
 #include <iosfwd>
 #include <memory>
+#include <optional>
 #include <vector>
 
+#include "../../flatsurf/decomposition_budget.hpp"
 #include "../../flatsurf/edge.hpp"
 #include "../../flatsurf/edge_map.hpp"
 #include "../../flatsurf/saddle_connection.hpp"
+#include "enclosure.hpp"
 #include "flow_decomposition_state.hpp"
 #include "read_only.hpp"
 
@@ -55,6 +58,11 @@ class Lengths {
   int cmp(intervalxt::Label, intervalxt::Label) const;
   T get(intervalxt::Label) const;
   std::string render(intervalxt::Label) const;
+
+  // Drop the cached enclosures and coefficients of the lengths. They are
+  // recomputed when they are needed again.
+  void compact();
+
   ::intervalxt::Lengths forget() const;
   ::intervalxt::Lengths only(const std::unordered_set<::intervalxt::Label>&) const;
   bool similar(::intervalxt::Label, ::intervalxt::Label, const ::intervalxt::Lengths&, ::intervalxt::Label, ::intervalxt::Label) const;
@@ -66,8 +74,13 @@ class Lengths {
   intervalxt::Label toLabel(Edge) const;
   Edge fromLabel(intervalxt::Label) const;
 
-  T length(intervalxt::Label) const;
-  T length() const;
+  const T& length(intervalxt::Label) const;
+  const T& length() const;
+  // Return how often the labels on the stack can be subtracted from minuend
+  // if this can be decided with ball arithmetic.
+  std::optional<mpz_class> fullSubtractions(intervalxt::Label minuend) const;
+  // Return the length of this label together with a ball enclosing it.
+  const Enclosure<T>& enclosure(intervalxt::Label) const;
   // Return whether this label is the leftmost label on a top contour.
   bool minuendOnTop(intervalxt::Label) const;
   // Return the component that holds this label.
@@ -77,10 +90,40 @@ class Lengths {
   ReadOnly<Vertical<FlatTriangulation<T>>> vertical;
   EdgeMap<std::optional<SaddleConnection<FlatTriangulation<T>>>> lengths;
 
+  // The lengths of the labels that have been computed so far, indexed by the
+  // index of the edge of the label. An entry is dropped when the length of
+  // its label changes in subtractRepeated(). This has an entry for every
+  // edge so that references to its entries remain valid.
+  mutable std::vector<std::optional<Enclosure<T>>> enclosures;
+
+  // The coefficients of the lengths of the labels that coefficients() has
+  // computed so far, indexed like enclosures. An entry is dropped together
+  // with the corresponding entry of enclosures.
+  mutable std::vector<std::optional<std::vector<mpq_class>>> coefficientRows;
+
   std::deque<intervalxt::Label> stack;
-  T sum;
+  Enclosure<T> sum;
+
+  // The implementation of the interval exchange transformation these lengths
+  // belong to in a flow decomposition. component() only considers the
+  // components of this transformation since the components of other
+  // transformations might be modified by other threads concurrently.
+  const void* owner = nullptr;
+
+  // Statistics for DecompositionBudget::trace() which are only collected
+  // while tracing is set.
+  bool tracing = false;
+  mutable size_t inductions = 0;
+  mutable DecompositionBudget::Clock::duration elapsed{};
+
+  // Measures the time spent in a method for elapsed (excluding nested
+  // calls.)
+  class Stopwatch;
+  mutable bool timing = false;
 
   friend IntervalExchangeTransformation<Surface>;
+  friend ImplementationOf<IntervalExchangeTransformation<Surface>>;
+  friend FlowComponent<FlatTriangulation<T>>;
 };
 
 }  // namespace flatsurf
@@ -20,6 +20,9 @@
 #ifndef LIBFLATSURF_PATH_IMPL_HPP
 #define LIBFLATSURF_PATH_IMPL_HPP
 
+#include <memory>
+#include <vector>
+
 #include "../../flatsurf/path.hpp"
 
 namespace flatsurf {
@@ -33,7 +36,17 @@ class ImplementationOf<Path<Surface>> {
   ImplementationOf();
   ImplementationOf(const std::vector<Segment>&);
 
-  std::vector<Segment> path = {};
+  // The segments of this path. Copies of a path share their segments until
+  // one of them is modified, see mutate(), so that copying a path does not
+  // copy the chains of all its saddle connections.
+  std::shared_ptr<std::vector<Segment>> path;
+
+  // Return the segments of this path for modification, copying them first
+  // if they are shared with another path.
+  std::vector<Segment>& mutate();
+
+  // Return the segments of an empty path that all empty paths share.
+  static const std::shared_ptr<std::vector<Segment>>& empty();
 
   static bool connected(const Segment&, const Segment&);
 };
@@ -0,0 +1,148 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_IMPL_PRECISION_POLICY_HPP
+#define LIBFLATSURF_IMPL_PRECISION_POLICY_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <exact-real/arb.hpp>
+#include <mutex>
+
+namespace flatsurf {
+
+// The working precision of the Arb approximations of a surface, i.e., of
+// the approximations of its half edges and of the chains on it.
+// The predicates that are decided on these approximations report whether
+// the approximation was good enough. When too many of them have to fall
+// back to exact arithmetic, the precision is doubled; when the
+// approximations decide everything for a while, the precision is halved
+// again. Predicates on surfaces with large coordinates thereby escalate
+// less often, while small surfaces stay at ARB_PRECISION_FAST.
+// Setting the environment variable LIBFLATSURF_ADAPTIVE_PRECISION=0 pins
+// the precision to ARB_PRECISION_FAST.
+class PrecisionPolicy {
+ public:
+  // The number of predicate evaluations after which the precision is
+  // reconsidered.
+  static constexpr size_t WINDOW = 1024;
+
+  // The precision is doubled when more than WINDOW / WIDEN predicates of a
+  // window could not be decided, i.e., when the exact fallbacks are likely
+  // to cost more than the additional precision.
+  static constexpr size_t WIDEN = 64;
+
+  // The precision never exceeds MAX_PRECISION; such predicates are
+  // typically undecidable by any approximation, e.g., because the vectors
+  // are actually collinear.
+  static constexpr slong MAX_PRECISION = 16 * exactreal::ARB_PRECISION_FAST;
+
+  PrecisionPolicy() = default;
+  PrecisionPolicy(const PrecisionPolicy&) = delete;
+  PrecisionPolicy& operator=(const PrecisionPolicy&) = delete;
+
+  // Return the precision to use for new approximations.
+  slong precision() const { return current.load(std::memory_order_relaxed); }
+
+  // Record that a predicate was decided by an approximation if decided is
+  // set, or that it had to be decided exactly.
+  void record(bool decided) {
+    if (!adaptive()) return;
+
+    // Several threads might record concurrently. Since this is only a
+    // heuristic, we accept that some evaluations get lost rather than
+    // synchronizing every evaluation.
+    if (!decided)
+      undecided.store(undecided.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    const size_t count = evaluations.load(std::memory_order_relaxed) + 1;
+    evaluations.store(count, std::memory_order_relaxed);
+
+    if (count >= WINDOW)
+      adapt();
+  }
+
+  // Return whether the precision is adapted at all, see
+  // LIBFLATSURF_ADAPTIVE_PRECISION.
+  static bool adaptive() {
+    static const bool adaptive = [] {
+      const char* setting = std::getenv("LIBFLATSURF_ADAPTIVE_PRECISION");
+      return setting == nullptr || std::strcmp(setting, "0") != 0;
+    }();
+    return adaptive;
+  }
+
+ private:
+  // Reconsider the precision at the end of a window.
+  void adapt() {
+    std::unique_lock<std::mutex> lock(adapting, std::try_to_lock);
+    // Another thread is already handling this window.
+    if (!lock.owns_lock()) return;
+
+    if (evaluations.load(std::memory_order_relaxed) < WINDOW) return;
+
+    const size_t failures = undecided.load(std::memory_order_relaxed);
+    evaluations.store(0, std::memory_order_relaxed);
+    undecided.store(0, std::memory_order_relaxed);
+
+    const slong prec = precision();
+
+    if (failures * WIDEN > WINDOW) {
+      quiet = 0;
+      if (prec < MAX_PRECISION) {
+        // When we have to widen right after narrowing, the lower precision
+        // was not good enough after all, so we wait longer before trying
+        // it again.
+        if (narrowed)
+          patience = std::min<size_t>(2 * patience, 1u << 16);
+        current.store(2 * prec, std::memory_order_relaxed);
+      }
+      narrowed = false;
+    } else if (failures == 0 && prec > exactreal::ARB_PRECISION_FAST) {
+      if (++quiet >= patience) {
+        quiet = 0;
+        narrowed = true;
+        current.store(prec / 2, std::memory_order_relaxed);
+      }
+    } else {
+      quiet = 0;
+      narrowed = false;
+    }
+  }
+
+  std::atomic<slong> current = exactreal::ARB_PRECISION_FAST;
+  std::atomic<size_t> evaluations = 0;
+  std::atomic<size_t> undecided = 0;
+
+  // Guards the remaining fields which are only touched at the end of a
+  // window.
+  std::mutex adapting;
+  // The number of consecutive windows in which every predicate was decided
+  // by the approximation.
+  size_t quiet = 0;
+  // The number of such windows after which the precision is halved.
+  size_t patience = 4;
+  // Whether the last change of precision halved the precision.
+  bool narrowed = false;
+};
+
+}  // namespace flatsurf
+
+#endif
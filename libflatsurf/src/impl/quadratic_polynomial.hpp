@@ -29,15 +29,35 @@ template <typename T>
 class QuadraticPolynomial {
   T a, b, c;
 
+  // The sign of the discriminant b^2 - 4ac, computed on first use.
+  mutable std::optional<int> discriminant;
+
+  // The most precise approximation of root() computed so far and the
+  // precision it was requested with, so that callers which successively
+  // increase the precision do not redo the work at lower precisions.
+  mutable slong rootPrecision = 0;
+  mutable std::optional<exactreal::Arb> rootApproximation;
+
+  // Return an approximation of root() at precision prec without consulting
+  // the above cache.
+  std::optional<exactreal::Arb> approximateRoot(slong prec) const;
+
+  // Return whether -n/d, which must be a root of this polynomial, is its
+  // smallest root in [0, 1].
+  bool first(const T& n, const T& d) const;
+
  public:
   QuadraticPolynomial(const T& a, const T& b, const T& c);
 
   // Return an approximation of the smallest solution of a*t^2 + b*t + c = 0
   // for t in [0, 1]. Returns nothing if there are no roots in [0, 1].
+  // The returned ball might be more precise than requested if a more
+  // precise approximation has been computed before.
   std::optional<exactreal::Arb> root(slong prec = exactreal::ARB_PRECISION_FAST) const;
 
   // Return whether the smallest root of a*t^2 + b*t + c in [0, 1] is smaller
-  // than the smallest corresponding root of rhs.
+  // than the smallest corresponding root of rhs. This comparison is exact,
+  // in particular when the two roots are equal.
   bool operator<(const QuadraticPolynomial& rhs) const;
 
   // Return whether the polynomial is positive for all t in [0, 1].
@@ -46,6 +46,21 @@ class ReadOnly {
   ReadOnly(const ReadOnly&);
   ReadOnly(ReadOnly&&);
 
+  // Return a read-only reference to value that does not keep value alive.
+  // Copying such a borrowed reference does not touch any reference counts,
+  // so it can be used for the many short-lived temporaries that are created
+  // during an enumeration. The caller must make sure that value outlives all
+  // copies of the returned reference; in particular, a borrowed reference
+  // must never end up in an object that is handed out to the user.
+  static ReadOnly borrow(const T& value);
+
+  // Return whether this reference has been created by borrow(), i.e.,
+  // whether it does not keep its target alive.
+  bool borrowed() const;
+
+  // Return whether this and rhs refer to the same object.
+  bool same(const ReadOnly& rhs) const;
+
   const T* operator->() const;
   const T& operator*() const;
 
@@ -20,6 +20,9 @@
 #ifndef LIBFLATSURF_SADDLE_CONNECTION_IMPL_HPP
 #define LIBFLATSURF_SADDLE_CONNECTION_IMPL_HPP
 
+#include <optional>
+#include <vector>
+
 #include "../../flatsurf/chain.hpp"
 #include "../../flatsurf/flat_triangulation.hpp"
 #include "../../flatsurf/flat_triangulation_collapsed.hpp"
@@ -38,6 +41,33 @@ class ImplementationOf<SaddleConnection<Surface>> {
   ImplementationOf(const Surface&, HalfEdge source, HalfEdge target, const Chain<Surface>&);
   ImplementationOf(const Surface&, HalfEdge source, HalfEdge target, Chain<Surface>&&);
 
+  // Append the half edges that are crossed by the saddle connection with
+  // vector that leaves in the sector counterclockwise from source to
+  // crossings, see SaddleConnection::crossings(). This walks through the
+  // triangles along the connection, so it takes time linear in the number of
+  // crossings.
+  static void crossings(const Surface&, HalfEdge source, const Vector<T>& vector, std::vector<HalfEdge>& crossings);
+
+  // Return the first saddle connection that leaves in the sector
+  // counterclockwise from source in the direction of vector. This walks
+  // through the triangles along that direction like crossings(), so it takes
+  // time linear in the number of crossings. Return nothing if that walk
+  // hits the boundary or, if bounded, if it does not reach a vertex before
+  // the end of vector.
+  static std::optional<SaddleConnection> shoot(const Surface&, HalfEdge source, const Vector<T>& vector, bool bounded);
+
+  // Return for each half edge at the vertex of source, indexed by its index,
+  // how many times a walk counterclockwise around that vertex, starting
+  // from vector in the sector of source, passes the direction of vector
+  // before it enters the sector of that half edge; -1 for the other half
+  // edges. This can be used to compute many angle() at the same vertex.
+  static std::vector<int> turns(const Surface&, HalfEdge source, const Vector<T>& vector);
+
+  // Return the angle from vector leaving from source to other leaving from
+  // sector, see SaddleConnection::angle(), where turns have been computed
+  // by turns() for source and vector.
+  static std::optional<int> angle(const Surface&, HalfEdge source, const Vector<T>& vector, const std::vector<int>& turns, HalfEdge sector, const Vector<T>& other);
+
   ReadOnly<Surface> surface;
   HalfEdge source;
   HalfEdge target;
@@ -0,0 +1,46 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTION_RECORDS_IMPL_HPP
+#define LIBFLATSURF_SADDLE_CONNECTION_RECORDS_IMPL_HPP
+
+#include <vector>
+
+#include "../../flatsurf/saddle_connection_records.hpp"
+#include "read_only.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+class ImplementationOf<SaddleConnectionRecords<Surface>> {
+  using Record = typename SaddleConnectionRecords<Surface>::Record;
+  using Term = typename SaddleConnectionRecords<Surface>::Term;
+
+ public:
+  ImplementationOf(const Surface&);
+
+  ReadOnly<Surface> surface;
+
+  std::vector<Record> records;
+  std::vector<Term> terms;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -20,11 +20,19 @@
 #ifndef LIBFLATSURF_SADDLE_CONNECTIONS_IMPL_HPP
 #define LIBFLATSURF_SADDLE_CONNECTIONS_IMPL_HPP
 
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "../../flatsurf/bound.hpp"
+#include "../../flatsurf/half_edge_map.hpp"
 #include "../../flatsurf/saddle_connections.hpp"
+#include "../../flatsurf/saddle_connections_statistics.hpp"
 #include "../../flatsurf/vector.hpp"
+#include "double_approximation.hpp"
 #include "flat_triangulation.impl.hpp"
 #include "read_only.hpp"
 
@@ -48,20 +56,169 @@ class ImplementationOf<SaddleConnections<Surface>> {
     HalfEdge source;
     std::optional<std::pair<Vector<T>, Vector<T>>> sector;
 
-    std::vector<Sector> refine(const Surface&, const Vector<T>& sectorBegin, const Vector<T>& sectorEnd) const;
+    // Append the parts of this sector that are in the sector from
+    // sectorBegin to sectorEnd to refined.
+    void refine(const Surface&, const Vector<T>& sectorBegin, const Vector<T>& sectorEnd, std::vector<Sector>& refined) const;
+
+    // Return this sector split into two sectors of roughly the same angle or
+    // nothing if this sector cannot be split.
+    std::optional<std::pair<Sector, Sector>> split(const Surface&) const;
+
     bool contains(const SaddleConnection<Surface>&) const;
+
+    // Return an approximation of the angle of this sector in radians. The
+    // work of a search in this sector up to some radius is roughly
+    // proportional to this angle.
+    double angle(const Surface&) const;
+  };
+
+  // An immutable list of sectors that is shared by all copies of these saddle
+  // connections, together with the range of it that is searched.
+  // The initial list of one full sector per half edge only depends on the
+  // number of half edges, so it is shared by all saddle connections on
+  // surfaces of that size. Restricting to a single half edge then only
+  // narrows down the range and does not copy any sectors.
+  class Sectors {
+   public:
+    using const_iterator = typename std::vector<Sector>::const_iterator;
+
+    // The full sectors at all the half edges of surface.
+    explicit Sectors(const Surface&);
+
+    Sectors(std::vector<Sector>);
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    size_t size() const;
+    bool empty() const;
+
+    const Sector& operator[](size_t) const;
+
+    // Return the sectors at source.
+    Sectors restrict(HalfEdge source) const;
+
+    // Return the sectors at the half edges of source.
+    Sectors restrict(const Surface&, const Vertex& source) const;
+
+   private:
+    Sectors(std::shared_ptr<const std::vector<Sector>>, size_t first, size_t last, bool full);
+
+    std::shared_ptr<const std::vector<Sector>> sectors;
+
+    // The range of sectors that is searched.
+    size_t first, last;
+
+    // Whether sectors is the initial list of sectors, i.e., the full sector
+    // at the i-th half edge is at index i.
+    bool full;
   };
 
   ImplementationOf(const Surface&);
 
+  // Return the number of connections, see SaddleConnections::count(), without
+  // consulting or updating the count stored in counted.
+  static size_t count(const SaddleConnections<Surface>&);
+
   // Reset the lowerBound back to 0; note that the public lowerBound() can only
   // increase the lower bound.
   static void resetLowerBound(SaddleConnections<Surface>&);
 
+  // Call callback for each saddle connection in order of increasing length
+  // until it returns false if these connections can be served from the
+  // cache of the surface, see SaddleConnections::cached(). Return whether
+  // the connections have been served from the cache.
+  bool forEachCached(const std::function<bool(const SaddleConnection<Surface>&)>& callback) const;
+
+  // Return whether the vertex at the end of chain, approximated by
+  // approximation, is longer than the lowerBound. This is decided on the
+  // approximation whenever possible so that searches with a large lower
+  // bound do not pay for an exact comparison at every vertex they visit
+  // inside of it.
+  bool beyondLowerBound(const DoubleApproximation& approximation, const Chain<Surface>& chain) const;
+
   ReadOnly<Surface> surface;
-  std::vector<Sector> sectors;
+  Sectors sectors;
   std::optional<Bound> searchRadius;
   Bound lowerBound;
+
+  // Whether searches should be served from the cache of the surface, see
+  // SaddleConnections::cached().
+  bool cached = false;
+
+  // The number of copies of the surface that the threads of forEach() work
+  // on, see SaddleConnections::replicated().
+  unsigned int replicas = 0;
+
+  // Return a copy of this search on a fresh clone of the surface.
+  ImplementationOf replicate() const;
+
+  // Return the connection on surface that has the same source, target, and
+  // chain as connection on a replicate() of surface.
+  static SaddleConnection<Surface> translate(const Surface& surface, const SaddleConnection<Surface>& connection);
+
+  // Return the sectors split up into tasks for a parallel search with the
+  // given number of threads, each with the number of times it has been
+  // split. The tasks are in the order in which iteration visits them.
+  std::vector<std::pair<Sector, int>> tasks(unsigned int threads) const;
+
+  // Return the sectors split up such that no piece has much more than the
+  // given share of the total angle of the sectors, each with the number of
+  // times it has been split. The pieces are in the order in which iteration
+  // visits them.
+  std::vector<std::pair<Sector, int>> pieces(double share) const;
+
+  // Call callback for each saddle connection in this sector in the order of
+  // iteration, using SaddleConnectionsInteger if integer is set.
+  void search(const Sector&, bool integer, const std::function<void(const SaddleConnection<Surface>&)>& callback) const;
+
+  // Return one sector out of each orbit of the sectors under symmetries or
+  // nothing if the sectors are not invariant under them, see
+  // SaddleConnections::symmetric().
+  std::optional<std::vector<Sector>> fundamentalDomain() const;
+
+  // Return the image of connection under the automorphism of the surface
+  // given by the images of the half edges indexed by their index.
+  static SaddleConnection<Surface> image(const SaddleConnection<Surface>& connection, const std::vector<HalfEdge>& automorphism);
+
+  // The orientation preserving isometric automorphisms of the surface if
+  // requested through SaddleConnections::symmetric(), including the
+  // identity, each given by the images of the half edges indexed by their
+  // index.
+  std::shared_ptr<const std::vector<std::vector<HalfEdge>>> symmetries;
+
+  // Floating point approximations of the half edges of the surface, shared
+  // by all copies of these saddle connections.
+  std::shared_ptr<const HalfEdgeMap<DoubleApproximation>> approximations;
+
+  // The statistics collected by the searches, if enabled, see
+  // SaddleConnections::collectStatistics().
+  struct Statistics {
+    std::mutex mutex;
+    SaddleConnectionsStatistics statistics;
+  };
+
+  std::shared_ptr<Statistics> statistics;
+
+  // The result of SaddleConnections::count() once it has been computed. The
+  // surface must not change while there are saddle connections on it (the
+  // approximations above are not updated either) so the count can be
+  // reused. It is not copied with these saddle connections since copies are
+  // usually modified to describe other connections, e.g., with bound().
+  struct Counted {
+    Counted() = default;
+    Counted(const Counted&) noexcept {}
+    Counted& operator=(const Counted&) noexcept {
+      std::lock_guard<std::mutex> lock(mutex);
+      count.reset();
+      return *this;
+    }
+
+    std::mutex mutex;
+    std::optional<size_t> count;
+  };
+
+  mutable Counted counted;
 };
 
 }  // namespace flatsurf
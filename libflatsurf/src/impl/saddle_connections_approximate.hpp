@@ -0,0 +1,156 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_APPROXIMATE_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_APPROXIMATE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "../../flatsurf/ccw.hpp"
+#include "../../flatsurf/saddle_connection.hpp"
+#include "../../flatsurf/vector.hpp"
+#include "double_approximation.hpp"
+#include "saddle_connections.impl.hpp"
+
+namespace flatsurf {
+
+// The depth-first search of SaddleConnectionsDepthFirst running on the
+// floating point approximations of the half edges.
+// The frames of this search only hold a DoubleApproximation of their vertex
+// and of their boundaries, so walking through the surface does not do any
+// exact arithmetic. Whenever an orientation or a comparison with the search
+// radius cannot be decided from these approximations, the exact vectors
+// involved are recovered from the trail of half edges that lead to them and
+// the predicate is decided exactly. Therefore, this search reports the same
+// saddle connections in the same order as SaddleConnectionsDepthFirst.
+template <typename Surface>
+class SaddleConnectionsApproximate {
+  using T = typename Surface::Coordinate;
+
+ public:
+  explicit SaddleConnectionsApproximate(const ImplementationOf<SaddleConnections<Surface>>&);
+
+  // Return whether this search can be used for these connections, i.e.,
+  // whether a search radius has been set that can be approximated by a
+  // double.
+  static bool applicable(const ImplementationOf<SaddleConnections<Surface>>&);
+
+  // Advance to the next saddle connection; return false if all saddle
+  // connections have been reported.
+  bool next();
+
+  // Return the saddle connection found by the last call to next().
+  SaddleConnection<Surface> connection() const;
+
+ private:
+  // A segment of the path of half edges that leads to a vertex, see
+  // SaddleConnectionsInteger::Trail.
+  struct Trail {
+    HalfEdge a;
+    HalfEdge b;
+    uint32_t parent;
+  };
+
+  // A boundary of the search sector of a frame together with the
+  // information needed to recover it exactly: a half edge at the beginning
+  // of a sector, the vertex at the end of a trail, or one of the vectors
+  // that restrict the sector. Only the latter are inclusive, see
+  // SaddleConnectionsCrossing::Frontier.
+  struct Boundary {
+    enum class Kind : uint8_t {
+      HALF_EDGE,
+      TRAIL,
+      SECTOR_BEGIN,
+      SECTOR_END,
+    };
+
+    DoubleApproximation approximation;
+    Kind kind;
+    HalfEdge halfEdge;
+    uint32_t trail;
+
+    bool exclusive() const { return kind == Kind::HALF_EDGE || kind == Kind::TRAIL; }
+  };
+
+  struct Frame {
+    size_t sector;
+    Boundary boundary[2];
+    HalfEdge nextEdge;
+    DoubleApproximation nextEdgeEnd;
+    uint32_t trail;
+  };
+
+  // Start the search in the next sector; return whether the half edge at
+  // the beginning of that sector is a saddle connection that is reported.
+  bool start();
+
+  // Return the exact vertex at the end of this trail.
+  Vector<T> exact(uint32_t trail) const;
+
+  // Return the exact vector of this boundary of a frame.
+  Vector<T> exact(const Frame&, const Boundary&) const;
+
+  // Return the orientation of the vertex at the end of trail with
+  // approximation vertex relative to this boundary of the frame.
+  CCW ccw(const Frame&, const Boundary&, const DoubleApproximation& vertex, uint32_t trail) const;
+
+  // Return whether the vertex at the end of trail with approximation vertex
+  // is within the search bounds.
+  bool reported(const DoubleApproximation& vertex, uint32_t trail) const;
+
+  // Return whether the vector with this approximation is within the search
+  // bounds; exact() is only called to compute the exact vector if this
+  // cannot be decided from the approximation.
+  template <typename Exact>
+  bool reported(const DoubleApproximation&, const Exact& exact) const;
+
+  // Return whether nothing beyond the half edge of this frame can be within
+  // the search radius.
+  bool beyond(const Frame&) const;
+
+  const ImplementationOf<SaddleConnections<Surface>>& connections;
+
+  // Lower and upper bounds for the search radius and for the lower bound
+  // as doubles.
+  double radius[2];
+  double lowerBound[2];
+
+  // The next sector that is going to be searched once the frames have been
+  // exhausted.
+  size_t sector = 0;
+
+  std::vector<Frame> frames;
+
+  // The segments of the paths to the vertices of the frames in the current
+  // sector; cleared whenever a sector has been searched completely.
+  std::vector<Trail> trails;
+
+  // The saddle connection found by the last call to next(), either a half
+  // edge at the beginning of a sector or a vertex reached on a trail.
+  HalfEdge source;
+  HalfEdge target;
+  std::optional<uint32_t> trail;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,93 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_BEST_FIRST_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_BEST_FIRST_HPP
+
+#include <optional>
+#include <queue>
+#include <vector>
+
+#include "../../flatsurf/saddle_connection.hpp"
+#include "saddle_connections.impl.hpp"
+#include "saddle_connections_crossing.hpp"
+
+namespace flatsurf {
+
+// A best-first search for saddle connections which produces them in order of
+// increasing length.
+// Unlike the search in SaddleConnectionsIterator, which descends depth-first
+// into the triangles of the surface, this search keeps a heap of the
+// triangle crossings it has not performed yet, keyed by a lower bound for
+// the length of anything that lies beyond them. It always performs the
+// crossing which is closest to the source. A saddle connection that has been
+// found is reported once it is certainly not longer than any crossing that
+// is still pending.
+// So the first connections are reported after only performing the crossings
+// that are closer than them, and the memory this search needs is
+// proportional to its frontier.
+template <typename Surface>
+class SaddleConnectionsBestFirst {
+  using T = typename Surface::Coordinate;
+  using Crossing = SaddleConnectionsCrossing<Surface>;
+  using Frontier = typename Crossing::Frontier;
+
+ public:
+  explicit SaddleConnectionsBestFirst(const ImplementationOf<SaddleConnections<Surface>>&);
+
+  // Return the next shortest saddle connection or nothing if all saddle
+  // connections have been reported.
+  std::optional<SaddleConnection<Surface>> next();
+
+ private:
+  struct Pending {
+    // A lower bound for the length of any saddle connection that is found
+    // beyond this crossing.
+    double distance;
+    Frontier frontier;
+
+    bool operator>(const Pending& rhs) const { return distance > rhs.distance; }
+  };
+
+  struct Found {
+    SaddleConnection<Surface> connection;
+    // An upper bound for the length of connection.
+    double length;
+
+    bool operator>(const Found& rhs) const;
+  };
+
+  // Queue a crossing; anything beyond it is at least at the given distance
+  // (and beyond the half edge that is crossed.)
+  void push(Frontier&&, double distance);
+
+  void push(SaddleConnection<Surface>&&, const DoubleApproximation&);
+
+  const ImplementationOf<SaddleConnections<Surface>>& connections;
+
+  // An upper bound for the search radius; crossings beyond it are dropped.
+  std::optional<double> radius;
+
+  std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> frontier;
+  std::priority_queue<Found, std::vector<Found>, std::greater<Found>> found;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,56 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_BUCKETS_IMPL_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_BUCKETS_IMPL_HPP
+
+#include <vector>
+
+#include "../../flatsurf/bound.hpp"
+#include "../../flatsurf/saddle_connection_records.hpp"
+#include "../../flatsurf/saddle_connections_buckets.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+class ImplementationOf<SaddleConnectionsBuckets<Surface>> {
+ public:
+  ImplementationOf(std::vector<SaddleConnectionRecords<Surface>> buckets, std::vector<Bound> bounds);
+
+  // Record that a saddle connection has been added to the bucket.
+  void add(size_t bucket);
+
+  // Return the number of saddle connections in the buckets before the
+  // given bucket.
+  size_t before(size_t bucket) const;
+
+  std::vector<Bound> bounds;
+  std::vector<SaddleConnectionRecords<Surface>> buckets;
+
+  // The number of saddle connections in the buckets as a Fenwick tree, so
+  // that adding a connection and counting the connections in the buckets
+  // before a bucket both take logarithmic time in the number of buckets.
+  // The entry at position i (1-based) holds the number of connections in
+  // the buckets (i - (i & -i), i].
+  std::vector<size_t> counts;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -26,6 +26,8 @@
 #include "../../flatsurf/bound.hpp"
 #include "../../flatsurf/saddle_connection.hpp"
 #include "../../flatsurf/saddle_connections_by_length_iterator.hpp"
+#include "saddle_connections.impl.hpp"
+#include "saddle_connections_iterator.impl.hpp"
 
 namespace flatsurf {
 
@@ -49,6 +51,19 @@ class ImplementationOf<SaddleConnectionsByLengthIterator<Surface>> {
   Bound upperBoundInclusive;
   std::deque<SaddleConnection<Surface>> connectionsWithinBounds;
 
+  // The number of connections found so far, reported as the progress of the
+  // search to the Latency::global().
+  size_t found = 0;
+
+  // The search by angle that is continued with a larger radius for each new
+  // range of lengths.
+  ImplementationOf<SaddleConnections<Surface>> search;
+
+  // The parts of the search that are beyond upperBoundInclusive. We continue
+  // the search from there when we increase the bounds, so we never search
+  // the region within upperBoundInclusive again.
+  typename ImplementationOf<SaddleConnectionsIterator<Surface>>::Postponed postponed;
+
   // This is a hack to work around https://bitbucket.org/wlav/cppyy/issues/271/next-implementation-does-not-respect.
   mutable std::list<SaddleConnection<Surface>> currents;
 };
@@ -0,0 +1,130 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_CACHE_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_CACHE_HPP
+
+#include <gmpxx.h>
+
+#include <algorithm>
+#include <optional>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "../../flatsurf/bound.hpp"
+#include "../../flatsurf/chain.hpp"
+#include "../../flatsurf/chain_iterator.hpp"
+#include "../../flatsurf/edge.hpp"
+#include "../../flatsurf/flat_triangulation_combinatorial.hpp"
+#include "../../flatsurf/half_edge.hpp"
+#include "../../flatsurf/saddle_connection.hpp"
+#include "../../flatsurf/saddle_connections.hpp"
+#include "../../flatsurf/saddle_connections_iterator.hpp"
+#include "../../flatsurf/vector.hpp"
+
+namespace flatsurf {
+
+// All the saddle connections on a surface up to a radius, sorted by length,
+// see SaddleConnections::cached().
+// The connections are stored without a reference to their surface since the
+// cache is kept by the surface itself. Any change to the surface, e.g., a
+// flip, empties the cache.
+template <typename Surface>
+class SaddleConnectionsCache {
+  using T = typename Surface::Coordinate;
+
+ public:
+  struct Entry {
+    HalfEdge source;
+    HalfEdge target;
+    Vector<T> vector;
+    // The nonzero coefficients of the chain of the connection, keyed by the
+    // index of their edge.
+    std::vector<std::pair<size_t, mpz_class>> chain;
+  };
+
+  // Return whether the cache contains all the saddle connections of length
+  // at most bound.
+  bool covers(const Bound& bound) const {
+    return radius && !(*radius < bound);
+  }
+
+  // Replace the content of the cache with all the saddle connections of
+  // length at most radius on surface.
+  void fill(const Surface& surface, const Bound& radius) {
+    entries.clear();
+
+    for (const auto& connection : SaddleConnections<Surface>(surface).bound(radius)) {
+      Entry entry{connection.source(), connection.target(), connection.vector(), {}};
+      for (const auto& [edge, coefficient] : connection.chain())
+        entry.chain.emplace_back(edge.index(), *coefficient);
+      entries.push_back(std::move(entry));
+    }
+
+    std::stable_sort(begin(entries), end(entries), [](const auto& lhs, const auto& rhs) {
+      return lhs.vector * lhs.vector < rhs.vector * rhs.vector;
+    });
+
+    this->radius = radius;
+  }
+
+  // Return the number of entries of length at most bound, i.e., the entries
+  // that make up the prefix of entries.
+  size_t prefix(const Bound& bound) const {
+    return static_cast<size_t>(std::partition_point(begin(entries), end(entries), [&](const auto& entry) { return !(entry.vector > bound); }) - begin(entries));
+  }
+
+  // Return the saddle connection of an entry on surface.
+  static SaddleConnection<Surface> connection(const Surface& surface, const Entry& entry) {
+    std::vector<mpz_class> coefficients(surface.size());
+    for (const auto& [edge, coefficient] : entry.chain)
+      coefficients[edge] = coefficient;
+    return SaddleConnection<Surface>(surface, entry.source, entry.target, Chain<Surface>(surface, coefficients));
+  }
+
+  void clear() {
+    radius.reset();
+    entries.clear();
+  }
+
+  static void clearAfterFlip(SaddleConnectionsCache& self, const FlatTriangulationCombinatorial&, HalfEdge) { self.clear(); }
+  static void clearBeforeCollapse(SaddleConnectionsCache& self, const FlatTriangulationCombinatorial&, Edge) { self.clear(); }
+  static void clearBeforeSwap(SaddleConnectionsCache& self, const FlatTriangulationCombinatorial&, HalfEdge, HalfEdge) { self.clear(); }
+  static void clearBeforeErase(SaddleConnectionsCache& self, const FlatTriangulationCombinatorial&, const std::vector<Edge>&) { self.clear(); }
+
+  friend std::ostream& operator<<(std::ostream& os, const SaddleConnectionsCache& self) {
+    os << "SaddleConnectionsCache(" << self.entries.size() << " connections";
+    if (self.radius)
+      os << " up to " << *self.radius;
+    return os << ")";
+  }
+
+  // The radius up to which all saddle connections are in entries or nothing
+  // if the cache is empty.
+  std::optional<Bound> radius;
+
+  // The saddle connections sorted by length.
+  std::vector<Entry> entries;
+};
+
+}  // namespace flatsurf
+
+#endif
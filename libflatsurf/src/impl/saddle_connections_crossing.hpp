@@ -0,0 +1,79 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_CROSSING_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_CROSSING_HPP
+
+#include <optional>
+
+#include "../../flatsurf/saddle_connection.hpp"
+#include "double_approximation.hpp"
+#include "saddle_connections.impl.hpp"
+#include "saddle_connections_iterator.impl.hpp"
+
+namespace flatsurf {
+
+// The elementary step of the searches for saddle connections that do not
+// drive the state machine of SaddleConnectionsIterator: given a Frontier,
+// i.e., a search sector and a half edge to cross, cross that half edge and
+// determine the saddle connection and the (at most two) Frontiers on the
+// other side.
+// Each Frontier is self-contained, so such searches can process them in any
+// order, see SaddleConnectionsBestFirst and SaddleConnectionsDepthFirst.
+template <typename Surface>
+class SaddleConnectionsCrossing {
+  using T = typename Surface::Coordinate;
+  using Search = ImplementationOf<SaddleConnectionsIterator<Surface>>;
+
+ public:
+  using Frontier = typename Search::Frontier;
+
+  // The result of crossing the half edge of a Frontier.
+  struct Expansion {
+    // The saddle connection to the vertex on the other side if it is in the
+    // search sector.
+    std::optional<SaddleConnection<Surface>> connection;
+    // An approximation of the vertex on the other side.
+    DoubleApproximation approximation;
+    // The parts of the search sector clockwise and counterclockwise of that
+    // vertex that still need to be searched.
+    std::optional<Frontier> clockwise;
+    std::optional<Frontier> counterclockwise;
+  };
+
+  // Return the first Frontier of the search in the sector with the given
+  // index (if the sector is not on the boundary) and set initial to the
+  // saddle connection on the half edge at the beginning of the sector if it
+  // is contained in the sector.
+  static std::optional<Frontier> start(const ImplementationOf<SaddleConnections<Surface>>&, size_t sector, std::optional<SaddleConnection<Surface>>& initial);
+
+  static Expansion expand(const ImplementationOf<SaddleConnections<Surface>>&, const Frontier&);
+
+  // Return an approximation of the start of the half edge of a Frontier.
+  static DoubleApproximation startApproximation(const ImplementationOf<SaddleConnections<Surface>>&, const Frontier&);
+
+ private:
+  // Return the orientation of boundary[side] and vertex; tries a cheap
+  // floating point filter before resorting to exact arithmetic.
+  static CCW ccw(const Frontier&, int side, const Chain<Surface>& vertex, const DoubleApproximation&);
+};
+
+}  // namespace flatsurf
+
+#endif
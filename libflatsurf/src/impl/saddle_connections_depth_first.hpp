@@ -0,0 +1,74 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_DEPTH_FIRST_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_DEPTH_FIRST_HPP
+
+#include <optional>
+#include <vector>
+
+#include "../../flatsurf/saddle_connection.hpp"
+#include "double_approximation.hpp"
+#include "saddle_connections.impl.hpp"
+#include "saddle_connections_crossing.hpp"
+
+namespace flatsurf {
+
+// The depth-first search of SaddleConnectionsIterator written in terms of
+// self-contained frames instead of a hand-rolled call stack.
+// The search in SaddleConnectionsIterator encodes its recursion in a stack of
+// States, a queue of pending Moves, and a stack of temporary Boundaries since
+// C++17 lacks stackless coroutines. This search keeps what would be the
+// frame of such a coroutine explicitly, namely the search sector and the half
+// edge that is about to be crossed, in a single stack. It reports the same
+// saddle connections in the same order but cannot skip sectors or postpone
+// parts of the search.
+template <typename Surface>
+class SaddleConnectionsDepthFirst {
+  using Crossing = SaddleConnectionsCrossing<Surface>;
+  using Frontier = typename Crossing::Frontier;
+
+ public:
+  explicit SaddleConnectionsDepthFirst(const ImplementationOf<SaddleConnections<Surface>>&);
+
+  // Return the next saddle connection or nothing if all saddle connections
+  // have been reported.
+  std::optional<SaddleConnection<Surface>> next();
+
+ private:
+  // Return whether a saddle connection, whose vector is approximated by
+  // approximation, is within the search bounds.
+  bool reported(const SaddleConnection<Surface>&, const DoubleApproximation& approximation) const;
+
+  // Return whether nothing beyond the half edge of this frame can be within
+  // the search radius.
+  bool beyond(const Frontier&) const;
+
+  const ImplementationOf<SaddleConnections<Surface>>& connections;
+
+  // The next sector that is going to be searched once the frames have been
+  // exhausted.
+  size_t sector = 0;
+
+  std::vector<Frontier> frames;
+};
+
+}  // namespace flatsurf
+
+#endif
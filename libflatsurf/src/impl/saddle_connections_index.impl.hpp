@@ -0,0 +1,59 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_INDEX_IMPL_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_INDEX_IMPL_HPP
+
+#include <utility>
+#include <vector>
+
+#include "../../flatsurf/bound.hpp"
+#include "../../flatsurf/saddle_connection.hpp"
+#include "../../flatsurf/saddle_connections_index.hpp"
+#include "read_only.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+class ImplementationOf<SaddleConnectionsIndex<Surface>> {
+  using T = typename Surface::Coordinate;
+
+ public:
+  ImplementationOf(const Surface&, Bound radius);
+
+  // Return the range of positions in the connections of the sector starting
+  // at source whose directions are in [sectorBegin, sectorEnd). Both
+  // boundaries must be in that sector.
+  std::pair<size_t, size_t> range(HalfEdge source, const Vector<T>& sectorBegin, const Vector<T>& sectorEnd) const;
+
+  ReadOnly<Surface> surface;
+  Bound radius;
+
+  // The indexed saddle connections in each sector, indexed by the
+  // HalfEdge::index() of the half edge at which the sector starts and sorted
+  // by angle.
+  std::vector<std::vector<SaddleConnection<Surface>>> sectors;
+
+  size_t size = 0;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,131 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_INTEGER_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_INTEGER_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "../../flatsurf/ccw.hpp"
+#include "../../flatsurf/saddle_connection.hpp"
+#include "saddle_connections.impl.hpp"
+
+namespace flatsurf {
+
+// The depth-first search of SaddleConnectionsDepthFirst specialized to
+// surfaces with machine integer coordinates.
+// The generic search keeps a Chain for the vertex and the boundaries of
+// each frame and classifies vertices with a floating point filter that
+// falls back to exact arithmetic. For long long coordinates of bounded size,
+// none of this is necessary: the frames only hold plain integer vectors
+// read from the coordinate columns of the surface and all orientations are
+// decided exactly by 128 bit cross products. The Chain of a saddle
+// connection is only built when it is actually requested by connection().
+// The search reports the same saddle connections in the same order as
+// SaddleConnectionsDepthFirst.
+template <typename Surface>
+class SaddleConnectionsInteger {
+ public:
+  explicit SaddleConnectionsInteger(const ImplementationOf<SaddleConnections<Surface>>&);
+
+  // Return whether this search can be used for these connections, i.e.,
+  // whether the surface has long long coordinates and the search radius
+  // and the half edges are small enough so that no coordinate that shows up
+  // during the search can overflow.
+  static bool applicable(const ImplementationOf<SaddleConnections<Surface>>&);
+
+  // Advance to the next saddle connection; return false if all saddle
+  // connections have been reported.
+  bool next();
+
+  // Return the saddle connection found by the last call to next().
+  SaddleConnection<Surface> connection() const;
+
+ private:
+  struct Point {
+    long long x;
+    long long y;
+  };
+
+  // A segment of the path of half edges that leads to a vertex: the vertex
+  // is reached by walking to the vertex of the parent and then along the
+  // half edges a and b.
+  struct Trail {
+    HalfEdge a;
+    HalfEdge b;
+    uint32_t parent;
+  };
+
+  // The analogue of SaddleConnectionsCrossing::Frontier. Boundaries that
+  // came from a Chain are exclusive, boundaries that are the original
+  // sector vectors are inclusive at the start of the sector.
+  struct Frame {
+    size_t sector;
+    Point boundary[2];
+    bool exclusive[2];
+    HalfEdge nextEdge;
+    Point nextEdgeEnd;
+    uint32_t trail;
+  };
+
+  // Start the search in the next sector; return whether the half edge at
+  // the beginning of that sector is a saddle connection that is reported.
+  bool start();
+
+  Point vector(HalfEdge) const;
+
+  // Return whether a vertex is within the search bounds.
+  bool reported(const Point&) const;
+
+  // Return whether nothing beyond the half edge of this frame can be within
+  // the search radius.
+  bool beyond(const Frame&) const;
+
+  static CCW ccw(const Point&, const Point&);
+  static __int128 norm(const Point&);
+
+  const ImplementationOf<SaddleConnections<Surface>>& connections;
+
+  // The squared search radius and the squared lower bound.
+  __int128 radius;
+  __int128 lowerBound;
+
+  // The next sector that is going to be searched once the frames have been
+  // exhausted.
+  size_t sector = 0;
+
+  std::vector<Frame> frames;
+
+  // The segments of the paths to the vertices of the frames in the current
+  // sector; cleared whenever a sector has been searched completely.
+  std::vector<Trail> trails;
+
+  // The saddle connection found by the last call to next(), either a half
+  // edge at the beginning of a sector or a vertex reached on a trail.
+  HalfEdge source;
+  HalfEdge target;
+  std::optional<uint32_t> trail;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -20,7 +20,8 @@
 #ifndef LIBFLATSURF_SADDLE_CONNECTIONS_ITERATOR_IMPL_HPP
 #define LIBFLATSURF_SADDLE_CONNECTIONS_ITERATOR_IMPL_HPP
 
-#include <deque>
+#include <memory>
+#include <mutex>
 #include <stack>
 #include <variant>
 #include <vector>
@@ -29,6 +30,13 @@
 #include "../../flatsurf/ccw.hpp"
 #include "../../flatsurf/half_edge.hpp"
 #include "../../flatsurf/saddle_connections_iterator.hpp"
+#include "../../flatsurf/saddle_connections_iterator_checkpoint.hpp"
+#include "../../flatsurf/saddle_connections_statistics.hpp"
+#include "../util/recycling_stack.ipp"
+#include "../util/ring_buffer.ipp"
+#include "double_approximation.hpp"
+#include "read_only.hpp"
+#include "saddle_connections.impl.hpp"
 
 namespace flatsurf {
 
@@ -51,6 +59,10 @@ class ImplementationOf<SaddleConnectionsIterator<Surface>> {
     START_FROM_INSIDE_TO_OUTSIDE,
     // The search will now cross nextEdge which starts outside or at the search radius and ends inside the search radius
     START_FROM_OUTSIDE_TO_INSIDE,
+    // The search would now cross nextEdge which starts and ends outside the
+    // search radius. This part of the search is only recorded when
+    // postponing, see Postponed.
+    START_FROM_OUTSIDE_TO_OUTSIDE,
     OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE,
     OUTSIDE_SEARCH_SECTOR_CLOCKWISE,
     // The iterator has stopped at a Saddle Connection inside or at the search radius
@@ -68,16 +80,87 @@ class ImplementationOf<SaddleConnectionsIterator<Surface>> {
 
   using Boundary = std::variant<Chain<Surface>, Vector<T>>;
 
+  // The statistics of a single search which are added to the statistics of
+  // the saddle connections when the search is destroyed, see
+  // SaddleConnections::collectStatistics().
+  class Statistics {
+    using Collected = typename ImplementationOf<SaddleConnections<Surface>>::Statistics;
+
+   public:
+    explicit Statistics(std::shared_ptr<Collected>);
+    // A copy of a search collects its statistics from scratch so that the
+    // shared part of the search is not counted twice.
+    Statistics(const Statistics&);
+    Statistics(Statistics&&);
+    Statistics& operator=(const Statistics&);
+    Statistics& operator=(Statistics&&);
+    ~Statistics();
+
+    // Update the counters if statistics are being collected.
+    template <typename F>
+    void record(F&& update) {
+      if (collected)
+        update(counters);
+    }
+
+   private:
+    void flush();
+
+    std::shared_ptr<Collected> collected;
+    SaddleConnectionsStatistics counters;
+  };
+
+  // A snapshot of the search right before it crosses nextEdge into a region
+  // that is completely beyond the search radius.
+  struct Frontier {
+    // The index of the sector that is being searched.
+    size_t sector;
+    Boundary boundary[2];
+    DoubleApproximation boundaryApproximation[2];
+    HalfEdge nextEdge;
+    Chain<Surface> nextEdgeEnd;
+    DoubleApproximation nextEdgeEndApproximation;
+  };
+
+  // The parts of a search that lie beyond its search radius. The search can
+  // be continued from these with an increased radius without visiting the
+  // parts of the search within the original radius again.
+  struct Postponed {
+    // The saddle connections that we found but that were beyond the search
+    // radius.
+    std::vector<SaddleConnection<Surface>> connections;
+    // The subtrees of the search that we did not descend into.
+    std::vector<Frontier> frontier;
+  };
+
   static CCW ccw(const Boundary& lhs, const Chain<Surface>& rhs);
   static CCW ccw(const Boundary& lhs, const Boundary& rhs);
   static CCW ccw(const Boundary& lhs, const Vector<T>& rhs);
 
-  ImplementationOf(const ImplementationOf<SaddleConnections<Surface>>&, const typename std::vector<Sector>::const_iterator begin, const typename std::vector<Sector>::const_iterator end);
+  // Return the orientation of boundary[side] and nextEdgeEnd; tries a cheap
+  // floating point filter before resorting to the above exact predicates.
+  CCW ccw(int side) const;
+
+  ImplementationOf(const ImplementationOf<SaddleConnections<Surface>>&, const typename std::vector<Sector>::const_iterator begin, const typename std::vector<Sector>::const_iterator end, Postponed* postponed = nullptr);
+
+  // Continue a postponed search from a frontier that has been recorded in an
+  // earlier search with a smaller radius.
+  ImplementationOf(const ImplementationOf<SaddleConnections<Surface>>&, const Frontier&, Postponed* postponed);
+
+  // Continue a search from a checkpoint, see SaddleConnections::resume().
+  ImplementationOf(const ImplementationOf<SaddleConnections<Surface>>&, const SaddleConnectionsIteratorCheckpoint<Surface>&);
 
   void prepareSearch();
 
   const ImplementationOf<SaddleConnections<Surface>>& connections;
 
+  // A borrowed reference to the surface of connections, see
+  // ReadOnly::borrow(). The chains of the search are created from it so that
+  // copying them around does not touch the reference count of the surface.
+  // The connections we report hold on to the surface again, see
+  // ImplementationOf<Chain>::own().
+  ReadOnly<Surface> surface;
+
   // The half edge nextEdge, to which we are currently changing, points into
   // sectors. Advanced when we are done searching an entire such sector for all
   // saddle connections.
@@ -95,6 +178,11 @@ class ImplementationOf<SaddleConnectionsIterator<Surface>> {
   // The vector to the target of nextEdge
   Chain<Surface> nextEdgeEnd;
 
+  // Floating point approximations of boundary and nextEdgeEnd with certified
+  // error bounds.
+  DoubleApproximation boundaryApproximation[2];
+  DoubleApproximation nextEdgeEndApproximation;
+
   // The call stack for increment().
   // As of early 2019, C++ lacks stackless coroutines. This code would be much
   // more readable with async/await idioms. And likely faster.
@@ -107,22 +195,36 @@ class ImplementationOf<SaddleConnectionsIterator<Surface>> {
   // optimize such tail recursion.)
   // (This should really be a stack. But we want to print its content easily
   // for debugging which a stack does not support.)
-  std::deque<State> state;
+  // This is a vector and not a deque since a vector keeps its capacity when
+  // it shrinks, so deep searches do not allocate on every push.
+  // See SaddleConnectionsDepthFirst for the same search written in terms of
+  // explicit frames.
+  std::vector<State> state;
 
   // We collect pending moves across the surface here (adding half edges to
   // nextEdgeEnd mostly.) When the exact value of nextEdgeEnd is required, we
   // can often combine several move more efficiently, see applyMoves().
-  std::deque<Move> moves;
+  RingBuffer<Move> moves;
 
   // Storage space for temporary values of boundary, when we descend
-  // recursively into a subsector.
-  std::stack<Boundary> tmp;
+  // recursively into a subsector. The popped boundaries are kept around
+  // so that their chains can be recycled when pushing again.
+  RecyclingStack<Boundary> tmp;
+  std::stack<DoubleApproximation, std::vector<DoubleApproximation>> tmpApproximation;
 
   // The current connection so we can return it in dereference by reference.
   mutable SaddleConnection<Surface> connection;
 
+  // Where to record the parts of the search beyond the search radius, if at
+  // all.
+  Postponed* postponed;
+
+  mutable Statistics statistics;
+
   bool increment();
 
+  const SaddleConnection<Surface>& dereference() const;
+
   bool onBoundary();
 
   void skipSector(CCW sector);
@@ -134,8 +236,64 @@ class ImplementationOf<SaddleConnectionsIterator<Surface>> {
   Classification classifyHalfEdgeEnd();
 
   void pushStart(bool fromOutside, bool toOutside);
+
+  // Return a copy of chain (which might live on an equal but distinct
+  // surface) that lives on our surface.
+  Chain<Surface> rebase(const Chain<Surface>& chain) const;
+
+  // Return a floating point approximation of a boundary from scratch.
+  static DoubleApproximation approximate(const Boundary&);
 };
 
+template <typename Surface>
+ImplementationOf<SaddleConnectionsIterator<Surface>>::Statistics::Statistics(std::shared_ptr<Collected> collected) :
+  collected(std::move(collected)) {}
+
+template <typename Surface>
+ImplementationOf<SaddleConnectionsIterator<Surface>>::Statistics::Statistics(const Statistics& other) :
+  collected(other.collected) {}
+
+template <typename Surface>
+ImplementationOf<SaddleConnectionsIterator<Surface>>::Statistics::Statistics(Statistics&& other) :
+  collected(std::move(other.collected)),
+  counters(other.counters) {
+  other.collected = nullptr;
+}
+
+template <typename Surface>
+typename ImplementationOf<SaddleConnectionsIterator<Surface>>::Statistics& ImplementationOf<SaddleConnectionsIterator<Surface>>::Statistics::operator=(const Statistics& other) {
+  if (this != &other) {
+    flush();
+    collected = other.collected;
+  }
+  return *this;
+}
+
+template <typename Surface>
+typename ImplementationOf<SaddleConnectionsIterator<Surface>>::Statistics& ImplementationOf<SaddleConnectionsIterator<Surface>>::Statistics::operator=(Statistics&& other) {
+  if (this != &other) {
+    flush();
+    collected = std::move(other.collected);
+    counters = other.counters;
+    other.collected = nullptr;
+  }
+  return *this;
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnectionsIterator<Surface>>::Statistics::~Statistics() {
+  flush();
+}
+
+template <typename Surface>
+void ImplementationOf<SaddleConnectionsIterator<Surface>>::Statistics::flush() {
+  if (collected) {
+    std::lock_guard lock(collected->mutex);
+    collected->statistics += counters;
+  }
+  counters = SaddleConnectionsStatistics();
+}
+
 template <typename Surface>
 template <typename... Args>
 SaddleConnectionsIterator<Surface>::SaddleConnectionsIterator(PrivateConstructor, Args&&... args) :
@@ -0,0 +1,55 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_LATTICE_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_LATTICE_HPP
+
+#include <cstddef>
+
+#include "saddle_connections.impl.hpp"
+
+namespace flatsurf {
+
+// Counts saddle connections on square-tiled surfaces without looking at the
+// geometry of the triangulation.
+// When the half edges of a closed surface have integer coordinates and the
+// vertices of the triangulation are all the preimages of the lattice point
+// of the torus R²/Z² that the surface covers, then a corner of a triangle
+// at a vertex emits exactly one saddle connection for each primitive vector
+// (x, y) in that corner, namely the one with holonomy (x, y). So counting
+// saddle connections amounts to counting primitive lattice vectors in the
+// corners of the search sectors which we do with a walk in the
+// Stern-Brocot tree that is pruned to the search radius and the corner.
+template <typename Surface>
+class SaddleConnectionsLattice {
+ public:
+  // Return whether the surface is square-tiled in the above sense and the
+  // search sectors are full corners of triangles, so that count() can be
+  // used for these connections.
+  static bool applicable(const ImplementationOf<SaddleConnections<Surface>>&);
+
+  // Return the number of saddle connections in the search sectors within
+  // the search bounds.
+  static size_t count(const ImplementationOf<SaddleConnections<Surface>>&);
+};
+
+}  // namespace flatsurf
+
+#endif
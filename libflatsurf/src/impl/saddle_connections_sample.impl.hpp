@@ -20,6 +20,8 @@
 #ifndef LIBFLATSURF_SADDLE_CONNECTIONS_SAMPLE_IMPL_HPP
 #define LIBFLATSURF_SADDLE_CONNECTIONS_SAMPLE_IMPL_HPP
 
+#include <optional>
+
 #include "../../flatsurf/saddle_connections_sample.hpp"
 #include "saddle_connections.impl.hpp"
 
@@ -31,6 +33,20 @@ class ImplementationOf<SaddleConnectionsSample<Surface>> : public Implementation
 
  public:
   ImplementationOf(const ImplementationOf<SaddleConnections<Surface>>& connections);
+
+  // Return sample with the seed and deduplication of this sample.
+  SaddleConnectionsSample<Surface> configure(SaddleConnectionsSample<Surface>&& sample) const;
+
+  // The seed of the random number generator of the iterators, if fixed.
+  std::optional<unsigned int> seed;
+
+  // The number of connections the iterators remember to not report a
+  // connection twice; unbounded if not set.
+  std::optional<size_t> deduplication;
+
+  // Whether the iterators sample by following straight lines in random
+  // directions.
+  bool trajectories = false;
 };
 
 template <typename Surface>
@@ -20,12 +20,14 @@
 #ifndef LIBFLATSURF_SADDLE_CONNECTIONS_SAMPLE_ITERATOR_IMPL_HPP
 #define LIBFLATSURF_SADDLE_CONNECTIONS_SAMPLE_ITERATOR_IMPL_HPP
 
+#include <deque>
 #include <random>
 #include <tuple>
 #include <unordered_set>
 
 #include "../../flatsurf/saddle_connection.hpp"
 #include "../../flatsurf/saddle_connections_sample_iterator.hpp"
+#include "../util/sharded_set.ipp"
 
 namespace flatsurf {
 
@@ -36,11 +38,32 @@ class ImplementationOf<SaddleConnectionsSampleIterator<Surface>> {
  public:
   ImplementationOf(const SaddleConnectionsSample<Surface>&);
 
+  // A sampler that draws from the given random stream and only reports
+  // connections that are not in shared yet. Several such samplers can run in
+  // parallel when they share the same set.
+  ImplementationOf(const SaddleConnectionsSample<Surface>&, std::mt19937 rand, ShardedSet<SaddleConnection<Surface>>* shared);
+
   void increment();
 
+  // Advance to the next sample by following a straight line in a random
+  // direction, see SaddleConnectionsSample::trajectories().
+  void flow();
+
+  // Return whether connection has not been reported before and record it
+  // as reported.
+  bool fresh(const SaddleConnection<Surface>&);
+
   const SaddleConnectionsSample<Surface>& connections;
   std::unordered_set<SaddleConnection<Surface>> seen;
 
+  // The connections in seen in the order they were reported so we can
+  // forget the oldest ones when deduplication is bounded.
+  std::deque<SaddleConnection<Surface>> history;
+
+  // The connections reported by all samplers running in parallel with this
+  // one, if any; seen is not used then.
+  ShardedSet<SaddleConnection<Surface>>* shared = nullptr;
+
   SaddleConnection<Surface> current;
 
   std::mt19937 rand;
@@ -21,16 +21,13 @@
 #define LIBFLATSURF_TRACKED_IMPL_HPP
 
 #include "../../flatsurf/tracked.hpp"
-#include "../external/sigslot/include/sigslot/signal.hpp"
 #include "flat_triangulation_combinatorial.impl.hpp"
 #include "weak_read_only.hpp"
 
 namespace flatsurf {
 
 template <typename T>
-class ImplementationOf<Tracked<T>> {
-  using Message = typename ImplementationOf<FlatTriangulationCombinatorial>::Message;
-
+class ImplementationOf<Tracked<T>> final : ImplementationOf<FlatTriangulationCombinatorial>::Observer {
  public:
   using FlipHandler = typename Tracked<T>::FlipHandler;
   using CollapseHandler = typename Tracked<T>::CollapseHandler;
@@ -42,9 +39,20 @@ class ImplementationOf<Tracked<T>> {
 
   static Tracked<T> make(const ImplementationOf<FlatTriangulationCombinatorial>*, T value, const FlipHandler& updateAfterFlip = Tracked<T>::defaultFlip, const CollapseHandler& updateBeforeCollapse = Tracked<T>::defaultCollapse, const SwapHandler& updateBeforeSwap = Tracked<T>::defaultSwap, const EraseHandler& updateBeforeErase = Tracked<T>::defaultErase, const DestructionHandler& updateBeforeDestruction = Tracked<T>::forgetParent);
 
+  // Declare that the flip handler of this object only depends on the
+  // flipped edge, so it can be notified in bulk at the end of a
+  // FlipTransaction, see ImplementationOf<FlatTriangulationCombinatorial>::Observer::deferrable().
+  static void defer(Tracked<T>&);
+
   ~ImplementationOf();
 
-  void connect();
+  void afterFlip(HalfEdge) override;
+  void afterFlips(const std::vector<HalfEdge>&) override;
+  void beforeCollapse(Edge) override;
+  void beforeSwap(HalfEdge, HalfEdge) override;
+  void beforeErase(const std::vector<Edge>&) override;
+  void beforeDestruction() override;
+  bool deferrable() const override;
 
   WeakReadOnly<FlatTriangulationCombinatorial> parent;
   T value;
@@ -55,7 +63,7 @@ class ImplementationOf<Tracked<T>> {
   const EraseHandler updateBeforeErase;
   const DestructionHandler updateBeforeDestruction;
 
-  typename sigslot::connection onChange;
+  bool deferred = false;
 };
 
 }  // namespace flatsurf
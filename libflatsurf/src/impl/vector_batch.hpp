@@ -0,0 +1,132 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_VECTOR_BATCH_HPP
+#define LIBFLATSURF_VECTOR_BATCH_HPP
+
+#include <type_traits>
+#include <vector>
+
+#include "../../flatsurf/ccw.hpp"
+#include "../../flatsurf/orientation.hpp"
+#include "../../flatsurf/vector.hpp"
+
+namespace flatsurf {
+
+// The coordinates of many vectors stored as a structure of arrays, i.e.,
+// all the x coordinates are contiguous in memory and so are all the y
+// coordinates. Loops over such columns are streamed sequentially and can be
+// vectorized by the compiler for machine integer coordinates.
+template <typename T>
+struct VectorColumns {
+  void resize(size_t size) {
+    x.resize(size);
+    y.resize(size);
+  }
+
+  void set(size_t i, const Vector<T>& vector) {
+    x[i] = vector.x();
+    y[i] = vector.y();
+  }
+
+  size_t size() const { return x.size(); }
+
+  std::vector<T> x;
+  std::vector<T> y;
+};
+
+// Evaluates predicates of many vectors relative to a fixed direction at once.
+// For machine integer coordinates, the coordinates are first gathered into
+// contiguous arrays so that the compiler can vectorize the actual arithmetic.
+// For other coordinate types, the predicates are evaluated one by one.
+template <typename T>
+class VectorBatch {
+ public:
+  // Set ccws[i] to direction.ccw(*vectors[i]).
+  static void ccw(const Vector<T>& direction, const std::vector<const Vector<T>*>& vectors, std::vector<CCW>& ccws) {
+    if constexpr (std::is_same_v<T, long long>) {
+      ccw(direction, gather(vectors), ccws);
+    } else {
+      ccws.resize(vectors.size());
+      for (size_t i = 0; i < vectors.size(); i++)
+        ccws[i] = direction.ccw(*vectors[i]);
+    }
+  }
+
+  // Set ccws[i] to direction.ccw(Vector(vectors.x[i], vectors.y[i])).
+  static void ccw(const Vector<T>& direction, const VectorColumns<T>& vectors, std::vector<CCW>& ccws) {
+    static_assert(std::is_same_v<T, long long>, "predicates on columns are only implemented for machine integers");
+
+    const long long dx = direction.x();
+    const long long dy = direction.y();
+
+    std::vector<int> sign(vectors.size());
+    for (size_t i = 0; i < sign.size(); i++) {
+      const long long a = dx * vectors.y[i];
+      const long long b = vectors.x[i] * dy;
+      sign[i] = (a > b) - (a < b);
+    }
+
+    ccws.resize(vectors.size());
+    for (size_t i = 0; i < sign.size(); i++)
+      ccws[i] = sign[i] == 0 ? CCW::COLLINEAR : (sign[i] > 0 ? CCW::COUNTERCLOCKWISE : CCW::CLOCKWISE);
+  }
+
+  // Set orientations[i] to direction.orientation(*vectors[i]).
+  static void orientation(const Vector<T>& direction, const std::vector<const Vector<T>*>& vectors, std::vector<ORIENTATION>& orientations) {
+    if constexpr (std::is_same_v<T, long long>) {
+      orientation(direction, gather(vectors), orientations);
+    } else {
+      orientations.resize(vectors.size());
+      for (size_t i = 0; i < vectors.size(); i++)
+        orientations[i] = direction.orientation(*vectors[i]);
+    }
+  }
+
+  // Set orientations[i] to direction.orientation(Vector(vectors.x[i], vectors.y[i])).
+  static void orientation(const Vector<T>& direction, const VectorColumns<T>& vectors, std::vector<ORIENTATION>& orientations) {
+    static_assert(std::is_same_v<T, long long>, "predicates on columns are only implemented for machine integers");
+
+    const long long dx = direction.x();
+    const long long dy = direction.y();
+
+    std::vector<int> sign(vectors.size());
+    for (size_t i = 0; i < sign.size(); i++) {
+      const long long dot = dx * vectors.x[i] + dy * vectors.y[i];
+      sign[i] = (dot > 0) - (dot < 0);
+    }
+
+    orientations.resize(vectors.size());
+    for (size_t i = 0; i < sign.size(); i++)
+      orientations[i] = sign[i] == 0 ? ORIENTATION::ORTHOGONAL : (sign[i] > 0 ? ORIENTATION::SAME : ORIENTATION::OPPOSITE);
+  }
+
+ private:
+  static VectorColumns<T> gather(const std::vector<const Vector<T>*>& vectors) {
+    VectorColumns<T> columns;
+    columns.resize(vectors.size());
+    for (size_t i = 0; i < vectors.size(); i++)
+      columns.set(i, *vectors[i]);
+    return columns;
+  }
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,75 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_VEECH_GROUP_IMPL_HPP
+#define LIBFLATSURF_VEECH_GROUP_IMPL_HPP
+
+#include <exact-real/arb.hpp>
+#include <optional>
+#include <vector>
+
+#include "../../flatsurf/veech_group.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+class ImplementationOf<VeechGroup<Surface>> {
+  using T = typename Surface::Coordinate;
+  using Element = typename VeechGroup<Surface>::Element;
+
+ public:
+  ImplementationOf(const Surface& surface);
+
+  // Return whether the matrix sending u to gu and v to gv might be an
+  // element of the Veech group judging from enclosures of its determinant
+  // and its trace.
+  bool plausible(const Vector<exactreal::Arb>& gu, const Vector<exactreal::Arb>& gv) const;
+
+  // Return the matrix sending u to gu and v to gv.
+  Element element(const Vector<T>& gu, const Vector<T>& gv) const;
+
+  // Return the matrix sending u to gu and v to gv if it is an element of the
+  // Veech group.
+  std::optional<Element> verify(const Vector<T>& gu, const Vector<T>& gv) const;
+
+  // A Delaunay triangulation of the surface.
+  Surface surface;
+
+  // The reference vectors, see VeechGroup::reference().
+  Vector<T> u, v;
+
+  // The cross product u × v, i.e., the common denominator of all elements.
+  T denominator;
+
+  Vector<exactreal::Arb> uApproximation, vApproximation;
+  exactreal::Arb denominatorApproximation;
+
+  // Enclosures of 2cos(2πk/n) for all orders n that an element of finite
+  // order can have on a surface of this genus, i.e., the possible traces of
+  // elliptic elements.
+  std::vector<exactreal::Arb> ellipticTraces;
+
+  // The canonical hash of surface, which is shared by the images of surface
+  // under all elements.
+  size_t hash;
+};
+
+}  // namespace flatsurf
+
+#endif
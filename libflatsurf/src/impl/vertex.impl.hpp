@@ -34,6 +34,8 @@ class ImplementationOf<Vertex> {
 
   static bool comparable(const HalfEdgeSet&, const HalfEdgeSet&);
   static void afterFlip(Vertex&, const FlatTriangulationCombinatorial&, HalfEdge flip);
+  // Exchange the half edges a and b if exactly one of them starts at this vertex.
+  static void afterSwap(Vertex&, HalfEdge a, HalfEdge b);
 
   static Vertex make(const std::vector<HalfEdge> sources);
 
@@ -0,0 +1,65 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_VERTEX_INVARIANTS_HPP
+#define LIBFLATSURF_VERTEX_INVARIANTS_HPP
+
+#include <ostream>
+#include <vector>
+
+namespace flatsurf {
+
+// Invariants of the vertices of a flat triangulation, indexed by the
+// position of the vertex in vertices().
+// Flips do not change the total angle at any vertex and they only change
+// the degree of the four vertices of the flipped quadrilateral, so these
+// can be kept up to date without recomputing them.
+struct VertexInvariants {
+  // Whether the invariants have been computed; any change to the surface
+  // other than a flip forgets them.
+  bool computed = false;
+
+  // The total angle at each vertex as a multiple of 2π.
+  std::vector<int> angles;
+
+  // The number of half edges starting at each vertex.
+  std::vector<size_t> degrees;
+
+  void clear() {
+    computed = false;
+    angles.clear();
+    degrees.clear();
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const VertexInvariants& self) {
+    if (!self.computed)
+      return os << "VertexInvariants()";
+
+    os << "VertexInvariants(";
+    for (size_t vertex = 0; vertex < self.angles.size(); vertex++) {
+      if (vertex) os << ", ";
+      os << "(" << self.angles[vertex] << ", " << self.degrees[vertex] << ")";
+    }
+    return os << ")";
+  }
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -20,9 +20,13 @@
 #ifndef LIBFLATSURF_VERTICAL_IMPL_HPP
 #define LIBFLATSURF_VERTICAL_IMPL_HPP
 
+#include <exact-real/arb.hpp>
 #include <functional>
+#include <mutex>
 
 #include "../../flatsurf/vertical.hpp"
+#include "edge_cache.hpp"
+#include "enclosure.hpp"
 #include "flat_triangulation.impl.hpp"
 #include "flat_triangulation_collapsed.impl.hpp"
 #include "managed_movable.impl.hpp"
@@ -44,18 +48,44 @@ class ImplementationOf<Vertical<Surface>> : ImplementationOf<ManagedMovable<Vert
   // which when returning false, aborts the process. (i.e., `visitor` found
   // a problem in the surface, such as a large edge that needs to be flipped
   // first.)
-  static bool visit(const Vertical& self, HalfEdge start, std::unordered_set<HalfEdge>& component, std::function<bool(HalfEdge)> visitor);
+  static bool visit(const Vertical& self, HalfEdge start, HalfEdgeSet& component, std::function<bool(HalfEdge)> visitor);
+
+  // Return -1, 0, or 1 if the absolute value of the perpendicular
+  // projection of the first edge is smaller than, equal to, or larger than
+  // the one of the second edge. This is decided on the approximate
+  // projections whenever possible, see compareProjectionsPerpendicular().
+  static int compareLengths(const Vertical& self, Edge, Edge);
+
+  // Return the approximation of the vector attached to this half edge.
+  Vector<exactreal::Arb> approximation(HalfEdge) const;
+
+  // Populate ccwCache and orientationCache for all half edges in one pass,
+  // unless this has been done already.
+  void batch() const;
 
   ReadOnly<Surface> surface;
   Vector<T> vertical;
   Vector<T> horizontal;
 
-  mutable Tracked<OddHalfEdgeMap<std::optional<T>>> parallelProjectionCache;
-  mutable Tracked<OddHalfEdgeMap<std::optional<T>>> perpendicularProjectionCache;
-  mutable Tracked<OddHalfEdgeMap<std::optional<CCW>>> ccwCache;
-  mutable Tracked<OddHalfEdgeMap<std::optional<ORIENTATION>>> orientationCache;
-  mutable Tracked<EdgeMap<std::optional<T>>> lengthCache;
-  mutable Tracked<EdgeMap<std::optional<bool>>> largenessCache;
+  // Approximations of vertical and horizontal for the approximate
+  // projections.
+  Vector<exactreal::Arb> verticalApproximation;
+  Vector<exactreal::Arb> horizontalApproximation;
+
+  mutable Tracked<OddHalfEdgeCache<T>> parallelProjectionCache;
+  mutable Tracked<OddHalfEdgeCache<T>> perpendicularProjectionCache;
+  mutable Tracked<OddHalfEdgeCache<CCW>> ccwCache;
+  mutable Tracked<OddHalfEdgeCache<ORIENTATION>> orientationCache;
+  mutable Tracked<EdgeCache<bool>> largenessCache;
+
+  // Whether batch() has populated the caches already. Afterwards, entries
+  // that become invalid due to flips are recomputed one by one.
+  mutable bool batched = false;
+
+  // Guards the caches above so that the const methods of a Vertical can be
+  // called from several threads at once. The lock is recursive since the
+  // cached queries call each other, e.g., large() relies on ccw().
+  mutable std::recursive_mutex cacheLock;
 
  private:
   using ImplementationOf<ManagedMovable<Vertical>>::from_this;
@@ -74,9 +74,36 @@ bool IndexedSet<T>::disjoint(const IndexedSet& rhs) const {
   return not set.intersects(rhs.set);
 }
 
+template <typename T>
+IndexedSet<T>& IndexedSet<T>::operator|=(const IndexedSet& rhs) {
+  set.resize(std::max(set.size(), rhs.set.size()));
+  rhs.set.resize(std::max(set.size(), rhs.set.size()));
+
+  set |= rhs.set;
+  return *this;
+}
+
+template <typename T>
+IndexedSet<T>& IndexedSet<T>::operator&=(const IndexedSet& rhs) {
+  set.resize(std::max(set.size(), rhs.set.size()));
+  rhs.set.resize(std::max(set.size(), rhs.set.size()));
+
+  set &= rhs.set;
+  return *this;
+}
+
+template <typename T>
+IndexedSet<T>& IndexedSet<T>::operator-=(const IndexedSet& rhs) {
+  set.resize(std::max(set.size(), rhs.set.size()));
+  rhs.set.resize(std::max(set.size(), rhs.set.size()));
+
+  set -= rhs.set;
+  return *this;
+}
+
 template <typename T>
 bool IndexedSet<T>::empty() const {
-  return begin() == end();
+  return set.none();
 }
 
 template <typename T>
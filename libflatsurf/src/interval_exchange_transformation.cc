@@ -24,13 +24,16 @@
 #include <intervalxt/interval_exchange_transformation.hpp>
 #include <intervalxt/label.hpp>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "../flatsurf/ccw.hpp"
 #include "../flatsurf/edge_set.hpp"
 #include "../flatsurf/fmt.hpp"
+#include "../flatsurf/half_edge_set.hpp"
 #include "../flatsurf/tracked.hpp"
 #include "../flatsurf/vertex.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
@@ -57,16 +60,11 @@ IntervalExchangeTransformation<Surface>::IntervalExchangeTransformation(const Su
 template <typename Surface>
 IntervalExchangeTransformation<Surface>::IntervalExchangeTransformation(const Surface& surface, const Vector<T>& vertical, HalfEdge large) :
   self([&]() {
-    CHECK_ARGUMENT(Vertical<Surface>(surface, vertical).large(large), "can only construct IntervalExchangeTransformation from a large half edge");
+    const Vertical<Surface> upward(surface, vertical);
 
-    vector<HalfEdge> top, bottom;
+    CHECK_ARGUMENT(upward.large(large), "can only construct IntervalExchangeTransformation from a large half edge");
 
-    ImplementationOf<ContourComponent<Surface>>::makeContour(back_inserter(top), large, surface, Vertical(surface, vertical));
-
-    ImplementationOf<ContourComponent<Surface>>::makeContour(back_inserter(bottom), -large, surface, Vertical(surface, -vertical));
-    reverse(bottom.begin(), bottom.end());
-    std::transform(bottom.begin(), bottom.end(), bottom.begin(), [](HalfEdge e) { return -e; });
-    assert(std::unordered_set<HalfEdge>(bottom.begin(), bottom.end()) == std::unordered_set<HalfEdge>(top.begin(), top.end()) && "top & bottom contour must contain the same half edges");
+    const auto [top, bottom] = ImplementationOf<IntervalExchangeTransformation>::contours(upward, -upward, large);
 
     return spimpl::make_unique_impl<ImplementationOf<IntervalExchangeTransformation>>(surface, vertical, top, bottom);
   }()) {
@@ -82,43 +80,37 @@ void IntervalExchangeTransformation<Surface>::makeUniqueLargeEdges(Surface& surf
   const bool splitContours = true;
 
   Vertical<Surface> vertical(surface, vertical_);
+  const Vertical<Surface> negated = -vertical;
 
   while (true) {
-    auto larges = surface.halfEdges() | rx::filter([&](const HalfEdge source) {
-      if (sources->contains(source)) return false;
-      if (!vertical.large(source)) return false;
-      if (vertical.ccw(source) == CCW::COUNTERCLOCKWISE) return false;
-      return true;
-    }) | rx::to_vector();
-
-    std::sort(begin(larges), end(larges), [&](const HalfEdge a, const HalfEdge b) {
-      auto alength = vertical.projectPerpendicular(a);
-      auto blength = vertical.projectPerpendicular(b);
-
-      if (alength < 0) alength = -alength;
-      if (blength < 0) blength = -blength;
-
-      return alength < blength;
-    });
+    // Pick the longest large edge that has not been processed yet. We only
+    // need the maximum, so there is no need to sort all large edges. The
+    // lengths, i.e., the absolute values of the projections, are compared
+    // on their approximations so that the exact projections are only
+    // computed for edges of (nearly) the same length.
+    std::optional<HalfEdge> longest;
+    for (const HalfEdge source : surface.halfEdges()) {
+      if (sources->contains(source)) continue;
+      if (!vertical.large(source)) continue;
+      if (vertical.ccw(source) == CCW::COUNTERCLOCKWISE) continue;
+      if (longest && ImplementationOf<Vertical<Surface>>::compareLengths(vertical, source, *longest) < 0) continue;
+      longest = source;
+    }
 
-    if (larges.size() == 0) break;
+    if (!longest) break;
 
-    HalfEdge source = larges.back();
+    HalfEdge source = *longest;
 
-    auto component = ImplementationOf<IntervalExchangeTransformation>::makeUniqueLargeEdge(surface, vertical_, source);
+    auto component = ImplementationOf<IntervalExchangeTransformation>::makeUniqueLargeEdge(surface, vertical, source);
 
     if (splitContours) {
-      bool trivial, trivialStart, trivialEnd;
-      {
-        // Some attached data might not be able to handle the following
-        // collapspe.  Therefore, we need to scope iet, so attached data is
-        // definitely gone when the collapse below happens.
-        auto fromContour = IntervalExchangeTransformation(surface, vertical_, source);
-        auto& iet = fromContour.intervalExchangeTransformation();
-        trivial = iet.top().size() == 1;
-        trivialStart = *iet.top().begin() == *iet.bottom().begin();
-        trivialEnd = *iet.top().rbegin() == *iet.bottom().rbegin();
-      }
+      // We only need to look at the contours of the component; there is no
+      // need to build the interval exchange transformation.
+      const auto [top, bottom] = ImplementationOf<IntervalExchangeTransformation>::contours(vertical, negated, source);
+
+      const bool trivial = top.size() == 1;
+      const bool trivialStart = top.front() == bottom.front();
+      const bool trivialEnd = top.back() == bottom.back();
 
       if (!trivial && (trivialStart || trivialEnd)) {
         // Since the first half edge of the top and bottom contour have the
@@ -197,13 +189,30 @@ ImplementationOf<IntervalExchangeTransformation<Surface>>::ImplementationOf(Inte
   auto erasedLengths = std::make_shared<intervalxt::Lengths>(Lengths<Surface>(*self.self->lengths, decomposition));
   iet = intervalxt::IntervalExchangeTransformation(erasedLengths, self.self->iet.top(), self.self->iet.bottom());
   lengths = boost::type_erasure::any_cast<Lengths<Surface>*>(erasedLengths.get());
+  lengths->owner = this;
 }
 
 template <typename Surface>
-std::unordered_set<HalfEdge> ImplementationOf<IntervalExchangeTransformation<Surface>>::makeUniqueLargeEdge(Surface& surface, const Vector<T>& vertical_, HalfEdge& unique_) {
-  Tracked<HalfEdge> unique(surface, HalfEdge(unique_));
+const ImplementationOf<IntervalExchangeTransformation<Surface>>& ImplementationOf<IntervalExchangeTransformation<Surface>>::self(const IntervalExchangeTransformation<Surface>& iet) {
+  return *iet.self;
+}
 
-  Vertical<Surface> vertical(surface, vertical_);
+template <typename Surface>
+std::pair<vector<HalfEdge>, vector<HalfEdge>> ImplementationOf<IntervalExchangeTransformation<Surface>>::contours(const Vertical<Surface>& vertical, const Vertical<Surface>& negated, HalfEdge large) {
+  vector<HalfEdge> top, bottom;
+
+  ImplementationOf<ContourComponent<Surface>>::makeContour(back_inserter(top), large, vertical.surface(), vertical);
+
+  ImplementationOf<ContourComponent<Surface>>::makeContour(back_inserter(bottom), -large, vertical.surface(), negated);
+  reverse(bottom.begin(), bottom.end());
+  std::transform(bottom.begin(), bottom.end(), bottom.begin(), [](HalfEdge e) { return -e; });
+
+  return {std::move(top), std::move(bottom)};
+}
+
+template <typename Surface>
+HalfEdgeSet ImplementationOf<IntervalExchangeTransformation<Surface>>::makeUniqueLargeEdge(Surface& surface, const Vertical<Surface>& vertical, HalfEdge& unique_) {
+  Tracked<HalfEdge> unique(surface, HalfEdge(unique_));
 
   ASSERT_ARGUMENT(vertical.large(unique), "edge must already be large");
   if (vertical.ccw(unique) == CCW::COUNTERCLOCKWISE)
@@ -213,7 +222,7 @@ std::unordered_set<HalfEdge> ImplementationOf<IntervalExchangeTransformation<Sur
   // edge in its component. Whenever a flip needs to be performed, the process
   // restarts.
   while (true) {
-    std::unordered_set<HalfEdge> component;
+    HalfEdgeSet component;
     if (ImplementationOf<Vertical<Surface>>::visit(vertical, unique, component, [&](HalfEdge e) {
           if (e == static_cast<HalfEdge>(unique) || e == -static_cast<HalfEdge>(unique))
             return true;
@@ -0,0 +1,149 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/isomorphism_classes.hpp"
+
+#include <algorithm>
+#include <map>
+#include <ostream>
+
+#include "../flatsurf/delaunay.hpp"
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/executor.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/vector.hpp"
+#include "../flatsurf/vertex.hpp"
+#include "impl/isomorphism_classes.impl.hpp"
+#include "util/work_stealing.ipp"
+
+namespace flatsurf {
+
+template <typename Surface>
+IsomorphismClasses<Surface>::IsomorphismClasses(ISOMORPHISM kind, MATRICES matrices, std::function<bool(const T &, const T &, const T &, const T &)> filter, unsigned int threads) :
+  self(spimpl::make_unique_impl<ImplementationOf<IsomorphismClasses>>(kind, matrices, std::move(filter), threads)) {}
+
+template <typename Surface>
+std::vector<std::vector<size_t>> IsomorphismClasses<Surface>::operator()(const std::vector<Surface> &surfaces) const {
+  unsigned int threads = self->threads;
+  if (threads == 0)
+    threads = Executor::global().concurrency();
+
+  // Run work(i) for all 0 ≤ i < size, in parallel if requested.
+  const auto parallel = [&](size_t size, const auto &work) {
+    if (threads == 1 || size < 2) {
+      for (size_t i = 0; i < size; i++)
+        work(i);
+    } else {
+      WorkStealing<size_t> pool(std::min<size_t>(threads, size));
+      for (size_t i = 0; i < size; i++)
+        pool.push(i, i);
+      pool.run([&](size_t, size_t i) { work(i); });
+    }
+  };
+
+  // Sort the surfaces into buckets by their invariants.
+  std::vector<typename ImplementationOf<IsomorphismClasses>::Invariant> invariants(surfaces.size());
+  parallel(surfaces.size(), [&](size_t i) { invariants[i] = self->invariant(surfaces[i]); });
+
+  std::map<typename ImplementationOf<IsomorphismClasses>::Invariant, std::vector<size_t>> buckets;
+  for (size_t i = 0; i < surfaces.size(); i++)
+    buckets[std::move(invariants[i])].push_back(i);
+
+  std::vector<const std::vector<size_t> *> bucketed;
+  for (const auto &bucket : buckets)
+    bucketed.push_back(&bucket.second);
+
+  // Split each bucket into isomorphism classes by comparing each surface to
+  // a representative of each class found so far. Since every surface is in
+  // exactly one bucket, the buckets can be processed independently.
+  std::vector<std::vector<std::vector<size_t>>> split(bucketed.size());
+  parallel(bucketed.size(), [&](size_t b) {
+    auto &classes = split[b];
+    for (const size_t i : *bucketed[b]) {
+      const auto isomorphic = std::find_if(begin(classes), end(classes), [&](const auto &c) {
+        return static_cast<bool>(surfaces[c[0]].isomorphism(surfaces[i], self->kind, self->filter));
+      });
+      if (isomorphic == end(classes))
+        classes.push_back({i});
+      else
+        isomorphic->push_back(i);
+    }
+  });
+
+  std::vector<std::vector<size_t>> classes;
+  for (auto &bucket : split)
+    for (auto &c : bucket)
+      classes.push_back(std::move(c));
+
+  std::sort(begin(classes), end(classes), [](const auto &lhs, const auto &rhs) { return lhs[0] < rhs[0]; });
+
+  return classes;
+}
+
+template <typename Surface>
+ImplementationOf<IsomorphismClasses<Surface>>::ImplementationOf(ISOMORPHISM kind, MATRICES matrices, std::function<bool(const T &, const T &, const T &, const T &)> filter, unsigned int threads) :
+  kind(kind),
+  matrices(matrices),
+  filter(std::move(filter)),
+  threads(threads) {}
+
+template <typename Surface>
+typename ImplementationOf<IsomorphismClasses<Surface>>::Invariant ImplementationOf<IsomorphismClasses<Surface>>::invariant(const Surface &surface) const {
+  std::vector<int> angles;
+  for (const auto &vertex : surface.vertices())
+    angles.push_back(surface.angle(vertex));
+  std::sort(begin(angles), end(angles));
+
+  std::optional<T> area;
+  if (matrices != MATRICES::GENERIC)
+    area = surface.area();
+
+  std::vector<T> lengths;
+  if (matrices == MATRICES::ISOMETRIES) {
+    for (const auto edge : surface.edges()) {
+      if (kind == ISOMORPHISM::DELAUNAY_CELLS && surface.delaunay(edge) == DELAUNAY::AMBIGUOUS)
+        continue;
+      const auto &v = surface.fromHalfEdge(edge.positive());
+      lengths.push_back(v * v);
+    }
+    std::sort(begin(lengths), end(lengths));
+  }
+
+  return Invariant{surface.canonicalHash(kind), std::move(angles), std::move(area), std::move(lengths)};
+}
+
+template <typename Surface>
+std::ostream &operator<<(std::ostream &os, const IsomorphismClasses<Surface> &self) {
+  os << "Isomorphism classes of " << (self.self->kind == ISOMORPHISM::FACES ? "triangulated surfaces" : "Delaunay decompositions");
+  switch (self.self->matrices) {
+    case IsomorphismClasses<Surface>::MATRICES::GENERIC:
+      return os;
+    case IsomorphismClasses<Surface>::MATRICES::AREA_PRESERVING:
+      return os << " up to area preserving maps";
+    default:
+      return os << " up to isometries";
+  }
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), IsomorphismClasses, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
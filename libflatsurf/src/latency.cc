@@ -0,0 +1,102 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/latency.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+#include "../flatsurf/decomposition_budget.hpp"
+#include "impl/decomposition_budget.impl.hpp"
+#include "impl/latency.impl.hpp"
+
+namespace flatsurf {
+
+namespace {
+
+// Guards the latency returned by Latency::global().
+std::mutex globalLock;
+
+Latency& globalLatency() {
+  static Latency latency;
+  return latency;
+}
+
+}  // namespace
+
+Latency::Latency() :
+  Latency(std::nullopt) {}
+
+Latency::Latency(std::optional<Clock::duration> budget, std::function<void(const Progress&)> progress) :
+  self(std::make_shared<ImplementationOf<Latency>>(budget, std::move(progress))) {}
+
+Latency Latency::global() {
+  std::lock_guard<std::mutex> guard(globalLock);
+  return globalLatency();
+}
+
+void Latency::global(Latency latency) {
+  std::lock_guard<std::mutex> guard(globalLock);
+  globalLatency() = std::move(latency);
+}
+
+std::optional<Latency::Clock::duration> Latency::budget() const {
+  return self->budget;
+}
+
+DecompositionBudget Latency::decomposition(int limit) const {
+  if (!self->budget && !self->progress)
+    return ImplementationOf<DecompositionBudget>::make(limit);
+
+  DecompositionBudget budget(std::nullopt, self->budget, limit);
+
+  if (self->progress) {
+    // The steps are counted here rather than with budget.consumed() since
+    // the callback must not hold on to the budget that owns it.
+    budget.trace([progress = self->progress, steps = std::make_shared<std::atomic<size_t>>(0)](const DecompositionBudget::Step&) {
+      progress(Progress{"FlowDecomposition::decompose", ++*steps});
+    });
+  }
+
+  return budget;
+}
+
+void Latency::report(const char* operation, size_t completed) const {
+  if (self->progress)
+    self->progress(Progress{operation, completed});
+}
+
+ImplementationOf<Latency>::ImplementationOf(std::optional<Latency::Clock::duration> budget, std::function<void(const Latency::Progress&)> progress) :
+  budget(budget),
+  progress(std::move(progress)) {}
+
+std::ostream& operator<<(std::ostream& os, const Latency& self) {
+  os << "Latency(";
+  if (self.budget())
+    os << std::chrono::duration_cast<std::chrono::milliseconds>(*self.budget()).count() << "ms";
+  else
+    os << "unlimited";
+  if (self.self->progress)
+    os << " with progress";
+  return os << ")";
+}
+
+}  // namespace flatsurf
@@ -22,6 +22,11 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <arb.h>
+#include <arf.h>
+#include <flint/fmpz.h>
+
+#include <exact-real/arb.hpp>
 #include <exact-real/element.hpp>
 #include <exact-real/integer_ring.hpp>
 #include <exact-real/module.hpp>
@@ -41,6 +46,7 @@
 #include <intervalxt/sample/mpz_floor_division.hpp>
 #include <intervalxt/sample/renf_elem_coefficients.hpp>
 #include <intervalxt/sample/renf_elem_floor_division.hpp>
+#include <mutex>
 #include <ostream>
 
 #include "../flatsurf/ccw.hpp"
@@ -52,6 +58,8 @@
 #include "impl/assert_connection.hpp"
 #include "impl/flow_component.impl.hpp"
 #include "impl/flow_connection.impl.hpp"
+#include "impl/flow_decomposition_state.hpp"
+#include "impl/interval_exchange_transformation.impl.hpp"
 #include "impl/saddle_connection.impl.hpp"
 #include "util/assert.ipp"
 #include "util/false.ipp"
@@ -63,12 +71,51 @@ using intervalxt::Label;
 using intervalxt::Length;
 using rx::none_of;
 
+namespace {
+
+template <typename T>
+constexpr bool IsExactReal = false;
+
+template <typename Ring>
+constexpr bool IsExactReal<exactreal::Element<Ring>> = true;
+
+}  // namespace
+
+template <typename Surface>
+class Lengths<Surface>::Stopwatch {
+  using Clock = DecompositionBudget::Clock;
+
+ public:
+  explicit Stopwatch(const Lengths& lengths) :
+    lengths(lengths),
+    running(lengths.tracing && !lengths.timing) {
+    if (running) {
+      lengths.timing = true;
+      start = Clock::now();
+    }
+  }
+
+  ~Stopwatch() {
+    if (running) {
+      lengths.elapsed += Clock::now() - start;
+      lengths.timing = false;
+    }
+  }
+
+ private:
+  const Lengths& lengths;
+  const bool running;
+  Clock::time_point start;
+};
+
 template <typename Surface>
 Lengths<Surface>::Lengths(const Vertical<FlatTriangulation<T>>& vertical, EdgeMap<std::optional<SaddleConnection<FlatTriangulation<T>>>>&& lengths) :
   vertical(vertical),
   lengths(std::move(lengths)),
+  enclosures(vertical.surface().edges().size()),
+  coefficientRows(vertical.surface().edges().size()),
   stack(),
-  sum() {
+  sum(T()) {
   this->lengths.apply([&](const auto& edge, const auto& connection) {
     CHECK_ARGUMENT(!connection || vertical.ccw(*connection) == CCW::CLOCKWISE, "nontrivial length must be positive but " << edge << " is " << *connection);
   });
@@ -78,23 +125,40 @@ template <typename Surface>
 void Lengths<Surface>::push(Label label) {
   ASSERT(stack | none_of([&](const auto& l) { return l == label; }), "must not push the same label twice");
   stack.push_back(label);
-  sum += length(label);
+  sum += enclosure(label);
 }
 
 template <typename Surface>
 void Lengths<Surface>::pop() {
   ASSERT(not stack.empty(), "cannot pop from an empty stack");
-  sum -= length(stack.back());
+  sum -= enclosure(stack.back());
   stack.pop_back();
-  ASSERT(!stack.empty() || sum == T(), "sum inconsistent with stack");
+  ASSERT(!stack.empty() || !sum.sgn(), "sum inconsistent with stack");
+}
+
+template <typename Surface>
+void Lengths<Surface>::compact() {
+  ASSERT(stack.empty(), "cannot compact lengths during an induction step");
+
+  for (auto& enclosure : enclosures)
+    enclosure.reset();
+  for (auto& row : coefficientRows)
+    row.reset();
+  stack.shrink_to_fit();
 }
 
 template <typename Surface>
 FlowComponentState<FlatTriangulation<typename Surface::Coordinate>>& Lengths<Surface>::component(Label label) const {
-  const auto component = std::find_if(begin(state.lock()->components), end(state.lock()->components), [&](const auto& component) {
+  const auto state = this->state.lock();
+
+  std::lock_guard<std::mutex> guard(state->lock);
+
+  const auto component = std::find_if(begin(state->components), end(state->components), [&](const auto& component) {
+    if (owner != nullptr && &ImplementationOf<IntervalExchangeTransformation<FlatTriangulationCollapsed<T>>>::self(*component.iet) != owner)
+      return false;
     return static_cast<::intervalxt::Label>(*begin(component.dynamicalComponent.topContour())) == label || static_cast<::intervalxt::Label>(*begin(component.dynamicalComponent.bottomContour())) == label;
   });
-  ASSERT(component != end(state.lock()->components), "Label nowhere in flow decomposition contour.")
+  ASSERT(component != end(state->components), "Label nowhere in flow decomposition contour.")
   return *component;
 }
 
@@ -108,11 +172,13 @@ bool Lengths<Surface>::minuendOnTop(Label minuend) const {
 
 template <typename Surface>
 void Lengths<Surface>::subtract(Label minuend) {
+  const Stopwatch stopwatch(*this);
   subtractRepeated(minuend, 1);
 }
 
 template <typename Surface>
 Label Lengths<Surface>::subtractRepeated(Label minuend) {
+  const Stopwatch stopwatch(*this);
   const auto& component = this->component(minuend);
   const bool minuendOnTop = this->minuendOnTop(minuend);
   const auto subtrahendContour = minuendOnTop ? component.dynamicalComponent.bottomContour() : component.dynamicalComponent.topContour();
@@ -124,10 +190,18 @@ Label Lengths<Surface>::subtractRepeated(Label minuend) {
 
   auto ret = stack.back();
   if (stableCombinatorics) {
-    const auto quotient = ::intervalxt::sample::FloorDivision<T>()(length(minuend), length());
-    mpz_class iterations = gmpxxll::mpz_class(quotient);
-    if (quotient * length() == length(minuend))
-      iterations -= 1;
+    mpz_class iterations = [&]() {
+      // The number of full subtractions, i.e., the floor of the quotient
+      // unless the quotient is an integer.
+      if (auto estimate = fullSubtractions(minuend))
+        return *estimate;
+
+      const auto quotient = ::intervalxt::sample::FloorDivision<T>()(length(minuend), length());
+      mpz_class iterations = gmpxxll::mpz_class(quotient);
+      if (quotient * length() == length(minuend))
+        iterations -= 1;
+      return iterations;
+    }();
     ASSERT(iterations > mpz_class(), "subtractRepeated() should not be called when there is no full subtract possible; but the labels on the stack fit only " << iterations << " times into the minuend label " << render(minuend) << "; the code cannot handle partial subtracts yet.");
     subtractRepeated(minuend, iterations);
   } else {
@@ -137,19 +211,64 @@ Label Lengths<Surface>::subtractRepeated(Label minuend) {
   return ret;
 }
 
+template <typename Surface>
+std::optional<mpz_class> Lengths<Surface>::fullSubtractions(Label minuend) const {
+  if constexpr (std::is_same_v<T, long long> || std::is_same_v<T, mpz_class> || std::is_same_v<T, mpq_class>) {
+    // Exact floor division is cheap for these.
+    return std::nullopt;
+  } else {
+    exactreal::Arb quotient;
+    arb_div(quotient.arb_t(), enclosure(minuend).arb().arb_t(), sum.arb().arb_t(), exactreal::ARB_PRECISION_FAST);
+
+    arf_t bound;
+    arf_init(bound);
+    fmpz_t lower, upper;
+    fmpz_init(lower);
+    fmpz_init(upper);
+
+    arb_get_lbound_arf(bound, quotient.arb_t(), exactreal::ARB_PRECISION_FAST);
+    // If the lower bound is an integer, the quotient might be that integer
+    // in which case we cannot subtract that often.
+    const bool integral = arf_is_int(bound);
+    arf_get_fmpz(lower, bound, ARF_RND_FLOOR);
+    arb_get_ubound_arf(bound, quotient.arb_t(), exactreal::ARB_PRECISION_FAST);
+    arf_get_fmpz(upper, bound, ARF_RND_FLOOR);
+
+    std::optional<mpz_class> iterations;
+    if (!integral && fmpz_equal(lower, upper) && arb_is_finite(quotient.arb_t())) {
+      iterations = mpz_class();
+      fmpz_get_mpz(iterations->get_mpz_t(), lower);
+    }
+
+    fmpz_clear(upper);
+    fmpz_clear(lower);
+    arf_clear(bound);
+
+    ASSERT(!iterations || (*iterations * length() < length(minuend) && mpz_class(*iterations + 1) * length() > length(minuend)), "ball arithmetic claimed that " << render(minuend) << " contains the stack " << *iterations << " times but that is not the case");
+
+    return iterations;
+  }
+}
+
 template <typename Surface>
 void Lengths<Surface>::subtractRepeated(Label minuend, const mpz_class& iterations) {
+  const Stopwatch stopwatch(*this);
+  if (tracing)
+    inductions++;
+
   ASSERT(iterations > 0, "must subtract at least once");
   ASSERT(length(minuend) > 0, "lengths must be positive");
 
+  // The expected length after the subtraction; only computed when checking
+  // assertions since it is exact arithmetic that we do not need otherwise.
   const auto expected = [&]() -> T {
     if constexpr (std::is_same_v<T, long long>)
       return length(minuend) - iterations.get_ui() * length();
     else
       return length(minuend) - iterations * length();
-  }();
-  ASSERT(expected > 0, "Lengths must be positive but subtracting " << length() << " " << iterations << " times from edge " << fromLabel(minuend) << " of length " << length(minuend) << " would yield " << expected << " which is non-positive.");
-  ASSERT(expected < length(minuend), "subtraction must shorten lengths");
+  };
+  ASSERT(expected() > 0, "Lengths must be positive but subtracting " << length() << " " << iterations << " times from edge " << fromLabel(minuend) << " of length " << length(minuend) << " would yield " << expected() << " which is non-positive.");
+  ASSERT(expected() < length(minuend), "subtraction must shorten lengths");
 
   auto& component = this->component(minuend);
 
@@ -242,11 +361,14 @@ void Lengths<Surface>::subtractRepeated(Label minuend, const mpz_class& iteratio
     }));
   }
 
+  enclosures[fromLabel(minuend).index()].reset();
+  coefficientRows[fromLabel(minuend).index()].reset();
+
   ASSERT(get(minuend), "lengths must be non-zero");
-  ASSERT(length(minuend) == expected, "subtract inconsistent: subtracted " << length() << " from " << fromLabel(minuend) << " which should have yielded " << expected << " but got " << length(minuend) << " instead");
+  ASSERT(length(minuend) == expected(), "subtract inconsistent: subtracted " << length() << " from " << fromLabel(minuend) << " which should have yielded " << expected() << " but got " << length(minuend) << " instead");
 
   stack.clear();
-  sum = T();
+  sum = Enclosure<T>(T());
 }
 
 template <typename Surface>
@@ -254,30 +376,61 @@ Lengths<Surface>::Lengths(const Lengths<Surface>& lengths, std::shared_ptr<FlowD
   state(state),
   vertical(lengths.vertical),
   lengths(lengths.lengths),
+  enclosures(lengths.enclosures),
+  coefficientRows(lengths.coefficientRows),
   stack(lengths.stack),
   sum(lengths.sum) {}
 
 template <typename Surface>
 std::vector<std::vector<mpq_class>> Lengths<Surface>::coefficients(const std::vector<Label>& labels) const {
-  return intervalxt::sample::Coefficients<T>()(labels | rx::transform([&](const Label& label) { return length(label); }) | rx::to_vector());
+  const Stopwatch stopwatch(*this);
+
+  const auto decompose = [&]() {
+    return intervalxt::sample::Coefficients<T>()(labels | rx::transform([&](const Label& label) { return length(label); }) | rx::to_vector());
+  };
+
+  if (labels.empty())
+    return decompose();
+
+  // The coefficients of a length do not depend on the other lengths as long
+  // as all of them are expressed in the same basis. Then, we copy the
+  // coefficients of each length from a cache instead of decomposing all the
+  // lengths again in each call during the induction.
+  if constexpr (IsExactReal<T>) {
+    const auto* module = length(labels[0]).module().get();
+    for (const auto& label : labels)
+      if (length(label).module().get() != module)
+        return decompose();
+  }
+
+  std::vector<std::vector<mpq_class>> coefficients;
+  coefficients.reserve(labels.size());
+  for (const auto& label : labels) {
+    auto& row = coefficientRows[fromLabel(label).index()];
+    if (!row)
+      row = std::move(intervalxt::sample::Coefficients<T>()({length(label)})[0]);
+    coefficients.push_back(*row);
+  }
+
+  // Coefficients might be trimmed, e.g., for rational elements of a number
+  // field, so the rows only form a matrix if they all have the same size.
+  for (const auto& row : coefficients)
+    if (row.size() != coefficients[0].size())
+      return decompose();
+
+  return coefficients;
 }
 
 template <typename Surface>
 int Lengths<Surface>::cmp(Label rhs) const {
-  if (length() < length(rhs))
-    return -1;
-  else if (length() > length(rhs))
-    return 1;
-  return 0;
+  const Stopwatch stopwatch(*this);
+  return sum.cmp(enclosure(rhs));
 }
 
 template <typename Surface>
 int Lengths<Surface>::cmp(Label lhs, Label rhs) const {
-  if (length(lhs) < length(rhs))
-    return -1;
-  else if (length(lhs) > length(rhs))
-    return 1;
-  return 0;
+  const Stopwatch stopwatch(*this);
+  return enclosure(lhs).cmp(enclosure(rhs));
 }
 
 template <typename Surface>
@@ -310,16 +463,27 @@ Edge Lengths<Surface>::fromLabel(Label l) const {
 }
 
 template <typename Surface>
-typename Surface::Coordinate Lengths<Surface>::length() const {
-  ASSERT(sum >= 0, "Length must not be negative");
+const typename Surface::Coordinate& Lengths<Surface>::length() const {
+  ASSERT(sum.sgn() >= 0, "Length must not be negative");
   return sum;
 }
 
 template <typename Surface>
-typename Surface::Coordinate Lengths<Surface>::length(intervalxt::Label label) const {
-  auto length = vertical->projectPerpendicular(*lengths[fromLabel(label)]);
-  ASSERT(length > 0, "length must be positive");
-  return length;
+const typename Surface::Coordinate& Lengths<Surface>::length(intervalxt::Label label) const {
+  return enclosure(label);
+}
+
+template <typename Surface>
+const Enclosure<typename Surface::Coordinate>& Lengths<Surface>::enclosure(intervalxt::Label label) const {
+  const Edge edge = fromLabel(label);
+  ASSERT(edge.index() < enclosures.size(), "no length cached for " << edge);
+
+  auto& length = enclosures[edge.index()];
+  if (!length) {
+    length = Enclosure<T>(vertical->projectPerpendicular(*lengths[edge]));
+    ASSERT(length->sgn() > 0, "length must be positive");
+  }
+  return *length;
 }
 
 template <typename Surface>
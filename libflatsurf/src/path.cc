@@ -22,17 +22,20 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <memory>
 #include <ostream>
 #include <unordered_set>
 
 #include "../flatsurf/ccw.hpp"
 #include "../flatsurf/chain.hpp"
+#include "../flatsurf/exact_fallbacks.hpp"
 #include "../flatsurf/fmt.hpp"
 #include "../flatsurf/path_iterator.hpp"
 #include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/vector.hpp"
 #include "../flatsurf/vertex.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
+#include "impl/exact_fallbacks.impl.hpp"
 #include "impl/path.impl.hpp"
 #include "impl/path_iterator.impl.hpp"
 #include "util/assert.ipp"
@@ -49,69 +52,81 @@ Path<Surface>::Path(const std::vector<Segment>& path) :
 
 template <typename Surface>
 Path<Surface>::operator const std::vector<Segment> &() const {
-  return self->path;
+  return *self->path;
 }
 
 template <typename Surface>
 bool Path<Surface>::operator==(const Path& rhs) const {
-  return self->path == rhs.self->path;
+  return self->path == rhs.self->path || *self->path == *rhs.self->path;
 }
 
 template <typename Surface>
 bool Path<Surface>::closed() const {
   if (empty()) return true;
-  return ImplementationOf<Path>::connected(*std::rbegin(self->path), *std::begin(self->path));
+  return ImplementationOf<Path>::connected(*std::rbegin(*self->path), *std::begin(*self->path));
 }
 
 template <typename Surface>
 bool Path<Surface>::simple() const {
   using std::begin, std::end;
-  std::unordered_set<Segment> segments(begin(self->path), end(self->path));
-  return segments.size() == self->path.size();
+  std::unordered_set<Segment> segments(begin(*self->path), end(*self->path));
+  return segments.size() == self->path->size();
 }
 
 template <typename Surface>
 Path<Surface> Path<Surface>::reversed() const {
-  return self->path | rx::transform([&](const auto& connection) { return -connection; }) | rx::reverse() | rx::to_vector();
+  return *self->path | rx::transform([&](const auto& connection) { return -connection; }) | rx::reverse() | rx::to_vector();
 }
 
 template <typename Surface>
 bool Path<Surface>::empty() const {
-  return self->path.empty();
+  return self->path->empty();
 }
 
 template <typename Surface>
 size_t Path<Surface>::size() const {
-  return self->path.size();
+  return self->path->size();
 }
 
 template <typename Surface>
 void Path<Surface>::push_front(const Segment& segment) {
   ASSERT(empty() || ImplementationOf<Path>::connected(segment, *begin()), "Path must be connected but " << segment << " does not precede " << *begin() << " either because they are connected to different vertices or because the turn from " << -segment << " to " << *begin() << " is not turning clockwise in the range (0, 2π]");
-  self->path.insert(std::begin(self->path), segment);
+  auto& path = self->mutate();
+  path.insert(std::begin(path), segment);
 }
 
 template <typename Surface>
 void Path<Surface>::push_back(const Segment& segment) {
-  ASSERT(empty() || ImplementationOf<Path>::connected(*self->path.rbegin(), segment), "Path must be connected but " << *self->path.rbegin() << " does not precede " << segment << " either because they are connected to different vertices or because the turn from " << -*self->path.rbegin() << " to " << segment << " is not turning clockwise in the range (0, 2π]");
-  self->path.push_back(segment);
+  ASSERT(empty() || ImplementationOf<Path>::connected(*self->path->rbegin(), segment), "Path must be connected but " << *self->path->rbegin() << " does not precede " << segment << " either because they are connected to different vertices or because the turn from " << -*self->path->rbegin() << " to " << segment << " is not turning clockwise in the range (0, 2π]");
+  self->mutate().push_back(segment);
 }
 
 template <typename Surface>
 void Path<Surface>::splice(const PathIterator<Surface>& pos, Path& other) {
   ASSERT_ARGUMENT(this != &other, "Cannot splice path into itself");
 
-  const auto at = pos == end() ? std::end(self->path) : pos.self->position;
-  self->path.insert(at, std::begin(other.self->path), std::end(other.self->path));
+  if (empty()) {
+    // Splicing into an empty path, we can take over the segments of other
+    // without copying them.
+    std::swap(self->path, other.self->path);
+    return;
+  }
+
+  // Note that pos might point into segments that are shared with another
+  // path, so we need to determine its offset before we copy them.
+  const auto at = pos == end() ? self->path->size() : static_cast<size_t>(pos.self->position - std::begin(*self->path));
+
+  auto& path = self->mutate();
+  path.insert(std::begin(path) + at, std::begin(*other.self->path), std::end(*other.self->path));
 
-  ASSERTIONS([&]() {
-    for (auto segment = std::begin(self->path); segment != std::end(self->path); segment++) {
-      ASSERT(segment + 1 == std::end(self->path) || ImplementationOf<Path>::connected(*segment, *(segment + 1)), "Path must be connected but " << *segment << " does not precede " << *(segment + 1) << " either because they are connected to different vertices or because the turn from " << -*segment << " to " << *(segment + 1) << " is not turning clockwise in the range (0, 2π]");
+  VALIDATE([&]() {
+    for (auto segment = std::begin(path); segment != std::end(path); segment++) {
+      CHECK(segment + 1 == std::end(path) || ImplementationOf<Path>::connected(*segment, *(segment + 1)), "Path must be connected but " << *segment << " does not precede " << *(segment + 1) << " either because they are connected to different vertices or because the turn from " << -*segment << " to " << *(segment + 1) << " is not turning clockwise in the range (0, 2π]");
     }
     return true;
   });
 
-  other.self->path.clear();
+  other.self->path = ImplementationOf<Path>::empty();
 }
 
 template <typename Surface>
@@ -128,31 +143,44 @@ typename Surface::Coordinate Path<Surface>::area() const {
 
 template <typename Surface>
 PathIterator<Surface> Path<Surface>::begin() const {
-  return PathIterator<Surface>(PrivateConstructor{}, this, std::begin(self->path));
+  return PathIterator<Surface>(PrivateConstructor{}, this, std::begin(*self->path));
 }
 
 template <typename Surface>
 PathIterator<Surface> Path<Surface>::end() const {
-  return PathIterator<Surface>(PrivateConstructor{}, this, std::end(self->path));
+  return PathIterator<Surface>(PrivateConstructor{}, this, std::end(*self->path));
 }
 
 template <typename Surface>
 std::ostream& operator<<(std::ostream& os, const Path<Surface>& path) {
-  return os << fmt::format("[{}]", fmt::join(path.self->path, " → "));
+  return os << fmt::format("[{}]", fmt::join(*path.self->path, " → "));
 }
 
 template <typename Surface>
 ImplementationOf<Path<Surface>>::ImplementationOf() :
-  path() {}
+  path(empty()) {}
 
 template <typename Surface>
-ImplementationOf<Path<Surface>>::ImplementationOf(const std::vector<Segment>& path) {
+ImplementationOf<Path<Surface>>::ImplementationOf(const std::vector<Segment>& path) :
+  path(std::make_shared<std::vector<Segment>>(path)) {
   for (auto segment = begin(path); segment != end(path); segment++) {
     ASSERT(segment + 1 == end(path) || connected(*segment, *(segment + 1)), "Path must be connected but " << *segment << " does not precede " << *(segment + 1) << " either because they are connected to different vertices or because the turn from " << -*segment << " to " << *(segment + 1) << " is not turning clockwise in the range (0, 2π]");
-    this->path.push_back(*segment);
   }
 }
 
+template <typename Surface>
+const std::shared_ptr<std::vector<SaddleConnection<Surface>>>& ImplementationOf<Path<Surface>>::empty() {
+  static const auto empty = std::make_shared<std::vector<Segment>>();
+  return empty;
+}
+
+template <typename Surface>
+std::vector<SaddleConnection<Surface>>& ImplementationOf<Path<Surface>>::mutate() {
+  if (path.use_count() > 1)
+    path = std::make_shared<std::vector<Segment>>(*path);
+  return *path;
+}
+
 template <typename Surface>
 bool ImplementationOf<Path<Surface>>::connected(const Segment& a, const Segment& to) {
   const auto& surface = a.surface();
@@ -162,9 +190,15 @@ bool ImplementationOf<Path<Surface>>::connected(const Segment& a, const Segment&
   const auto ccw = [](const Chain<Surface>& lhs, const Chain<Surface>& rhs) {
     // In typical flow decompositions, running ccw on approximations first
     // does not seem to help the runtime of this method:
+    static const size_t site = ImplementationOf<ExactFallbacks>::site("Path::connected");
+
     const auto approximate = static_cast<const Vector<exactreal::Arb>&>(lhs).ccw(static_cast<const Vector<exactreal::Arb>&>(rhs));
-    if (approximate)
+    if (approximate) {
+      ImplementationOf<ExactFallbacks>::decided(site);
       return *approximate;
+    }
+
+    const ImplementationOf<ExactFallbacks>::Fallback fallback(site);
     return static_cast<const Vector<T>&>(lhs).ccw(static_cast<const Vector<T>&>(rhs));
   };
 
@@ -31,8 +31,8 @@ void PathIterator<Surface>::increment() {
   ASSERT(!self->parent->empty(), "cannot increment iterator into empty path");
   ASSERT(!self->end, "cannot increment end() iterator")
   self->position++;
-  if (self->position == end(self->parent->self->path)) {
-    self->position = begin(self->parent->self->path);
+  if (self->position == end(*self->parent->self->path)) {
+    self->position = begin(*self->parent->self->path);
     self->turn++;
   }
 }
@@ -41,7 +41,7 @@ template <typename Surface>
 const SaddleConnection<Surface>& PathIterator<Surface>::dereference() const {
   ASSERT(!self->parent->empty(), "cannot dereference iterator into empty path");
   ASSERT(!self->end, "cannot dereference end() iterator");
-  ASSERT(self->position != end(self->parent->self->path), "iterator in impossible end state");
+  ASSERT(self->position != end(*self->parent->self->path), "iterator in impossible end state");
   return *self->position;
 }
 
@@ -65,9 +65,9 @@ template <typename Surface>
 ImplementationOf<PathIterator<Surface>>::ImplementationOf(const Path<Surface>* parent, const Position& position) :
   parent(parent),
   position(position) {
-  if (position == std::end(parent->self->path)) {
+  if (position == std::end(*parent->self->path)) {
     this->end = true;
-    this->position = begin(parent->self->path);
+    this->position = begin(*parent->self->path);
   }
 }
 }  // namespace flatsurf
@@ -19,6 +19,7 @@
 
 #include "../flatsurf/permutation.hpp"
 
+#include <algorithm>
 #include <boost/range/numeric.hpp>
 #include <cassert>
 #include <ostream>
@@ -38,6 +39,25 @@ namespace {
 template <typename T>
 size_t index(const T &t) { return t.index(); }
 
+// Return whether cycle consists of a single element (possibly repeated.)
+template <typename T>
+bool trivial(const vector<T> &cycle) {
+  return std::all_of(begin(cycle), end(cycle), [&](const auto &t) { return t == cycle[0]; });
+}
+
+// Return whether the entries of cycle are distinct. The cycles we multiply
+// with are typically very short, so we avoid the allocation of a hash set.
+template <typename T>
+bool distinct(const vector<T> &cycle) {
+  if (cycle.size() > 16)
+    return std::unordered_set<T>(cycle.begin(), cycle.end()).size() == cycle.size();
+  for (size_t i = 0; i < cycle.size(); i++)
+    for (size_t j = i + 1; j < cycle.size(); j++)
+      if (cycle[i] == cycle[j])
+        return false;
+  return true;
+}
+
 template <typename T>
 void check(const Permutation<T> &permutation) {
   vector<int> hits(permutation.size());
@@ -75,7 +95,7 @@ template <typename T>
 Permutation<T>::Permutation(const vector<vector<T>> &cycles) :
   Permutation([&]() {
     vector<T> data(accumulate(cycles, 0u, [](size_t sum, const auto &cycle) { return sum + cycle.size(); }));
-    for (const auto cycle : cycles) {
+    for (const auto &cycle : cycles) {
       for (auto i = 0u; i < cycle.size(); i++) {
         ASSERT_ARGUMENT(index(cycle[i]) < data.size(), "cycle contains an element beyond the size of the permutation");
         data[index(cycle[i])] = cycle[(i + 1) % cycle.size()];
@@ -84,6 +104,23 @@ Permutation<T>::Permutation(const vector<vector<T>> &cycles) :
     return data;
   }()) {}
 
+template <typename T>
+Permutation<T>::Permutation(const vector<T> &elements, const vector<size_t> &offsets) :
+  Permutation([&]() {
+    ASSERT_ARGUMENT(offsets.size() && offsets.front() == 0 && offsets.back() == elements.size(), "offsets must delimit the cycles in elements");
+    vector<T> data(elements.size());
+    for (size_t c = 0; c + 1 < offsets.size(); c++) {
+      const size_t begin = offsets[c];
+      const size_t end = offsets[c + 1];
+      ASSERT_ARGUMENT(begin < end, "cycles must not be empty");
+      for (size_t i = begin; i < end; i++) {
+        ASSERT_ARGUMENT(index(elements[i]) < data.size(), "cycle contains an element beyond the size of the permutation");
+        data[index(elements[i])] = elements[i + 1 == end ? begin : i + 1];
+      }
+    }
+    return data;
+  }()) {}
+
 template <typename T>
 Permutation<T>::Permutation(const vector<pair<T, T>> &permutation) :
   Permutation([&]() {
@@ -140,36 +177,55 @@ const vector<T> &Permutation<T>::domain() const {
 
 template <typename T>
 vector<vector<T>> Permutation<T>::cycles() const {
-  std::unordered_set<T> seen;
+  vector<T> elements;
+  vector<size_t> offsets;
+  cycles(elements, offsets);
+
   vector<vector<T>> cycles;
+  cycles.reserve(offsets.size() - 1);
+  for (size_t i = 0; i + 1 < offsets.size(); i++)
+    cycles.emplace_back(begin(elements) + offsets[i], begin(elements) + offsets[i + 1]);
+
+  return cycles;
+}
+
+template <typename T>
+void Permutation<T>::cycles(vector<T> &elements, vector<size_t> &offsets) const {
+  elements.clear();
+  elements.reserve(size());
+  offsets.clear();
+  offsets.push_back(0);
+
+  vector<bool> seen(size());
   for (const auto &t : domain()) {
-    if (seen.find(t) != seen.end())
+    if (seen[index(t)])
       continue;
 
-    vector<T> cycle;
     auto s = t;
     do {
-      cycle.push_back(s);
-      seen.insert(s);
-      s = this->operator()(s);
+      elements.push_back(s);
+      seen[index(s)] = true;
+      s = permutation[index(s)];
     } while (s != t);
 
-    cycles.push_back(cycle);
+    offsets.push_back(elements.size());
   }
-
-  return cycles;
 }
 
 template <typename T>
 void Permutation<T>::drop(const vector<T> &items) {
+  // Since the items have maximal indices, dropping them only requires to
+  // shrink the underlying vectors; nothing needs to be renumbered.
+  const size_t remaining = permutation.size() - items.size();
+
   for (auto &item : items)
-    CHECK_ARGUMENT(std::find(begin(items), end(items), this->operator()(item)) != end(items), "items to remove must be in isolated cycles");
+    CHECK_ARGUMENT(index(item) >= remaining, "items to remove must have maximal index");
 
   for (auto &item : items)
-    CHECK_ARGUMENT(index(item) >= permutation.size() - items.size(), "items to remove must have maximal index");
+    CHECK_ARGUMENT(index(this->operator()(item)) >= remaining, "items to remove must be in isolated cycles");
 
-  permutation.resize(permutation.size() - items.size());
-  inverse.resize(inverse.size() - items.size());
+  permutation.resize(remaining);
+  inverse.resize(remaining);
 }
 
 template <typename T>
@@ -181,10 +237,21 @@ template <typename T>
 Permutation<T> &Permutation<T>::operator*=(const Permutation<T> &rhs) {
   CHECK_ARGUMENT(size() == rhs.size(), "permutations must have the same domain");
 
-  vector<T> permutation(rhs.permutation);
-  for (auto it = permutation.begin(); it != permutation.end(); it++)
-    *it = (*this)(*it);
-  return *this = Permutation<T>(permutation);
+  // The composition of two permutations is a permutation, so we can skip the
+  // checks in the constructor and compute the inverse directly as the
+  // composition of the inverses.
+  vector<T> composed(rhs.permutation);
+  for (auto &t : composed)
+    t = permutation[index(t)];
+
+  vector<T> inverted(inverse);
+  for (auto &t : inverted)
+    t = rhs.inverse[index(t)];
+
+  permutation = std::move(composed);
+  inverse = std::move(inverted);
+
+  return *this;
 }
 
 template <typename T>
@@ -210,9 +277,9 @@ std::vector<T> Permutation<T>::cycle(const T &first) const {
 
 template <typename T>
 Permutation<T> &operator*=(const vector<T> &cycle, Permutation<T> &self) {
-  if (std::unordered_set<T>(cycle.begin(), cycle.end()).size() <= 1) return self;
+  if (trivial(cycle)) return self;
 
-  CHECK_ARGUMENT(std::unordered_set<T>(cycle.begin(), cycle.end()).size() == cycle.size(), "cycle must consist of distinct entries");
+  CHECK_ARGUMENT(distinct(cycle), "cycle must consist of distinct entries");
 
   T tmp = self.preimage(cycle[0]);
   for (auto it = cycle.begin(); it != cycle.end() - 1; it++) {
@@ -227,9 +294,9 @@ Permutation<T> &operator*=(const vector<T> &cycle, Permutation<T> &self) {
 
 template <typename T>
 Permutation<T> &operator*=(Permutation<T> &self, const vector<T> &cycle) {
-  if (std::unordered_set<T>(cycle.begin(), cycle.end()).size() <= 1) return self;
+  if (trivial(cycle)) return self;
 
-  CHECK_ARGUMENT(std::unordered_set<T>(cycle.begin(), cycle.end()).size() == cycle.size(), "cycle must consist of distinct entries");
+  CHECK_ARGUMENT(distinct(cycle), "cycle must consist of distinct entries");
 
   T tmp = self(cycle[0]);
   for (auto it = cycle.begin(); it != cycle.end() - 1; it++) {
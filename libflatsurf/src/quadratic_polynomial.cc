@@ -23,6 +23,7 @@
 
 #include "impl/approximation.hpp"
 #include "util/assert.ipp"
+#include "util/scratch.ipp"
 
 namespace flatsurf {
 
@@ -34,6 +35,23 @@ QuadraticPolynomial<T>::QuadraticPolynomial(const T& a, const T& b, const T& c)
 
 template <typename T>
 std::optional<exactreal::Arb> QuadraticPolynomial<T>::root(const long prec) const {
+  if (rootPrecision >= prec)
+    return rootApproximation;
+
+  auto approximation = approximateRoot(prec);
+
+  // Note that approximateRoot() might have already cached a more precise
+  // approximation.
+  if (rootPrecision < prec) {
+    rootPrecision = prec;
+    rootApproximation = approximation;
+  }
+
+  return approximation;
+}
+
+template <typename T>
+std::optional<exactreal::Arb> QuadraticPolynomial<T>::approximateRoot(const long prec) const {
   const auto validate = [&](const exactreal::Arb& solution) -> std::optional<exactreal::Arb> {
     auto lt0 = solution < 0;
     auto gt1 = solution > 1;
@@ -70,10 +88,24 @@ std::optional<exactreal::Arb> QuadraticPolynomial<T>::root(const long prec) cons
     return validate(solution);
   }
 
-  const T discriminant = b * b - 4 * a * c;
-  if (discriminant < 0) {
+  if (!discriminant) {
+    // The discriminant lives in registers of this thread that are reused
+    // across calls so that we do not allocate temporaries for every root.
+    Scratch<T, 2> scratch;
+    T& value = scratch[0];
+    T& product = scratch[1];
+    value = b;
+    value *= b;
+    product = 4 * a;
+    product *= c;
+    value -= product;
+
+    discriminant = value < 0 ? -1 : value == 0 ? 0 : 1;
+  }
+
+  if (*discriminant < 0) {
     return std::nullopt;
-  } else if (discriminant == 0) {
+  } else if (*discriminant == 0) {
     return validate((-b_ / (2 * a_))(prec));
   } else {
     exactreal::Arb sqrt_discriminant = (b_ * b_ - 4 * a_ * c_)(prec);
@@ -98,8 +130,36 @@ std::optional<exactreal::Arb> QuadraticPolynomial<T>::root(const long prec) cons
 
 template <typename T>
 bool QuadraticPolynomial<T>::operator<(const QuadraticPolynomial<T>& rhs) const {
+  // The products of coefficients live in registers of this thread that are
+  // reused across calls so that we do not allocate a temporary for each of
+  // them.
+  Scratch<T, 2> scratch;
+  T& accumulator = scratch[0];
+  T& product = scratch[1];
+
+  // Return whether p*q == r*s.
+  const auto equalProducts = [&](const T& p, const T& q, const T& r, const T& s) {
+    accumulator = p;
+    accumulator *= q;
+    product = r;
+    product *= s;
+    return accumulator == product;
+  };
+
+  // Add sgn * p*q*r*s to the accumulator.
+  const auto addProduct = [&](int sgn, const T& p, const T& q, const T& r, const T& s) {
+    product = p;
+    product *= q;
+    product *= r;
+    product *= s;
+    for (; sgn > 0; sgn--)
+      accumulator += product;
+    for (; sgn < 0; sgn++)
+      accumulator -= product;
+  };
+
   // When the two polynomials are just multiples of each other, the critical time is the same.
-  if (a * rhs.b == b * rhs.a && a * rhs.c == c * rhs.a && b * rhs.c == c * rhs.b)
+  if (equalProducts(a, rhs.b, b, rhs.a) && equalProducts(a, rhs.c, c, rhs.a) && equalProducts(b, rhs.c, c, rhs.b))
     return false;
 
   // Compute approximate values for the respective critical times t and compare them.
@@ -121,27 +181,69 @@ bool QuadraticPolynomial<T>::operator<(const QuadraticPolynomial<T>& rhs) const
     // If both polynomials are only linear, then we decide whether they
     // have the same root by comparing coefficients: namely if c/b = c'/b'.
     if (!a && !rhs.a) {
-      if (c * rhs.b == rhs.c * b)
+      if (equalProducts(c, rhs.b, rhs.c, b))
         return false;
       continue;
     }
 
     // In the non-linear case, they have a common root iff their
     // resultant is zero.
-    if (c * c * rhs.a * rhs.a - b * c * rhs.a * rhs.b + a * c * rhs.b * rhs.b + b * b * rhs.a * rhs.c - 2 * a * c * rhs.a * rhs.c - a * b * rhs.b * rhs.c + a * a * rhs.c * rhs.c != 0)
+    accumulator = T();
+    addProduct(1, c, c, rhs.a, rhs.a);
+    addProduct(-1, b, c, rhs.a, rhs.b);
+    addProduct(1, a, c, rhs.b, rhs.b);
+    addProduct(1, b, b, rhs.a, rhs.c);
+    addProduct(-2, a, c, rhs.a, rhs.c);
+    addProduct(-1, a, b, rhs.b, rhs.c);
+    addProduct(1, a, a, rhs.c, rhs.c);
+    if (accumulator != 0)
       continue;
 
     // When they have a common root, it does not necessarily have to be the
-    // root we care about.
-    // We already know that not both of their roots can be the same since
-    // then the polynomials would be multiples of each other which we
-    // checked before. We could now probably compute the gcd of the
-    // polynomials and then look at the common linear factor but for all
-    // cases that we can imagine it is probably safe to assume that the
-    // root that is the same is actually the root that also looks like it's
-    // approximately the same, i.e., the two critical times are equal.
+    // root we care about. Since the polynomials are not multiples of each
+    // other, this common root is the root of the linear polynomial
+    // rhs.a * this - a * rhs, i.e., -n/d.
+    const T d = rhs.a * b - a * rhs.b;
+    const T n = rhs.a * c - a * rhs.c;
+
+    if (d == 0) {
+      // This cannot happen unless one of the polynomials is zero.
+      return false;
+    }
+
+    if (first(n, d) && rhs.first(n, d))
+      return false;
+
+    // The roots we care about are different, so we are eventually going to
+    // separate them.
+  }
+}
+
+template <typename T>
+bool QuadraticPolynomial<T>::first(const T& n, const T& d) const {
+  // The root is t = p/q with q > 0.
+  T p = -n;
+  T q = d;
+  if (q < 0) {
+    p = -p;
+    q = -q;
+  }
+
+  if (p < 0 || p > q)
     return false;
+
+  if (a == 0)
+    return true;
+
+  // The other root is -b/a - t = p2/q2 with q2 > 0.
+  T p2 = -b * q - a * p;
+  T q2 = a * q;
+  if (q2 < 0) {
+    p2 = -p2;
+    q2 = -q2;
   }
+
+  return p2 < 0 || p2 * q >= p * q2;
 }
 
 template <typename T>
@@ -184,4 +286,4 @@ std::ostream& operator<<(std::ostream& os, const QuadraticPolynomial<T>& self) {
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION), QuadraticPolynomial, LIBFLATSURF_REAL_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION), QuadraticPolynomial, LIBFLATSURF_GEOMETRY_TYPES)
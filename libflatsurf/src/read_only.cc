@@ -19,6 +19,8 @@
 
 #include "impl/read_only.hpp"
 
+#include <memory>
+
 #include "../flatsurf/managed_movable.hpp"
 
 namespace flatsurf {
@@ -35,6 +37,26 @@ template <typename T>
 ReadOnly<T>::ReadOnly(ReadOnly&& rhs) :
   value(std::move(rhs.value)) {}
 
+template <typename T>
+ReadOnly<T> ReadOnly<T>::borrow(const T& value) {
+  const auto& state = ImplementationOf<ManagedMovable<T>>::self(value).state;
+  // The aliasing constructor of shared_ptr with an empty owner creates a
+  // pointer without a control block, i.e., copies of it are plain pointer
+  // copies.
+  return ReadOnly(ImplementationOf<ManagedMovable<T>>::from_this(std::shared_ptr<ImplementationOf<T>>(std::shared_ptr<ImplementationOf<T>>(), state.get())));
+}
+
+template <typename T>
+bool ReadOnly<T>::borrowed() const {
+  const auto& state = ImplementationOf<ManagedMovable<T>>::self(value).state;
+  return state != nullptr && state.use_count() == 0;
+}
+
+template <typename T>
+bool ReadOnly<T>::same(const ReadOnly& rhs) const {
+  return ImplementationOf<ManagedMovable<T>>::self(value).state.get() == ImplementationOf<ManagedMovable<T>>::self(rhs.value).state.get();
+}
+
 template <typename T>
 const T* ReadOnly<T>::operator->() const {
   return &value;
@@ -79,7 +101,7 @@ std::ostream& operator<<(std::ostream& os, const ReadOnly<T>& self) {
 
 // Instantiations of templates so implementations are generated for the linker
 LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION), ReadOnly, (FlatTriangulationCombinatorial))
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION), ReadOnly, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION), ReadOnly, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
 LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION), ReadOnly, LIBFLATSURF_FLAT_TRIANGULATION_COLLAPSED_TYPES)
-LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION), Vertical, LIBFLATSURF_FLAT_TRIANGULATION_TYPES, READONLY_WRAP_WRAP)
+LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION), Vertical, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES, READONLY_WRAP_WRAP)
 LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITHOUT_IMPLEMENTATION), Vertical, LIBFLATSURF_FLAT_TRIANGULATION_COLLAPSED_TYPES, READONLY_WRAP_WRAP)
@@ -20,20 +20,20 @@
 #include "../flatsurf/saddle_connection.hpp"
 
 #include <boost/lexical_cast.hpp>
-#include <climits>
+#include <optional>
 #include <ostream>
+#include <stdexcept>
+#include <vector>
 
 #include "../flatsurf/bound.hpp"
 #include "../flatsurf/ccw.hpp"
 #include "../flatsurf/flat_triangulation.hpp"
 #include "../flatsurf/half_edge_map.hpp"
 #include "../flatsurf/orientation.hpp"
-#include "../flatsurf/saddle_connections.hpp"
-#include "../flatsurf/saddle_connections_by_length.hpp"
-#include "../flatsurf/saddle_connections_by_length_iterator.hpp"
-#include "../flatsurf/saddle_connections_iterator.hpp"
 #include "../flatsurf/vector.hpp"
+#include "../flatsurf/vertex.hpp"
 #include "../flatsurf/vertical.hpp"
+#include "impl/chain.impl.hpp"
 #include "impl/saddle_connection.impl.hpp"
 #include "util/assert.ipp"
 #include "util/hash.ipp"
@@ -92,14 +92,9 @@ template <typename Surface>
 SaddleConnection<Surface> SaddleConnection<Surface>::inSector(const Surface& surface, HalfEdge source, const Vector<T>& vector) {
   CHECK_ARGUMENT(surface.inSector(source, vector), "Cannot search for " << vector << " next to " << source << " in " << surface << "; that direction is not in the search sector");
 
-  const auto construction = SaddleConnections<Surface>(surface)
-                                .bound(Bound::upper(vector))
-                                .sector(source)
-                                .sector(vector, vector);
+  const auto ret = ImplementationOf<SaddleConnection>::shoot(surface, source, vector, true);
 
-  const auto ret = begin(construction);
-
-  CHECK_ARGUMENT(ret != end(construction), "No connection with vector " << vector << " in sector starting at " << source << " in " << surface);
+  CHECK_ARGUMENT(ret, "No connection with vector " << vector << " in sector starting at " << source << " in " << surface);
 
   return *ret;
 }
@@ -170,12 +165,9 @@ template <typename Surface>
 SaddleConnection<Surface> SaddleConnection<Surface>::inSector(const Surface& surface, HalfEdge source, const Vertical<Surface>& direction) {
   CHECK_ARGUMENT(surface.inSector(source, direction), "Cannot search in direction " << direction << " next to " << source << " in " << surface << "; that direction is not in the search sector");
 
-  const auto construction = SaddleConnections<Surface>(surface)
-                                .byLength()
-                                .sector(source)
-                                .sector(direction, direction);
+  const auto ret = ImplementationOf<SaddleConnection>::shoot(surface, source, direction.vertical(), false);
 
-  const auto ret = begin(construction);
+  CHECK_ARGUMENT(ret, "No connection in direction " << direction << " in sector starting at " << source << " in " << surface);
 
   return *ret;
 }
@@ -183,32 +175,16 @@ SaddleConnection<Surface> SaddleConnection<Surface>::inSector(const Surface& sur
 template <typename Surface>
 std::vector<HalfEdge> SaddleConnection<Surface>::crossings() const {
   std::vector<HalfEdge> ret;
-
-  // We reconstruct the sequence of half edges that this saddle connection
-  // crossed. This is expensive (but cheap in terms of the output size.) This
-  // information seems to be essential to properly plot a saddle connection.
-  // It would be good to use a finite bound instead, see https://github.com/flatsurf/flatsurf/issues/153
-  auto reconstruction = SaddleConnections<Surface>(self->surface).bound(INT_MAX).sector(source());
-  auto it = reconstruction.begin();
-  while (*it != *this) {
-    const auto ccw = it->vector().ccw(vector());
-    ASSERT(ccw != CCW::COLLINEAR, "There cannot be another saddle connection in exactly the same direction as this one but in " << self->surface << " at " << source() << " we found " << it->vector() << " which has the same direction as " << vector());
-    it.skipSector(-ccw);
-    while (true) {
-      auto crossing = it.incrementWithCrossings();
-      if (crossing.has_value()) {
-        ret.push_back(*crossing);
-      } else {
-        break;
-      }
-    }
-  }
-
-  ASSERT(it->target() == target(), "We reconstructed the saddle connection in " << self->surface << " starting from " << source() << " with vector " << vector() << " but it does not end at " << target() << " as claimed but at " << it->target());
-
+  ImplementationOf<SaddleConnection>::crossings(*self->surface, source(), vector(), ret);
   return ret;
 }
 
+template <typename Surface>
+std::optional<int> SaddleConnection<Surface>::angle(const SaddleConnection<Surface>& other) const {
+  const auto turns = ImplementationOf<SaddleConnection>::turns(*self->surface, source(), vector());
+  return ImplementationOf<SaddleConnection>::angle(*self->surface, source(), vector(), turns, other.source(), other.vector());
+}
+
 template <typename Surface>
 SaddleConnection<Surface> SaddleConnection<Surface>::counterclockwise(const Surface& surface, HalfEdge source, HalfEdge target, const Chain<Surface>& chain) {
   const auto normalize = [&](HalfEdge& sector, const Vector<T>& vector) {
@@ -225,6 +201,38 @@ SaddleConnection<Surface> SaddleConnection<Surface>::counterclockwise(const Surf
   return SaddleConnection(surface, source, target, chain);
 }
 
+template <typename Surface>
+std::optional<SaddleConnection<Surface>> SaddleConnection<Surface>::lift(const Surface& surface, const SaddleConnection<FlatTriangulation<double>>& approximation) {
+#ifdef LIBFLATSURF_WITHOUT_DOUBLE
+  (void)surface;
+  (void)approximation;
+  throw std::logic_error("not implemented: lift() without support for double coordinates");
+#else
+  CHECK_ARGUMENT(surface.halfEdges().size() == approximation.surface().halfEdges().size(), "approximation " << approximation.surface() << " is not an approximation of " << surface);
+
+  std::vector<mpz_class> coefficients;
+  for (const auto edge : surface.edges())
+    coefficients.push_back(approximation.chain()[edge]);
+  const Chain<Surface> chain(surface, coefficients);
+
+  // The chain is the holonomy of the connection on the approximation. We
+  // search for the connection in its direction on surface and check that it
+  // has actually the same holonomy and ends at the same vertex.
+  const auto& vector = static_cast<const Vector<T>&>(chain);
+  if (!vector || !surface.inSector(approximation.source(), vector))
+    return std::nullopt;
+
+  const auto lift = ImplementationOf<SaddleConnection>::shoot(surface, approximation.source(), vector, true);
+  if (!lift)
+    return std::nullopt;
+
+  if (!(lift->chain() == chain) || lift->target() != approximation.target())
+    return std::nullopt;
+
+  return lift;
+#endif
+}
+
 template <typename Surface>
 const Vector<typename Surface::Coordinate>& SaddleConnection<Surface>::vector() const {
   return static_cast<const Vector<T>&>(chain());
@@ -246,13 +254,13 @@ SaddleConnection<Surface>::operator const Chain<Surface> &() const {
 }
 
 template <typename Surface>
-bool SaddleConnection<Surface>::operator>(const Bound bound) const {
-  return vector() > bound;
+bool SaddleConnection<Surface>::operator>(const Bound& bound) const {
+  return chain() > bound;
 }
 
 template <typename Surface>
-bool SaddleConnection<Surface>::operator<(const Bound bound) const {
-  return vector() < bound;
+bool SaddleConnection<Surface>::operator<(const Bound& bound) const {
+  return chain() < bound;
 }
 
 template <typename Surface>
@@ -265,14 +273,166 @@ ImplementationOf<SaddleConnection<Surface>>::ImplementationOf(const Surface& sur
   surface(surface),
   source(source),
   target(target),
-  chain(chain) {}
+  chain(chain) {
+  // The chain might come from a search that only borrows the surface. A
+  // saddle connection can be handed out to the user so it must keep the
+  // surface alive.
+  ImplementationOf<Chain<Surface>>::own(this->chain, this->surface);
+}
 
 template <typename Surface>
 ImplementationOf<SaddleConnection<Surface>>::ImplementationOf(const Surface& surface, HalfEdge source, HalfEdge target, Chain<Surface>&& chain) :
   surface(surface),
   source(source),
   target(target),
-  chain(std::move(chain)) {}
+  chain(std::move(chain)) {
+  ImplementationOf<Chain<Surface>>::own(this->chain, this->surface);
+}
+
+template <typename Surface>
+void ImplementationOf<SaddleConnection<Surface>>::crossings(const Surface& surface, HalfEdge source, const Vector<T>& vector, std::vector<HalfEdge>& crossings) {
+  // A saddle connection along its source half edge does not cross anything.
+  if (surface.fromHalfEdge(source).ccw(vector) == CCW::COLLINEAR)
+    return;
+
+  // We walk through the triangles along vector just like
+  // SaddleConnectionsCrossing::expand() but only ever continue on the side
+  // of the new vertex that contains vector.
+  HalfEdge nextEdge = surface.nextInFace(source);
+  Vector<T> nextEdgeEnd = surface.fromHalfEdge(source) + surface.fromHalfEdge(nextEdge);
+
+  while (true) {
+    crossings.push_back(nextEdge);
+
+    const HalfEdge across = -nextEdge;
+    ASSERT(!surface.boundary(across), "saddle connection " << vector << " from " << source << " cannot cross the boundary at " << across);
+
+    const HalfEdge first = surface.nextInFace(across);
+
+    Vector<T> vertex = nextEdgeEnd;
+    vertex += surface.fromHalfEdge(across);
+    vertex += surface.fromHalfEdge(first);
+
+    switch (vector.ccw(vertex)) {
+      case CCW::COLLINEAR:
+        // There are no vertices in the interior of a saddle connection, so
+        // this vertex is where the connection ends.
+        ASSERT(vertex == vector, "saddle connection " << vector << " from " << source << " passes through a vertex at " << vertex);
+        return;
+      case CCW::COUNTERCLOCKWISE:
+        nextEdge = first;
+        nextEdgeEnd = std::move(vertex);
+        break;
+      case CCW::CLOCKWISE:
+        nextEdge = surface.nextInFace(first);
+        break;
+    }
+  }
+}
+
+template <typename Surface>
+std::optional<SaddleConnection<Surface>> ImplementationOf<SaddleConnection<Surface>>::shoot(const Surface& surface, HalfEdge source, const Vector<T>& vector, bool bounded) {
+  ASSERT(surface.inSector(source, vector), "vector " << vector << " is not in the sector next to " << source);
+
+  // Return whether the vertex at end, which is in the direction of vector,
+  // is too far away to be the end of the connection.
+  const auto exceeds = [&](const Vector<T>& end) {
+    return bounded && !(end == vector) && vector.orientation(vector - end) == ORIENTATION::OPPOSITE;
+  };
+
+  // The connection might be the half edge source itself.
+  if (surface.fromHalfEdge(source).ccw(vector) == CCW::COLLINEAR) {
+    if (exceeds(surface.fromHalfEdge(source)))
+      return std::nullopt;
+    return SaddleConnection(surface, source);
+  }
+
+  // We walk through the triangles along vector like crossings() do. We
+  // track the end of the half edge that we are about to cross, both as a
+  // vector for the predicates and as a chain for the connection we return.
+  HalfEdge nextEdge = surface.nextInFace(source);
+  Vector<T> nextEdgeEnd = surface.fromHalfEdge(source) + surface.fromHalfEdge(nextEdge);
+  Chain<Surface> chain(surface, source);
+  chain += nextEdge;
+
+  while (true) {
+    // If vector ends before it crosses nextEdge, i.e., on the same side of
+    // nextEdge as the source vertex, there is no connection of at most that
+    // length. (If it ends on nextEdge, it does not end at a vertex either.)
+    if (bounded && surface.fromHalfEdge(nextEdge).ccw(vector - nextEdgeEnd + surface.fromHalfEdge(nextEdge)) != CCW::CLOCKWISE)
+      return std::nullopt;
+
+    const HalfEdge across = -nextEdge;
+    if (surface.boundary(across))
+      return std::nullopt;
+
+    const HalfEdge first = surface.nextInFace(across);
+
+    Vector<T> vertex = nextEdgeEnd;
+    vertex += surface.fromHalfEdge(across);
+    vertex += surface.fromHalfEdge(first);
+
+    switch (vector.ccw(vertex)) {
+      case CCW::COLLINEAR:
+        // The connection ends at this vertex and arrives in the sector
+        // between the two half edges of this triangle at that vertex.
+        if (exceeds(vertex))
+          return std::nullopt;
+        chain += across;
+        chain += first;
+        ASSERT(static_cast<const Vector<T>&>(chain) == vertex, "chain " << chain << " does not describe the vertex at " << vertex);
+        return SaddleConnection(surface, source, surface.nextInFace(first), std::move(chain));
+      case CCW::COUNTERCLOCKWISE:
+        nextEdge = first;
+        nextEdgeEnd = std::move(vertex);
+        chain += across;
+        chain += first;
+        break;
+      case CCW::CLOCKWISE:
+        nextEdge = surface.nextInFace(first);
+        break;
+    }
+  }
+}
+
+template <typename Surface>
+std::vector<int> ImplementationOf<SaddleConnection<Surface>>::turns(const Surface& surface, HalfEdge source, const Vector<T>& vector) {
+  std::vector<int> turns(surface.halfEdges().size(), -1);
+
+  int passed = 0;
+  HalfEdge sector = source;
+  do {
+    turns[sector.index()] = passed;
+    if (sector != source && vector.inSector(surface.fromHalfEdge(sector), surface.fromHalfEdge(surface.nextAtVertex(sector))))
+      passed++;
+    sector = surface.nextAtVertex(sector);
+  } while (sector != source);
+
+  return turns;
+}
+
+template <typename Surface>
+std::optional<int> ImplementationOf<SaddleConnection<Surface>>::angle(const Surface& surface, HalfEdge source, const Vector<T>& vector, const std::vector<int>& turns, HalfEdge sector, const Vector<T>& other) {
+  if (turns[sector.index()] == -1)
+    return std::nullopt;
+
+  const auto end = surface.fromHalfEdge(surface.nextAtVertex(sector));
+
+  if (sector == source) {
+    // Either other comes after vector in the same sector or we have to walk
+    // around the vertex and passed the direction of vector in every sheet
+    // but the one of vector itself.
+    if (other.inSector(vector, end))
+      return 0;
+    return surface.angle(Vertex::source(source, surface)) - 1;
+  }
+
+  // We pass the direction of vector in this sector if other comes after it.
+  int angle = turns[sector.index()];
+  if (vector.inSector(surface.fromHalfEdge(sector), end) && other.inSector(vector, end))
+    angle++;
+  return angle;
+}
 
 }  // namespace flatsurf
 
@@ -290,4 +450,4 @@ size_t hash<SaddleConnection<Surface>>::operator()(const SaddleConnection<Surfac
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), SaddleConnection, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), SaddleConnection, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
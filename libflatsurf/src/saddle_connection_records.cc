@@ -0,0 +1,228 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/saddle_connection_records.hpp"
+
+#include <algorithm>
+#include <complex>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../flatsurf/chain.hpp"
+#include "../flatsurf/chain_iterator.hpp"
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/vector.hpp"
+#include "impl/saddle_connection.impl.hpp"
+#include "impl/saddle_connection_records.impl.hpp"
+#include "util/assert.ipp"
+
+namespace flatsurf {
+
+template <typename Surface>
+SaddleConnectionRecords<Surface>::SaddleConnectionRecords(const Surface& surface) :
+  self(spimpl::make_impl<ImplementationOf<SaddleConnectionRecords>>(surface)) {
+  static_assert(std::is_trivially_copyable_v<Record>, "records must be trivially copyable");
+  static_assert(std::is_trivially_copyable_v<Term>, "terms must be trivially copyable");
+}
+
+template <typename Surface>
+const typename SaddleConnectionRecords<Surface>::Record& SaddleConnectionRecords<Surface>::push_back(const SaddleConnection<Surface>& connection) {
+  ASSERT_ARGUMENT(connection.surface() == surface(), "saddle connection must be on the surface of this store");
+  return push_back(connection.source(), connection.target(), connection.chain());
+}
+
+template <typename Surface>
+const typename SaddleConnectionRecords<Surface>::Record& SaddleConnectionRecords<Surface>::push_back(HalfEdge source, HalfEdge target, const Chain<Surface>& chain) {
+  const size_t begin = self->terms.size();
+
+  for (const auto& [edge, coefficient] : chain) {
+    if (!coefficient->fits_slong_p()) {
+      self->terms.resize(begin);
+      throw std::invalid_argument("coefficients of saddle connection do not fit into 64 bits");
+    }
+    self->terms.push_back(Term{edge.index(), coefficient->get_si()});
+  }
+
+  self->records.push_back(Record{source.id(), target.id(), begin, self->terms.size()});
+  return self->records.back();
+}
+
+template <typename Surface>
+const typename SaddleConnectionRecords<Surface>::Record& SaddleConnectionRecords<Surface>::push_back(int source, int target, const Term* begin, const Term* end) {
+  ASSERT_ARGUMENT(std::all_of(begin, end, [&](const Term& term) { return term.edge < self->surface->size(); }), "terms must refer to edges of the surface of this store");
+
+  const size_t first = self->terms.size();
+  self->terms.insert(self->terms.end(), begin, end);
+
+  self->records.push_back(Record{source, target, first, self->terms.size()});
+  return self->records.back();
+}
+
+template <typename Surface>
+SaddleConnection<Surface> SaddleConnectionRecords<Surface>::operator[](size_t i) const {
+  CHECK_ARGUMENT(i < size(), "no saddle connection at this position");
+  return (*this)[self->records[i]];
+}
+
+template <typename Surface>
+SaddleConnection<Surface> SaddleConnectionRecords<Surface>::operator[](const Record& record) const {
+  ASSERT_ARGUMENT(record.begin <= record.end && record.end <= self->terms.size(), "record does not belong to this store");
+
+  const auto& surface = *self->surface;
+
+  Chain<Surface> chain(surface);
+  for (size_t i = record.begin; i != record.end; i++) {
+    const auto& term = self->terms[i];
+    chain += Chain<Surface>(surface, Edge::fromIndex(term.edge).positive()) * mpz_class(term.coefficient);
+  }
+
+  return SaddleConnection<Surface>(surface, HalfEdge(record.source), HalfEdge(record.target), std::move(chain));
+}
+
+template <typename Surface>
+size_t SaddleConnectionRecords<Surface>::size() const {
+  return self->records.size();
+}
+
+template <typename Surface>
+bool SaddleConnectionRecords<Surface>::empty() const {
+  return self->records.empty();
+}
+
+template <typename Surface>
+void SaddleConnectionRecords<Surface>::clear() {
+  self->records.clear();
+  self->terms.clear();
+}
+
+template <typename Surface>
+const std::vector<typename SaddleConnectionRecords<Surface>::Record>& SaddleConnectionRecords<Surface>::records() const {
+  return self->records;
+}
+
+template <typename Surface>
+const std::vector<typename SaddleConnectionRecords<Surface>::Term>& SaddleConnectionRecords<Surface>::terms() const {
+  return self->terms;
+}
+
+template <typename Surface>
+void SaddleConnectionRecords<Surface>::columns(int* sources, int* targets, double* x, double* y, double* squared) const {
+  const auto& surface = *self->surface;
+
+  std::vector<std::complex<double>> vectors;
+  if (x || y || squared) {
+    vectors.resize(surface.size());
+    for (const auto& edge : surface.edges())
+      vectors[edge.index()] = static_cast<std::complex<double>>(surface.fromHalfEdge(edge.positive()));
+  }
+
+  for (size_t i = 0; i < self->records.size(); i++) {
+    const auto& record = self->records[i];
+
+    if (sources)
+      sources[i] = record.source;
+    if (targets)
+      targets[i] = record.target;
+
+    if (vectors.empty())
+      continue;
+
+    std::complex<double> vector;
+    for (size_t t = record.begin; t != record.end; t++)
+      vector += static_cast<double>(self->terms[t].coefficient) * vectors[self->terms[t].edge];
+
+    if (x)
+      x[i] = vector.real();
+    if (y)
+      y[i] = vector.imag();
+    if (squared)
+      squared[i] = std::norm(vector);
+  }
+}
+
+template <typename Surface>
+void SaddleConnectionRecords<Surface>::chains(size_t* offsets, size_t* edges, int64_t* coefficients) const {
+  for (size_t i = 0; i < self->records.size(); i++)
+    offsets[i] = self->records[i].begin;
+  offsets[self->records.size()] = self->terms.size();
+
+  for (size_t t = 0; t < self->terms.size(); t++) {
+    edges[t] = self->terms[t].edge;
+    coefficients[t] = self->terms[t].coefficient;
+  }
+}
+
+template <typename Surface>
+void SaddleConnectionRecords<Surface>::crossings(std::vector<size_t>& offsets, std::vector<HalfEdge>& crossings) const {
+  const auto& surface = *self->surface;
+
+  offsets.clear();
+  crossings.clear();
+
+  for (const auto& record : self->records) {
+    offsets.push_back(crossings.size());
+    ImplementationOf<SaddleConnection<Surface>>::crossings(surface, HalfEdge(record.source), (*this)[record].vector(), crossings);
+  }
+  offsets.push_back(crossings.size());
+}
+
+template <typename Surface>
+void SaddleConnectionRecords<Surface>::angles(const SaddleConnection<Surface>& from, int* angles) const {
+  ASSERT_ARGUMENT(from.surface() == surface(), "saddle connection must be on the surface of this store");
+
+  const auto& surface = *self->surface;
+
+  const auto turns = ImplementationOf<SaddleConnection<Surface>>::turns(surface, from.source(), from.vector());
+
+  for (size_t i = 0; i < self->records.size(); i++) {
+    const HalfEdge sector(self->records[i].source);
+
+    if (turns[sector.index()] == -1) {
+      angles[i] = -1;
+      continue;
+    }
+
+    angles[i] = *ImplementationOf<SaddleConnection<Surface>>::angle(surface, from.source(), from.vector(), turns, sector, (*this)[i].vector());
+  }
+}
+
+template <typename Surface>
+const Surface& SaddleConnectionRecords<Surface>::surface() const {
+  return *self->surface;
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnectionRecords<Surface>>::ImplementationOf(const Surface& surface) :
+  surface(surface) {}
+
+template <typename Surface>
+std::ostream& operator<<(std::ostream& os, const SaddleConnectionRecords<Surface>& self) {
+  return os << "SaddleConnectionRecords(" << self.size() << " connections)";
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), SaddleConnectionRecords, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
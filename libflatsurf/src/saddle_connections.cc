@@ -22,38 +22,72 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
 #include <exact-real/arb.hpp>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <optional>
 #include <stack>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
 
 #include "../flatsurf/bound.hpp"
 #include "../flatsurf/ccw.hpp"
 #include "../flatsurf/chain.hpp"
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/executor.hpp"
 #include "../flatsurf/flat_triangulation.hpp"
 #include "../flatsurf/fmt.hpp"
 #include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/isomorphism.hpp"
 #include "../flatsurf/orientation.hpp"
 #include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connection_records.hpp"
+#include "../flatsurf/saddle_connections_buckets.hpp"
 #include "../flatsurf/saddle_connections_by_length.hpp"
 #include "../flatsurf/saddle_connections_iterator.hpp"
+#include "../flatsurf/saddle_connections_iterator_checkpoint.hpp"
 #include "../flatsurf/saddle_connections_sample.hpp"
+#include "../flatsurf/saddle_connections_statistics.hpp"
+#include "../flatsurf/saddle_connections_work_unit.hpp"
 #include "../flatsurf/vector.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
 #include "impl/saddle_connections.impl.hpp"
+#include "impl/saddle_connections_approximate.hpp"
+#include "impl/saddle_connections_best_first.hpp"
+#include "impl/saddle_connections_depth_first.hpp"
+#include "impl/saddle_connections_integer.hpp"
+#include "impl/saddle_connections_lattice.hpp"
 #include "impl/saddle_connections_by_length.impl.hpp"
+#include "impl/saddle_connections_cache.hpp"
 #include "impl/saddle_connections_iterator.impl.hpp"
 #include "util/assert.ipp"
+#include "util/trace.ipp"
+#include "util/work_stealing.ipp"
 
 namespace flatsurf {
 
+namespace {
+// The number of times a sector might get split up during a parallel search
+// to hand some of its work to idle threads.
+constexpr int MAX_SECTOR_SPLITS = 16;
+
+// The number of tasks per thread that a parallel search aims for when it
+// splits up the sectors before the search starts.
+constexpr int TASKS_PER_THREAD = 8;
+}  // namespace
+
 template <typename Surface>
 SaddleConnections<Surface>::SaddleConnections(const Surface& surface) :
   self(spimpl::make_impl<ImplementationOf<SaddleConnections>>(surface)) {}
 
 template <typename Surface>
 SaddleConnections<Surface> SaddleConnections<Surface>::bound(const Bound searchRadius) const {
-  SaddleConnections<Surface> ret(self->surface);
-  ret.self = self;
+  auto ret = *this;
   ret.self->searchRadius = ret.self->searchRadius ? std::min(*ret.self->searchRadius, searchRadius) : searchRadius;
   return ret;
 }
@@ -72,29 +106,22 @@ std::optional<Bound> SaddleConnections<Surface>::bound() const {
 
 template <typename Surface>
 SaddleConnections<Surface> SaddleConnections<Surface>::lowerBound(const Bound bound) const {
-  SaddleConnections<Surface> ret(self->surface);
-  ret.self = self;
+  auto ret = *this;
   ret.self->lowerBound = std::max(ret.self->lowerBound, bound);
   return ret;
 }
 
 template <typename Surface>
 SaddleConnections<Surface> SaddleConnections<Surface>::source(const Vertex& source) const {
-  SaddleConnections<Surface> ret(self->surface);
-  ret.self = self;
-  ret.self->sectors = ret.self->sectors | rx::filter([&](const auto& sector) {
-    return Vertex::source(sector.source, *self->surface) == source;
-  }) | rx::to_vector();
+  auto ret = *this;
+  ret.self->sectors = ret.self->sectors.restrict(surface(), source);
   return ret;
 }
 
 template <typename Surface>
 SaddleConnections<Surface> SaddleConnections<Surface>::sector(const HalfEdge source) const {
   auto ret = *this;
-
-  ret.self->sectors = ret.self->sectors | rx::filter([&](const auto& sector) {
-    return sector.source == source;
-  }) | rx::to_vector();
+  ret.self->sectors = ret.self->sectors.restrict(source);
   return ret;
 }
 
@@ -103,11 +130,52 @@ SaddleConnections<Surface> SaddleConnections<Surface>::sector(const Vector<T>& s
   auto ret = *this;
 
   std::vector<typename ImplementationOf<SaddleConnections>::Sector> sectors;
+  sectors.reserve(ret.self->sectors.size());
   for (const auto& sector : ret.self->sectors)
-    for (const auto refined : sector.refine(surface(), sectorBegin, sectorEnd))
-      sectors.push_back(refined);
+    sector.refine(surface(), sectorBegin, sectorEnd, sectors);
 
-  ret.self->sectors = sectors;
+  ret.self->sectors = std::move(sectors);
+
+  return ret;
+}
+
+template <typename Surface>
+SaddleConnections<Surface> SaddleConnections<Surface>::near(const SaddleConnection<Surface>& connection, const T& epsilon) const {
+  CHECK_ARGUMENT(epsilon > 0, "epsilon must be positive");
+  CHECK_ARGUMENT(connection.surface() == surface(), "saddle connection must be on the surface of these saddle connections");
+
+  const auto& surface = this->surface();
+
+  const auto perpendicular = connection.vector().perpendicular();
+  const Vector<T> offset(perpendicular.x() * epsilon, perpendicular.y() * epsilon);
+  const Vector<T> sectorBegin = connection.vector() - offset;
+  const Vector<T> sectorEnd = connection.vector() + offset;
+
+  // Collect the half edges at the source of connection whose sectors meet
+  // the sector around connection by walking from the sector of connection
+  // in both directions. Since that sector is of angle less than π, we stop
+  // before reaching another sheet at that vertex.
+  std::vector<bool> near(surface.halfEdges().size());
+  near[connection.source().index()] = true;
+
+  for (HalfEdge he = surface.nextAtVertex(connection.source()); he != connection.source() && surface.fromHalfEdge(he).ccw(sectorEnd) == CCW::COUNTERCLOCKWISE; he = surface.nextAtVertex(he))
+    near[he.index()] = true;
+
+  for (HalfEdge he = connection.source(); sectorBegin.ccw(surface.fromHalfEdge(he)) == CCW::COUNTERCLOCKWISE;) {
+    he = surface.previousAtVertex(he);
+    if (he == connection.source())
+      break;
+    near[he.index()] = true;
+  }
+
+  auto ret = *this;
+
+  std::vector<typename ImplementationOf<SaddleConnections>::Sector> sectors;
+  for (const auto& sector : ret.self->sectors)
+    if (near[sector.source.index()])
+      sector.refine(surface, sectorBegin, sectorEnd, sectors);
+
+  ret.self->sectors = std::move(sectors);
 
   return ret;
 }
@@ -122,16 +190,14 @@ SaddleConnections<Surface> SaddleConnections<Surface>::sector(const SaddleConnec
   for (const auto& sector : ret.self->sectors) {
     if (sectorBegin.source() == sectorEnd.source()) {
       if (sector.source == sectorBegin.source())
-        for (const auto& refined : sector.refine(surface(), sectorBegin, sectorEnd))
-          sectors.push_back(refined);
+        sector.refine(surface(), sectorBegin, sectorEnd, sectors);
       else {
         if (sectorBegin.vector().ccw(sectorEnd.vector()) == CCW::CLOCKWISE)
           sectors.push_back(sector);
       }
     } else {
       if (sector.source == sectorBegin.source()) {
-        for (const auto& refined : sector.refine(surface(), sectorBegin, surface().fromHalfEdge(surface().nextAtVertex(sector.source))))
-          sectors.push_back(refined);
+        sector.refine(surface(), sectorBegin, surface().fromHalfEdge(surface().nextAtVertex(sector.source)), sectors);
       } else if (sector.source == sectorEnd.source()) {
         if (surface().fromHalfEdge(sector.source).ccw(sectorEnd) == CCW::COLLINEAR)
           // We must not call refine in this case as that method considers the
@@ -139,8 +205,7 @@ SaddleConnections<Surface> SaddleConnections<Surface>::sector(const SaddleConnec
           // is exclusive here.
           ;
         else
-          for (const auto& refined : sector.refine(surface(), surface().fromHalfEdge(sector.source), sectorEnd))
-            sectors.push_back(refined);
+          sector.refine(surface(), surface().fromHalfEdge(sector.source), sectorEnd, sectors);
       } else {
         for (HalfEdge walk = sector.source; walk != sectorBegin.source(); walk = surface().nextAtVertex(walk)) {
           if (walk == sectorEnd.source()) {
@@ -152,18 +217,402 @@ SaddleConnections<Surface> SaddleConnections<Surface>::sector(const SaddleConnec
     }
   }
 
-  ret.self->sectors = sectors;
+  ret.self->sectors = std::move(sectors);
   return ret;
 }
 
 template <typename Surface>
 typename SaddleConnections<Surface>::iterator SaddleConnections<Surface>::begin() const {
-  return SaddleConnectionsIterator<Surface>(PrivateConstructor{}, *self, cbegin(self->sectors), cend(self->sectors));
+  return SaddleConnectionsIterator<Surface>(PrivateConstructor{}, *self, self->sectors.begin(), self->sectors.end());
 }
 
 template <typename Surface>
 typename SaddleConnections<Surface>::iterator SaddleConnections<Surface>::end() const {
-  return SaddleConnectionsIterator<Surface>(PrivateConstructor{}, *self, cend(self->sectors), cend(self->sectors));
+  return SaddleConnectionsIterator<Surface>(PrivateConstructor{}, *self, self->sectors.end(), self->sectors.end());
+}
+
+template <typename Surface>
+typename SaddleConnections<Surface>::iterator SaddleConnections<Surface>::resume(const SaddleConnectionsIteratorCheckpoint<Surface>& checkpoint) const {
+  CHECK_ARGUMENT(checkpoint.sector <= self->sectors.size(), "checkpoint refers to sector " << checkpoint.sector << " but there are only " << self->sectors.size() << " sectors");
+
+  if (checkpoint.sector != self->sectors.size()) {
+    CHECK_ARGUMENT(checkpoint.boundaries.size() >= 2, "checkpoint must record the boundaries of the search sector");
+    CHECK_ARGUMENT(checkpoint.nextEdgeEnd, "checkpoint must record the position of the search");
+    CHECK_ARGUMENT(checkpoint.nextEdgeEnd->surface() == surface(), "checkpoint must have been created on the same surface");
+    CHECK_ARGUMENT(checkpoint.state.size() && checkpoint.state.front() == static_cast<unsigned char>(ImplementationOf<SaddleConnectionsIterator<Surface>>::State::END), "checkpoint does not record a valid search");
+    for (const auto s : checkpoint.state)
+      CHECK_ARGUMENT(s <= static_cast<unsigned char>(ImplementationOf<SaddleConnectionsIterator<Surface>>::State::END), "checkpoint does not record a valid search");
+  }
+
+  return SaddleConnectionsIterator<Surface>(PrivateConstructor{}, *self, checkpoint);
+}
+
+template <typename Surface>
+std::vector<SaddleConnectionsWorkUnit<Surface>> SaddleConnections<Surface>::split(size_t units) const {
+  CHECK_ARGUMENT(units > 0, "cannot split saddle connections into zero work units");
+
+  // We split the sectors into pieces such that no piece has much more than
+  // its share of the work (which is roughly proportional to the angle of the
+  // piece.) Consecutive pieces are then grouped into units of roughly equal
+  // total angle.
+  double total = 0;
+  for (const auto& sector : self->sectors)
+    total += sector.angle(surface());
+
+  const auto pieces = self->pieces(units > 1 ? total / (units * TASKS_PER_THREAD) : std::numeric_limits<double>::infinity());
+
+  std::vector<SaddleConnectionsWorkUnit<Surface>> split;
+  double assigned = 0;
+  for (const auto& [piece, splits] : pieces) {
+    if (split.empty() || (split.size() < units && assigned >= total * static_cast<double>(split.size()) / static_cast<double>(units))) {
+      split.emplace_back();
+      split.back().bound = self->searchRadius;
+      split.back().lowerBound = self->lowerBound;
+    }
+
+    split.back().sectors.push_back({piece.source, piece.sector});
+    assigned += piece.angle(surface());
+  }
+
+  return split;
+}
+
+template <typename Surface>
+SaddleConnections<Surface> SaddleConnections<Surface>::unit(const SaddleConnectionsWorkUnit<Surface>& unit) const {
+  using Sector = typename ImplementationOf<SaddleConnections>::Sector;
+
+  SaddleConnections<Surface> connections = *this;
+  connections.self->symmetries = nullptr;
+  connections.self->searchRadius = unit.bound;
+  connections.self->lowerBound = unit.lowerBound;
+  std::vector<Sector> sectors;
+  for (const auto& sector : unit.sectors) {
+    CHECK_ARGUMENT(sector.source.index() < surface().halfEdges().size(), "work unit refers to half edge " << sector.source << " which is not on this surface");
+    if (sector.rays)
+      sectors.push_back(Sector(sector.source, sector.rays->first, sector.rays->second));
+    else
+      sectors.push_back(Sector(sector.source));
+  }
+  connections.self->sectors = std::move(sectors);
+
+  return connections;
+}
+
+template <typename Surface>
+size_t SaddleConnections<Surface>::count() const {
+  LIBFLATSURF_TRACE("SaddleConnections::count");
+
+  // Every count has to be recorded in the statistics, so we cannot reuse
+  // the result of an earlier count then.
+  if (self->statistics)
+    return ImplementationOf<SaddleConnections>::count(*this);
+
+  std::lock_guard<std::mutex> lock(self->counted.mutex);
+  if (!self->counted.count)
+    self->counted.count = ImplementationOf<SaddleConnections>::count(*this);
+  return *self->counted.count;
+}
+
+template <typename Surface>
+void SaddleConnections<Surface>::forEach(const std::function<void(const SaddleConnection<Surface>&)>& callback, unsigned int threads) const {
+  LIBFLATSURF_TRACE("SaddleConnections::forEach");
+
+  using Sector = typename ImplementationOf<SaddleConnections>::Sector;
+
+  if (self->forEachCached([&](const auto& connection) {
+        callback(connection);
+        return true;
+      }))
+    return;
+
+  if (self->symmetries) {
+    if (const auto domain = self->fundamentalDomain()) {
+      SaddleConnections<Surface> fundamental = *this;
+      fundamental.self->symmetries = nullptr;
+      fundamental.self->sectors = *domain;
+      fundamental.forEach([&](const auto& connection) {
+        for (const auto& automorphism : *self->symmetries)
+          callback(ImplementationOf<SaddleConnections>::image(connection, automorphism));
+      }, threads);
+      return;
+    }
+  }
+
+  if (threads == 0)
+    threads = Executor::global().concurrency();
+
+  // Each task searches a sector which has been split a certain number of times.
+  WorkStealing<std::pair<Sector, int>> pool(threads);
+
+  // The sectors are split up front according to their angle. When workers
+  // run out of work later, they split their sectors further, see below.
+  size_t tasks = 0;
+  for (auto& task : self->tasks(threads))
+    pool.push(tasks++, std::move(task));
+
+  // On small integer surfaces, the tasks do not need to build a Chain for
+  // every vertex they visit.
+  const bool integer = SaddleConnectionsInteger<Surface>::applicable(*self);
+
+  // The copies of the surface that the workers search on, see replicated().
+  // Worker i searches on copy i modulo the number of copies which is
+  // created by the first worker that needs it.
+  const size_t replicas = std::min<size_t>(self->replicas, pool.workers());
+  std::vector<std::optional<ImplementationOf<SaddleConnections>>> replica(replicas);
+  std::vector<std::once_flag> created(replicas);
+
+  pool.run([&](size_t worker, std::pair<Sector, int> task) {
+    auto& [sector, splits] = task;
+
+    // Hand half of this sector to another thread if there is not enough work
+    // to go around.
+    while (splits < MAX_SECTOR_SPLITS && pool.hungry()) {
+      const auto halves = sector.split(surface());
+      if (!halves)
+        break;
+      splits++;
+      pool.push(worker, {halves->second, splits});
+      sector = halves->first;
+    }
+
+    if (replicas == 0) {
+      self->search(sector, integer, callback);
+      return;
+    }
+
+    const size_t copy = worker % replicas;
+    std::call_once(created[copy], [&]() { replica[copy].emplace(self->replicate()); });
+    replica[copy]->search(sector, integer, [&](const auto& connection) {
+      callback(ImplementationOf<SaddleConnections>::translate(surface(), connection));
+    });
+  });
+}
+
+template <typename Surface>
+void SaddleConnections<Surface>::forEachByAngle(const std::function<void(const SaddleConnection<Surface>&)>& callback, unsigned int threads) const {
+  LIBFLATSURF_TRACE("SaddleConnections::forEachByAngle");
+
+  if (threads == 0)
+    threads = Executor::global().concurrency();
+
+  // The tasks are the pieces of the sectors in the order in which iteration
+  // visits them. Each worker searches a task into a buffer and the calling
+  // thread reports the buffers in the order of the tasks.
+  const auto tasks = self->tasks(threads);
+
+  const bool integer = SaddleConnectionsInteger<Surface>::applicable(*self);
+
+  // Workers only pick up tasks that are less than this many tasks ahead of
+  // the task that is currently being reported so that the buffering is
+  // bounded when the callback is slower than the search.
+  const size_t window = threads * TASKS_PER_THREAD;
+
+  std::vector<std::vector<SaddleConnection<Surface>>> buffers(tasks.size());
+  std::vector<bool> done(tasks.size());
+
+  std::mutex lock;
+  std::condition_variable changed;
+  // The next task that is going to be picked up by a worker.
+  size_t next = 0;
+  // The next task whose connections are going to be reported.
+  size_t reported = 0;
+  bool stop = false;
+  std::exception_ptr error;
+
+  const auto work = [&]() {
+    while (true) {
+      size_t task;
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [&]() { return stop || next == tasks.size() || next < reported + window; });
+        if (stop || next == tasks.size())
+          return;
+        task = next++;
+      }
+
+      std::vector<SaddleConnection<Surface>> buffer;
+      try {
+        self->search(tasks[task].first, integer, [&](const auto& connection) { buffer.push_back(connection); });
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!error)
+          error = std::current_exception();
+        stop = true;
+        changed.notify_all();
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        buffers[task] = std::move(buffer);
+        done[task] = true;
+      }
+      changed.notify_all();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned int i = 0; i < threads; i++)
+    workers.emplace_back(work);
+
+  const auto join = [&]() {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      stop = true;
+    }
+    changed.notify_all();
+    for (auto& worker : workers)
+      worker.join();
+  };
+
+  try {
+    while (true) {
+      std::vector<SaddleConnection<Surface>> buffer;
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [&]() { return stop || reported == tasks.size() || done[reported]; });
+        if (stop || reported == tasks.size())
+          break;
+        buffer = std::move(buffers[reported++]);
+      }
+      changed.notify_all();
+
+      for (const auto& connection : buffer)
+        callback(connection);
+    }
+  } catch (...) {
+    join();
+    throw;
+  }
+
+  join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+template <typename Surface>
+std::vector<std::pair<Vector<typename Surface::Coordinate>, size_t>> SaddleConnections<Surface>::directions(unsigned int threads) const {
+  LIBFLATSURF_TRACE("SaddleConnections::directions");
+
+  std::vector<Vector<T>> vectors;
+  std::mutex lock;
+
+  forEach([&](const auto& connection) {
+    std::lock_guard<std::mutex> guard(lock);
+    vectors.push_back(connection.vector());
+  }, threads);
+
+  // Sort the vectors by their angle in [0, 2π).
+  const auto upper = [](const Vector<T>& v) { return v.y() > 0 || (v.y() == 0 && v.x() > 0); };
+  std::sort(begin(vectors), end(vectors), [&](const Vector<T>& v, const Vector<T>& w) {
+    if (upper(v) != upper(w))
+      return upper(v);
+    return v.ccw(w) == CCW::COUNTERCLOCKWISE;
+  });
+
+  std::vector<std::pair<Vector<T>, size_t>> directions;
+  for (auto& v : vectors) {
+    if (!directions.empty() && directions.back().first.ccw(v) == CCW::COLLINEAR && directions.back().first.orientation(v) == ORIENTATION::SAME) {
+      auto& [shortest, count] = directions.back();
+      count++;
+      if (v * v < shortest * shortest)
+        shortest = std::move(v);
+      continue;
+    }
+    directions.emplace_back(std::move(v), 1);
+  }
+
+  return directions;
+}
+
+template <typename Surface>
+SaddleConnectionsBuckets<Surface> SaddleConnections<Surface>::buckets(std::vector<Bound> bounds, unsigned int threads) const {
+  LIBFLATSURF_TRACE("SaddleConnections::buckets");
+
+  SaddleConnectionsBuckets<Surface> buckets(surface(), std::move(bounds));
+
+  Bound radius = buckets.bounds().back();
+  if (bound() && *bound() < radius)
+    radius = *bound();
+
+  std::mutex lock;
+
+  this->bound(radius).forEach([&](const auto& connection) {
+    std::lock_guard<std::mutex> guard(lock);
+    buckets.push_back(connection);
+  }, threads);
+
+  return buckets;
+}
+
+template <typename Surface>
+void SaddleConnections<Surface>::forEachByLength(const std::function<bool(const SaddleConnection<Surface>&)>& callback) const {
+  LIBFLATSURF_TRACE("SaddleConnections::forEachByLength");
+
+  if (self->forEachCached(callback))
+    return;
+
+  SaddleConnectionsBestFirst<Surface> search(*self);
+
+  while (const auto connection = search.next())
+    if (!callback(*connection))
+      return;
+}
+
+template <typename Surface>
+SaddleConnections<Surface> SaddleConnections<Surface>::collectStatistics() const {
+  auto ret = *this;
+  ret.self->statistics = std::make_shared<typename ImplementationOf<SaddleConnections>::Statistics>();
+  return ret;
+}
+
+template <typename Surface>
+SaddleConnections<Surface> SaddleConnections<Surface>::replicated(unsigned int replicas) const {
+  auto ret = *this;
+  ret.self->replicas = replicas;
+  return ret;
+}
+
+template <typename Surface>
+SaddleConnections<Surface> SaddleConnections<Surface>::cached() const {
+  auto ret = *this;
+  ret.self->cached = true;
+  return ret;
+}
+
+template <typename Surface>
+SaddleConnections<Surface> SaddleConnections<Surface>::symmetric() const {
+  const auto& surface = this->surface();
+
+  auto symmetries = std::make_shared<std::vector<std::vector<HalfEdge>>>();
+
+  if (!surface.hasBoundary()) {
+    const auto rotation = [](const T& a, const T& b, const T& c, const T& d) {
+      return a * d - b * c == 1 && a * a + c * c == 1 && b * b + d * d == 1 && a * b + c * d == 0;
+    };
+
+    for (const auto& automorphism : surface.automorphisms(ISOMORPHISM::FACES, rotation)) {
+      std::vector<HalfEdge> images(2 * surface.size());
+      for (const auto he : surface.halfEdges())
+        images[he.index()] = *automorphism(he);
+      symmetries->push_back(std::move(images));
+    }
+  }
+
+  auto ret = *this;
+  if (symmetries->size() > 1)
+    ret.self->symmetries = std::move(symmetries);
+  return ret;
+}
+
+template <typename Surface>
+std::optional<SaddleConnectionsStatistics> SaddleConnections<Surface>::statistics() const {
+  if (!self->statistics)
+    return std::nullopt;
+
+  std::lock_guard lock(self->statistics->mutex);
+  return self->statistics->statistics;
 }
 
 template <typename Surface>
@@ -184,7 +633,204 @@ const Surface& SaddleConnections<Surface>::surface() const {
 template <typename Surface>
 ImplementationOf<SaddleConnections<Surface>>::ImplementationOf(const Surface& surface) :
   surface(surface),
-  sectors(surface.halfEdges() | rx::transform([](const auto he) { return Sector(he); }) | rx::to_vector()) {}
+  sectors(surface),
+  approximations(std::make_shared<const HalfEdgeMap<DoubleApproximation>>(surface, [&](const HalfEdge he) { return DoubleApproximation(surface.fromHalfEdgeApproximate(he)); })) {}
+
+template <typename Surface>
+size_t ImplementationOf<SaddleConnections<Surface>>::count(const SaddleConnections<Surface>& connections) {
+  const auto& self = connections.self;
+
+  size_t count = 0;
+
+  if (self->forEachCached([&](const auto&) {
+        count++;
+        return true;
+      }))
+    return count;
+
+  if (self->symmetries) {
+    if (const auto domain = self->fundamentalDomain()) {
+      SaddleConnections<Surface> fundamental = connections;
+      fundamental.self->symmetries = nullptr;
+      fundamental.self->sectors = *domain;
+      return fundamental.count() * self->symmetries->size();
+    }
+  }
+
+  // The specialized searches below do not collect statistics, so we only
+  // use them when no statistics have been requested.
+  if (!self->statistics) {
+    // On square-tiled surfaces, we only need to count lattice points.
+    if (SaddleConnectionsLattice<Surface>::applicable(*self))
+      return SaddleConnectionsLattice<Surface>::count(*self);
+
+    if (SaddleConnectionsInteger<Surface>::applicable(*self)) {
+      // On small integer surfaces, we can count without ever building a Chain.
+      SaddleConnectionsInteger<Surface> search(*self);
+      while (search.next())
+        count++;
+      return count;
+    }
+
+    if (SaddleConnectionsApproximate<Surface>::applicable(*self)) {
+      // Otherwise, we search on floating point approximations and only
+      // resort to exact arithmetic when these are not conclusive.
+      SaddleConnectionsApproximate<Surface> search(*self);
+      while (search.next())
+        count++;
+      return count;
+    }
+  }
+
+  // We drive the search directly instead of going through the iterator
+  // interface so that we never compare iterators or construct the saddle
+  // connections themselves.
+  ImplementationOf<SaddleConnectionsIterator<Surface>> search(*self, self->sectors.begin(), self->sectors.end());
+
+  while (search.sector != search.end) {
+    count++;
+    while (!search.increment())
+      ;
+  }
+
+  return count;
+}
+
+template <typename Surface>
+std::vector<std::pair<typename ImplementationOf<SaddleConnections<Surface>>::Sector, int>> ImplementationOf<SaddleConnections<Surface>>::tasks(unsigned int threads) const {
+  // The work in a sector grows with its angle, so sectors at vertices of
+  // large total angle or in the wide corners of thin triangles are much
+  // more expensive than others. We split the sectors up front until no
+  // task has much more than its share of the total angle.
+  double share = std::numeric_limits<double>::infinity();
+  if (threads > 1) {
+    double total = 0;
+    for (const auto& sector : sectors)
+      total += sector.angle(*surface);
+    share = total / (threads * TASKS_PER_THREAD);
+  }
+
+  return pieces(share);
+}
+
+template <typename Surface>
+std::vector<std::pair<typename ImplementationOf<SaddleConnections<Surface>>::Sector, int>> ImplementationOf<SaddleConnections<Surface>>::pieces(double share) const {
+  std::vector<std::pair<Sector, int>> tasks;
+
+  for (const auto& sector : sectors) {
+    std::vector<std::pair<Sector, int>> pieces{{sector, 0}};
+    while (!pieces.empty()) {
+      auto [piece, splits] = std::move(pieces.back());
+      pieces.pop_back();
+
+      if (splits < MAX_SECTOR_SPLITS && piece.angle(*surface) > share) {
+        if (auto halves = piece.split(*surface)) {
+          pieces.push_back({std::move(halves->second), splits + 1});
+          pieces.push_back({std::move(halves->first), splits + 1});
+          continue;
+        }
+      }
+
+      tasks.push_back({std::move(piece), splits});
+    }
+  }
+
+  return tasks;
+}
+
+template <typename Surface>
+void ImplementationOf<SaddleConnections<Surface>>::search(const Sector& sector, bool integer, const std::function<void(const SaddleConnection<Surface>&)>& callback) const {
+  ImplementationOf connections = *this;
+  connections.sectors = std::vector<Sector>{sector};
+
+  if (integer) {
+    SaddleConnectionsInteger<Surface> search(connections);
+    while (search.next())
+      callback(search.connection());
+    return;
+  }
+
+  SaddleConnectionsDepthFirst<Surface> search(connections);
+  while (const auto connection = search.next())
+    callback(*connection);
+}
+
+template <typename Surface>
+std::optional<std::vector<typename ImplementationOf<SaddleConnections<Surface>>::Sector>> ImplementationOf<SaddleConnections<Surface>>::fundamentalDomain() const {
+  if (!symmetries)
+    return std::nullopt;
+
+  std::vector<bool> searched(2 * surface->size());
+  for (const auto& sector : sectors) {
+    if (sector.sector)
+      return std::nullopt;
+    searched[sector.source.index()] = true;
+  }
+
+  for (const auto& automorphism : *symmetries)
+    for (const auto& sector : sectors)
+      if (!searched[automorphism[sector.source.index()].index()])
+        return std::nullopt;
+
+  // Since an orientation preserving automorphism that fixes a half edge is
+  // the identity, every orbit has as many sectors as there are symmetries.
+  std::vector<bool> covered(2 * surface->size());
+  std::vector<Sector> domain;
+  for (const auto& sector : sectors) {
+    if (covered[sector.source.index()])
+      continue;
+    domain.push_back(sector);
+    for (const auto& automorphism : *symmetries)
+      covered[automorphism[sector.source.index()].index()] = true;
+  }
+
+  return domain;
+}
+
+template <typename Surface>
+SaddleConnection<Surface> ImplementationOf<SaddleConnections<Surface>>::image(const SaddleConnection<Surface>& connection, const std::vector<HalfEdge>& automorphism) {
+  const HalfEdge source = automorphism[connection.source().index()];
+
+  if (source == connection.source())
+    return connection;
+
+  const auto& surface = connection.surface();
+
+  std::vector<mpz_class> coefficients(surface.size());
+  for (const auto& edge : surface.edges()) {
+    const auto& coefficient = connection.chain()[edge];
+    if (coefficient == 0)
+      continue;
+
+    const HalfEdge he = automorphism[edge.positive().index()];
+    if (he == Edge(he).positive())
+      coefficients[Edge(he).index()] += coefficient;
+    else
+      coefficients[Edge(he).index()] -= coefficient;
+  }
+
+  return SaddleConnection<Surface>(surface, source, automorphism[connection.target().index()], Chain<Surface>(surface, coefficients));
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnections<Surface>> ImplementationOf<SaddleConnections<Surface>>::replicate() const {
+  ImplementationOf replica = *this;
+
+  const Surface clone = surface->clone();
+  replica.surface = ReadOnly<Surface>(clone);
+  replica.approximations = std::make_shared<const HalfEdgeMap<DoubleApproximation>>(clone, [&](const HalfEdge he) { return DoubleApproximation(clone.fromHalfEdgeApproximate(he)); });
+
+  return replica;
+}
+
+template <typename Surface>
+SaddleConnection<Surface> ImplementationOf<SaddleConnections<Surface>>::translate(const Surface& surface, const SaddleConnection<Surface>& connection) {
+  std::vector<mpz_class> coefficients(surface.size());
+  for (const auto& edge : surface.edges())
+    coefficients[edge.index()] = connection.chain()[edge];
+
+  return SaddleConnection<Surface>(surface, connection.source(), connection.target(), Chain<Surface>(surface, coefficients));
+}
 
 template <typename Surface>
 void ImplementationOf<SaddleConnections<Surface>>::resetLowerBound(SaddleConnections<Surface>& connections) {
@@ -192,11 +838,77 @@ void ImplementationOf<SaddleConnections<Surface>>::resetLowerBound(SaddleConnect
 }
 
 template <typename Surface>
-std::vector<typename ImplementationOf<SaddleConnections<Surface>>::Sector> ImplementationOf<SaddleConnections<Surface>>::Sector::refine(const Surface& surface, const Vector<T>& sectorBegin, const Vector<T>& sectorEnd) const {
-  auto sector = this->sector ? *this->sector : std::pair{surface.fromHalfEdge(source), surface.fromHalfEdge(surface.nextAtVertex(source))};
+bool ImplementationOf<SaddleConnections<Surface>>::beyondLowerBound(const DoubleApproximation& approximation, const Chain<Surface>& chain) const {
+  // Saddle connections are never zero.
+  if (!lowerBound)
+    return true;
+
+  // The relative error we allow for in the approximation of the lower bound
+  // and the roundings below; much larger than the actual error.
+  constexpr double SLACK = 1e-12;
 
-  ASSERT(sector.first.ccw(surface.fromHalfEdge(source)) != CCW::CLOCKWISE, "sector boundaries before refinement must not be outside of search sector");
-  ASSERT(sector.second.ccw(surface.fromHalfEdge(source)) != CCW::COUNTERCLOCKWISE, "sector boundaries before refinement must not be outside of search sector");
+  const double squared = lowerBound.squared().get_d();
+
+  const double lower = approximation.lowerLength();
+  if (lower * lower > squared * (1 + SLACK))
+    return true;
+
+  const double upper = approximation.upperLength();
+  if (upper * upper < squared * (1 - SLACK))
+    return false;
+
+  return chain > lowerBound;
+}
+
+template <typename Surface>
+bool ImplementationOf<SaddleConnections<Surface>>::forEachCached(const std::function<bool(const SaddleConnection<Surface>&)>& callback) const {
+  if (!cached || !searchRadius)
+    return false;
+
+  // The search sectors starting at each half edge.
+  std::vector<std::vector<const Sector*>> bySource(surface->halfEdges().size());
+  for (const auto& sector : sectors)
+    bySource[sector.source.index()].push_back(&sector);
+
+  const auto contains = [&](const auto& entry) {
+    for (const auto* sector : bySource[entry.source.index()])
+      if (!sector->sector || entry.vector.inSector(sector->sector->first, sector->sector->second))
+        return true;
+    return false;
+  };
+
+  // We copy the matching entries so that callback can run without holding
+  // the lock on the cache.
+  std::vector<typename SaddleConnectionsCache<Surface>::Entry> entries;
+
+  ImplementationOf<Surface>::connections(surface, [&](SaddleConnectionsCache<Surface>& cache) {
+    if (!cache.covers(*searchRadius))
+      cache.fill(surface, *searchRadius);
+
+    // The entries are sorted by length, so we can jump straight to the
+    // ones that are longer than the lower bound.
+    const size_t prefix = cache.prefix(*searchRadius);
+    for (size_t i = cache.prefix(lowerBound); i < prefix; i++)
+      if (contains(cache.entries[i]))
+        entries.push_back(cache.entries[i]);
+  });
+
+  for (const auto& entry : entries)
+    if (!callback(SaddleConnectionsCache<Surface>::connection(surface, entry)))
+      break;
+
+  return true;
+}
+
+template <typename Surface>
+void ImplementationOf<SaddleConnections<Surface>>::Sector::refine(const Surface& surface, const Vector<T>& sectorBegin, const Vector<T>& sectorEnd, std::vector<Sector>& refined) const {
+  // We refer to the boundaries of the sector without copying their exact
+  // coordinates.
+  const Vector<T>& first = this->sector ? this->sector->first : surface.fromHalfEdge(source);
+  const Vector<T>& second = this->sector ? this->sector->second : surface.fromHalfEdge(surface.nextAtVertex(source));
+
+  ASSERT(first.ccw(surface.fromHalfEdge(source)) != CCW::CLOCKWISE, "sector boundaries before refinement must not be outside of search sector");
+  ASSERT(second.ccw(surface.fromHalfEdge(source)) != CCW::COUNTERCLOCKWISE, "sector boundaries before refinement must not be outside of search sector");
 
   const auto inSector = [](const auto& v, const auto& begin, const auto& end) {
     return v.inSector(begin, end);
@@ -206,28 +918,39 @@ std::vector<typename ImplementationOf<SaddleConnections<Surface>>::Sector> Imple
     return v.inSector(begin, end) && !(v.ccw(begin) == CCW::COLLINEAR && v.orientation(begin) == ORIENTATION::SAME);
   };
 
-  if (inSector(sectorBegin, sector.first, sector.second)) {
+  if (inSector(sectorBegin, first, second)) {
     if (sectorBegin.ccw(sectorEnd) == CCW::CLOCKWISE) {
-      const auto fromBegin = Sector(source, sectorBegin, sector.second);
-      const auto toEnd = Sector(source, sector.first, sectorEnd);
-      if (sector.first.ccw(sectorEnd) == CCW::COUNTERCLOCKWISE)
-        return {fromBegin, toEnd};
-      else
-        return {fromBegin};
-    } else if (inSector(sectorEnd, sector.first, sector.second)) {
-      return {Sector(source, sectorBegin, sectorEnd)};
+      refined.emplace_back(source, sectorBegin, second);
+      if (first.ccw(sectorEnd) == CCW::COUNTERCLOCKWISE)
+        refined.emplace_back(source, first, sectorEnd);
+    } else if (inSector(sectorEnd, first, second)) {
+      refined.emplace_back(source, sectorBegin, sectorEnd);
     } else {
-      return {Sector(source, sectorBegin, sector.second)};
+      refined.emplace_back(source, sectorBegin, second);
     }
-  } else if (inSectorExclusive(sectorEnd, sector.first, sector.second)) {
-    return {Sector(source, sector.first, sectorEnd)};
-  } else if (inSector(sector.first, sectorBegin, sectorEnd)) {
-    return {*this};
-  } else {
-    return {};
+  } else if (inSectorExclusive(sectorEnd, first, second)) {
+    refined.emplace_back(source, first, sectorEnd);
+  } else if (inSector(first, sectorBegin, sectorEnd)) {
+    refined.push_back(*this);
   }
 }
 
+template <typename Surface>
+std::optional<std::pair<typename ImplementationOf<SaddleConnections<Surface>>::Sector, typename ImplementationOf<SaddleConnections<Surface>>::Sector>> ImplementationOf<SaddleConnections<Surface>>::Sector::split(const Surface& surface) const {
+  if (surface.boundary(source))
+    return std::nullopt;
+
+  const auto [begin, end] = this->sector ? *this->sector : std::pair{surface.fromHalfEdge(source), surface.fromHalfEdge(surface.nextAtVertex(source))};
+
+  // Sectors are contained in a face and so their angle is less than π.
+  if (begin.ccw(end) != CCW::COUNTERCLOCKWISE)
+    return std::nullopt;
+
+  const auto middle = begin + end;
+
+  return std::pair{Sector(source, begin, middle), Sector(source, middle, end)};
+}
+
 template <typename Surface>
 bool ImplementationOf<SaddleConnections<Surface>>::Sector::contains(const SaddleConnection<Surface>& connection) const {
   if (connection.source() != source)
@@ -237,6 +960,115 @@ bool ImplementationOf<SaddleConnections<Surface>>::Sector::contains(const Saddle
   return connection.vector().inSector(sector->first, sector->second);
 }
 
+template <typename Surface>
+double ImplementationOf<SaddleConnections<Surface>>::Sector::angle(const Surface& surface) const {
+  if (surface.boundary(source))
+    return 0;
+
+  const auto [begin, end] = this->sector ? *this->sector : std::pair{surface.fromHalfEdge(source), surface.fromHalfEdge(surface.nextAtVertex(source))};
+
+  double angle = std::arg(static_cast<std::complex<double>>(end)) - std::arg(static_cast<std::complex<double>>(begin));
+  if (angle < 0)
+    angle += 2 * M_PI;
+  return angle;
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnections<Surface>>::Sectors::Sectors(const Surface& surface) :
+  full(true) {
+  // The half edges of a surface are sorted by index, so the list of full
+  // sectors is the same for all surfaces with the same number of half edges.
+  static std::mutex mutex;
+  static std::unordered_map<size_t, std::weak_ptr<const std::vector<Sector>>> cache;
+
+  const size_t halfEdges = surface.halfEdges().size();
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  sectors = cache[halfEdges].lock();
+  if (!sectors) {
+    sectors = std::make_shared<const std::vector<Sector>>(surface.halfEdges() | rx::transform([](const auto he) { return Sector(he); }) | rx::to_vector());
+    cache[halfEdges] = sectors;
+  }
+
+  first = 0;
+  last = halfEdges;
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnections<Surface>>::Sectors::Sectors(std::vector<Sector> sectors) :
+  Sectors(std::make_shared<const std::vector<Sector>>(std::move(sectors)), 0, 0, false) {
+  last = this->sectors->size();
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnections<Surface>>::Sectors::Sectors(std::shared_ptr<const std::vector<Sector>> sectors, size_t first, size_t last, bool full) :
+  sectors(std::move(sectors)),
+  first(first),
+  last(last),
+  full(full) {}
+
+template <typename Surface>
+typename ImplementationOf<SaddleConnections<Surface>>::Sectors::const_iterator ImplementationOf<SaddleConnections<Surface>>::Sectors::begin() const {
+  return sectors->cbegin() + static_cast<std::ptrdiff_t>(first);
+}
+
+template <typename Surface>
+typename ImplementationOf<SaddleConnections<Surface>>::Sectors::const_iterator ImplementationOf<SaddleConnections<Surface>>::Sectors::end() const {
+  return sectors->cbegin() + static_cast<std::ptrdiff_t>(last);
+}
+
+template <typename Surface>
+size_t ImplementationOf<SaddleConnections<Surface>>::Sectors::size() const {
+  return last - first;
+}
+
+template <typename Surface>
+bool ImplementationOf<SaddleConnections<Surface>>::Sectors::empty() const {
+  return first == last;
+}
+
+template <typename Surface>
+const typename ImplementationOf<SaddleConnections<Surface>>::Sector& ImplementationOf<SaddleConnections<Surface>>::Sectors::operator[](size_t index) const {
+  return (*sectors)[first + index];
+}
+
+template <typename Surface>
+typename ImplementationOf<SaddleConnections<Surface>>::Sectors ImplementationOf<SaddleConnections<Surface>>::Sectors::restrict(HalfEdge source) const {
+  if (full) {
+    if (source.index() >= first && source.index() < last)
+      return Sectors(sectors, source.index(), source.index() + 1, true);
+    return Sectors(sectors, first, first, true);
+  }
+
+  std::vector<Sector> restricted;
+  for (const auto& sector : *this)
+    if (sector.source == source)
+      restricted.push_back(sector);
+  return restricted;
+}
+
+template <typename Surface>
+typename ImplementationOf<SaddleConnections<Surface>>::Sectors ImplementationOf<SaddleConnections<Surface>>::Sectors::restrict(const Surface& surface, const Vertex& source) const {
+  std::vector<Sector> restricted;
+
+  if (full) {
+    // Only the half edges at source need to be considered, in the order of
+    // the full list.
+    auto halfEdges = surface.atVertex(source);
+    std::sort(std::begin(halfEdges), std::end(halfEdges), [](const auto& lhs, const auto& rhs) { return lhs.index() < rhs.index(); });
+    for (const auto he : halfEdges)
+      if (he.index() >= first && he.index() < last)
+        restricted.push_back((*sectors)[he.index()]);
+  } else {
+    for (const auto& sector : *this)
+      if (Vertex::source(sector.source, surface) == source)
+        restricted.push_back(sector);
+  }
+
+  return restricted;
+}
+
 template <typename Surface>
 std::ostream& operator<<(std::ostream& os, const SaddleConnections<Surface>&) {
   return os << "SaddleConnections()";
@@ -246,4 +1078,4 @@ std::ostream& operator<<(std::ostream& os, const SaddleConnections<Surface>&) {
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), SaddleConnections, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), SaddleConnections, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -0,0 +1,327 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#include "impl/saddle_connections_approximate.hpp"
+
+#include <cmath>
+#include <exact-real/arb.hpp>
+#include <stdexcept>
+
+#include "../flatsurf/bound.hpp"
+#include "../flatsurf/chain.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/half_edge_map.hpp"
+
+namespace flatsurf {
+
+namespace {
+
+// The relative error we allow for when approximating the bounds of the
+// search by doubles; much larger than the error of the actual computation.
+constexpr double SLACK = 1e-12;
+
+// Return whether bound can be approximated by a double.
+bool approximable(const Bound& bound) {
+  return std::isfinite(bound.squared().get_d());
+}
+
+// Set bounds to a lower and an upper bound for the length of bound.
+void approximate(const Bound& bound, double (&bounds)[2]) {
+  const double length = std::sqrt(bound.squared().get_d());
+  bounds[0] = length * (1 - SLACK);
+  bounds[1] = length * (1 + SLACK);
+}
+
+// Return whether the vector with this approximation is at most as long as
+// bound whose length is approximated by bounds. Only when this cannot be
+// decided from the approximations, the exact vector is computed.
+template <typename Exact>
+bool within(const DoubleApproximation& approximation, const double (&bounds)[2], const Bound& bound, const Exact& exact) {
+  if (approximation.lowerLength() > bounds[1])
+    return false;
+  if (approximation.upperLength() <= bounds[0])
+    return true;
+  return !(exact() > bound);
+}
+
+}  // namespace
+
+template <typename Surface>
+SaddleConnectionsApproximate<Surface>::SaddleConnectionsApproximate(const ImplementationOf<SaddleConnections<Surface>>& connections) :
+  connections(connections) {
+  approximate(*connections.searchRadius, radius);
+  approximate(connections.lowerBound, lowerBound);
+}
+
+template <typename Surface>
+bool SaddleConnectionsApproximate<Surface>::applicable(const ImplementationOf<SaddleConnections<Surface>>& connections) {
+  if (!connections.searchRadius)
+    return false;
+
+  return approximable(*connections.searchRadius) && approximable(connections.lowerBound);
+}
+
+template <typename Surface>
+bool SaddleConnectionsApproximate<Surface>::next() {
+  const auto& surface = *connections.surface;
+  const auto& approximations = *connections.approximations;
+
+  while (true) {
+    if (frames.empty()) {
+      trails.clear();
+
+      if (sector == connections.sectors.size())
+        return false;
+
+      if (start())
+        return true;
+
+      continue;
+    }
+
+    const Frame from = frames.back();
+    frames.pop_back();
+
+    // This follows SaddleConnectionsInteger::next().
+    const HalfEdge across = -from.nextEdge;
+
+    if (surface.boundary(across))
+      continue;
+
+    const HalfEdge first = surface.nextInFace(across);
+    const HalfEdge second = surface.nextInFace(first);
+
+    DoubleApproximation vertex = from.nextEdgeEnd;
+    vertex += approximations[across];
+    vertex += approximations[first];
+
+    // The trail of the new vertex. It is only kept if the vertex is in the
+    // search sector.
+    trails.push_back({across, first, from.trail});
+    const auto index = static_cast<uint32_t>(trails.size() - 1);
+
+    bool clockwiseOfSector = false;
+    bool counterclockwiseOfSector = true;
+    switch (ccw(from, from.boundary[0], vertex, index)) {
+      case CCW::CLOCKWISE:
+        clockwiseOfSector = true;
+        break;
+      case CCW::COLLINEAR:
+        if (from.boundary[0].exclusive())
+          clockwiseOfSector = true;
+        else
+          counterclockwiseOfSector = false;
+        break;
+      case CCW::COUNTERCLOCKWISE:
+        if (ccw(from, from.boundary[1], vertex, index) == CCW::CLOCKWISE)
+          counterclockwiseOfSector = false;
+        break;
+    }
+
+    if (clockwiseOfSector) {
+      trails.pop_back();
+
+      Frame counterclockwise = from;
+      counterclockwise.nextEdge = second;
+      if (!beyond(counterclockwise))
+        frames.push_back(counterclockwise);
+      continue;
+    }
+
+    if (counterclockwiseOfSector) {
+      Frame clockwise = from;
+      clockwise.nextEdge = first;
+      clockwise.nextEdgeEnd = vertex;
+      clockwise.trail = index;
+      if (!beyond(clockwise))
+        frames.push_back(clockwise);
+      continue;
+    }
+
+    // Split the search sector at the saddle connection.
+    const Boundary boundary{vertex, Boundary::Kind::TRAIL, HalfEdge(), index};
+
+    Frame clockwise = from;
+    if (!clockwise.boundary[0].exclusive() && ccw(clockwise, clockwise.boundary[0], vertex, index) == CCW::COLLINEAR)
+      clockwise.boundary[0] = boundary;
+
+    Frame counterclockwise = clockwise;
+
+    if (clockwise.boundary[1].exclusive() || ccw(clockwise, clockwise.boundary[1], vertex, index) != CCW::COUNTERCLOCKWISE)
+      clockwise.boundary[1] = boundary;
+    clockwise.nextEdge = first;
+    clockwise.nextEdgeEnd = vertex;
+    clockwise.trail = index;
+
+    if (counterclockwise.boundary[0].exclusive() || ccw(counterclockwise, counterclockwise.boundary[0], vertex, index) != CCW::CLOCKWISE)
+      counterclockwise.boundary[0] = boundary;
+    counterclockwise.nextEdge = second;
+
+    // The clockwise part is searched first, so it goes on top of the stack.
+    if (!beyond(counterclockwise))
+      frames.push_back(counterclockwise);
+    if (!beyond(clockwise))
+      frames.push_back(clockwise);
+
+    if (reported(vertex, index)) {
+      source = connections.sectors[from.sector].source;
+      target = surface.previousAtVertex(-first);
+      trail = index;
+      return true;
+    }
+  }
+}
+
+template <typename Surface>
+bool SaddleConnectionsApproximate<Surface>::start() {
+  const auto& surface = *connections.surface;
+  const auto& approximations = *connections.approximations;
+  const size_t index = sector++;
+  const auto& current = connections.sectors[index];
+
+  // This follows SaddleConnectionsInteger::start().
+  const HalfEdge e = current.source;
+
+  if (surface.boundary(e))
+    return false;
+
+  const HalfEdge nextEdge = surface.nextInFace(e);
+
+  DoubleApproximation end = approximations[e];
+  end += approximations[nextEdge];
+
+  trails.push_back({e, nextEdge, static_cast<uint32_t>(-1)});
+  const auto path = static_cast<uint32_t>(trails.size() - 1);
+
+  Frame frame{index, {{approximations[e], Boundary::Kind::HALF_EDGE, e, 0}, {end, Boundary::Kind::TRAIL, HalfEdge(), path}}, nextEdge, end, path};
+
+  if (current.sector) {
+    frame.boundary[0] = {DoubleApproximation(static_cast<Vector<exactreal::Arb>>(current.sector->first)), Boundary::Kind::SECTOR_BEGIN, HalfEdge(), 0};
+    frame.boundary[1] = {DoubleApproximation(static_cast<Vector<exactreal::Arb>>(current.sector->second)), Boundary::Kind::SECTOR_END, HalfEdge(), 0};
+  }
+
+  bool initial = false;
+  if (current.contains(SaddleConnection(surface, e))) {
+    if (!frame.boundary[0].exclusive())
+      frame.boundary[0] = {approximations[e], Boundary::Kind::HALF_EDGE, e, 0};
+
+    initial = reported(approximations[e], [&]() { return surface.fromHalfEdge(e); });
+  }
+
+  frames.push_back(frame);
+
+  if (initial) {
+    source = e;
+    target = e;
+    trail = std::nullopt;
+  }
+
+  return initial;
+}
+
+template <typename Surface>
+SaddleConnection<Surface> SaddleConnectionsApproximate<Surface>::connection() const {
+  const auto& surface = *connections.surface;
+
+  if (!trail)
+    return SaddleConnection<Surface>(surface, source);
+
+  Chain<Surface> chain(surface);
+  for (uint32_t t = *trail; t != static_cast<uint32_t>(-1); t = trails[t].parent) {
+    chain += trails[t].a;
+    chain += trails[t].b;
+  }
+
+  return SaddleConnection<Surface>(surface, source, target, std::move(chain));
+}
+
+template <typename Surface>
+Vector<typename Surface::Coordinate> SaddleConnectionsApproximate<Surface>::exact(uint32_t trail) const {
+  const auto& surface = *connections.surface;
+
+  Vector<T> vertex;
+  for (uint32_t t = trail; t != static_cast<uint32_t>(-1); t = trails[t].parent) {
+    vertex += surface.fromHalfEdge(trails[t].a);
+    vertex += surface.fromHalfEdge(trails[t].b);
+  }
+  return vertex;
+}
+
+template <typename Surface>
+Vector<typename Surface::Coordinate> SaddleConnectionsApproximate<Surface>::exact(const Frame& frame, const Boundary& boundary) const {
+  switch (boundary.kind) {
+    case Boundary::Kind::HALF_EDGE:
+      return connections.surface->fromHalfEdge(boundary.halfEdge);
+    case Boundary::Kind::TRAIL:
+      return exact(boundary.trail);
+    case Boundary::Kind::SECTOR_BEGIN:
+      return connections.sectors[frame.sector].sector->first;
+    case Boundary::Kind::SECTOR_END:
+      return connections.sectors[frame.sector].sector->second;
+  }
+  throw std::logic_error("unknown boundary kind");
+}
+
+template <typename Surface>
+CCW SaddleConnectionsApproximate<Surface>::ccw(const Frame& frame, const Boundary& boundary, const DoubleApproximation& vertex, uint32_t trail) const {
+  if (const auto ccw = boundary.approximation.ccw(vertex))
+    return *ccw;
+  return exact(frame, boundary).ccw(exact(trail));
+}
+
+template <typename Surface>
+bool SaddleConnectionsApproximate<Surface>::reported(const DoubleApproximation& vertex, uint32_t trail) const {
+  std::optional<Vector<T>> vector;
+
+  return reported(vertex, [&]() -> const Vector<T>& {
+    if (!vector)
+      vector = exact(trail);
+    return *vector;
+  });
+}
+
+template <typename Surface>
+template <typename Exact>
+bool SaddleConnectionsApproximate<Surface>::reported(const DoubleApproximation& vertex, const Exact& exact) const {
+  if (!within(vertex, radius, *connections.searchRadius, exact))
+    return false;
+
+  return !within(vertex, lowerBound, connections.lowerBound, exact);
+}
+
+template <typename Surface>
+bool SaddleConnectionsApproximate<Surface>::beyond(const Frame& frame) const {
+  const auto& searchRadius = *connections.searchRadius;
+
+  if (within(frame.nextEdgeEnd, radius, searchRadius, [&]() { return exact(frame.trail); }))
+    return false;
+
+  DoubleApproximation start = frame.nextEdgeEnd;
+  start -= (*connections.approximations)[frame.nextEdge];
+
+  return !within(start, radius, searchRadius, [&]() { return exact(frame.trail) - connections.surface->fromHalfEdge(frame.nextEdge); });
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), SaddleConnectionsApproximate, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -0,0 +1,126 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "impl/saddle_connections_best_first.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../flatsurf/bound.hpp"
+#include "../flatsurf/chain.hpp"
+#include "../flatsurf/half_edge_map.hpp"
+#include "../flatsurf/vector.hpp"
+#include "impl/chain.impl.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+SaddleConnectionsBestFirst<Surface>::SaddleConnectionsBestFirst(const ImplementationOf<SaddleConnections<Surface>>& connections) :
+  connections(connections) {
+  if (connections.searchRadius) {
+    // The conversion to double truncates, so we round up twice to get an
+    // upper bound for the radius.
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    radius = std::nextafter(std::sqrt(std::nextafter(connections.searchRadius->squared().get_d(), infinity)), infinity);
+  }
+
+  for (size_t sector = 0; sector < connections.sectors.size(); sector++) {
+    std::optional<SaddleConnection<Surface>> initial;
+    auto start = Crossing::start(connections, sector, initial);
+
+    if (!start)
+      continue;
+
+    if (initial)
+      push(std::move(*initial), (*connections.approximations)[connections.sectors[sector].source]);
+
+    push(std::move(*start), 0);
+  }
+}
+
+template <typename Surface>
+std::optional<SaddleConnection<Surface>> SaddleConnectionsBestFirst<Surface>::next() {
+  while (true) {
+    if (found.empty()) {
+      if (frontier.empty())
+        return std::nullopt;
+    } else if (frontier.empty() || found.top().length <= frontier.top().distance) {
+      // No pending crossing can lead to a shorter saddle connection.
+      auto connection = found.top().connection;
+      found.pop();
+
+      if (connections.searchRadius && connection > *connections.searchRadius) {
+        // Everything that is still pending is even longer.
+        found = {};
+        frontier = {};
+        return std::nullopt;
+      }
+
+      return connection;
+    }
+
+    const Pending pending = frontier.top();
+    frontier.pop();
+
+    auto expansion = Crossing::expand(connections, pending.frontier);
+
+    if (expansion.connection)
+      push(std::move(*expansion.connection), expansion.approximation);
+
+    // Anything beyond the new crossings is also beyond the crossing we just
+    // performed.
+    if (expansion.clockwise)
+      push(std::move(*expansion.clockwise), pending.distance);
+    if (expansion.counterclockwise)
+      push(std::move(*expansion.counterclockwise), pending.distance);
+  }
+}
+
+template <typename Surface>
+void SaddleConnectionsBestFirst<Surface>::push(Frontier&& crossing, double distance) {
+  distance = std::max(distance, DoubleApproximation::lowerDistance(Crossing::startApproximation(connections, crossing), crossing.nextEdgeEndApproximation));
+
+  if (radius && distance > *radius)
+    return;
+
+  frontier.push(Pending{distance, std::move(crossing)});
+}
+
+template <typename Surface>
+void SaddleConnectionsBestFirst<Surface>::push(SaddleConnection<Surface>&& connection, const DoubleApproximation& approximation) {
+  // Connections within the lower bound are never reported, so we do not
+  // need to keep them around.
+  if (!connections.beyondLowerBound(approximation, connection.chain()))
+    return;
+
+  found.push(Found{std::move(connection), approximation.upperLength()});
+}
+
+template <typename Surface>
+bool SaddleConnectionsBestFirst<Surface>::Found::operator>(const Found& rhs) const {
+  return ImplementationOf<Chain<Surface>>::shorter(rhs.connection.chain(), connection.chain());
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), SaddleConnectionsBestFirst, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
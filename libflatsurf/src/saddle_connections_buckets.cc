@@ -0,0 +1,205 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/saddle_connections_buckets.hpp"
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+
+#include "../flatsurf/bound.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connection_records.hpp"
+#include "impl/saddle_connections_buckets.impl.hpp"
+#include "util/assert.ipp"
+
+namespace flatsurf {
+
+template <typename Surface>
+SaddleConnectionsBuckets<Surface>::SaddleConnectionsBuckets(const Surface& surface, std::vector<Bound> bounds) :
+  SaddleConnectionsBuckets(std::vector<SaddleConnectionRecords<Surface>>(bounds.size(), SaddleConnectionRecords<Surface>(surface)), bounds) {}
+
+template <typename Surface>
+SaddleConnectionsBuckets<Surface>::SaddleConnectionsBuckets(std::vector<SaddleConnectionRecords<Surface>> buckets, std::vector<Bound> bounds) :
+  self(spimpl::make_impl<ImplementationOf<SaddleConnectionsBuckets>>(std::move(buckets), std::move(bounds))) {}
+
+template <typename Surface>
+bool SaddleConnectionsBuckets<Surface>::push_back(const SaddleConnection<Surface>& connection) {
+  const size_t bucket = this->bucket(connection);
+  if (bucket == self->bounds.size())
+    return false;
+
+  self->buckets[bucket].push_back(connection);
+  self->add(bucket);
+  return true;
+}
+
+template <typename Surface>
+size_t SaddleConnectionsBuckets<Surface>::bucket(const SaddleConnection<Surface>& connection) const {
+  return static_cast<size_t>(std::partition_point(begin(self->bounds), end(self->bounds), [&](const Bound& bound) {
+    return connection > bound;
+  }) - begin(self->bounds));
+}
+
+template <typename Surface>
+const std::vector<Bound>& SaddleConnectionsBuckets<Surface>::bounds() const {
+  return self->bounds;
+}
+
+template <typename Surface>
+const SaddleConnectionRecords<Surface>& SaddleConnectionsBuckets<Surface>::operator[](size_t bucket) const {
+  CHECK_ARGUMENT(bucket < self->buckets.size(), "no bucket at this position");
+  return self->buckets[bucket];
+}
+
+template <typename Surface>
+size_t SaddleConnectionsBuckets<Surface>::count(Bound bound) const {
+  // The bucket that bound falls into, i.e., the first bucket whose bound is
+  // not below bound.
+  const size_t bucket = static_cast<size_t>(std::partition_point(begin(self->bounds), end(self->bounds), [&](const Bound& b) {
+    return b < bound;
+  }) - begin(self->bounds));
+
+  if (bucket == self->bounds.size())
+    return size();
+
+  const auto& records = self->buckets[bucket];
+
+  size_t count = self->before(bucket);
+
+  if (self->bounds[bucket] == bound)
+    return count + records.size();
+
+  for (size_t i = 0; i < records.size(); i++)
+    if (!(records[i] > bound))
+      count++;
+
+  return count;
+}
+
+template <typename Surface>
+size_t SaddleConnectionsBuckets<Surface>::count(Bound lower, Bound upper) const {
+  if (!(lower < upper))
+    return 0;
+
+  return count(upper) - count(lower);
+}
+
+template <typename Surface>
+std::vector<SaddleConnection<Surface>> SaddleConnectionsBuckets<Surface>::range(Bound lower, Bound upper) const {
+  std::vector<SaddleConnection<Surface>> connections;
+
+  if (!(lower < upper))
+    return connections;
+
+  // The buckets before the bucket that lower falls into only contain
+  // connections of length at most lower.
+  const size_t first = static_cast<size_t>(std::partition_point(begin(self->bounds), end(self->bounds), [&](const Bound& b) {
+    return b < lower;
+  }) - begin(self->bounds));
+
+  for (size_t bucket = first; bucket < self->bounds.size(); bucket++) {
+    const auto& records = self->buckets[bucket];
+
+    // Only the buckets at the ends of the range need to be compared to its
+    // bounds.
+    const bool inner = bucket != first && !(upper < self->bounds[bucket]);
+
+    for (size_t i = 0; i < records.size(); i++) {
+      auto connection = records[i];
+      if (inner || (connection > lower && !(connection > upper)))
+        connections.push_back(std::move(connection));
+    }
+
+    if (!(self->bounds[bucket] < upper))
+      break;
+  }
+
+  return connections;
+}
+
+template <typename Surface>
+size_t SaddleConnectionsBuckets<Surface>::size() const {
+  return self->before(self->buckets.size());
+}
+
+template <typename Surface>
+bool SaddleConnectionsBuckets<Surface>::empty() const {
+  return size() == 0;
+}
+
+template <typename Surface>
+const Surface& SaddleConnectionsBuckets<Surface>::surface() const {
+  return self->buckets.front().surface();
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnectionsBuckets<Surface>>::ImplementationOf(std::vector<SaddleConnectionRecords<Surface>> buckets, std::vector<Bound> bounds) :
+  bounds(std::move(bounds)),
+  buckets(std::move(buckets)),
+  counts(this->bounds.size() + 1) {
+  if (this->bounds.empty())
+    throw std::invalid_argument("buckets need at least one bound");
+
+  for (size_t i = 1; i < this->bounds.size(); i++)
+    if (!(this->bounds[i - 1] < this->bounds[i]))
+      throw std::invalid_argument("bounds of buckets must be strictly increasing");
+
+  if (this->buckets.size() != this->bounds.size())
+    throw std::invalid_argument("there must be one bucket for each bound");
+
+  for (const auto& bucket : this->buckets)
+    if (!(bucket.surface() == this->buckets.front().surface()))
+      throw std::invalid_argument("saddle connections of all buckets must be on the same surface");
+
+  // Build the Fenwick tree of the sizes of the buckets in linear time.
+  for (size_t i = 1; i < counts.size(); i++) {
+    counts[i] += this->buckets[i - 1].size();
+    const size_t parent = i + (i & -i);
+    if (parent < counts.size())
+      counts[parent] += counts[i];
+  }
+}
+
+template <typename Surface>
+void ImplementationOf<SaddleConnectionsBuckets<Surface>>::add(size_t bucket) {
+  for (size_t i = bucket + 1; i < counts.size(); i += i & -i)
+    counts[i]++;
+}
+
+template <typename Surface>
+size_t ImplementationOf<SaddleConnectionsBuckets<Surface>>::before(size_t bucket) const {
+  size_t count = 0;
+  for (size_t i = bucket; i > 0; i -= i & -i)
+    count += counts[i];
+  return count;
+}
+
+template <typename Surface>
+std::ostream& operator<<(std::ostream& os, const SaddleConnectionsBuckets<Surface>& self) {
+  return os << "SaddleConnectionsBuckets(" << self.size() << " connections in " << self.bounds().size() << " buckets)";
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), SaddleConnectionsBuckets, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -18,10 +18,14 @@
  *********************************************************************/
 
 #include <iterator>
+#include <vector>
 
+#include "../flatsurf/latency.hpp"
+#include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/saddle_connections_iterator.hpp"
 #include "../flatsurf/vector.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
+#include "impl/chain.impl.hpp"
 #include "impl/saddle_connections_by_length.impl.hpp"
 #include "impl/saddle_connections_by_length_iterator.impl.hpp"
 #include "util/assert.ipp"
@@ -49,6 +53,15 @@ const SaddleConnection<Surface>& SaddleConnectionsByLengthIterator<Surface>::der
   return self->currents.front();
 }
 
+template <typename Surface>
+std::vector<SaddleConnection<Surface>> SaddleConnectionsByLengthIterator<Surface>::batch(size_t n) {
+  std::vector<SaddleConnection<Surface>> batch;
+  for (; batch.size() < n && !self->connectionsWithinBounds.empty(); increment())
+    batch.push_back(self->connectionsWithinBounds.front());
+
+  return batch;
+}
+
 template <typename Surface>
 bool SaddleConnectionsByLengthIterator<Surface>::equal(const SaddleConnectionsByLengthIterator& rhs) const {
   return self->upperBoundInclusive == rhs.self->upperBoundInclusive && &self->connections == &rhs.self->connections && self->lowerBoundExclusive == rhs.self->lowerBoundExclusive && self->connectionsWithinBounds.size() == rhs.self->connectionsWithinBounds.size();
@@ -64,7 +77,8 @@ ImplementationOf<SaddleConnectionsByLengthIterator<Surface>>::ImplementationOf(c
   connections(connections),
   lowerBoundExclusive(0),
   upperBoundInclusive(0),
-  connectionsWithinBounds() {}
+  connectionsWithinBounds(),
+  search(*connections.self) {}
 
 template <typename Surface>
 void ImplementationOf<SaddleConnectionsByLengthIterator<Surface>>::increment() {
@@ -87,10 +101,51 @@ void ImplementationOf<SaddleConnectionsByLengthIterator<Surface>>::increment() {
     }
 
     // Fill connectionsWithinBounds with all connections between [lowerBoundInclusive, upperBoundExclusive)
-    auto withinBounds = connections.byAngle().bound(upperBoundInclusive).lowerBound(lowerBoundExclusive) | rx::to_vector();
-    std::sort(begin(withinBounds), end(withinBounds), typename Vector<T>::CompareLength());
+    search.searchRadius = connections.bound() ? std::min(*connections.bound(), upperBoundInclusive) : upperBoundInclusive;
+    search.lowerBound = std::max(connections.self->lowerBound, lowerBoundExclusive);
+
+    std::vector<SaddleConnection<Surface>> withinBounds;
+
+    // Report the connections that we had already found with an earlier
+    // search but which were beyond its radius.
+    {
+      std::vector<SaddleConnection<Surface>> beyond;
+      for (auto& connection : postponed.connections) {
+        if (connection > *search.searchRadius)
+          beyond.push_back(std::move(connection));
+        else if (connection > search.lowerBound)
+          withinBounds.push_back(std::move(connection));
+      }
+      postponed.connections = std::move(beyond);
+    }
+
+    const auto collect = [&](ImplementationOf<SaddleConnectionsIterator<Surface>>&& iterator) {
+      while (iterator.sector != iterator.end) {
+        withinBounds.push_back(iterator.dereference());
+        while (!iterator.increment())
+          ;
+      }
+    };
+
+    if (lowerBoundExclusive == 0) {
+      // Run the initial search from scratch.
+      collect(ImplementationOf<SaddleConnectionsIterator<Surface>>(search, search.sectors.begin(), search.sectors.end(), &postponed));
+    } else {
+      // Continue the search where the previous search stopped at its radius.
+      auto frontier = std::move(postponed.frontier);
+      postponed.frontier.clear();
+      for (const auto& subtree : frontier)
+        collect(ImplementationOf<SaddleConnectionsIterator<Surface>>(search, subtree, &postponed));
+    }
+
+    std::sort(begin(withinBounds), end(withinBounds), [](const auto& lhs, const auto& rhs) {
+      return ImplementationOf<Chain<Surface>>::shorter(lhs.chain(), rhs.chain());
+    });
 
     std::copy(rbegin(withinBounds), rend(withinBounds), std::back_inserter(connectionsWithinBounds));
+
+    found += withinBounds.size();
+    Latency::global().report("SaddleConnectionsByLength", found);
   }
 }
 
@@ -99,4 +154,4 @@ void ImplementationOf<SaddleConnectionsByLengthIterator<Surface>>::increment() {
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), SaddleConnectionsByLengthIterator, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), SaddleConnectionsByLengthIterator, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
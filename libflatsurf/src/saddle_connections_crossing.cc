@@ -0,0 +1,188 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "impl/saddle_connections_crossing.hpp"
+
+#include <exact-real/arb.hpp>
+#include <stdexcept>
+#include <variant>
+
+#include "../flatsurf/ccw.hpp"
+#include "../flatsurf/chain.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/half_edge_map.hpp"
+#include "../flatsurf/vector.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+std::optional<typename SaddleConnectionsCrossing<Surface>::Frontier> SaddleConnectionsCrossing<Surface>::start(const ImplementationOf<SaddleConnections<Surface>>& connections, size_t index, std::optional<SaddleConnection<Surface>>& initial) {
+  const auto& surface = *connections.surface;
+  const auto& approximations = *connections.approximations;
+  const auto& sector = connections.sectors[index];
+
+  initial = std::nullopt;
+
+  // This follows ImplementationOf<SaddleConnectionsIterator>::prepareSearch().
+  const HalfEdge e = sector.source;
+
+  if (surface.boundary(e))
+    return std::nullopt;
+
+  const HalfEdge nextEdge = surface.nextInFace(e);
+
+  Frontier frontier{index, {Chain(surface) + e, (Chain(surface) + e) + nextEdge}, {approximations[e], approximations[e]}, nextEdge, (Chain(surface) + e) + nextEdge, approximations[e]};
+  frontier.boundaryApproximation[1] += approximations[nextEdge];
+  frontier.nextEdgeEndApproximation += approximations[nextEdge];
+
+  if (sector.sector) {
+    frontier.boundary[0] = sector.sector->first;
+    frontier.boundaryApproximation[0] = DoubleApproximation(static_cast<Vector<exactreal::Arb>>(sector.sector->first));
+    frontier.boundary[1] = sector.sector->second;
+    frontier.boundaryApproximation[1] = DoubleApproximation(static_cast<Vector<exactreal::Arb>>(sector.sector->second));
+  }
+
+  auto connection = SaddleConnection(surface, e);
+  if (sector.contains(connection)) {
+    if (std::holds_alternative<Vector<T>>(frontier.boundary[0])) {
+      frontier.boundary[0] = Chain(surface) + e;
+      frontier.boundaryApproximation[0] = approximations[e];
+    }
+    initial = std::move(connection);
+  }
+
+  return frontier;
+}
+
+template <typename Surface>
+typename SaddleConnectionsCrossing<Surface>::Expansion SaddleConnectionsCrossing<Surface>::expand(const ImplementationOf<SaddleConnections<Surface>>& connections, const Frontier& from) {
+  const auto& surface = *connections.surface;
+  const auto& approximations = *connections.approximations;
+
+  Expansion expansion;
+
+  // The half edge we are crossing as seen from the other side.
+  const HalfEdge across = -from.nextEdge;
+
+  if (surface.boundary(across))
+    return expansion;
+
+  // The edges of the triangle on the other side, from the start of the
+  // crossed half edge to the new vertex and from there to its end.
+  const HalfEdge first = surface.nextInFace(across);
+  const HalfEdge second = surface.nextInFace(first);
+
+  Chain<Surface> vertex = from.nextEdgeEnd;
+  vertex += across;
+  vertex += first;
+
+  DoubleApproximation& approximation = expansion.approximation;
+  approximation = from.nextEdgeEndApproximation;
+  approximation += approximations[across];
+  approximation += approximations[first];
+
+  // Classify the new vertex just like ImplementationOf<SaddleConnectionsIterator>::classifyHalfEdgeEnd() does.
+  auto classification = Search::Classification::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE;
+  switch (ccw(from, 0, vertex, approximation)) {
+    case CCW::CLOCKWISE:
+      classification = Search::Classification::OUTSIDE_SEARCH_SECTOR_CLOCKWISE;
+      break;
+    case CCW::COLLINEAR:
+      if (std::holds_alternative<Chain<Surface>>(from.boundary[0]))
+        classification = Search::Classification::OUTSIDE_SEARCH_SECTOR_CLOCKWISE;
+      else
+        classification = Search::Classification::SADDLE_CONNECTION;
+      break;
+    case CCW::COUNTERCLOCKWISE:
+      if (ccw(from, 1, vertex, approximation) == CCW::CLOCKWISE)
+        classification = Search::Classification::SADDLE_CONNECTION;
+      break;
+  }
+
+  switch (classification) {
+    case Search::Classification::OUTSIDE_SEARCH_SECTOR_CLOCKWISE:
+      // Only the half edge from the vertex to the end can lead back into
+      // the search sector.
+      expansion.counterclockwise = from;
+      expansion.counterclockwise->nextEdge = second;
+      return expansion;
+    case Search::Classification::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE:
+      // Only the half edge from the start to the vertex can lead back into
+      // the search sector.
+      expansion.clockwise = from;
+      expansion.clockwise->nextEdge = first;
+      expansion.clockwise->nextEdgeEnd = std::move(vertex);
+      expansion.clockwise->nextEdgeEndApproximation = approximation;
+      return expansion;
+    case Search::Classification::SADDLE_CONNECTION: {
+      // Split the search sector at the saddle connection and shrink it in
+      // the same way as the depth-first search of the iterator does.
+      Frontier clockwise = from;
+      if (std::holds_alternative<Vector<T>>(clockwise.boundary[0]) && std::get<Vector<T>>(clockwise.boundary[0]).ccw(vertex) == CCW::COLLINEAR) {
+        clockwise.boundary[0] = vertex;
+        clockwise.boundaryApproximation[0] = approximation;
+      }
+
+      Frontier counterclockwise = clockwise;
+
+      if (std::holds_alternative<Chain<Surface>>(clockwise.boundary[1]) || std::get<Vector<T>>(clockwise.boundary[1]).ccw(vertex) != CCW::COUNTERCLOCKWISE) {
+        clockwise.boundary[1] = vertex;
+        clockwise.boundaryApproximation[1] = approximation;
+      }
+      clockwise.nextEdge = first;
+      clockwise.nextEdgeEnd = vertex;
+      clockwise.nextEdgeEndApproximation = approximation;
+
+      if (std::holds_alternative<Chain<Surface>>(counterclockwise.boundary[0]) || std::get<Vector<T>>(counterclockwise.boundary[0]).ccw(vertex) != CCW::CLOCKWISE) {
+        counterclockwise.boundary[0] = vertex;
+        counterclockwise.boundaryApproximation[0] = approximation;
+      }
+      counterclockwise.nextEdge = second;
+
+      expansion.connection = SaddleConnection<Surface>(surface, connections.sectors[from.sector].source, surface.previousAtVertex(-first), std::move(vertex));
+      expansion.clockwise = std::move(clockwise);
+      expansion.counterclockwise = std::move(counterclockwise);
+      return expansion;
+    }
+    default:
+      throw std::logic_error("unknown classification result");
+  }
+}
+
+template <typename Surface>
+DoubleApproximation SaddleConnectionsCrossing<Surface>::startApproximation(const ImplementationOf<SaddleConnections<Surface>>& connections, const Frontier& frontier) {
+  DoubleApproximation start = frontier.nextEdgeEndApproximation;
+  start -= (*connections.approximations)[frontier.nextEdge];
+  return start;
+}
+
+template <typename Surface>
+CCW SaddleConnectionsCrossing<Surface>::ccw(const Frontier& frontier, int side, const Chain<Surface>& vertex, const DoubleApproximation& approximation) {
+  const auto ccw = frontier.boundaryApproximation[side].ccw(approximation);
+  if (ccw)
+    return *ccw;
+  return Search::ccw(frontier.boundary[side], vertex);
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), SaddleConnectionsCrossing, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -0,0 +1,93 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "impl/saddle_connections_depth_first.hpp"
+
+#include "../flatsurf/bound.hpp"
+#include "../flatsurf/chain.hpp"
+
+namespace flatsurf {
+
+template <typename Surface>
+SaddleConnectionsDepthFirst<Surface>::SaddleConnectionsDepthFirst(const ImplementationOf<SaddleConnections<Surface>>& connections) :
+  connections(connections) {}
+
+template <typename Surface>
+std::optional<SaddleConnection<Surface>> SaddleConnectionsDepthFirst<Surface>::next() {
+  while (true) {
+    if (frames.empty()) {
+      if (sector == connections.sectors.size())
+        return std::nullopt;
+
+      std::optional<SaddleConnection<Surface>> initial;
+      auto start = Crossing::start(connections, sector++, initial);
+
+      if (!start)
+        continue;
+
+      frames.push_back(std::move(*start));
+
+      if (initial && reported(*initial, (*connections.approximations)[initial->source()]))
+        return initial;
+
+      continue;
+    }
+
+    const Frontier frame = std::move(frames.back());
+    frames.pop_back();
+
+    auto expansion = Crossing::expand(connections, frame);
+
+    // The clockwise part is searched first, so it goes on top of the stack.
+    if (expansion.counterclockwise && !beyond(*expansion.counterclockwise))
+      frames.push_back(std::move(*expansion.counterclockwise));
+    if (expansion.clockwise && !beyond(*expansion.clockwise))
+      frames.push_back(std::move(*expansion.clockwise));
+
+    if (expansion.connection && reported(*expansion.connection, expansion.approximation))
+      return std::move(expansion.connection);
+  }
+}
+
+template <typename Surface>
+bool SaddleConnectionsDepthFirst<Surface>::reported(const SaddleConnection<Surface>& connection, const DoubleApproximation& approximation) const {
+  if (connections.searchRadius && connection > *connections.searchRadius)
+    return false;
+  return connections.beyondLowerBound(approximation, connection.chain());
+}
+
+template <typename Surface>
+bool SaddleConnectionsDepthFirst<Surface>::beyond(const Frontier& frame) const {
+  if (!connections.searchRadius)
+    return false;
+
+  if (!(frame.nextEdgeEnd > *connections.searchRadius))
+    return false;
+
+  Chain<Surface> start = frame.nextEdgeEnd;
+  start -= frame.nextEdge;
+  return start > *connections.searchRadius;
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), SaddleConnectionsDepthFirst, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -0,0 +1,154 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#include "../flatsurf/saddle_connections_index.hpp"
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+
+#include "../flatsurf/bound.hpp"
+#include "../flatsurf/ccw.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connections.hpp"
+#include "../flatsurf/saddle_connections_iterator.hpp"
+#include "../flatsurf/vector.hpp"
+#include "impl/saddle_connections.impl.hpp"
+#include "impl/saddle_connections_index.impl.hpp"
+#include "util/assert.ipp"
+
+namespace flatsurf {
+
+template <typename Surface>
+SaddleConnectionsIndex<Surface>::SaddleConnectionsIndex(const Surface& surface, Bound radius) :
+  self(spimpl::make_impl<ImplementationOf<SaddleConnectionsIndex>>(surface, radius)) {}
+
+template <typename Surface>
+std::vector<SaddleConnection<Surface>> SaddleConnectionsIndex<Surface>::sector(const Vector<T>& sectorBegin, const Vector<T>& sectorEnd) const {
+  return sector(sectorBegin, sectorEnd, self->radius);
+}
+
+template <typename Surface>
+std::vector<SaddleConnection<Surface>> SaddleConnectionsIndex<Surface>::sector(const Vector<T>& sectorBegin, const Vector<T>& sectorEnd, Bound bound) const {
+  std::vector<SaddleConnection<Surface>> connections;
+
+  if (self->radius < bound) {
+    for (const auto& connection : SaddleConnections<Surface>(*self->surface).bound(bound).sector(sectorBegin, sectorEnd))
+      connections.push_back(connection);
+    return connections;
+  }
+
+  const auto& surface = *self->surface;
+
+  using Sector = typename ImplementationOf<SaddleConnections<Surface>>::Sector;
+  std::vector<Sector> sectors;
+
+  for (const auto source : surface.halfEdges()) {
+    const auto& sorted = self->sectors[source.index()];
+    if (sorted.empty())
+      continue;
+
+    sectors.clear();
+    Sector(source).refine(surface, sectorBegin, sectorEnd, sectors);
+    for (const auto& refined : sectors) {
+      const auto [begin, end] = refined.sector ? self->range(source, refined.sector->first, refined.sector->second) : std::pair{size_t{0}, sorted.size()};
+
+      for (size_t i = begin; i != end; i++)
+        if (!(sorted[i] > bound))
+          connections.push_back(sorted[i]);
+    }
+  }
+
+  return connections;
+}
+
+template <typename Surface>
+const std::vector<SaddleConnection<Surface>>& SaddleConnectionsIndex<Surface>::sector(HalfEdge sectorBegin) const {
+  return self->sectors[sectorBegin.index()];
+}
+
+template <typename Surface>
+Bound SaddleConnectionsIndex<Surface>::radius() const {
+  return self->radius;
+}
+
+template <typename Surface>
+size_t SaddleConnectionsIndex<Surface>::size() const {
+  return self->size;
+}
+
+template <typename Surface>
+const Surface& SaddleConnectionsIndex<Surface>::surface() const {
+  return *self->surface;
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnectionsIndex<Surface>>::ImplementationOf(const Surface& surface, Bound radius) :
+  surface(surface),
+  radius(radius),
+  sectors(surface.halfEdges().size()) {
+  if (surface.hasBoundary())
+    throw std::logic_error("not implemented: cannot index saddle connections on a surface with boundary");
+
+  for (const auto& connection : SaddleConnections<Surface>(surface).bound(radius)) {
+    sectors[connection.source().index()].push_back(connection);
+    size++;
+  }
+
+  // Each sector is contained in a face, so it has an angle of less than π
+  // and its saddle connections are totally ordered by ccw(); there are no
+  // two saddle connections in the same direction in a sector.
+  for (auto& sector : sectors)
+    std::sort(begin(sector), end(sector), [](const auto& lhs, const auto& rhs) {
+      return lhs.vector().ccw(rhs.vector()) == CCW::COUNTERCLOCKWISE;
+    });
+}
+
+template <typename Surface>
+std::pair<size_t, size_t> ImplementationOf<SaddleConnectionsIndex<Surface>>::range(HalfEdge source, const Vector<T>& sectorBegin, const Vector<T>& sectorEnd) const {
+  const auto& sorted = sectors[source.index()];
+
+  // Return the first position whose direction is not strictly before the
+  // direction of v.
+  const auto position = [&](const Vector<T>& v) {
+    return static_cast<size_t>(std::partition_point(begin(sorted), end(sorted), [&](const auto& connection) {
+      return connection.vector().ccw(v) == CCW::COUNTERCLOCKWISE;
+    }) - begin(sorted));
+  };
+
+  // Since the sector is contained in a face, a sectorEnd at the following
+  // half edge comes after all the connections in the sector.
+  const size_t first = position(sectorBegin);
+  return {first, std::max(first, position(sectorEnd))};
+}
+
+template <typename Surface>
+std::ostream& operator<<(std::ostream& os, const SaddleConnectionsIndex<Surface>& self) {
+  return os << "SaddleConnectionsIndex(" << self.size() << " connections of length at most " << self.radius() << ")";
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), SaddleConnectionsIndex, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -0,0 +1,292 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#include "impl/saddle_connections_integer.hpp"
+
+#include <cstdlib>
+#include <type_traits>
+
+#include "../flatsurf/bound.hpp"
+#include "../flatsurf/chain.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/vector.hpp"
+#include "impl/flat_triangulation.impl.hpp"
+
+namespace flatsurf {
+
+namespace {
+
+// Coordinates of the half edges and the search radius must be below this
+// bound, so that the vertices that the search visits are in absolute value
+// below 2^32 and their squared lengths fit comfortably into 128 bits.
+constexpr long long MAX_COORDINATE = 1ll << 30;
+
+}  // namespace
+
+template <typename Surface>
+SaddleConnectionsInteger<Surface>::SaddleConnectionsInteger(const ImplementationOf<SaddleConnections<Surface>>& connections) :
+  connections(connections),
+  radius(*connections.searchRadius->machineSquared()),
+  lowerBound(*connections.lowerBound.machineSquared()) {}
+
+template <typename Surface>
+bool SaddleConnectionsInteger<Surface>::applicable(const ImplementationOf<SaddleConnections<Surface>>& connections) {
+  using T = typename Surface::Coordinate;
+
+  if constexpr (!std::is_same_v<T, long long>) {
+    return false;
+  } else {
+    if (!connections.searchRadius)
+      return false;
+
+    const auto radius = connections.searchRadius->machineSquared();
+    if (!radius || *radius >= MAX_COORDINATE * MAX_COORDINATE)
+      return false;
+
+    if (!connections.lowerBound.machineSquared())
+      return false;
+
+    const auto& columns = ImplementationOf<FlatTriangulation<T>>::coordinates(*connections.surface);
+    for (size_t i = 0; i < columns.size(); i++)
+      if (std::llabs(columns.x[i]) >= MAX_COORDINATE || std::llabs(columns.y[i]) >= MAX_COORDINATE)
+        return false;
+
+    return true;
+  }
+}
+
+template <typename Surface>
+bool SaddleConnectionsInteger<Surface>::next() {
+  const auto& surface = *connections.surface;
+
+  while (true) {
+    if (frames.empty()) {
+      trails.clear();
+
+      if (sector == connections.sectors.size())
+        return false;
+
+      if (start())
+        return true;
+
+      continue;
+    }
+
+    const Frame from = frames.back();
+    frames.pop_back();
+
+    // This follows SaddleConnectionsCrossing::expand().
+    const HalfEdge across = -from.nextEdge;
+
+    if (surface.boundary(across))
+      continue;
+
+    const HalfEdge first = surface.nextInFace(across);
+    const HalfEdge second = surface.nextInFace(first);
+
+    const Point a = vector(across);
+    const Point b = vector(first);
+    const Point vertex{from.nextEdgeEnd.x + a.x + b.x, from.nextEdgeEnd.y + a.y + b.y};
+
+    bool clockwiseOfSector = false;
+    bool counterclockwiseOfSector = true;
+    switch (ccw(from.boundary[0], vertex)) {
+      case CCW::CLOCKWISE:
+        clockwiseOfSector = true;
+        break;
+      case CCW::COLLINEAR:
+        if (from.exclusive[0])
+          clockwiseOfSector = true;
+        else
+          counterclockwiseOfSector = false;
+        break;
+      case CCW::COUNTERCLOCKWISE:
+        if (ccw(from.boundary[1], vertex) == CCW::CLOCKWISE)
+          counterclockwiseOfSector = false;
+        break;
+    }
+
+    if (clockwiseOfSector) {
+      Frame counterclockwise = from;
+      counterclockwise.nextEdge = second;
+      if (!beyond(counterclockwise))
+        frames.push_back(counterclockwise);
+      continue;
+    }
+
+    trails.push_back({across, first, from.trail});
+
+    if (counterclockwiseOfSector) {
+      Frame clockwise = from;
+      clockwise.nextEdge = first;
+      clockwise.nextEdgeEnd = vertex;
+      clockwise.trail = static_cast<uint32_t>(trails.size() - 1);
+      if (!beyond(clockwise))
+        frames.push_back(clockwise);
+      continue;
+    }
+
+    // Split the search sector at the saddle connection.
+    Frame clockwise = from;
+    if (!clockwise.exclusive[0] && ccw(clockwise.boundary[0], vertex) == CCW::COLLINEAR) {
+      clockwise.boundary[0] = vertex;
+      clockwise.exclusive[0] = true;
+    }
+
+    Frame counterclockwise = clockwise;
+
+    if (clockwise.exclusive[1] || ccw(clockwise.boundary[1], vertex) != CCW::COUNTERCLOCKWISE) {
+      clockwise.boundary[1] = vertex;
+      clockwise.exclusive[1] = true;
+    }
+    clockwise.nextEdge = first;
+    clockwise.nextEdgeEnd = vertex;
+    clockwise.trail = static_cast<uint32_t>(trails.size() - 1);
+
+    if (counterclockwise.exclusive[0] || ccw(counterclockwise.boundary[0], vertex) != CCW::CLOCKWISE) {
+      counterclockwise.boundary[0] = vertex;
+      counterclockwise.exclusive[0] = true;
+    }
+    counterclockwise.nextEdge = second;
+
+    // The clockwise part is searched first, so it goes on top of the stack.
+    if (!beyond(counterclockwise))
+      frames.push_back(counterclockwise);
+    if (!beyond(clockwise))
+      frames.push_back(clockwise);
+
+    if (reported(vertex)) {
+      source = connections.sectors[from.sector].source;
+      target = surface.previousAtVertex(-first);
+      trail = clockwise.trail;
+      return true;
+    }
+  }
+}
+
+template <typename Surface>
+bool SaddleConnectionsInteger<Surface>::start() {
+  const auto& surface = *connections.surface;
+  const size_t index = sector++;
+  const auto& current = connections.sectors[index];
+
+  // This follows SaddleConnectionsCrossing::start().
+  const HalfEdge e = current.source;
+
+  if (surface.boundary(e))
+    return false;
+
+  const HalfEdge nextEdge = surface.nextInFace(e);
+
+  const Point a = vector(e);
+  const Point b = vector(nextEdge);
+  const Point end{a.x + b.x, a.y + b.y};
+
+  trails.push_back({e, nextEdge, static_cast<uint32_t>(-1)});
+
+  Frame frame{index, {a, end}, {true, true}, nextEdge, end, static_cast<uint32_t>(trails.size() - 1)};
+
+  if constexpr (std::is_same_v<typename Surface::Coordinate, long long>) {
+    if (current.sector) {
+      frame.boundary[0] = Point{current.sector->first.x(), current.sector->first.y()};
+      frame.boundary[1] = Point{current.sector->second.x(), current.sector->second.y()};
+      frame.exclusive[0] = false;
+      frame.exclusive[1] = false;
+    }
+  }
+
+  bool initial = false;
+  if (current.contains(SaddleConnection(surface, e))) {
+    if (!frame.exclusive[0]) {
+      frame.boundary[0] = a;
+      frame.exclusive[0] = true;
+    }
+    initial = reported(a);
+  }
+
+  frames.push_back(frame);
+
+  if (initial) {
+    source = e;
+    target = e;
+    trail = std::nullopt;
+  }
+
+  return initial;
+}
+
+template <typename Surface>
+SaddleConnection<Surface> SaddleConnectionsInteger<Surface>::connection() const {
+  const auto& surface = *connections.surface;
+
+  if (!trail)
+    return SaddleConnection<Surface>(surface, source);
+
+  Chain<Surface> chain(surface);
+  for (uint32_t t = *trail; t != static_cast<uint32_t>(-1); t = trails[t].parent) {
+    chain += trails[t].a;
+    chain += trails[t].b;
+  }
+
+  return SaddleConnection<Surface>(surface, source, target, std::move(chain));
+}
+
+template <typename Surface>
+typename SaddleConnectionsInteger<Surface>::Point SaddleConnectionsInteger<Surface>::vector(HalfEdge he) const {
+  const auto& columns = ImplementationOf<FlatTriangulation<typename Surface::Coordinate>>::coordinates(*connections.surface);
+  return Point{columns.x[he.index()], columns.y[he.index()]};
+}
+
+template <typename Surface>
+bool SaddleConnectionsInteger<Surface>::reported(const Point& vertex) const {
+  const __int128 length = norm(vertex);
+  return length <= radius && length > lowerBound;
+}
+
+template <typename Surface>
+bool SaddleConnectionsInteger<Surface>::beyond(const Frame& frame) const {
+  if (!(norm(frame.nextEdgeEnd) > radius))
+    return false;
+
+  const Point edge = vector(frame.nextEdge);
+  return norm(Point{frame.nextEdgeEnd.x - edge.x, frame.nextEdgeEnd.y - edge.y}) > radius;
+}
+
+template <typename Surface>
+CCW SaddleConnectionsInteger<Surface>::ccw(const Point& boundary, const Point& vertex) {
+  const __int128 cross = static_cast<__int128>(boundary.x) * vertex.y - static_cast<__int128>(boundary.y) * vertex.x;
+  if (cross > 0)
+    return CCW::COUNTERCLOCKWISE;
+  if (cross < 0)
+    return CCW::CLOCKWISE;
+  return CCW::COLLINEAR;
+}
+
+template <typename Surface>
+__int128 SaddleConnectionsInteger<Surface>::norm(const Point& vector) {
+  return static_cast<__int128>(vector.x) * vector.x + static_cast<__int128>(vector.y) * vector.y;
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), SaddleConnectionsInteger, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -19,39 +19,140 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <exact-real/arb.hpp>
 #include <optional>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include "../flatsurf/chain.hpp"
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/exact_fallbacks.hpp"
 #include "../flatsurf/fmt.hpp"
 #include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connection_records.hpp"
+#include "../flatsurf/saddle_connections_iterator_checkpoint.hpp"
+#include "../flatsurf/saddle_connections_statistics.hpp"
 #include "../flatsurf/vector.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
+#include "impl/chain.impl.hpp"
+#include "impl/exact_fallbacks.impl.hpp"
 #include "impl/saddle_connections.impl.hpp"
 #include "impl/saddle_connections_iterator.impl.hpp"
 #include "util/assert.ipp"
+#include "util/trace.ipp"
 
 namespace flatsurf {
 
 using std::vector;
 
 template <typename Surface>
-ImplementationOf<SaddleConnectionsIterator<Surface>>::ImplementationOf(const ImplementationOf<SaddleConnections<Surface>>& connections, const typename vector<Sector>::const_iterator begin, const typename vector<Sector>::const_iterator end) :
+ImplementationOf<SaddleConnectionsIterator<Surface>>::ImplementationOf(const ImplementationOf<SaddleConnections<Surface>>& connections, const typename vector<Sector>::const_iterator begin, const typename vector<Sector>::const_iterator end, Postponed* postponed) :
   connections(connections),
+  surface(ReadOnly<Surface>::borrow(connections.surface)),
   sector(begin),
   end(end),
   boundary{Vector<T>(), Vector<T>()},
-  nextEdgeEnd(connections.surface),
-  connection(SaddleConnection(*connections.surface, connections.surface->halfEdges()[0])) {
+  nextEdgeEnd(*surface),
+  connection(SaddleConnection(*connections.surface, connections.surface->halfEdges()[0])),
+  postponed(postponed),
+  statistics(connections.statistics) {
   prepareSearch();
 }
 
+template <typename Surface>
+ImplementationOf<SaddleConnectionsIterator<Surface>>::ImplementationOf(const ImplementationOf<SaddleConnections<Surface>>& connections, const Frontier& frontier, Postponed* postponed) :
+  connections(connections),
+  surface(ReadOnly<Surface>::borrow(connections.surface)),
+  sector(connections.sectors.begin() + static_cast<std::ptrdiff_t>(frontier.sector)),
+  end(sector + 1),
+  boundary{frontier.boundary[0], frontier.boundary[1]},
+  nextEdge(frontier.nextEdge),
+  nextEdgeEnd(frontier.nextEdgeEnd),
+  boundaryApproximation{frontier.boundaryApproximation[0], frontier.boundaryApproximation[1]},
+  nextEdgeEndApproximation(frontier.nextEdgeEndApproximation),
+  connection(SaddleConnection(*connections.surface, connections.surface->halfEdges()[0])),
+  postponed(postponed),
+  statistics(connections.statistics) {
+  Chain<Surface> nextEdgeStart = nextEdgeEnd;
+  nextEdgeStart -= nextEdge;
+
+  state.push_back(State::END);
+  pushStart(connections.searchRadius && nextEdgeStart > *connections.searchRadius, connections.searchRadius && nextEdgeEnd > *connections.searchRadius);
+
+  while (!increment())
+    ;
+}
+
+template <typename Surface>
+ImplementationOf<SaddleConnectionsIterator<Surface>>::ImplementationOf(const ImplementationOf<SaddleConnections<Surface>>& connections, const SaddleConnectionsIteratorCheckpoint<Surface>& checkpoint) :
+  connections(connections),
+  surface(ReadOnly<Surface>::borrow(connections.surface)),
+  sector(connections.sectors.begin() + static_cast<std::ptrdiff_t>(checkpoint.sector)),
+  end(connections.sectors.end()),
+  boundary{Vector<T>(), Vector<T>()},
+  nextEdgeEnd(*surface),
+  connection(SaddleConnection(*connections.surface, connections.surface->halfEdges()[0])),
+  postponed(nullptr),
+  statistics(connections.statistics) {
+  if (sector == end)
+    return;
+
+  const auto restore = [&](const Boundary& boundary) -> Boundary {
+    if (std::holds_alternative<Chain<Surface>>(boundary))
+      return rebase(std::get<Chain<Surface>>(boundary));
+    return boundary;
+  };
+
+  for (int side = 0; side < 2; side++) {
+    boundary[side] = restore(checkpoint.boundaries[static_cast<size_t>(side)]);
+    boundaryApproximation[side] = approximate(boundary[side]);
+  }
+
+  for (size_t i = 2; i < checkpoint.boundaries.size(); i++) {
+    tmp.push(restore(checkpoint.boundaries[i]));
+    tmpApproximation.push(approximate(tmp.top()));
+  }
+
+  nextEdge = checkpoint.nextEdge;
+  nextEdgeEnd = rebase(*checkpoint.nextEdgeEnd);
+
+  // The approximation of nextEdgeEnd is not the same as the one we had
+  // accumulated before the checkpoint. But since these approximations only
+  // filter the exact predicates, the search proceeds in exactly the same way.
+  nextEdgeEndApproximation = DoubleApproximation(static_cast<const Vector<exactreal::Arb>&>(nextEdgeEnd));
+
+  for (const auto s : checkpoint.state)
+    state.push_back(static_cast<State>(s));
+}
+
+template <typename Surface>
+Chain<Surface> ImplementationOf<SaddleConnectionsIterator<Surface>>::rebase(const Chain<Surface>& chain) const {
+  Chain<Surface> rebased(*surface);
+  for (const auto& edge : surface->edges())
+    if (chain[edge] != 0)
+      rebased += (Chain<Surface>(*surface, edge.positive()) *= chain[edge]);
+  return rebased;
+}
+
+template <typename Surface>
+DoubleApproximation ImplementationOf<SaddleConnectionsIterator<Surface>>::approximate(const Boundary& boundary) {
+  return std::visit([](const auto& b) {
+    using B = std::decay_t<decltype(b)>;
+    if constexpr (std::is_same_v<B, Chain<Surface>>)
+      return DoubleApproximation(static_cast<const Vector<exactreal::Arb>&>(b));
+    else
+      return DoubleApproximation(static_cast<Vector<exactreal::Arb>>(b));
+  },
+      boundary);
+}
+
 template <typename Surface>
 void ImplementationOf<SaddleConnectionsIterator<Surface>>::prepareSearch() {
   assert(state.size() == 0);
   assert(tmp.size() == 0);
+  assert(tmpApproximation.size() == 0);
   assert(moves.size() == 0);
 
   if (sector == end)
@@ -65,25 +166,41 @@ void ImplementationOf<SaddleConnectionsIterator<Surface>>::prepareSearch() {
     return;
   }
 
-  boundary[0] = Chain(*connections.surface) + e;
-  if (sector->sector)
+  const auto& approximations = *connections.approximations;
+
+  boundary[0] = Chain(*surface) + e;
+  boundaryApproximation[0] = approximations[e];
+  if (sector->sector) {
     boundary[0] = sector->sector->first;
+    boundaryApproximation[0] = DoubleApproximation(static_cast<Vector<exactreal::Arb>>(sector->sector->first));
+  }
 
   nextEdge = connections.surface->nextInFace(e);
-  boundary[1] = Chain(*connections.surface) + e + nextEdge;
-  if (sector->sector)
+  boundary[1] = Chain(*surface) + e + nextEdge;
+  boundaryApproximation[1] = approximations[e];
+  boundaryApproximation[1] += approximations[nextEdge];
+  if (sector->sector) {
     boundary[1] = sector->sector->second;
+    boundaryApproximation[1] = DoubleApproximation(static_cast<Vector<exactreal::Arb>>(sector->sector->second));
+  }
 
-  nextEdgeEnd = (Chain<Surface>(connections.surface) += e) += nextEdge;
+  nextEdgeEnd = (Chain<Surface>(*surface) += e) += nextEdge;
+  nextEdgeEndApproximation = approximations[e];
+  nextEdgeEndApproximation += approximations[nextEdge];
   state.push_back(State::END);
   state.push_back(State::START_FROM_INSIDE_TO_INSIDE);
+  statistics.record([&](auto& counters) { counters.maximumDepth = std::max(counters.maximumDepth, state.size()); });
 
   // Report the half edge "e" as a saddle connection unless it is outside the
   // search scope.
   const auto initial = SaddleConnection(*connections.surface, e);
-  if (std::holds_alternative<Vector<T>>(boundary[0]) && sector->contains(initial))
-    boundary[0] = Chain(*connections.surface) + e;
-  if ((connections.searchRadius && initial > *connections.searchRadius) || !sector->contains(initial) || initial <= connections.lowerBound) {
+  if (std::holds_alternative<Vector<T>>(boundary[0]) && sector->contains(initial)) {
+    boundary[0] = Chain(*surface) + e;
+    boundaryApproximation[0] = approximations[e];
+  }
+  if (postponed && connections.searchRadius && initial > *connections.searchRadius && sector->contains(initial))
+    postponed->connections.push_back(initial);
+  if ((connections.searchRadius && initial > *connections.searchRadius) || !sector->contains(initial) || !connections.beyondLowerBound(approximations[e], initial.chain())) {
     while (!increment())
       ;
   }
@@ -94,8 +211,17 @@ CCW ImplementationOf<SaddleConnectionsIterator<Surface>>::ccw(const Boundary& lh
   return std::visit([&](const auto& l) {
     using B = std::decay_t<decltype(l)>;
     if constexpr (std::is_same_v<B, Chain<Surface>>) {
-      auto ccw = static_cast<const Vector<exactreal::Arb>&>(l).ccw(static_cast<const Vector<exactreal::Arb>&>(rhs));
-      if (ccw) return *ccw;
+      static const size_t site = ImplementationOf<ExactFallbacks>::site("SaddleConnectionsIterator::ccw");
+
+      const auto approximate = static_cast<const Vector<exactreal::Arb>&>(l).ccw(static_cast<const Vector<exactreal::Arb>&>(rhs));
+      ImplementationOf<Surface>::precision(rhs.surface()).record(static_cast<bool>(approximate));
+      if (approximate) {
+        ImplementationOf<ExactFallbacks>::decided(site);
+        return *approximate;
+      }
+
+      const ImplementationOf<ExactFallbacks>::Fallback fallback(site);
+      return ccw(lhs, static_cast<const Vector<T>&>(rhs));
     }
     return ccw(lhs, static_cast<const Vector<T>&>(rhs));
   },
@@ -115,6 +241,17 @@ CCW ImplementationOf<SaddleConnectionsIterator<Surface>>::ccw(const Boundary& lh
       rhs);
 }
 
+template <typename Surface>
+CCW ImplementationOf<SaddleConnectionsIterator<Surface>>::ccw(int side) const {
+  const auto ccw = boundaryApproximation[side].ccw(nextEdgeEndApproximation);
+  if (ccw) {
+    statistics.record([](auto& counters) { counters.approximatePredicates++; });
+    return *ccw;
+  }
+  statistics.record([](auto& counters) { counters.exactPredicates++; });
+  return ImplementationOf::ccw(boundary[side], nextEdgeEnd);
+}
+
 template <typename Surface>
 bool ImplementationOf<SaddleConnectionsIterator<Surface>>::increment() {
   assert(state.size());
@@ -137,6 +274,7 @@ bool ImplementationOf<SaddleConnectionsIterator<Surface>>::increment() {
     case State::START_FROM_INSIDE_TO_OUTSIDE:
     case State::START_FROM_OUTSIDE_TO_INSIDE:
       moves.push_back(Move::GOTO_OTHER_FACE);
+      statistics.record([](auto& counters) { counters.trianglesCrossed++; });
 
       if (onBoundary()) {
         moves.push_back(Move::GOTO_OTHER_FACE);
@@ -182,40 +320,68 @@ bool ImplementationOf<SaddleConnectionsIterator<Surface>>::increment() {
           pushStart(s == State::START_FROM_OUTSIDE_TO_INSIDE, beyondRadius);
 
           // Shrink the search sector for the clockwise descent.
+          tmpApproximation.push(boundaryApproximation[1]);
           if (std::holds_alternative<Chain<Surface>>(boundary[1]) || std::get<Vector<T>>(boundary[1]).ccw(nextEdgeEnd) != CCW::COUNTERCLOCKWISE) {
             tmp.push(std::move(boundary[1]));
             boundary[1] = nextEdgeEnd;
+            boundaryApproximation[1] = nextEdgeEndApproximation;
+            statistics.record([](auto& counters) { counters.chainCopies++; });
           } else {
             tmp.push(boundary[1]);
           }
           // Exclude sectorBegin from future search if this saddle connections
           // hits it exactly so we hide all future vertices that lie on this
           // line.
-          if (std::holds_alternative<Vector<T>>(boundary[0]) && std::get<Vector<T>>(boundary[0]).ccw(nextEdgeEnd) == CCW::COLLINEAR)
+          if (std::holds_alternative<Vector<T>>(boundary[0]) && std::get<Vector<T>>(boundary[0]).ccw(nextEdgeEnd) == CCW::COLLINEAR) {
             boundary[0] = nextEdgeEnd;
+            boundaryApproximation[0] = nextEdgeEndApproximation;
+            statistics.record([](auto& counters) { counters.chainCopies++; });
+          }
 
           if (beyondRadius) {
+            if (postponed) {
+              postponed->connections.push_back(SaddleConnection<Surface>(connections.surface, sector->source, connections.surface->previousAtVertex(-nextEdge), nextEdgeEnd));
+              statistics.record([](auto& counters) { counters.chainCopies++; });
+            }
             return false;
           } else {
             state.push_back(State::SADDLE_CONNECTION_FOUND);
-            return nextEdgeEnd > connections.lowerBound;
+            return connections.beyondLowerBound(nextEdgeEndApproximation, nextEdgeEnd);
           }
         }
         default:
           throw std::logic_error("unknown classification result");
       }
+    case State::START_FROM_OUTSIDE_TO_OUTSIDE:
+      // Nothing beyond nextEdge is within the search radius. We record where
+      // we are so the search can be continued from here later.
+      assert(postponed && "search can only be recorded when postponing");
+      postponed->frontier.push_back(Frontier{
+          static_cast<size_t>(sector - connections.sectors.begin()),
+          {boundary[0], boundary[1]},
+          {boundaryApproximation[0], boundaryApproximation[1]},
+          nextEdge,
+          nextEdgeEnd,
+          nextEdgeEndApproximation});
+      statistics.record([](auto& counters) { counters.chainCopies++; });
+      return false;
     case State::SADDLE_CONNECTION_FOUND:
       return false;
     case State::SADDLE_CONNECTION_FOUND_SEARCHING_FIRST:
       // We have just come back from the search in the clockwise sector; now
       // we prepare the recursive descend into the counterclockwise sector.
-      boundary[1] = std::move(tmp.top());
+      std::swap(boundary[1], tmp.top());
       tmp.pop();
+      boundaryApproximation[1] = tmpApproximation.top();
+      tmpApproximation.pop();
       applyMoves();
       // Shrink the search sector for the counter-clockwise descent
+      tmpApproximation.push(boundaryApproximation[0]);
       if (std::holds_alternative<Chain<Surface>>(boundary[0]) || std::get<Vector<T>>(boundary[0]).ccw(nextEdgeEnd) != CCW::CLOCKWISE) {
         tmp.push(std::move(boundary[0]));
         boundary[0] = nextEdgeEnd;
+        boundaryApproximation[0] = nextEdgeEndApproximation;
+        statistics.record([](auto& counters) { counters.chainCopies++; });
       } else {
         tmp.push(boundary[0]);
       }
@@ -224,8 +390,10 @@ bool ImplementationOf<SaddleConnectionsIterator<Surface>>::increment() {
     case State::SADDLE_CONNECTION_FOUND_SEARCHING_SECOND:
       // We have just come back from the search in the counterclockwise
       // sector; we are done here and return in the recursion.
-      boundary[0] = std::move(tmp.top());
+      std::swap(boundary[0], tmp.top());
       tmp.pop();
+      boundaryApproximation[0] = tmpApproximation.top();
+      tmpApproximation.pop();
       moves.push_back(Move::GOTO_NEXT_EDGE);
       moves.push_back(Move::GOTO_OTHER_FACE);
       return false;
@@ -267,6 +435,7 @@ void ImplementationOf<SaddleConnectionsIterator<Surface>>::skipSector(CCW sector
           case State::START_FROM_INSIDE_TO_INSIDE:
           case State::START_FROM_INSIDE_TO_OUTSIDE:
           case State::START_FROM_OUTSIDE_TO_INSIDE:
+          case State::START_FROM_OUTSIDE_TO_OUTSIDE:
             state.pop_back();
             break;
           default:
@@ -285,6 +454,7 @@ void ImplementationOf<SaddleConnectionsIterator<Surface>>::skipSector(CCW sector
           case State::START_FROM_INSIDE_TO_INSIDE:
           case State::START_FROM_INSIDE_TO_OUTSIDE:
           case State::START_FROM_OUTSIDE_TO_INSIDE:
+          case State::START_FROM_OUTSIDE_TO_OUTSIDE:
             unchanged.pop();
           default:
             break;
@@ -320,17 +490,22 @@ void ImplementationOf<SaddleConnectionsIterator<Surface>>::skipSector(CCW sector
 
 template <typename Surface>
 void ImplementationOf<SaddleConnectionsIterator<Surface>>::apply(const Move m) {
+  statistics.record([](auto& counters) { counters.appliedMoves++; });
+
   switch (m) {
     case Move::GOTO_NEXT_EDGE:
       nextEdge = connections.surface->nextInFace(nextEdge);
       nextEdgeEnd += nextEdge;
+      nextEdgeEndApproximation += (*connections.approximations)[nextEdge];
       break;
     case Move::GOTO_OTHER_FACE:
       nextEdge = -nextEdge;
       nextEdgeEnd += nextEdge;
+      nextEdgeEndApproximation += (*connections.approximations)[nextEdge];
       break;
     case Move::GOTO_PREVIOUS_EDGE:
       nextEdgeEnd -= nextEdge;
+      nextEdgeEndApproximation -= (*connections.approximations)[nextEdge];
       nextEdge = connections.surface->nextAtVertex(nextEdge);
       nextEdge = -nextEdge;
       break;
@@ -353,6 +528,8 @@ void ImplementationOf<SaddleConnectionsIterator<Surface>>::applyMoves() {
     const auto n = moves.front();
     moves.pop_front();
 
+    statistics.record([](auto& counters) { counters.combinedMoves++; });
+
     switch (m) {
       case Move::GOTO_NEXT_EDGE:
         switch (n) {
@@ -404,8 +581,9 @@ void ImplementationOf<SaddleConnectionsIterator<Surface>>::applyMoves() {
 
 template <typename Surface>
 typename ImplementationOf<SaddleConnectionsIterator<Surface>>::Classification ImplementationOf<SaddleConnectionsIterator<Surface>>::classifyHalfEdgeEnd() {
+  statistics.record([](auto& counters) { counters.classifications++; });
   applyMoves();
-  switch (ccw(boundary[0], nextEdgeEnd)) {
+  switch (ccw(0)) {
     case CCW::CLOCKWISE:
       return Classification::OUTSIDE_SEARCH_SECTOR_CLOCKWISE;
     case CCW::COLLINEAR:
@@ -414,7 +592,7 @@ typename ImplementationOf<SaddleConnectionsIterator<Surface>>::Classification Im
       else
         return Classification::SADDLE_CONNECTION;
     case CCW::COUNTERCLOCKWISE:
-      switch (ccw(boundary[1], nextEdgeEnd)) {
+      switch (ccw(1)) {
         case CCW::CLOCKWISE:
           return Classification::SADDLE_CONNECTION;
         case CCW::COUNTERCLOCKWISE:
@@ -429,7 +607,8 @@ template <typename Surface>
 void ImplementationOf<SaddleConnectionsIterator<Surface>>::pushStart(bool fromOutside, bool toOutside) {
   if (fromOutside) {
     if (toOutside) {
-      ;
+      if (postponed)
+        state.push_back(State::START_FROM_OUTSIDE_TO_OUTSIDE);
     } else {
       state.push_back(State::START_FROM_OUTSIDE_TO_INSIDE);
     }
@@ -440,6 +619,8 @@ void ImplementationOf<SaddleConnectionsIterator<Surface>>::pushStart(bool fromOu
       state.push_back(State::START_FROM_INSIDE_TO_INSIDE);
     }
   }
+
+  statistics.record([&](auto& counters) { counters.maximumDepth = std::max(counters.maximumDepth, state.size()); });
 }
 
 template <typename Surface>
@@ -465,6 +646,104 @@ void SaddleConnectionsIterator<Surface>::skipSector(CCW ccw) {
   self->skipSector(ccw);
 }
 
+template <typename Surface>
+size_t SaddleConnectionsIterator<Surface>::fill(std::vector<HalfEdge>& halfEdges, std::vector<mpz_class>& coefficients, size_t n) {
+  LIBFLATSURF_TRACE("SaddleConnectionsIterator::fill");
+
+  const auto& surface = *self->connections.surface;
+
+  size_t filled = 0;
+  for (; filled < n && self->sector != self->end; filled++) {
+    if (self->state.back() == ImplementationOf<SaddleConnectionsIterator>::State::SADDLE_CONNECTION_FOUND) {
+      // Write the connection directly from the state of the search without
+      // creating a SaddleConnection.
+      halfEdges.push_back(self->sector->source);
+      halfEdges.push_back(surface.previousAtVertex(-self->nextEdge));
+      for (const auto& edge : surface.edges())
+        coefficients.push_back(self->nextEdgeEnd[edge]);
+    } else {
+      const auto& connection = self->dereference();
+      halfEdges.push_back(connection.source());
+      halfEdges.push_back(connection.target());
+      for (const auto& edge : surface.edges())
+        coefficients.push_back(connection.chain()[edge]);
+    }
+
+    increment();
+  }
+
+  return filled;
+}
+
+template <typename Surface>
+std::vector<SaddleConnection<Surface>> SaddleConnectionsIterator<Surface>::batch(size_t n) {
+  LIBFLATSURF_TRACE("SaddleConnectionsIterator::batch");
+
+  std::vector<SaddleConnection<Surface>> batch;
+  for (; batch.size() < n && self->sector != self->end; increment())
+    batch.push_back(self->dereference());
+
+  return batch;
+}
+
+template <typename Surface>
+size_t SaddleConnectionsIterator<Surface>::fill(SaddleConnectionRecords<Surface>& records, size_t n) {
+  LIBFLATSURF_TRACE("SaddleConnectionsIterator::fill");
+
+  const auto& surface = *self->connections.surface;
+
+  size_t filled = 0;
+  for (; filled < n && self->sector != self->end; filled++) {
+    if (self->state.back() == ImplementationOf<SaddleConnectionsIterator>::State::SADDLE_CONNECTION_FOUND) {
+      records.push_back(self->sector->source, surface.previousAtVertex(-self->nextEdge), self->nextEdgeEnd);
+    } else {
+      records.push_back(self->dereference());
+    }
+
+    increment();
+  }
+
+  return filled;
+}
+
+template <typename Surface>
+SaddleConnectionsIteratorCheckpoint<Surface> SaddleConnectionsIterator<Surface>::checkpoint() const {
+  ASSERT(self->postponed == nullptr, "cannot checkpoint a search that is being postponed");
+
+  SaddleConnectionsIteratorCheckpoint<Surface> checkpoint;
+  checkpoint.sector = static_cast<size_t>(self->sector - self->connections.sectors.begin());
+
+  if (self->sector == self->end)
+    return checkpoint;
+
+  // Part of our position is encoded in the pending moves. We do not want to
+  // record these, so we apply them to a copy of our state.
+  ImplementationOf<SaddleConnectionsIterator> position = *self;
+  position.applyMoves();
+
+  // The chains of the search only borrow the surface. The checkpoint might
+  // outlive the search, so its chains need to hold on to the surface.
+  const auto own = [&](auto boundary) {
+    if (std::holds_alternative<Chain<Surface>>(boundary))
+      ImplementationOf<Chain<Surface>>::own(std::get<Chain<Surface>>(boundary), self->connections.surface);
+    return boundary;
+  };
+
+  checkpoint.boundaries.push_back(own(position.boundary[0]));
+  checkpoint.boundaries.push_back(own(position.boundary[1]));
+  for (size_t i = 0; i < position.tmp.size(); i++)
+    checkpoint.boundaries.push_back(own(position.tmp[i]));
+
+  checkpoint.nextEdge = position.nextEdge;
+  checkpoint.nextEdgeEnd = position.nextEdgeEnd;
+  ImplementationOf<Chain<Surface>>::own(*checkpoint.nextEdgeEnd, self->connections.surface);
+
+  for (const auto s : position.state)
+    checkpoint.state.push_back(static_cast<unsigned char>(s));
+
+  return checkpoint;
+}
+
 template <typename Surface>
 std::optional<HalfEdge> SaddleConnectionsIterator<Surface>::incrementWithCrossings() {
   ASSERT(self->sector != self->end, "iterator is at end()");
@@ -492,24 +771,30 @@ std::optional<HalfEdge> SaddleConnectionsIterator<Surface>::incrementWithCrossin
 
 template <typename Surface>
 const SaddleConnection<Surface>& SaddleConnectionsIterator<Surface>::dereference() const {
-  ASSERT(self->sector != self->end, "iterator is at end()");
+  return self->dereference();
+}
 
-  switch (self->state.back()) {
-    case ImplementationOf<SaddleConnectionsIterator>::State::START_FROM_INSIDE_TO_INSIDE:
+template <typename Surface>
+const SaddleConnection<Surface>& ImplementationOf<SaddleConnectionsIterator<Surface>>::dereference() const {
+  ASSERT(sector != end, "iterator is at end()");
+
+  switch (state.back()) {
+    case State::START_FROM_INSIDE_TO_INSIDE:
       // This makes the first reported connection work: It is not nextEdgeEnd but the sector boundary.
-      self->connection = SaddleConnection(*self->connections.surface, self->sector->source);
+      connection = SaddleConnection(*connections.surface, sector->source);
       break;
-    case ImplementationOf<SaddleConnectionsIterator>::State::SADDLE_CONNECTION_FOUND:
-      self->connection = SaddleConnection<Surface>(self->connections.surface, self->sector->source, self->connections.surface->previousAtVertex(-self->nextEdge), self->nextEdgeEnd);
+    case State::SADDLE_CONNECTION_FOUND:
+      connection = SaddleConnection<Surface>(connections.surface, sector->source, connections.surface->previousAtVertex(-nextEdge), nextEdgeEnd);
+      statistics.record([](auto& counters) { counters.chainCopies++; });
       break;
     default:
       ASSERT(false, "iterator cannot hold in this state");
   }
 
-  ASSERT(!self->connections.searchRadius || self->connection <= *self->connections.searchRadius, "Iterator stopped at connection " << self->connection << " which is beyond the search radius " << *self->connections.searchRadius);
-  ASSERT(self->connection > self->connections.lowerBound, "Iterator stopped at connection " << self->connection << " which is within the excluded lower bound " << self->connections.lowerBound);
+  ASSERT(!connections.searchRadius || connection <= *connections.searchRadius, "Iterator stopped at connection " << connection << " which is beyond the search radius " << *connections.searchRadius);
+  ASSERT(connection > connections.lowerBound, "Iterator stopped at connection " << connection << " which is within the excluded lower bound " << connections.lowerBound);
 
-  return self->connection;
+  return connection;
 }
 
 template <typename Surface>
@@ -528,6 +813,8 @@ std::ostream& operator<<(std::ostream& os, const SaddleConnectionsIterator<Surfa
           return "START_FROM_INSIDE_TO_OUTSIDE";
         case Implementation::State::START_FROM_OUTSIDE_TO_INSIDE:
           return "START_FROM_OUTSIDE_TO_INSIDE";
+        case Implementation::State::START_FROM_OUTSIDE_TO_OUTSIDE:
+          return "START_FROM_OUTSIDE_TO_OUTSIDE";
         case Implementation::State::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE:
           return "OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE";
         case Implementation::State::OUTSIDE_SEARCH_SECTOR_CLOCKWISE:
@@ -553,4 +840,4 @@ std::ostream& operator<<(std::ostream& os, const SaddleConnectionsIterator<Surfa
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), SaddleConnectionsIterator, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), SaddleConnectionsIterator, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
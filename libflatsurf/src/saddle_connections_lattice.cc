@@ -0,0 +1,217 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+
+#include "impl/saddle_connections_lattice.hpp"
+
+#include <gmpxx.h>
+
+#include <cstdlib>
+#include <map>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../flatsurf/bound.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/vector.hpp"
+
+namespace flatsurf {
+
+namespace {
+
+// Coordinates of the half edges and the search radius must be below this
+// bound so that all the products below fit comfortably into 128 bits.
+constexpr long long MAX_COORDINATE = 1ll << 30;
+
+using Point = std::pair<long long, long long>;
+
+template <typename T>
+std::optional<long long> integer(const T& x) {
+  if constexpr (std::is_same_v<T, long long>) {
+    return x;
+  } else if constexpr (std::is_same_v<T, mpz_class>) {
+    if (x.fits_slong_p())
+      return x.get_si();
+    return std::nullopt;
+  } else if constexpr (std::is_same_v<T, mpq_class>) {
+    if (x.get_den() == 1 && x.get_num().fits_slong_p())
+      return x.get_num().get_si();
+    return std::nullopt;
+  } else {
+    return std::nullopt;
+  }
+}
+
+__int128 cross(const Point& v, const Point& w) {
+  return static_cast<__int128>(v.first) * w.second - static_cast<__int128>(v.second) * w.first;
+}
+
+__int128 dot(const Point& v, const Point& w) {
+  return static_cast<__int128>(v.first) * w.first + static_cast<__int128>(v.second) * w.second;
+}
+
+// Return whether v is strictly inside the cone from a to b whose angle is
+// less than π.
+bool inside(const Point& v, const Point& a, const Point& b) {
+  return cross(a, v) > 0 && cross(v, b) > 0;
+}
+
+bool parallel(const Point& v, const Point& w) {
+  return cross(v, w) == 0 && dot(v, w) > 0;
+}
+
+// Return the number of primitive vectors v in the cone [a, b) with
+// lowerBound < |v|² ≤ radius.
+size_t primitive(const Point& a, const Point& b, long long radius, long long lowerBound) {
+  size_t count = 0;
+
+  const auto visit = [&](const Point& v) {
+    const auto length = dot(v, v);
+    if (length <= radius && length > lowerBound && (parallel(v, a) || inside(v, a, b)))
+      count++;
+  };
+
+  const Point axes[] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+
+  // The Stern-Brocot trees in the four quadrants. Every primitive vector
+  // strictly inside a quadrant is the mediant l + r of exactly one pair of
+  // neighbours (l, r) in these trees.
+  std::vector<std::pair<Point, Point>> stack;
+  for (int i = 0; i < 4; i++) {
+    visit(axes[i]);
+    stack.push_back({axes[i], axes[(i + 1) % 4]});
+  }
+
+  while (!stack.empty()) {
+    const auto [l, r] = stack.back();
+    stack.pop_back();
+
+    const Point mediant{l.first + r.first, l.second + r.second};
+
+    // Since l and r are in the same quadrant, all the vectors further down
+    // in this part of the tree are at least as long as the mediant.
+    if (dot(mediant, mediant) > radius)
+      continue;
+
+    // Since both cones are less than π, they intersect if and only if one
+    // of them starts inside the other one or they start in the same
+    // direction.
+    if (!inside(l, a, b) && !inside(a, l, r) && !parallel(l, a))
+      continue;
+
+    visit(mediant);
+
+    stack.push_back({l, mediant});
+    stack.push_back({mediant, r});
+  }
+
+  return count;
+}
+
+}  // namespace
+
+template <typename Surface>
+bool SaddleConnectionsLattice<Surface>::applicable(const ImplementationOf<SaddleConnections<Surface>>& connections) {
+  const auto& surface = *connections.surface;
+
+  if (!connections.searchRadius)
+    return false;
+
+  const auto radius = connections.searchRadius->machineSquared();
+  if (!radius || *radius >= MAX_COORDINATE * MAX_COORDINATE)
+    return false;
+
+  if (!connections.lowerBound.machineSquared())
+    return false;
+
+  if (surface.hasBoundary())
+    return false;
+
+  for (const auto& sector : connections.sectors)
+    if (sector.sector)
+      return false;
+
+  // Twice the area of all the triangles, each triangle counted three times.
+  __int128 area = 0;
+
+  for (const auto he : surface.halfEdges()) {
+    const auto& v = surface.fromHalfEdge(he);
+    const auto& w = surface.fromHalfEdge(surface.nextInFace(he));
+
+    const auto vx = integer(v.x());
+    const auto vy = integer(v.y());
+    const auto wx = integer(w.x());
+    const auto wy = integer(w.y());
+
+    if (!vx || !vy || !wx || !wy)
+      return false;
+
+    if (std::llabs(*vx) >= MAX_COORDINATE || std::llabs(*vy) >= MAX_COORDINATE)
+      return false;
+
+    area += cross(Point{*vx, *vy}, Point{*wx, *wy});
+  }
+
+  // The surface covers the torus with degree equal to its area; the total
+  // angle at the vertices is 2π times this degree if and only if all the
+  // preimages of the lattice point are vertices, i.e., if and only if there
+  // are two triangles per unit square.
+  return area == static_cast<__int128>(surface.halfEdges().size());
+}
+
+template <typename Surface>
+size_t SaddleConnectionsLattice<Surface>::count(const ImplementationOf<SaddleConnections<Surface>>& connections) {
+  const auto& surface = *connections.surface;
+
+  const long long radius = *connections.searchRadius->machineSquared();
+  const long long lowerBound = *connections.lowerBound.machineSquared();
+
+  const auto point = [&](HalfEdge he) {
+    const auto& v = surface.fromHalfEdge(he);
+    return Point{*integer(v.x()), *integer(v.y())};
+  };
+
+  // Square-tiled surfaces typically only have a few different shapes of
+  // corners so we count the primitive vectors for each shape only once.
+  std::map<std::pair<Point, Point>, size_t> corners;
+
+  size_t count = 0;
+  for (const auto& sector : connections.sectors) {
+    const Point a = point(sector.source);
+    const Point next = point(surface.nextInFace(sector.source));
+    const Point b{a.first + next.first, a.second + next.second};
+
+    auto corner = corners.find({a, b});
+    if (corner == corners.end())
+      corner = corners.emplace(std::pair{a, b}, primitive(a, b, radius, lowerBound)).first;
+
+    count += corner->second;
+  }
+
+  return count;
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), SaddleConnectionsLattice, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -19,13 +19,19 @@
 
 #include "../flatsurf/saddle_connections_sample.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <ostream>
+#include <random>
 
 #include "../flatsurf/bound.hpp"
+#include "../flatsurf/executor.hpp"
 #include "../flatsurf/saddle_connections.hpp"
 #include "../flatsurf/saddle_connections_sample_iterator.hpp"
 #include "impl/saddle_connections_sample.impl.hpp"
 #include "impl/saddle_connections_sample_iterator.impl.hpp"
+#include "util/sharded_set.ipp"
+#include "util/work_stealing.ipp"
 
 namespace flatsurf {
 
@@ -44,6 +50,46 @@ typename SaddleConnectionsSample<Surface>::iterator SaddleConnectionsSample<Surf
   return begin();
 }
 
+template <typename Surface>
+void SaddleConnectionsSample<Surface>::forEach(size_t count, const std::function<void(const SaddleConnection<Surface>&)>& callback, unsigned int threads, std::optional<unsigned int> seed) const {
+  if (count == 0)
+    return;
+
+  if (threads == 0)
+    threads = Executor::global().concurrency();
+
+  if (!seed)
+    seed = self->seed;
+  if (!seed)
+    seed = std::random_device()();
+
+  // Use a few more shards than threads so that threads rarely contend for
+  // the same shard.
+  ShardedSet<SaddleConnection<Surface>> seen(4 * threads);
+
+  // With bounded deduplication, each sampler only remembers its own recent
+  // connections.
+  auto* shared = self->deduplication ? nullptr : &seen;
+
+  std::atomic<size_t> reported{0};
+
+  // Each task is the random stream of a sampler.
+  WorkStealing<unsigned int> pool(threads);
+  for (unsigned int stream = 0; stream < threads; stream++)
+    pool.push(stream, stream);
+
+  pool.run([&](size_t, unsigned int stream) {
+    std::seed_seq seeds{*seed, stream};
+
+    ImplementationOf<SaddleConnectionsSampleIterator<Surface>> sampler(*this, std::mt19937(seeds), shared);
+
+    while (reported++ < count) {
+      callback(sampler.current);
+      sampler.increment();
+    }
+  });
+}
+
 template <typename Surface>
 const Surface& SaddleConnectionsSample<Surface>::surface() const {
   return self->surface;
@@ -68,38 +114,82 @@ SaddleConnections<Surface> SaddleConnectionsSample<Surface>::byAngle() const {
 
 template <typename Surface>
 SaddleConnectionsSample<Surface> SaddleConnectionsSample<Surface>::bound(Bound bound) const {
-  return this->byAngle().bound(bound).sample();
+  return self->configure(this->byAngle().bound(bound).sample());
 }
 
 template <typename Surface>
 SaddleConnectionsSample<Surface> SaddleConnectionsSample<Surface>::lowerBound(Bound bound) const {
-  return this->byAngle().lowerBound(bound).sample();
+  return self->configure(this->byAngle().lowerBound(bound).sample());
 }
 
 template <typename Surface>
 SaddleConnectionsSample<Surface> SaddleConnectionsSample<Surface>::sector(HalfEdge sectorBegin) const {
-  return this->byAngle().sector(sectorBegin).sample();
+  return self->configure(this->byAngle().sector(sectorBegin).sample());
 }
 
 template <typename Surface>
 SaddleConnectionsSample<Surface> SaddleConnectionsSample<Surface>::sector(const SaddleConnection<Surface>& sectorBegin, const SaddleConnection<Surface>& sectorEnd) const {
-  return this->byAngle().sector(sectorBegin, sectorEnd).sample();
+  return self->configure(this->byAngle().sector(sectorBegin, sectorEnd).sample());
 }
 
 template <typename Surface>
 SaddleConnectionsSample<Surface> SaddleConnectionsSample<Surface>::sector(const Vector<T>& sectorBegin, const Vector<T>& sectorEnd) const {
-  return this->byAngle().sector(sectorBegin, sectorEnd).sample();
+  return self->configure(this->byAngle().sector(sectorBegin, sectorEnd).sample());
+}
+
+template <typename Surface>
+std::optional<unsigned int> SaddleConnectionsSample<Surface>::seed() const {
+  return self->seed;
+}
+
+template <typename Surface>
+SaddleConnectionsSample<Surface> SaddleConnectionsSample<Surface>::seed(unsigned int seed) const {
+  SaddleConnectionsSample<Surface> sample = *this;
+  sample.self->seed = seed;
+  return sample;
+}
+
+template <typename Surface>
+std::optional<size_t> SaddleConnectionsSample<Surface>::deduplication() const {
+  return self->deduplication;
+}
+
+template <typename Surface>
+SaddleConnectionsSample<Surface> SaddleConnectionsSample<Surface>::deduplication(std::optional<size_t> capacity) const {
+  SaddleConnectionsSample<Surface> sample = *this;
+  sample.self->deduplication = capacity;
+  return sample;
+}
+
+template <typename Surface>
+bool SaddleConnectionsSample<Surface>::trajectories() const {
+  return self->trajectories;
+}
+
+template <typename Surface>
+SaddleConnectionsSample<Surface> SaddleConnectionsSample<Surface>::trajectories(bool enable) const {
+  SaddleConnectionsSample<Surface> sample = *this;
+  sample.self->trajectories = enable;
+  return sample;
 }
 
 template <typename Surface>
 SaddleConnectionsSample<Surface> SaddleConnectionsSample<Surface>::source(const Vertex& source) const {
-  return this->byAngle().source(source).sample();
+  return self->configure(this->byAngle().source(source).sample());
 }
 
 template <typename Surface>
 ImplementationOf<SaddleConnectionsSample<Surface>>::ImplementationOf(const ImplementationOf<SaddleConnections<Surface>>& connections) :
   ImplementationOf<SaddleConnections<Surface>>(connections) {}
 
+template <typename Surface>
+SaddleConnectionsSample<Surface> ImplementationOf<SaddleConnectionsSample<Surface>>::configure(SaddleConnectionsSample<Surface>&& sample) const {
+  sample.self->seed = seed;
+  sample.self->deduplication = deduplication;
+  sample.self->trajectories = trajectories;
+  return std::move(sample);
+}
+
 template <typename Surface>
 std::ostream& operator<<(std::ostream& os, const SaddleConnectionsSample<Surface>&) {
   return os << "SaddleConnectionsSample()";
@@ -110,4 +200,4 @@ std::ostream& operator<<(std::ostream& os, const SaddleConnectionsSample<Surface
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), SaddleConnectionsSample, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), SaddleConnectionsSample, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
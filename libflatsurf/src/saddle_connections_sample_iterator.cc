@@ -17,11 +17,15 @@
  *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
  *********************************************************************/
 
+#include <cmath>
+#include <complex>
 #include <random>
 
 #include "../flatsurf/ccw.hpp"
+#include "../flatsurf/chain.hpp"
 #include "../flatsurf/saddle_connections_iterator.hpp"
 #include "../flatsurf/saddle_connections_sample.hpp"
+#include "impl/saddle_connections_crossing.hpp"
 #include "impl/saddle_connections_sample.impl.hpp"
 #include "impl/saddle_connections_sample_iterator.impl.hpp"
 
@@ -53,10 +57,45 @@ ImplementationOf<SaddleConnectionsSampleIterator<Surface>>::ImplementationOf(con
   connections(connections),
   seen(),
   current(connections.surface(), connections.self->sectors[0].source),
-  rand(std::random_device()()) {
+  rand(connections.self->seed ? *connections.self->seed : std::random_device()()) {
   increment();
 }
 
+template <typename Surface>
+ImplementationOf<SaddleConnectionsSampleIterator<Surface>>::ImplementationOf(const SaddleConnectionsSample<Surface>& connections, std::mt19937 rand, ShardedSet<SaddleConnection<Surface>>* shared) :
+  connections(connections),
+  seen(),
+  shared(shared),
+  current(connections.surface(), connections.self->sectors[0].source),
+  rand(std::move(rand)) {
+  increment();
+}
+
+template <typename Surface>
+bool ImplementationOf<SaddleConnectionsSampleIterator<Surface>>::fresh(const SaddleConnection<Surface>& connection) {
+  if (shared)
+    return shared->insert(connection);
+
+  const auto& capacity = connections.self->deduplication;
+
+  if (!capacity)
+    return seen.insert(connection).second;
+
+  if (*capacity == 0)
+    return true;
+
+  if (!seen.insert(connection).second)
+    return false;
+
+  history.push_back(connection);
+  if (history.size() > *capacity) {
+    seen.erase(history.front());
+    history.pop_front();
+  }
+
+  return true;
+}
+
 template <typename Surface>
 void ImplementationOf<SaddleConnectionsSampleIterator<Surface>>::increment() {
   if (connections.bound())
@@ -67,6 +106,9 @@ void ImplementationOf<SaddleConnectionsSampleIterator<Surface>>::increment() {
   if (sectors.size() == 0)
     throw std::logic_error("not implemented: random sampling of empty sets of saddle connections is not implemented");
 
+  if (connections.self->trajectories)
+    return flow();
+
   std::uniform_int_distribution<> sector_distribution(0, static_cast<int>(sectors.size()) - 1);
   auto& sector = sectors[sector_distribution(rand)];
 
@@ -154,12 +196,8 @@ void ImplementationOf<SaddleConnectionsSampleIterator<Surface>>::increment() {
 
     bool eligible = current > this->connections.lowerBound();
 
-    if (eligible) {
-      if (seen.find(current) == end(seen))
-        seen.insert(current);
-      else
-        eligible = false;
-    }
+    if (eligible)
+      eligible = fresh(current);
 
     if (!eligible) {
       if (current.vector() == outerSectorBegin)
@@ -182,9 +220,71 @@ void ImplementationOf<SaddleConnectionsSampleIterator<Surface>>::increment() {
   }
 }
 
+template <typename Surface>
+void ImplementationOf<SaddleConnectionsSampleIterator<Surface>>::flow() {
+  using Crossing = SaddleConnectionsCrossing<Surface>;
+
+  // A straight line in a periodic direction might never pass a saddle
+  // connection; we give up on such a line after this many crossings.
+  // Since directions are drawn at random, this practically never happens.
+  constexpr size_t MAX_CROSSINGS = size_t(1) << 24;
+
+  const auto& search = *connections.self;
+  const auto& surface = connections.surface();
+  const auto& sectors = search.sectors;
+
+  const auto eligible = [&](const SaddleConnection<Surface>& connection, const DoubleApproximation& approximation) {
+    return search.beyondLowerBound(approximation, connection.chain()) && fresh(connection);
+  };
+
+  while (true) {
+    const size_t sector = std::uniform_int_distribution<size_t>(0, sectors.size() - 1)(rand);
+    const auto& bounds = sectors[sector].sector;
+
+    // Pick a direction in the sector uniformly at random.
+    const double begin = std::arg(static_cast<std::complex<double>>(bounds ? bounds->first : surface.fromHalfEdge(sectors[sector].source)));
+    const double end = std::arg(static_cast<std::complex<double>>(bounds ? bounds->second : surface.fromHalfEdge(surface.nextAtVertex(sectors[sector].source))));
+    double angle = end - begin;
+    if (angle <= 0)
+      angle += 2 * M_PI;
+    const auto direction = std::polar(1., begin + std::uniform_real_distribution<>(0, angle)(rand));
+
+    std::optional<SaddleConnection<Surface>> initial;
+    auto frontier = Crossing::start(search, sector, initial);
+
+    if (initial && eligible(*initial, (*search.approximations)[initial->source()])) {
+      current = std::move(*initial);
+      return;
+    }
+
+    for (size_t crossings = 0; frontier && crossings < MAX_CROSSINGS; crossings++) {
+      auto expansion = Crossing::expand(search, *frontier);
+
+      if (!expansion.connection) {
+        // The vertex on the other side is outside of the search sector, so
+        // the line continues in the only remaining part of the sector.
+        frontier = expansion.clockwise ? std::move(expansion.clockwise) : std::move(expansion.counterclockwise);
+        continue;
+      }
+
+      // Continue on the side of the saddle connection that contains the
+      // line. When this is decided wrongly due to rounding, we just
+      // continue along a slightly different line.
+      const auto vector = static_cast<std::complex<double>>(expansion.connection->vector());
+      const bool counterclockwise = vector.real() * direction.imag() - vector.imag() * direction.real() > 0;
+      frontier = counterclockwise ? std::move(expansion.counterclockwise) : std::move(expansion.clockwise);
+
+      if (eligible(*expansion.connection, expansion.approximation)) {
+        current = std::move(*expansion.connection);
+        return;
+      }
+    }
+  }
+}
+
 }  // namespace flatsurf
 
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), SaddleConnectionsSampleIterator, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION)(LIBFLATSURF_INSTANTIATE_HASH), SaddleConnectionsSampleIterator, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
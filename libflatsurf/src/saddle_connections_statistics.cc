@@ -0,0 +1,45 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/saddle_connections_statistics.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <ostream>
+
+namespace flatsurf {
+
+SaddleConnectionsStatistics& SaddleConnectionsStatistics::operator+=(const SaddleConnectionsStatistics& rhs) {
+  trianglesCrossed += rhs.trianglesCrossed;
+  classifications += rhs.classifications;
+  approximatePredicates += rhs.approximatePredicates;
+  exactPredicates += rhs.exactPredicates;
+  combinedMoves += rhs.combinedMoves;
+  appliedMoves += rhs.appliedMoves;
+  maximumDepth = std::max(maximumDepth, rhs.maximumDepth);
+  chainCopies += rhs.chainCopies;
+  return *this;
+}
+
+std::ostream& operator<<(std::ostream& os, const SaddleConnectionsStatistics& self) {
+  return os << fmt::format("SaddleConnectionsStatistics(trianglesCrossed={}, classifications={}, approximatePredicates={}, exactPredicates={}, combinedMoves={}, appliedMoves={}, maximumDepth={}, chainCopies={})", self.trianglesCrossed, self.classifications, self.approximatePredicates, self.exactPredicates, self.combinedMoves, self.appliedMoves, self.maximumDepth, self.chainCopies);
+}
+
+}  // namespace flatsurf
@@ -0,0 +1,133 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/tracing.hpp"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace flatsurf {
+
+namespace {
+
+using Clock = Tracing::Clock;
+
+struct Event {
+  const char* name;
+  Clock::time_point start;
+  Clock::duration duration;
+  size_t thread;
+};
+
+struct Recorder {
+  std::mutex mutex;
+  std::vector<Event> events;
+  // The time that all events in the trace are relative to.
+  const Clock::time_point epoch = Clock::now();
+  std::atomic<size_t> threads = 0;
+  std::atomic<bool> active = false;
+};
+
+// The recorder is never destroyed since threads might still report to it
+// while static objects are being destroyed at exit.
+Recorder& recorder() {
+  static Recorder* recorder = new Recorder();
+  return *recorder;
+}
+
+// Return a small number identifying the current thread in the trace.
+size_t thread() {
+  thread_local size_t id = recorder().threads++;
+  return id;
+}
+
+// Enable tracing when requested through the environment and write the trace
+// when the program exits.
+[[maybe_unused]] const bool fromEnvironment = [] {
+  static const char* path = std::getenv("LIBFLATSURF_TRACE");
+  if (path == nullptr || *path == '\0')
+    return false;
+  Tracing::enable();
+  std::atexit([] {
+    std::ofstream trace(path);
+    Tracing::write(trace);
+  });
+  return true;
+}();
+
+}  // namespace
+
+Tracing::Scope::Scope(const char* name) noexcept :
+  name(name) {
+  if (recorder().active.load(std::memory_order_relaxed))
+    start = Clock::now();
+}
+
+Tracing::Scope::~Scope() {
+  if (!start)
+    return;
+
+  const auto end = Clock::now();
+  const auto id = thread();
+
+  auto& recorder = ::flatsurf::recorder();
+  std::lock_guard lock(recorder.mutex);
+  recorder.events.push_back(Event{name, *start, end - *start, id});
+}
+
+void Tracing::enable(bool enabled) {
+  recorder().active = enabled;
+}
+
+bool Tracing::enabled() {
+  return recorder().active;
+}
+
+void Tracing::reset() {
+  auto& recorder = ::flatsurf::recorder();
+  std::lock_guard lock(recorder.mutex);
+  recorder.events.clear();
+}
+
+void Tracing::write(std::ostream& os) {
+  auto& recorder = ::flatsurf::recorder();
+  std::lock_guard lock(recorder.mutex);
+
+  const auto microseconds = [](Clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+  };
+
+  os << "{\"traceEvents\":[";
+  for (size_t i = 0; i < recorder.events.size(); i++) {
+    const auto& event = recorder.events[i];
+    // The names are identifiers chosen by the library, so they need no
+    // escaping in JSON.
+    os << (i ? ",\n" : "\n") << fmt::format(R"({{"name":"{}","cat":"flatsurf","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":0,"tid":{}}})", event.name, microseconds(event.start - recorder.epoch), microseconds(event.duration), event.thread);
+  }
+  os << "\n]}" << std::endl;
+}
+
+}  // namespace flatsurf
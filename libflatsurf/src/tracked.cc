@@ -21,6 +21,7 @@
 
 #include "../flatsurf/odd_half_edge_map.hpp"
 #include "external/rx-ranges/include/rx/ranges.hpp"
+#include "impl/edge_cache.hpp"
 #include "impl/read_only.hpp"
 #include "impl/tracked.impl.hpp"
 #include "impl/weak_read_only.hpp"
@@ -46,6 +47,18 @@ struct is_odd_half_edge_map : std::false_type {};
 
 template <typename T>
 struct is_odd_half_edge_map<OddHalfEdgeMap<T>> : std::true_type {};
+
+template <typename T>
+struct is_edge_cache : std::false_type {};
+
+template <typename T>
+struct is_edge_cache<EdgeCache<T>> : std::true_type {};
+
+template <typename T>
+struct is_odd_half_edge_cache : std::false_type {};
+
+template <typename T>
+struct is_odd_half_edge_cache<OddHalfEdgeCache<T>> : std::true_type {};
 }  // namespace
 
 template <typename T>
@@ -55,7 +68,9 @@ Tracked<T>::Tracked(const FlatTriangulationCombinatorial& parent, T value, const
 
 template <typename T>
 Tracked<T>::Tracked(const Tracked& rhs) noexcept :
-  self(spimpl::make_unique_impl<ImplementationOf<Tracked>>(rhs.self->parent.get(), T(rhs.self->value), rhs.self->updateAfterFlip, rhs.self->updateBeforeCollapse, rhs.self->updateBeforeSwap, rhs.self->updateBeforeErase, rhs.self->updateBeforeDestruction)) {}
+  self(spimpl::make_unique_impl<ImplementationOf<Tracked>>(rhs.self->parent.get(), T(rhs.self->value), rhs.self->updateAfterFlip, rhs.self->updateBeforeCollapse, rhs.self->updateBeforeSwap, rhs.self->updateBeforeErase, rhs.self->updateBeforeDestruction)) {
+  self->deferred = rhs.self->deferred;
+}
 
 template <typename T>
 Tracked<T>::Tracked(Tracked&& rhs) noexcept :
@@ -127,6 +142,8 @@ void Tracked<T>::defaultSwap(T& self, const FlatTriangulationCombinatorial&, Hal
       self.set(a, self.get(b));
       self.set(b, tmp);
     }
+  } else if constexpr (is_edge_cache<T>::value || is_odd_half_edge_cache<T>::value) {
+    self.swap(a, b);
   } else {
     throw std::logic_error("This Tracked<T> of a FlatTriangulationCombinatorial does not support swapping of half edges.");
   }
@@ -140,13 +157,13 @@ void Tracked<T>::defaultErase(T& self, const FlatTriangulationCombinatorial&, co
   } else if constexpr (std::is_same_v<T, EdgeSet>) {
     for (auto e : erase)
       self.erase(e);
-  } else if constexpr (is_edge_map<T>::value) {
+  } else if constexpr (is_edge_map<T>::value || is_edge_cache<T>::value) {
     ASSERT(erase | rx::all_of([&](const auto& e) { return e.index() >= self.size() - erase.size(); }), "Can only erase Edges of maximal index from Tracked<EdgeMap>. But the given edges are not maximal.");
     for (auto e : erase) {
       (void)e;
       self.pop();
     }
-  } else if constexpr (is_half_edge_map<T>::value || is_odd_half_edge_map<T>::value) {
+  } else if constexpr (is_half_edge_map<T>::value || is_odd_half_edge_map<T>::value || is_odd_half_edge_cache<T>::value) {
     ASSERT(erase | rx::all_of([&](const auto& e) { return e.positive().index() >= self.size() - 2 * erase.size(); }), "Can only erase HalfEdges of maximal index from Tracked<(Odd)HalfEdgeMap>. But the given edges are not maximal.");
     for (auto e : erase) {
       (void)e;
@@ -229,48 +246,61 @@ ImplementationOf<Tracked<T>>::ImplementationOf(ImplementationOf<FlatTriangulatio
   updateBeforeErase(updateBeforeErase),
   updateBeforeDestruction(updateBeforeDestruction) {
   if (parent != nullptr)
-    connect();
+    parent->attach(this);
 }
 
 template <typename T>
 ImplementationOf<Tracked<T>>::~ImplementationOf() {
   if (!parent.expired())
-    onChange.disconnect();
+    parent.get()->detach(this);
 }
 
 template <typename T>
-void ImplementationOf<Tracked<T>>::connect() {
-  ASSERT(!parent.expired(), "cannot connect without a parent FlatTriangulationCombinatorial");
-
-  // This callback uses a reference to "this->parent". This reference will not
-  // be dangling since we explicitly disconnect in ~Implementation.
-  onChange = ImplementationOf<FlatTriangulationCombinatorial>::connect(parent.get(), [this](const Message& message) {
-    if (auto flipMessage = std::get_if<ImplementationOf<FlatTriangulationCombinatorial>::MessageAfterFlip>(&message)) {
-      const auto surface = static_cast<ReadOnly<FlatTriangulationCombinatorial>>(parent);
-      updateAfterFlip(value, surface, flipMessage->e);
-    } else if (auto collapseMessage = std::get_if<ImplementationOf<FlatTriangulationCombinatorial>::MessageBeforeCollapse>(&message)) {
-      const auto surface = static_cast<ReadOnly<FlatTriangulationCombinatorial>>(parent);
-      updateBeforeCollapse(value, surface, collapseMessage->e);
-    } else if (auto swapMessage = std::get_if<ImplementationOf<FlatTriangulationCombinatorial>::MessageBeforeSwap>(&message)) {
-      const auto surface = static_cast<ReadOnly<FlatTriangulationCombinatorial>>(parent);
-      updateBeforeSwap(value, surface, swapMessage->a, swapMessage->b);
-    } else if (auto eraseMessage = std::get_if<ImplementationOf<FlatTriangulationCombinatorial>::MessageBeforeErase>(&message)) {
-      const auto surface = static_cast<ReadOnly<FlatTriangulationCombinatorial>>(parent);
-      updateBeforeErase(value, surface, eraseMessage->erase);
-    } else if (auto moveMessage = std::get_if<ImplementationOf<FlatTriangulationCombinatorial>::MessageAfterMove>(&message)) {
-      if (moveMessage->target == nullptr) {
-        const auto surface = static_cast<ReadOnly<FlatTriangulationCombinatorial>>(parent);
-        updateBeforeDestruction(value, surface);
-      }
-      if (!parent.expired())
-        onChange.disconnect();
-      this->parent = moveMessage->target;
-      if (!parent.expired())
-        connect();
-    } else {
-      throw std::logic_error("unknown Message");
-    }
-  });
+void ImplementationOf<Tracked<T>>::defer(Tracked<T>& tracked) {
+  tracked.self->deferred = true;
+}
+
+template <typename T>
+void ImplementationOf<Tracked<T>>::afterFlip(HalfEdge flip) {
+  const auto surface = static_cast<ReadOnly<FlatTriangulationCombinatorial>>(parent);
+  updateAfterFlip(value, surface, flip);
+}
+
+template <typename T>
+void ImplementationOf<Tracked<T>>::afterFlips(const std::vector<HalfEdge>& flips) {
+  const auto surface = static_cast<ReadOnly<FlatTriangulationCombinatorial>>(parent);
+  for (const auto flip : flips)
+    updateAfterFlip(value, surface, flip);
+}
+
+template <typename T>
+void ImplementationOf<Tracked<T>>::beforeCollapse(Edge collapse) {
+  const auto surface = static_cast<ReadOnly<FlatTriangulationCombinatorial>>(parent);
+  updateBeforeCollapse(value, surface, collapse);
+}
+
+template <typename T>
+void ImplementationOf<Tracked<T>>::beforeSwap(HalfEdge a, HalfEdge b) {
+  const auto surface = static_cast<ReadOnly<FlatTriangulationCombinatorial>>(parent);
+  updateBeforeSwap(value, surface, a, b);
+}
+
+template <typename T>
+void ImplementationOf<Tracked<T>>::beforeErase(const std::vector<Edge>& erase) {
+  const auto surface = static_cast<ReadOnly<FlatTriangulationCombinatorial>>(parent);
+  updateBeforeErase(value, surface, erase);
+}
+
+template <typename T>
+void ImplementationOf<Tracked<T>>::beforeDestruction() {
+  const auto surface = static_cast<ReadOnly<FlatTriangulationCombinatorial>>(parent);
+  updateBeforeDestruction(value, surface);
+  parent.reset();
+}
+
+template <typename T>
+bool ImplementationOf<Tracked<T>>::deferrable() const {
+  return deferred;
 }
 
 }  // namespace flatsurf
@@ -286,26 +316,36 @@ void ImplementationOf<Tracked<T>>::connect() {
 #include "../flatsurf/vector.hpp"
 #include "impl/collapsed_half_edge.hpp"
 #include "impl/flat_triangulation_collapsed.impl.hpp"
+#include "impl/saddle_connections_cache.hpp"
+#include "impl/vertex_invariants.hpp"
 #include "util/instantiate.ipp"
 
 LIBFLATSURF_INSTANTIATE((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), (Tracked<HalfEdge>))
 LIBFLATSURF_INSTANTIATE((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), (Tracked<HalfEdgeSet>))
 LIBFLATSURF_INSTANTIATE((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), (Tracked<EdgeSet>))
+LIBFLATSURF_INSTANTIATE((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), (Tracked<VertexInvariants>))
 
 #define LIBFLATSURF_WRAP_ODD_HALF_EDGE_MAP_VECTOR(R, TYPE, T) (TYPE<OddHalfEdgeMap<Vector<T>>>)
-LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_REAL_TYPES(exactreal::Arb), LIBFLATSURF_WRAP_ODD_HALF_EDGE_MAP_VECTOR)
+LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_GEOMETRY_TYPES(exactreal::Arb), LIBFLATSURF_WRAP_ODD_HALF_EDGE_MAP_VECTOR)
 
 #define LIBFLATSURF_WRAP_EDGE_MAP_OPTIONAL(R, TYPE, T) (TYPE<EdgeMap<std::optional<T>>>)
 LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_REAL_TYPES(bool), LIBFLATSURF_WRAP_EDGE_MAP_OPTIONAL)
 
+LIBFLATSURF_INSTANTIATE((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), (Tracked<EdgeCache<bool>>))
+
 #define LIBFLATSURF_WRAP_HALF_EDGE_MAP_OPTIONAL(R, TYPE, T) (TYPE<HalfEdgeMap<std::optional<T>>>)
-LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_REAL_TYPES, LIBFLATSURF_WRAP_HALF_EDGE_MAP_OPTIONAL)
+LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_GEOMETRY_TYPES, LIBFLATSURF_WRAP_HALF_EDGE_MAP_OPTIONAL)
 
-#define LIBFLATSURF_WRAP_ODD_HALF_EDGE_MAP_OPTIONAL(R, TYPE, T) (TYPE<OddHalfEdgeMap<std::optional<T>>>)
-LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_REAL_TYPES(flatsurf::CCW)(flatsurf::ORIENTATION), LIBFLATSURF_WRAP_ODD_HALF_EDGE_MAP_OPTIONAL)
+#define LIBFLATSURF_WRAP_ODD_HALF_EDGE_CACHE(R, TYPE, T) (TYPE<OddHalfEdgeCache<T>>)
+LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_GEOMETRY_TYPES(flatsurf::CCW)(flatsurf::ORIENTATION), LIBFLATSURF_WRAP_ODD_HALF_EDGE_CACHE)
+
+LIBFLATSURF_INSTANTIATE((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), (Tracked<OddHalfEdgeMap<std::optional<Vector<exactreal::Arb>>>>))
 
 #define LIBFLATSURF_WRAP_HALF_EDGE_MAP_SADDLE_CONNECTION(R, TYPE, T) (TYPE<HalfEdgeMap<SaddleConnection<T>>>)
-LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_FLAT_TRIANGULATION_TYPES, LIBFLATSURF_WRAP_HALF_EDGE_MAP_SADDLE_CONNECTION)
+LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES, LIBFLATSURF_WRAP_HALF_EDGE_MAP_SADDLE_CONNECTION)
 
 #define LIBFLATSURF_WRAP_HALF_EDGE_MAP_COLLAPSED(R, TYPE, T) (TYPE<HalfEdgeMap<CollapsedHalfEdge<T>>>)
 LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_REAL_TYPES, LIBFLATSURF_WRAP_HALF_EDGE_MAP_COLLAPSED)
+
+#define LIBFLATSURF_WRAP_SADDLE_CONNECTIONS_CACHE(R, TYPE, T) (TYPE<SaddleConnectionsCache<T>>)
+LIBFLATSURF_INSTANTIATE_MANY_FROM_TRANSFORMATION((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Tracked, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES, LIBFLATSURF_WRAP_SADDLE_CONNECTIONS_CACHE)
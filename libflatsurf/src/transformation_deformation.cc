@@ -65,4 +65,4 @@ Deformation<Surface> TransformationDeformation<Surface>::make(Surface&& surface,
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), TransformationDeformation, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), TransformationDeformation, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
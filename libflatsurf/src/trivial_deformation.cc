@@ -37,4 +37,4 @@ std::optional<HalfEdge> TrivialDeformation<Surface>::operator()(HalfEdge he) con
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), TrivialDeformation, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_STATIC), TrivialDeformation, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES)
@@ -68,6 +68,41 @@
 
 #endif
 
+// The structural checks that validate an entire surface, such as
+// ImplementationOf<FlatTriangulation>::check(), take time linear in the size
+// of the surface. The single switch LIBFLATSURF_VALIDATION decides when they
+// run:
+// 0: never; only use this when all input is known to be valid,
+// 1: only for data that is passed into the library, e.g., the surfaces
+//    built with the public constructors of FlatTriangulation; this is the
+//    default when NDEBUG is defined,
+// 2: also re-validate the surfaces that the library derives from valid
+//    surfaces itself, e.g., after a flip or when cloning; this is the default
+//    otherwise.
+#ifndef LIBFLATSURF_VALIDATION
+#ifdef NDEBUG
+#define LIBFLATSURF_VALIDATION 1
+#else
+#define LIBFLATSURF_VALIDATION 2
+#endif
+#endif
+
+// Run LAMBDA to validate data that has been passed into the library.
+#if LIBFLATSURF_VALIDATION >= 1
+#define VALIDATE_INPUT(LAMBDA) LAMBDA()
+#else
+#define VALIDATE_INPUT(LAMBDA) \
+  while (false) LAMBDA()
+#endif
+
+// Run LAMBDA to re-validate data that the library created itself.
+#if LIBFLATSURF_VALIDATION >= 2
+#define VALIDATE(LAMBDA) LAMBDA()
+#else
+#define VALIDATE(LAMBDA) \
+  while (false) LAMBDA()
+#endif
+
 namespace flatsurf {
 
 // A throw statement that can be used in noexcept marked blocks without
@@ -0,0 +1,114 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_FMPZ_POOL_IPP
+#define LIBFLATSURF_UTIL_FMPZ_POOL_IPP
+
+#include <flint/fmpz.h>
+#include <flint/fmpz_vec.h>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace flatsurf {
+
+// A pool of zeroed arrays of fmpz of the same length that can be shared by
+// several threads. Released arrays are kept on a free list so that later
+// allocations do not need to go through malloc. To keep threads from waiting
+// for each other, the free list is split into several shards and each thread
+// prefers the shard picked by its id.
+class FmpzPool {
+  struct Shard {
+    std::mutex lock;
+    std::vector<fmpz*> blocks;
+    // The length of the arrays in blocks.
+    size_t length = 0;
+  };
+
+  // The number of shards. Collisions between threads only cost a short wait.
+  static constexpr size_t SHARDS = 16;
+
+  // The maximum number of free blocks that each shard holds on to.
+  static constexpr size_t CAPACITY = 256;
+
+ public:
+  FmpzPool() = default;
+  FmpzPool(const FmpzPool&) = delete;
+  FmpzPool& operator=(const FmpzPool&) = delete;
+
+  ~FmpzPool() {
+    for (auto& shard : shards)
+      for (auto* block : shard.blocks)
+        _fmpz_vec_clear(block, shard.length);
+  }
+
+  // Return an array of length zeroed fmpz.
+  fmpz* allocate(size_t length) {
+    auto& shard = this->shard();
+    {
+      std::lock_guard<std::mutex> guard(shard.lock);
+      if (shard.blocks.size() && shard.length == length) {
+        fmpz* block = shard.blocks.back();
+        shard.blocks.pop_back();
+        return block;
+      }
+    }
+    return _fmpz_vec_init(length);
+  }
+
+  // Return block, an array of length fmpz allocated with allocate(), to the
+  // pool.
+  void release(fmpz* block, size_t length) {
+    // Free any GMP integers and reset the entries to zero.
+    _fmpz_vec_zero(block, length);
+
+    auto& shard = this->shard();
+    {
+      std::lock_guard<std::mutex> guard(shard.lock);
+      if (shard.length != length) {
+        // The surface changed its number of edges. Blocks of the old size
+        // cannot be used anymore.
+        for (auto* old : shard.blocks)
+          _fmpz_vec_clear(old, shard.length);
+        shard.blocks.clear();
+        shard.length = length;
+      }
+      if (shard.blocks.size() < CAPACITY) {
+        shard.blocks.push_back(block);
+        return;
+      }
+    }
+    _fmpz_vec_clear(block, length);
+  }
+
+ private:
+  Shard& shard() {
+    return shards[std::hash<std::thread::id>()(std::this_thread::get_id()) % SHARDS];
+  }
+
+  std::array<Shard, SHARDS> shards;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -39,7 +39,66 @@
 #define LIBFLATSURF_REM_(...) __VA_ARGS__
 #define LIBFLATSURF_REM(ARGS) LIBFLATSURF_REM_ ARGS
 
-#define LIBFLATSURF_REAL_TYPES (long long)(mpz_class)(mpq_class)(eantic::renf_elem_class)(exactreal::Element<exactreal::IntegerRing>)(exactreal::Element<exactreal::RationalField>)(exactreal::Element<exactreal::NumberField>)
+// The coordinate types for which the library is instantiated. Individual
+// types can be disabled with ./configure --with-coordinates which defines
+// LIBFLATSURF_WITHOUT_<TYPE> for each type that is not built.
+#ifdef LIBFLATSURF_WITHOUT_LONGLONG
+#define LIBFLATSURF_REAL_TYPES_LONGLONG
+#else
+#define LIBFLATSURF_REAL_TYPES_LONGLONG (long long)
+#endif
+
+#ifdef LIBFLATSURF_WITHOUT_MPZ
+#define LIBFLATSURF_REAL_TYPES_MPZ
+#else
+#define LIBFLATSURF_REAL_TYPES_MPZ (mpz_class)
+#endif
+
+#ifdef LIBFLATSURF_WITHOUT_MPQ
+#define LIBFLATSURF_REAL_TYPES_MPQ
+#else
+#define LIBFLATSURF_REAL_TYPES_MPQ (mpq_class)
+#endif
+
+#ifdef LIBFLATSURF_WITHOUT_RENF
+#define LIBFLATSURF_REAL_TYPES_RENF
+#else
+#define LIBFLATSURF_REAL_TYPES_RENF (eantic::renf_elem_class)
+#endif
+
+#ifdef LIBFLATSURF_WITHOUT_EXACTREAL_INTEGER
+#define LIBFLATSURF_REAL_TYPES_EXACTREAL_INTEGER
+#else
+#define LIBFLATSURF_REAL_TYPES_EXACTREAL_INTEGER (exactreal::Element<exactreal::IntegerRing>)
+#endif
+
+#ifdef LIBFLATSURF_WITHOUT_EXACTREAL_RATIONAL
+#define LIBFLATSURF_REAL_TYPES_EXACTREAL_RATIONAL
+#else
+#define LIBFLATSURF_REAL_TYPES_EXACTREAL_RATIONAL (exactreal::Element<exactreal::RationalField>)
+#endif
+
+#ifdef LIBFLATSURF_WITHOUT_EXACTREAL_NUMBER_FIELD
+#define LIBFLATSURF_REAL_TYPES_EXACTREAL_NUMBER_FIELD
+#else
+#define LIBFLATSURF_REAL_TYPES_EXACTREAL_NUMBER_FIELD (exactreal::Element<exactreal::NumberField>)
+#endif
+
+#define LIBFLATSURF_REAL_TYPES LIBFLATSURF_REAL_TYPES_LONGLONG LIBFLATSURF_REAL_TYPES_MPZ LIBFLATSURF_REAL_TYPES_MPQ LIBFLATSURF_REAL_TYPES_RENF LIBFLATSURF_REAL_TYPES_EXACTREAL_INTEGER LIBFLATSURF_REAL_TYPES_EXACTREAL_RATIONAL LIBFLATSURF_REAL_TYPES_EXACTREAL_NUMBER_FIELD
+
+// Floating point coordinates for quick exploration. Predicates on such
+// coordinates are decided up to a relative error, see Vector<double>, so
+// results are only heuristic. Flow decompositions (and everything else that
+// relies on interval exchange transformations) need exact coordinates, so
+// only the geometry of surfaces, i.e., their vectors, deformations, and
+// saddle connections, is instantiated for these types.
+#ifdef LIBFLATSURF_WITHOUT_DOUBLE
+#define LIBFLATSURF_FLOAT_TYPES
+#else
+#define LIBFLATSURF_FLOAT_TYPES (double)
+#endif
+
+#define LIBFLATSURF_GEOMETRY_TYPES LIBFLATSURF_REAL_TYPES LIBFLATSURF_FLOAT_TYPES
 
 #define LIBFLATSURF_SURFACE_TYPE_TEMPLATES (FlatTriangulation)(FlatTriangulationCollapsed)
 
@@ -51,6 +110,8 @@
 
 #define LIBFLATSURF_FLAT_TRIANGULATION_TYPES BOOST_PP_SEQ_FOR_EACH_PRODUCT(LIBFLATSURF_SURFACE_TYPE_TEMPLATES_WRAP, ((FlatTriangulation))(LIBFLATSURF_REAL_TYPES))
 
+#define LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES BOOST_PP_SEQ_FOR_EACH_PRODUCT(LIBFLATSURF_SURFACE_TYPE_TEMPLATES_WRAP, ((FlatTriangulation))(LIBFLATSURF_GEOMETRY_TYPES))
+
 #define LIBFLATSURF_FLAT_TRIANGULATION_COLLAPSED_TYPES BOOST_PP_SEQ_FOR_EACH_PRODUCT(LIBFLATSURF_SURFACE_TYPE_TEMPLATES_WRAP, ((FlatTriangulationCollapsed))(LIBFLATSURF_REAL_TYPES))
 
 #define LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION(T) \
@@ -0,0 +1,87 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_RECYCLING_STACK_IPP
+#define LIBFLATSURF_UTIL_RECYCLING_STACK_IPP
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace flatsurf {
+
+// A stack that keeps its elements alive when they are popped so that later
+// pushes can reuse their storage. This is useful for values such as Chain
+// whose copy assignment can recycle the memory of the value it overwrites.
+template <typename T>
+class RecyclingStack {
+ public:
+  // Push a copy of value by assigning it to a previously popped element.
+  void push(const T& value) {
+    if (used < slots.size())
+      slots[used] = value;
+    else
+      slots.push_back(value);
+    used++;
+  }
+
+  // Push value by swapping it with a previously popped element. So, value is
+  // left with the storage of that element which can be recycled by assigning
+  // to it. (If there is no such element, value is left in a moved-from state.)
+  void push(T&& value) {
+    if (used < slots.size()) {
+      using std::swap;
+      swap(slots[used], value);
+    } else {
+      slots.push_back(std::move(value));
+    }
+    used++;
+  }
+
+  T& top() {
+    assert(used && "cannot access top of empty stack");
+    return slots[used - 1];
+  }
+
+  // Remove the top element. The element is not destroyed but kept for
+  // recycling.
+  void pop() {
+    assert(used && "cannot pop from empty stack");
+    used--;
+  }
+
+  // Return the i-th element from the bottom of the stack.
+  const T& operator[](size_t i) const {
+    assert(i < used && "cannot access element beyond the top of the stack");
+    return slots[i];
+  }
+
+  size_t size() const { return used; }
+
+  bool empty() const { return used == 0; }
+
+ private:
+  std::vector<T> slots;
+  size_t used = 0;
+};
+
+}  // namespace flatsurf
+
+#endif
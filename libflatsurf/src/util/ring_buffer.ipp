@@ -0,0 +1,85 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_RING_BUFFER_IPP
+#define LIBFLATSURF_UTIL_RING_BUFFER_IPP
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace flatsurf {
+
+// A double ended queue of trivially copyable values in a circular buffer
+// that only grows. Unlike std::deque, this never allocates once it has
+// reached the maximum size that it is ever going to hold.
+template <typename T>
+class RingBuffer {
+  static_assert(std::is_trivially_copyable_v<T>, "RingBuffer only holds trivially copyable values");
+
+ public:
+  void push_back(T value) {
+    reserve();
+    buffer[(offset + used) % buffer.size()] = value;
+    used++;
+  }
+
+  void push_front(T value) {
+    reserve();
+    offset = (offset + buffer.size() - 1) % buffer.size();
+    buffer[offset] = value;
+    used++;
+  }
+
+  T front() const {
+    assert(used && "cannot access front of empty buffer");
+    return buffer[offset];
+  }
+
+  void pop_front() {
+    assert(used && "cannot pop from empty buffer");
+    offset = (offset + 1) % buffer.size();
+    used--;
+  }
+
+  size_t size() const { return used; }
+
+ private:
+  // Make sure there is room for another value.
+  void reserve() {
+    if (used < buffer.size())
+      return;
+
+    std::vector<T> grown(buffer.size() ? 2 * buffer.size() : 8);
+    for (size_t i = 0; i < used; i++)
+      grown[i] = buffer[(offset + i) % buffer.size()];
+
+    buffer = std::move(grown);
+    offset = 0;
+  }
+
+  std::vector<T> buffer;
+  size_t offset = 0;
+  size_t used = 0;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,78 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_SCRATCH_IPP
+#define LIBFLATSURF_UTIL_SCRATCH_IPP
+
+#include <cassert>
+#include <cstddef>
+#include <deque>
+
+namespace flatsurf {
+
+// Registers of type T to hold intermediate results of exact computations.
+// The registers are kept alive in a thread local stack, so that the
+// (heap allocated) storage of GMP and e-antic values is recycled by later
+// computations on the same thread instead of being allocated again.
+// Registers should be overwritten with assignments and compound assignments
+// such as `*=` which can reuse their storage.
+// Scratch must be used with stack discipline, i.e., it must be destroyed in
+// the reverse order of its creation on each thread; this is automatic when
+// it is only used as a local variable.
+template <typename T, size_t N>
+class Scratch {
+  struct Registers {
+    std::deque<T> registers;
+    size_t used = 0;
+  };
+
+ public:
+  Scratch() :
+    offset(registers().used) {
+    auto& registers = this->registers();
+    while (registers.registers.size() < offset + N)
+      registers.registers.emplace_back();
+    registers.used += N;
+  }
+
+  Scratch(const Scratch&) = delete;
+  Scratch& operator=(const Scratch&) = delete;
+
+  ~Scratch() {
+    assert(registers().used == offset + N && "scratch registers must be released in the reverse order of acquisition");
+    registers().used = offset;
+  }
+
+  T& operator[](size_t i) {
+    assert(i < N && "no such scratch register");
+    return registers().registers[offset + i];
+  }
+
+ private:
+  static Registers& registers() {
+    static thread_local Registers registers;
+    return registers;
+  }
+
+  const size_t offset;
+};
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,58 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_SHARDED_SET_IPP
+#define LIBFLATSURF_UTIL_SHARDED_SET_IPP
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace flatsurf {
+
+// A set that can be shared by several threads. The elements are distributed
+// over several shards by their hash, and each shard has its own lock, so
+// threads rarely wait for each other when inserting.
+template <typename T, typename Hash = std::hash<T>>
+class ShardedSet {
+  struct Shard {
+    std::mutex lock;
+    std::unordered_set<T, Hash> elements;
+  };
+
+ public:
+  explicit ShardedSet(size_t shards) :
+    shards(shards == 0 ? 1 : shards) {}
+
+  // Insert value and return whether it was not in the set before.
+  bool insert(const T& value) {
+    auto& shard = shards[Hash()(value) % shards.size()];
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.elements.insert(value).second;
+  }
+
+ private:
+  std::vector<Shard> shards;
+};
+
+}  // namespace flatsurf
+
+#endif
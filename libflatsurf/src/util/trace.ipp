@@ -0,0 +1,40 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_TRACE_IPP
+#define LIBFLATSURF_UTIL_TRACE_IPP
+
+#include <boost/preprocessor/cat.hpp>
+
+#include "../../flatsurf/tracing.hpp"
+
+// Record the time until the end of the current block as an event called
+// NAME in the trace, see Tracing. Unless the library has been configured
+// with --enable-tracing, this does nothing.
+#ifdef LIBFLATSURF_TRACING
+
+#define LIBFLATSURF_TRACE(NAME) ::flatsurf::Tracing::Scope BOOST_PP_CAT(trace_, __LINE__)(NAME)
+
+#else
+
+#define LIBFLATSURF_TRACE(NAME) static_cast<void>(0)
+
+#endif
+
+#endif
@@ -20,52 +20,59 @@
 #ifndef LIBFLATSURF_UTIL_UNION_FIND_IPP
 #define LIBFLATSURF_UTIL_UNION_FIND_IPP
 
-#include <boost/operators.hpp>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "assert.ipp"
 
 namespace flatsurf {
 namespace {
-// The classic union-find data structure to decide set membership in
-// (practically) O(1).
-template <typename T>
-class UnionFind : boost::equality_comparable<UnionFind<T>> {
-  mutable UnionFind const* parent;
-  const T repr;
+// The classic union-find data structure on the indices 0, …, size - 1 to
+// decide set membership in (practically) O(1).
+// Sets are merged by size and paths are halved on lookup. Everything is
+// stored in flat vectors so large instances do not allocate per element.
+class UnionFind {
+  std::vector<uint32_t> parent;
+  std::vector<uint32_t> sizes;
 
-  const UnionFind& top() {
-    if (parent == this)
-      return *this;
-    return *(parent = &parent->top());
+ public:
+  explicit UnionFind(size_t size) :
+    parent(size),
+    sizes(size, 1) {
+    std::iota(parent.begin(), parent.end(), 0);
   }
 
-  const UnionFind& top() const {
-    if (parent == this)
-      return *this;
-    return *(parent = &parent->top());
+  // Return the representative of the set containing i.
+  size_t find(size_t i) {
+    ASSERT(i < parent.size(), "index out of range of union-find");
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
   }
 
- public:
-  UnionFind(const T representative) :
-    repr(representative) {
-    parent = this;
+  // Merge the sets containing i and j. Return whether they were disjoint.
+  bool join(size_t i, size_t j) {
+    i = find(i);
+    j = find(j);
+    if (i == j)
+      return false;
+    if (sizes[i] < sizes[j])
+      std::swap(i, j);
+    parent[j] = static_cast<uint32_t>(i);
+    sizes[i] += sizes[j];
+    return true;
   }
 
-  UnionFind(const UnionFind&) = delete;
-  UnionFind(UnionFind&&) = delete;
-  UnionFind& operator=(const UnionFind&) = delete;
-  UnionFind& operator=(UnionFind&&) = delete;
+  bool equivalent(size_t i, size_t j) { return find(i) == find(j); }
 
-  bool operator==(const UnionFind& rhs) const {
-    return &top() == &rhs.top();
-  }
+  // Return the number of elements in the set containing i.
+  size_t size(size_t i) { return sizes[find(i)]; }
 
-  void join(const UnionFind& rhs) {
-    top().parent = &rhs.top();
-    assert(*this == rhs);
-  }
-
-  const T& representative() const {
-    return top().repr;
-  }
+  size_t size() const { return parent.size(); }
 };
 }  // namespace
 }  // namespace flatsurf
@@ -0,0 +1,187 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_WORK_STEALING_IPP
+#define LIBFLATSURF_UTIL_WORK_STEALING_IPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "../../flatsurf/executor.hpp"
+
+namespace flatsurf {
+
+// A minimal pool of threads that process tasks of type Task.
+// The threads are provided by Executor::global().
+// Each worker has its own queue of tasks. A worker takes tasks from the back
+// of its own queue and, when that queue is empty, steals from the front of
+// the queues of the other workers. Tasks may push further tasks while they
+// are being processed, e.g., to split up work when other workers are idle.
+template <typename Task>
+class WorkStealing {
+  struct Queue {
+    std::mutex lock;
+    std::deque<Task> tasks;
+  };
+
+ public:
+  explicit WorkStealing(size_t workers) :
+    queues(workers == 0 ? 1 : workers) {}
+
+  size_t workers() const { return queues.size(); }
+
+  // Enqueue task into the queue of the given worker.
+  void push(size_t worker, Task task) {
+    pending++;
+    auto& queue = queues[worker % queues.size()];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    queue.tasks.push_back(std::move(task));
+  }
+
+  // Return whether some of the workers are currently out of work, i.e., it
+  // might be beneficial to push some more tasks.
+  bool hungry() const { return idle > 0; }
+
+  // Process all tasks with work(worker, task) until no tasks are pending
+  // anymore. Exceptions thrown in a worker are rethrown here once all
+  // threads have stopped.
+  // The calling thread works as worker 0, the other workers are handed to
+  // Executor::global(). Since the calling thread steals all the tasks
+  // eventually, this completes even if the executor never runs the other
+  // workers.
+  template <typename Work>
+  void run(Work&& work) {
+    std::exception_ptr error;
+    std::mutex errorLock;
+    std::atomic<bool> aborted{false};
+
+    const auto loop = [&](size_t worker) {
+      bool waiting = false;
+      try {
+        while (pending && !aborted) {
+          auto task = pop(worker);
+          if (!task) {
+            if (!waiting) {
+              waiting = true;
+              idle++;
+            }
+            std::this_thread::yield();
+            continue;
+          }
+          if (waiting) {
+            waiting = false;
+            idle--;
+          }
+          work(worker, std::move(*task));
+          pending--;
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(errorLock);
+        if (!error)
+          error = std::current_exception();
+        aborted = true;
+      }
+      if (waiting)
+        idle--;
+    };
+
+    // Workers that start after the calling thread has completed all tasks
+    // do nothing; in particular they do not touch loop anymore.
+    struct Workers {
+      std::mutex lock;
+      std::condition_variable stopped;
+      size_t running = 0;
+      bool closed = false;
+    };
+    const auto workers = std::make_shared<Workers>();
+
+    const auto executor = Executor::global();
+    for (size_t worker = 1; worker < queues.size(); worker++)
+      executor.submit([workers, &loop, worker]() {
+        {
+          std::lock_guard<std::mutex> guard(workers->lock);
+          if (workers->closed)
+            return;
+          workers->running++;
+        }
+        loop(worker);
+        {
+          std::lock_guard<std::mutex> guard(workers->lock);
+          workers->running--;
+        }
+        workers->stopped.notify_all();
+      });
+
+    // The calling thread participates as worker 0.
+    loop(0);
+
+    {
+      std::unique_lock<std::mutex> guard(workers->lock);
+      workers->closed = true;
+      workers->stopped.wait(guard, [&]() { return workers->running == 0; });
+    }
+
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+ private:
+  std::optional<Task> pop(size_t worker) {
+    {
+      auto& own = queues[worker];
+      std::lock_guard<std::mutex> guard(own.lock);
+      if (own.tasks.size()) {
+        Task task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        return task;
+      }
+    }
+
+    for (size_t i = 1; i < queues.size(); i++) {
+      auto& victim = queues[(worker + i) % queues.size()];
+      std::lock_guard<std::mutex> guard(victim.lock);
+      if (victim.tasks.size()) {
+        Task task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return task;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  std::vector<Queue> queues;
+
+  // The number of tasks that have been pushed but have not been completed.
+  std::atomic<size_t> pending{0};
+
+  // The number of workers that are currently waiting for work.
+  std::atomic<size_t> idle{0};
+};
+
+}  // namespace flatsurf
+
+#endif
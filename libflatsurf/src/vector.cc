@@ -22,8 +22,13 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <flint/fmpq_poly.h>
+
+#include <algorithm>
+#include <array>
 #include <boost/type_traits/is_detected.hpp>
 #include <boost/type_traits/is_detected_exact.hpp>
+#include <e-antic/renfxx.h>
 #include <exact-real/arb.hpp>
 #include <exact-real/arf.hpp>
 #include <exact-real/element.hpp>
@@ -35,9 +40,12 @@
 
 #include "../flatsurf/bound.hpp"
 #include "../flatsurf/ccw.hpp"
+#include "../flatsurf/exact_fallbacks.hpp"
 #include "../flatsurf/fmt.hpp"
 #include "../flatsurf/orientation.hpp"
 #include "impl/approximation.hpp"
+#include "impl/exact_fallbacks.impl.hpp"
+#include "impl/floating_point.hpp"
 #include "impl/vector.impl.hpp"
 #include "util/assert.ipp"
 #include "util/hash.ipp"
@@ -53,6 +61,15 @@ namespace flatsurf {
 // precision for that.
 using exactreal::ARB_PRECISION_FAST;
 
+// Return the precision for an operation on these balls, i.e., the
+// precision of the most precise one but at least ARB_PRECISION_FAST, so that
+// balls that have been approximated to a higher precision, see
+// PrecisionPolicy, keep it through arithmetic.
+template <typename... Balls>
+slong precision(const Balls&... balls) {
+  return std::max<slong>({ARB_PRECISION_FAST, arb_bits(balls.arb_t())...});
+}
+
 template <typename S, typename T>
 inline constexpr bool Similar = std::is_same_v<std::decay_t<S>, std::decay_t<T>>;
 
@@ -74,6 +91,87 @@ inline constexpr bool IsMPQ = Similar<T, mpq_class>;
 template <typename T>
 inline constexpr bool IsLongLong = Similar<T, long long>;
 
+template <typename T>
+inline constexpr bool IsDouble = Similar<T, double>;
+
+// Most surfaces with GMP coordinates that we work with, e.g., square-tiled
+// surfaces, have very small coordinates, and GMP's overhead dominates the
+// arithmetic in the predicates below. So we first try to evaluate the
+// predicates on machine integers and only fall back to GMP on overflow.
+template <typename T>
+std::optional<long long> machineInteger(const T& value) {
+  if constexpr (IsMPZ<T>) {
+    if (mpz_fits_slong_p(value.get_mpz_t()))
+      return mpz_get_si(value.get_mpz_t());
+  } else if constexpr (IsMPQ<T>) {
+    if (mpz_cmp_ui(value.get_den_mpz_t(), 1) == 0 && mpz_fits_slong_p(value.get_num_mpz_t()))
+      return mpz_get_si(value.get_num_mpz_t());
+  }
+  return std::nullopt;
+}
+
+// Return a * b + c * d unless this overflows.
+inline std::optional<long long> machineDot(long long a, long long b, long long c, long long d) {
+  long long ab, cd, dot;
+  if (__builtin_mul_overflow(a, b, &ab) || __builtin_mul_overflow(c, d, &cd) || __builtin_add_overflow(ab, cd, &dot))
+    return std::nullopt;
+  return dot;
+}
+
+// Return the sign of a * b - c * d unless the products overflow.
+inline std::optional<int> machineCompareProducts(long long a, long long b, long long c, long long d) {
+  long long ab, cd;
+  if (__builtin_mul_overflow(a, b, &ab) || __builtin_mul_overflow(c, d, &cd))
+    return std::nullopt;
+  return (ab > cd) - (ab < cd);
+}
+
+// Most of the number field surfaces that we work with, e.g., Veech surfaces,
+// are defined over real quadratic fields. When the Arb approximations cannot
+// decide a predicate, the vectors are usually collinear or orthogonal. Over a
+// quadratic field, i.e., with elements (p + qα)/d, we can detect that with a
+// few integer multiplications instead of going through the generic
+// polynomial arithmetic of e-antic.
+// Return whether a·b + sgn·c·d vanishes if all elements live in the same
+// quadratic field; return nothing otherwise.
+template <typename T>
+std::optional<bool> quadraticVanishes(const T& a, const T& b, const T& c, const T& d, int sgn) {
+  if constexpr (IsEAntic<T>) {
+    const auto& K = a.parent();
+    if (K.degree() != 2 || !(b.parent() == K) || !(c.parent() == K) || !(d.parent() == K))
+      return std::nullopt;
+
+    // The defining polynomial c₀ + c₁x + c₂x² of the field with integer
+    // coefficients.
+    std::array<mpz_class, 3> pol;
+    for (slong i = 0; i < 3; i++)
+      fmpz_get_mpz(pol[i].get_mpz_t(), fmpq_poly_numref(K.renf_t()->nf->pol) + i);
+
+    // Write x·y·c₂ as p + qα with integers p and q, ignoring the
+    // denominators of x and y.
+    const auto mul = [&](const T& x, const T& y) {
+      auto xs = x.num_vector();
+      auto ys = y.num_vector();
+      xs.resize(2);
+      ys.resize(2);
+      const mpz_class square = xs[1] * ys[1];
+      return std::pair<mpz_class, mpz_class>(pol[2] * xs[0] * ys[0] - pol[0] * square, pol[2] * (xs[0] * ys[1] + xs[1] * ys[0]) - pol[1] * square);
+    };
+
+    auto [p, q] = mul(a, b);
+    auto [p_, q_] = mul(c, d);
+
+    // Bring both products to the same denominator.
+    const mpz_class scale = c.den() * d.den();
+    const mpz_class scale_ = sgn * a.den() * b.den();
+
+    // Since α is irrational, p + qα vanishes iff p and q vanish.
+    return p * scale + p_ * scale_ == 0 && q * scale + q_ * scale_ == 0;
+  } else {
+    return std::nullopt;
+  }
+}
+
 template <typename T>
 using binary_inplace_div_int_t = decltype(std::declval<T>() /= std::declval<int>());
 template <typename T>
@@ -84,17 +182,27 @@ using binary_inplace_div_mpz_t = decltype(std::declval<T>() /= std::declval<mpz_
 template <typename T>
 static constexpr bool has_binary_inplace_div_mpz = boost::is_detected_v<binary_inplace_div_mpz_t, T>;
 
+// Create the storage of a Vector<T> from args, see detail::VectorStorage.
+template <typename T, typename... Args>
+typename detail::VectorStorage<T>::type makeVectorStorage(Args&&... args) {
+  using Storage = typename detail::VectorStorage<T>::type;
+  if constexpr (std::is_same_v<Storage, Copyable<Vector<T>>>)
+    return spimpl::make_impl<ImplementationOf<Vector<T>>>(std::forward<Args>(args)...);
+  else
+    return Storage::make(std::forward<Args>(args)...);
+}
+
 template <typename T>
 Vector<T>::Vector() noexcept :
-  self(spimpl::make_impl<ImplementationOf<Vector>>()) {}
+  self(makeVectorStorage<T>()) {}
 
 template <typename T>
 Vector<T>::Vector(const T& x, const T& y) :
-  self(spimpl::make_impl<ImplementationOf<Vector>>(x, y)) {}
+  self(makeVectorStorage<T>(x, y)) {}
 
 template <typename T>
 Vector<T>::Vector(T&& x, T&& y) :
-  self(spimpl::make_impl<ImplementationOf<Vector>>(std::move(x), std::move(y))) {}
+  self(makeVectorStorage<T>(std::move(x), std::move(y))) {}
 
 template <typename T>
 T Vector<T>::x() const { return self->x; }
@@ -112,11 +220,11 @@ Vector& detail::VectorBase<Vector>::operator+=(const Vector& rhs) {
     // particular in DEBUG builds for this operation that is called all the
     // time. So we have to call arb_add directly here.
 
-    // this->x += rhs.self->x(ARB_PRECISION_FAST);
-    arb_add(self.self->x.arb_t(), self.self->x.arb_t(), rhs.self->x.arb_t(), ARB_PRECISION_FAST);
+    // this->x += rhs.self->x;
+    arb_add(self.self->x.arb_t(), self.self->x.arb_t(), rhs.self->x.arb_t(), precision(self.self->x, rhs.self->x));
 
-    // this->y += rhs.self->y(ARB_PRECISION_FAST);
-    arb_add(self.self->y.arb_t(), self.self->y.arb_t(), rhs.self->y.arb_t(), ARB_PRECISION_FAST);
+    // this->y += rhs.self->y;
+    arb_add(self.self->y.arb_t(), self.self->y.arb_t(), rhs.self->y.arb_t(), precision(self.self->y, rhs.self->y));
   } else {
     self.self->x += rhs.self->x;
     self.self->y += rhs.self->y;
@@ -143,8 +251,8 @@ Vector& detail::VectorBase<Vector>::operator*=(const int rhs) {
   Vector& self = static_cast<Vector&>(*this);
 
   if constexpr (IsArb<T>) {
-    arb_mul_si(self.self->x.arb_t(), self.self->x.arb_t(), rhs, ARB_PRECISION_FAST);
-    arb_mul_si(self.self->y.arb_t(), self.self->y.arb_t(), rhs, ARB_PRECISION_FAST);
+    arb_mul_si(self.self->x.arb_t(), self.self->x.arb_t(), rhs, precision(self.self->x));
+    arb_mul_si(self.self->y.arb_t(), self.self->y.arb_t(), rhs, precision(self.self->y));
   } else {
     self.self->x *= rhs;
     self.self->y *= rhs;
@@ -161,6 +269,9 @@ Vector& detail::VectorBase<Vector>::operator*=(const mpz_class& rhs) {
   if constexpr (IsArb<T>) {
     self.self->x *= exactreal::Arb(rhs)(ARB_PRECISION_FAST);
     self.self->y *= exactreal::Arb(rhs)(ARB_PRECISION_FAST);
+  } else if constexpr (IsDouble<T>) {
+    self.self->x *= rhs.get_d();
+    self.self->y *= rhs.get_d();
   } else if constexpr (IsLongLong<T>) {
     using gmpxxll::mpz_class;
     ASSERT(rhs * mpz_class(self.self->x) <= mpz_class(LONG_LONG_MAX), "Multiplication overflow");
@@ -181,11 +292,12 @@ Vector& detail::VectorBase<Vector>::operator/=(const int rhs) {
   Vector& self = static_cast<Vector&>(*this);
 
   if constexpr (IsArb<T>) {
-    arb_div_si(self.self->x.arb_t(), self.self->x.arb_t(), rhs, ARB_PRECISION_FAST);
-    arb_div_si(self.self->y.arb_t(), self.self->y.arb_t(), rhs, ARB_PRECISION_FAST);
-  } else if constexpr (IsLongLong<T> || has_binary_inplace_div_int<T>) {
-    // Strangely, we need to explicitly check for long long here since
-    // has_binary_inplace_div_int does not work for long long.
+    arb_div_si(self.self->x.arb_t(), self.self->x.arb_t(), rhs, precision(self.self->x));
+    arb_div_si(self.self->y.arb_t(), self.self->y.arb_t(), rhs, precision(self.self->y));
+  } else if constexpr (IsLongLong<T> || IsDouble<T> || has_binary_inplace_div_int<T>) {
+    // Strangely, we need to explicitly check for long long (and double)
+    // here since has_binary_inplace_div_int does not work for primitive
+    // types.
     self.self->x /= rhs;
     self.self->y /= rhs;
   } else {
@@ -213,6 +325,9 @@ Vector& detail::VectorBase<Vector>::operator/=(const mpz_class& rhs) {
       self.self->x /= mpz_class(rhs).get_sll();
       self.self->y /= mpz_class(rhs).get_sll();
     }
+  } else if constexpr (IsDouble<T>) {
+    self.self->x /= rhs.get_d();
+    self.self->y /= rhs.get_d();
   } else if constexpr (has_binary_inplace_div_mpz<T>) {
     self.self->x /= rhs;
     self.self->y /= rhs;
@@ -258,8 +373,9 @@ template <typename Vector>
 std::optional<CCW> detail::VectorWithError<Vector>::ccw(const Vector& rhs) const {
   const Vector& self = static_cast<const Vector&>(*this);
 
-  const exactreal::Arb a = (self.self->x * rhs.self->y)(ARB_PRECISION_FAST);
-  const exactreal::Arb b = (rhs.self->x * self.self->y)(ARB_PRECISION_FAST);
+  const slong prec = precision(self.self->x, self.self->y, rhs.self->x, rhs.self->y);
+  const exactreal::Arb a = (self.self->x * rhs.self->y)(prec);
+  const exactreal::Arb b = (rhs.self->x * self.self->y)(prec);
 
   const bool overlaps = arb_overlaps(a.arb_t(), b.arb_t());
   if (overlaps) {
@@ -285,7 +401,7 @@ std::optional<ORIENTATION> detail::VectorWithError<Vector>::orientation(const Ve
   const Vector& self = static_cast<const Vector&>(*this);
 
   // Arb also has a built-in dot product. It's probably not doing anything else in 2d.
-  const exactreal::Arb dot = (self.self->x * rhs.self->x + self.self->y * rhs.self->y)(ARB_PRECISION_FAST);
+  const exactreal::Arb dot = (self.self->x * rhs.self->x + self.self->y * rhs.self->y)(precision(self.self->x, self.self->y, rhs.self->x, rhs.self->y));
 
   auto cmp = dot > 0;
   if (cmp.has_value()) {
@@ -305,7 +421,7 @@ std::optional<ORIENTATION> detail::VectorWithError<Vector>::orientation(const Ve
 }
 
 template <typename Vector>
-std::optional<bool> detail::VectorWithError<Vector>::operator>(Bound bound) const {
+std::optional<bool> detail::VectorWithError<Vector>::operator>(const Bound& bound) const {
   const Vector& self = static_cast<const Vector&>(*this);
 
   if (!bound) {
@@ -313,12 +429,12 @@ std::optional<bool> detail::VectorWithError<Vector>::operator>(Bound bound) cons
     if (nonzero) return *nonzero;
   }
 
-  exactreal::Arb size = (self.self->x * self.self->x + self.self->y * self.self->y)(ARB_PRECISION_FAST);
+  exactreal::Arb size = (self.self->x * self.self->x + self.self->y * self.self->y)(precision(self.self->x, self.self->y));
   return size > bound.squared();
 }
 
 template <typename Vector>
-std::optional<bool> detail::VectorWithError<Vector>::operator>=(Bound bound) const {
+std::optional<bool> detail::VectorWithError<Vector>::operator>=(const Bound& bound) const {
   const auto lt = *this < bound;
 
   if (!lt)
@@ -328,16 +444,16 @@ std::optional<bool> detail::VectorWithError<Vector>::operator>=(Bound bound) con
 }
 
 template <typename Vector>
-std::optional<bool> detail::VectorWithError<Vector>::operator<(Bound bound) const {
+std::optional<bool> detail::VectorWithError<Vector>::operator<(const Bound& bound) const {
   const Vector& self = static_cast<const Vector&>(*this);
 
   if (!bound) return false;
-  exactreal::Arb size = (self.self->x * self.self->x + self.self->y * self.self->y)(ARB_PRECISION_FAST);
+  exactreal::Arb size = (self.self->x * self.self->x + self.self->y * self.self->y)(precision(self.self->x, self.self->y));
   return size < bound.squared();
 }
 
 template <typename Vector>
-std::optional<bool> detail::VectorWithError<Vector>::operator<=(Bound bound) const {
+std::optional<bool> detail::VectorWithError<Vector>::operator<=(const Bound& bound) const {
   const auto gt = *this > bound;
 
   if (!gt)
@@ -392,7 +508,7 @@ template <typename Vector>
 exactreal::Arb detail::VectorWithError<Vector>::operator*(const Vector& rhs) const {
   const Vector& self = static_cast<const Vector&>(*this);
 
-  return (self.self->x * rhs.self->x + self.self->y * rhs.self->y)(ARB_PRECISION_FAST);
+  return (self.self->x * rhs.self->x + self.self->y * rhs.self->y)(precision(self.self->x, self.self->y, rhs.self->x, rhs.self->y));
 }
 
 template <typename Vector, typename T>
@@ -413,9 +529,36 @@ CCW detail::VectorExact<Vector, T>::ccw(const Vector& other) const {
   };
 
   if constexpr (IsEAntic<T> || IsExactReal<T>) {
+    static const size_t site = ImplementationOf<ExactFallbacks>::site("Vector::ccw");
+
     const auto maybeCcw = static_cast<flatsurf::Vector<exactreal::Arb>>(self).ccw(static_cast<flatsurf::Vector<exactreal::Arb>>(other));
-    if (maybeCcw)
+    if (maybeCcw) {
+      ImplementationOf<ExactFallbacks>::decided(site);
       return *maybeCcw;
+    }
+
+    const ImplementationOf<ExactFallbacks>::Fallback fallback(site);
+
+    if (quadraticVanishes(self.self->x, other.self->y, other.self->x, self.self->y, -1) == true)
+      return CCW::COLLINEAR;
+
+    return ccwExact(self, other);
+  }
+
+  if constexpr (IsMPZ<T> || IsMPQ<T>) {
+    const auto x = machineInteger(self.self->x), y = machineInteger(self.self->y), x_ = machineInteger(other.self->x), y_ = machineInteger(other.self->y);
+    if (x && y && x_ && y_) {
+      const auto cmp = machineCompareProducts(*x, *y_, *x_, *y);
+      if (cmp)
+        return *cmp == 0 ? CCW::COLLINEAR : (*cmp > 0 ? CCW::COUNTERCLOCKWISE : CCW::CLOCKWISE);
+    }
+  }
+
+  if constexpr (IsDouble<T>) {
+    const double det = self.self->x * other.self->y - other.self->x * self.self->y;
+    if (std::abs(det) <= floatTolerance(self.self->x, self.self->y, other.self->x, other.self->y))
+      return CCW::COLLINEAR;
+    return det > 0 ? CCW::COUNTERCLOCKWISE : CCW::CLOCKWISE;
   }
 
   return ccwExact(self, other);
@@ -438,9 +581,36 @@ ORIENTATION detail::VectorExact<Vector, T>::orientation(const Vector& other) con
   };
 
   if constexpr (IsEAntic<T> || IsExactReal<T>) {
+    static const size_t site = ImplementationOf<ExactFallbacks>::site("Vector::orientation");
+
     const auto maybeOrientation = static_cast<flatsurf::Vector<exactreal::Arb>>(self).orientation(static_cast<flatsurf::Vector<exactreal::Arb>>(other));
-    if (maybeOrientation)
+    if (maybeOrientation) {
+      ImplementationOf<ExactFallbacks>::decided(site);
       return *maybeOrientation;
+    }
+
+    const ImplementationOf<ExactFallbacks>::Fallback fallback(site);
+
+    if (quadraticVanishes(self.self->x, other.self->x, self.self->y, other.self->y, 1) == true)
+      return ORIENTATION::ORTHOGONAL;
+
+    return orientationExact(self, other);
+  }
+
+  if constexpr (IsMPZ<T> || IsMPQ<T>) {
+    const auto x = machineInteger(self.self->x), y = machineInteger(self.self->y), x_ = machineInteger(other.self->x), y_ = machineInteger(other.self->y);
+    if (x && y && x_ && y_) {
+      const auto dot = machineDot(*x, *x_, *y, *y_);
+      if (dot)
+        return *dot == 0 ? ORIENTATION::ORTHOGONAL : (*dot > 0 ? ORIENTATION::SAME : ORIENTATION::OPPOSITE);
+    }
+  }
+
+  if constexpr (IsDouble<T>) {
+    const double dot = self * other;
+    if (std::abs(dot) <= floatTolerance(self.self->x, self.self->y, other.self->x, other.self->y))
+      return ORIENTATION::ORTHOGONAL;
+    return dot > 0 ? ORIENTATION::SAME : ORIENTATION::OPPOSITE;
   }
 
   return orientationExact(self, other);
@@ -454,33 +624,109 @@ T detail::VectorExact<Vector, T>::operator*(const Vector& rhs) const {
 }
 
 template <typename Vector, typename T>
-bool detail::VectorExact<Vector, T>::operator>(Bound bound) const {
+bool detail::VectorExact<Vector, T>::operator>(const Bound& bound) const {
   const Vector& self = static_cast<const Vector&>(*this);
 
   if (!bound) return static_cast<bool>(self);
 
   if constexpr (IsEAntic<T> || IsExactReal<T>) {
+    static const size_t site = ImplementationOf<ExactFallbacks>::site("Vector::operator>(Bound)");
+
     const auto maybe = static_cast<flatsurf::Vector<exactreal::Arb>>(self) > bound;
-    if (maybe)
+    if (maybe) {
+      ImplementationOf<ExactFallbacks>::decided(site);
       return *maybe;
+    }
+
+    const ImplementationOf<ExactFallbacks>::Fallback fallback(site);
+
+    if constexpr (IsExactReal<T>)
+      return self.self->x * self.self->x + self.self->y * self.self->y > ::gmpxxll::mpz_class(bound.squared());
+    else
+      return self.self->x * self.self->x + self.self->y * self.self->y > bound.squared();
+  }
+
+  if constexpr (IsDouble<T>)
+    return floatCompare(self * self, bound.squared().get_d()) > 0;
+
+  if constexpr (IsMPZ<T> || IsMPQ<T> || IsLongLong<T>) {
+    const auto squared = bound.machineSquared();
+    if (squared) {
+      std::optional<long long> x, y;
+      if constexpr (IsLongLong<T>) {
+        x = self.self->x;
+        y = self.self->y;
+      } else {
+        x = machineInteger(self.self->x);
+        y = machineInteger(self.self->y);
+      }
+      if (x && y) {
+        const auto length = machineDot(*x, *x, *y, *y);
+        if (length)
+          return *length > *squared;
+      }
+    }
   }
 
-  return self.x() * self.x() + self.y() * self.y() > ::gmpxxll::mpz_class(bound.squared());
+  if constexpr (IsLongLong<T>)
+    return ::gmpxxll::mpz_class(self.self->x) * ::gmpxxll::mpz_class(self.self->x) + ::gmpxxll::mpz_class(self.self->y) * ::gmpxxll::mpz_class(self.self->y) > bound.squared();
+  else if constexpr (IsExactReal<T>)
+    return self.self->x * self.self->x + self.self->y * self.self->y > ::gmpxxll::mpz_class(bound.squared());
+  else
+    return self.self->x * self.self->x + self.self->y * self.self->y > bound.squared();
 }
 
 template <typename Vector, typename T>
-bool detail::VectorExact<Vector, T>::operator<(Bound bound) const {
+bool detail::VectorExact<Vector, T>::operator<(const Bound& bound) const {
   const Vector& self = static_cast<const Vector&>(*this);
 
   if (!bound) return false;
 
   if constexpr (IsEAntic<T> || IsExactReal<T>) {
+    static const size_t site = ImplementationOf<ExactFallbacks>::site("Vector::operator<(Bound)");
+
     const auto maybe = static_cast<flatsurf::Vector<exactreal::Arb>>(self) < bound;
-    if (maybe)
+    if (maybe) {
+      ImplementationOf<ExactFallbacks>::decided(site);
       return *maybe;
+    }
+
+    const ImplementationOf<ExactFallbacks>::Fallback fallback(site);
+
+    if constexpr (IsExactReal<T>)
+      return self.self->x * self.self->x + self.self->y * self.self->y < ::gmpxxll::mpz_class(bound.squared());
+    else
+      return self.self->x * self.self->x + self.self->y * self.self->y < bound.squared();
   }
 
-  return self.x() * self.x() + self.y() * self.y() < ::gmpxxll::mpz_class(bound.squared());
+  if constexpr (IsDouble<T>)
+    return floatCompare(self * self, bound.squared().get_d()) < 0;
+
+  if constexpr (IsMPZ<T> || IsMPQ<T> || IsLongLong<T>) {
+    const auto squared = bound.machineSquared();
+    if (squared) {
+      std::optional<long long> x, y;
+      if constexpr (IsLongLong<T>) {
+        x = self.self->x;
+        y = self.self->y;
+      } else {
+        x = machineInteger(self.self->x);
+        y = machineInteger(self.self->y);
+      }
+      if (x && y) {
+        const auto length = machineDot(*x, *x, *y, *y);
+        if (length)
+          return *length < *squared;
+      }
+    }
+  }
+
+  if constexpr (IsLongLong<T>)
+    return ::gmpxxll::mpz_class(self.self->x) * ::gmpxxll::mpz_class(self.self->x) + ::gmpxxll::mpz_class(self.self->y) * ::gmpxxll::mpz_class(self.self->y) < bound.squared();
+  else if constexpr (IsExactReal<T>)
+    return self.self->x * self.self->x + self.self->y * self.self->y < ::gmpxxll::mpz_class(bound.squared());
+  else
+    return self.self->x * self.self->x + self.self->y * self.self->y < bound.squared();
 }
 
 template <typename Vector, typename T>
@@ -571,6 +817,21 @@ bool detail::VectorExact<Vector, T>::CompareSlope::operator()(const Vector& lhs,
   ASSERT(lhs.x() || lhs.y(), "zero vector has no slope");
   ASSERT(rhs.x() || rhs.y(), "zero vector has no slope");
 
+  if constexpr (IsMPZ<T> || IsMPQ<T>) {
+    const auto x = machineInteger(lhs.self->x), y = machineInteger(lhs.self->y), x_ = machineInteger(rhs.self->x), y_ = machineInteger(rhs.self->y);
+    if (x && y && x_ && y_) {
+      const int lhs_infinite = *x ? 0 : (*y < 0 ? -1 : 1);
+      const int rhs_infinite = *x_ ? 0 : (*y_ < 0 ? -1 : 1);
+
+      if (lhs_infinite || rhs_infinite)
+        return lhs_infinite < rhs_infinite;
+
+      const auto cmp = machineCompareProducts(*y, *x_, *y_, *x);
+      if (cmp)
+        return ((*x < 0) == (*x_ < 0)) ? *cmp < 0 : *cmp > 0;
+    }
+  }
+
   const int lhs_infinite = lhs.x() ? 0 : (lhs.y() < 0 ? -1 : 1);
   const int rhs_infinite = rhs.x() ? 0 : (rhs.y() < 0 ? -1 : 1);
 
@@ -598,6 +859,15 @@ bool detail::VectorExact<Vector, T>::CompareLength::operator()(const Vector& lhs
       return *maybe;
   }
 
+  if constexpr (IsMPZ<T> || IsMPQ<T>) {
+    const auto x = machineInteger(lhs.self->x), y = machineInteger(lhs.self->y), x_ = machineInteger(rhs.self->x), y_ = machineInteger(rhs.self->y);
+    if (x && y && x_ && y_) {
+      const auto length = machineDot(*x, *x, *y, *y), length_ = machineDot(*x_, *x_, *y_, *y_);
+      if (length && length_)
+        return *length < *length_;
+    }
+  }
+
   return lhs * lhs < rhs * rhs;
 }
 
@@ -653,7 +923,7 @@ size_t hash<Vector<T>>::operator()(const Vector<T>& self) const {
   template class VectorBase<Vector<T>>;                    \
   }
 
-LIBFLATSURF_INSTANTIATE_MANY((LIBFLATSURF_INSTANTIATE_THIS), LIBFLATSURF_REAL_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY((LIBFLATSURF_INSTANTIATE_THIS), LIBFLATSURF_GEOMETRY_TYPES)
 
 template class ::flatsurf::Vector<exactreal::Arb>;
 template class ::flatsurf::detail::VectorWithError<::flatsurf::Vector<exactreal::Arb>>;
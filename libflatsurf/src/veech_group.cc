@@ -0,0 +1,252 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/veech_group.hpp"
+
+#include <flint/fmpq.h>
+
+#include <algorithm>
+#include <exact-real/arb.hpp>
+#include <ostream>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "../flatsurf/ccw.hpp"
+#include "../flatsurf/deformation.hpp"
+#include "../flatsurf/executor.hpp"
+#include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/isomorphism.hpp"
+#include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connections.hpp"
+#include "../flatsurf/saddle_connections_by_length.hpp"
+#include "../flatsurf/saddle_connections_by_length_iterator.hpp"
+#include "../flatsurf/saddle_connections_iterator.hpp"
+#include "../flatsurf/vertex.hpp"
+#include "impl/veech_group.impl.hpp"
+#include "util/work_stealing.ipp"
+
+namespace flatsurf {
+
+namespace {
+
+template <typename T>
+T cross(const Vector<T>& lhs, const Vector<T>& rhs) {
+  return lhs.x() * rhs.y() - lhs.y() * rhs.x();
+}
+
+exactreal::Arb cross(const Vector<exactreal::Arb>& lhs, const Vector<exactreal::Arb>& rhs) {
+  const slong prec = exactreal::ARB_PRECISION_FAST;
+
+  exactreal::Arb ret, yx;
+  arb_mul(ret.arb_t(), lhs.x().arb_t(), rhs.y().arb_t(), prec);
+  arb_mul(yx.arb_t(), lhs.y().arb_t(), rhs.x().arb_t(), prec);
+  arb_sub(ret.arb_t(), ret.arb_t(), yx.arb_t(), prec);
+  return ret;
+}
+
+}  // namespace
+
+template <typename Surface>
+VeechGroup<Surface>::VeechGroup(const Surface& surface) :
+  self(spimpl::make_unique_impl<ImplementationOf<VeechGroup>>(surface)) {}
+
+template <typename Surface>
+std::pair<Vector<typename Surface::Coordinate>, Vector<typename Surface::Coordinate>> VeechGroup<Surface>::reference() const {
+  return {self->u, self->v};
+}
+
+template <typename Surface>
+std::vector<typename VeechGroup<Surface>::Element> VeechGroup<Surface>::elements(Bound bound, unsigned int threads) const {
+  if (threads == 0)
+    threads = Executor::global().concurrency();
+
+  // The holonomy vectors of the saddle connections of length at most bound.
+  // Each vector is only considered once even if there are several saddle
+  // connections with that holonomy, so that each matrix is verified only
+  // once.
+  std::vector<Vector<T>> holonomies;
+  {
+    std::unordered_set<Vector<T>> seen;
+    for (const auto& connection : self->surface.connections().bound(bound))
+      if (seen.insert(connection.vector()).second)
+        holonomies.push_back(connection.vector());
+  }
+
+  std::vector<Vector<exactreal::Arb>> approximations;
+  approximations.reserve(holonomies.size());
+  for (const auto& holonomy : holonomies)
+    approximations.push_back(static_cast<Vector<exactreal::Arb>>(holonomy));
+
+  // The candidate images (g·u, g·v) as indices into holonomies.
+  std::vector<std::pair<size_t, size_t>> candidates;
+  for (size_t i = 0; i < holonomies.size(); i++)
+    for (size_t j = 0; j < holonomies.size(); j++)
+      if (self->plausible(approximations[i], approximations[j]) && cross(holonomies[i], holonomies[j]) == self->denominator)
+        candidates.emplace_back(i, j);
+
+  if (candidates.empty())
+    return {};
+
+  // Each candidate is verified independently, so each task writes to its
+  // own entry.
+  std::vector<std::optional<Element>> verified(candidates.size());
+
+  WorkStealing<size_t> pool(std::min<size_t>(threads, candidates.size()));
+  for (size_t i = 0; i < candidates.size(); i++)
+    pool.push(i, i);
+
+  pool.run([&](size_t, size_t candidate) {
+    verified[candidate] = self->verify(holonomies[candidates[candidate].first], holonomies[candidates[candidate].second]);
+  });
+
+  std::vector<Element> elements;
+  for (auto& element : verified)
+    if (element)
+      elements.push_back(std::move(*element));
+
+  return elements;
+}
+
+template <typename Surface>
+const Surface& VeechGroup<Surface>::surface() const {
+  return self->surface;
+}
+
+template <typename Surface>
+ImplementationOf<VeechGroup<Surface>>::ImplementationOf(const Surface& surface) :
+  surface(surface.clone()) {
+  this->surface.delaunay();
+
+  const auto reference = [&]() -> std::pair<Vector<T>, Vector<T>> {
+    std::optional<Vector<T>> shortest;
+    for (const auto& connection : this->surface.connections().byLength()) {
+      if (!shortest)
+        shortest = connection.vector();
+      else if (shortest->ccw(connection.vector()) != CCW::COLLINEAR)
+        return {*shortest, connection.vector()};
+    }
+    throw std::invalid_argument("surface must have two non-parallel saddle connections to determine its Veech group elements");
+  }();
+
+  u = reference.first;
+  v = reference.second;
+  denominator = cross(u, v);
+
+  uApproximation = static_cast<Vector<exactreal::Arb>>(u);
+  vApproximation = static_cast<Vector<exactreal::Arb>>(v);
+  denominatorApproximation = cross(uApproximation, vApproximation);
+
+  // The order of an automorphism of a Riemann surface of genus g ≥ 2 is at
+  // most 4g + 2. For the torus, the orders are 1, 2, 3, 4, and 6.
+  int genus = 2;
+  for (const auto& vertex : this->surface.vertices())
+    genus += this->surface.angle(vertex) - 1;
+  genus /= 2;
+
+  const slong prec = exactreal::ARB_PRECISION_FAST;
+
+  fmpq_t angle;
+  fmpq_init(angle);
+  for (int n = 1; n <= 4 * std::max(genus, 1) + 2; n++) {
+    for (int k = 0; k < n; k++) {
+      exactreal::Arb trace;
+      fmpq_set_si(angle, 2 * k, n);
+      arb_cos_pi_fmpq(trace.arb_t(), angle, prec);
+      arb_mul_2exp_si(trace.arb_t(), trace.arb_t(), 1);
+      ellipticTraces.push_back(trace);
+    }
+  }
+  fmpq_clear(angle);
+
+  hash = this->surface.canonicalHash(ISOMORPHISM::DELAUNAY_CELLS);
+}
+
+template <typename Surface>
+bool ImplementationOf<VeechGroup<Surface>>::plausible(const Vector<exactreal::Arb>& gu, const Vector<exactreal::Arb>& gv) const {
+  const slong prec = exactreal::ARB_PRECISION_FAST;
+
+  // The determinant is 1 iff g·u × g·v = u × v.
+  if (!arb_overlaps(cross(gu, gv).arb_t(), denominatorApproximation.arb_t()))
+    return false;
+
+  // The trace is (g·u × v + u × g·v) / (u × v).
+  exactreal::Arb trace = cross(gu, vApproximation);
+  arb_add(trace.arb_t(), trace.arb_t(), cross(uApproximation, gv).arb_t(), prec);
+  arb_div(trace.arb_t(), trace.arb_t(), denominatorApproximation.arb_t(), prec);
+
+  exactreal::Arb margin;
+  arb_abs(margin.arb_t(), trace.arb_t());
+  arb_sub_si(margin.arb_t(), margin.arb_t(), 2, prec);
+
+  if (!arb_is_negative(margin.arb_t()))
+    return true;
+
+  // An elliptic element has finite order.
+  return std::any_of(begin(ellipticTraces), end(ellipticTraces), [&](const auto& elliptic) {
+    return arb_overlaps(trace.arb_t(), elliptic.arb_t());
+  });
+}
+
+template <typename Surface>
+typename VeechGroup<Surface>::Element ImplementationOf<VeechGroup<Surface>>::element(const Vector<T>& gu, const Vector<T>& gv) const {
+  // The matrix (g·u, g·v) · (u, v)⁻¹ where (u, v)⁻¹ is the adjugate of (u, v)
+  // divided by its determinant u × v.
+  return Element{
+      gu.x() * v.y() - gv.x() * u.y(),
+      gv.x() * u.x() - gu.x() * v.x(),
+      gu.y() * v.y() - gv.y() * u.y(),
+      gv.y() * u.x() - gu.y() * v.x(),
+      denominator};
+}
+
+template <typename Surface>
+std::optional<typename VeechGroup<Surface>::Element> ImplementationOf<VeechGroup<Surface>>::verify(const Vector<T>& gu, const Vector<T>& gv) const {
+  auto element = this->element(gu, gv);
+
+  // We apply the element scaled by its denominator, so that the result is
+  // isomorphic to the surface scaled by the denominator if the element is
+  // in the Veech group. Since the determinant of the element is 1, the
+  // scaled matrix has positive determinant.
+  auto image = surface.clone();
+  image.apply(element.a, element.b, element.c, element.d);
+
+  if (image.canonicalHash(ISOMORPHISM::DELAUNAY_CELLS) != hash)
+    return std::nullopt;
+
+  const auto isomorphism = surface.isomorphism(image, ISOMORPHISM::DELAUNAY_CELLS, [&](const T& a, const T& b, const T& c, const T& d) {
+    return a == denominator && b == 0 && c == 0 && d == denominator;
+  });
+
+  if (!isomorphism)
+    return std::nullopt;
+
+  return element;
+}
+
+template <typename Surface>
+std::ostream& operator<<(std::ostream& os, const VeechGroup<Surface>& self) {
+  return os << "Veech group of " << self.surface();
+}
+
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include "util/instantiate.ipp"
+
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), VeechGroup, LIBFLATSURF_FLAT_TRIANGULATION_TYPES)
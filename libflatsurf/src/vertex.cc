@@ -82,6 +82,16 @@ void ImplementationOf<Vertex>::afterFlip(Vertex& v, const FlatTriangulationCombi
   if (sources.contains(d)) sources.insert(flipped);
 }
 
+void ImplementationOf<Vertex>::afterSwap(Vertex& v, HalfEdge a, HalfEdge b) {
+  auto& sources = v.self->sources;
+
+  const bool containsA = sources.contains(a);
+  if (containsA == sources.contains(b)) return;
+
+  sources.erase(containsA ? a : b);
+  sources.insert(containsA ? b : a);
+}
+
 ImplementationOf<Vertex>::ImplementationOf(const HalfEdgeSet& sources) :
   sources(sources) {}
 
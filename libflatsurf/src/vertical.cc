@@ -21,18 +21,29 @@
 
 #include <intervalxt/interval_exchange_transformation.hpp>
 #include <intervalxt/label.hpp>
+#include <exact-real/arb.hpp>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <type_traits>
 #include <unordered_set>
+#include <vector>
 
 #include "../flatsurf/ccw.hpp"
 #include "../flatsurf/edge_map.hpp"
 #include "../flatsurf/flat_triangulation.hpp"
 #include "../flatsurf/flat_triangulation_collapsed.hpp"
 #include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/half_edge_map.hpp"
+#include "../flatsurf/half_edge_set.hpp"
 #include "../flatsurf/interval_exchange_transformation.hpp"
 #include "../flatsurf/odd_half_edge_map.hpp"
 #include "../flatsurf/orientation.hpp"
 #include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/vector.hpp"
+#include "impl/flat_triangulation.impl.hpp"
+#include "impl/tracked.impl.hpp"
+#include "impl/vector_batch.hpp"
 #include "impl/vertical.impl.hpp"
 #include "util/assert.ipp"
 
@@ -41,50 +52,128 @@ using namespace flatsurf;
 
 namespace flatsurf {
 
+namespace {
+
+// Return a ball enclosing the scalar product of the vectors enclosed by lhs
+// and rhs.
+exactreal::Arb dot(const Vector<exactreal::Arb>& lhs, const Vector<exactreal::Arb>& rhs) {
+  const slong prec = exactreal::ARB_PRECISION_FAST;
+
+  exactreal::Arb ret, yy;
+  arb_mul(ret.arb_t(), lhs.x().arb_t(), rhs.x().arb_t(), prec);
+  arb_mul(yy.arb_t(), lhs.y().arb_t(), rhs.y().arb_t(), prec);
+  arb_add(ret.arb_t(), ret.arb_t(), yy.arb_t(), prec);
+  return ret;
+}
+
+// Return -1 or 1 if everything in the ball lhs is smaller or larger than
+// everything in the ball rhs. Return nothing if the balls overlap.
+std::optional<int> cmp(const exactreal::Arb& lhs, const exactreal::Arb& rhs) {
+  exactreal::Arb difference;
+  arb_sub(difference.arb_t(), lhs.arb_t(), rhs.arb_t(), exactreal::ARB_PRECISION_FAST);
+  if (arb_is_positive(difference.arb_t()))
+    return 1;
+  if (arb_is_negative(difference.arb_t()))
+    return -1;
+  return std::nullopt;
+}
+
+}  // namespace
+
 template <typename Surface>
 Vertical<Surface>::Vertical(const Surface& surface, const Vector<T>& vertical) :
-  self(std::make_shared<ImplementationOf<Vertical>>(surface, vertical)) {}
+  self([&]() {
+    const auto make = [&]() { return std::make_shared<ImplementationOf<Vertical>>(surface, vertical); };
+    // Verticals on the same surface in the same direction share their
+    // caches, since verticals are often recreated for the same direction.
+    if constexpr (std::is_same_v<Surface, FlatTriangulation<T>>)
+      return ImplementationOf<FlatTriangulation<T>>::vertical(surface, vertical, make);
+    else
+      return make();
+  }()) {}
 
 template <typename Surface>
-std::vector<std::unordered_set<HalfEdge>> Vertical<Surface>::components() const {
-  std::vector<std::unordered_set<HalfEdge>> components;
-  std::unordered_set<HalfEdge> done;
-  for (const auto& start : self->surface->halfEdges()) {
-    if (done.find(start) != done.end())
+std::vector<HalfEdgeSet> Vertical<Surface>::components() const {
+  const auto labels = componentLabels();
+
+  std::vector<HalfEdgeSet> components;
+  for (const auto he : self->surface->halfEdges()) {
+    if (labels[he] == components.size())
+      components.emplace_back();
+    components[labels[he]].insert(he);
+  }
+  return components;
+}
+
+template <typename Surface>
+HalfEdgeMap<uint32_t> Vertical<Surface>::componentLabels() const {
+  // Two half edges are in the same component if one can be reached from the
+  // other by crossing faces or non-vertical half edges, see visit(). We
+  // flood fill the half edges following these steps in both directions.
+  // The components are labeled in the order of their smallest half edge.
+  constexpr uint32_t UNLABELED = std::numeric_limits<uint32_t>::max();
+
+  const auto& surface = *self->surface;
+
+  HalfEdgeMap<uint32_t> labels(std::vector<uint32_t>(surface.halfEdges().size(), UNLABELED));
+
+  uint32_t label = 0;
+  std::vector<HalfEdge> pending;
+  for (const auto start : surface.halfEdges()) {
+    if (labels[start] != UNLABELED)
       continue;
-    std::unordered_set<HalfEdge> component;
-    if (!ImplementationOf<Vertical>::visit(*this, start, component, [&](HalfEdge) { return true; })) {
-      assert(false && "visit cannot fail without a predicate");
+
+    labels[start] = label;
+    pending.push_back(start);
+
+    while (!pending.empty()) {
+      const HalfEdge he = pending.back();
+      pending.pop_back();
+
+      const bool collinear = ccw(he) == CCW::COLLINEAR;
+
+      const auto reach = [&](HalfEdge next) {
+        if (labels[next] != UNLABELED)
+          return;
+        if (collinear && ccw(next) == CCW::COLLINEAR)
+          return;
+        labels[next] = label;
+        pending.push_back(next);
+      };
+
+      reach(-he);
+      reach(surface.nextInFace(he));
+      reach(surface.previousInFace(he));
     }
-    assert(component.size() && "visit cannot return an empty component");
-    components.push_back(component);
-    done.insert(component.begin(), component.end());
+
+    label++;
   }
-  return components;
+
+  return labels;
 }
 
 template <typename Surface>
 bool Vertical<Surface>::large(HalfEdge e) const {
-  if (!(*self->largenessCache)[e]) {
-    auto length = [&](const HalfEdge edge) {
-      auto ret = projectPerpendicular(edge);
-      return ret > 0 ? ret : -ret;
+  std::lock_guard<std::recursive_mutex> guard(self->cacheLock);
+  if (!self->largenessCache->contains(e)) {
+    const auto longerThan = [&](const HalfEdge other) {
+      return ImplementationOf<Vertical>::compareLengths(*this, e, other) >= 0;
     };
-    auto len = length(e);
-    (*self->largenessCache)[e] =
-        len >= length(self->surface->nextInFace(e)) &&
-        len >= length(self->surface->previousInFace(e)) &&
-        len >= length(self->surface->nextInFace(-e)) &&
-        len >= length(self->surface->previousInFace(-e));
+    self->largenessCache->set(e,
+        longerThan(self->surface->nextInFace(e)) &&
+        longerThan(self->surface->previousInFace(e)) &&
+        longerThan(self->surface->nextInFace(-e)) &&
+        longerThan(self->surface->previousInFace(-e)));
   }
-  return *(*self->largenessCache)[e];
+  return self->largenessCache->get(e);
 }
 
 template <typename Surface>
 typename Surface::Coordinate Vertical<Surface>::projectPerpendicular(HalfEdge he) const {
-  if (!self->perpendicularProjectionCache->get(he))
+  std::lock_guard<std::recursive_mutex> guard(self->cacheLock);
+  if (!self->perpendicularProjectionCache->contains(he))
     self->perpendicularProjectionCache->set(he, projectPerpendicular(self->surface->fromHalfEdge(he)));
-  return *self->perpendicularProjectionCache->get(he);
+  return self->perpendicularProjectionCache->get(he);
 }
 
 template <typename Surface>
@@ -94,9 +183,10 @@ typename Surface::Coordinate Vertical<Surface>::projectPerpendicular(const Vecto
 
 template <typename Surface>
 typename Surface::Coordinate Vertical<Surface>::project(HalfEdge he) const {
-  if (!self->parallelProjectionCache->get(he))
+  std::lock_guard<std::recursive_mutex> guard(self->cacheLock);
+  if (!self->parallelProjectionCache->contains(he))
     self->parallelProjectionCache->set(he, project(self->surface->fromHalfEdge(he)));
-  return *self->parallelProjectionCache->get(he);
+  return self->parallelProjectionCache->get(he);
 }
 
 template <typename Surface>
@@ -104,11 +194,55 @@ typename Surface::Coordinate Vertical<Surface>::project(const Vector<T>& v) cons
   return self->vertical * v;
 }
 
+template <typename Surface>
+exactreal::Arb Vertical<Surface>::projectApproximate(HalfEdge he) const {
+  return dot(self->verticalApproximation, self->approximation(he));
+}
+
+template <typename Surface>
+exactreal::Arb Vertical<Surface>::projectPerpendicularApproximate(HalfEdge he) const {
+  return dot(self->horizontalApproximation, self->approximation(he));
+}
+
+template <typename Surface>
+int Vertical<Surface>::compareProjections(HalfEdge a, HalfEdge b) const {
+  if (a == b)
+    return 0;
+
+  if constexpr (Enclosure<T>::filtered) {
+    if (const auto decided = cmp(projectApproximate(a), projectApproximate(b)))
+      return *decided;
+  }
+
+  const T lhs = project(a);
+  const T rhs = project(b);
+  return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+template <typename Surface>
+int Vertical<Surface>::compareProjectionsPerpendicular(HalfEdge a, HalfEdge b) const {
+  if (a == b)
+    return 0;
+
+  if constexpr (Enclosure<T>::filtered) {
+    if (const auto decided = cmp(projectPerpendicularApproximate(a), projectPerpendicularApproximate(b)))
+      return *decided;
+  }
+
+  const T lhs = projectPerpendicular(a);
+  const T rhs = projectPerpendicular(b);
+  return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
 template <typename Surface>
 ORIENTATION Vertical<Surface>::orientation(HalfEdge he) const {
-  if (!self->orientationCache->get(he))
-    self->orientationCache->set(he, orientation(self->surface->fromHalfEdge(he)));
-  return *self->orientationCache->get(he);
+  std::lock_guard<std::recursive_mutex> guard(self->cacheLock);
+  if (!self->orientationCache->contains(he)) {
+    self->batch();
+    if (!self->orientationCache->contains(he))
+      self->orientationCache->set(he, orientation(self->surface->fromHalfEdge(he)));
+  }
+  return self->orientationCache->get(he);
 }
 
 template <typename Surface>
@@ -118,9 +252,13 @@ ORIENTATION Vertical<Surface>::orientation(const Vector<T>& v) const {
 
 template <typename Surface>
 CCW Vertical<Surface>::ccw(HalfEdge he) const {
-  if (!self->ccwCache->get(he))
-    self->ccwCache->set(he, ccw(self->surface->fromHalfEdge(he)));
-  return *self->ccwCache->get(he);
+  std::lock_guard<std::recursive_mutex> guard(self->cacheLock);
+  if (!self->ccwCache->contains(he)) {
+    self->batch();
+    if (!self->ccwCache->contains(he))
+      self->ccwCache->set(he, ccw(self->surface->fromHalfEdge(he)));
+  }
+  return self->ccwCache->get(he);
 }
 
 template <typename Surface>
@@ -132,16 +270,31 @@ template <typename Surface>
 typename Vertical<Surface>::TRIANGLE Vertical<Surface>::classifyFace(HalfEdge face) const {
   // Some of these cases are not possible if Surface is collapsed.
 
-  auto perp = projectPerpendicular(face);
-  auto a = projectPerpendicular(self->surface->nextInFace(face));
-  auto b = projectPerpendicular(self->surface->previousInFace(face));
+  // The classification only depends on the signs of the perpendicular
+  // projections. A half edge has positive perpendicular projection iff it
+  // is clockwise from the vertical, so we can read these signs from the
+  // ccwCache which is populated in bulk by batch().
+  const auto sgn = [&](HalfEdge he) {
+    switch (ccw(he)) {
+      case CCW::CLOCKWISE:
+        return 1;
+      case CCW::COUNTERCLOCKWISE:
+        return -1;
+      default:
+        return 0;
+    }
+  };
+
+  const int perp = sgn(face);
+  const int a = sgn(self->surface->nextInFace(face));
+  const int b = sgn(self->surface->previousInFace(face));
 
   if (self->surface->nextInFace(face) == self->surface->previousInFace(face)) {
-    ASSERT(perp + a == 0, "face is not closed");
+    ASSERT(projectPerpendicular(face) + projectPerpendicular(self->surface->nextInFace(face)) == 0, "face is not closed");
     return TRIANGLE::COLLAPSED_TO_TWO_FACES;
   }
 
-  ASSERT(perp + a + b == 0, "face is not closed");
+  ASSERT(projectPerpendicular(face) + projectPerpendicular(self->surface->nextInFace(face)) + projectPerpendicular(self->surface->previousInFace(face)) == 0, "face is not closed");
 
   if (perp == 0) {
     ASSERT(a != 0 && b != 0, "face cannot have two vertical edges");
@@ -163,6 +316,31 @@ typename Vertical<Surface>::TRIANGLE Vertical<Surface>::classifyFace(HalfEdge fa
   }
 }
 
+template <typename Surface>
+void Vertical<Surface>::classifyAll() const {
+  // Determine the orientation of all half edges in one pass (if this has
+  // not been done before.) This is all that classifyFace() needs.
+  self->batch();
+
+  const auto& surface = *self->surface;
+
+  // Determine the orientations of all edges that have not been cached yet,
+  // e.g., because they have been flipped. Each edge is a side of two faces,
+  // so computing these once per edge here saves the repeated lookups of the
+  // face by face queries below.
+  for (const auto edge : surface.edges())
+    ccw(edge.positive());
+
+  // Determine the largeness of all edges that are not at the boundary. The
+  // largenessCache only forgets about the edges of the quadrilaterals that
+  // have been flipped, so only these are recomputed here.
+  for (const auto edge : surface.edges()) {
+    if (surface.boundary(edge.positive()) || surface.boundary(edge.negative()))
+      continue;
+    large(edge.positive());
+  }
+}
+
 template <typename Surface>
 Vertical<Surface> Vertical<Surface>::operator-() const {
   return Vertical(self->surface, -vertical());
@@ -198,33 +376,105 @@ ImplementationOf<Vertical<Surface>>::ImplementationOf(const Surface& surface, co
   surface(surface),
   vertical(vertical),
   horizontal(-vertical.perpendicular()),
+  verticalApproximation(static_cast<Vector<exactreal::Arb>>(vertical)),
+  horizontalApproximation(static_cast<Vector<exactreal::Arb>>(horizontal)),
   parallelProjectionCache(
-      surface, OddHalfEdgeMap<std::optional<T>>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache.set(flip, std::nullopt); }, [](auto& cache, const auto&, Edge collapse) { cache.set(collapse.positive(), T()); }),
+      surface, OddHalfEdgeCache<T>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache.erase(flip); }, [](auto& cache, const auto&, Edge collapse) { cache.set(collapse.positive(), T()); }),
   perpendicularProjectionCache(
-      surface, OddHalfEdgeMap<std::optional<T>>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache.set(flip, std::nullopt); }, [](auto& cache, const auto&, Edge collapse) { ASSERT(!cache.get(collapse.positive()) || !*cache.get(collapse.positive()), "cannot collapse non-vertical edges"); }),
+      surface, OddHalfEdgeCache<T>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache.erase(flip); }, [](auto& cache, const auto&, Edge collapse) { ASSERT(!cache.contains(collapse.positive()) || !cache.get(collapse.positive()), "cannot collapse non-vertical edges"); }),
   ccwCache(
-      surface, OddHalfEdgeMap<std::optional<CCW>>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache.set(flip, std::nullopt); }, [](auto& cache, const auto&, Edge collapse) { ASSERT(!cache.get(collapse.positive()) || *cache.get(collapse.positive()) == CCW::COLLINEAR, "cannot collapse non-collinear edges"); }),
+      surface, OddHalfEdgeCache<CCW>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache.erase(flip); }, [](auto& cache, const auto&, Edge collapse) { ASSERT(!cache.contains(collapse.positive()) || cache.get(collapse.positive()) == CCW::COLLINEAR, "cannot collapse non-collinear edges"); }),
   orientationCache(
-      surface, OddHalfEdgeMap<std::optional<ORIENTATION>>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache.set(flip, std::nullopt); },
+      surface, OddHalfEdgeCache<ORIENTATION>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache.erase(flip); },
       // intentionally empty: when collapsing an Edge we won't reason about its orientation anymore
       [](auto&, const auto&, Edge) {}),
-  lengthCache(
-      surface, EdgeMap<std::optional<T>>(surface), [](auto& cache, const auto&, HalfEdge flip) { cache[flip] = std::nullopt; }, [](auto& cache, const auto&, Edge collapse) { ASSERT(!cache[collapse] || !*cache[collapse], "cannot collapse non-vertical edges"); }),
   largenessCache(
-      surface, EdgeMap<std::optional<bool>>(surface), [](auto& cache, const auto& surface, HalfEdge flip) {
-    cache[flip]= std::nullopt;
-    cache[surface.nextInFace(flip)] = std::nullopt;
-    cache[surface.previousInFace(flip)] = std::nullopt;
-    cache[surface.nextInFace(-flip)] = std::nullopt;
-    cache[surface.previousInFace(-flip)] = std::nullopt; },
+      surface, EdgeCache<bool>(surface), [](auto& cache, const auto& surface, HalfEdge flip) {
+    cache.erase(flip);
+    cache.erase(surface.nextInFace(flip));
+    cache.erase(surface.previousInFace(flip));
+    cache.erase(surface.nextInFace(-flip));
+    cache.erase(surface.previousInFace(-flip)); },
       // intentionally empty: when collapsing an Edge we won't reason about it's largeness anymore
       [](auto&, const auto&, Edge) {}) {
   CHECK_ARGUMENT(vertical, "vertical must be non-zero");
+
+  // These caches only forget about flipped edges, so they can be notified
+  // in bulk at the end of a sequence of flips.
+  ImplementationOf<Tracked<OddHalfEdgeCache<T>>>::defer(parallelProjectionCache);
+  ImplementationOf<Tracked<OddHalfEdgeCache<T>>>::defer(perpendicularProjectionCache);
+  ImplementationOf<Tracked<OddHalfEdgeCache<CCW>>>::defer(ccwCache);
+  ImplementationOf<Tracked<OddHalfEdgeCache<ORIENTATION>>>::defer(orientationCache);
+}
+
+template <typename Surface>
+void ImplementationOf<Vertical<Surface>>::batch() const {
+  std::lock_guard<std::recursive_mutex> guard(cacheLock);
+
+  if (batched)
+    return;
+  batched = true;
+
+  // Only machine integers profit from evaluating the predicates in a batch.
+  // For other coordinates, we keep computing them lazily since they are
+  // expensive and not every half edge might be needed.
+  if constexpr (std::is_same_v<Surface, FlatTriangulation<long long>>) {
+    // The surface keeps its coordinates in columns already, so we evaluate
+    // the predicates on all half edges directly.
+    const auto& columns = ImplementationOf<FlatTriangulation<long long>>::coordinates(*surface);
+
+    std::vector<CCW> ccws;
+    VectorBatch<T>::ccw(vertical, columns, ccws);
+    std::vector<ORIENTATION> orientations;
+    VectorBatch<T>::orientation(vertical, columns, orientations);
+
+    // The caches are odd, so it suffices to set the positive half edges.
+    for (size_t i = 0; i < columns.size(); i += 2) {
+      ccwCache->set(HalfEdge::fromIndex(i), ccws[i]);
+      orientationCache->set(HalfEdge::fromIndex(i), orientations[i]);
+    }
+  } else if constexpr (std::is_same_v<T, long long>) {
+    std::vector<HalfEdge> halfEdges;
+    std::vector<const Vector<T>*> vectors;
+    for (const auto edge : surface->edges()) {
+      halfEdges.push_back(edge.positive());
+      vectors.push_back(&static_cast<const Vector<T>&>(surface->fromHalfEdge(edge.positive())));
+    }
+
+    std::vector<CCW> ccws;
+    VectorBatch<T>::ccw(vertical, vectors, ccws);
+    std::vector<ORIENTATION> orientations;
+    VectorBatch<T>::orientation(vertical, vectors, orientations);
+
+    for (size_t i = 0; i < halfEdges.size(); i++) {
+      ccwCache->set(halfEdges[i], ccws[i]);
+      orientationCache->set(halfEdges[i], orientations[i]);
+    }
+  }
+}
+
+template <typename Surface>
+int ImplementationOf<Vertical<Surface>>::compareLengths(const Vertical& self, Edge a, Edge b) {
+  // A half edge has non-negative perpendicular projection iff it is not
+  // counterclockwise from the vertical, so the lengths are the perpendicular
+  // projections of these half edges.
+  const auto nonnegative = [&](const Edge edge) {
+    return self.ccw(edge.positive()) == CCW::COUNTERCLOCKWISE ? edge.negative() : edge.positive();
+  };
+  return self.compareProjectionsPerpendicular(nonnegative(a), nonnegative(b));
+}
+
+template <typename Surface>
+Vector<exactreal::Arb> ImplementationOf<Vertical<Surface>>::approximation(HalfEdge he) const {
+  if constexpr (std::is_same_v<Surface, FlatTriangulation<T>>)
+    return surface->fromHalfEdgeApproximate(he);
+  else
+    return static_cast<Vector<exactreal::Arb>>(static_cast<const Vector<T>&>(surface->fromHalfEdge(he)));
 }
 
 template <typename Surface>
-bool ImplementationOf<Vertical<Surface>>::visit(const Vertical& self, HalfEdge start, std::unordered_set<HalfEdge>& component, std::function<bool(HalfEdge)> visitor) {
-  if (component.find(start) != component.end())
+bool ImplementationOf<Vertical<Surface>>::visit(const Vertical& self, HalfEdge start, HalfEdgeSet& component, std::function<bool(HalfEdge)> visitor) {
+  if (component.contains(start))
     return true;
 
   component.insert(start);
@@ -247,4 +497,4 @@ bool ImplementationOf<Vertical<Surface>>::visit(const Vertical& self, HalfEdge s
 // Instantiations of templates so implementations are generated for the linker
 #include "util/instantiate.ipp"
 
-LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Vertical, LIBFLATSURF_SURFACE_TYPES)
+LIBFLATSURF_INSTANTIATE_MANY_WRAPPED((LIBFLATSURF_INSTANTIATE_WITH_IMPLEMENTATION), Vertical, LIBFLATSURF_GEOMETRY_FLAT_TRIANGULATION_TYPES LIBFLATSURF_FLAT_TRIANGULATION_COLLAPSED_TYPES)
@@ -17,7 +17,12 @@
  *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
  *********************************************************************/
 
+#include "../flatsurf/ccw.hpp"
+#include "../flatsurf/vector.hpp"
 #include "../src/impl/approximation.hpp"
+#include "../src/impl/double_approximation.hpp"
+#include "../src/impl/enclosure.hpp"
+#include "../src/impl/precision_policy.hpp"
 #include "external/catch2/single_include/catch2/catch.hpp"
 #include "generators/real_generator.hpp"
 
@@ -66,6 +71,103 @@ TEMPLATE_TEST_CASE("Approximation", "[arb]", LIBFLATSURF_TEST_REAL_TYPES) {
       }
     }
   }
+
+  SECTION("Batches Contain the Approximated Values") {
+    const auto values = std::vector<T>{T(-3), T(0), T(3)};
+    const auto batch = Approximation<T>::arb(std::vector<const T*>{&values[0], &values[1], &values[2]}, 64);
+
+    REQUIRE(batch.size() == values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+      CAPTURE(batch[i]);
+      const auto bounds = static_cast<std::pair<Arf, Arf>>(batch[i]);
+      REQUIRE(bounds.first <= static_cast<int>(i) * 3 - 3);
+      REQUIRE(bounds.second >= static_cast<int>(i) * 3 - 3);
+    }
+  }
+
+  SECTION("Enclosures Decide Signs and Comparisons") {
+    auto n = GENERATE(-3, 0, 3);
+
+    const auto value = Enclosure<T>(T(n));
+    REQUIRE(value.sgn() == (n > 0) - (n < 0));
+    REQUIRE(value.abs().sgn() == (n != 0));
+    REQUIRE(value.cmp(Enclosure<T>(T(1))) == (n > 1) - (n < 1));
+    REQUIRE(value.cmp(value) == 0);
+
+    auto sum = Enclosure<T>(T());
+    sum += value;
+    sum += value;
+    sum -= value;
+    REQUIRE(sum.cmp(value) == 0);
+    REQUIRE(static_cast<const T&>(sum) == T(n));
+  }
+}
+
+TEST_CASE("Floating Point Filter", "[arb]") {
+  using Arb = exactreal::Arb;
+  using R2 = Vector<Arb>;
+
+  const auto approximate = [](int x, int y) {
+    return DoubleApproximation(R2(Arb(x), Arb(y)));
+  };
+
+  SECTION("Clearly Oriented Vectors are Classified") {
+    REQUIRE(approximate(1, 0).ccw(approximate(0, 1)) == CCW::COUNTERCLOCKWISE);
+    REQUIRE(approximate(0, 1).ccw(approximate(1, 0)) == CCW::CLOCKWISE);
+  }
+
+  SECTION("Collinear Vectors are Never Classified") {
+    REQUIRE(!approximate(1, 1).ccw(approximate(2, 2)));
+    REQUIRE(!approximate(1, 1).ccw(approximate(-3, -3)));
+  }
+
+  SECTION("Errors Accumulate in Sums") {
+    auto sum = approximate(0, 0);
+    for (int i = 0; i < 1024; i++)
+      sum += approximate(1, 3);
+    REQUIRE(sum.ccw(approximate(1, 3)) == std::nullopt);
+    REQUIRE(sum.ccw(approximate(1, 4)) == CCW::COUNTERCLOCKWISE);
+  }
+
+  SECTION("Balls are Taken into Account") {
+    const Arb x = (Arb(1) / Arb(3))(64);
+    const auto third = DoubleApproximation(R2(x, x));
+    REQUIRE(!third.ccw(approximate(1, 1)));
+    REQUIRE(third.ccw(approximate(1, 2)) == CCW::COUNTERCLOCKWISE);
+  }
+}
+
+TEST_CASE("Adaptive Precision of Approximations", "[arb]") {
+  if (!PrecisionPolicy::adaptive()) return;
+
+  PrecisionPolicy policy;
+  REQUIRE(policy.precision() == exactreal::ARB_PRECISION_FAST);
+
+  const auto window = [&](size_t undecided) {
+    for (size_t i = 0; i < PrecisionPolicy::WINDOW; i++)
+      policy.record(i >= undecided);
+  };
+
+  SECTION("Precision Stays Low When Approximations Decide") {
+    window(0);
+    window(1);
+    REQUIRE(policy.precision() == exactreal::ARB_PRECISION_FAST);
+  }
+
+  SECTION("Precision Widens When Approximations Fail") {
+    window(PrecisionPolicy::WINDOW / 2);
+    REQUIRE(policy.precision() == 2 * exactreal::ARB_PRECISION_FAST);
+
+    for (int i = 0; i < 32; i++)
+      window(PrecisionPolicy::WINDOW / 2);
+    REQUIRE(policy.precision() == PrecisionPolicy::MAX_PRECISION);
+
+    SECTION("And Narrows Again When Approximations Decide") {
+      for (int i = 0; i < 1024 && policy.precision() > exactreal::ARB_PRECISION_FAST; i++)
+        window(0);
+      REQUIRE(policy.precision() == exactreal::ARB_PRECISION_FAST);
+    }
+  }
 }
 
 }  // namespace flatsurf::test
@@ -37,6 +37,17 @@ TEST_CASE("Bound Arithmetic", "[bound]") {
     REQUIRE(Bound(3, 4) == Bound(5));
   }
 
+  SECTION("Bounds Beyond Machine Integers Compare Correctly") {
+    const mpz_class large("4611686018427387904");  // 2^62
+
+    REQUIRE(Bound(large) > Bound(1 << 30));
+    REQUIRE(Bound(1 << 30) < Bound(large));
+    REQUIRE(Bound(large, 0) == Bound(0, large));
+    REQUIRE(!Bound(large).machineSquared());
+    REQUIRE(*Bound(3, 4).machineSquared() == 25);
+    REQUIRE(Bound(1 << 30) * mpz_class(1 << 30) == Bound(large / 4));
+  }
+
   SECTION("Non-zero Checks") {
     REQUIRE(static_cast<bool>(Bound()) == false);
     REQUIRE(static_cast<bool>(Bound(1)) == true);
@@ -18,12 +18,24 @@
  *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
  *********************************************************************/
 
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 
 #include "../flatsurf/cereal.hpp"
+#include "../flatsurf/flow_component.hpp"
+#include "../flatsurf/flow_decomposition.hpp"
+#include "../flatsurf/flow_decomposition_summary.hpp"
+#include "../flatsurf/pickle.hpp"
+#include "../flatsurf/saddle_connections_buckets.hpp"
+#include "../flatsurf/saddle_connections_iterator_checkpoint.hpp"
+#include "../flatsurf/saddle_connections_work_unit.hpp"
+#include "../flatsurf/saddle_connections_stream.hpp"
+#include "../flatsurf/surface_catalog.hpp"
+#include "../flatsurf/tracing.hpp"
 #include "../flatsurf/vertical.hpp"
 #include "cereal.helpers.hpp"
 #include "external/catch2/single_include/catch2/catch.hpp"
+#include "external/cereal/include/cereal/archives/binary.hpp"
 #include "external/cereal/include/cereal/archives/json.hpp"
 #include "generators/saddle_connections_generator.hpp"
 #include "surfaces.hpp"
@@ -87,6 +99,27 @@ TEST_CASE("Serialization of a FlatTriangulationCombinatorial", "[cereal]") {
   testRoundtrip(*square);
 }
 
+TEST_CASE("Binary Serialization of a FlatTriangulationCombinatorial", "[cereal]") {
+  const auto surface = makeL<Vector<long long>>()->combinatorial().clone();
+
+  std::stringstream s;
+  {
+    cereal::BinaryOutputArchive archive(s);
+    archive(surface);
+  }
+
+  // Each half edge id takes a single byte plus some bytes of overhead.
+  REQUIRE(s.str().size() < surface.halfEdges().size() + 32);
+
+  FlatTriangulationCombinatorial deserialized;
+  {
+    cereal::BinaryInputArchive archive(s);
+    archive(deserialized);
+  }
+
+  REQUIRE(deserialized == surface);
+}
+
 TEMPLATE_TEST_CASE("Serialization of a FlatTriangulation", "[cereal]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
   using R2 = Vector<TestType>;
   auto square = makeSquare<R2>();
@@ -94,6 +127,149 @@ TEMPLATE_TEST_CASE("Serialization of a FlatTriangulation", "[cereal]", (long lon
   testRoundtrip(*square);
 }
 
+TEMPLATE_TEST_CASE("Binary Serialization of a FlatTriangulation", "[cereal]", (long long), (mpz_class), (mpq_class)) {
+  using R2 = Vector<TestType>;
+  // Coordinates that do not fit into a single limb.
+  const mpz_class scale = std::is_same_v<TestType, long long> ? mpz_class(1) : mpz_class(1) << 190;
+  const auto square = makeSquare<R2>()->scale(scale);
+
+  std::stringstream s;
+  {
+    cereal::BinaryOutputArchive archive(s);
+    archive(square);
+    archive(SaddleConnection<FlatTriangulation<TestType>>(square, HalfEdge(1)));
+  }
+
+  FlatTriangulation<TestType> surface;
+  auto connection = factory<SaddleConnection<FlatTriangulation<TestType>>>::make();
+  {
+    cereal::BinaryInputArchive archive(s);
+    archive(surface);
+    archive(*connection);
+  }
+
+  REQUIRE(surface == square);
+  REQUIRE(*connection == SaddleConnection<FlatTriangulation<TestType>>(square, HalfEdge(1)));
+}
+
+TEMPLATE_TEST_CASE("Binary Serialization without the Surface", "[cereal]", (long long), (mpq_class), (renf_elem_class)) {
+  using R2 = Vector<TestType>;
+  using Surface = FlatTriangulation<TestType>;
+  const auto square = makeSquare<R2>();
+
+  for (const auto& connection : square->connections().bound(4)) {
+    const auto bytes = pickle::save(connection, *square);
+    REQUIRE(bytes.size() < pickle::save(connection).size());
+
+    const auto loaded = pickle::load<SaddleConnection<Surface>>(reinterpret_cast<const char*>(bytes.data()), bytes.size(), *square);
+    REQUIRE(loaded == connection);
+    REQUIRE(loaded.target() == connection.target());
+    REQUIRE(pickle::identity(loaded.surface()) == pickle::identity(*square));
+
+    const auto chain = pickle::save(connection.chain(), *square);
+    REQUIRE(pickle::load<Chain<Surface>>(reinterpret_cast<const char*>(chain.data()), chain.size(), *square) == connection.chain());
+
+    const auto vertical = pickle::save(Vertical(*square, connection.vector()), *square);
+    REQUIRE(pickle::load<Vertical<Surface>>(reinterpret_cast<const char*>(vertical.data()), vertical.size(), *square).vertical() == connection.vector());
+  }
+
+  const auto bytes = pickle::save(*square);
+  REQUIRE(pickle::load<Surface>(reinterpret_cast<const char*>(bytes.data()), bytes.size()) == *square);
+}
+
+TEST_CASE("Serialization of a FlatTriangulation is Traced", "[cereal][tracing]") {
+  const auto square = makeSquare<Vector<long long>>();
+
+  Tracing::enable();
+  Tracing::reset();
+
+  std::stringstream s;
+  {
+    cereal::BinaryOutputArchive archive(s);
+    archive(*square);
+  }
+
+  Tracing::enable(false);
+
+  std::stringstream trace;
+  Tracing::write(trace);
+  CAPTURE(trace.str());
+
+  REQUIRE(trace.str().find(R"("traceEvents")") != std::string::npos);
+  REQUIRE(trace.str().find(R"("name":"FlatTriangulation::save","cat":"flatsurf","ph":"X")") != std::string::npos);
+
+  Tracing::reset();
+  {
+    cereal::BinaryOutputArchive archive(s);
+    archive(*square);
+  }
+
+  trace.str("");
+  Tracing::write(trace);
+  REQUIRE(trace.str().find("FlatTriangulation::save") == std::string::npos);
+}
+
+TEMPLATE_TEST_CASE("Streaming of SaddleConnections", "[cereal]", (long long), (mpq_class), (renf_elem_class)) {
+  using R2 = Vector<TestType>;
+  using Surface = FlatTriangulation<TestType>;
+  const auto square = makeSquare<R2>();
+
+  const auto chunk = GENERATE(1, 3, 1024);
+
+  std::stringstream s;
+  {
+    SaddleConnectionsWriter<Surface> writer(s, *square, chunk);
+    writer.write(square->connections().bound(8));
+    writer.finish();
+  }
+
+  SaddleConnectionsReader<Surface> reader(s);
+  REQUIRE(reader.surface() == *square);
+
+  for (const auto& connection : square->connections().bound(8)) {
+    const auto read = reader.next();
+    REQUIRE(read);
+    REQUIRE(read->vector() == connection.vector());
+    REQUIRE(read->source() == connection.source());
+    REQUIRE(read->target() == connection.target());
+  }
+
+  REQUIRE(!reader.next());
+  REQUIRE(!reader.next());
+}
+
+TEMPLATE_TEST_CASE("Catalogs of Surfaces", "[cereal]", (long long), (mpq_class), (renf_elem_class)) {
+  using R2 = Vector<TestType>;
+  const auto square = makeSquare<R2>();
+  const auto L = makeL<R2>();
+
+  auto stream = std::make_shared<std::stringstream>();
+  {
+    SurfaceCatalogWriter<TestType> writer(*stream);
+    writer.push(*square);
+    writer.push(*L);
+    writer.push(square->scale(2));
+    writer.finish();
+  }
+
+  const SurfaceCatalog<TestType> catalog(stream);
+  REQUIRE(catalog.size() == 3);
+
+  // Surfaces can be read in any order.
+  REQUIRE(catalog[2] == square->scale(2));
+  REQUIRE(catalog[0] == *square);
+  REQUIRE(catalog[1] == *L);
+
+  REQUIRE_THROWS(catalog[3]);
+
+  const auto threads = GENERATE(1u, 2u, 8u);
+  const auto surfaces = catalog.surfaces(threads);
+  REQUIRE(surfaces.size() == 3);
+  REQUIRE(surfaces[0] == *square);
+  REQUIRE(surfaces[1] == *L);
+  REQUIRE(surfaces[2] == square->scale(2));
+}
+
 TEMPLATE_TEST_CASE("Serialization of a Vertical", "[cereal]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
   using R2 = Vector<TestType>;
   auto square = makeSquare<R2>();
@@ -116,6 +292,210 @@ TEMPLATE_TEST_CASE("Serialization of a SaddleConnection", "[cereal]", (long long
   testRoundtrip(saddleConnection);
 }
 
+TEMPLATE_TEST_CASE("Serialization of Many SaddleConnections Writes Their Surface Once", "[cereal]", (long long), (mpq_class), (renf_elem_class)) {
+  using cereal::JSONInputArchive;
+  using cereal::JSONOutputArchive;
+
+  using R2 = Vector<TestType>;
+  auto square = makeSquare<R2>();
+
+  std::vector<SaddleConnection<FlatTriangulation<TestType>>> connections;
+  for (const auto& connection : square->connections().bound(4))
+    connections.push_back(connection);
+  REQUIRE(connections.size() > 1);
+
+  std::stringstream s;
+  {
+    JSONOutputArchive archive(s);
+    for (size_t i = 0; i < connections.size(); i++)
+      archive(cereal::make_nvp(std::to_string(i), connections[i]));
+  }
+
+  const auto serialized = s.str();
+  INFO("Serialized to " << serialized);
+
+  size_t surfaces = 0;
+  for (auto position = serialized.find("\"vectors\""); position != std::string::npos; position = serialized.find("\"vectors\"", position + 1))
+    surfaces++;
+  REQUIRE(surfaces == 1);
+
+  {
+    JSONInputArchive archive(s);
+    for (size_t i = 0; i < connections.size(); i++) {
+      auto connection = factory<SaddleConnection<FlatTriangulation<TestType>>>::make();
+      archive(cereal::make_nvp(std::to_string(i), *connection));
+      REQUIRE(*connection == connections[i]);
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Checkpointing of SaddleConnections", "[cereal]", (long long), (mpq_class), (renf_elem_class)) {
+  using cereal::JSONInputArchive;
+  using cereal::JSONOutputArchive;
+
+  using R2 = Vector<TestType>;
+  using Surface = FlatTriangulation<TestType>;
+  const auto L = makeL<R2>();
+
+  const auto connections = L->connections().bound(8);
+
+  std::vector<SaddleConnection<Surface>> expected;
+  for (const auto& connection : connections)
+    expected.push_back(connection);
+
+  const size_t skip = GENERATE(0, 1, 7, 32);
+  const size_t start = std::min(skip, expected.size());
+  CAPTURE(start);
+
+  auto it = connections.begin();
+  for (size_t i = 0; i < start; i++)
+    ++it;
+
+  std::stringstream s;
+  {
+    JSONOutputArchive archive(s);
+    archive(cereal::make_nvp("checkpoint", it.checkpoint()));
+  }
+
+  INFO("Serialized to " << s.str());
+
+  SaddleConnectionsIteratorCheckpoint<Surface> checkpoint;
+  {
+    JSONInputArchive archive(s);
+    archive(cereal::make_nvp("checkpoint", checkpoint));
+  }
+
+  // Resume on a copy of the surface to make sure the checkpoint does not
+  // depend on the original search.
+  const auto copy = L->clone();
+  const auto resumed = copy.connections().bound(8);
+  size_t i = start;
+  for (auto jt = resumed.resume(checkpoint); jt != resumed.end(); ++jt, ++i) {
+    REQUIRE(i < expected.size());
+    REQUIRE(jt->vector() == expected[i].vector());
+    REQUIRE(jt->source() == expected[i].source());
+    REQUIRE(jt->target() == expected[i].target());
+  }
+  REQUIRE(i == expected.size());
+}
+
+TEMPLATE_TEST_CASE("Distribute SaddleConnections in Work Units", "[cereal]", (long long), (mpq_class), (renf_elem_class)) {
+  using cereal::JSONInputArchive;
+  using cereal::JSONOutputArchive;
+
+  using R2 = Vector<TestType>;
+  using Surface = FlatTriangulation<TestType>;
+  const auto L = makeL<R2>();
+
+  const auto connections = L->connections().bound(8);
+
+  std::vector<SaddleConnection<Surface>> expected;
+  for (const auto& connection : connections)
+    expected.push_back(connection);
+
+  const size_t units = GENERATE(1, 2, 5, 64);
+  CAPTURE(units);
+
+  const auto split = connections.split(units);
+  REQUIRE(split.size() >= 1);
+  REQUIRE(split.size() <= units);
+
+  // Search each unit on a copy of the surface to make sure the units do not
+  // depend on the original search.
+  const auto copy = L->clone();
+
+  std::vector<SaddleConnection<Surface>> found;
+  for (const auto& unit : split) {
+    std::stringstream s;
+    {
+      JSONOutputArchive archive(s);
+      archive(cereal::make_nvp("unit", unit));
+    }
+
+    INFO("Serialized to " << s.str());
+
+    SaddleConnectionsWorkUnit<Surface> deserialized;
+    {
+      JSONInputArchive archive(s);
+      archive(cereal::make_nvp("unit", deserialized));
+    }
+
+    for (const auto& connection : copy.connections().unit(deserialized))
+      found.push_back(connection);
+  }
+
+  // Splitting a sector can change the order in which its saddle connections
+  // are found, so we only compare the connections found.
+  REQUIRE(found.size() == expected.size());
+  for (const auto& connection : found)
+    REQUIRE(std::find_if(begin(expected), end(expected), [&](const auto& c) { return c.vector() == connection.vector() && c.source() == connection.source(); }) != end(expected));
+}
+
+TEMPLATE_TEST_CASE("Serialization of Saddle Connections in Buckets", "[cereal]", (long long), (mpq_class), (renf_elem_class)) {
+  using R2 = Vector<TestType>;
+  using Surface = FlatTriangulation<TestType>;
+  const auto L = makeL<R2>();
+
+  const auto buckets = L->connections().buckets({Bound(2), Bound(4), Bound(8)});
+
+  std::stringstream s;
+  {
+    cereal::BinaryOutputArchive archive(s);
+    archive(buckets);
+  }
+
+  SaddleConnectionsBuckets<Surface> deserialized(*L, {Bound(1)});
+  {
+    cereal::BinaryInputArchive archive(s);
+    archive(deserialized);
+  }
+
+  REQUIRE(deserialized.bounds() == buckets.bounds());
+  REQUIRE(deserialized.size() == buckets.size());
+  for (size_t bucket = 0; bucket < buckets.bounds().size(); bucket++) {
+    REQUIRE(deserialized[bucket].size() == buckets[bucket].size());
+    for (size_t i = 0; i < buckets[bucket].size(); i++)
+      REQUIRE(deserialized[bucket][i].vector() == buckets[bucket][i].vector());
+  }
+
+  for (const auto bound : {Bound(3), Bound(4), Bound(6)})
+    REQUIRE(deserialized.count(bound) == buckets.count(bound));
+}
+
+TEMPLATE_TEST_CASE("Serialization of a FlowDecompositionSummary", "[cereal]", (long long), (mpq_class), (renf_elem_class)) {
+  using cereal::JSONInputArchive;
+  using cereal::JSONOutputArchive;
+
+  using R2 = Vector<TestType>;
+  auto square = makeSquare<R2>();
+
+  auto decomposition = FlowDecomposition<FlatTriangulation<TestType>>(square->clone(), R2(1, 2));
+  REQUIRE(decomposition.decompose());
+
+  const auto serialize = [](const auto& summary) {
+    std::stringstream s;
+    {
+      JSONOutputArchive archive(s);
+      archive(cereal::make_nvp("test", summary));
+    }
+    return s.str();
+  };
+
+  const auto serialized = serialize(decomposition.summary());
+  INFO("Serialized to " << serialized);
+
+  FlowDecompositionSummary<FlatTriangulation<TestType>> summary;
+  {
+    std::stringstream s(serialized);
+    JSONInputArchive archive(s);
+    archive(cereal::make_nvp("test", summary));
+  }
+
+  REQUIRE(summary.vertical == R2(1, 2));
+  REQUIRE(summary.components.size() == decomposition.components().size());
+  REQUIRE(serialize(summary) == serialized);
+}
+
 TEST_CASE("Serialization of a Bound", "[cereal]") {
   testRoundtrip(Bound(13, 37));
 }
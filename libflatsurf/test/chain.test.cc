@@ -18,7 +18,9 @@
  *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
  *********************************************************************/
 
+#include "../flatsurf/bound.hpp"
 #include "../flatsurf/chain.hpp"
+#include "../flatsurf/edge.hpp"
 #include "../flatsurf/flat_triangulation.hpp"
 #include "../flatsurf/half_edge.hpp"
 #include "external/catch2/single_include/catch2/catch.hpp"
@@ -55,6 +57,106 @@ TEMPLATE_TEST_CASE("Chain Arithmetic", "[chain][arithmetic]", (long long), (mpz_
     REQUIRE(a * 1337 == a * 1336 + a);
     REQUIRE((a + b) * 1337 == a * 1337 + b * 1337);
   }
+
+  SECTION("Assignment") {
+    auto c = a;
+    c += b;
+    REQUIRE(c == a + b);
+    REQUIRE(static_cast<const R2&>(c) == static_cast<const R2&>(a) + static_cast<const R2&>(b));
+
+    c = a;
+    REQUIRE(c == a);
+    REQUIRE(static_cast<const R2&>(c) == static_cast<const R2&>(a));
+
+    c += a;
+    REQUIRE(c == a * 2);
+    REQUIRE(a != c);
+
+    auto d = std::move(c);
+    c = b;
+    REQUIRE(c == b);
+    REQUIRE(d == a * 2);
+  }
+
+  SECTION("Comparison with Bounds") {
+    const auto bound = Bound::upper(static_cast<const R2&>(a));
+
+    REQUIRE(!(a > bound));
+    REQUIRE(a > Bound(0));
+    REQUIRE(!(zero > Bound(0)));
+    REQUIRE(!(zero < Bound(0)));
+
+    auto c = a;
+    c *= 3;
+    REQUIRE(static_cast<const R2&>(c) == static_cast<const R2&>(a) * 3);
+    REQUIRE(c > bound);
+    REQUIRE(c < bound * 4);
+
+    c -= a;
+    c -= a;
+    REQUIRE(!(c > bound));
+  }
+
+  SECTION("Large Coefficients") {
+    const mpz_class large("100000000000000000000");
+
+    auto c = a * large + b;
+    REQUIRE(c[Edge(square->halfEdges()[0])] == large);
+    REQUIRE(c[Edge(square->halfEdges()[1])] == 1);
+    REQUIRE(c - a * large == b);
+    REQUIRE(std::hash<Chain<FlatTriangulation<TestType>>>()(c - a * large) == std::hash<Chain<FlatTriangulation<TestType>>>()(b));
+
+    REQUIRE(!c.coefficient(Edge(square->halfEdges()[0])));
+    REQUIRE(c.coefficient(Edge(square->halfEdges()[1])) == 1);
+
+    c -= a * large;
+    c -= b;
+    REQUIRE(!c);
+  }
+
+  SECTION("Machine Integer Coefficients") {
+    // A large coefficient forces the chain into its dense representation.
+    const mpz_class large("100000000000000000000");
+    auto c = a * large;
+    c -= a * large;
+    c += a * 3 - b;
+
+    for (const auto& edge : square->edges()) {
+      REQUIRE(c.coefficient(edge));
+      REQUIRE(*c.coefficient(edge) == c[edge]);
+    }
+
+    for (auto it = c.begin(); it != c.end(); ++it)
+      REQUIRE(*it.coefficient() == *it->second);
+  }
+
+  SECTION("Hashing") {
+    const auto hash = std::hash<Chain<FlatTriangulation<TestType>>>();
+
+    REQUIRE(hash(a + b) == hash(b + a));
+    REQUIRE(hash(a * 2) == hash(a + a));
+    REQUIRE(hash(a - a) == hash(zero));
+    REQUIRE(hash(a) != hash(b));
+    REQUIRE(hash(a) != hash(-a));
+    REQUIRE(a != b);
+  }
+
+  SECTION("Construction from Coefficients") {
+    const mpz_class large("100000000000000000000");
+
+    for (const auto& chain : {zero, a, a - b * 3, a * large + b}) {
+      std::vector<mpz_class> coefficients;
+      for (const auto& edge : square->edges())
+        coefficients.push_back(chain[edge]);
+
+      const auto c = Chain(*square, coefficients);
+      REQUIRE(c == chain);
+      REQUIRE(static_cast<const R2&>(c) == static_cast<const R2&>(chain));
+      REQUIRE(std::hash<Chain<FlatTriangulation<TestType>>>()(c) == std::hash<Chain<FlatTriangulation<TestType>>>()(chain));
+    }
+
+    REQUIRE_THROWS(Chain(*square, std::vector<mpz_class>{1}));
+  }
 }
 
 }  // namespace flatsurf::test
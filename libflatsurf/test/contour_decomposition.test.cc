@@ -74,6 +74,22 @@ TEST_CASE("Perimeter of Contour Decomposition", "[contour_decomposition][perimet
     REQUIRE(lexical_cast<std::string>(decomposition) == "[[(-1, -1) from -2 to 2 → (2, 1) from 1 to 4 → (1, 1) from 2 to -2 → (-2, -1) from -6 to -4], [(-1, -1) from 5 to -5 → (2, 1) from -4 to -6 → (2, 1) from 6 to -1 → (1, 1) from -5 to 5 → (-2, -1) from 4 to 1 → (-2, -1) from -1 to 6]]");
   }
 
+  SECTION("Rotating a Decomposition") {
+    using T = long long;
+    using R2 = Vector<T>;
+    auto surface = makeL<R2>();
+    CAPTURE(*surface);
+
+    const auto decomposition = ContourDecomposition<FlatTriangulation<T>>(surface->clone(), {1, 1});
+
+    const auto same = decomposition.rotate({2, 2});
+    REQUIRE(&same.collapsed() == &decomposition.collapsed());
+
+    const auto rotated = decomposition.rotate({2, 1});
+    REQUIRE(rotated.collapsed().uncollapsed() == decomposition.collapsed().uncollapsed());
+    REQUIRE(lexical_cast<std::string>(rotated) == lexical_cast<std::string>(ContourDecomposition<FlatTriangulation<T>>(surface->clone(), {2, 1})));
+  }
+
   SECTION("A Complicated Surface With Some Collapsed Edges") {
     using T = renf_elem_class;
     using R2 = Vector<T>;
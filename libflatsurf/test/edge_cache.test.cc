@@ -0,0 +1,80 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include "../flatsurf/ccw.hpp"
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/half_edge.hpp"
+#include "../src/impl/edge_cache.hpp"
+#include "external/catch2/single_include/catch2/catch.hpp"
+#include "surfaces.hpp"
+
+namespace flatsurf::test {
+
+TEST_CASE("Edge Cache", "[edge_cache]") {
+  const auto square = makeSquareCombinatorial();
+
+  SECTION("Entries can be Set and Invalidated") {
+    auto cache = EdgeCache<bool>(*square);
+    REQUIRE(cache.size() == square->size());
+
+    for (const auto edge : square->edges())
+      REQUIRE(!cache.contains(edge));
+
+    cache.set(Edge(1), true);
+    cache.set(Edge(2), false);
+    REQUIRE(cache.contains(Edge(1)));
+    REQUIRE(cache.get(Edge(1)) == true);
+    REQUIRE(cache.contains(Edge(2)));
+    REQUIRE(cache.get(Edge(2)) == false);
+    REQUIRE(!cache.contains(Edge(3)));
+
+    cache.swap(Edge(2), Edge(3));
+    REQUIRE(!cache.contains(Edge(2)));
+    REQUIRE(cache.get(Edge(3)) == false);
+
+    cache.erase(Edge(1));
+    REQUIRE(!cache.contains(Edge(1)));
+    REQUIRE(cache.contains(Edge(3)));
+
+    cache.clear();
+    for (const auto edge : square->edges())
+      REQUIRE(!cache.contains(edge));
+  }
+
+  SECTION("Odd Entries are Negated for Negative Half Edges") {
+    auto cache = OddHalfEdgeCache<CCW>(*square);
+    REQUIRE(cache.size() == 2 * square->size());
+
+    cache.set(HalfEdge(-1), CCW::CLOCKWISE);
+    REQUIRE(cache.contains(HalfEdge(1)));
+    REQUIRE(cache.contains(HalfEdge(-1)));
+    REQUIRE(cache.get(HalfEdge(-1)) == CCW::CLOCKWISE);
+    REQUIRE(cache.get(HalfEdge(1)) == CCW::COUNTERCLOCKWISE);
+
+    cache.swap(HalfEdge(1), HalfEdge(-2));
+    REQUIRE(!cache.contains(HalfEdge(1)));
+    REQUIRE(cache.get(HalfEdge(-2)) == CCW::COUNTERCLOCKWISE);
+    REQUIRE(cache.get(HalfEdge(2)) == CCW::CLOCKWISE);
+
+    cache.erase(HalfEdge(2));
+    REQUIRE(!cache.contains(HalfEdge(-2)));
+  }
+}
+
+}  // namespace flatsurf::test
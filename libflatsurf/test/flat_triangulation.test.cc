@@ -23,28 +23,75 @@
 #include <fmt/ostream.h>
 
 #include <exact-real/element.hpp>
+#include <exact-real/integer_ring.hpp>
+#include <exact-real/module.hpp>
 #include <exact-real/number_field.hpp>
+#include <exact-real/real_number.hpp>
+#include <algorithm>
 #include <numeric>
+#include <optional>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
+#include "../flatsurf/async.hpp"
 #include "../flatsurf/ccw.hpp"
+#include "../flatsurf/chain.hpp"
+#include "../flatsurf/decomposition_budget.hpp"
 #include "../flatsurf/deformation.hpp"
 #include "../flatsurf/delaunay.hpp"
+#include "../flatsurf/flow_component.hpp"
+#include "../flatsurf/flow_decomposition.hpp"
 #include "../flatsurf/flat_triangulation.hpp"
+#include "../flatsurf/geodesic_flow.hpp"
 #include "../flatsurf/half_edge.hpp"
 #include "../flatsurf/half_edge_set.hpp"
 #include "../flatsurf/interval_exchange_transformation.hpp"
 #include "../flatsurf/isomorphism.hpp"
+#include "../flatsurf/isomorphism_classes.hpp"
 #include "../flatsurf/odd_half_edge_map.hpp"
 #include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/saddle_connections.hpp"
 #include "../flatsurf/vector.hpp"
+#include "../flatsurf/veech_group.hpp"
+#include "../flatsurf/vertical.hpp"
 #include "../src/external/rx-ranges/include/rx/ranges.hpp"
+#include "../src/impl/approximation.hpp"
+#include "../src/impl/managed_movable.impl.hpp"
 #include "external/catch2/single_include/catch2/catch.hpp"
 #include "generators/half_edge_generator.hpp"
 #include "generators/surface_generator.hpp"
 #include "surfaces.hpp"
 
 namespace flatsurf::test {
+TEMPLATE_TEST_CASE("Create a Flat Triangulation From Flat Buffers", "[flat_triangulation]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  GIVEN("The Square") {
+    const auto square = makeSquare<R2>();
+
+    THEN("The Same Square is Created From the Flat Vertex Permutation and Coordinate Arrays") {
+      const auto surface = FlatTriangulation<T>(FlatTriangulationCombinatorial({1, 3, 2, -1, -3, -2}, {0, 6}, {}), std::vector<T>{T(1), T(0), T(1)}, std::vector<T>{T(0), T(1), T(1)});
+      REQUIRE(surface == *square);
+    }
+  }
+
+  GIVEN("The Square With Boundary") {
+    const auto square = makeSquareWithBoundary<R2>();
+
+    THEN("The Same Square is Created From the Flat Vertex Permutation and Coordinate Arrays") {
+      const auto surface = FlatTriangulation<T>(FlatTriangulationCombinatorial({-2, 1, 3, 2, 4, -1, -3, -4}, {0, 4, 8}, {2, -4}), std::vector<T>{T(1), T(0), T(1), T(0)}, std::vector<T>{T(0), T(1), T(1), T(1)});
+      REQUIRE(surface == *square);
+    }
+
+    THEN("Boundary Half Edges Must be Last at Their Vertex") {
+      REQUIRE_THROWS(FlatTriangulationCombinatorial({2, -2, 1, 3, 4, -1, -3, -4}, {0, 4, 8}, {2, -4}));
+    }
+  }
+}
+
 TEMPLATE_TEST_CASE("Flip in a Flat Triangulation", "[flat_triangulation][flip]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
   using R2 = Vector<TestType>;
   auto square = makeSquare<R2>();
@@ -70,6 +117,61 @@ TEMPLATE_TEST_CASE("Flip in a Flat Triangulation", "[flat_triangulation][flip]",
   }
 }
 
+TEMPLATE_TEST_CASE("Shortest Edge of a Flat Triangulation", "[flat_triangulation][flip][shortest]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto seed = GENERATE(0u, 1u, 2u);
+  auto surface = makeRandomSquareTiled<R2>(6, seed)->clone();
+
+  const auto shortest = [&]() {
+    auto shortest = surface.fromHalfEdge(surface.edges()[0].positive());
+    for (const auto& edge : surface.edges()) {
+      const auto& v = surface.fromHalfEdge(edge.positive());
+      if (v * v < shortest * shortest)
+        shortest = v;
+    }
+    return shortest;
+  };
+
+  GIVEN("The Random Square-Tiled Surface " << surface) {
+    REQUIRE(surface.shortest() == shortest());
+
+    THEN("The Shortest Edge is Maintained when Flipping Edges") {
+      std::mt19937 rand(seed);
+      for (int i = 0; i < 64; i++) {
+        const auto he = surface.halfEdges()[std::uniform_int_distribution<size_t>(0, surface.halfEdges().size() - 1)(rand)];
+        if (!surface.convex(he, true))
+          continue;
+        surface.flip(he);
+        REQUIRE(surface.shortest() == shortest());
+      }
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Approximations of a Flat Triangulation", "[flat_triangulation][flip]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
+  using R2 = Vector<TestType>;
+  auto L = makeL<R2>();
+
+  // Approximations are only computed on first use, so they must be correct
+  // whether or not they are requested before the surface is flipped.
+  const bool approximateFirst = GENERATE(false, true);
+  if (approximateFirst)
+    L->fromHalfEdgeApproximate(HalfEdge(1));
+
+  for (const auto he : L->halfEdges())
+    if (L->convex(he, true))
+      L->flip(he);
+
+  for (const auto he : L->halfEdges()) {
+    const auto& approximation = L->fromHalfEdgeApproximate(he);
+    const auto& vector = L->fromHalfEdge(he);
+    REQUIRE(arb_overlaps(approximation.x().arb_t(), Approximation<TestType>::arb(vector.x(), 64).arb_t()));
+    REQUIRE(arb_overlaps(approximation.y().arb_t(), Approximation<TestType>::arb(vector.y(), 64).arb_t()));
+  }
+}
+
 TEMPLATE_TEST_CASE("Insert into a Flat Triangulation", "[flat_triangulation][insert][slit]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
   using R2 = Vector<TestType>;
 
@@ -97,6 +199,20 @@ TEMPLATE_TEST_CASE("Insert into a Flat Triangulation", "[flat_triangulation][ins
       auto sector = HalfEdge(1);
       REQUIRE(fmt::format("{}", surface.insertAt(sector, R2(5, 1))) == "FlatTriangulationCombinatorial(vertices = (1, -10, 3, 5, 9, 4, -3, -12, 2, -9, 6, 7, 8, -6, -5, -4, -2, -11, -1, -7, -8)(10, 11, 12), faces = (1, -11, 10)(-1, -8, 7)(2, -4, 9)(-2, -12, 11)(3, 4, -5)(-3, -10, 12)(5, -6, -9)(6, 8, -7)) with vectors {1: (3, 0), 2: (-9, -3), 3: (12, 3), 4: (-3, 0), 5: (9, 3), 6: (3, 0), 7: (3, 3), 8: (0, 3), 9: (6, 3), 10: (-5, -1), 11: (-2, -1), 12: (7, 2)}");
     }
+
+    SECTION("Insert Several Points at Once") {
+      std::vector<std::pair<HalfEdge, R2>> points = {{HalfEdge(1), R2(2, 1)}, {HalfEdge(1), R2(5, 1)}};
+
+      auto first = HalfEdge(1);
+      auto second = HalfEdge(1);
+      const auto expected = surface.insertAt(first, R2(2, 1)).surface().insertAt(second, R2(5, 1)).surface();
+
+      const auto inserted = surface.insertAt(points).surface();
+      REQUIRE(fmt::format("{}", inserted) == fmt::format("{}", expected));
+
+      for (const auto& [sector, vector] : points)
+        REQUIRE((inserted.inSector(sector, vector) || inserted.fromHalfEdge(inserted.nextAtVertex(sector)) == vector));
+    }
   }
 
   SECTION("Slit at Many Places in the First Sector") {
@@ -198,13 +314,47 @@ TEMPLATE_TEST_CASE("Delaunay Triangulation of an Octagon", "[flat_triangulation]
   }
 }
 
+TEMPLATE_TEST_CASE("Delaunay Triangulation of a Random Square-Tiled Surface", "[flat_triangulation][delaunay]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using Vector = Vector<T>;
+
+  const int squares = GENERATE(1, 2, 7, 32);
+
+  GIVEN("A Random Square-Tiled Surface with " << squares << " Squares Distorted by a Random Shear") {
+    const auto surface = makeRandomlySheared(*makeRandomSquareTiled<Vector>(squares));
+    CAPTURE(*surface);
+
+    REQUIRE(surface->size() == 3 * static_cast<size_t>(squares));
+    REQUIRE(surface->area() == 2 * squares);
+
+    THEN("Delaunay Triangulation Recovers Short Edges") {
+      surface->delaunay();
+      CAPTURE(*surface);
+      REQUIRE(surface->area() == 2 * squares);
+      for (auto halfEdge : surface->halfEdges()) {
+        REQUIRE(surface->delaunay(halfEdge.edge()) != DELAUNAY::NON_DELAUNAY);
+        REQUIRE(surface->fromHalfEdge(halfEdge) < Bound(2, 0));
+      }
+    }
+  }
+}
+
 TEMPLATE_TEST_CASE("Delaunay Triangulation", "[flat_triangulation][delaunay]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
   const auto [name, surface_] = GENERATE(makeSurface<TestType>());
   auto surface = *surface_;
 
   GIVEN("The Surface " << *name) {
+    auto parallel = surface->clone();
+
     surface->delaunay();
 
+    THEN("Flipping in Parallel also Produces a Delaunay Triangulation") {
+      parallel.delaunay(4);
+
+      for (const auto edge : parallel.edges())
+        REQUIRE(parallel.delaunay(edge) != DELAUNAY::NON_DELAUNAY);
+    }
+
     THEN("Delaunay Cells are Convex and their Boundaries Connected") {
       HalfEdgeSet boundary;
       for (auto halfEdge : surface->halfEdges())
@@ -243,6 +393,218 @@ TEMPLATE_TEST_CASE("Delaunay Triangulation", "[flat_triangulation][delaunay]", (
   }
 }
 
+TEST_CASE("Delaunay Triangulation of a Sheared Surface in Parallel", "[flat_triangulation][delaunay]") {
+  using R2 = Vector<long long>;
+
+  const unsigned int seed = GENERATE(range(0u, 4u));
+  const unsigned int threads = GENERATE(values({2u, 8u}));
+
+  GIVEN("A Random Square-Tiled Surface Sheared by a Large Parabolic") {
+    const auto surface = makeRandomSquareTiled<R2>(64, seed);
+
+    auto sheared = FlatTriangulation<long long>(static_cast<const FlatTriangulationCombinatorial&>(*surface).clone(), [&](const HalfEdge he) {
+      const auto v = surface->fromHalfEdge(he);
+      return R2(v.x() + 32 * v.y(), v.y());
+    });
+
+    auto serial = sheared.clone();
+    serial.delaunay();
+
+    sheared.delaunay(threads);
+
+    THEN("The Result is Delaunay Triangulated") {
+      for (const auto edge : sheared.edges())
+        REQUIRE(sheared.delaunay(edge) != DELAUNAY::NON_DELAUNAY);
+
+      REQUIRE(sheared.canonicalHash(ISOMORPHISM::DELAUNAY_CELLS) == serial.canonicalHash(ISOMORPHISM::DELAUNAY_CELLS));
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Delaunay Triangulation Updates Caches", "[flat_triangulation][delaunay][vertical]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
+  const auto [name, surface_] = GENERATE(makeSurface<TestType>());
+  auto surface = *surface_;
+
+  GIVEN("The Surface " << *name) {
+    const auto vertical = Vertical<FlatTriangulation<TestType>>(*surface, surface->fromHalfEdge(HalfEdge(1)));
+    for (const auto he : surface->halfEdges()) {
+      vertical.ccw(he);
+      vertical.projectPerpendicular(he);
+    }
+    vertical.classifyAll();
+    for (const auto& vertex : surface->vertices())
+      surface->angle(vertex);
+
+    surface->delaunay();
+
+    THEN("The Cached Predicates of a Vertical Agree with the Flipped Vectors") {
+      for (const auto he : surface->halfEdges()) {
+        REQUIRE(vertical.ccw(he) == vertical.ccw(surface->fromHalfEdge(he)));
+        REQUIRE(vertical.projectPerpendicular(he) == vertical.projectPerpendicular(surface->fromHalfEdge(he)));
+      }
+    }
+
+    THEN("The Approximate Projections of a Vertical Decide the Same Comparisons as the Exact Projections") {
+      for (const auto he : surface->halfEdges()) {
+        REQUIRE(arb_overlaps(vertical.projectApproximate(he).arb_t(), Approximation<TestType>::arb(vertical.project(surface->fromHalfEdge(he)), 64).arb_t()));
+        REQUIRE(arb_overlaps(vertical.projectPerpendicularApproximate(he).arb_t(), Approximation<TestType>::arb(vertical.projectPerpendicular(surface->fromHalfEdge(he)), 64).arb_t()));
+      }
+
+      const auto sgn = [](const TestType& x) { return x < 0 ? -1 : (x > 0 ? 1 : 0); };
+      for (const auto a : surface->halfEdges()) {
+        for (const auto b : surface->halfEdges()) {
+          REQUIRE(vertical.compareProjections(a, b) == sgn(vertical.project(surface->fromHalfEdge(a)) - vertical.project(surface->fromHalfEdge(b))));
+          REQUIRE(vertical.compareProjectionsPerpendicular(a, b) == sgn(vertical.projectPerpendicular(surface->fromHalfEdge(a)) - vertical.projectPerpendicular(surface->fromHalfEdge(b))));
+        }
+      }
+    }
+
+    THEN("The Cached Classification of Faces and Edges Agrees with the Flipped Vectors") {
+      vertical.classifyAll();
+
+      // A vertical in a different direction does not share any caches.
+      const auto fresh = Vertical<FlatTriangulation<TestType>>(*surface, 2 * surface->fromHalfEdge(HalfEdge(1)));
+      for (const auto he : surface->halfEdges()) {
+        REQUIRE(vertical.classifyFace(he) == fresh.classifyFace(he));
+        if (!surface->boundary(he) && !surface->boundary(-he))
+          REQUIRE(vertical.large(he) == fresh.large(he));
+      }
+    }
+
+    THEN("The Cached Angles and Degrees Agree with the Flipped Surface") {
+      const auto clone = surface->clone();
+      for (const auto& vertex : surface->vertices()) {
+        REQUIRE(surface->angle(vertex) == clone.angle(vertex));
+        REQUIRE(surface->degree(vertex) == surface->atVertex(vertex).size());
+      }
+    }
+
+    THEN("The Component Labels of a Vertical Agree with its Components") {
+      const auto components = vertical.components();
+      const auto labels = vertical.componentLabels();
+      for (size_t i = 0; i < components.size(); i++)
+        for (const auto he : components[i])
+          REQUIRE(labels[he] == i);
+    }
+
+    THEN("A Vertical in the Same Direction Shares the Updated Caches") {
+      const auto same = Vertical<FlatTriangulation<TestType>>(*surface, surface->fromHalfEdge(HalfEdge(1)));
+      using Implementation = ImplementationOf<ManagedMovable<Vertical<FlatTriangulation<TestType>>>>;
+      REQUIRE(Implementation::self(same).state == Implementation::self(vertical).state);
+      for (const auto he : surface->halfEdges())
+        REQUIRE(same.ccw(he) == same.ccw(surface->fromHalfEdge(he)));
+    }
+
+    THEN("The Approximations Contain the Flipped Vectors") {
+      for (const auto he : surface->halfEdges()) {
+        const auto& approximation = surface->fromHalfEdgeApproximate(he);
+        const auto& vector = surface->fromHalfEdge(he);
+        REQUIRE(arb_overlaps(approximation.x().arb_t(), Approximation<TestType>::arb(vector.x(), 64).arb_t()));
+        REQUIRE(arb_overlaps(approximation.y().arb_t(), Approximation<TestType>::arb(vector.y(), 64).arb_t()));
+      }
+    }
+
+    THEN("The Shortest Vector is the Shortest Flipped Vector") {
+      const auto shortest = surface->shortest();
+      for (const auto he : surface->halfEdges())
+        REQUIRE(shortest * shortest <= surface->fromHalfEdge(he) * surface->fromHalfEdge(he));
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Query a Flat Triangulation from Several Threads", "[flat_triangulation][vertical][threads]", (long long), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::NumberField>)) {
+  using T = TestType;
+
+  const auto [name, surface_] = GENERATE(makeSurface<T>());
+  const auto surface = *surface_;
+
+  GIVEN("The Surface " << *name) {
+    std::vector<SaddleConnection<FlatTriangulation<T>>> connections;
+    for (const auto& connection : surface->connections().bound(4))
+      connections.push_back(connection);
+
+    THEN("Threads Can Share the Surface, its Verticals, and its Saddle Connections") {
+      std::vector<std::vector<CCW>> ccws(4);
+      std::vector<std::thread> threads;
+      for (size_t thread = 0; thread < ccws.size(); thread++)
+        threads.emplace_back([&, thread]() {
+          for (const auto& connection : connections) {
+            const auto& vector = static_cast<const Vector<T>&>(connection.chain());
+            // All threads create the same verticals so they share caches.
+            const auto vertical = Vertical<FlatTriangulation<T>>(*surface, vector);
+            vertical.classifyAll();
+            for (const auto he : surface->halfEdges())
+              ccws[thread].push_back(vertical.ccw(he));
+          }
+        });
+      for (auto& thread : threads)
+        thread.join();
+
+      std::vector<CCW> expected;
+      for (const auto& connection : connections) {
+        const auto vertical = Vertical<FlatTriangulation<T>>(*surface, connection.vector());
+        for (const auto he : surface->halfEdges())
+          expected.push_back(vertical.ccw(surface->fromHalfEdge(he)));
+      }
+
+      for (const auto& ccw : ccws)
+        REQUIRE(ccw == expected);
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Run Operations on a Flat Triangulation Asynchronously", "[flat_triangulation][async]", (long long), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::NumberField>)) {
+  using T = TestType;
+
+  const auto [name, surface_] = GENERATE(makeSurface<T>());
+  const auto surface = *surface_;
+
+  // Run tasks on threads of their own or, to simulate a user-supplied
+  // executor, directly on the calling thread.
+  const bool inline_ = GENERATE(false, true);
+  const auto async = inline_ ? Async(*surface, [](std::function<void()> task) { task(); }) : Async(*surface);
+
+  GIVEN("The Surface " << *name) {
+    THEN("The Asynchronous Delaunay Triangulation Agrees with the Synchronous One") {
+      auto delaunay = async.delaunay().get();
+      for (const auto edge : delaunay.edges())
+        REQUIRE(delaunay.delaunay(edge) != DELAUNAY::NON_DELAUNAY);
+      REQUIRE(surface->area() == delaunay.area());
+    }
+
+    THEN("The Surface is Isomorphic to Itself") {
+      REQUIRE(async.isomorphism(*surface, ISOMORPHISM::FACES).get());
+    }
+
+    THEN("The Saddle Connections Agree with the Synchronous Ones") {
+      std::vector<SaddleConnection<FlatTriangulation<T>>> connections;
+      for (const auto& connection : surface->connections().bound(3))
+        connections.push_back(connection);
+
+      REQUIRE(async.connections(surface->connections().bound(3)).get() == connections);
+    }
+
+    THEN("The Flow Decomposition Agrees with the Synchronous One") {
+      const auto vertical = surface->fromHalfEdge(HalfEdge(1));
+      auto decomposition = async.flowDecomposition(vertical).get();
+      auto expected = FlowDecomposition<FlatTriangulation<T>>(surface->clone(), vertical);
+      expected.decompose();
+      REQUIRE(decomposition.components().size() == expected.components().size());
+    }
+
+    THEN("Cancelled Operations Report a Partial Result") {
+      const auto budget = DecompositionBudget();
+      budget.cancel();
+
+      REQUIRE(async.connections(surface->connections().bound(3), budget).get().empty());
+      REQUIRE(!async.isomorphism(*surface, ISOMORPHISM::FACES, [](const T& a, const T& b, const T& c, const T& d) { return a == 1 && b == 0 && c == 0 && d == 1; }, [](HalfEdge, HalfEdge) { return true; }, budget).get());
+
+      auto decomposition = async.flowDecomposition(surface->fromHalfEdge(HalfEdge(1)), FlowDecomposition<FlatTriangulation<T>>::defaultTarget, budget).get();
+      REQUIRE(decomposition.decompose());
+    }
+  }
+}
+
 TEMPLATE_TEST_CASE("Deform a Flat Triangulation", "[flat_triangulation][deformation]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
   using R2 = Vector<TestType>;
 
@@ -261,6 +623,138 @@ TEMPLATE_TEST_CASE("Deform a Flat Triangulation", "[flat_triangulation][deformat
 
     REQUIRE(surface->operator+(shift).surface() != *surface);
   }
+
+  SECTION("Stretch an L in Place") {
+    auto shift = OddHalfEdgeMap<R2>(*surface);
+
+    shift.set(HalfEdge(8), R2(0, 1));
+    shift.set(HalfEdge(7), R2(0, 1));
+
+    const auto stretched = surface->operator+(shift).surface();
+
+    auto inplace = surface->clone();
+    inplace += shift;
+
+    REQUIRE(inplace == stretched);
+    REQUIRE(inplace.area() == stretched.area());
+  }
+
+  SECTION("Shear an L Along a Long Path") {
+    // Shearing forces many flips along the way.
+    const auto shift = OddHalfEdgeMap<R2>(*surface, [&](const HalfEdge he) {
+      return R2(TestType(surface->fromHalfEdge(he).y() * 8), TestType());
+    });
+
+    const auto sheared = surface->operator+(shift).surface();
+
+    REQUIRE(sheared.area() == surface->area());
+
+    auto inplace = surface->clone();
+    inplace += shift;
+
+    REQUIRE(inplace == sheared);
+  }
+
+  SECTION("Scale an L in Place") {
+    auto inplace = surface->clone();
+    inplace *= 3;
+
+    REQUIRE(inplace == surface->scale(3));
+  }
+}
+
+TEMPLATE_TEST_CASE("Apply a Matrix to a Flat Triangulation", "[flat_triangulation][apply]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto surface = makeL<R2>();
+
+  auto sheared = surface->clone();
+  sheared.delaunay();
+
+  // Populate the caches that are transformed by apply().
+  const Vertical<FlatTriangulation<T>> vertical(sheared, R2(0, 1));
+  for (const auto he : sheared.halfEdges()) {
+    sheared.fromHalfEdgeApproximate(he);
+    vertical.ccw(he);
+    vertical.projectPerpendicular(he);
+  }
+  sheared.area();
+
+  sheared.apply(T(1), T(3), T(0), T(1));
+
+  THEN("The Result is a Delaunay Triangulation of the Sheared Surface") {
+    for (const auto edge : sheared.edges())
+      REQUIRE(sheared.delaunay(edge) != DELAUNAY::NON_DELAUNAY);
+
+    auto expected = FlatTriangulation<T>(surface->combinatorial().clone(), [&](const HalfEdge he) {
+      const auto& v = surface->fromHalfEdge(he);
+      return R2(T(v.x() + 3 * v.y()), v.y());
+    });
+    expected.delaunay();
+
+    REQUIRE(sheared.area() == surface->area());
+    REQUIRE(sheared.isomorphism(expected, ISOMORPHISM::DELAUNAY_CELLS));
+  }
+
+  THEN("The Vertical Follows the Transformation") {
+    REQUIRE(vertical.vertical() == R2(3, 1));
+    for (const auto he : sheared.halfEdges()) {
+      REQUIRE(vertical.ccw(he) == vertical.vertical().ccw(sheared.fromHalfEdge(he)));
+      REQUIRE(vertical.projectPerpendicular(he) == vertical.projectPerpendicular(sheared.fromHalfEdge(he)));
+
+      // The transformed approximation still encloses the exact vector.
+      const auto exact = static_cast<Vector<exactreal::Arb>>(sheared.fromHalfEdge(he));
+      const auto& approximation = sheared.fromHalfEdgeApproximate(he);
+      REQUIRE((exact.x() == approximation.x()) != std::optional<bool>(false));
+      REQUIRE((exact.y() == approximation.y()) != std::optional<bool>(false));
+    }
+  }
+
+  THEN("The Area Scales with the Determinant") {
+    const auto scaled = surface->scale(2);
+    REQUIRE(scaled.area() == 4 * surface->area());
+
+    auto stretched = scaled.clone();
+    stretched.area();
+    stretched.apply(T(2), T(0), T(0), T(1));
+    REQUIRE(stretched.area() == 2 * scaled.area());
+
+    // A fresh clone has no area cached, so it is computed from the approximations.
+    REQUIRE(arb_overlaps(stretched.clone().areaApproximate().arb_t(), Approximation<T>::arb(stretched.area(), 64).arb_t()));
+  }
+}
+
+TEMPLATE_TEST_CASE("Follow the Geodesic Flow on a Flat Triangulation", "[flat_triangulation][geodesic_flow]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto surface = makeL<R2>();
+
+  GeodesicFlow flow(*surface);
+
+  // The diagonal matrix that the flow has applied so far.
+  T a = T(1), d = T(1);
+
+  // Stretch horizontally for a while and then vertically.
+  const std::vector<std::pair<int, int>> steps = {{2, 1}, {2, 1}, {3, 1}, {1, 1}, {1, 2}, {1, 3}, {1, 2}};
+
+  for (const auto& [x, y] : steps) {
+    flow.step(T(x), T(y));
+    a *= x;
+    d *= y;
+
+    CAPTURE(a, d, flow.surface());
+
+    for (const auto edge : flow.surface().edges())
+      REQUIRE(flow.surface().delaunay(edge) != DELAUNAY::NON_DELAUNAY);
+
+    auto expected = surface->clone();
+    expected.apply(a, T(), T(), d);
+
+    REQUIRE(flow.surface().area() == a * d * surface->area());
+    REQUIRE(flow.surface().isomorphism(expected, ISOMORPHISM::DELAUNAY_CELLS));
+  }
 }
 
 TEMPLATE_TEST_CASE("Eliminate Marked Points", "[flat_triangulation][eliminate_marked_points]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
@@ -295,6 +789,56 @@ TEMPLATE_TEST_CASE("Eliminate Marked Points", "[flat_triangulation][eliminate_ma
   }
 }
 
+TEST_CASE("Eliminate Many Marked Points", "[flat_triangulation][eliminate_marked_points]") {
+  using R2 = Vector<long long>;
+
+  const int squares = GENERATE(values({8, 32}));
+  const unsigned int seed = GENERATE(range(0u, 4u));
+
+  GIVEN("A Random Square-Tiled Surface with " << squares << " Squares") {
+    const auto surface = makeRandomSquareTiled<R2>(squares, seed);
+    const auto simplified = surface->eliminateMarkedPoints().surface();
+
+    CAPTURE(*surface, simplified);
+
+    const auto singularities = surface->vertices() | rx::filter([&](const auto& vertex) { return surface->angle(vertex) != 1; }) | rx::count();
+
+    THEN("Only the Singularities Remain") {
+      REQUIRE(simplified.vertices().size() == std::max<size_t>(singularities, 1));
+      REQUIRE(simplified.area() == surface->area());
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Reorder the Half Edges of a Flat Triangulation", "[flat_triangulation][reorder]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
+  using T = TestType;
+
+  const auto [name, surface] = GENERATE(makeSurface<T>());
+  GIVEN("The Surface " << *name) {
+    const auto reorder = (*surface)->reorder();
+    const auto& reordered = reorder.surface();
+
+    CAPTURE(reordered);
+
+    THEN("The Half Edges are Relabeled Consistently") {
+      for (const auto he : (*surface)->halfEdges()) {
+        const auto image = reorder(he);
+        REQUIRE(image);
+        REQUIRE(*reorder(-he) == -*image);
+        REQUIRE(reordered.fromHalfEdge(*image) == (*surface)->fromHalfEdge(he));
+        REQUIRE(reordered.nextAtVertex(*image) == *reorder((*surface)->nextAtVertex(he)));
+        REQUIRE(reordered.boundary(*image) == (*surface)->boundary(he));
+      }
+    }
+
+    THEN("The First Face Keeps its Half Edges") {
+      const auto halfEdges = (*surface)->halfEdges();
+      const auto first = *std::find_if(begin(halfEdges), end(halfEdges), [&](const auto he) { return !(*surface)->boundary(he); });
+      REQUIRE(*reorder(first) == HalfEdge(1));
+    }
+  }
+}
+
 TEMPLATE_TEST_CASE("Detect Isomorphic Surfaces", "[flat_triangulation][isomorphism]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
   using T = TestType;
   using Transformation = std::tuple<T, T, T, T>;
@@ -350,6 +894,186 @@ TEMPLATE_TEST_CASE("Detect Isomorphic Surfaces", "[flat_triangulation][isomorphi
 
     REQUIRE(!(*surface)->isomorphism(scaled, isomorphism));
     REQUIRE((*surface)->isomorphism(scaled, isomorphism, [](const auto&, const auto&, const auto&, const auto&) { return true; }));
+
+    REQUIRE(scaled.canonicalHash(isomorphism) == (*surface)->canonicalHash(isomorphism));
+
+    const auto relabeled = makeRandomlyRelabeled(**surface);
+    CAPTURE(*relabeled);
+
+    REQUIRE((*surface)->isomorphism(*relabeled, isomorphism));
+    REQUIRE(relabeled->canonicalHash(isomorphism) == (*surface)->canonicalHash(isomorphism));
+
+    THEN("Isomorphisms Can Be Searched For in Parallel") {
+      const auto translation = [](const T& a, const T& b, const T& c, const T& d) { return a == 1 && b == 0 && c == 0 && d == 1; };
+      const auto any = [](HalfEdge, HalfEdge) { return true; };
+
+      REQUIRE((*surface)->isomorphism(*relabeled, isomorphism, translation, any, 4));
+      REQUIRE(!(*surface)->isomorphism(scaled, isomorphism, translation, any, 4));
+    }
+
+    if (delaunay) {
+      // Flipping an ambiguous edge does not change the Delaunay cells.
+      auto flipped = (*surface)->clone();
+      for (const auto edge : flipped.edges()) {
+        if (flipped.delaunay(edge) == DELAUNAY::AMBIGUOUS && flipped.convex(edge.positive(), true)) {
+          flipped.flip(edge.positive());
+          break;
+        }
+      }
+      REQUIRE(flipped.canonicalHash(isomorphism) == (*surface)->canonicalHash(isomorphism));
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Partition Surfaces into Isomorphism Classes", "[flat_triangulation][isomorphism][isomorphism_classes]", (long long), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::NumberField>)) {
+  using T = TestType;
+
+  const auto [name, surface] = GENERATE(makeSurface<T>());
+  const int delaunay = GENERATE(values({0, 1}));
+  const auto isomorphism = delaunay ? ISOMORPHISM::DELAUNAY_CELLS : ISOMORPHISM::FACES;
+  const unsigned int threads = GENERATE(values({1u, 4u}));
+
+  if (delaunay)
+    (*surface)->delaunay();
+
+  GIVEN("Copies of the Surface " << *name) {
+    std::vector<FlatTriangulation<T>> surfaces;
+    surfaces.push_back((*surface)->clone());
+    surfaces.push_back(makeRandomlyRelabeled(**surface)->clone());
+    surfaces.push_back((*surface)->scale(2));
+    surfaces.push_back(makeRandomlyRelabeled(**surface, 1)->clone());
+
+    THEN("Translation Equivalent Surfaces are in the Same Class") {
+      const auto classes = IsomorphismClasses<FlatTriangulation<T>>(isomorphism, IsomorphismClasses<FlatTriangulation<T>>::MATRICES::ISOMETRIES, [](const T& a, const T& b, const T& c, const T& d) { return a == 1 && b == 0 && c == 0 && d == 1; }, threads)(surfaces);
+      REQUIRE(classes == std::vector<std::vector<size_t>>{{0, 1, 3}, {2}});
+    }
+
+    THEN("Without Restrictions on the Matrices, all Surfaces are in the Same Class") {
+      const auto classes = IsomorphismClasses<FlatTriangulation<T>>(isomorphism, IsomorphismClasses<FlatTriangulation<T>>::MATRICES::GENERIC, [](const T&, const T&, const T&, const T&) { return true; }, threads)(surfaces);
+      REQUIRE(classes == std::vector<std::vector<size_t>>{{0, 1, 2, 3}});
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Automorphisms of a Surface", "[flat_triangulation][isomorphism][automorphisms]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto square = makeSquare<R2>();
+
+  GIVEN("The Torus " << *square) {
+    THEN("Its Only Translation Automorphism is the Identity") {
+      const auto automorphisms = square->automorphisms(ISOMORPHISM::FACES);
+      REQUIRE(automorphisms.size() == 1);
+      for (const auto he : square->halfEdges())
+        REQUIRE(automorphisms[0](he) == he);
+    }
+
+    THEN("It has the Hyperelliptic Involution as a Rotational Automorphism") {
+      const auto automorphisms = square->automorphisms(ISOMORPHISM::FACES, [](const T& a, const T& b, const T& c, const T& d) { return b == 0 && c == 0 && a == d; });
+      REQUIRE(automorphisms.size() == 2);
+      for (const auto& automorphism : automorphisms)
+        if (automorphism(HalfEdge(1)) != HalfEdge(1))
+          for (const auto he : square->halfEdges())
+            REQUIRE(automorphism(he) == -he);
+    }
+
+    THEN("Composing the Hyperelliptic Involution with Itself gives the Identity") {
+      const auto involution = [&]() {
+        auto automorphisms = square->automorphisms(ISOMORPHISM::FACES, [](const T& a, const T& b, const T& c, const T& d) { return b == 0 && c == 0 && a == d && a < 0; });
+        REQUIRE(automorphisms.size() == 1);
+        return std::move(automorphisms[0]);
+      };
+
+      const auto identity = involution() * involution();
+      REQUIRE(identity.surface() == *square);
+      for (const auto he : square->halfEdges())
+        REQUIRE(identity(he) == he);
+    }
+  }
+
+  const auto seed = GENERATE(0u, 1u, 2u);
+  const auto surface = makeRandomSquareTiled<R2>(6, seed);
+
+  GIVEN("The Random Square-Tiled Surface " << *surface) {
+    THEN("Its Translation Automorphisms Act Freely on the Half Edges") {
+      const auto automorphisms = surface->automorphisms(ISOMORPHISM::FACES);
+      REQUIRE(automorphisms.size() >= 1);
+      REQUIRE(surface->halfEdges().size() % automorphisms.size() == 0);
+
+      std::unordered_set<HalfEdge> images;
+      for (const auto& automorphism : automorphisms)
+        images.insert(*automorphism(HalfEdge(1)));
+      REQUIRE(images.size() == automorphisms.size());
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Elements of the Veech Group of a Surface", "[flat_triangulation][isomorphism][veech_group]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto square = makeSquare<R2>();
+
+  GIVEN("The Torus " << *square) {
+    const auto group = VeechGroup(*square);
+    const auto [u, v] = group.reference();
+
+    REQUIRE(u.ccw(v) != CCW::COLLINEAR);
+
+    THEN("The Elements Mapping the Shortest Connections to Shortest Connections are the Rotations") {
+      const auto elements = group.elements(Bound(1, 0));
+      REQUIRE(elements.size() == 4);
+      for (const auto& element : elements) {
+        REQUIRE(element.a == element.d);
+        REQUIRE(element.b == -element.c);
+      }
+    }
+
+    THEN("It Contains a Parabolic Element") {
+      const auto elements = group.elements(Bound(2, 0), 2);
+      REQUIRE(elements.size() > 4);
+      for (const auto& element : elements)
+        REQUIRE(element.a * element.d - element.b * element.c == element.denominator * element.denominator);
+      REQUIRE(std::any_of(begin(elements), end(elements), [](const auto& element) {
+        const auto& D = element.denominator;
+        return element.a == D && element.b == D && element.c == 0 && element.d == D;
+      }));
+    }
+  }
+}
+
+TEST_CASE("Coordinates of a Surface Share a Module", "[flat_triangulation][exact_real]") {
+  using exactreal::IntegerRing;
+  using exactreal::Module;
+  using exactreal::RealNumber;
+  using T = exactreal::Element<IntegerRing>;
+
+  const auto rational = Module<IntegerRing>::make({RealNumber::rational(1)});
+  const auto irrational = Module<IntegerRing>::make({RealNumber::rational(1), RealNumber::random()});
+  const T one = rational->gen(0);
+  const T other = irrational->gen(0);
+
+  GIVEN("A Square with Coordinates in Different Modules") {
+    const auto square = FlatTriangulation<T>(std::move(*makeSquareCombinatorial()), std::vector{Vector<T>(one, 0 * other), Vector<T>(0 * one, other), Vector<T>(one, other)});
+
+    THEN("All Coordinates Have Been Promoted to the Same Module") {
+      const auto module = square.fromHalfEdge(HalfEdge(1)).x().module();
+      for (const auto he : square.halfEdges()) {
+        REQUIRE(square.fromHalfEdge(he).x().module() == module);
+        REQUIRE(square.fromHalfEdge(he).y().module() == module);
+      }
+
+      for (const auto& connection : square.connections().bound(4)) {
+        REQUIRE(connection.vector().x().module() == module);
+        REQUIRE(connection.vector().y().module() == module);
+      }
+    }
+
+    THEN("The Surface Is Still a Unit Square") {
+      REQUIRE(square.fromHalfEdge(HalfEdge(3)) == Vector<T>(1, 1));
+      REQUIRE(square.area() == 1);
+    }
   }
 }
 
@@ -20,13 +20,17 @@
 
 #include <e-antic/renfxx_fwd.h>
 
+#include <algorithm>
 #include <exact-real/element.hpp>
 #include <exact-real/number_field.hpp>
+#include <random>
 #include <unordered_set>
 
 #include "../flatsurf/edge.hpp"
 #include "../flatsurf/flat_triangulation.hpp"
 #include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/half_edge_set.hpp"
+#include "../flatsurf/half_edge_set_iterator.hpp"
 #include "../flatsurf/vertex.hpp"
 #include "external/catch2/single_include/catch2/catch.hpp"
 #include "generators/combinatorial_surface_generator.hpp"
@@ -42,6 +46,29 @@ TEST_CASE("Flat Triangulation Comparisons", "[flat_triangulation_combinatorial][
   }
 }
 
+TEST_CASE("Flat Triangulation Connected Components", "[flat_triangulation_combinatorial][components]") {
+  SECTION("Connected Surfaces Have a Single Component") {
+    const auto surface = GENERATE(makeSurfaceCombinatorial());
+
+    GIVEN("The Surface " << *surface) {
+      const auto components = surface->components();
+      REQUIRE(components.size() == 1);
+      REQUIRE(components[0].size() == surface->halfEdges().size());
+    }
+  }
+
+  SECTION("Two Squares Have Two Components") {
+    const auto surface = FlatTriangulationCombinatorial(std::vector<std::vector<int>>{{1, 3, 2, -1, -3, -2}, {4, 6, 5, -4, -6, -5}});
+    const auto components = surface.components();
+    REQUIRE(components.size() == 2);
+    for (const auto& component : components) {
+      REQUIRE(component.size() == 6);
+      for (const auto he : component)
+        REQUIRE(std::find(begin(component), end(component), -he) != end(component));
+    }
+  }
+}
+
 TEST_CASE("Flat Triangulation Edges", "[flat_triangulation_combinatorial][edges]") {
   const auto surface = GENERATE(makeSurfaceCombinatorial());
 
@@ -86,6 +113,60 @@ TEST_CASE("Flat Triangulation Vertices", "[flat_triangulation_combinatorial][ver
   }
 }
 
+TEST_CASE("Flat Triangulation Flips", "[flat_triangulation_combinatorial][flip]") {
+  const auto genus = GENERATE(2, 3, 5);
+  const auto surface = makeGenusCombinatorial(genus);
+
+  GIVEN("The Surface " << *surface) {
+    REQUIRE(surface->vertices().size() == 1);
+    REQUIRE(surface->edges().size() == static_cast<size_t>(6 * genus - 3));
+
+    WHEN("We Flip Random Edges") {
+      std::mt19937 random(1337);
+      for (int i = 0; i < 1024; i++)
+        surface->flip(surface->halfEdges()[random() % surface->halfEdges().size()]);
+
+      THEN("The Vertices are Consistent with the Combinatorics") {
+        size_t outgoing = 0;
+        for (const auto& vertex : surface->vertices()) {
+          for (const auto he : vertex.outgoing()) {
+            REQUIRE(vertex.outgoing().contains(surface->nextAtVertex(he)));
+            REQUIRE(Vertex::source(he, *surface) == vertex);
+            outgoing++;
+          }
+        }
+        REQUIRE(outgoing == surface->halfEdges().size());
+      }
+
+      THEN("The Neighbours of Half Edges are Consistent with the Faces") {
+        for (const auto he : surface->halfEdges()) {
+          REQUIRE(surface->previousAtVertex(surface->nextAtVertex(he)) == he);
+          REQUIRE(surface->nextAtVertex(he) == -surface->previousInFace(he));
+          REQUIRE(surface->nextInFace(surface->nextInFace(surface->nextInFace(he))) == he);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Flat Triangulation Clones", "[flat_triangulation_combinatorial][clone]") {
+  const auto surface = makeGenusCombinatorial(2);
+
+  GIVEN("The Surface " << *surface) {
+    auto clone = surface->clone();
+    REQUIRE(clone == *surface);
+
+    WHEN("We Flip an Edge of the Clone") {
+      clone.flip(clone.halfEdges()[0]);
+
+      THEN("The Original Surface is not Affected") {
+        REQUIRE(clone != *surface);
+        REQUIRE(*surface == *makeGenusCombinatorial(2));
+      }
+    }
+  }
+}
+
 TEST_CASE("Flat Triangulation Insertions", "[flat_triangulation_combinatorial][insert]") {
   const auto surface = GENERATE(makeSurfaceCombinatorial());
 
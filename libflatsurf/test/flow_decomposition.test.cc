@@ -18,6 +18,8 @@
  *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
  *********************************************************************/
 
+#include <algorithm>
+
 #include <e-antic/renfxx.h>
 #include <gmpxx.h>
 
@@ -26,9 +28,15 @@
 #include <exact-real/number_field.hpp>
 
 #include "../flatsurf/bound.hpp"
+#include "../flatsurf/ccw.hpp"
+#include "../flatsurf/decomposition_budget.hpp"
 #include "../flatsurf/flow_component.hpp"
 #include "../flatsurf/flow_decomposition.hpp"
+#include "../flatsurf/flow_decomposition_summary.hpp"
+#include "../flatsurf/flow_decompositions.hpp"
 #include "../flatsurf/flow_triangulation.hpp"
+#include "../flatsurf/latency.hpp"
+#include "../flatsurf/orientation.hpp"
 #include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/saddle_connections.hpp"
 #include "../flatsurf/vector.hpp"
@@ -63,6 +71,232 @@ TEST_CASE("Flow Decompositions Over Number Fields", "[flow_decomposition]") {
 
     REQUIRE(flowDecomposition.components().size() == 5);
   }
+
+  SECTION("Decompositions Can Be Resumed After Exhausting Their Budget") {
+    const auto surface = makeCathedralVeech<Vector<T>>();
+    CAPTURE(*surface);
+
+    auto a = N->gen();
+
+    const auto direction = Vector<T>(a + mpq_class(1, 2), 1);
+
+    auto flowDecomposition = FlowDecomposition<FlatTriangulation<T>>(surface->clone(), direction);
+    CAPTURE(flowDecomposition);
+
+    const auto cancelled = DecompositionBudget();
+    cancelled.cancel();
+    REQUIRE(!flowDecomposition.decompose(FlowDecomposition<FlatTriangulation<T>>::defaultTarget, cancelled));
+    REQUIRE(cancelled.consumed() == 0);
+
+    const auto single = DecompositionBudget(1);
+    REQUIRE(!flowDecomposition.decompose(FlowDecomposition<FlatTriangulation<T>>::defaultTarget, single));
+    REQUIRE(single.consumed() == 1);
+    REQUIRE(single.exhausted());
+
+    const auto timed = DecompositionBudget(std::nullopt, std::chrono::hours(1));
+    REQUIRE(flowDecomposition.decompose(FlowDecomposition<FlatTriangulation<T>>::defaultTarget, timed));
+    REQUIRE(!timed.exhausted());
+
+    REQUIRE(flowDecomposition.components().size() == 5);
+  }
+
+  SECTION("Decompositions Can Be Compacted") {
+    const auto surface = makeCathedralVeech<Vector<T>>();
+
+    auto a = N->gen();
+
+    auto flowDecomposition = FlowDecomposition<FlatTriangulation<T>>(surface->clone(), Vector<T>(a + mpq_class(1, 2), 1));
+
+    // Compacting a partial decomposition does not prevent resuming it.
+    REQUIRE(!flowDecomposition.decompose(FlowDecomposition<FlatTriangulation<T>>::defaultTarget, DecompositionBudget(1)));
+    flowDecomposition.compact();
+    REQUIRE(flowDecomposition.decompose());
+
+    const auto summary = flowDecomposition.summary();
+    flowDecomposition.compact();
+
+    const auto compacted = flowDecomposition.summary();
+    REQUIRE(compacted.components.size() == 5);
+    for (size_t i = 0; i < compacted.components.size(); i++) {
+      REQUIRE(compacted.components[i].cylinder == summary.components[i].cylinder);
+      REQUIRE(compacted.components[i].area == summary.components[i].area);
+      REQUIRE(compacted.components[i].perimeter.size() == summary.components[i].perimeter.size());
+    }
+    REQUIRE(flowDecomposition.triangulation().area() == surface->area());
+  }
+
+  SECTION("Decomposition Steps Can Be Traced") {
+    const auto surface = makeCathedralVeech<Vector<T>>();
+
+    auto a = N->gen();
+
+    auto flowDecomposition = FlowDecomposition<FlatTriangulation<T>>(surface->clone(), Vector<T>(a + mpq_class(1, 2), 1));
+
+    const auto initial = flowDecomposition.components().size();
+
+    std::vector<DecompositionBudget::Step> steps;
+    const auto traced = DecompositionBudget();
+    traced.trace([&](const auto& step) { steps.push_back(step); });
+
+    REQUIRE(flowDecomposition.decompose(FlowDecomposition<FlatTriangulation<T>>::defaultTarget, traced));
+
+    REQUIRE(steps.size() == traced.consumed());
+    const auto splits = steps | rx::filter([](const auto& step) { return step.split; }) | rx::count();
+    REQUIRE(initial + splits == flowDecomposition.components().size());
+    for (const auto& step : steps) {
+      REQUIRE(!step.limitReached);
+      REQUIRE(step.lengths <= step.total);
+    }
+  }
+
+  SECTION("Decompositions Honor The Global Latency") {
+    const auto surface = makeCathedralVeech<Vector<T>>();
+
+    auto a = N->gen();
+
+    auto flowDecomposition = FlowDecomposition<FlatTriangulation<T>>(surface->clone(), Vector<T>(a + mpq_class(1, 2), 1));
+
+    const auto initial = flowDecomposition.components().size();
+
+    const auto latency = Latency::global();
+
+    // A decomposition without any time left leaves its components undetermined.
+    Latency::global(Latency(std::chrono::seconds(0)));
+    REQUIRE(!flowDecomposition.decompose());
+    REQUIRE(flowDecomposition.components().size() == initial);
+    const auto components = flowDecomposition.components();
+    REQUIRE(std::any_of(begin(components), end(components), [](const auto& component) { return boost::logic::indeterminate(component.cylinder()); }));
+
+    // Resuming reports the decomposition steps as progress.
+    size_t progress = 0;
+    Latency::global(Latency(std::nullopt, [&](const auto& step) { progress = step.completed; }));
+    REQUIRE(flowDecomposition.decompose());
+    REQUIRE(progress > 0);
+
+    Latency::global(latency);
+
+    REQUIRE(flowDecomposition.components().size() == 5);
+  }
+}
+
+TEST_CASE("Flow Decompositions in Many Directions", "[flow_decomposition]") {
+  using T = long long;
+
+  const auto surface = makeL<Vector<T>>();
+  CAPTURE(*surface);
+
+  const auto directions = surface->connections().bound(3) | rx::transform([](const auto& connection) { return connection.vector(); }) | rx::to_vector();
+  REQUIRE(directions.size() > 1);
+
+  const auto decompositions = FlowDecompositions(*surface, directions);
+
+  const auto threads = GENERATE(1u, 4u);
+
+  SECTION("All Directions are Reported") {
+    size_t reported = 0;
+    decompositions.forEach([&](auto&& decomposition, bool decomposed) {
+      REQUIRE(decomposed);
+      // All rational directions on a square-tiled surface are completely periodic.
+      REQUIRE(decomposition.completelyPeriodic() == boost::logic::tribool(true));
+      reported++;
+      return true;
+    }, FlowDecomposition<FlatTriangulation<T>>::defaultTarget, -1, threads);
+
+    REQUIRE(reported == directions.size());
+  }
+
+  SECTION("No More Directions are Reported Once the Callback Asks to Stop") {
+    size_t reported = 0;
+    decompositions.forEach([&](auto&&, bool) {
+      reported++;
+      return false;
+    }, FlowDecomposition<FlatTriangulation<T>>::defaultTarget, -1, threads);
+
+    REQUIRE(reported == 1);
+  }
+
+  SECTION("Repeated Directions Report the Same Summary") {
+    auto repeated = directions;
+    for (const auto& direction : directions)
+      repeated.push_back(2 * direction);
+
+    std::vector<Vector<T>> reported;
+    FlowDecompositions(*surface, repeated).forEachSummary([&](const auto& direction, const auto& summary, bool decomposed) {
+      REQUIRE(decomposed);
+      REQUIRE(summary.vertical.ccw(direction) == CCW::COLLINEAR);
+      REQUIRE(summary.vertical.orientation(direction) == ORIENTATION::SAME);
+      REQUIRE((summary.components | rx::transform([](const auto& component) { return component.area; }) | rx::sum()) == surface->area());
+      reported.push_back(direction);
+      return true;
+    }, FlowDecomposition<FlatTriangulation<T>>::defaultTarget, -1, threads);
+
+    REQUIRE(reported.size() == repeated.size());
+  }
+
+  SECTION("Directions are Decomposed while Saddle Connections are Enumerated") {
+    const auto capacity = GENERATE(size_t{1}, size_t{0});
+
+    std::vector<Vector<T>> reported;
+    FlowDecompositions<FlatTriangulation<T>>::survey(surface->connections().byLength().bound(3), [&](const auto& direction, const auto& summary, bool decomposed) {
+      REQUIRE(decomposed);
+      REQUIRE(summary.vertical.ccw(direction) == CCW::COLLINEAR);
+      REQUIRE((summary.components | rx::transform([](const auto& component) { return component.area; }) | rx::sum()) == surface->area());
+      for (const auto& previous : reported)
+        REQUIRE(!(previous.ccw(direction) == CCW::COLLINEAR && previous.orientation(direction) == ORIENTATION::SAME));
+      reported.push_back(direction);
+      return true;
+    }, FlowDecomposition<FlatTriangulation<T>>::defaultTarget, -1, threads, capacity);
+
+    size_t distinct = 0;
+    for (size_t i = 0; i < directions.size(); i++) {
+      bool repeated = false;
+      for (size_t j = 0; j < i; j++)
+        repeated = repeated || (directions[j].ccw(directions[i]) == CCW::COLLINEAR && directions[j].orientation(directions[i]) == ORIENTATION::SAME);
+      if (!repeated)
+        distinct++;
+    }
+
+    REQUIRE(reported.size() == distinct);
+  }
+
+  SECTION("Surveying Stops Once the Callback Asks to Stop") {
+    // Stop after two completely periodic directions.
+    size_t periodic = 0;
+    FlowDecompositions<FlatTriangulation<T>>::survey(surface->connections().byLength(), [&](const auto&, const auto& summary, bool) {
+      REQUIRE(std::all_of(begin(summary.components), end(summary.components), [](const auto& component) { return static_cast<bool>(component.cylinder); }));
+      return ++periodic < 2;
+    }, FlowDecomposition<FlatTriangulation<T>>::defaultTarget, -1, threads);
+
+    REQUIRE(periodic == 2);
+  }
+
+  SECTION("Cylinders are Found in the Directions of Saddle Connections") {
+    size_t reported = 0;
+    FlowDecompositions<FlatTriangulation<T>>::cylinders(surface->connections().byLength().bound(3), [&](const auto&, size_t cylinders, boost::logic::tribool hasCylinder) {
+      // All directions of saddle connections on a square-tiled surface contain cylinders.
+      REQUIRE(hasCylinder == boost::logic::tribool(true));
+      REQUIRE(cylinders >= 1);
+      reported++;
+      return true;
+    }, std::nullopt, DecompositionBudget(), threads);
+
+    REQUIRE(reported > 1);
+  }
+
+  SECTION("Cylinder Search Reports Undecided Directions Once the Budget is Exhausted") {
+    DecompositionBudget budget;
+    budget.cancel();
+
+    size_t reported = 0;
+    FlowDecompositions<FlatTriangulation<T>>::cylinders(surface->connections().byLength().bound(3), [&](const auto&, size_t cylinders, boost::logic::tribool hasCylinder) {
+      REQUIRE(boost::logic::indeterminate(hasCylinder));
+      REQUIRE(cylinders == 0);
+      reported++;
+      return true;
+    }, std::nullopt, budget, threads);
+
+    REQUIRE(reported > 1);
+  }
 }
 
 TEMPLATE_TEST_CASE("Flow Decomposition", "[flow_decomposition]", (long long), (mpz_class), (mpq_class), (renf_elem_class), (exactreal::Element<exactreal::IntegerRing>), (exactreal::Element<exactreal::RationalField>), (exactreal::Element<exactreal::NumberField>)) {
@@ -93,12 +327,56 @@ TEMPLATE_TEST_CASE("Flow Decomposition", "[flow_decomposition]", (long long), (m
         CAPTURE(flowDecomposition);
         REQUIRE(area(flowDecomposition.components()) == surface->area());
 
+        AND_THEN("The summaries of its components are consistent") {
+          for (const auto& component : flowDecomposition.components()) {
+            const auto& summary = component.summary();
+            REQUIRE(summary.area == component.area());
+            REQUIRE(summary.width == component.width());
+            REQUIRE(static_cast<bool>(summary.circumferenceHolonomy) == static_cast<bool>(component.cylinder()));
+          }
+        }
+
+        AND_THEN("Its summary outlives the decomposition") {
+          const auto summary = [&]() {
+            auto decomposition = FlowDecomposition<FlatTriangulation<T>>(surface->clone(), vertical);
+            REQUIRE(decomposition.decompose());
+            return decomposition.summary();
+          }();
+
+          REQUIRE(summary.vertical == vertical);
+          REQUIRE(summary.components.size() == flowDecomposition.components().size());
+          REQUIRE((summary.components | rx::transform([](const auto& component) { return component.area; }) | rx::sum()) == surface->area());
+          for (const auto& component : summary.components) {
+            REQUIRE(component.perimeter.size() > 0);
+            REQUIRE(static_cast<bool>(component.circumferenceHolonomy) == static_cast<bool>(component.cylinder));
+          }
+        }
+
         AND_THEN("Each of its components can be triangulated") {
           const auto triangulations = flowDecomposition.components() | rx::transform([](const auto& component) { return component.triangulation(); }) | rx::to_vector();
           REQUIRE((triangulations | rx::transform([](const auto& component) { return component.triangulation().area(); }) | rx::sum()) == surface->area());
           REQUIRE(flowDecomposition.triangulation().area() == surface->area());
+          REQUIRE(flowDecomposition.triangulation(4) == flowDecomposition.triangulation());
         }
       }
+
+      THEN("The flow decomposition can be computed in parallel with the same result") {
+        auto serial = FlowDecomposition<FlatTriangulation<T>>(surface->clone(), vertical);
+        REQUIRE(serial.decompose());
+
+        auto parallel = FlowDecomposition<FlatTriangulation<T>>(surface->clone(), vertical);
+        REQUIRE(parallel.decompose(FlowDecomposition<FlatTriangulation<T>>::defaultTarget, -1, 4));
+
+        CAPTURE(serial);
+        CAPTURE(parallel);
+
+        const auto cylinders = [](const auto& decomposition) {
+          return decomposition.components() | rx::filter([](const auto& component) { return static_cast<bool>(component.cylinder()); }) | rx::count();
+        };
+
+        REQUIRE(parallel.components().size() == serial.components().size());
+        REQUIRE(cylinders(parallel) == cylinders(serial));
+      }
     }
   }
 }
@@ -18,7 +18,13 @@
  *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
  *********************************************************************/
 
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
 #include "../flatsurf/half_edge.hpp"
+#include "../flatsurf/half_edge_set.hpp"
+#include "../flatsurf/half_edge_set_iterator.hpp"
 #include "external/catch2/single_include/catch2/catch.hpp"
 
 namespace flatsurf::test {
@@ -38,4 +44,39 @@ TEST_CASE("HalfEdge Basics", "[half_edge]") {
   REQUIRE(HalfEdge::fromIndex(e.index()) == e);
 }
 
+TEST_CASE("HalfEdge in Constant Expressions", "[half_edge]") {
+  static_assert(std::is_trivially_copyable_v<HalfEdge>);
+  static_assert(std::is_trivially_copyable_v<Edge>);
+
+  constexpr HalfEdge e = HalfEdge::fromIndex(5);
+  static_assert(e.id() == -3);
+  static_assert((-e).index() == 4);
+  static_assert(e.edge() == Edge::fromIndex(2));
+  static_assert(e.edge().positive() == -e);
+  static_assert(e.edge().negative() == e);
+  static_assert(e.edge().index() == 2);
+
+  REQUIRE(e == HalfEdge(-3));
+  REQUIRE(e.edge() == Edge(3));
+}
+
+TEST_CASE("HalfEdgeSet Operations", "[half_edge_set]") {
+  const auto lhs = HalfEdgeSet(std::vector{HalfEdge(1), HalfEdge(-1), HalfEdge(2)});
+  const auto rhs = HalfEdgeSet(std::vector{HalfEdge(2), HalfEdge(3), HalfEdge(-7)});
+
+  REQUIRE((lhs | rhs) == HalfEdgeSet(std::vector{HalfEdge(1), HalfEdge(-1), HalfEdge(2), HalfEdge(3), HalfEdge(-7)}));
+  REQUIRE((lhs & rhs) == HalfEdgeSet(std::vector{HalfEdge(2)}));
+  REQUIRE((rhs & lhs) == HalfEdgeSet(std::vector{HalfEdge(2)}));
+  REQUIRE((lhs - rhs) == HalfEdgeSet(std::vector{HalfEdge(1), HalfEdge(-1)}));
+  REQUIRE((rhs - lhs) == HalfEdgeSet(std::vector{HalfEdge(3), HalfEdge(-7)}));
+  REQUIRE((lhs - lhs).empty());
+  REQUIRE((lhs | rhs).size() == 5);
+
+  std::vector<HalfEdge> elements;
+  for (const auto he : lhs | rhs)
+    elements.push_back(he);
+  REQUIRE(elements.size() == 5);
+  REQUIRE(std::is_sorted(begin(elements), end(elements), [](const auto& a, const auto& b) { return a.index() < b.index(); }));
+}
+
 }  // namespace flatsurf::test
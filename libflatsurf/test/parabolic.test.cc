@@ -174,6 +174,21 @@ TEST_CASE("Parabolic", "[surface]") {
     REQUIRE(flowDecomposition.components().size() == 6);
     REQUIRE(flowDecomposition.parabolic() == boost::logic::tribool(false));
   }
+
+  SECTION("Decomposing Only Until Parabolicity Is Decided") {
+    using T = renf_elem_class;
+    using R2 = Vector<T>;
+    auto surface = makeLParabolicNonParabolic<R2>();
+    CAPTURE(*surface);
+
+    for (const auto& [direction, parabolic] : {std::pair{Vector<T>(1, 0), true}, std::pair{Vector<T>(0, 1), false}}) {
+      auto flowDecomposition = FlowDecomposition<FlatTriangulation<T>>(surface->clone(), direction);
+      CAPTURE(flowDecomposition);
+
+      REQUIRE(flowDecomposition.decomposeUntil([](const auto& decomposition) { return decomposition.parabolic(); }) == boost::logic::tribool(parabolic));
+      REQUIRE(flowDecomposition.completelyPeriodic() == boost::logic::tribool(true));
+    }
+  }
 }
 
 }  // namespace flatsurf::test
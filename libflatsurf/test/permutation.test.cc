@@ -47,6 +47,32 @@ TEST_CASE("Permutation", "[permutation]") {
         }
       }
     }
+
+    THEN("The Flat Cycles are the Cycles") {
+      std::vector<HalfEdge> elements;
+      std::vector<size_t> offsets;
+      p.cycles(elements, offsets);
+
+      const auto cycles = p.cycles();
+      REQUIRE(offsets.size() == cycles.size() + 1);
+      REQUIRE(elements.size() == domain.size());
+      for (size_t i = 0; i < cycles.size(); i++)
+        REQUIRE(std::vector<HalfEdge>(begin(elements) + offsets[i], begin(elements) + offsets[i + 1]) == cycles[i]);
+
+      AND_THEN("It can be Reconstructed From its Flat Cycles") {
+        REQUIRE(p == Permutation<HalfEdge>(elements, offsets));
+      }
+    }
+
+    THEN("Composition is Consistent with Evaluation") {
+      auto q = Permutation<HalfEdge>::random(domain);
+      auto pq = p;
+      pq *= q;
+      for (const auto he : domain) {
+        REQUIRE(pq(he) == p(q(he)));
+        REQUIRE(pq.preimage(pq(he)) == he);
+      }
+    }
   }
 }
 }  // namespace flatsurf::test
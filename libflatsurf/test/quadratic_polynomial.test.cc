@@ -106,6 +106,35 @@ TEMPLATE_TEST_CASE("Quadratic Polynomial", "[quadratic_polynomial]", LIBFLATSURF
     REQUIRE(!(Q(-2, 0, 1) < Q(-2, 0, 1)));
     REQUIRE(Q(-2, 0, 1) < Q(-2, 0, 2));
   }
+
+  SECTION("Polynomials with a Common Root") {
+    // (2t - 1)(4t - 3) and (2t - 1)(4t + 1) both have 1/2 as their smallest
+    // root in [0, 1].
+    REQUIRE(!(Q(8, -10, 3) < Q(8, -2, -1)));
+    REQUIRE(!(Q(8, -2, -1) < Q(8, -10, 3)));
+
+    // (2t - 1)(4t - 1) has 1/4 as its smallest root in [0, 1].
+    REQUIRE(Q(8, -6, 1) < Q(8, -10, 3));
+    REQUIRE(!(Q(8, -10, 3) < Q(8, -6, 1)));
+
+    // The linear 2t - 1 has the same root.
+    REQUIRE(!(Q(0, 2, -1) < Q(8, -10, 3)));
+    REQUIRE(!(Q(8, -10, 3) < Q(0, 2, -1)));
+  }
+
+  SECTION("Refining Roots") {
+    const auto f = Q(1, 1, -1);
+    const auto fast = f.root();
+    const auto precise = f.root(1024);
+    REQUIRE(fast.has_value());
+    REQUIRE(precise.has_value());
+    REQUIRE((*fast == *precise) != std::optional<bool>(false));
+
+    // Asking for the fast approximation again gives an approximation that
+    // is at least as precise.
+    REQUIRE((*f.root() == *precise) != std::optional<bool>(false));
+    REQUIRE(!(*f.root() < *precise).has_value());
+  }
 }
 
 }  // namespace flatsurf::test
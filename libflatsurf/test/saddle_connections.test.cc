@@ -21,24 +21,37 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <algorithm>
+#include <complex>
 #include <exact-real/element.hpp>
 #include <exact-real/number_field.hpp>
+#include <mutex>
+#include <optional>
 #include <unordered_set>
+#include <vector>
 
 #include "../flatsurf/bound.hpp"
 #include "../flatsurf/ccw.hpp"
+#include "../flatsurf/chain.hpp"
 #include "../flatsurf/deformation.hpp"
+#include "../flatsurf/edge.hpp"
+#include "../flatsurf/executor.hpp"
 #include "../flatsurf/flat_triangulation.hpp"
 #include "../flatsurf/half_edge.hpp"
 #include "../flatsurf/orientation.hpp"
 #include "../flatsurf/saddle_connection.hpp"
+#include "../flatsurf/saddle_connection_records.hpp"
 #include "../flatsurf/saddle_connections.hpp"
+#include "../flatsurf/saddle_connections_buckets.hpp"
 #include "../flatsurf/saddle_connections_by_length.hpp"
 #include "../flatsurf/saddle_connections_by_length_iterator.hpp"
+#include "../flatsurf/saddle_connections_index.hpp"
 #include "../flatsurf/saddle_connections_iterator.hpp"
 #include "../flatsurf/saddle_connections_sample.hpp"
 #include "../flatsurf/saddle_connections_sample_iterator.hpp"
+#include "../flatsurf/saddle_connections_statistics.hpp"
 #include "../flatsurf/vector.hpp"
+#include "../flatsurf/vertical.hpp"
 #include "external/catch2/single_include/catch2/catch.hpp"
 #include "generators/saddle_connections_generator.hpp"
 #include "generators/surface_generator.hpp"
@@ -75,6 +88,37 @@ TEMPLATE_TEST_CASE("Saddle Connections on a Torus", "[saddle_connections]", (lon
       REQUIRE(++search == end(connections));
     }
 
+    THEN("Restricting to Sectors Commutes with Restricting to their Sources") {
+      const auto connections = square->connections().bound(3);
+
+      size_t count = 0;
+      for (const auto he : square->halfEdges()) {
+        const auto vertex = Vertex::source(he, *square);
+        REQUIRE(connections.sector(he).count() == connections.source(vertex).sector(he).count());
+        REQUIRE(connections.sector(he).source(vertex).count() == connections.sector(he).count());
+        REQUIRE(connections.sector(he).sector(-he).count() == 0);
+        count += connections.sector(he).count();
+      }
+
+      REQUIRE(count == connections.count());
+    }
+
+    THEN("Saddle Connections Keep Their Surface Alive After the Search") {
+      std::vector<SaddleConnection<FlatTriangulation<TestType>>> connections;
+      {
+        const auto clone = square->clone();
+        for (const auto& connection : clone.connections().bound(4))
+          connections.push_back(connection);
+      }
+
+      REQUIRE(connections.size() > 8);
+      for (const auto& connection : connections) {
+        REQUIRE(connection.surface() == *square);
+        REQUIRE(connection.chain().surface() == *square);
+        REQUIRE(connection.vector() == static_cast<R2>(connection.chain()));
+      }
+    }
+
     THEN("Saddle Connections Within a Fixed Bound Correspond to Coprime Coordinates") {
       auto bound = GENERATE(0, 2, 16);
 
@@ -89,6 +133,35 @@ TEMPLATE_TEST_CASE("Saddle Connections on a Torus", "[saddle_connections]", (lon
         const auto count = std::distance(begin(connections), end(connections));
 
         REQUIRE(count == expected * 8);
+        REQUIRE(connections.count() == static_cast<size_t>(count));
+      }
+
+      AND_THEN("We Find the Same Connections When Searching in Parallel") {
+        const auto replicas = GENERATE(0u, 2u);
+        const auto connections = square->connections().bound(bound).replicated(replicas);
+        const auto threads = GENERATE(1u, 4u);
+        // Without threads of the executor, the calling thread does all the work.
+        const bool serial = GENERATE(false, true);
+
+        const auto executor = Executor::global();
+        if (serial)
+          Executor::global(Executor::serial());
+
+        // Catch2 is not thread-safe, so we must not REQUIRE in the callback.
+        std::mutex lock;
+        std::unordered_set<SaddleConnection<FlatTriangulation<TestType>>> seen;
+        bool duplicates = false;
+        connections.forEach([&](const auto& connection) {
+          std::lock_guard<std::mutex> guard(lock);
+          duplicates |= !seen.insert(connection).second;
+        }, threads);
+
+        Executor::global(executor);
+
+        REQUIRE(!duplicates);
+        REQUIRE(seen.size() == static_cast<size_t>(expected * 8));
+        for (const auto& connection : connections)
+          REQUIRE(seen.find(connection) != seen.end());
       }
 
       AND_THEN("Saddle Connections are Equally Distributed Next to the Half Edges") {
@@ -166,6 +239,7 @@ TEMPLATE_TEST_CASE("Saddle Connections on a Hexagon", "[saddle_connections]", (r
     auto connections = hexagon->connections().bound(bound).sector(edge);
     auto count = std::distance(begin(connections), end(connections));
     REQUIRE(count == required);
+    REQUIRE(connections.count() == static_cast<size_t>(required));
   }
 }
 
@@ -242,6 +316,223 @@ TEMPLATE_TEST_CASE("Saddle Connections on a Surface", "[saddle_connections]", (l
       }
     }
 
+    SECTION("Filling Buffers Produces the Same Connections as Iterating") {
+      const auto connections = surface->connections().bound(Bound::upper(surface->shortest()) * 4);
+
+      auto it = connections.begin();
+      std::vector<HalfEdge> halfEdges;
+      std::vector<mpz_class> coefficients;
+      size_t filled = 0;
+      while (const auto written = it.fill(halfEdges, coefficients, 3))
+        filled += written;
+
+      REQUIRE(it == connections.end());
+      REQUIRE(filled == connections.count());
+      REQUIRE(halfEdges.size() == 2 * filled);
+      REQUIRE(coefficients.size() == surface->size() * filled);
+
+      size_t i = 0;
+      for (const auto& connection : connections) {
+        Chain chain(*surface);
+        for (const auto& edge : surface->edges())
+          chain += Chain(*surface, edge.positive()) * coefficients[i * surface->size() + edge.index()];
+
+        REQUIRE(SaddleConnection(*surface, halfEdges[2 * i], halfEdges[2 * i + 1], chain) == connection);
+        i++;
+      }
+    }
+
+    SECTION("Batches Produce the Same Connections as Iterating") {
+      const auto connections = surface->connections().bound(Bound::upper(surface->shortest()) * 4);
+
+      std::vector<SaddleConnection<FlatTriangulation<T>>> batched;
+      auto it = connections.begin();
+      for (auto batch = it.batch(3); batch.size(); batch = it.batch(3))
+        batched.insert(end(batched), begin(batch), end(batch));
+
+      REQUIRE(it == connections.end());
+      REQUIRE(batched == std::vector<SaddleConnection<FlatTriangulation<T>>>(begin(connections), end(connections)));
+
+      std::vector<SaddleConnection<FlatTriangulation<T>>> byLength;
+      const auto connectionsByLength = connections.byLength();
+      auto jt = connectionsByLength.begin();
+      for (auto batch = jt.batch(3); batch.size(); batch = jt.batch(3))
+        byLength.insert(end(byLength), begin(batch), end(batch));
+
+      REQUIRE(jt == connectionsByLength.end());
+      REQUIRE(byLength == std::vector<SaddleConnection<FlatTriangulation<T>>>(begin(connectionsByLength), end(connectionsByLength)));
+    }
+
+    SECTION("Saddle Connections can be Stored in Compact Records") {
+      const auto connections = surface->connections().bound(Bound::upper(surface->shortest()) * 4);
+
+      SaddleConnectionRecords<FlatTriangulation<T>> records(*surface);
+      auto it = connections.begin();
+      while (it.fill(records, 3))
+        ;
+
+      REQUIRE(records.size() == connections.count());
+
+      size_t i = 0;
+      for (const auto& connection : connections) {
+        REQUIRE(records[i] == connection);
+        REQUIRE(records[records.push_back(connection)] == connection);
+        i++;
+      }
+    }
+
+    SECTION("Compact Records Report Crossings and Angles in Bulk") {
+      const auto connections = surface->connections().bound(Bound::upper(surface->shortest()) * 4);
+
+      SaddleConnectionRecords<FlatTriangulation<T>> records(*surface);
+      for (const auto& connection : connections)
+        records.push_back(connection);
+
+      std::vector<size_t> offsets;
+      std::vector<HalfEdge> crossings;
+      records.crossings(offsets, crossings);
+
+      REQUIRE(offsets.size() == records.size() + 1);
+      REQUIRE(offsets.back() == crossings.size());
+
+      const auto from = records[0];
+      std::vector<int> angles(records.size());
+      records.angles(from, angles.data());
+
+      for (size_t i = 0; i < records.size(); i++) {
+        const auto connection = records[i];
+        CAPTURE(connection);
+
+        const auto crossed = connection.crossings();
+        REQUIRE(std::vector<HalfEdge>(crossings.begin() + offsets[i], crossings.begin() + offsets[i + 1]) == crossed);
+        if (crossed.empty())
+          REQUIRE(connection.vector() == surface->fromHalfEdge(connection.source()));
+        else
+          REQUIRE(crossed.front() == surface->nextInFace(connection.source()));
+
+        const auto angle = from.angle(connection);
+        REQUIRE(angles[i] == (angle ? *angle : -1));
+
+        if (angle) {
+          const int total = surface->angle(Vertex::source(from.source(), *surface));
+          const bool parallel = from.vector().ccw(connection.vector()) == CCW::COLLINEAR && from.vector().orientation(connection.vector()) == ORIENTATION::SAME;
+          REQUIRE(*angle + *connection.angle(from) == total - (parallel ? 0 : 1));
+        }
+      }
+    }
+
+    SECTION("Compact Records can be Exported as Columns") {
+      const auto connections = surface->connections().bound(Bound::upper(surface->shortest()) * 4);
+
+      SaddleConnectionRecords<FlatTriangulation<T>> records(*surface);
+      auto it = connections.begin();
+      while (it.fill(records, 3))
+        ;
+
+      const size_t n = records.size();
+      std::vector<int> sources(n), targets(n);
+      std::vector<double> x(n), y(n), squared(n);
+      records.columns(sources.data(), targets.data(), x.data(), nullptr, squared.data());
+
+      std::vector<size_t> offsets(n + 1), edges(records.terms().size());
+      std::vector<int64_t> coefficients(records.terms().size());
+      records.chains(offsets.data(), edges.data(), coefficients.data());
+
+      REQUIRE(offsets.back() == edges.size());
+
+      size_t i = 0;
+      for (const auto& connection : connections) {
+        REQUIRE(HalfEdge(sources[i]) == connection.source());
+        REQUIRE(HalfEdge(targets[i]) == connection.target());
+
+        const auto vector = static_cast<std::complex<double>>(connection.vector());
+        REQUIRE(x[i] == Approx(vector.real()).margin(1e-9));
+        REQUIRE(squared[i] == Approx(std::norm(vector)).margin(1e-9));
+
+        Chain chain(*surface);
+        for (size_t t = offsets[i]; t != offsets[i + 1]; t++)
+          chain += Chain(*surface, Edge::fromIndex(edges[t]).positive()) * mpz_class(coefficients[t]);
+        REQUIRE(chain == connection.chain());
+
+        i++;
+      }
+    }
+
+    SECTION("Statistics of the Search are Collected Only When Requested") {
+      const auto connections = surface->connections().bound(Bound::upper(surface->shortest()) * 4);
+
+      REQUIRE(!connections.statistics());
+
+      const auto collecting = connections.collectStatistics();
+      const size_t count = collecting.count();
+      REQUIRE(count == connections.count());
+
+      const auto statistics = *collecting.statistics();
+      CAPTURE(statistics);
+      REQUIRE(statistics.trianglesCrossed >= statistics.classifications);
+      REQUIRE(statistics.approximatePredicates + statistics.exactPredicates >= statistics.classifications);
+      REQUIRE(statistics.maximumDepth >= 1);
+
+      AND_THEN("Iterating Adds to the Same Statistics") {
+        REQUIRE(static_cast<size_t>(std::distance(collecting.begin(), collecting.end())) == count);
+        const auto total = *collecting.statistics();
+        REQUIRE(total.classifications == 2 * statistics.classifications);
+        REQUIRE(total.maximumDepth == statistics.maximumDepth);
+      }
+    }
+
+    SECTION("Iterating By Length Finds the Same Connections as Iterating By Angle") {
+      const auto bound = Bound::upper(surface->shortest()) * 8;
+
+      std::unordered_set<SaddleConnection<FlatTriangulation<T>>> byLength;
+      std::optional<SaddleConnection<FlatTriangulation<T>>> previous;
+
+      for (const auto& connection : surface->connections().byLength()) {
+        if (connection > bound)
+          break;
+
+        CAPTURE(connection);
+        REQUIRE(byLength.insert(connection).second);
+        if (previous)
+          REQUIRE(!typename Vector<T>::CompareLength()(connection.vector(), previous->vector()));
+        previous = connection;
+      }
+
+      const auto byAngle = surface->connections().bound(bound);
+      REQUIRE(byLength.size() == byAngle.count());
+      for (const auto& connection : byAngle)
+        REQUIRE(byLength.find(connection) != byLength.end());
+    }
+
+    SECTION("A Best-First Search Finds the Same Connections as Iterating By Angle") {
+      const auto bound = Bound::upper(surface->shortest()) * 8;
+
+      std::unordered_set<SaddleConnection<FlatTriangulation<T>>> byLength;
+      std::optional<SaddleConnection<FlatTriangulation<T>>> previous;
+      bool sorted = true;
+
+      surface->connections().bound(bound).forEachByLength([&](const auto& connection) {
+        byLength.insert(connection);
+        if (previous && typename Vector<T>::CompareLength()(connection.vector(), previous->vector()))
+          sorted = false;
+        previous = connection;
+        return true;
+      });
+
+      REQUIRE(sorted);
+
+      const auto byAngle = surface->connections().bound(bound);
+      REQUIRE(byLength.size() == byAngle.count());
+      for (const auto& connection : byAngle)
+        REQUIRE(byLength.find(connection) != byLength.end());
+
+      size_t reported = 0;
+      surface->connections().bound(bound).forEachByLength([&](const auto&) {
+        return ++reported < 4;
+      });
+      REQUIRE(reported == std::min<size_t>(4, byLength.size()));
+    }
+
     SECTION("A Random Sample Of Connections does not Contain Duplicates") {
       const auto bound = GENERATE(Bound(0), Bound(2));
 
@@ -259,6 +550,542 @@ TEMPLATE_TEST_CASE("Saddle Connections on a Surface", "[saddle_connections]", (l
         if (seen.size() > 16) break;
       }
     }
+
+    SECTION("A Random Sample Along Straight Lines Only Contains Distinct Long Connections") {
+      const auto bound = GENERATE(Bound(0), Bound(2), Bound(8));
+
+      std::unordered_set<SaddleConnection<FlatTriangulation<T>>> seen;
+
+      const auto connections = surface->connections().sample().seed(1337).trajectories(true).lowerBound(bound);
+      REQUIRE(connections.trajectories());
+
+      for (auto connection : connections) {
+        CAPTURE(connection);
+
+        REQUIRE(connection > bound);
+        REQUIRE(seen.find(connection) == seen.end());
+
+        seen.insert(connection);
+
+        if (seen.size() > 16) break;
+      }
+    }
+
+    SECTION("A Seeded Random Sample Of Connections is Reproducible") {
+      const auto connections = surface->connections().sample().seed(1337).deduplication(8);
+      REQUIRE(connections.seed() == 1337u);
+      REQUIRE(connections.deduplication() == size_t{8});
+      REQUIRE(connections.lowerBound(Bound(1)).seed() == 1337u);
+
+      auto first = connections.begin();
+      auto second = connections.begin();
+
+      for (int i = 0; i < 16; i++) {
+        REQUIRE(*first == *second);
+        ++first;
+        ++second;
+      }
+    }
+
+    SECTION("A Parallel Random Sample Of Connections does not Contain Duplicates") {
+      const auto bound = GENERATE(Bound(0), Bound(2));
+      const auto threads = GENERATE(1u, 4u);
+
+      std::mutex lock;
+      std::unordered_set<SaddleConnection<FlatTriangulation<T>>> seen;
+      bool duplicates = false;
+      size_t reported = 0;
+
+      surface->connections().sample().lowerBound(bound).forEach(
+          17, [&](const auto& connection) {
+            std::lock_guard<std::mutex> guard(lock);
+            reported++;
+            if (!seen.insert(connection).second)
+              duplicates = true;
+          },
+          threads, 1337);
+
+      REQUIRE(reported == 17);
+      REQUIRE(!duplicates);
+    }
+  }
+}
+
+TEST_CASE("Saddle Connections on Integer Surfaces", "[saddle_connections][integer]") {
+  using T = long long;
+
+  const auto seed = GENERATE(0u, 1u, 2u);
+  const auto surface = makeRandomlySheared(*makeRandomSquareTiled<Vector<T>>(8, seed), 4, seed);
+
+  GIVEN("The random square-tiled surface " << *surface) {
+    const auto bound = GENERATE(Bound(6), Bound(12));
+
+    const auto iterate = [](const auto& connections) {
+      std::vector<SaddleConnection<FlatTriangulation<T>>> iterated;
+      for (const auto& connection : connections)
+        iterated.push_back(connection);
+      return iterated;
+    };
+
+    const auto forEach = [](const auto& connections) {
+      std::vector<SaddleConnection<FlatTriangulation<T>>> searched;
+      connections.forEach([&](const auto& connection) { searched.push_back(connection); }, 1);
+      return searched;
+    };
+
+    THEN("Searches up to " << bound << " Find the Same Connections in the Same Order as Iterating") {
+      const auto connections = surface->connections().bound(bound);
+      const auto iterated = iterate(connections);
+      REQUIRE(forEach(connections) == iterated);
+      REQUIRE(connections.count() == iterated.size());
+    }
+
+    THEN("Searches with a Lower Bound Find the Same Connections as Iterating") {
+      const auto connections = surface->connections().bound(bound).lowerBound(3);
+      REQUIRE(forEach(connections) == iterate(connections));
+    }
+
+    THEN("Searches in a Sector Find the Same Connections as Iterating") {
+      const auto connections = surface->connections().bound(bound).sector(Vector<T>(1, 0), Vector<T>(2, 3));
+      REQUIRE(forEach(connections) == iterate(connections));
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Count Saddle Connections on Square-Tiled Surfaces", "[saddle_connections][lattice]", (long long), (mpz_class), (mpq_class)) {
+  using T = TestType;
+
+  const auto seed = GENERATE(0u, 1u, 2u);
+  const auto surface = makeRandomlySheared(*makeRandomSquareTiled<Vector<T>>(8, seed), 4, seed);
+
+  GIVEN("The random square-tiled surface " << *surface) {
+    const auto bound = GENERATE(Bound(1), Bound(5), Bound(12));
+
+    const auto iterate = [](const auto& connections) {
+      return static_cast<size_t>(std::distance(begin(connections), end(connections)));
+    };
+
+    THEN("Counting up to " << bound << " Finds as Many Connections as Iterating") {
+      const auto connections = surface->connections().bound(bound);
+      REQUIRE(connections.count() == iterate(connections));
+    }
+
+    THEN("Counting with a Lower Bound Finds as Many Connections as Iterating") {
+      const auto connections = surface->connections().bound(bound).lowerBound(2);
+      REQUIRE(connections.count() == iterate(connections));
+    }
+
+    THEN("Counting at a Vertex Finds as Many Connections as Iterating") {
+      const auto connections = surface->connections().bound(bound).source(Vertex::source(HalfEdge(1), *surface));
+      REQUIRE(connections.count() == iterate(connections));
+    }
+  }
+}
+
+TEST_CASE("Count Saddle Connections with Floating Point Approximations", "[saddle_connections][approximate]") {
+  using T = renf_elem_class;
+  using R2 = Vector<T>;
+
+  const auto surface = GENERATE(makeGoldenL<R2>(), makeOctagon<R2>(), make123<R2>());
+
+  GIVEN("The surface " << *surface) {
+    const auto bound = GENERATE(Bound(4), Bound(16));
+
+    const auto iterate = [](const auto& connections) {
+      return static_cast<size_t>(std::distance(begin(connections), end(connections)));
+    };
+
+    THEN("Counting up to " << bound << " Finds as Many Connections as Iterating") {
+      const auto connections = surface->connections().bound(bound);
+      REQUIRE(connections.count() == iterate(connections));
+    }
+
+    THEN("Counting with a Lower Bound Finds as Many Connections as Iterating") {
+      const auto connections = surface->connections().bound(bound).lowerBound(2);
+      REQUIRE(connections.count() == iterate(connections));
+    }
+
+    THEN("Counting in a Sector Finds as Many Connections as Iterating") {
+      // Sector boundaries that are collinear with saddle connections force
+      // the search to decide some orientations exactly.
+      const auto connections = surface->connections().bound(bound).sector(R2(1, 0), R2(0, 1));
+      REQUIRE(connections.count() == iterate(connections));
+    }
+  }
+}
+
+TEST_CASE("Saddle Connections on a Double Approximation", "[saddle_connections][double]") {
+  using T = renf_elem_class;
+  using R2 = Vector<T>;
+
+  const auto surface = GENERATE(makeGoldenL<R2>(), makeOctagon<R2>(), make123<R2>());
+  const auto approximation = surface->approximate();
+
+  GIVEN("The surface " << *surface << " and its approximation " << approximation) {
+    const auto bound = GENERATE(Bound(4), Bound(16));
+
+    THEN("The Approximation Has the Same Saddle Connections up to " << bound) {
+      const auto connections = approximation.connections().bound(bound);
+      REQUIRE(connections.count() == surface->connections().bound(bound).count());
+
+      for (const auto& connection : connections) {
+        const auto lift = SaddleConnection<FlatTriangulation<T>>::lift(*surface, connection);
+        REQUIRE(lift);
+        REQUIRE(lift->source() == connection.source());
+        REQUIRE(lift->target() == connection.target());
+      }
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Saddle Connections Beyond a Lower Bound", "[saddle_connections][lower_bound]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto surface = GENERATE(makeL<R2>(), makeRandomSquareTiled<R2>(6));
+
+  GIVEN("The surface " << *surface) {
+    const auto lowerBound = GENERATE(Bound(0), Bound(2), Bound(5));
+    const Bound bound = 8;
+
+    std::vector<SaddleConnection<FlatTriangulation<T>>> annulus;
+    for (const auto& connection : surface->connections().bound(bound))
+      if (connection > lowerBound)
+        annulus.push_back(connection);
+
+    THEN("Iterating Beyond " << lowerBound << " Only Skips the Shorter Connections") {
+      std::vector<SaddleConnection<FlatTriangulation<T>>> iterated;
+      for (const auto& connection : surface->connections().bound(bound).lowerBound(lowerBound))
+        iterated.push_back(connection);
+      REQUIRE(iterated == annulus);
+    }
+
+    THEN("Searching Beyond " << lowerBound << " Only Skips the Shorter Connections") {
+      std::vector<SaddleConnection<FlatTriangulation<T>>> searched;
+      surface->connections().bound(bound).lowerBound(lowerBound).forEach([&](const auto& connection) { searched.push_back(connection); }, 1);
+      REQUIRE(searched == annulus);
+    }
+
+    THEN("Searching by Length Beyond " << lowerBound << " Finds the Same Connections") {
+      size_t searched = 0;
+      surface->connections().bound(bound).lowerBound(lowerBound).forEachByLength([&](const auto&) {
+        searched++;
+        return true;
+      });
+      REQUIRE(searched == annulus.size());
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Saddle Connections Near a Saddle Connection", "[saddle_connections][near]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto surface = GENERATE(makeSquare<R2>(), makeL<R2>());
+  const Bound bound = 6;
+
+  GIVEN("The surface " << *surface) {
+    const auto connections = surface->connections().bound(bound);
+    const auto connection = GENERATE_REF(take(4, saddleConnections<T>(surface)));
+
+    THEN("The Connections Near " << connection << " are Those in the Same Sheet Within Epsilon") {
+      const T epsilon = 1;
+
+      const auto perpendicular = connection.vector().perpendicular();
+      const R2 sectorBegin = connection.vector() - perpendicular;
+      const R2 sectorEnd = connection.vector() + perpendicular;
+
+      std::vector<SaddleConnection<FlatTriangulation<T>>> expected;
+      for (const auto& other : connections) {
+        if (!other.vector().inSector(sectorBegin, sectorEnd))
+          continue;
+        // Only report the connections that are reached by turning less than
+        // 2π from connection.
+        const auto angle = connection.vector().ccw(other.vector()) == CCW::CLOCKWISE ? other.angle(connection) : connection.angle(other);
+        if (angle == 0)
+          expected.push_back(other);
+      }
+
+      std::vector<SaddleConnection<FlatTriangulation<T>>> near;
+      for (const auto& other : connections.near(connection, epsilon))
+        near.push_back(other);
+
+      std::sort(begin(expected), end(expected), [](const auto& lhs, const auto& rhs) { return std::hash<SaddleConnection<FlatTriangulation<T>>>()(lhs) < std::hash<SaddleConnection<FlatTriangulation<T>>>()(rhs); });
+      std::sort(begin(near), end(near), [](const auto& lhs, const auto& rhs) { return std::hash<SaddleConnection<FlatTriangulation<T>>>()(lhs) < std::hash<SaddleConnection<FlatTriangulation<T>>>()(rhs); });
+
+      REQUIRE(near == expected);
+      REQUIRE(std::find(begin(near), end(near), connection) != end(near));
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Find a Saddle Connection from its Holonomy", "[saddle_connections][in_sector]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto surface = GENERATE(makeSquare<R2>(), makeL<R2>(), makeRandomSquareTiled<R2>(6));
+
+  GIVEN("The surface " << *surface) {
+    for (const auto& connection : surface->connections().bound(6)) {
+      CAPTURE(connection);
+
+      const auto found = SaddleConnection<FlatTriangulation<T>>::inSector(*surface, connection.source(), connection.vector());
+      REQUIRE(found == connection);
+      REQUIRE(found.target() == connection.target());
+      REQUIRE(found.chain() == connection.chain());
+
+      REQUIRE(SaddleConnection<FlatTriangulation<T>>::inSector(*surface, connection.source(), Vertical(*surface, connection.vector())) == connection);
+
+      // A longer vector in the same direction finds the same connection but
+      // a shorter one does not find any connection.
+      REQUIRE(SaddleConnection<FlatTriangulation<T>>::inSector(*surface, connection.source(), 3 * connection.vector()) == connection);
+      if constexpr (!std::is_same_v<T, long long>)
+        REQUIRE_THROWS(SaddleConnection<FlatTriangulation<T>>::inSector(*surface, connection.source(), connection.vector() / 2));
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Saddle Connections up to Symmetry", "[saddle_connections][symmetric]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto surface = GENERATE(makeSquare<R2>(), makeL<R2>(), makeRandomSquareTiled<R2>(6));
+
+  GIVEN("The Surface " << *surface) {
+    const auto bound = GENERATE(Bound(4), Bound(8));
+
+    const auto collect = [](const auto& connections) {
+      // Catch2 is not thread-safe, so we must not REQUIRE in the callback.
+      std::unordered_set<SaddleConnection<FlatTriangulation<T>>> collected;
+      std::mutex lock;
+      bool duplicates = false;
+      connections.forEach([&](const auto& connection) {
+        std::lock_guard<std::mutex> guard(lock);
+        duplicates |= !collected.insert(connection).second;
+      });
+      REQUIRE(!duplicates);
+      return collected;
+    };
+
+    THEN("Searching up to Symmetry up to " << bound << " Finds the Same Connections as Searching Everything") {
+      const auto connections = surface->connections().bound(bound);
+      REQUIRE(connections.symmetric().count() == connections.count());
+      REQUIRE(collect(connections.symmetric()) == collect(connections));
+    }
+
+    THEN("Searching up to Symmetry in a Sector Finds the Same Connections as Searching That Sector") {
+      const auto connections = surface->connections().bound(bound).sector(HalfEdge(1));
+      REQUIRE(surface->connections().bound(bound).symmetric().sector(HalfEdge(1)).count() == connections.count());
+      REQUIRE(collect(surface->connections().bound(bound).symmetric().sector(HalfEdge(1))) == collect(connections));
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Directions of Saddle Connections", "[saddle_connections][directions]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto surface = GENERATE(makeSquare<R2>(), makeL<R2>());
+
+  GIVEN("The Surface " << *surface) {
+    const auto bound = GENERATE(Bound(4), Bound(8));
+    const auto connections = surface->connections().bound(bound);
+    const auto directions = connections.directions();
+
+    THEN("The Directions up to " << bound << " Account for All the Connections") {
+      size_t count = 0;
+      for (const auto& direction : directions)
+        count += direction.second;
+      REQUIRE(count == connections.count());
+
+      for (const auto& connection : connections)
+        REQUIRE(std::any_of(begin(directions), end(directions), [&](const auto& direction) {
+          return direction.first.ccw(connection.vector()) == CCW::COLLINEAR && direction.first.orientation(connection.vector()) == ORIENTATION::SAME && direction.first * direction.first <= connection.vector() * connection.vector();
+        }));
+    }
+
+    THEN("The Directions are Distinct and in Counterclockwise Order") {
+      REQUIRE(directions.size() > 1);
+      REQUIRE(directions.front().first.y() == 0);
+      REQUIRE(directions.front().first.x() > 0);
+      for (size_t i = 1; i < directions.size(); i++) {
+        if (directions[i].first.y() >= 0 && directions[i - 1].first.y() >= 0)
+          REQUIRE(directions[i - 1].first.ccw(directions[i].first) == CCW::COUNTERCLOCKWISE);
+        if (directions[i].first.y() < 0 && directions[i - 1].first.y() < 0)
+          REQUIRE(directions[i - 1].first.ccw(directions[i].first) == CCW::COUNTERCLOCKWISE);
+      }
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Parallel Searches Split Sectors", "[saddle_connections][parallel]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  const auto surface = GENERATE(makeL<R2>(), makeRandomlySheared(*makeRandomSquareTiled<R2>(6)));
+
+  GIVEN("The Surface " << *surface) {
+    const auto bound = GENERATE(Bound(4), Bound(16));
+    const auto threads = GENERATE(2u, 8u);
+    const auto connections = surface->connections().bound(bound);
+
+    THEN("Searching up to " << bound << " with " << threads << " Threads Finds Every Connection Exactly Once") {
+      // Catch2 is not thread-safe, so we must not REQUIRE in the callback.
+      std::mutex lock;
+      std::unordered_set<SaddleConnection<FlatTriangulation<T>>> seen;
+      bool duplicates = false;
+      connections.forEach([&](const auto& connection) {
+        std::lock_guard<std::mutex> guard(lock);
+        duplicates |= !seen.insert(connection).second;
+      }, threads);
+
+      REQUIRE(!duplicates);
+
+      size_t count = 0;
+      for (const auto& connection : connections) {
+        REQUIRE(seen.find(connection) != seen.end());
+        count++;
+      }
+      REQUIRE(seen.size() == count);
+    }
+
+    THEN("Searching up to " << bound << " with " << threads << " Threads in Order Finds the Connections in the Order of Iteration") {
+      std::vector<SaddleConnection<FlatTriangulation<T>>> ordered;
+      connections.forEachByAngle([&](const auto& connection) { ordered.push_back(connection); }, threads);
+
+      std::vector<SaddleConnection<FlatTriangulation<T>>> iterated;
+      for (const auto& connection : connections)
+        iterated.push_back(connection);
+
+      REQUIRE(ordered == iterated);
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Index Saddle Connections by Angle", "[saddle_connections][index]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+  using Surface = FlatTriangulation<T>;
+
+  const auto surface = makeL<R2>();
+  const auto index = SaddleConnectionsIndex(*surface, Bound(8));
+
+  GIVEN("The L " << *surface << " with " << index) {
+    REQUIRE(index.size() == surface->connections().bound(8).count());
+
+    const auto [sectorBegin, sectorEnd] = GENERATE(values<std::pair<R2, R2>>({{R2(1, 0), R2(0, 1)}, {R2(2, 1), R2(1, 2)}, {R2(1, 1), R2(1, -1)}, {R2(-3, 1), R2(-3, 1)}, {R2(0, -1), R2(1, 0)}}));
+    const auto bound = GENERATE(Bound(3), Bound(8), Bound(12));
+
+    THEN("Queries in the Sector from " << sectorBegin << " to " << sectorEnd << " up to " << bound << " Find the Same Connections as a Search") {
+      std::unordered_set<SaddleConnection<Surface>> expected;
+      for (const auto& connection : surface->connections().bound(bound).sector(sectorBegin, sectorEnd))
+        expected.insert(connection);
+
+      const auto indexed = index.sector(sectorBegin, sectorEnd, bound);
+
+      REQUIRE(indexed.size() == expected.size());
+      REQUIRE(std::unordered_set<SaddleConnection<Surface>>(begin(indexed), end(indexed)) == expected);
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Bucket Saddle Connections by Length", "[saddle_connections][buckets]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+  using Surface = FlatTriangulation<T>;
+
+  const auto surface = GENERATE(makeSquare<R2>(), makeL<R2>());
+  const auto threads = GENERATE(1u, 4u);
+
+  GIVEN("The Surface " << *surface) {
+    const auto buckets = surface->connections().buckets({Bound(1), Bound(2), Bound(4), Bound(8)}, threads);
+
+    THEN("The Buckets Count Each Connection up to the Last Bound Once") {
+      REQUIRE(buckets.size() == surface->connections().bound(8).count());
+      for (size_t bucket = 0; bucket < buckets.bounds().size(); bucket++)
+        for (size_t i = 0; i < buckets[bucket].size(); i++)
+          REQUIRE(buckets.bucket(buckets[bucket][i]) == bucket);
+    }
+
+    const auto bound = GENERATE(Bound(0), Bound(1), Bound(3), Bound(4), Bound(5), Bound(8), Bound(12));
+
+    THEN("Counting up to " << bound << " Agrees with a Search") {
+      REQUIRE(buckets.count(bound) == surface->connections().bound(std::min(bound, Bound(8))).count());
+    }
+
+    THEN("The Connections in a Range up to " << bound << " Agree with a Search") {
+      const Bound lower(2, 1);
+
+      std::unordered_set<SaddleConnection<Surface>> expected;
+      for (const auto& connection : surface->connections().bound(std::min(bound, Bound(8))))
+        if (connection > lower)
+          expected.insert(connection);
+
+      const auto range = buckets.range(lower, bound);
+      REQUIRE(range.size() == expected.size());
+      REQUIRE(std::unordered_set<SaddleConnection<Surface>>(begin(range), end(range)) == expected);
+      REQUIRE(buckets.count(lower, bound) == expected.size());
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Cache Saddle Connections on a Surface", "[saddle_connections][cached]", (long long), (mpq_class), (renf_elem_class)) {
+  using T = TestType;
+  using R2 = Vector<T>;
+
+  auto surface = makeL<R2>()->clone();
+
+  const auto count = [&](const auto& connections) {
+    size_t count = 0;
+    connections.forEach([&](const auto&) { count++; }, 1);
+    return count;
+  };
+
+  GIVEN("The L " << surface) {
+    const auto bound = GENERATE(Bound(4), Bound(8));
+
+    THEN("Cached Searches up to " << bound << " Find the Same Connections as Searches of the Surface") {
+      REQUIRE(surface.connections().cached().bound(bound).count() == surface.connections().bound(bound).count());
+
+      AND_THEN("Searches with Smaller Bounds, Lower Bounds, and in Sectors are Served from the Cache") {
+        REQUIRE(surface.connections().cached().bound(3).count() == surface.connections().bound(3).count());
+        REQUIRE(surface.connections().cached().bound(bound).lowerBound(2).count() == surface.connections().bound(bound).lowerBound(2).count());
+        REQUIRE(count(surface.connections().cached().bound(bound).sector(R2(1, 0), R2(1, 1))) == surface.connections().bound(bound).sector(R2(1, 0), R2(1, 1)).count());
+        REQUIRE(count(surface.connections().cached().bound(bound).sector(HalfEdge(1))) == surface.connections().bound(bound).sector(HalfEdge(1)).count());
+      }
+
+      AND_THEN("Cached Connections are Reported by Increasing Length") {
+        std::vector<SaddleConnection<FlatTriangulation<T>>> connections;
+        surface.connections().cached().bound(bound).forEachByLength([&](const auto& connection) {
+          connections.push_back(connection);
+          return true;
+        });
+
+        REQUIRE(connections.size() == surface.connections().bound(bound).count());
+        for (size_t i = 1; i < connections.size(); i++)
+          REQUIRE(connections[i - 1].vector() * connections[i - 1].vector() <= connections[i].vector() * connections[i].vector());
+      }
+
+      AND_WHEN("We Flip an Edge") {
+        for (const auto he : surface.halfEdges()) {
+          if (surface.convex(he, true)) {
+            surface.flip(he);
+            break;
+          }
+        }
+
+        THEN("The Cache is Rebuilt") {
+          std::unordered_set<SaddleConnection<FlatTriangulation<T>>> cached;
+          surface.connections().cached().bound(bound).forEach([&](const auto& connection) { cached.insert(connection); }, 1);
+
+          std::unordered_set<SaddleConnection<FlatTriangulation<T>>> searched;
+          for (const auto& connection : surface.connections().bound(bound))
+            searched.insert(connection);
+
+          REQUIRE(cached == searched);
+        }
+      }
+    }
   }
 }
 }  // namespace flatsurf::test
@@ -28,7 +28,15 @@
 #include <exact-real/module.hpp>
 #include <exact-real/number_field.hpp>
 #include <exact-real/real_number.hpp>
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "../flatsurf/flat_triangulation.hpp"
@@ -83,6 +91,56 @@ auto makeL() {
   return std::make_shared<FlatTriangulation<typename R2::Coordinate>>(std::move(*makeLCombinatorial()), vectors);
 }
 
+// Return a triangulation with a single vertex of a surface of the given
+// genus. The surface is a 4g-gon whose sides are glued as a₁b₁a₁⁻¹b₁⁻¹⋯ and
+// that is triangulated by the diagonals from one of its corners.
+inline auto makeGenusCombinatorial(int genus) {
+  const int sides = 4 * genus;
+  const int edges = 6 * genus - 3;
+
+  // The half edges along the sides of the polygon, counterclockwise.
+  const auto side = [&](int i) {
+    const int pair = 2 * (i / 4);
+    switch (i % 4) {
+      case 0:
+        return pair + 1;
+      case 1:
+        return pair + 2;
+      case 2:
+        return -(pair + 1);
+      default:
+        return -(pair + 2);
+    }
+  };
+  // The half edges from the first corner to the k-th corner and back.
+  const auto spoke = [&](int k) { return k == 1 ? side(0) : 2 * genus + k - 1; };
+  const auto back = [&](int k) { return k == sides - 1 ? side(sides - 1) : -(2 * genus + k - 1); };
+
+  std::unordered_map<int, int> previousInFace;
+  for (int k = 1; k < sides - 1; k++) {
+    const int face[] = {spoke(k), side(k), back(k + 1)};
+    for (int i = 0; i < 3; i++)
+      previousInFace[face[(i + 1) % 3]] = face[i];
+  }
+
+  // Walk around the vertices, see ImplementationOf<FlatTriangulationCombinatorial>::check().
+  auto vertices = vector<vector<int>>{};
+  std::unordered_set<int> visited;
+  for (int e = 1; e <= edges; e++) {
+    for (int start : {e, -e}) {
+      if (visited.count(start))
+        continue;
+      vertices.emplace_back();
+      for (int he = start; !visited.count(he); he = -previousInFace[he]) {
+        visited.insert(he);
+        vertices.back().push_back(he);
+      }
+    }
+  }
+
+  return std::make_shared<FlatTriangulationCombinatorial>(vertices);
+}
+
 template <typename R2>
 auto makeGoldenL() {
   vector<R2> vectors;
@@ -288,6 +346,124 @@ auto make1234() {
   return std::make_shared<FlatTriangulation<typename R2::Coordinate>>(std::move(*make1234Combinatorial()), vectors);
 }
 
+// Return the combinatorial structure of a random square-tiled surface made
+// from the given number of unit squares, each cut into two triangles by its
+// diagonal. The right neighbours of the squares are a random cycle so that
+// the surface is connected; the top neighbours are a random permutation.
+inline auto makeRandomSquareTiledCombinatorial(int squares, unsigned int seed = 1337) {
+  std::mt19937 rand(seed);
+
+  vector<int> order(squares);
+  std::iota(begin(order), end(order), 0);
+  std::shuffle(begin(order), end(order), rand);
+  vector<int> right(squares);
+  for (int i = 0; i < squares; i++)
+    right[order[i]] = order[(i + 1) % squares];
+
+  vector<int> top(squares);
+  std::iota(begin(top), end(top), 0);
+  std::shuffle(begin(top), end(top), rand);
+
+  // The half edges along the bottom, along the left side, and along the
+  // diagonal of the i-th square from its bottom left corner.
+  const auto bottom = [](int i) { return HalfEdge(3 * i + 1); };
+  const auto left = [](int i) { return HalfEdge(3 * i + 2); };
+  const auto diagonal = [](int i) { return HalfEdge(3 * i + 3); };
+
+  vector<std::tuple<HalfEdge, HalfEdge, HalfEdge>> faces;
+  for (int i = 0; i < squares; i++) {
+    faces.emplace_back(bottom(i), left(right[i]), -diagonal(i));
+    faces.emplace_back(diagonal(i), -bottom(top[i]), -left(i));
+  }
+
+  return std::make_shared<FlatTriangulationCombinatorial>(faces);
+}
+
+// Return a random square-tiled surface, see
+// makeRandomSquareTiledCombinatorial().
+template <typename R2>
+auto makeRandomSquareTiled(int squares, unsigned int seed = 1337) {
+  vector<R2> vectors;
+  for (int i = 0; i < squares; i++)
+    vectors.insert(end(vectors), {R2(1, 0), R2(0, 1), R2(1, 1)});
+  return std::make_shared<FlatTriangulation<typename R2::Coordinate>>(std::move(*makeRandomSquareTiledCombinatorial(squares, seed)), vectors);
+}
+
+// Return the image of surface under a random element of SL(2, Z), namely a
+// product of the given number of random horizontal and vertical shears.
+// When surface is a Veech surface, such as a square-tiled surface, so is the
+// result; but its triangulation is typically far from Delaunay.
+template <typename T>
+auto makeRandomlySheared(const FlatTriangulation<T>& surface, int shears = 4, unsigned int seed = 1337) {
+  std::mt19937 rand(seed);
+  std::uniform_int_distribution<int> shear(-3, 3);
+
+  int a = 1, b = 0, c = 0, d = 1;
+  for (int i = 0; i < shears; i++) {
+    const int k = shear(rand);
+    if (i % 2)
+      std::tie(a, b) = std::pair(a + k * c, b + k * d);
+    else
+      std::tie(c, d) = std::pair(c + k * a, d + k * b);
+  }
+
+  return std::make_shared<FlatTriangulation<T>>(static_cast<const FlatTriangulationCombinatorics<FlatTriangulation<T>>&>(surface).clone(), [&](HalfEdge e) {
+    const auto& v = surface.fromHalfEdge(e);
+    return Vector<T>(a * v.x() + b * v.y(), c * v.x() + d * v.y());
+  });
+}
+
+// Return a copy of surface where the given number of random edges have been
+// flipped (among those that are strictly convex.)
+template <typename T>
+auto makeRandomlyFlipped(const FlatTriangulation<T>& surface, int flips, unsigned int seed = 1337) {
+  std::mt19937 rand(seed);
+
+  auto flipped = std::make_shared<FlatTriangulation<T>>(static_cast<const FlatTriangulationCombinatorics<FlatTriangulation<T>>&>(surface).clone(), [&](HalfEdge e) {
+    return surface.fromHalfEdge(e);
+  });
+  std::uniform_int_distribution<size_t> edge(0, flipped->halfEdges().size() - 1);
+  for (int i = 0; i < flips; i++) {
+    const HalfEdge e = flipped->halfEdges()[edge(rand)];
+    if (flipped->convex(e, true))
+      flipped->flip(e);
+  }
+  return flipped;
+}
+
+// Return a copy of surface whose edges have been randomly renumbered and
+// reoriented, i.e., a surface that is isomorphic to surface with
+// ISOMORPHISM::FACES but not equal to it.
+template <typename T>
+auto makeRandomlyRelabeled(const FlatTriangulation<T>& surface, unsigned int seed = 1337) {
+  std::mt19937 rand(seed);
+
+  vector<int> ids(surface.size());
+  std::iota(begin(ids), end(ids), 1);
+  std::shuffle(begin(ids), end(ids), rand);
+  std::bernoulli_distribution reorient;
+  for (auto& id : ids)
+    if (reorient(rand))
+      id = -id;
+
+  const auto relabel = [&](HalfEdge he) {
+    const int id = ids[static_cast<size_t>(std::abs(he.id())) - 1];
+    return HalfEdge(he.id() > 0 ? id : -id);
+  };
+
+  vector<std::tuple<HalfEdge, HalfEdge, HalfEdge>> faces;
+  for (const auto& [a, b, c] : surface.faces())
+    faces.emplace_back(relabel(a), relabel(b), relabel(c));
+
+  std::unordered_map<HalfEdge, HalfEdge> preimage;
+  for (const auto he : surface.halfEdges())
+    preimage[relabel(he)] = he;
+
+  return std::make_shared<FlatTriangulation<T>>(FlatTriangulationCombinatorial(faces), [&](HalfEdge e) {
+    return surface.fromHalfEdge(preimage.at(e));
+  });
+}
+
 }  // namespace flatsurf::test
 
 #endif
@@ -29,6 +29,8 @@
 
 #include "../flatsurf/bound.hpp"
 #include "../flatsurf/ccw.hpp"
+#include "../flatsurf/exact_fallbacks.hpp"
+#include "../flatsurf/orientation.hpp"
 #include "../flatsurf/saddle_connection.hpp"
 #include "../flatsurf/saddle_connections.hpp"
 #include "../flatsurf/saddle_connections_iterator.hpp"
@@ -108,6 +110,31 @@ TEMPLATE_TEST_CASE("Exact Vectors", "[vector]", (long long), (mpz_class), (mpq_c
     REQUIRE(v.ccw(V(0, -1)) == CCW::CLOCKWISE);
   }
 
+  if constexpr (std::is_same_v<T, mpz_class> || std::is_same_v<T, mpq_class>) {
+    SECTION("CCWs are Computed when Coordinates Overflow Machine Integers") {
+      const T large("4611686018427387904");  // 2^62
+      V v(large, large + 1);
+
+      REQUIRE(v.ccw(V(large - 1, large)) == CCW::COUNTERCLOCKWISE);
+      REQUIRE(v.ccw(V(large + 1, large)) == CCW::CLOCKWISE);
+      REQUIRE(v.ccw(v * 2) == CCW::COLLINEAR);
+      REQUIRE(v.orientation(V(-large - 1, large)) == ORIENTATION::ORTHOGONAL);
+      REQUIRE(typename V::CompareLength()(V(large, 0), v));
+    }
+  }
+
+  if constexpr (std::is_same_v<T, eantic::renf_elem_class>) {
+    SECTION("CCWs are Computed over Quadratic Fields") {
+      const auto a = L->gen();
+      V v(a, 2 * a + 1);
+
+      REQUIRE(v.ccw(V(a * a, (2 * a + 1) * a)) == CCW::COLLINEAR);
+      REQUIRE(v.ccw(V(a, 2 * a)) == CCW::CLOCKWISE);
+      REQUIRE(v.orientation(V(-(2 * a + 1) / 3, a / 3)) == ORIENTATION::ORTHOGONAL);
+      REQUIRE(v.orientation(v) == ORIENTATION::SAME);
+    }
+  }
+
   SECTION("Non-Zero Detection") {
     REQUIRE(static_cast<bool>(V(2, 3)) == true);
     REQUIRE(static_cast<bool>(V()) == false);
@@ -137,4 +164,37 @@ TEMPLATE_TEST_CASE("Inexact Vectors", "[vector]", (exactreal::Arb)) {
   }
 }
 
+TEST_CASE("Exact Fallbacks of Vector Predicates are Counted", "[vector][exact_fallbacks]") {
+  using V = Vector<eantic::renf_elem_class>;
+
+  ExactFallbacks::enable();
+  ExactFallbacks::reset();
+
+  const auto ccw = [](const auto& sites) {
+    for (const auto& site : sites)
+      if (site.name == "Vector::ccw")
+        return site;
+    return ExactFallbacks::Site{"Vector::ccw", 0, 0, {}};
+  };
+
+  const auto before = ccw(ExactFallbacks::sites());
+  REQUIRE(before.decided == 0);
+  REQUIRE(before.undecided == 0);
+
+  // The balls can decide the orientation of non-collinear vectors.
+  REQUIRE(V(1, 0).ccw(V(N->gen(), 1)) == CCW::COUNTERCLOCKWISE);
+  // But collinear vectors with irrational coordinates need exact arithmetic.
+  REQUIRE(V(1, N->gen()).ccw(V(2, 2 * N->gen())) == CCW::COLLINEAR);
+
+  const auto after = ccw(ExactFallbacks::sites());
+  CAPTURE(after);
+  REQUIRE(after.decided == 1);
+  REQUIRE(after.undecided == 1);
+
+  ExactFallbacks::enable(false);
+
+  REQUIRE(V(1, N->gen()).ccw(V(2, 2 * N->gen())) == CCW::COLLINEAR);
+  REQUIRE(ccw(ExactFallbacks::sites()).undecided == 1);
+}
+
 }  // namespace flatsurf::test
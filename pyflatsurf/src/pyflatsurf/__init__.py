@@ -23,6 +23,15 @@ Pickling works::
     >>> loads(dumps(square)) == square
     True
 
+Saddle connections share their surface when pickled together::
+
+    >>> connections = [c for c in square.connections().bound(4)]
+    >>> unpickled = loads(dumps(connections))
+    >>> [str(c) for c in unpickled] == [str(c) for c in connections]
+    True
+    >>> len(dumps(connections)) < len(connections) * len(dumps(square))
+    True
+
 """
 #*********************************************************************
 #  This file is part of flatsurf.
@@ -26,7 +26,7 @@ from cppyy.gbl import std
 
 from pyexactreal import exactreal
 
-from .pythonization import enable_iterable
+from .pythonization import enable_iterable, enable_pickling, release_gil
 
 from cppyythonizations.pickling.cereal import enable_cereal
 from cppyythonizations.util import filtered, add_method, wrap_method
@@ -48,6 +48,7 @@ cppyy.py.add_pythonization(filtered(re.compile("Vector<.*>"))(enable_arithmetic)
 cppyy.py.add_pythonization(filtered(re.compile("Vector<.*>"))(add_method("__str__")(lambda self: "(" + str(self.x()) + ", " + str(self.y()) + ")")), "flatsurf")
 cppyy.py.add_pythonization(enable_pretty_printing, "flatsurf")
 cppyy.py.add_pythonization(lambda proxy, name: enable_cereal(proxy, name, ["flatsurf/cereal.hpp"]), "flatsurf")
+cppyy.py.add_pythonization(enable_pickling, "flatsurf")
 cppyy.py.add_pythonization(filtered(re.compile("vector<flatsurf::.*>"))(enable_list_printing), "std")
 
 
@@ -62,6 +63,14 @@ cppyy.py.add_pythonization(filtered(re.compile("FlowDecomposition<.*>"))(add_met
 cppyy.py.add_pythonization(filtered(re.compile("FlowDecomposition<.*>"))(add_method("undeterminedComponents")(lambda self: [component for component in self.components() if not (component.cylinder() == True) and not (component.withoutPeriodicTrajectory() == True)])), "flatsurf")
 cppyy.py.add_pythonization(filtered(re.compile("FlowDecomposition<.*>"))(add_method("__str__")(lambda self: "FlowDecomposition with %d cylinders, %d minimal components and %d undetermined components" % (len(self.cylinders()), len(self.minimalComponents()), len(self.undeterminedComponents())))), "flatsurf")
 
+# Release the GIL during long running computations that do not call back
+# into Python so that these can run in parallel in Python threads.
+cppyy.py.add_pythonization(filtered(re.compile("FlatTriangulation<.*>"))(release_gil("delaunay", "eliminateMarkedPoints")), "flatsurf")
+cppyy.py.add_pythonization(filtered(re.compile("SaddleConnections<.*>"))(release_gil("count")), "flatsurf")
+cppyy.py.add_pythonization(filtered(re.compile("SaddleConnectionsIterator<.*>"))(release_gil("fill", "batch")), "flatsurf")
+cppyy.py.add_pythonization(filtered(re.compile("SaddleConnectionsByLengthIterator<.*>"))(release_gil("batch")), "flatsurf")
+cppyy.py.add_pythonization(filtered(re.compile("FlowDecomposition<.*>"))(release_gil("triangulation")), "flatsurf")
+
 # We have to workaround issues with complex std::function parameters in cppyy
 cppyy.py.add_pythonization(filtered(re.compile("FlatTriangulation<.*>"))(add_method("isomorphism")(lambda self, other, kind=None, filter_matrix=lambda a,b,c,d: a == 1 and b == 0 and c == 0 and d == 1, filter_map=lambda a, b: True: cppyy.gbl.flatsurf.isomorphism[type(self).Coordinate.__cpp_name__](self, other, kind or cppyy.gbl.flatsurf.ISOMORPHISM.FACES, lambda m: filter_matrix(m.a, m.b, m.c, m.d), filter_map))), "flatsurf")
 
@@ -70,7 +79,18 @@ for path in os.environ.get('PYFLATSURF_INCLUDE','').split(':'):
     if path: cppyy.add_include_path(path)
 
 
+# Load the precompiled classes of libflatsurf if pyflatsurf has been built
+# with a cppyy dictionary, see src/Makefile.am. Otherwise, cppyy compiles
+# these on demand which can take a long time.
+dictionary = os.environ.get('PYFLATSURF_DICTIONARY', os.path.join(os.path.dirname(__file__), 'libpyflatsurf_dict.so'))
+if dictionary and os.path.exists(dictionary):
+    cppyy.load_reflection_info(dictionary)
+
 cppyy.include("flatsurf/cppyy.hpp")
 
+# The decomposition is driven by the helpers in cppyy.hpp, see above.
+cppyy.gbl.flatsurf.makeFlowDecomposition.__release_gil__ = True
+cppyy.gbl.flatsurf.decomposeFlowDecomposition.__release_gil__ = True
+
 
 from cppyy.gbl import flatsurf
@@ -0,0 +1,258 @@
+# -*- coding: utf-8 -*-
+r"""
+Export of large amounts of data from libflatsurf into columnar formats.
+
+EXAMPLES::
+
+    >>> from pyflatsurf import Surface, flatsurf
+    >>> from pyflatsurf.export import saddle_connection_columns
+    >>> R2 = flatsurf.Vector['long long']
+    >>> square = Surface([[1, 3, 2, -1, -3, -2]], [R2(1, 0), R2(0, 1), R2(1, 1)])
+    >>> columns = saddle_connection_columns(square.connections().bound(4))
+    >>> len(columns["source"])
+    32
+    >>> sorted(columns.keys())
+    ['source', 'squared', 'target', 'x', 'y']
+
+"""
+#*********************************************************************
+#  This file is part of flatsurf.
+#
+#        Copyright (C) 2020 Julian Rüth
+#
+#  Flatsurf is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  Flatsurf is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+#*********************************************************************
+
+import array
+
+from .cppyy_flatsurf import flatsurf
+
+def _allocate(typecode, size):
+    r"""
+    Return a zero-initialized buffer of ``size`` entries of type
+    ``typecode``, a numpy array if numpy is available and an ``array.array``
+    otherwise.
+    """
+    try:
+        import numpy
+    except ModuleNotFoundError:
+        return array.array(typecode, bytes(array.array(typecode).itemsize * size))
+    return numpy.zeros(size, dtype=typecode)
+
+def saddle_connection_records(connections, chunk=1 << 16):
+    r"""
+    Return the saddle connections in ``connections`` as compact
+    ``SaddleConnectionRecords``.
+
+    The connections are pulled from the iterator ``chunk`` at a time so
+    that they do not cross into Python one by one.
+
+    EXAMPLES::
+
+        >>> from pyflatsurf import Surface, flatsurf
+        >>> from pyflatsurf.export import saddle_connection_records
+        >>> R2 = flatsurf.Vector['long long']
+        >>> square = Surface([[1, 3, 2, -1, -3, -2]], [R2(1, 0), R2(0, 1), R2(1, 1)])
+        >>> records = saddle_connection_records(square.connections().bound(4))
+        >>> records.size()
+        32
+
+    """
+    surface = connections.surface()
+    records = flatsurf.SaddleConnectionRecords[type(surface)](surface)
+    iterator = connections.begin()
+    while iterator.fill(records, chunk):
+        pass
+    return records
+
+def saddle_connection_columns(connections, exact=False, arrow=False, chunk=1 << 16):
+    r"""
+    Return the saddle connections in ``connections`` column by column.
+
+    The result is a dictionary of numpy arrays (or ``array.array`` if numpy
+    is not available) with the ids of the ``source`` and ``target`` half
+    edges, floating point approximations ``x`` and ``y`` of the coordinates
+    and the ``squared`` length of each connection.
+
+    ``connections`` can also be ``SaddleConnectionRecords``.
+
+    If ``exact`` is set, the exact chains of the connections are included
+    in compressed sparse row format: the nonzero coefficients of the i-th
+    connection in terms of the edge vectors are ``coefficients[j]`` at the
+    edges ``edges[j]`` for ``offsets[i] <= j < offsets[i + 1]``.
+
+    If ``arrow`` is set, a ``pyarrow.RecordBatch`` is returned instead,
+    where the exact chains are list columns ``edges`` and ``coefficients``.
+
+    EXAMPLES::
+
+        >>> from pyflatsurf import Surface, flatsurf
+        >>> from pyflatsurf.export import saddle_connection_columns
+        >>> R2 = flatsurf.Vector['long long']
+        >>> square = Surface([[1, 3, 2, -1, -3, -2]], [R2(1, 0), R2(0, 1), R2(1, 1)])
+        >>> columns = saddle_connection_columns(square.connections().bound(2).sector(flatsurf.HalfEdge(1)), exact=True)
+        >>> columns["x"].tolist(), columns["y"].tolist()
+        ([1.0], [0.0])
+        >>> columns["offsets"].tolist(), columns["edges"].tolist(), columns["coefficients"].tolist()
+        ([0, 1], [0], [1])
+
+    """
+    records = connections if hasattr(connections, "records") else saddle_connection_records(connections, chunk=chunk)
+
+    size = records.size()
+    columns = {
+        "source": _allocate("i", size),
+        "target": _allocate("i", size),
+        "x": _allocate("d", size),
+        "y": _allocate("d", size),
+        "squared": _allocate("d", size),
+    }
+    records.columns(columns["source"], columns["target"], columns["x"], columns["y"], columns["squared"])
+
+    if exact:
+        terms = records.terms().size()
+        chains = {
+            "offsets": _allocate("Q", size + 1),
+            "edges": _allocate("Q", terms),
+            "coefficients": _allocate("q", terms),
+        }
+        records.chains(chains["offsets"], chains["edges"], chains["coefficients"])
+
+    if not arrow:
+        if exact:
+            columns.update(chains)
+        return columns
+
+    import pyarrow
+    names = list(columns.keys())
+    arrays = [pyarrow.array(column) for column in columns.values()]
+    if exact:
+        offsets = pyarrow.array(chains["offsets"]).cast(pyarrow.int64())
+        for name in ["edges", "coefficients"]:
+            names.append(name)
+            arrays.append(pyarrow.LargeListArray.from_arrays(offsets, pyarrow.array(chains[name])))
+    return pyarrow.RecordBatch.from_arrays(arrays, names=names)
+
+class VectorArray:
+    r"""
+    An array of flatsurf vectors backed by a C++ ``std::vector`` on which
+    arithmetic happens elementwise in C++.
+
+    EXAMPLES::
+
+        >>> from pyflatsurf import flatsurf
+        >>> from pyflatsurf.export import VectorArray
+        >>> R2 = flatsurf.Vector['long long']
+        >>> vectors = VectorArray([R2(1, 0), R2(0, 1), R2(1, 1)])
+        >>> len(vectors)
+        3
+        >>> vectors[2]
+        (1, 1)
+        >>> (2 * vectors + vectors).numpy().tolist()
+        [[3.0, 0.0], [0.0, 3.0], [3.0, 3.0]]
+        >>> (vectors - vectors).numpy().tolist()
+        [[0.0, 0.0], [0.0, 0.0], [0.0, 0.0]]
+        >>> vectors.ccw(R2(1, 0)).tolist()
+        [0, 1, 1]
+
+    The vectors of saddle connections can be postprocessed in bulk::
+
+        >>> from pyflatsurf import Surface
+        >>> square = Surface([[1, 3, 2, -1, -3, -2]], [R2(1, 0), R2(0, 1), R2(1, 1)])
+        >>> connections = VectorArray([connection.vector() for connection in square.connections().bound(2)])
+        >>> len(connections)
+        16
+
+    """
+    def __init__(self, vectors, type=None):
+        import cppyy
+        vectors = list(vectors)
+        if type is None:
+            if not vectors:
+                raise ValueError("cannot deduce the type of an empty array of vectors")
+            type = vectors[0].__class__
+        self._type = type
+        self._vectors = cppyy.gbl.std.vector[type]()
+        self._vectors.reserve(len(vectors))
+        for vector in vectors:
+            self._vectors.push_back(vector)
+
+    def _wrap(self, vectors):
+        r"""
+        Return a ``VectorArray`` of the same type backed by the C++ array
+        ``vectors`` without copying it.
+        """
+        wrapped = VectorArray.__new__(VectorArray)
+        wrapped._type = self._type
+        wrapped._vectors = vectors
+        return wrapped
+
+    def __len__(self):
+        return self._vectors.size()
+
+    def __getitem__(self, i):
+        if i < 0:
+            i += len(self)
+        if not 0 <= i < len(self):
+            raise IndexError(i)
+        return self._type(self._vectors[i])
+
+    def __iter__(self):
+        for i in range(len(self)):
+            yield self[i]
+
+    def __add__(self, other):
+        if not isinstance(other, VectorArray):
+            return NotImplemented
+        return self._wrap(flatsurf.addVectors(self._vectors, other._vectors, 1))
+
+    def __sub__(self, other):
+        if not isinstance(other, VectorArray):
+            return NotImplemented
+        return self._wrap(flatsurf.addVectors(self._vectors, other._vectors, -1))
+
+    def __neg__(self):
+        return self * -1
+
+    def __mul__(self, scalar):
+        import cppyy
+        return self._wrap(flatsurf.scaleVectors(self._vectors, cppyy.gbl.mpz_class(str(int(scalar)))))
+
+    __rmul__ = __mul__
+
+    def ccw(self, direction):
+        r"""
+        Return the orientation of each vector relative to ``direction`` as
+        an array of ints, i.e., the values of ``flatsurf::CCW``.
+        """
+        ccw = _allocate("i", len(self))
+        flatsurf.ccwVectors(self._vectors, direction, ccw)
+        return ccw
+
+    def numpy(self):
+        r"""
+        Return floating point approximations of the vectors as a numpy array
+        of shape ``(len(self), 2)``.
+        """
+        import numpy
+        xy = numpy.zeros(2 * len(self), dtype="d")
+        flatsurf.approximateVectors(self._vectors, xy)
+        return xy.reshape((len(self), 2))
+
+    def __array__(self, dtype=None):
+        xy = self.numpy()
+        return xy if dtype is None else xy.astype(dtype)
+
+    def __repr__(self):
+        return "VectorArray([%s])" % ", ".join(repr(vector) for vector in self)
@@ -18,11 +18,20 @@
 #  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
 #*********************************************************************
 
+import array
+
 import cppyy
 from .cppyy_flatsurf import flatsurf
 
 def make_FlatTriangulation(vertices, vectors):
-    vertices = cppyy.gbl.std.vector[cppyy.gbl.std.vector[int]]([cppyy.gbl.std.vector[int](l) for l in vertices])
+    # We hand the vertex permutation to C++ as a single flat buffer with the
+    # offsets of the cycles so that C++ does not need to allocate a vector
+    # for each vertex.
+    offsets = [0]
+    for cycle in vertices:
+        offsets.append(offsets[-1] + len(cycle))
+    offsets = cppyy.gbl.std.vector['size_t'](offsets)
+    vertices = cppyy.gbl.std.vector[int]([e for cycle in vertices for e in cycle])
     R2 = type(vectors[0])
     vectors = cppyy.gbl.std.vector[R2](vectors)
 
@@ -30,7 +39,64 @@ def make_FlatTriangulation(vertices, vectors):
     # combinatorial = cppyy.gbl.flatsurf.FlatTriangulationCombinatorial(vertices)
     # return cppyy.gbl.flatsurf.FlatTriangulation[R2.Coordinate](cppyy.gbl.std.move(combinatorial), vectors)
 
-    return cppyy.gbl.flatsurf.makeFlatTriangulation(vertices, vectors)
+    return cppyy.gbl.flatsurf.makeFlatTriangulation(vertices, offsets, vectors)
+
+def _buffer(values, typecode):
+    r"""
+    Return ``values`` as an object supporting the buffer protocol with
+    entries of type ``typecode``, e.g., a numpy array or an ``array.array``,
+    without copying if ``values`` already is such an object.
+    """
+    try:
+        view = memoryview(values)
+        if view.format == typecode or (view.itemsize == array.array(typecode).itemsize and view.format in "ilq"):
+            return values
+    except TypeError:
+        pass
+    return array.array(typecode, values)
+
+def make_FlatTriangulation_from_buffers(vertices, offsets, coordinates, denominators=None, field=None, coordinate="mpq_class"):
+    r"""
+    Return a FlatTriangulation from contiguous buffers, e.g., numpy arrays.
+
+    The half edges around the i-th vertex are
+    ``vertices[offsets[i]:offsets[i+1]]``. Without a ``field``,
+    ``coordinates`` are the integer coordinates ``x, y`` of the edges 1, 2,
+    …, which are turned into vectors with ``coordinate`` entries. With a
+    ``field``, ``coordinates`` holds the numerators of the coefficients of
+    each coordinate in the power basis of ``field`` and ``denominators``
+    holds the common denominator of each coordinate.
+
+    Since the buffers are handed to C++ as they are, this is much faster
+    than :func:`make_FlatTriangulation` for large surfaces.
+
+    EXAMPLES::
+
+        >>> from pyflatsurf import Surface, flatsurf
+        >>> from pyflatsurf.factory import make_FlatTriangulation_from_buffers
+        >>> square = make_FlatTriangulation_from_buffers([1, 3, 2, -1, -3, -2], [0, 6], [1, 0, 0, 1, 1, 1], coordinate="long long")
+        >>> R2 = flatsurf.Vector['long long']
+        >>> square == Surface([[1, 3, 2, -1, -3, -2]], [R2(1, 0), R2(0, 1), R2(1, 1)])
+        True
+
+    """
+    vertices = _buffer(vertices, "i")
+    offsets = _buffer(offsets, "q")
+    coordinates = _buffer(coordinates, "q")
+    cycles = len(offsets) - 1
+
+    if field is None:
+        if len(coordinates) % 2:
+            raise ValueError("coordinates must contain an x and a y coordinate for each edge")
+        return cppyy.gbl.flatsurf.makeFlatTriangulationFromBuffers[coordinate](vertices, offsets, cycles, coordinates, len(coordinates) // 2)
+
+    if denominators is None:
+        raise ValueError("denominators must be given for coordinates in a number field")
+    denominators = _buffer(denominators, "q")
+    if len(denominators) % 2 or len(coordinates) % len(denominators):
+        raise ValueError("there must be a denominator for each coordinate and the same number of coefficients for each coordinate")
+    degree = len(coordinates) // len(denominators)
+    return cppyy.gbl.flatsurf.makeFlatTriangulationFromBuffers(field, vertices, offsets, cycles, coordinates, denominators, degree, len(denominators) // 2)
 
 def make_surface(surface_or_vertices, vectors = None):
     from collections.abc import Iterable
@@ -18,6 +18,9 @@
 #  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
 #*********************************************************************
 
+import re
+import weakref
+
 import cppyy
 
 def enable_iterable(proxy, name):
@@ -25,7 +28,24 @@ def enable_iterable(proxy, name):
         if not hasattr(proxy, '__iter__'):
             def iter(self):
                 i = self.begin()
-                while i != self.end():
+
+                if hasattr(i, 'batch'):
+                    # Pull the elements from C++ in batches. We start with
+                    # small batches so that consumers that only want a few
+                    # elements do not trigger an expensive search.
+                    size = 1
+                    while True:
+                        batch = i.batch(size)
+                        for element in batch:
+                            # The elements of batch are only valid while
+                            # batch is alive so we hand out copies.
+                            yield type(element)(element)
+                        if len(batch) < size:
+                            return
+                        size = min(2 * size, 1024)
+
+                end = self.end()
+                while i != end:
                     if hasattr(i, '__deref__'):
                         yield i.__deref__()
                     elif hasattr(i, 'dereference'):
@@ -42,7 +62,131 @@ def enable_iterable(proxy, name):
             proxy.__iter__ = iter
 
         if not hasattr(proxy, '__len__'):
-            def len(self):
-                return cppyy.gbl.std.distance(self.begin(), self.end())
+            if hasattr(proxy, 'size'):
+                def len(self):
+                    return self.size()
+
+                proxy.__len__ = len
+            elif hasattr(proxy, 'count'):
+                # Saddle connections count without constructing any
+                # connection and remember that count, see
+                # SaddleConnections::count().
+                def len(self):
+                    return self.count()
+
+                proxy.__len__ = len
+            elif not name.startswith('SaddleConnections'):
+                # The other ranges of saddle connections, e.g., samples and
+                # connections by length, are typically infinite, so we do
+                # not count them by iterating.
+                def len(self):
+                    return cppyy.gbl.std.distance(self.begin(), self.end())
+
+                proxy.__len__ = len
+
+def release_gil(*methods):
+    r"""
+    Return a pythonization that releases the Python GIL while the given
+    methods run in C++ so that other Python threads can run concurrently.
+
+    Only use this for methods that do not call back into Python.
+    """
+    def pythonization(proxy, name):
+        for method in methods:
+            if hasattr(proxy, method):
+                getattr(proxy, method).__release_gil__ = True
+
+    return pythonization
+
+
+def _pickle():
+    r"""
+    Return the C++ helpers for pickling, see ``flatsurf/pickle.hpp``.
+    """
+    if not hasattr(cppyy.gbl.flatsurf, "pickle"):
+        cppyy.include("flatsurf/pickle.hpp")
+    return cppyy.gbl.flatsurf.pickle
+
+
+def _dump(value, *surface):
+    r"""
+    Return ``value`` written to a binary cereal archive as bytes, see
+    ``flatsurf/pickle.hpp``.
+    """
+    buffer = _pickle().save(value, *surface)
+    view = buffer.data()
+    view.reshape((buffer.size(),))
+    return bytes(view)
+
+
+def _load(cpp_name, data, *surface):
+    r"""
+    Return the object of type ``cpp_name`` that has been written with
+    :func:`_dump`.
+    """
+    if surface:
+        return _pickle().load[cpp_name, type(surface[0]).__cpp_name__](data, len(data), *surface)
+    return _pickle().load[cpp_name](data, len(data))
+
+
+def _surface(reference):
+    r"""
+    Return the surface that ``reference`` resolved to when unpickling.
+    """
+    return reference
+
+
+class _SurfaceReference:
+    r"""
+    A surface that is pickled on behalf of the objects living on it.
+
+    There is only one such reference for each surface at any time, so the
+    pickle stream memoizes it and the surface is only written once to a
+    stream, no matter how many objects on that surface are in it. When
+    unpickling, the reference turns into the surface itself.
+    """
+    _references = weakref.WeakValueDictionary()
+
+    def __init__(self, owner, surface):
+        # The owner keeps the surface alive, so its identity cannot be
+        # taken by another surface while this reference exists.
+        self._owner = owner
+        self._surface = surface
+
+    @classmethod
+    def of(cls, owner, surface):
+        identity = int(_pickle().identity(surface))
+        reference = cls._references.get(identity)
+        if reference is None:
+            reference = cls(owner, surface)
+            cls._references[identity] = reference
+        return reference
+
+    def __reduce__(self):
+        return (_load, (type(self._surface).__cpp_name__, _dump(self._surface)))
+
+
+def enable_pickling(proxy, name):
+    r"""
+    Pickle flatsurf objects with compact binary cereal archives instead of
+    the JSON archives of ``cppyythonizations.pickling.cereal``.
+
+    Objects that live on a surface, such as saddle connections, do not
+    contain their surface. Instead, their surface is pickled once per pickle
+    stream.
+    """
+    def reduce(self):
+        return (_load, (type(self).__cpp_name__, _dump(self)))
+
+    if re.match(r"FlatTriangulation<.*>$", name):
+        def reduce(self):
+            return (_surface, (_SurfaceReference.of(self, self),))
+    elif re.match(r"(Chain|SaddleConnection|Vertical)<.*>$", name):
+        def reduce(self):
+            surface = self.surface()
+            return (_load, (type(self).__cpp_name__, _dump(self, surface), _SurfaceReference.of(self, surface)))
+    elif not re.match(r"(FlatTriangulationCombinatorial|Vector<.*>|Bound|HalfEdge|Edge)$", name):
+        return
 
-            proxy.__len__ = len
+    proxy.__reduce__ = reduce
+    proxy.__reduce_ex__ = lambda self, protocol: self.__reduce__()
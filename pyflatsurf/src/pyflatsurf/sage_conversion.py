@@ -0,0 +1,179 @@
+# -*- coding: utf-8 -*-
+r"""
+Conversion of sage-flatsurf surfaces to libflatsurf surfaces.
+
+EXAMPLES::
+
+    sage: import flatsurf as sage_flatsurf
+    sage: from pyflatsurf.sage_conversion import to_FlatTriangulation
+    sage: T = sage_flatsurf.polygons.triangle(2, 3, 4)
+    sage: S = sage_flatsurf.similarity_surfaces.billiard(T).minimal_cover(cover_type="translation")
+    sage: to_FlatTriangulation(S)
+    FlatTriangulationCombinatorial(vertices = ...
+
+"""
+#*********************************************************************
+#  This file is part of flatsurf.
+#
+#        Copyright (C) 2020 Julian Rüth
+#
+#  Flatsurf is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  Flatsurf is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+#*********************************************************************
+
+import array
+
+from .factory import make_FlatTriangulation, make_FlatTriangulation_from_buffers
+from .cppyy_flatsurf import flatsurf
+
+# Coefficients are handed to C++ as long long.
+_LIMIT = 1 << 63
+
+def _cycles(vertices, offsets):
+    r"""
+    Return the cycles of the vertex permutation given as flat buffers.
+    """
+    return [list(vertices[offsets[i]:offsets[i + 1]]) for i in range(len(offsets) - 1)]
+
+class Converter:
+    r"""
+    Converts sage-flatsurf surfaces made of triangles to libflatsurf surfaces.
+
+    The e-antic number fields corresponding to SageMath number fields are
+    created only once per converter, so converting many surfaces over the
+    same field, such as the unfoldings of many triangles, does not rebuild
+    the field and its embedding for every coordinate.
+
+    EXAMPLES::
+
+        sage: import flatsurf as sage_flatsurf
+        sage: from pyflatsurf.sage_conversion import Converter
+        sage: converter = Converter()
+        sage: T = sage_flatsurf.polygons.triangle(1, 1, 2)
+        sage: S = sage_flatsurf.similarity_surfaces.billiard(T).minimal_cover(cover_type="translation")
+        sage: converter(S) == converter(S)
+        True
+        sage: len(converter._fields)
+        1
+
+    """
+    def __init__(self):
+        self._fields = {}
+
+    def field(self, K):
+        r"""
+        Return the e-antic number field corresponding to the SageMath number
+        field ``K``.
+        """
+        if K not in self._fields:
+            from pyeantic.sage_conversion import sage_nf_to_eantic
+            self._fields[K] = sage_nf_to_eantic(K)
+        return self._fields[K]
+
+    def __call__(self, surface):
+        r"""
+        Return the sage-flatsurf translation ``surface`` (made of triangles)
+        as a libflatsurf ``FlatTriangulation``.
+        """
+        vertices, offsets, edges = self._combinatorics(surface)
+
+        K = edges[0][0].parent()
+
+        from sage.all import QQ
+        if K is QQ:
+            return self._rational(vertices, offsets, edges)
+
+        # The coefficients of all coordinates in the power basis of K with a
+        # common denominator per coordinate, i.e., the layout that the
+        # number field variant of make_FlatTriangulation_from_buffers expects.
+        numerators = array.array("q")
+        denominators = array.array("q")
+        for edge in edges:
+            for coordinate in edge:
+                denominator = coordinate.denominator()
+                coefficients = [c * denominator for c in coordinate.list()]
+                if any(abs(c) >= _LIMIT for c in coefficients) or denominator >= _LIMIT:
+                    return self._exact(vertices, offsets, edges)
+                numerators.extend(int(c) for c in coefficients)
+                denominators.append(int(denominator))
+
+        return make_FlatTriangulation_from_buffers(vertices, offsets, numerators, denominators, field=self.field(K))
+
+    def _combinatorics(self, surface):
+        r"""
+        Return the vertex permutation of ``surface`` as flat buffers of half
+        edges and offsets of the cycles, together with the vectors of the
+        edges 1, 2, … as pairs of SageMath coordinates.
+        """
+        # Map sage-flatsurf's (face, id) to flatsurf.HalfEdge
+        halfEdges = {}
+        edges = []
+
+        for face in surface.label_iterator():
+            for edge in [0, 1, 2]:
+                label = (face, edge)
+
+                if label in halfEdges: continue
+
+                edges.append(surface.polygon(face).edge(edge))
+                halfEdges[label] = len(edges)
+                halfEdges[surface.opposite_edge(*label)] = -len(edges)
+
+        # The half edge following each half edge counterclockwise around its vertex
+        successors = {}
+        for face in surface.label_iterator():
+            for edge in [0, 1, 2]:
+                successors[halfEdges[(face, edge)]] = halfEdges[surface.opposite_edge(face, (edge + 2) % 3)]
+
+        vertices = array.array("i")
+        offsets = array.array("q", [0])
+        while successors:
+            start = next(iter(successors))
+            halfEdge = start
+            while True:
+                vertices.append(halfEdge)
+                halfEdge = successors.pop(halfEdge)
+                if halfEdge == start: break
+            offsets.append(len(vertices))
+
+        return vertices, offsets, edges
+
+    def _exact(self, vertices, offsets, edges):
+        r"""
+        Return the surface with coordinates converted one by one, for
+        coordinates whose coefficients do not fit into a long long.
+        """
+        from pyeantic.sage_conversion import sage_nf_elem_to_eantic
+        K = self.field(edges[0][0].parent())
+        R2 = flatsurf.Vector['eantic::renf_elem_class']
+        return make_FlatTriangulation(_cycles(vertices, offsets), [R2(sage_nf_elem_to_eantic(K, x), sage_nf_elem_to_eantic(K, y)) for (x, y) in edges])
+
+    def _rational(self, vertices, offsets, edges):
+        r"""
+        Return the surface with rational coordinates.
+        """
+        import cppyy
+        R2 = flatsurf.Vector['mpq_class']
+        return make_FlatTriangulation(_cycles(vertices, offsets), [R2(cppyy.gbl.mpq_class(str(x)), cppyy.gbl.mpq_class(str(y))) for (x, y) in edges])
+
+_converter = Converter()
+
+def to_FlatTriangulation(surface):
+    r"""
+    Return the sage-flatsurf translation ``surface`` (made of triangles) as
+    a libflatsurf ``FlatTriangulation``.
+
+    The e-antic number fields are cached between calls, see
+    :class:`Converter`.
+    """
+    return _converter(surface)
@@ -0,0 +1,220 @@
+# -*- coding: utf-8 -*-
+r"""
+Survey flow decompositions of many surfaces in many directions with a pool
+of worker processes.
+
+EXAMPLES::
+
+    >>> from pyflatsurf import Surface, flatsurf
+    >>> from pyflatsurf.survey import survey
+    >>> R2 = flatsurf.Vector['long long']
+    >>> square = Surface([[1, 3, 2, -1, -3, -2]], [R2(1, 0), R2(0, 1), R2(1, 1)])
+    >>> results = sorted(survey([square], bound=4, processes=2))
+    >>> len(results)
+    32
+    >>> results[0]
+    (0, 0, {'cylinders': 1, 'minimal': 0, 'undetermined': 0})
+
+"""
+#*********************************************************************
+#  This file is part of flatsurf.
+#
+#        Copyright (C) 2020 Julian Rüth
+#
+#  Flatsurf is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  Flatsurf is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+#*********************************************************************
+
+import json
+import os
+import pickle
+
+from .cppyy_flatsurf import flatsurf
+
+def summarize(decomposition):
+    r"""
+    Return the number of cylinders, minimal components, and undetermined
+    components of a flow decomposition.
+
+    This is the default analysis performed by :func:`survey`.
+
+    EXAMPLES::
+
+        >>> from pyflatsurf import Surface, flatsurf
+        >>> from pyflatsurf.survey import summarize
+        >>> R2 = flatsurf.Vector['long long']
+        >>> square = Surface([[1, 3, 2, -1, -3, -2]], [R2(1, 0), R2(0, 1), R2(1, 1)])
+        >>> decomposition = flatsurf.makeFlowDecomposition(square, R2(1, 0))
+        >>> decomposition.decompose(-1)
+        True
+        >>> summarize(decomposition)
+        {'cylinders': 1, 'minimal': 0, 'undetermined': 0}
+
+    """
+    return {
+        "cylinders": len(decomposition.cylinders()),
+        "minimal": len(decomposition.minimalComponents()),
+        "undetermined": len(decomposition.undeterminedComponents()),
+    }
+
+def saddle_connection_directions(surface, bound):
+    r"""
+    Return the directions of the saddle connections on ``surface`` of
+    length at most ``bound``.
+
+    The directions are always returned in the same order, so their
+    positions can be used to refer to them across runs of a survey.
+
+    EXAMPLES::
+
+        >>> from pyflatsurf import Surface, flatsurf
+        >>> from pyflatsurf.survey import saddle_connection_directions
+        >>> R2 = flatsurf.Vector['long long']
+        >>> square = Surface([[1, 3, 2, -1, -3, -2]], [R2(1, 0), R2(0, 1), R2(1, 1)])
+        >>> len(saddle_connection_directions(square, 4))
+        32
+
+    """
+    R2 = type(surface.fromHalfEdge(flatsurf.HalfEdge(1)))
+    # vector() returns a reference that is only valid until the iterator advances
+    return [R2(connection.vector()) for connection in surface.connections().bound(bound)]
+
+# The state of a worker process, see _initialize().
+_worker = {}
+
+def _initialize(surfaces, analyze, limit):
+    r"""
+    Set up a worker process of :func:`survey`.
+
+    ``surfaces`` are the pickled surfaces of the survey. They are handed to
+    each worker once and only unpickled when a worker first needs them.
+    """
+    _worker["serialized"] = surfaces
+    _worker["surfaces"] = {}
+    _worker["analyze"] = analyze
+    _worker["limit"] = limit
+
+def _surface(index):
+    r"""
+    Return the ``index``-th surface of the survey in a worker process.
+    """
+    surfaces = _worker["surfaces"]
+    if index not in surfaces:
+        surfaces[index] = pickle.loads(_worker["serialized"][index])
+    return surfaces[index]
+
+def _run(task):
+    r"""
+    Decompose one surface in one direction in a worker process.
+    """
+    index, direction, vector = task
+    decomposition = flatsurf.makeFlowDecomposition(_surface(index), pickle.loads(vector))
+    decomposition.decompose(_worker["limit"])
+    return index, direction, _worker["analyze"](decomposition)
+
+def _completed(journal):
+    r"""
+    Return the results recorded in ``journal`` by an earlier run of
+    :func:`survey`.
+    """
+    completed = {}
+    if journal is None or not os.path.exists(journal):
+        return completed
+    with open(journal) as records:
+        for record in records:
+            record = record.strip()
+            # A run that was interrupted might have written a partial line.
+            if not record:
+                continue
+            try:
+                index, direction, result = json.loads(record)
+            except ValueError:
+                continue
+            completed[(index, direction)] = result
+    return completed
+
+def survey(surfaces, bound=None, directions=None, analyze=summarize, processes=None, journal=None, limit=-1, chunksize=1):
+    r"""
+    Decompose each of ``surfaces`` in a number of directions with a pool of
+    ``processes`` worker processes (one per core by default.)
+
+    The directions are either given explicitly as ``directions``, a list
+    with a list of vectors for each surface, or they are the directions of
+    the saddle connections of length at most ``bound`` on each surface.
+
+    Yields triples ``(surface, direction, result)`` as soon as they are
+    available, in no particular order, where ``surface`` and ``direction``
+    are the positions of the surface and of the direction, and ``result`` is
+    what ``analyze`` returned for the flow decomposition. ``analyze`` must be
+    a function defined at the top level of a module so that it can be sent to
+    the workers.
+
+    The surfaces are pickled once and each worker unpickles each surface at
+    most once, so the tasks only need to carry the direction.
+
+    When ``journal`` is a path, each result is appended to that file as a
+    line of JSON (so ``analyze`` needs to return something that can be
+    written as JSON.) When ``survey`` is called again with the same
+    journal, the results recorded there are yielded first and are not
+    computed again, i.e., an interrupted survey can be resumed.
+
+    EXAMPLES::
+
+        >>> import os, tempfile
+        >>> from pyflatsurf import Surface, flatsurf
+        >>> from pyflatsurf.survey import survey
+        >>> R2 = flatsurf.Vector['long long']
+        >>> square = Surface([[1, 3, 2, -1, -3, -2]], [R2(1, 0), R2(0, 1), R2(1, 1)])
+        >>> journal = os.path.join(tempfile.mkdtemp(), "journal.json")
+
+    We interrupt a survey after three results and then resume it::
+
+        >>> interrupted = survey([square], bound=2, journal=journal, processes=1)
+        >>> for _ in range(3): _ = next(interrupted)
+        >>> interrupted.close()
+        >>> len(list(survey([square], bound=2, journal=journal, processes=1)))
+        8
+
+    """
+    if directions is None:
+        if bound is None:
+            raise ValueError("either directions or a bound must be given")
+        directions = [saddle_connection_directions(surface, bound) for surface in surfaces]
+    if len(directions) != len(surfaces):
+        raise ValueError("there must be a list of directions for each surface")
+
+    completed = _completed(journal)
+    for (index, direction), result in completed.items():
+        yield index, direction, result
+
+    tasks = [(index, direction, pickle.dumps(vector))
+             for index, vectors in enumerate(directions)
+             for direction, vector in enumerate(vectors)
+             if (index, direction) not in completed]
+    if not tasks:
+        return
+
+    serialized = [pickle.dumps(surface) for surface in surfaces]
+
+    import multiprocessing
+    with multiprocessing.Pool(processes, initializer=_initialize, initargs=(serialized, analyze, limit)) as pool:
+        records = open(journal, "a") if journal is not None else None
+        try:
+            for index, direction, result in pool.imap_unordered(_run, tasks, chunksize=chunksize):
+                if records is not None:
+                    records.write(json.dumps([index, direction, result]) + "\n")
+                    records.flush()
+                yield index, direction, result
+        finally:
+            if records is not None:
+                records.close()
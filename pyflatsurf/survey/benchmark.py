@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+r"""
+Benchmark the survey of a set of triangles.
+
+For each triangle, this times the unfolding with sage-flatsurf, the
+conversion to libflatsurf, the Delaunay triangulation, the enumeration of
+saddle connections up to ``--bound``, and each flow decomposition in the
+directions of these saddle connections. The timings are written as a CSV
+or JSON report so that the throughput on the same set of triangles can be
+compared across versions of the library.
+
+EXAMPLES::
+
+    ./benchmark.py 1,1,1 1,2,3 --bound 8 --csv timings.csv --json summary.json
+
+"""
+######################################################################
+#  This file is part of flatsurf.
+#
+#        Copyright (C) 2020 Julian Rüth
+#
+#  flatsurf is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  flatsurf is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+######################################################################
+
+import argparse
+import csv
+import json
+import sys
+import time
+
+from pyflatsurf import flatsurf
+from pyflatsurf.survey import summarize, saddle_connection_directions
+from unfold import unfold_sage, to_pyflatsurf
+
+def timed(f, *args):
+    r"""
+    Return the result of ``f(*args)`` and the wall time in seconds it took.
+    """
+    start = time.perf_counter()
+    result = f(*args)
+    return result, time.perf_counter() - start
+
+def benchmark(angles, bound, limit):
+    r"""
+    Return the rows of the report for the triangle with ``angles``.
+
+    There is one row for each phase of the survey and one row for each flow
+    decomposition.
+    """
+    label = ",".join(str(a) for a in angles)
+    rows = []
+
+    def record(phase, seconds, **details):
+        row = {"triangle": label, "phase": phase, "seconds": seconds, "direction": "", "cylinders": "", "minimal": "", "undetermined": ""}
+        row.update(details)
+        rows.append(row)
+
+    S, seconds = timed(unfold_sage, *angles)
+    record("unfold", seconds)
+
+    surface, seconds = timed(to_pyflatsurf, S)
+    record("conversion", seconds)
+
+    _, seconds = timed(surface.delaunay)
+    record("delaunay", seconds)
+
+    directions, seconds = timed(saddle_connection_directions, surface, flatsurf.Bound(bound, 0))
+    record("saddle connections", seconds, direction=len(directions))
+
+    for direction, vector in enumerate(directions):
+        def decompose():
+            decomposition = flatsurf.makeFlowDecomposition(surface, vector)
+            decomposition.decompose(limit)
+            return summarize(decomposition)
+        summary, seconds = timed(decompose)
+        record("flow decomposition", seconds, direction=direction, **summary)
+
+    return rows
+
+def parse_triangle(value):
+    angles = tuple(int(a) for a in value.split(","))
+    if len(angles) != 3:
+        raise argparse.ArgumentTypeError("a triangle must be given by three angles a,b,c")
+    return angles
+
+parser = argparse.ArgumentParser(description='Benchmark the Survey of Triangles')
+parser.add_argument('triangles', metavar='A,B,C', type=parse_triangle, nargs='*', help='the angles of the triangles to survey')
+parser.add_argument('--triangles', dest='file', type=str, default=None, help='file with one triangle a,b,c per line to survey in addition')
+parser.add_argument('--bound', type=int, default=10)
+parser.add_argument('--limit', type=int, default=-1, help='number of steps to decompose each component for, until fully decomposed by default')
+parser.add_argument('--csv', type=str, default=None, help='file to write the timing of every phase and every flow decomposition to')
+parser.add_argument('--json', type=str, default=None, help='file to write the total time of each phase and the throughput to')
+
+args = parser.parse_args()
+
+triangles = list(args.triangles)
+if args.file is not None:
+    with open(args.file) as lines:
+        triangles += [parse_triangle(line.strip()) for line in lines if line.strip() and not line.startswith("#")]
+
+if not triangles:
+    parser.error("no triangles to benchmark")
+
+rows = []
+start = time.perf_counter()
+for angles in triangles:
+    print("Benchmarking %s"%(angles,), file=sys.stderr)
+    rows += benchmark(angles, args.bound, args.limit)
+total = time.perf_counter() - start
+
+phases = {}
+for row in rows:
+    phase = phases.setdefault(row["phase"], {"count": 0, "seconds": 0.})
+    phase["count"] += 1
+    phase["seconds"] += row["seconds"]
+
+summary = {
+    "bound": args.bound,
+    "triangles": len(triangles),
+    "seconds": total,
+    "triangles per hour": 3600 * len(triangles) / total if total else None,
+    "phases": phases,
+}
+
+if args.csv is not None:
+    with open(args.csv, "w", newline="") as report:
+        writer = csv.DictWriter(report, fieldnames=["triangle", "phase", "direction", "seconds", "cylinders", "minimal", "undetermined"])
+        writer.writeheader()
+        writer.writerows(rows)
+
+if args.json is not None:
+    with open(args.json, "w") as report:
+        json.dump(summary, report, indent=2)
+
+json.dump(summary, sys.stdout, indent=2)
+print()
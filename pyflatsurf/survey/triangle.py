@@ -22,13 +22,15 @@
 
 import argparse
 
-from pyflatsurf import flatsurf, Surface
-import flatsurf as sage_flatsurf
-from pyeantic.sage_conversion import sage_nf_to_eantic, sage_nf_elem_to_eantic
+from pyflatsurf import flatsurf
+from pyflatsurf.survey import survey, saddle_connection_directions
+from unfold import unfold
 
 parser = argparse.ArgumentParser(description='Survey a Triangle')
 parser.add_argument('angles', metavar='N', type=int, nargs='+')
 parser.add_argument('--bound', type=int, default=10)
+parser.add_argument('--processes', type=int, default=None, help='number of worker processes, one per core by default')
+parser.add_argument('--journal', type=str, default=None, help='file to record results in so that an interrupted survey can be resumed')
 
 args = parser.parse_args()
 
@@ -36,78 +38,16 @@ assert(len(args.angles) == 3)
 
 print("Unfolding %s"%(args.angles))
 
-# Unfold the (a, b, c) triangle with sage-flatsurf
-T = sage_flatsurf.polygons.triangle(*args.angles)
-S = sage_flatsurf.similarity_surfaces.billiard(T)
-S = S.minimal_cover(cover_type="translation")
-
-# Map sage-flatsurf's (face, id) to flatsurf.HalfEdge 
-edges = {}
-# Map flatsurf.HalfEdge to flatsurf.Vector
-vectors = {}
-
-K = None
-
-for face in S.label_iterator():
-    for edge in [0, 1, 2]:
-        label = (face, edge)
-
-        if label in edges: continue
-
-        edges[label] = len(edges) // 2 + 1
-        edges[S.opposite_edge(*label)] = -edges[label]
-
-        vector = S.polygon(face).edge(edge)
-
-        if K is None:
-            K = sage_nf_to_eantic(vector[0].parent())
-            print(K)
-
-        vector = flatsurf.Vector['eantic::renf_elem_class'](
-            sage_nf_elem_to_eantic(K, vector[0]),
-            sage_nf_elem_to_eantic(K, vector[1]))
-
-        vectors[edges[label]] = vector
-        vectors[edges[S.opposite_edge(*label)]] = -vector
-
-# The vectors for the HalfEdge 1 … n
-vectors = [vectors[i + 1] for i in range(len(vectors) // 2)]
-
-# Construct half edge permutation around vertices
-vertices = {}
-
-for face in S.label_iterator():
-    for edge in [0, 1, 2]:
-        label = (face, edge)
-        nextLabel = S.opposite_edge(face, (edge + 2) % 3)
-        vertices[edges[label]] = edges[nextLabel]
-
-cycles = []
-while vertices:
-    key = next(iter(vertices.keys()))
-    cycle = []
-    while True:
-        cycle.append(key)
-        successor = vertices[key]
-        del vertices[key]
-        key = successor 
-        if key == cycle[0]: break
-    cycles.append(cycle)
-
-vertices = cycles
-
-surface = Surface(vertices, vectors)
+surface = unfold(*args.angles)
 
 print(surface)
 
-for connection in surface.saddle_connections(flatsurf.Bound(args.bound, 0)):
-    print("Investigating in direction %s"%(connection.vector()))
-    decomposition = flatsurf.makeFlowDecomposition(surface, connection.vector())
-    decomposition.decompose()
-    if not all([bool(component.cylinder()) for component in decomposition.components()]):
-        for component in decomposition.components():
-            print(component)
-        if any([bool(component.cylinder() for component  in decomposition.components())]):
+directions = saddle_connection_directions(surface, flatsurf.Bound(args.bound, 0))
+
+for _, direction, result in survey([surface], directions=[directions], processes=args.processes, journal=args.journal):
+    print("Investigating in direction %s"%(directions[direction],))
+    if result["minimal"] or result["undetermined"]:
+        if result["cylinders"]:
             print("NOT CYLINDER COMPLETELY PERIODIC - found a cylinder and a component without periodic trajectories in the same direction")
             import sys
             sys.exit(1)
@@ -116,6 +56,6 @@ for connection in surface.saddle_connections(flatsurf.Bound(args.bound, 0)):
             import sys
             sys.exit(1)
     else:
-        print("Decomposes into %s cylinders"%(len(decomposition.components())))
+        print("Decomposes into %s cylinders"%(result["cylinders"],))
 
 print("Could be Completely Periodic After Looking at All Saddle Connections of Length up to %s"%(args.bound,))
@@ -0,0 +1,48 @@
+# -*- coding: utf-8 -*-
+r"""
+Unfolding of rational triangles into translation surfaces in libflatsurf
+that is shared by the survey scripts.
+"""
+######################################################################
+#  This file is part of flatsurf.
+#
+#        Copyright (C) 2019-2020 Julian Rüth
+#
+#  flatsurf is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  flatsurf is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+######################################################################
+
+import flatsurf as sage_flatsurf
+from pyflatsurf.sage_conversion import to_FlatTriangulation
+
+def unfold_sage(a, b, c):
+    r"""
+    Return the unfolding of the (a, b, c) triangle as a sage-flatsurf
+    translation surface.
+    """
+    T = sage_flatsurf.polygons.triangle(a, b, c)
+    S = sage_flatsurf.similarity_surfaces.billiard(T)
+    return S.minimal_cover(cover_type="translation")
+
+def to_pyflatsurf(S):
+    r"""
+    Return the sage-flatsurf translation surface ``S`` (made of triangles)
+    as a libflatsurf surface over e-antic.
+    """
+    return to_FlatTriangulation(S)
+
+def unfold(a, b, c):
+    r"""
+    Return the unfolding of the (a, b, c) triangle as a libflatsurf surface.
+    """
+    return to_pyflatsurf(unfold_sage(a, b, c))
@@ -141,6 +141,19 @@ def test_isomorphism():
     assert L.isomorphism(L, filter_matrix=lambda a, b, c, d: a == -1 and b == 0 and c == 0 and d == -1)
     assert not L.isomorphism(L, filter_matrix=lambda a, b, c, d: a*d - b*c not in [-1, 1])
 
+def test_buffers():
+    from array import array
+    from pyflatsurf.factory import make_FlatTriangulation_from_buffers
+
+    square = surfaces.square(flatsurf.Vector['mpq_class'])
+    assert make_FlatTriangulation_from_buffers([1, 3, 2, -1, -3, -2], [0, 6], [1, 0, 0, 1, 1, 1]) == square
+    assert make_FlatTriangulation_from_buffers(array('i', [1, 3, 2, -1, -3, -2]), array('q', [0, 6]), array('q', [1, 0, 0, 1, 1, 1])) == square
+
+    # The hexagon with coordinates in Q(√3), i.e., coefficients of 1 and x.
+    hexagon = surfaces.hexagon()
+    coefficients = [2, 0, 0, 0,  1, 0, 0, 1,  3, 0, 0, 1,  1, 0, 0, -1,  4, 0, 0, 0,  3, 0, 0, 1]
+    assert make_FlatTriangulation_from_buffers([1, 3, -4, -5, -3, -2, 2, -1, -6, 4, 5, 6], [0, 6, 12], coefficients, denominators=[1] * 12, field=surfaces.K) == hexagon
+
 def test_serialization():
     hexagon = surfaces.random_hexagon()
 
@@ -127,4 +127,20 @@ def test_undetermined():
     decomposition.decompose(-1)
     assert len(decomposition.undeterminedComponents()) == 0
 
+def test_threads():
+    from concurrent.futures import ThreadPoolExecutor
+
+    S = surfaces.D33()
+    R2 = flatsurf.Vector['eantic::renf_elem_class']
+    # vector() returns a reference that is only valid until the iterator advances
+    directions = [R2(connection.vector()) for connection in S.connections().bound(4)]
+
+    def decompose(v):
+        decomposition = flatsurf.makeFlowDecomposition(S, v)
+        decomposition.decompose(-1)
+        return (len(decomposition.cylinders()), len(decomposition.minimalComponents()))
+
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        assert list(pool.map(decompose, directions)) == [decompose(v) for v in directions]
+
 if __name__ == '__main__': sys.exit(pytest.main(sys.argv))
@@ -30,14 +30,32 @@ import surfaces
 def test_square_longlong():
     surface = surfaces.square(flatsurf.Vector['long long'])
     connections = surface.connections().bound(16).sector(flatsurf.HalfEdge(1))
-    # https://bitbucket.org/wlav/cppyy/issues/103/std-distance-returns-random-output
-    # assert len(connections) == 60
-    # This does not work, the iterator that backs connections returns
-    # references that are only valid until the iterator is advanced, so the
-    # conversion to list does not work at the moment.
-    # assert len(list(connections))
+    assert len(connections) == 60
+    assert len(list(connections)) == 60
     assert len([1 for c in connections]) == 60
 
+def test_list():
+    surface = surfaces.L(flatsurf.Vector['mpq_class'])
+    connections = surface.connections().bound(16).sector(flatsurf.HalfEdge(1))
+    # Iteration hands out copies, so the connections outlive the iterator.
+    assert len(set(str(c) for c in list(connections))) == 60
+    assert len(list(connections.byLength())) == 60
+    assert not hasattr(connections.byLength(), '__len__')
+
+def test_pickling():
+    import pickle
+    surface = surfaces.L(flatsurf.Vector['mpq_class'])
+    connections = [c for c in surface.connections().bound(16)]
+
+    unpickled = pickle.loads(pickle.dumps((surface, connections)))
+    assert unpickled[0] == surface
+    assert [str(c) for c in unpickled[1]] == [str(c) for c in connections]
+    # All connections live on the same unpickled surface.
+    assert all(c.surface() == unpickled[0] for c in unpickled[1])
+
+    # The surface is only written once to the stream.
+    assert len(pickle.dumps(connections)) < len(connections) * len(pickle.dumps(surface))
+
 def test_L_mpq():
     surface = surfaces.L(flatsurf.Vector['mpq_class'])
     connections = surface.connections().bound(16).sector(flatsurf.HalfEdge(1))
@@ -70,6 +88,21 @@ def test_hexagon_exactreal():
     connections = surface.connections().bound(16).sector(flatsurf.HalfEdge(1))
     assert len([1 for c in connections]) >= 10
 
+def test_columns():
+    from pyflatsurf.export import saddle_connection_records, saddle_connection_columns
+    surface = surfaces.L(flatsurf.Vector['mpq_class'])
+    connections = surface.connections().bound(16)
+    records = saddle_connection_records(connections, chunk=7)
+    columns = saddle_connection_columns(records, exact=True)
+
+    assert len(columns["source"]) == len([1 for c in connections])
+    assert len(columns["offsets"]) == len(columns["source"]) + 1
+    for i, connection in enumerate(connections):
+        assert columns["source"][i] == connection.source().id()
+        assert columns["target"][i] == connection.target().id()
+        assert abs(columns["x"][i] - float(connection.vector().x().get_d())) < 1e-9
+        assert abs(columns["squared"][i] - float(connection.vector().x().get_d())**2 - float(connection.vector().y().get_d())**2) < 1e-6
+
 def test_printing():
     for coefficients in ['long long', 'mpz_class', 'mpq_class', 'eantic::renf_elem_class', 'exactreal::Element<exactreal::IntegerRing>', 'exactreal::Element<exactreal::RationalField>', 'exactreal::Element<exactreal::NumberField>']:
         surface = surfaces.square(flatsurf.Vector[coefficients])
@@ -26,29 +26,35 @@
 # 'benchmark' (google benchmark) to your asv.conf.json matrix as that is a
 # reserved key in ASV. Instead add an exact pin such as 'benchmark==1.4.1'.
 
+import json
+import os
+import re
 import subprocess
 
 def create_wrappers(benchmark):
     r"""
-    Return ASV compatible benchmark classes that contain a `track_time` method
-    for each benchmark exported by the Google Benchmark binary `benchmark`.
+    Return ASV compatible benchmark classes that contain a `track_time` and a
+    `track_peak_rss` method for each benchmark exported by the Google
+    Benchmark binary `benchmark`.
     """
     benchmarks = subprocess.check_output([benchmark, "--benchmark_list_tests"]).decode('UTF-8').split('\n')
 
     benchmarks = [benchmark.strip().split('/') for benchmark in benchmarks if benchmark.strip()]
 
-    benchmarks = create_time_methods(benchmark, benchmarks)
+    benchmarks = create_track_methods(benchmark, benchmarks)
 
     benchmarks = { sanitize_benchmark_name(benchmark): benchmarks[benchmark] for benchmark in benchmarks }
 
-    return {benchmark: create_benchmark_class(benchmark, time_method) for (benchmark, time_method) in benchmarks.items()}
+    return {benchmark: create_benchmark_class(benchmark, *methods) for (benchmark, methods) in benchmarks.items()}
 
-def create_benchmark_class(name, time_method):
+def create_benchmark_class(name, time_method, rss_method):
     r"""
-    Return an ASV compatible benchmark class called `name` that runs the given method as `track_time`.
+    Return an ASV compatible benchmark class called `name` that runs the given
+    methods as `track_time` and `track_peak_rss`.
     """
     class Benchmark:
         track_time = time_method
+        track_peak_rss = rss_method
     Benchmark.__name__ = name
 
     return Benchmark
@@ -65,38 +71,120 @@ def sanitize_benchmark_name(name):
 
     return name
 
-def create_time_methods(benchmark, benchmarks):
+def benchmark_filter(name):
     r"""
-    Return a mapping from sanitized benchmark names to Python methods that run that benchmark.
+    Return a filter for `--benchmark_filter` that matches exactly the Google
+    Benchmark called `name`.
+
+    Google Benchmark interprets the filter as a POSIX extended regular
+    expression, so we cannot use Python's `re.escape` here.
+
+    EXAMPLES::
+
+        >>> benchmark_filter("SaddleConnectionsL<Vector<long long>>/64")
+        '^SaddleConnectionsL<Vector<long long>>/64$'
+        >>> benchmark_filter("FlatTriangulationDelaunay/make1234")
+        '^FlatTriangulationDelaunay/make1234$'
+        >>> benchmark_filter("Benchmark<(1+2)>")
+        '^Benchmark<\\(1\\+2\\)>$'
+
+    """
+    return "^" + re.sub(r"([.\[\](){}*+?|^$\\])", r"\\\1", name) + "$"
+
+def run(benchmark, name):
+    r"""
+    Run the Google Benchmark called `name` in a separate process of the binary
+    `benchmark` and return its JSON record and the peak resident set size of
+    that process in bytes.
+    """
+    process = subprocess.Popen([benchmark, f"--benchmark_filter={benchmark_filter(name)}", "--benchmark_format=json"], stdout=subprocess.PIPE)
+    out = process.stdout.read()
+    process.stdout.close()
+
+    # We wait for the process ourselves since subprocess does not report the
+    # resources used by a single child.
+    _, status, usage = os.wait4(process.pid, 0)
+    process.returncode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -os.WTERMSIG(status)
+    if process.returncode != 0:
+        raise subprocess.CalledProcessError(process.returncode, process.args, out)
+
+    out = json.loads(out)
+
+    runs = [run for run in out["benchmarks"] if run.get("run_type", "iteration") == "iteration"]
+    assert(len(runs) == 1)
+
+    # On Linux, ru_maxrss is reported in kilobytes.
+    return runs[0], usage.ru_maxrss * 1024
+
+def create_track_methods(benchmark, benchmarks):
+    r"""
+    Return a mapping from benchmark names to pairs of Python methods that run
+    that benchmark and track its time and its peak memory usage.
     """
     toplevel = set(b[0] for b in benchmarks)
 
-    time_methods = { name: create_time_method(benchmark, name) for name in toplevel }
-    
     params = { name: [tuple(b[1:]) for b in benchmarks if b[0] == name] for name in toplevel }
 
+    methods = {}
     for name in toplevel:
+        methods[name] = (create_time_method(benchmark, name), create_rss_method(benchmark, name))
         if len(params[name]) > 1:
-            time_methods[name].params = [ ", ".join(p) for p in params[name] ]
+            for method in methods[name]:
+                method.params = [ ", ".join(p) for p in params[name] ]
+
+    return methods
+
+def _configure(method, name, unit):
+    r"""
+    Set the ASV attributes of `method` which tracks the Google Benchmark
+    `name` in `unit`.
+    """
+    method.unit = unit
 
-    return time_methods
+    # We cannot compute a version number of this benchmark yet since we cannot hash its original C++ source code easily.
+    method.version = 0
+
+    # Google Benchmark already takes care of sampling for us, so we only run the benchmarks once.
+    method.repeat = 1
+    method.number = 1
+    method.min_run_count = 1
+
+    # Show the original benchmark name in ASV output
+    # Unfortunately, this breaks ASV's HTML output.
+    # method.name = name
+    # method.pretty_name = name
+
+    return method
+
+def _full_name(name, params):
+    r"""
+    Return the name of the Google Benchmark `name` with the ASV parameters
+    `params`.
+
+    EXAMPLES::
+
+        >>> _full_name("SaddleConnectionsL<Vector<long long>>", "64")
+        'SaddleConnectionsL<Vector<long long>>/64'
+        >>> _full_name("FlowDecompositionDecompose", "makeOctagon, cylinderDirections")
+        'FlowDecompositionDecompose/makeOctagon/cylinderDirections'
+        >>> _full_name("ChainCopy", None)
+        'ChainCopy'
+
+    """
+    if params:
+        return f"{name}/{params.replace(', ', '/')}"
+    return name
 
 def create_time_method(benchmark, name):
     r"""
-    Return a method that runs the benchmark binary `benchmark` on the Google Benchmark called `name`.
+    Return a method that runs the benchmark binary `benchmark` on the Google
+    Benchmark called `name` and returns the CPU time per iteration.
     """
     def run_benchmark(self, params=None):
-        filter = f"{name}"
-        if params:
-            filter = f"{name}/{params.replace(', ', '/')}"
-        out = subprocess.check_output([benchmark, f"--benchmark_filter={filter}", "--benchmark_format=json"])
-
-        import json
-        out = json.loads(out)
+        out, _ = run(benchmark, _full_name(name, params))
 
-        assert(len(out["benchmarks"]) == 1)
-        time = out["benchmarks"][0]["cpu_time"]
-        unit = out["benchmarks"][0]["time_unit"]
+        time = out["cpu_time"]
+        unit = out["time_unit"]
 
         if unit == "s":
             time *= 1000
@@ -112,19 +200,19 @@ def create_time_method(benchmark, name):
 
         return time
 
-    run_benchmark.unit = "ns"
+    return _configure(run_benchmark, name, "ns")
 
-    # We cannot compute a version number of this benchmark yet since we cannot hash its original C++ source code easily.
-    run_benchmark.version = 0
-
-    # Google Benchmark already takes care of sampling for us, so we only run the benchmarks once.
-    run_benchmark.repeat = 1
-    run_benchmark.number = 1
-    run_benchmark.min_run_count = 1
+def create_rss_method(benchmark, name):
+    r"""
+    Return a method that runs the benchmark binary `benchmark` on the Google
+    Benchmark called `name` and returns the peak resident set size of the
+    process running that benchmark.
 
-    # Show the original benchmark name in ASV output
-    # Unfortunately, this breaks ASV's HTML output.
-    # run_benchmark.name = name
-    # run_benchmark.pretty_name = name
+    Since every benchmark runs in a process of its own, this is the memory
+    used by that benchmark on top of the constant overhead of the binary.
+    """
+    def run_benchmark(self, params=None):
+        _, rss = run(benchmark, _full_name(name, params))
+        return rss
 
-    return run_benchmark
+    return _configure(run_benchmark, name, "bytes")